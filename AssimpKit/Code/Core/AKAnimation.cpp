@@ -0,0 +1,163 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAnimation.h"
+#include "AKMemory.h"
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - Make keyframe tracks
+
+/**
+ Fills a keyframe track from assimp vector keys.
+
+ @param keys The assimp position or scale keys.
+ @param nKeys The number of keys.
+ @param track The keyframe track to fill.
+ */
+static void makeVectorTrack(const struct aiVectorKey *keys,
+                            unsigned int nKeys,
+                            AKKeyframeTrack *track)
+{
+    track->nKeys = nKeys;
+    track->nComponents = 3;
+    track->keyTimes = (float *)AKMemoryMalloc(nKeys * sizeof(float));
+    track->values = (float *)AKMemoryMalloc(nKeys * 3 * sizeof(float));
+    for (unsigned int k = 0; k < nKeys; k++)
+    {
+        track->keyTimes[k] = (float)keys[k].mTime;
+        track->values[k * 3 + 0] = keys[k].mValue.x;
+        track->values[k * 3 + 1] = keys[k].mValue.y;
+        track->values[k * 3 + 2] = keys[k].mValue.z;
+    }
+}
+
+/**
+ Fills a keyframe track from assimp quaternion keys.
+
+ @param keys The assimp rotation keys.
+ @param nKeys The number of keys.
+ @param track The keyframe track to fill.
+ */
+static void makeQuatTrack(const struct aiQuatKey *keys,
+                          unsigned int nKeys,
+                          AKKeyframeTrack *track)
+{
+    track->nKeys = nKeys;
+    track->nComponents = 4;
+    track->keyTimes = (float *)AKMemoryMalloc(nKeys * sizeof(float));
+    track->values = (float *)AKMemoryMalloc(nKeys * 4 * sizeof(float));
+    for (unsigned int k = 0; k < nKeys; k++)
+    {
+        track->keyTimes[k] = (float)keys[k].mTime;
+        track->values[k * 4 + 0] = keys[k].mValue.x;
+        track->values[k * 4 + 1] = keys[k].mValue.y;
+        track->values[k * 4 + 2] = keys[k].mValue.z;
+        track->values[k * 4 + 3] = keys[k].mValue.w;
+    }
+}
+
+/**
+ Creates the keyframe tracks for each channel of the specified animation.
+
+ @param aiAnimation The assimp animation.
+ @return New animation tracks which must be released with
+ AKAnimationTracksRelease.
+ */
+AKAnimationTracks *AKAnimationTracksCreate(
+    const struct aiAnimation *aiAnimation)
+{
+    AKAnimationTracks *tracks =
+        (AKAnimationTracks *)AKMemoryCalloc(1, sizeof(AKAnimationTracks));
+    if (aiAnimation->mTicksPerSecond != 0)
+    {
+        tracks->duration =
+            aiAnimation->mDuration / aiAnimation->mTicksPerSecond;
+    }
+    else
+    {
+        tracks->duration = aiAnimation->mDuration;
+    }
+    tracks->nChannels = aiAnimation->mNumChannels;
+    tracks->channels = (AKChannelTracks *)AKMemoryCalloc(
+        aiAnimation->mNumChannels, sizeof(AKChannelTracks));
+    for (unsigned int j = 0; j < aiAnimation->mNumChannels; j++)
+    {
+        const struct aiNodeAnim *aiNodeAnim = aiAnimation->mChannels[j];
+        AKChannelTracks *channel = &tracks->channels[j];
+        channel->nodeName = strdup(aiNodeAnim->mNodeName.data);
+        makeVectorTrack(aiNodeAnim->mPositionKeys,
+                        aiNodeAnim->mNumPositionKeys, &channel->position);
+        makeQuatTrack(aiNodeAnim->mRotationKeys, aiNodeAnim->mNumRotationKeys,
+                      &channel->orientation);
+        makeVectorTrack(aiNodeAnim->mScalingKeys, aiNodeAnim->mNumScalingKeys,
+                        &channel->scale);
+    }
+    return tracks;
+}
+
+/**
+ Releases the buffers of a keyframe track.
+
+ @param track The keyframe track.
+ */
+static void releaseTrack(AKKeyframeTrack *track)
+{
+    AKMemoryFree(track->keyTimes);
+    AKMemoryFree(track->values);
+}
+
+/**
+ Releases the animation tracks and all of their buffers.
+
+ @param tracks The animation tracks, may be NULL.
+ */
+void AKAnimationTracksRelease(AKAnimationTracks *tracks)
+{
+    if (tracks == NULL)
+    {
+        return;
+    }
+    for (unsigned int j = 0; j < tracks->nChannels; j++)
+    {
+        AKChannelTracks *channel = &tracks->channels[j];
+        free(channel->nodeName);
+        releaseTrack(&channel->position);
+        releaseTrack(&channel->orientation);
+        releaseTrack(&channel->scale);
+    }
+    AKMemoryFree(tracks->channels);
+    AKMemoryFree(tracks);
+}
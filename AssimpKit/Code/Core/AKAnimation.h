@@ -0,0 +1,147 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKAnimation_h
+#define AKAnimation_h
+
+#include "assimp/anim.h" // Animation data structure
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Keyframe tracks
+
+/**
+ The keyframes of one animated property of a bone: position, orientation or
+ scale.
+ */
+typedef struct AKKeyframeTrack
+{
+    /**
+     The number of keyframes.
+     */
+    unsigned int nKeys;
+
+    /**
+     The number of float components of each keyframe value: 3 for position
+     and scale, 4 for orientation.
+     */
+    unsigned int nComponents;
+
+    /**
+     The keyframe times in ticks, one per keyframe.
+     */
+    float *keyTimes;
+
+    /**
+     The keyframe values, nComponents floats per keyframe. Orientations are
+     stored as x, y, z, w quaternions.
+     */
+    float *values;
+} AKKeyframeTrack;
+
+/**
+ The keyframe tracks of a single animation channel, which animates one bone.
+ */
+typedef struct AKChannelTracks
+{
+    /**
+     The name of the node affected by this channel.
+     */
+    char *nodeName;
+
+    /**
+     The position keyframes.
+     */
+    AKKeyframeTrack position;
+
+    /**
+     The orientation keyframes.
+     */
+    AKKeyframeTrack orientation;
+
+    /**
+     The scale keyframes.
+     */
+    AKKeyframeTrack scale;
+} AKChannelTracks;
+
+/**
+ The keyframe tracks for all channels of an animation.
+ */
+typedef struct AKAnimationTracks
+{
+    /**
+     The duration of the animation in seconds, or in ticks if the animation
+     does not specify the ticks per second.
+     */
+    float duration;
+
+    /**
+     The number of channels.
+     */
+    unsigned int nChannels;
+
+    /**
+     The tracks for each channel.
+     */
+    AKChannelTracks *channels;
+} AKAnimationTracks;
+
+#pragma mark - Make keyframe tracks
+
+/**
+ Creates the keyframe tracks for each channel of the specified animation.
+
+ @param aiAnimation The assimp animation.
+ @return New animation tracks which must be released with
+ AKAnimationTracksRelease.
+ */
+AKAnimationTracks *AKAnimationTracksCreate(
+    const struct aiAnimation *aiAnimation);
+
+/**
+ Releases the animation tracks and all of their buffers.
+
+ @param tracks The animation tracks, may be NULL.
+ */
+void AKAnimationTracksRelease(AKAnimationTracks *tracks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKAnimation_h */
@@ -0,0 +1,686 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAssetCompiler.h"
+#include "AKImportStats.h"
+#include "AKSceneCache.h"
+#include <algorithm>
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <map>
+#include <set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ The file name suffix of the assets.
+ */
+static const char AKAssetSuffix[] = "." AK_SCENE_ARCHIVE_EXTENSION;
+
+/**
+ The report of a file, with the strings it refers to.
+ */
+struct AKAssetEntry
+{
+    /**
+     The path of the file relative to the input directory.
+     */
+    std::string path;
+
+    /**
+     The path of the asset relative to the output directory.
+     */
+    std::string assetPath;
+
+    /**
+     The description of the failure, or an empty string.
+     */
+    std::string error;
+
+    /**
+     What the run did with the file.
+     */
+    AKAssetStatus status;
+
+    /**
+     The key of the asset.
+     */
+    unsigned long long key;
+
+    /**
+     The size of the file in bytes.
+     */
+    size_t fileBytes;
+
+    /**
+     The size of the asset in bytes.
+     */
+    size_t assetBytes;
+
+    /**
+     The time taken to hash and compile the file, in milliseconds.
+     */
+    double milliseconds;
+};
+
+/**
+ An asset recorded in the manifest of a run before.
+ */
+struct AKManifestEntry
+{
+    /**
+     The key of the asset.
+     */
+    unsigned long long key;
+
+    /**
+     The size of the asset in bytes.
+     */
+    size_t assetBytes;
+
+    /**
+     The path of the asset relative to the output directory.
+     */
+    std::string assetPath;
+};
+
+/**
+ An offline compiler of a directory tree of scene files.
+ */
+struct AKAssetCompiler
+{
+    /**
+     The directory of the scene files.
+     */
+    std::string inputDirectory;
+
+    /**
+     The directory of the assets.
+     */
+    std::string outputDirectory;
+
+    /**
+     The hash of the settings the assets are compiled with.
+     */
+    unsigned long long settingsKey;
+
+    /**
+     The function which compiles a file.
+     */
+    AKAssetCompileFunction function;
+
+    /**
+     The context passed to the compile function.
+     */
+    void *context;
+
+    /**
+     The extensions of the files to compile, in lower case.
+     */
+    std::set<std::string> extensions;
+
+    /**
+     The assets of the manifest of the last run, by the path of their file.
+     */
+    std::map<std::string, AKManifestEntry> manifest;
+
+    /**
+     The reports of the files of the last run, in the order of their paths.
+     */
+    std::vector<AKAssetEntry> entries;
+
+    /**
+     The number of assets of files which are gone, removed by the last run.
+     */
+    size_t nRemoved;
+};
+
+#pragma mark - Creating an asset compiler
+
+/**
+ Creates an asset compiler without extensions.
+
+ @param inputDirectory The directory of the scene files.
+ @param outputDirectory The directory of the assets, created when the
+ compiler runs if it does not exist.
+ @param settingsKey The hash of the settings the assets are compiled with,
+ such as the post processing flags and the vertex layout.
+ @param function The function which compiles a file.
+ @param context The context passed to the compile function.
+ @return A new compiler which must be released with AKAssetCompilerRelease.
+ */
+AKAssetCompiler *AKAssetCompilerCreate(const char *inputDirectory,
+                                       const char *outputDirectory,
+                                       unsigned long long settingsKey,
+                                       AKAssetCompileFunction function,
+                                       void *context)
+{
+    AKAssetCompiler *compiler = new AKAssetCompiler;
+    compiler->inputDirectory = inputDirectory;
+    compiler->outputDirectory = outputDirectory;
+    compiler->settingsKey = settingsKey;
+    compiler->function = function;
+    compiler->context = context;
+    compiler->nRemoved = 0;
+    return compiler;
+}
+
+/**
+ Releases the compiler and its reports.
+
+ @param compiler The compiler, may be NULL.
+ */
+void AKAssetCompilerRelease(AKAssetCompiler *compiler)
+{
+    delete compiler;
+}
+
+/**
+ Adds an extension of the files to compile.
+
+ @param compiler The compiler.
+ @param extension The extension without the dot, such as dae, which matches
+ the names of the files regardless of case.
+ */
+void AKAssetCompilerAddExtension(AKAssetCompiler *compiler,
+                                 const char *extension)
+{
+    std::string lower;
+    for (const char *c = extension; *c != '\0'; c++)
+    {
+        lower += (char)tolower((unsigned char)*c);
+    }
+    if (!lower.empty())
+    {
+        compiler->extensions.insert(lower);
+    }
+}
+
+/**
+ Adds the extensions listed in a file, one per line, such as the
+ valid-extensions.txt of the test assets.
+
+ @param compiler The compiler.
+ @param path The path of the list.
+ @return The number of extensions read, or -1 if the file could not be read.
+ */
+int AKAssetCompilerAddExtensionsFromFile(AKAssetCompiler *compiler,
+                                         const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    int nExtensions = 0;
+    char line[64];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        char *end = line;
+        while (*end != '\0' && !isspace((unsigned char)*end))
+        {
+            end++;
+        }
+        *end = '\0';
+        if (line[0] != '\0')
+        {
+            AKAssetCompilerAddExtension(compiler, line);
+            nExtensions++;
+        }
+    }
+    fclose(file);
+    return nExtensions;
+}
+
+#pragma mark - Directories
+
+/**
+ Adds the files of a directory and its subdirectories with one of the
+ extensions of the compiler to a list.
+
+ @param compiler The compiler.
+ @param directory The path of the directory relative to the input directory,
+ empty for the input directory.
+ @param paths The list of paths relative to the input directory to add to.
+ */
+static void listFiles(const AKAssetCompiler *compiler,
+                      const std::string &directory,
+                      std::vector<std::string> *paths)
+{
+    std::string fullPath = compiler->inputDirectory;
+    if (!directory.empty())
+    {
+        fullPath += "/" + directory;
+    }
+    DIR *dir = opendir(fullPath.c_str());
+    if (dir == NULL)
+    {
+        return;
+    }
+    struct dirent *dirent;
+    while ((dirent = readdir(dir)) != NULL)
+    {
+        std::string name = dirent->d_name;
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+        std::string path = directory.empty() ? name : directory + "/" + name;
+        struct stat info;
+        if (stat((fullPath + "/" + name).c_str(), &info) != 0)
+        {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode))
+        {
+            listFiles(compiler, path, paths);
+            continue;
+        }
+        size_t dot = name.rfind('.');
+        if (dot == std::string::npos)
+        {
+            continue;
+        }
+        std::string extension = name.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       ::tolower);
+        if (compiler->extensions.count(extension) > 0)
+        {
+            paths->push_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ Creates a directory and its parent directories.
+
+ @param directory The path of the directory.
+ @return true if the directory exists.
+ */
+static bool makeDirectory(const std::string &directory)
+{
+    for (size_t slash = directory.find('/', 1); slash != std::string::npos;
+         slash = directory.find('/', slash + 1))
+    {
+        mkdir(directory.substr(0, slash).c_str(), 0755);
+    }
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        return false;
+    }
+    struct stat info;
+    return stat(directory.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+/**
+ Returns the size of a file.
+
+ @param path The path of the file.
+ @return The size in bytes, or 0 if the file does not exist.
+ */
+static size_t fileSize(const std::string &path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? (size_t)info.st_size : 0;
+}
+
+#pragma mark - Manifest
+
+/**
+ Returns the path of a file of the output directory.
+
+ @param compiler The compiler.
+ @param name The path of the file relative to the output directory.
+ @return The path of the file.
+ */
+static std::string outputPath(const AKAssetCompiler *compiler,
+                              const std::string &name)
+{
+    return compiler->outputDirectory + "/" + name;
+}
+
+/**
+ Reads the manifest of the last run. A manifest of another version or of
+ other settings is read without its assets, so that every file is compiled
+ again, but the assets it lists are still removed when their files are gone.
+
+ @param compiler The compiler.
+ @param manifest Set to the assets of the manifest, by the path of their
+ file.
+ @return true if the assets of the manifest are up to date with the
+ settings of the compiler.
+ */
+static bool readManifest(const AKAssetCompiler *compiler,
+                         std::map<std::string, AKManifestEntry> *manifest)
+{
+    std::string path = outputPath(compiler, AK_ASSET_MANIFEST_NAME);
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+    unsigned int version = 0;
+    unsigned long long settingsKey = 0;
+    bool current = fscanf(file, "AKASSETS %u %llx\n", &version,
+                          &settingsKey) == 2 &&
+                   version == AK_ASSET_MANIFEST_VERSION;
+    std::string line;
+    int c;
+    while (current && (c = fgetc(file)) != EOF)
+    {
+        if (c != '\n')
+        {
+            line += (char)c;
+            continue;
+        }
+        size_t tabs[3];
+        tabs[0] = line.find('\t');
+        tabs[1] = line.find('\t', tabs[0] + 1);
+        tabs[2] = line.find('\t', tabs[1] + 1);
+        if (tabs[0] != std::string::npos && tabs[1] != std::string::npos &&
+            tabs[2] != std::string::npos)
+        {
+            AKManifestEntry entry;
+            entry.key = strtoull(line.c_str(), NULL, 16);
+            entry.assetBytes =
+                (size_t)strtoull(line.c_str() + tabs[0] + 1, NULL, 10);
+            entry.assetPath = line.substr(tabs[2] + 1);
+            (*manifest)[line.substr(tabs[1] + 1, tabs[2] - tabs[1] - 1)] =
+                entry;
+        }
+        line.clear();
+    }
+    fclose(file);
+    return current && settingsKey == compiler->settingsKey;
+}
+
+/**
+ Writes the manifest of the assets of the last run, to a temporary file which
+ is then renamed so that a manifest is never read while it is written.
+
+ @param compiler The compiler.
+ @return true if the manifest was written.
+ */
+static bool writeManifest(const AKAssetCompiler *compiler)
+{
+    std::string path = outputPath(compiler, AK_ASSET_MANIFEST_NAME);
+    std::string tempPath = path + ".tmp";
+    FILE *file = fopen(tempPath.c_str(), "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+    fprintf(file, "AKASSETS %u %016llx\n", AK_ASSET_MANIFEST_VERSION,
+            compiler->settingsKey);
+    for (size_t i = 0; i < compiler->entries.size(); i++)
+    {
+        const AKAssetEntry &entry = compiler->entries[i];
+        if (entry.status != AKAssetFailed)
+        {
+            fprintf(file, "%016llx\t%zu\t%s\t%s\n", entry.key,
+                    entry.assetBytes, entry.path.c_str(),
+                    entry.assetPath.c_str());
+        }
+    }
+    bool failed = ferror(file) != 0;
+    if (fclose(file) != 0 || failed ||
+        rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+#pragma mark - Compiling assets
+
+/**
+ Hashes a file into the key of its asset, and compiles it unless its asset is
+ up to date.
+
+ The asset is written to a temporary file which is then renamed, so that a
+ failed compile does not leave a partial asset.
+
+ @param context The compiler.
+ @param item The index of the file in the reports.
+ @param worker Unused.
+ */
+static void compileItem(void *context, size_t item, unsigned int worker)
+{
+    AKAssetCompiler *compiler = (AKAssetCompiler *)context;
+    AKAssetEntry &entry = compiler->entries[item];
+    double start = AKImportStatsClock();
+    std::string path = compiler->inputDirectory + "/" + entry.path;
+    std::string assetPath = outputPath(compiler, entry.assetPath);
+    entry.fileBytes = fileSize(path);
+    unsigned long long key = AKSceneCacheKeyMake();
+    if (!AKSceneCacheKeyAddFile(&key, path.c_str()))
+    {
+        entry.status = AKAssetFailed;
+        entry.error = "could not read the file";
+    }
+    else
+    {
+        entry.key = AKSceneCacheKeyAdd(key, &compiler->settingsKey,
+                                       sizeof(compiler->settingsKey));
+        std::map<std::string, AKManifestEntry>::const_iterator found =
+            compiler->manifest.find(entry.path);
+        if (found != compiler->manifest.end() &&
+            found->second.key == entry.key &&
+            found->second.assetPath == entry.assetPath &&
+            found->second.assetBytes == fileSize(assetPath))
+        {
+            entry.status = AKAssetUpToDate;
+            entry.assetBytes = found->second.assetBytes;
+        }
+    }
+    if (entry.status == AKAssetCompiled)
+    {
+        std::string directory = assetPath.substr(0, assetPath.rfind('/'));
+        char error[256] = "";
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), ".%d.tmp", (int)getpid());
+        std::string tempPath = assetPath + suffix;
+        if (!makeDirectory(directory))
+        {
+            snprintf(error, sizeof(error), "could not create %s",
+                     directory.c_str());
+        }
+        else
+        {
+            entry.assetBytes =
+                compiler->function(compiler->context, path.c_str(),
+                                   tempPath.c_str(), entry.key, error,
+                                   sizeof(error));
+        }
+        if (entry.assetBytes == 0 ||
+            rename(tempPath.c_str(), assetPath.c_str()) != 0)
+        {
+            entry.status = AKAssetFailed;
+            entry.error = error[0] != '\0' ? error : "could not compile";
+            entry.assetBytes = 0;
+            remove(tempPath.c_str());
+        }
+    }
+    if (entry.status == AKAssetFailed)
+    {
+        // a stale asset is not left next to the manifest which omits it
+        remove(assetPath.c_str());
+    }
+    entry.milliseconds = (AKImportStatsClock() - start) * 1000.0;
+}
+
+/**
+ Compiles the files which changed since the last run, removes the assets of
+ the files which are gone, and writes the manifest.
+
+ The files are hashed and compiled on the workers of the pool with the size
+ of each file as its cost. A file which fails has no asset and is left out of
+ the manifest, so that it is compiled again by the next run.
+
+ @param compiler The compiler.
+ @param pool The work pool, or NULL to compile the files on the calling
+ thread.
+ @return 1 if every file was compiled or up to date and the manifest was
+ written, 0 otherwise.
+ */
+int AKAssetCompilerRun(AKAssetCompiler *compiler, AKWorkPool *pool)
+{
+    std::map<std::string, AKManifestEntry> manifest;
+    bool current = readManifest(compiler, &manifest);
+    std::vector<std::string> paths;
+    listFiles(compiler, "", &paths);
+    std::sort(paths.begin(), paths.end());
+
+    // the assets of the files which are gone are removed
+    compiler->nRemoved = 0;
+    std::set<std::string> listed(paths.begin(), paths.end());
+    for (std::map<std::string, AKManifestEntry>::const_iterator it =
+             manifest.begin();
+         it != manifest.end(); ++it)
+    {
+        if (listed.count(it->first) == 0 &&
+            remove(outputPath(compiler, it->second.assetPath).c_str()) == 0)
+        {
+            compiler->nRemoved++;
+        }
+    }
+    if (!current)
+    {
+        manifest.clear();
+    }
+    compiler->manifest.swap(manifest);
+
+    compiler->entries.assign(paths.size(), AKAssetEntry());
+    std::vector<size_t> costs(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        AKAssetEntry &entry = compiler->entries[i];
+        entry.path = paths[i];
+        entry.assetPath = paths[i] + AKAssetSuffix;
+        entry.status = AKAssetCompiled;
+        entry.key = 0;
+        entry.fileBytes = 0;
+        entry.assetBytes = 0;
+        entry.milliseconds = 0.0;
+        costs[i] = fileSize(compiler->inputDirectory + "/" + paths[i]);
+    }
+    if (!makeDirectory(compiler->outputDirectory))
+    {
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            compiler->entries[i].status = AKAssetFailed;
+            compiler->entries[i].error = "could not create the output "
+                                         "directory";
+        }
+        compiler->manifest.clear();
+        return 0;
+    }
+    if (pool != NULL)
+    {
+        AKWorkPoolRun(pool, paths.size(), costs.empty() ? NULL : &costs[0],
+                      compileItem, compiler);
+    }
+    else
+    {
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            compileItem(compiler, i, 0);
+        }
+    }
+    compiler->manifest.clear();
+    bool compiled = true;
+    for (size_t i = 0; i < compiler->entries.size(); i++)
+    {
+        compiled = compiled && compiler->entries[i].status != AKAssetFailed;
+    }
+    bool written = writeManifest(compiler);
+    return compiled && written ? 1 : 0;
+}
+
+/**
+ Returns the number of files of the last run.
+
+ @param compiler The compiler.
+ @return The number of reports.
+ */
+size_t AKAssetCompilerReportCount(const AKAssetCompiler *compiler)
+{
+    return compiler->entries.size();
+}
+
+/**
+ Returns the report of a file of the last run, in the order of the paths of
+ the files.
+
+ @param compiler The compiler.
+ @param index The index of the file, less than the number of reports.
+ @return The report, whose strings are owned by the compiler until its next
+ run.
+ */
+AKAssetReport AKAssetCompilerReportAt(const AKAssetCompiler *compiler,
+                                      size_t index)
+{
+    const AKAssetEntry &entry = compiler->entries[index];
+    AKAssetReport report;
+    report.path = entry.path.c_str();
+    report.assetPath = entry.assetPath.c_str();
+    report.error = entry.error.c_str();
+    report.status = entry.status;
+    report.key = entry.key;
+    report.fileBytes = entry.fileBytes;
+    report.assetBytes = entry.assetBytes;
+    report.milliseconds = entry.milliseconds;
+    return report;
+}
+
+/**
+ Returns the number of assets of files which are gone, removed by the last
+ run.
+
+ @param compiler The compiler.
+ @return The number of assets removed.
+ */
+size_t AKAssetCompilerRemovedCount(const AKAssetCompiler *compiler)
+{
+    return compiler->nRemoved;
+}
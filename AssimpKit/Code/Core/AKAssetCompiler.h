@@ -0,0 +1,281 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKAssetCompiler_h
+#define AKAssetCompiler_h
+
+#include "AKWorkPool.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ An offline compiler of a directory tree of scene files into a directory tree
+ of runtime assets, so that the scenes are converted when the assets are built
+ instead of when they are loaded.
+
+ The compiler lists the files of the input directory and its subdirectories
+ with one of its extensions, and compiles each file on the workers of a work
+ pool into an asset at the same relative path in the output directory, with
+ the .akscene suffix added to its name. The compiling itself is done by the
+ compile function of the compiler, such as an import of the file followed by
+ the conversion of its scene into a scene archive.
+
+ The compiler is incremental. The key of each asset is the hash of the bytes
+ of its file and of the settings key of the compiler, and the manifest of the
+ output directory records the key of each asset compiled before. A file whose
+ key and asset are unchanged since the last run is not compiled again, the
+ asset of a file which is no longer listed is removed, and every file is
+ compiled again when the settings key changes.
+
+ The manifest, AK_ASSET_MANIFEST_NAME in the output directory, is a text file
+ which starts with the line
+
+     AKASSETS <manifest version> <settings key>
+
+ followed by one line per asset, in the order of the paths of the files:
+
+     <key> <asset size> <file path> <asset path>
+
+ The fields are separated by tabs, the keys are 16 hexadecimal digits, the
+ size is in bytes and the paths are relative to the input and the output
+ directories. The key of an asset is the key its scene archive is opened
+ with.
+ */
+typedef struct AKAssetCompiler AKAssetCompiler;
+
+/**
+ The name of the manifest in the output directory.
+ */
+#define AK_ASSET_MANIFEST_NAME "manifest.txt"
+
+/**
+ The version of the manifest format, which a compiler only reads manifests
+ of.
+ */
+#define AK_ASSET_MANIFEST_VERSION 1
+
+/**
+ What the last run of a compiler did with a file.
+ */
+typedef enum AKAssetStatus
+{
+    /**
+     The file was compiled into its asset.
+     */
+    AKAssetCompiled = 0,
+
+    /**
+     The file and its asset were unchanged since the last run, so the file
+     was not compiled.
+     */
+    AKAssetUpToDate,
+
+    /**
+     The file could not be read or compiled, and has no asset.
+     */
+    AKAssetFailed
+} AKAssetStatus;
+
+/**
+ The report of the compiling of a file by the last run of a compiler.
+ */
+typedef struct AKAssetReport
+{
+    /**
+     The path of the file relative to the input directory.
+     */
+    const char *path;
+
+    /**
+     The path of the asset relative to the output directory.
+     */
+    const char *assetPath;
+
+    /**
+     The description of the failure, or an empty string.
+     */
+    const char *error;
+
+    /**
+     What the run did with the file.
+     */
+    AKAssetStatus status;
+
+    /**
+     The key of the asset.
+     */
+    unsigned long long key;
+
+    /**
+     The size of the file in bytes.
+     */
+    size_t fileBytes;
+
+    /**
+     The size of the asset in bytes, or 0 if the file failed.
+     */
+    size_t assetBytes;
+
+    /**
+     The time taken to hash and compile the file, in milliseconds.
+     */
+    double milliseconds;
+} AKAssetReport;
+
+/**
+ The function which compiles a file into its asset.
+
+ The function is called on a worker thread, and may be called on several
+ workers at the same time for different files.
+
+ @param context The context passed to AKAssetCompilerCreate.
+ @param path The path of the file.
+ @param assetPath The path of the asset to write, in an existing directory.
+ @param key The key of the asset, to store in the asset.
+ @param error The buffer which receives the description of a failure.
+ @param nErrorBytes The size of the error buffer.
+ @return The size of the asset written in bytes, or 0 if the file could not
+ be compiled.
+ */
+typedef size_t (*AKAssetCompileFunction)(void *context,
+                                         const char *path,
+                                         const char *assetPath,
+                                         unsigned long long key,
+                                         char *error,
+                                         size_t nErrorBytes);
+
+#pragma mark - Creating an asset compiler
+
+/**
+ Creates an asset compiler without extensions.
+
+ @param inputDirectory The directory of the scene files.
+ @param outputDirectory The directory of the assets, created when the
+ compiler runs if it does not exist.
+ @param settingsKey The hash of the settings the assets are compiled with,
+ such as the post processing flags and the vertex layout.
+ @param function The function which compiles a file.
+ @param context The context passed to the compile function.
+ @return A new compiler which must be released with AKAssetCompilerRelease.
+ */
+AKAssetCompiler *AKAssetCompilerCreate(const char *inputDirectory,
+                                       const char *outputDirectory,
+                                       unsigned long long settingsKey,
+                                       AKAssetCompileFunction function,
+                                       void *context);
+
+/**
+ Releases the compiler and its reports.
+
+ @param compiler The compiler, may be NULL.
+ */
+void AKAssetCompilerRelease(AKAssetCompiler *compiler);
+
+/**
+ Adds an extension of the files to compile.
+
+ @param compiler The compiler.
+ @param extension The extension without the dot, such as dae, which matches
+ the names of the files regardless of case.
+ */
+void AKAssetCompilerAddExtension(AKAssetCompiler *compiler,
+                                 const char *extension);
+
+/**
+ Adds the extensions listed in a file, one per line, such as the
+ valid-extensions.txt of the test assets.
+
+ @param compiler The compiler.
+ @param path The path of the list.
+ @return The number of extensions read, or -1 if the file could not be read.
+ */
+int AKAssetCompilerAddExtensionsFromFile(AKAssetCompiler *compiler,
+                                         const char *path);
+
+#pragma mark - Compiling assets
+
+/**
+ Compiles the files which changed since the last run, removes the assets of
+ the files which are gone, and writes the manifest.
+
+ The files are hashed and compiled on the workers of the pool with the size
+ of each file as its cost. A file which fails has no asset and is left out of
+ the manifest, so that it is compiled again by the next run.
+
+ @param compiler The compiler.
+ @param pool The work pool, or NULL to compile the files on the calling
+ thread.
+ @return 1 if every file was compiled or up to date and the manifest was
+ written, 0 otherwise.
+ */
+int AKAssetCompilerRun(AKAssetCompiler *compiler, AKWorkPool *pool);
+
+/**
+ Returns the number of files of the last run.
+
+ @param compiler The compiler.
+ @return The number of reports.
+ */
+size_t AKAssetCompilerReportCount(const AKAssetCompiler *compiler);
+
+/**
+ Returns the report of a file of the last run, in the order of the paths of
+ the files.
+
+ @param compiler The compiler.
+ @param index The index of the file, less than the number of reports.
+ @return The report, whose strings are owned by the compiler until its next
+ run.
+ */
+AKAssetReport AKAssetCompilerReportAt(const AKAssetCompiler *compiler,
+                                      size_t index);
+
+/**
+ Returns the number of assets of files which are gone, removed by the last
+ run.
+
+ @param compiler The compiler.
+ @return The number of assets removed.
+ */
+size_t AKAssetCompilerRemovedCount(const AKAssetCompiler *compiler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKAssetCompiler_h */
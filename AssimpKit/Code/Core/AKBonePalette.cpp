@@ -0,0 +1,295 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBonePalette.h"
+#include <string.h>
+#include <vector>
+
+/**
+ A slot of the open addressing hash table of the palette.
+ */
+struct AKBonePaletteSlot
+{
+    /**
+     The hash of the bone name.
+     */
+    unsigned int hash;
+
+    /**
+     The palette index of the bone, or -1 if the slot is empty.
+     */
+    int index;
+};
+
+/**
+ The unique bone names of a scene, interned in a single string pool in palette
+ order and found by an open addressing hash table of their palette indices.
+ */
+struct AKBonePalette
+{
+    /**
+     The interned bone names, each terminated by a null character.
+     */
+    std::vector<char> names;
+
+    /**
+     The offset of the name of each bone in the interned names.
+     */
+    std::vector<unsigned int> nameOffsets;
+
+    /**
+     The length of the name of each bone.
+     */
+    std::vector<unsigned int> nameLengths;
+
+    /**
+     The hash table, whose size is a power of two at least twice the number
+     of bones.
+     */
+    std::vector<AKBonePaletteSlot> slots;
+};
+
+#pragma mark - Hash bone names
+
+/**
+ Hashes a bone name with the 32 bit FNV-1a hash.
+
+ @param name The bone name.
+ @param length The length of the bone name.
+ @return The hash.
+ */
+static unsigned int hashName(const char *name, size_t length)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ Finds the slot of the specified bone name in the hash table.
+
+ @param palette The bone palette.
+ @param name The bone name.
+ @param length The length of the bone name.
+ @param hash The hash of the bone name.
+ @return The slot holding the bone, or the empty slot where it belongs.
+ */
+static AKBonePaletteSlot *findSlot(const AKBonePalette *palette,
+                                   const char *name,
+                                   size_t length,
+                                   unsigned int hash)
+{
+    size_t mask = palette->slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        const AKBonePaletteSlot *slot = &palette->slots[i];
+        if (slot->index < 0)
+        {
+            return const_cast<AKBonePaletteSlot *>(slot);
+        }
+        if (slot->hash == hash && palette->nameLengths[slot->index] == length &&
+            memcmp(&palette->names[palette->nameOffsets[slot->index]], name,
+                   length) == 0)
+        {
+            return const_cast<AKBonePaletteSlot *>(slot);
+        }
+    }
+}
+
+#pragma mark - Collect the bones of a scene
+
+/**
+ Counts the bones, including the duplicates, in the meshes of the node and its
+ descendants.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @return The number of bones.
+ */
+static unsigned int countBones(const struct aiNode *aiNode,
+                               const struct aiScene *aiScene)
+{
+    unsigned int nBones = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        nBones += aiScene->mMeshes[aiNode->mMeshes[i]]->mNumBones;
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        nBones += countBones(aiNode->mChildren[i], aiScene);
+    }
+    return nBones;
+}
+
+/**
+ Adds the bones in the meshes of the node and its descendants to the palette,
+ in depth first order.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette.
+ */
+static void addBones(const struct aiNode *aiNode,
+                     const struct aiScene *aiScene,
+                     AKBonePalette *palette)
+{
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            const struct aiString *name = &aiMesh->mBones[j]->mName;
+            unsigned int hash = hashName(name->data, name->length);
+            AKBonePaletteSlot *slot =
+                findSlot(palette, name->data, name->length, hash);
+            if (slot->index >= 0)
+            {
+                continue;
+            }
+            slot->hash = hash;
+            slot->index = (int)palette->nameOffsets.size();
+            palette->nameOffsets.push_back(
+                (unsigned int)palette->names.size());
+            palette->nameLengths.push_back(name->length);
+            palette->names.insert(palette->names.end(), name->data,
+                                  name->data + name->length);
+            palette->names.push_back('\0');
+        }
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        addBones(aiNode->mChildren[i], aiScene, palette);
+    }
+}
+
+#pragma mark - Make a bone palette
+
+/**
+ Creates the bone palette for the bones in the meshes of the specified scene.
+
+ @param aiScene The assimp scene.
+ @return A new bone palette which must be released with AKBonePaletteRelease.
+ */
+AKBonePalette *AKBonePaletteCreate(const struct aiScene *aiScene)
+{
+    AKBonePalette *palette = new AKBonePalette();
+    if (aiScene->mRootNode == NULL)
+    {
+        palette->slots.resize(1);
+        palette->slots[0].index = -1;
+        return palette;
+    }
+    // size the table for the worst case where all the bones are unique
+    unsigned int nBones = countBones(aiScene->mRootNode, aiScene);
+    size_t nSlots = 1;
+    while (nSlots < 2 * (size_t)nBones + 1)
+    {
+        nSlots <<= 1;
+    }
+    AKBonePaletteSlot emptySlot = {0, -1};
+    palette->slots.assign(nSlots, emptySlot);
+    palette->nameOffsets.reserve(nBones);
+    palette->nameLengths.reserve(nBones);
+    addBones(aiScene->mRootNode, aiScene, palette);
+    return palette;
+}
+
+/**
+ Releases the bone palette and its interned names.
+
+ @param palette The bone palette, may be NULL.
+ */
+void AKBonePaletteRelease(AKBonePalette *palette)
+{
+    delete palette;
+}
+
+#pragma mark - Find bones in the palette
+
+/**
+ Finds the number of unique bones in the palette.
+
+ @param palette The bone palette.
+ @return The number of bones.
+ */
+unsigned int AKBonePaletteCount(const AKBonePalette *palette)
+{
+    return (unsigned int)palette->nameOffsets.size();
+}
+
+/**
+ Finds the name of the bone at the specified palette index.
+
+ @param palette The bone palette.
+ @param index The palette index, less than AKBonePaletteCount.
+ @return The interned bone name, valid until the palette is released.
+ */
+const char *AKBonePaletteName(const AKBonePalette *palette, unsigned int index)
+{
+    return &palette->names[palette->nameOffsets[index]];
+}
+
+/**
+ Finds the palette index of the bone with the specified name.
+
+ @param palette The bone palette.
+ @param name The bone name.
+ @return The palette index, or -1 if the palette has no such bone.
+ */
+int AKBonePaletteIndexOfName(const AKBonePalette *palette, const char *name)
+{
+    size_t length = strlen(name);
+    return findSlot(palette, name, length, hashName(name, length))->index;
+}
+
+/**
+ Finds the palette index of the specified bone.
+
+ @param palette The bone palette.
+ @param aiBone The assimp bone.
+ @return The palette index, or -1 if the palette has no such bone.
+ */
+int AKBonePaletteIndexOfBone(const AKBonePalette *palette,
+                             const struct aiBone *aiBone)
+{
+    const struct aiString *name = &aiBone->mName;
+    return findSlot(palette, name->data, name->length,
+                    hashName(name->data, name->length))
+        ->index;
+}
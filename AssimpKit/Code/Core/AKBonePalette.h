@@ -0,0 +1,120 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKBonePalette_h
+#define AKBonePalette_h
+
+#include "assimp/scene.h" // Output data structure
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Bone palette
+
+/**
+ The unique bone names of a scene and their indices in the skinner's bones
+ array.
+
+ The palette is built once per import. The bone names are interned in a single
+ string pool and are looked up with a hash table, so that finding the palette
+ index of a bone does not depend on the number of bones.
+
+ The bones are ordered by their first appearance in a depth first traversal of
+ the node hierarchy, visiting the meshes of a node and the bones of a mesh in
+ order. This order is the same for every import of a file.
+ */
+typedef struct AKBonePalette AKBonePalette;
+
+#pragma mark - Make a bone palette
+
+/**
+ Creates the bone palette for the bones in the meshes of the specified scene.
+
+ @param aiScene The assimp scene.
+ @return A new bone palette which must be released with AKBonePaletteRelease.
+ */
+AKBonePalette *AKBonePaletteCreate(const struct aiScene *aiScene);
+
+/**
+ Releases the bone palette and its interned names.
+
+ @param palette The bone palette, may be NULL.
+ */
+void AKBonePaletteRelease(AKBonePalette *palette);
+
+#pragma mark - Find bones in the palette
+
+/**
+ Finds the number of unique bones in the palette.
+
+ @param palette The bone palette.
+ @return The number of bones.
+ */
+unsigned int AKBonePaletteCount(const AKBonePalette *palette);
+
+/**
+ Finds the name of the bone at the specified palette index.
+
+ @param palette The bone palette.
+ @param index The palette index, less than AKBonePaletteCount.
+ @return The interned bone name, valid until the palette is released.
+ */
+const char *AKBonePaletteName(const AKBonePalette *palette, unsigned int index);
+
+/**
+ Finds the palette index of the bone with the specified name.
+
+ @param palette The bone palette.
+ @param name The bone name.
+ @return The palette index, or -1 if the palette has no such bone.
+ */
+int AKBonePaletteIndexOfName(const AKBonePalette *palette, const char *name);
+
+/**
+ Finds the palette index of the specified bone.
+
+ @param palette The bone palette.
+ @param aiBone The assimp bone.
+ @return The palette index, or -1 if the palette has no such bone.
+ */
+int AKBonePaletteIndexOfBone(const AKBonePalette *palette,
+                             const struct aiBone *aiBone);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKBonePalette_h */
@@ -0,0 +1,749 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKFileSystem.h"
+#include <chrono>
+#include <fcntl.h>
+#include <map>
+#include <set>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ The size of the buffer of a stream, so that the many small reads of the
+ loaders are served from memory.
+ */
+static const size_t AKStreamBufferSize = 64 * 1024;
+
+#pragma mark - File system
+
+/**
+ The bytes of a file which is read in place.
+ */
+struct AKFileBuffer
+{
+    /**
+     The bytes of the file.
+     */
+    const void *data;
+
+    /**
+     The number of bytes of the file.
+     */
+    size_t length;
+};
+
+/**
+ A file on the disk, which the file system keeps open once it is opened.
+ */
+struct AKDiskFile
+{
+    /**
+     true if the file exists and is a regular file.
+     */
+    bool exists;
+
+    /**
+     The size of the file.
+     */
+    size_t size;
+
+    /**
+     The memory mapping of the file, or NULL if it is not mapped.
+     */
+    void *mapping;
+
+    /**
+     The streams of the file which are not in use, rewound on the next open.
+     */
+    std::vector<FILE *> idleStreams;
+};
+
+/**
+ The files which an import reads.
+ */
+struct AKFileSystem
+{
+    /**
+     The memory files and the resolved files by path.
+     */
+    std::map<std::string, AKFileBuffer> buffers;
+
+    /**
+     The paths which the resolver did not resolve.
+     */
+    std::set<std::string> unresolved;
+
+    /**
+     The files on the disk by path, including the files which do not exist.
+     */
+    std::map<std::string, AKDiskFile> diskFiles;
+
+    /**
+     The paths of the disk files in the order they were looked for.
+     */
+    std::vector<std::string> diskPaths;
+
+    /**
+     The resolver, or NULL.
+     */
+    AKFileResolver resolver;
+
+    /**
+     The context passed to the resolver.
+     */
+    void *resolverContext;
+
+    /**
+     The base directory with a trailing separator, or empty for none.
+     */
+    std::string baseDirectory;
+
+    /**
+     Non zero if the files read from the disk are memory mapped.
+     */
+    int mapsFiles;
+
+    /**
+     The reads of the file system.
+     */
+    AKFileSystemStats stats;
+};
+
+/**
+ A read only file.
+ */
+struct AKFile
+{
+    /**
+     The file system which opened the file.
+     */
+    AKFileSystem *fs;
+
+    /**
+     The file on the disk, or NULL for a memory or resolved file.
+     */
+    AKDiskFile *disk;
+
+    /**
+     The bytes of a file read in place, else NULL.
+     */
+    const unsigned char *bytes;
+
+    /**
+     The size of the file.
+     */
+    size_t size;
+
+    /**
+     The current position.
+     */
+    size_t position;
+
+    /**
+     The stream of a file read with buffered reads, else NULL.
+     */
+    FILE *stream;
+};
+
+/**
+ Returns the time of a steady clock.
+
+ @return The time in seconds.
+ */
+static double ioClock()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+#pragma mark - Creating a file system
+
+/**
+ Creates a file system which reads files from the disk with buffered reads.
+
+ @return A new file system which must be released with AKFileSystemRelease.
+ */
+AKFileSystem *AKFileSystemCreate(void)
+{
+    AKFileSystem *fs = new AKFileSystem;
+    fs->resolver = NULL;
+    fs->resolverContext = NULL;
+    fs->mapsFiles = 0;
+    memset(&fs->stats, 0, sizeof(fs->stats));
+    return fs;
+}
+
+/**
+ Releases the file system and the files it keeps open. The files opened from
+ it must be closed first.
+
+ @param fs The file system, may be NULL.
+ */
+void AKFileSystemRelease(AKFileSystem *fs)
+{
+    if (fs == NULL)
+    {
+        return;
+    }
+    std::map<std::string, AKDiskFile>::iterator it;
+    for (it = fs->diskFiles.begin(); it != fs->diskFiles.end(); ++it)
+    {
+        AKDiskFile &disk = it->second;
+        for (size_t i = 0; i < disk.idleStreams.size(); i++)
+        {
+            fclose(disk.idleStreams[i]);
+        }
+        if (disk.mapping != NULL)
+        {
+            munmap(disk.mapping, disk.size);
+        }
+    }
+    delete fs;
+}
+
+#pragma mark - Configuring a file system
+
+/**
+ Adds a memory file, whose bytes are read in place and are not copied.
+
+ @param fs The file system.
+ @param name The name of the file.
+ @param data The bytes of the file, which must stay valid and unchanged until
+ the file system is released.
+ @param length The number of bytes of the file.
+ */
+void AKFileSystemAddMemoryFile(AKFileSystem *fs,
+                               const char *name,
+                               const void *data,
+                               size_t length)
+{
+    AKFileBuffer buffer = {data, length};
+    fs->buffers[name] = buffer;
+}
+
+/**
+ Sets the resolver which supplies the files which are not memory files.
+
+ @param fs The file system.
+ @param resolver The resolver, or NULL to read the other files from the disk.
+ @param context The context passed to the resolver.
+ */
+void AKFileSystemSetResolver(AKFileSystem *fs,
+                             AKFileResolver resolver,
+                             void *context)
+{
+    fs->resolver = resolver;
+    fs->resolverContext = context;
+    fs->unresolved.clear();
+}
+
+/**
+ Sets the directory which the names passed to the resolver are relative to,
+ usually the directory of the scene file.
+
+ @param fs The file system.
+ @param directory The base directory, or NULL or "" for none.
+ */
+void AKFileSystemSetBaseDirectory(AKFileSystem *fs, const char *directory)
+{
+    fs->baseDirectory = directory != NULL ? directory : "";
+    if (!fs->baseDirectory.empty() &&
+        fs->baseDirectory[fs->baseDirectory.size() - 1] != '/')
+    {
+        fs->baseDirectory += '/';
+    }
+}
+
+/**
+ Sets if the files read from the disk are memory mapped.
+
+ @param fs The file system.
+ @param mapsFiles Non zero to memory map the files, zero to read them with
+ buffered reads.
+ */
+void AKFileSystemSetMapsFiles(AKFileSystem *fs, int mapsFiles)
+{
+    fs->mapsFiles = mapsFiles;
+}
+
+#pragma mark - Opening files
+
+/**
+ Finds the bytes of a memory file or a file which the resolver supplies.
+
+ A file is resolved once, and its bytes are kept with the memory files.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @return The bytes of the file, or NULL if it is neither a memory file nor
+ resolved.
+ */
+static const AKFileBuffer *findBuffer(AKFileSystem *fs, const char *path)
+{
+    std::map<std::string, AKFileBuffer>::const_iterator it =
+        fs->buffers.find(path);
+    if (it != fs->buffers.end())
+    {
+        return &it->second;
+    }
+    if (fs->resolver == NULL || fs->unresolved.count(path) > 0)
+    {
+        return NULL;
+    }
+    const char *name = path;
+    if (!fs->baseDirectory.empty() &&
+        strncmp(path, fs->baseDirectory.c_str(), fs->baseDirectory.size()) ==
+            0)
+    {
+        name += fs->baseDirectory.size();
+    }
+    AKFileBuffer buffer = {NULL, 0};
+    if (!fs->resolver(fs->resolverContext, name, &buffer.data,
+                      &buffer.length))
+    {
+        fs->unresolved.insert(path);
+        return NULL;
+    }
+    fs->stats.nResolved++;
+    return &(fs->buffers[path] = buffer);
+}
+
+/**
+ Finds a file on the disk, which is looked up once per file system.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @return The disk file, which may not exist.
+ */
+static AKDiskFile *findDiskFile(AKFileSystem *fs, const char *path)
+{
+    std::map<std::string, AKDiskFile>::iterator it = fs->diskFiles.find(path);
+    if (it != fs->diskFiles.end())
+    {
+        return &it->second;
+    }
+    AKDiskFile &disk = fs->diskFiles[path];
+    fs->diskPaths.push_back(path);
+    struct stat info;
+    disk.exists = stat(path, &info) == 0 && S_ISREG(info.st_mode);
+    disk.size = disk.exists ? (size_t)info.st_size : 0;
+    disk.mapping = NULL;
+    return &disk;
+}
+
+/**
+ Memory maps a file from the disk, unless it is already mapped.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @param disk The disk file.
+ @return true if the file is mapped, false if it cannot be mapped or is
+ empty.
+ */
+static bool mapDiskFile(AKFileSystem *fs, const char *path, AKDiskFile *disk)
+{
+    if (disk->mapping != NULL)
+    {
+        return true;
+    }
+    if (disk->size == 0)
+    {
+        return false;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    void *mapping = mmap(NULL, disk->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file open
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    disk->mapping = mapping;
+    fs->stats.nDiskOpens++;
+    return true;
+}
+
+/**
+ Opens a stream of a file from the disk, reusing a stream which is not in
+ use.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @param disk The disk file.
+ @return The stream at the start of the file, or NULL if the file cannot be
+ opened.
+ */
+static FILE *openDiskStream(AKFileSystem *fs,
+                            const char *path,
+                            AKDiskFile *disk)
+{
+    if (!disk->idleStreams.empty())
+    {
+        FILE *stream = disk->idleStreams.back();
+        disk->idleStreams.pop_back();
+        rewind(stream);
+        fs->stats.nCachedOpens++;
+        return stream;
+    }
+    FILE *stream = fopen(path, "rb");
+    if (stream != NULL)
+    {
+        setvbuf(stream, NULL, _IOFBF, AKStreamBufferSize);
+        fs->stats.nDiskOpens++;
+    }
+    return stream;
+}
+
+/**
+ Determines if a file can be opened.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @return 1 if the file can be opened, else 0.
+ */
+int AKFileSystemExists(AKFileSystem *fs, const char *path)
+{
+    if (findBuffer(fs, path) != NULL)
+    {
+        return 1;
+    }
+    return findDiskFile(fs, path)->exists ? 1 : 0;
+}
+
+/**
+ Opens a file to read.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @return The file which must be closed with AKFileClose, or NULL if the file
+ cannot be opened.
+ */
+AKFile *AKFileSystemOpen(AKFileSystem *fs, const char *path)
+{
+    double start = ioClock();
+    fs->stats.nOpens++;
+    AKFile *file = new AKFile;
+    file->fs = fs;
+    file->disk = NULL;
+    file->bytes = NULL;
+    file->size = 0;
+    file->position = 0;
+    file->stream = NULL;
+    const AKFileBuffer *buffer = findBuffer(fs, path);
+    if (buffer != NULL)
+    {
+        file->bytes = (const unsigned char *)buffer->data;
+        file->size = buffer->length;
+        fs->stats.ioSeconds += ioClock() - start;
+        return file;
+    }
+    AKDiskFile *disk = findDiskFile(fs, path);
+    if (disk->exists)
+    {
+        file->disk = disk;
+        file->size = disk->size;
+        if (fs->mapsFiles && disk->mapping != NULL)
+        {
+            fs->stats.nCachedOpens++;
+            file->bytes = (const unsigned char *)disk->mapping;
+        }
+        else if (fs->mapsFiles && mapDiskFile(fs, path, disk))
+        {
+            file->bytes = (const unsigned char *)disk->mapping;
+        }
+        else
+        {
+            file->stream = openDiskStream(fs, path, disk);
+        }
+    }
+    fs->stats.ioSeconds += ioClock() - start;
+    if (file->bytes == NULL && file->stream == NULL)
+    {
+        delete file;
+        return NULL;
+    }
+    return file;
+}
+
+/**
+ Makes the path of a file which a scene refers to.
+
+ @param fs The file system.
+ @param name The name of the file in the scene.
+ @return The path of the file.
+ */
+static std::string referencePath(const AKFileSystem *fs, const char *name)
+{
+    std::string path = name;
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        path[i] = path[i] == '\\' ? '/' : path[i];
+    }
+    while (path.compare(0, 2, "./") == 0)
+    {
+        path.erase(0, 2);
+    }
+    return !path.empty() && path[0] == '/' ? path : fs->baseDirectory + path;
+}
+
+/**
+ Opens a file which a scene refers to, such as a texture, by the name in the
+ scene.
+
+ The name may use backslashes as separators, and is relative to the base
+ directory unless it is an absolute path.
+
+ @param fs The file system.
+ @param name The name of the file in the scene.
+ @return The file which must be closed with AKFileClose, or NULL if the file
+ cannot be opened.
+ */
+AKFile *AKFileSystemOpenReference(AKFileSystem *fs, const char *name)
+{
+    return AKFileSystemOpen(fs, referencePath(fs, name).c_str());
+}
+
+/**
+ Asks the kernel to read a file into its cache in the background.
+
+ @param fd The file descriptor.
+ @param size The size of the file.
+ */
+static void adviseWillRead(int fd, size_t size)
+{
+#if defined(F_RDADVISE)
+    struct radvisory advice;
+    advice.ra_offset = 0;
+    advice.ra_count = (int)size;
+    fcntl(fd, F_RDADVISE, &advice);
+#elif defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(fd, 0, (off_t)size, POSIX_FADV_WILLNEED);
+#endif
+}
+
+/**
+ Starts reading a file which a scene refers to from the disk, so that it is
+ in memory when it is opened.
+
+ A file in memory or supplied by the resolver is not read ahead.
+
+ @param fs The file system.
+ @param name The name of the file in the scene.
+ */
+void AKFileSystemReadAheadReference(AKFileSystem *fs, const char *name)
+{
+    double start = ioClock();
+    std::string path = referencePath(fs, name);
+    AKDiskFile *disk = NULL;
+    if (findBuffer(fs, path.c_str()) == NULL)
+    {
+        disk = findDiskFile(fs, path.c_str());
+    }
+    if (disk != NULL && disk->exists && disk->size > 0)
+    {
+        if (fs->mapsFiles && mapDiskFile(fs, path.c_str(), disk))
+        {
+            madvise(disk->mapping, disk->size, MADV_WILLNEED);
+            fs->stats.nReadAheads++;
+        }
+        else if (disk->idleStreams.empty())
+        {
+            // the stream is kept for the open which follows
+            FILE *stream = openDiskStream(fs, path.c_str(), disk);
+            if (stream != NULL)
+            {
+                adviseWillRead(fileno(stream), disk->size);
+                disk->idleStreams.push_back(stream);
+                fs->stats.nReadAheads++;
+            }
+        }
+    }
+    fs->stats.ioSeconds += ioClock() - start;
+}
+
+/**
+ Returns the number of paths which the file system looked for on the disk,
+ including the paths of the files which do not exist.
+
+ @param fs The file system.
+ @return The number of paths.
+ */
+size_t AKFileSystemDiskPathCount(const AKFileSystem *fs)
+{
+    return fs->diskPaths.size();
+}
+
+/**
+ Returns a path which the file system looked for on the disk, in the order
+ the paths were first looked for.
+
+ @param fs The file system.
+ @param index The index of the path, less than AKFileSystemDiskPathCount.
+ @return The path.
+ */
+const char *AKFileSystemDiskPath(const AKFileSystem *fs, size_t index)
+{
+    return fs->diskPaths[index].c_str();
+}
+
+#pragma mark - Statistics
+
+/**
+ Returns the reads of a file system since it was created.
+
+ @param fs The file system.
+ @return The statistics.
+ */
+AKFileSystemStats AKFileSystemGetStats(const AKFileSystem *fs)
+{
+    return fs->stats;
+}
+
+#pragma mark - Reading files
+
+/**
+ Reads bytes from the current position of a file and moves past them.
+
+ @param file The file.
+ @param buffer Receives the bytes.
+ @param nBytes The number of bytes to read.
+ @return The number of bytes read, less than nBytes at the end of the file.
+ */
+size_t AKFileRead(AKFile *file, void *buffer, size_t nBytes)
+{
+    double start = ioClock();
+    size_t left = file->size - file->position;
+    nBytes = nBytes < left ? nBytes : left;
+    if (file->stream != NULL)
+    {
+        nBytes = fread(buffer, 1, nBytes, file->stream);
+    }
+    else if (nBytes > 0)
+    {
+        memcpy(buffer, file->bytes + file->position, nBytes);
+    }
+    file->position += nBytes;
+    AKFileSystemStats &stats = file->fs->stats;
+    stats.nReads++;
+    stats.bytesRead += nBytes;
+    stats.ioSeconds += ioClock() - start;
+    return nBytes;
+}
+
+/**
+ Moves the current position of a file.
+
+ @param file The file.
+ @param offset The new position, from 0 to the size of the file.
+ @return 1 if the position was moved, 0 if it is out of the file.
+ */
+int AKFileSeek(AKFile *file, size_t offset)
+{
+    if (offset > file->size)
+    {
+        return 0;
+    }
+    if (file->stream != NULL && fseek(file->stream, (long)offset, SEEK_SET))
+    {
+        return 0;
+    }
+    file->position = offset;
+    return 1;
+}
+
+/**
+ Returns the current position of a file.
+
+ @param file The file.
+ @return The position in bytes from the start of the file.
+ */
+size_t AKFileTell(const AKFile *file)
+{
+    return file->position;
+}
+
+/**
+ Returns the size of a file.
+
+ @param file The file.
+ @return The size in bytes.
+ */
+size_t AKFileSize(const AKFile *file)
+{
+    return file->size;
+}
+
+/**
+ Returns the bytes of a file which is read in place: a memory file, a
+ resolved file or a memory mapped file.
+
+ @param file The file.
+ @return The bytes of the file, or NULL if the file is read with buffered
+ reads.
+ */
+const void *AKFileBytes(const AKFile *file)
+{
+    return file->bytes;
+}
+
+/**
+ Closes a file. The file system keeps the stream or the mapping of a file on
+ the disk for the next open of the file.
+
+ @param file The file, may be NULL.
+ */
+void AKFileClose(AKFile *file)
+{
+    if (file == NULL)
+    {
+        return;
+    }
+    if (file->stream != NULL)
+    {
+        file->disk->idleStreams.push_back(file->stream);
+    }
+    delete file;
+}
@@ -0,0 +1,334 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKFileSystem_h
+#define AKFileSystem_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ The files which an import reads: the scene file and the files it refers to,
+ such as the material library of an OBJ file.
+
+ A file is opened from the first of these places which has it:
+
+ 1. The memory files added to the file system, whose bytes are read in place.
+ 2. The resolver of the file system, which may supply the bytes of a file
+    from a pack file or a decrypted blob. The resolved bytes are read in
+    place.
+ 3. The disk, where a file is memory mapped if the file system maps files,
+    else read with buffered reads.
+
+ So a scene in memory and its external files are never written to disk or
+ copied by the file system. The file system is used by one import at a time.
+
+ The file system keeps the files it opens from the disk until it is
+ released: a mapped file stays mapped, and the stream of a file read with
+ buffered reads is rewound for the next open of the file. So a file which
+ the loaders open several times, such as a material library, is opened from
+ the disk once per import. The files which a scene refers to may be read
+ ahead, so that the disk reads them while the import does other work.
+ */
+typedef struct AKFileSystem AKFileSystem;
+
+/**
+ A read only file opened from a file system.
+ */
+typedef struct AKFile AKFile;
+
+/**
+ The reads of a file system since it was created.
+ */
+typedef struct AKFileSystemStats
+{
+    /**
+     The number of files opened, from memory, from the resolver or from the
+     disk.
+     */
+    size_t nOpens;
+
+    /**
+     The number of files opened or mapped from the disk.
+     */
+    size_t nDiskOpens;
+
+    /**
+     The number of opens of disk files which were already open or mapped.
+     */
+    size_t nCachedOpens;
+
+    /**
+     The number of files supplied by the resolver.
+     */
+    size_t nResolved;
+
+    /**
+     The number of files read ahead.
+     */
+    size_t nReadAheads;
+
+    /**
+     The number of reads.
+     */
+    size_t nReads;
+
+    /**
+     The number of bytes read.
+     */
+    size_t bytesRead;
+
+    /**
+     The time spent opening, mapping and reading files, in seconds.
+     */
+    double ioSeconds;
+} AKFileSystemStats;
+
+/**
+ Supplies the bytes of a file which is not a memory file of a file system.
+
+ @param context The context passed to AKFileSystemSetResolver.
+ @param name The path of the file relative to the base directory of the file
+ system, or its full path if it is not in the base directory.
+ @param data Receives the bytes of the file, which must stay valid and
+ unchanged until the file system is released.
+ @param length Receives the number of bytes of the file.
+ @return 1 if the file was resolved, 0 to look for the file on the disk.
+ */
+typedef int (*AKFileResolver)(void *context,
+                              const char *name,
+                              const void **data,
+                              size_t *length);
+
+#pragma mark - Creating a file system
+
+/**
+ Creates a file system which reads files from the disk with buffered reads.
+
+ @return A new file system which must be released with AKFileSystemRelease.
+ */
+AKFileSystem *AKFileSystemCreate(void);
+
+/**
+ Releases the file system and the files it keeps open. The files opened from
+ it must be closed first.
+
+ @param fs The file system, may be NULL.
+ */
+void AKFileSystemRelease(AKFileSystem *fs);
+
+#pragma mark - Configuring a file system
+
+/**
+ Adds a memory file, whose bytes are read in place and are not copied.
+
+ @param fs The file system.
+ @param name The name of the file.
+ @param data The bytes of the file, which must stay valid and unchanged until
+ the file system is released.
+ @param length The number of bytes of the file.
+ */
+void AKFileSystemAddMemoryFile(AKFileSystem *fs,
+                               const char *name,
+                               const void *data,
+                               size_t length);
+
+/**
+ Sets the resolver which supplies the files which are not memory files.
+
+ @param fs The file system.
+ @param resolver The resolver, or NULL to read the other files from the disk.
+ @param context The context passed to the resolver.
+ */
+void AKFileSystemSetResolver(AKFileSystem *fs,
+                             AKFileResolver resolver,
+                             void *context);
+
+/**
+ Sets the directory which the names passed to the resolver are relative to,
+ usually the directory of the scene file.
+
+ @param fs The file system.
+ @param directory The base directory, or NULL or "" for none.
+ */
+void AKFileSystemSetBaseDirectory(AKFileSystem *fs, const char *directory);
+
+/**
+ Sets if the files read from the disk are memory mapped.
+
+ @param fs The file system.
+ @param mapsFiles Non zero to memory map the files, zero to read them with
+ buffered reads.
+ */
+void AKFileSystemSetMapsFiles(AKFileSystem *fs, int mapsFiles);
+
+#pragma mark - Opening files
+
+/**
+ Determines if a file can be opened.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @return 1 if the file can be opened, else 0.
+ */
+int AKFileSystemExists(AKFileSystem *fs, const char *path);
+
+/**
+ Opens a file to read.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @return The file which must be closed with AKFileClose, or NULL if the file
+ cannot be opened.
+ */
+AKFile *AKFileSystemOpen(AKFileSystem *fs, const char *path);
+
+/**
+ Opens a file which a scene refers to, such as a texture, by the name in the
+ scene.
+
+ The name may use backslashes as separators, and is relative to the base
+ directory unless it is an absolute path.
+
+ @param fs The file system.
+ @param name The name of the file in the scene.
+ @return The file which must be closed with AKFileClose, or NULL if the file
+ cannot be opened.
+ */
+AKFile *AKFileSystemOpenReference(AKFileSystem *fs, const char *name);
+
+/**
+ Starts reading a file which a scene refers to from the disk, so that it is
+ in memory when it is opened.
+
+ A file in memory or supplied by the resolver is not read ahead.
+
+ @param fs The file system.
+ @param name The name of the file in the scene.
+ */
+void AKFileSystemReadAheadReference(AKFileSystem *fs, const char *name);
+
+/**
+ Returns the number of paths which the file system looked for on the disk,
+ including the paths of the files which do not exist.
+
+ @param fs The file system.
+ @return The number of paths.
+ */
+size_t AKFileSystemDiskPathCount(const AKFileSystem *fs);
+
+/**
+ Returns a path which the file system looked for on the disk, in the order
+ the paths were first looked for.
+
+ @param fs The file system.
+ @param index The index of the path, less than AKFileSystemDiskPathCount.
+ @return The path.
+ */
+const char *AKFileSystemDiskPath(const AKFileSystem *fs, size_t index);
+
+#pragma mark - Statistics
+
+/**
+ Returns the reads of a file system since it was created.
+
+ @param fs The file system.
+ @return The statistics.
+ */
+AKFileSystemStats AKFileSystemGetStats(const AKFileSystem *fs);
+
+#pragma mark - Reading files
+
+/**
+ Reads bytes from the current position of a file and moves past them.
+
+ @param file The file.
+ @param buffer Receives the bytes.
+ @param nBytes The number of bytes to read.
+ @return The number of bytes read, less than nBytes at the end of the file.
+ */
+size_t AKFileRead(AKFile *file, void *buffer, size_t nBytes);
+
+/**
+ Moves the current position of a file.
+
+ @param file The file.
+ @param offset The new position, from 0 to the size of the file.
+ @return 1 if the position was moved, 0 if it is out of the file.
+ */
+int AKFileSeek(AKFile *file, size_t offset);
+
+/**
+ Returns the current position of a file.
+
+ @param file The file.
+ @return The position in bytes from the start of the file.
+ */
+size_t AKFileTell(const AKFile *file);
+
+/**
+ Returns the size of a file.
+
+ @param file The file.
+ @return The size in bytes.
+ */
+size_t AKFileSize(const AKFile *file);
+
+/**
+ Returns the bytes of a file which is read in place: a memory file, a
+ resolved file or a memory mapped file.
+
+ @param file The file.
+ @return The bytes of the file, or NULL if the file is read with buffered
+ reads.
+ */
+const void *AKFileBytes(const AKFile *file);
+
+/**
+ Closes a file. The file system keeps the stream or the mapping of a file on
+ the disk for the next open of the file.
+
+ @param file The file, may be NULL.
+ */
+void AKFileClose(AKFile *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKFileSystem_h */
@@ -0,0 +1,1238 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKGeometry.h"
+#include "AKMemory.h"
+#include "AKQuantize.h"
+#include "AKVertexKernels.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#pragma mark - Find the number of vertices and indices of a geometry
+
+/**
+ Finds the total number of vertices in the meshes of the specified node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @return The number of vertices.
+ */
+unsigned int AKNumVerticesInNode(const struct aiNode *aiNode,
+                                 const struct aiScene *aiScene)
+{
+    unsigned int nVertices = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        nVertices += aiMesh->mNumVertices;
+    }
+    return nVertices;
+}
+
+/**
+ Finds the total number of indices in the faces of the specified mesh.
+
+ @param aiMesh The assimp mesh.
+ @return The total number of indices.
+ */
+unsigned int AKNumIndicesInMesh(const struct aiMesh *aiMesh)
+{
+    unsigned int nIndices = 0;
+    for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
+    {
+        nIndices += aiMesh->mFaces[i].mNumIndices;
+    }
+    return nIndices;
+}
+
+#pragma mark - Vertex layouts
+
+/**
+ Makes the default vertex layout, which stores every attribute as floats.
+
+ @return The default vertex layout.
+ */
+AKVertexLayout AKVertexLayoutMakeDefault(void)
+{
+    AKVertexLayout layout;
+    for (int i = 0; i < AKVertexAttributeCount; i++)
+    {
+        layout.formats[i] = AKVertexFormatFloat;
+    }
+    return layout;
+}
+
+/**
+ Finds the format which stores an attribute, replacing a format which does not
+ apply to the attribute with floats.
+
+ @param attribute The vertex attribute.
+ @param format The format of the vertex layout.
+ @return The format of the stored attribute.
+ */
+static AKVertexFormat formatOfAttribute(AKVertexAttribute attribute,
+                                        AKVertexFormat format)
+{
+    switch (format)
+    {
+    case AKVertexFormatSNorm16:
+        return attribute == AKVertexAttributeTexCoord ||
+                       attribute == AKVertexAttributeColor
+                   ? AKVertexFormatFloat
+                   : format;
+    case AKVertexFormatOctSNorm16:
+        return attribute == AKVertexAttributeNormal ||
+                       attribute == AKVertexAttributeTangent
+                   ? format
+                   : AKVertexFormatFloat;
+    case AKVertexFormatUNorm8:
+        return attribute == AKVertexAttributeColor ? format
+                                                   : AKVertexFormatFloat;
+    default:
+        return format;
+    }
+}
+
+/**
+ Finds the number of components of a vertex attribute stored in the specified
+ format.
+
+ @param attribute The vertex attribute.
+ @param format The format of the stored attribute.
+ @return The number of components.
+ */
+static unsigned int componentsOfAttribute(AKVertexAttribute attribute,
+                                          AKVertexFormat format)
+{
+    switch (format)
+    {
+    case AKVertexFormatOctSNorm16:
+        return 2;
+    case AKVertexFormatUNorm8:
+        return 4;
+    default:
+        return attribute == AKVertexAttributeTexCoord ? 2 : 3;
+    }
+}
+
+/**
+ Finds the number of bytes of each component stored in the specified format.
+
+ @param format The vertex format.
+ @return The number of bytes per component, 0 for AKVertexFormatNone.
+ */
+static unsigned int bytesPerComponentOfFormat(AKVertexFormat format)
+{
+    switch (format)
+    {
+    case AKVertexFormatFloat:
+        return sizeof(float);
+    case AKVertexFormatHalf:
+    case AKVertexFormatSNorm16:
+    case AKVertexFormatOctSNorm16:
+        return sizeof(uint16_t);
+    case AKVertexFormatUNorm8:
+        return sizeof(uint8_t);
+    default:
+        return 0;
+    }
+}
+
+/**
+ Finds if the meshes of the node have the specified attribute.
+
+ @param meshStats The statistics of each mesh of the node.
+ @param attribute The vertex attribute.
+ @return true if any mesh has the attribute, or for the color attribute, if
+ every mesh has vertex colors.
+ */
+static bool nodeHasAttribute(const std::vector<AKMeshStats> &meshStats,
+                             AKVertexAttribute attribute)
+{
+    unsigned int stream = 0;
+    switch (attribute)
+    {
+    case AKVertexAttributePosition:
+        return true;
+    case AKVertexAttributeNormal:
+        stream = AKMeshStreamNormals;
+        break;
+    case AKVertexAttributeTangent:
+        stream = AKMeshStreamTangents;
+        break;
+    case AKVertexAttributeTexCoord:
+        stream = AKMeshStreamTexCoords;
+        break;
+    default:
+        stream = AKMeshStreamColors;
+        break;
+    }
+    bool hasAll = !meshStats.empty();
+    bool hasAny = false;
+    for (size_t i = 0; i < meshStats.size(); i++)
+    {
+        bool has = (meshStats[i].streams & stream) != 0;
+        hasAll = hasAll && has;
+        hasAny = hasAny || has;
+    }
+    return attribute == AKVertexAttributeColor ? hasAll : hasAny;
+}
+
+/**
+ Lays out the stored attributes of the node geometry one after the other in
+ each vertex, each at an offset aligned to 4 bytes.
+
+ @param meshStats The statistics of each mesh of the node.
+ @param layout The vertex layout.
+ @param geometry The node geometry whose attribute views and vertex stride
+ are set.
+ */
+static void layoutAttributes(const std::vector<AKMeshStats> &meshStats,
+                             const AKVertexLayout *layout,
+                             AKNodeGeometry *geometry)
+{
+    unsigned int offset = 0;
+    for (int i = 0; i < AKVertexAttributeCount; i++)
+    {
+        AKVertexAttribute attribute = (AKVertexAttribute)i;
+        AKVertexAttributeView *view = &geometry->attributes[i];
+        view->format = formatOfAttribute(attribute, layout->formats[i]);
+        if (attribute == AKVertexAttributePosition &&
+            view->format == AKVertexFormatNone)
+        {
+            view->format = AKVertexFormatFloat;
+        }
+        if (view->format != AKVertexFormatNone &&
+            !nodeHasAttribute(meshStats, attribute))
+        {
+            view->format = AKVertexFormatNone;
+        }
+        if (view->format == AKVertexFormatNone)
+        {
+            view->nComponents = 0;
+            view->bytesPerComponent = 0;
+            view->offset = 0;
+            continue;
+        }
+        view->nComponents = componentsOfAttribute(attribute, view->format);
+        view->bytesPerComponent = bytesPerComponentOfFormat(view->format);
+        view->offset = offset;
+        offset += view->nComponents * view->bytesPerComponent;
+        offset = (offset + 3) & ~3u;
+    }
+    geometry->vertexStride = offset;
+}
+
+/**
+ Finds the address of an attribute of a vertex of the node geometry.
+
+ @param geometry The node geometry.
+ @param attribute The vertex attribute.
+ @param vertex The index of the vertex.
+ @return The address of the first component of the attribute, or NULL if the
+ geometry does not store the attribute.
+ */
+const void *AKNodeGeometryAttributeAt(const AKNodeGeometry *geometry,
+                                      AKVertexAttribute attribute,
+                                      unsigned int vertex)
+{
+    const AKVertexAttributeView *view = &geometry->attributes[attribute];
+    if (view->format == AKVertexFormatNone)
+    {
+        return NULL;
+    }
+    return geometry->vertexData + (size_t)vertex * geometry->vertexStride +
+           view->offset;
+}
+
+/**
+ Reads an attribute of a vertex of the node geometry as floats, restoring the
+ quantized components.
+
+ @param geometry The node geometry.
+ @param attribute The vertex attribute.
+ @param vertex The index of the vertex.
+ @param values The components of the attribute, at least 4 floats.
+ @return The number of components read, or 0 if the geometry does not store
+ the attribute.
+ */
+unsigned int AKNodeGeometryReadAttribute(const AKNodeGeometry *geometry,
+                                         AKVertexAttribute attribute,
+                                         unsigned int vertex,
+                                         float *values)
+{
+    const AKVertexAttributeView *view = &geometry->attributes[attribute];
+    const unsigned char *src = (const unsigned char *)AKNodeGeometryAttributeAt(
+        geometry, attribute, vertex);
+    if (src == NULL)
+    {
+        return 0;
+    }
+    unsigned int nComponents = view->nComponents;
+    for (unsigned int k = 0; k < view->nComponents; k++)
+    {
+        switch (view->format)
+        {
+        case AKVertexFormatHalf:
+        {
+            uint16_t half;
+            memcpy(&half, src + k * sizeof(half), sizeof(half));
+            values[k] = AKHalfToFloat(half);
+            break;
+        }
+        case AKVertexFormatSNorm16:
+        case AKVertexFormatOctSNorm16:
+        {
+            int16_t snorm;
+            memcpy(&snorm, src + k * sizeof(snorm), sizeof(snorm));
+            values[k] = snorm < -32767 ? -1.0f : snorm / 32767.0f;
+            break;
+        }
+        case AKVertexFormatUNorm8:
+            values[k] = src[k] / 255.0f;
+            break;
+        default:
+            memcpy(&values[k], src + k * sizeof(float), sizeof(float));
+            break;
+        }
+    }
+    if (view->format == AKVertexFormatOctSNorm16)
+    {
+        float oct[2] = {values[0], values[1]};
+        AKOctDecode(oct, values);
+        nComponents = 3;
+    }
+    if (attribute == AKVertexAttributePosition)
+    {
+        for (unsigned int k = 0; k < 3; k++)
+        {
+            values[k] = values[k] * geometry->positionScale[k] +
+                        geometry->positionOffset[k];
+        }
+    }
+    return nComponents;
+}
+
+#pragma mark - Copy vertex attributes
+
+/**
+ Finds the bounds of the positions of the meshes of the node, and sets the
+ position scale and offset which map the bounds to [-1, 1] when the positions
+ are quantized.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param geometry The node geometry.
+ */
+static void makePositionTransform(const struct aiNode *aiNode,
+                                  const struct aiScene *aiScene,
+                                  AKNodeGeometry *geometry)
+{
+    for (int k = 0; k < 3; k++)
+    {
+        geometry->positionScale[k] = 1.0f;
+        geometry->positionOffset[k] = 0.0f;
+    }
+    if (geometry->attributes[AKVertexAttributePosition].format ==
+        AKVertexFormatFloat)
+    {
+        return;
+    }
+    float lower[3] = {HUGE_VALF, HUGE_VALF, HUGE_VALF};
+    float upper[3] = {-HUGE_VALF, -HUGE_VALF, -HUGE_VALF};
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        for (unsigned int j = 0; j < aiMesh->mNumVertices; j++)
+        {
+            const float p[3] = {aiMesh->mVertices[j].x, aiMesh->mVertices[j].y,
+                                aiMesh->mVertices[j].z};
+            for (int k = 0; k < 3; k++)
+            {
+                lower[k] = p[k] < lower[k] ? p[k] : lower[k];
+                upper[k] = p[k] > upper[k] ? p[k] : upper[k];
+            }
+        }
+    }
+    for (int k = 0; k < 3; k++)
+    {
+        float halfExtent = (upper[k] - lower[k]) * 0.5f;
+        geometry->positionOffset[k] = lower[k] + halfExtent;
+        geometry->positionScale[k] = halfExtent > 0.0f ? halfExtent : 1.0f;
+    }
+}
+
+/**
+ The buffers which convert the quantized attributes of a chunk of vertices,
+ reused from chunk to chunk.
+ */
+struct AKChunkScratch
+{
+    /**
+     The float components of an attribute of each vertex of the chunk.
+     */
+    std::vector<float, AKMemoryAllocator<float> > values;
+
+    /**
+     The quantized components of an attribute of each vertex of the chunk.
+     */
+    std::vector<unsigned char, AKMemoryAllocator<unsigned char> > quantized;
+};
+
+/**
+ Stores the components of an attribute of consecutive vertices in the
+ attribute's format, quantizing all of them at once.
+
+ @param values The components of the attribute of each vertex, in the number
+ of components of the attribute view.
+ @param nVertices The number of vertices, at most AKVertexChunkSize.
+ @param view The attribute view.
+ @param stride The number of bytes of each interleaved vertex.
+ @param dst The address of the first interleaved vertex.
+ @param quantized The buffer of the quantized components.
+ */
+static void storeAttributes(const float *values,
+                            size_t nVertices,
+                            const AKVertexAttributeView *view,
+                            unsigned int stride,
+                            unsigned char *dst,
+                            unsigned char *quantized)
+{
+    const size_t n = nVertices * view->nComponents;
+    const size_t rowBytes = view->nComponents * view->bytesPerComponent;
+    const unsigned char *src = (const unsigned char *)values;
+    switch (view->format)
+    {
+    case AKVertexFormatHalf:
+        AKQuantizeHalf(values, n, (uint16_t *)quantized);
+        src = quantized;
+        break;
+    case AKVertexFormatSNorm16:
+    case AKVertexFormatOctSNorm16:
+        AKQuantizeSNorm16(values, n, (int16_t *)quantized);
+        src = quantized;
+        break;
+    case AKVertexFormatUNorm8:
+        AKQuantizeUNorm8(values, n, quantized);
+        src = quantized;
+        break;
+    default:
+        break;
+    }
+    for (size_t j = 0; j < nVertices; j++)
+    {
+        memcpy(dst + j * stride + view->offset, src + j * rowBytes, rowBytes);
+    }
+}
+
+/**
+ Converts an attribute of a chunk of vertices of a mesh with the vertex
+ kernels.
+
+ Float attributes and unorm8 colors are written straight into the interleaved
+ vertices, so they are copied once from the mesh. The other attributes are
+ converted to floats in the scratch buffers, octahedral normals and tangents
+ are encoded, and then they are quantized all at once.
+
+ @param attribute The vertex attribute.
+ @param src The stream of the attribute at the first vertex of the chunk.
+ @param nVertices The number of vertices, at most AKVertexChunkSize.
+ @param geometry The node geometry.
+ @param rows The address of the first interleaved vertex of the chunk.
+ @param scratch The scratch buffers.
+ */
+static void convertAttributeChunk(AKVertexAttribute attribute,
+                                  const float *src,
+                                  size_t nVertices,
+                                  const AKNodeGeometry *geometry,
+                                  unsigned char *rows,
+                                  AKChunkScratch *scratch)
+{
+    const AKVertexAttributeView *view = &geometry->attributes[attribute];
+    const unsigned int stride = geometry->vertexStride;
+    const bool direct = view->format == AKVertexFormatFloat ||
+                        view->format == AKVertexFormatUNorm8;
+    const bool oct = view->format == AKVertexFormatOctSNorm16;
+    float *values = scratch->values.data();
+    // the float components before they are quantized
+    const size_t nComponents = oct ? 3 : view->nComponents;
+    unsigned char *out = direct ? rows + view->offset : (unsigned char *)values;
+    const size_t outStride = direct ? stride : nComponents * sizeof(float);
+    switch (attribute)
+    {
+    case AKVertexAttributePosition:
+        if (view->format == AKVertexFormatFloat)
+        {
+            AKCopyVec3(src, nVertices, out, outStride);
+        }
+        else
+        {
+            // maps the bounds of the positions to [-1, 1]
+            float scale[3];
+            float offset[3];
+            for (int k = 0; k < 3; k++)
+            {
+                scale[k] = 1.0f / geometry->positionScale[k];
+                offset[k] = -geometry->positionOffset[k] * scale[k];
+            }
+            AKScaleOffsetVec3(src, nVertices, scale, offset, out, outStride);
+        }
+        break;
+    case AKVertexAttributeTexCoord:
+        AKExtractTexCoords(src, nVertices, out, outStride);
+        break;
+    case AKVertexAttributeColor:
+        if (view->format == AKVertexFormatUNorm8)
+        {
+            AKPackColorsRGBA8(src, nVertices, out, outStride);
+        }
+        else
+        {
+            AKPackColorsRGB(src, nVertices, out, outStride);
+        }
+        break;
+    default:
+        AKCopyVec3(src, nVertices, out, outStride);
+        break;
+    }
+    if (direct)
+    {
+        return;
+    }
+    if (oct)
+    {
+        // encodes in place, each vector being read before it is overwritten
+        for (size_t j = 0; j < nVertices; j++)
+        {
+            const float v[3] = {values[3 * j], values[3 * j + 1],
+                                values[3 * j + 2]};
+            AKOctEncode(v, values + 2 * j);
+        }
+    }
+    storeAttributes(values, nVertices, view, stride, rows,
+                    scratch->quantized.data());
+}
+
+/**
+ Converts every vertex stream of a mesh into the attributes of its interleaved
+ vertices, a chunk of vertices at a time.
+
+ Each attribute of a chunk is converted by a vertex kernel while the
+ interleaved vertices of the chunk stay in the cache. Streams which the mesh
+ does not have leave the zeroed attribute, so that the vertices stay aligned
+ with the vertex positions.
+
+ @param aiMesh The assimp mesh.
+ @param geometry The node geometry with zeroed vertices.
+ @param dst The address of the first interleaved vertex of the mesh.
+ @param scratch The scratch buffers, reused from mesh to mesh.
+ @param progress The progress of the import, advanced after each chunk, or
+ NULL.
+ @return true if the vertices were converted, false if the import was
+ cancelled.
+ */
+static bool convertMeshVertices(const struct aiMesh *aiMesh,
+                                const AKNodeGeometry *geometry,
+                                unsigned char *dst,
+                                AKChunkScratch *scratch,
+                                AKProgress *progress)
+{
+    const size_t nVertices = aiMesh->mNumVertices;
+    const unsigned int stride = geometry->vertexStride;
+    // the packed floats of the assimp streams
+    static_assert(sizeof(aiVector3D) == 3 * sizeof(float) &&
+                      sizeof(aiColor4D) == 4 * sizeof(float),
+                  "The vertex kernels read assimp streams as packed floats");
+    const float *streams[AKVertexAttributeCount] = {
+        (const float *)aiMesh->mVertices, (const float *)aiMesh->mNormals,
+        (const float *)aiMesh->mTangents,
+        (const float *)aiMesh->mTextureCoords[0],
+        (const float *)aiMesh->mColors[0]};
+    const size_t floatsPerVertex[AKVertexAttributeCount] = {3, 3, 3, 3, 4};
+    scratch->values.resize(AKVertexChunkSize * 4);
+    scratch->quantized.resize(AKVertexChunkSize * 4 * sizeof(uint16_t));
+    for (size_t first = 0; first < nVertices; first += AKVertexChunkSize)
+    {
+        size_t n = nVertices - first < AKVertexChunkSize
+                       ? nVertices - first
+                       : (size_t)AKVertexChunkSize;
+        unsigned char *rows = dst + first * stride;
+        for (int a = 0; a < AKVertexAttributeCount; a++)
+        {
+            if (geometry->attributes[a].format == AKVertexFormatNone ||
+                streams[a] == NULL)
+            {
+                continue;
+            }
+            convertAttributeChunk((AKVertexAttribute)a,
+                                  streams[a] + first * floatsPerVertex[a], n,
+                                  geometry, rows, scratch);
+        }
+        if (!AKProgressAdvance(progress, AKImportPhaseGeometry, n))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#pragma mark - Measure quantization error
+
+/**
+ Finds the angle between two vectors.
+
+ @param a The first vector, 3 floats.
+ @param b The second vector, 3 floats.
+ @return The angle in degrees, or 0 if either vector has no length.
+ */
+static float angleBetween(const float *a, const float *b)
+{
+    double dot = 0.0, lengthA = 0.0, lengthB = 0.0;
+    for (int k = 0; k < 3; k++)
+    {
+        dot += (double)a[k] * b[k];
+        lengthA += (double)a[k] * a[k];
+        lengthB += (double)b[k] * b[k];
+    }
+    if (lengthA == 0.0 || lengthB == 0.0)
+    {
+        return 0.0f;
+    }
+    double cosine = dot / sqrt(lengthA * lengthB);
+    cosine = cosine > 1.0 ? 1.0 : (cosine < -1.0 ? -1.0 : cosine);
+    return (float)(acos(cosine) * 180.0 / M_PI);
+}
+
+/**
+ Finds the bytes saved by quantizing the attributes of the node geometry,
+ resetting its quantization report.
+
+ @param geometry The node geometry whose quantization report is reset.
+ @return true if any attribute is quantized.
+ */
+static bool startQuantizationReport(AKNodeGeometry *geometry)
+{
+    AKQuantizationReport *report = &geometry->quantization;
+    memset(report, 0, sizeof(AKQuantizationReport));
+    unsigned int floatStride = 0;
+    bool quantized = false;
+    for (int i = 0; i < AKVertexAttributeCount; i++)
+    {
+        AKVertexAttribute attribute = (AKVertexAttribute)i;
+        AKVertexFormat format = geometry->attributes[i].format;
+        if (format != AKVertexFormatNone)
+        {
+            floatStride += componentsOfAttribute(attribute,
+                                                 AKVertexFormatFloat) *
+                           sizeof(float);
+            quantized = quantized || format != AKVertexFormatFloat;
+        }
+    }
+    if (quantized && floatStride > geometry->vertexStride)
+    {
+        report->bytesSaved = (unsigned long)geometry->nVertices *
+                             (floatStride - geometry->vertexStride);
+    }
+    return quantized;
+}
+
+/**
+ Measures the error of the quantized attributes of the vertices of a mesh
+ against the mesh, while they are still in the cache.
+
+ @param aiMesh The assimp mesh.
+ @param firstVertex The index of the first vertex of the mesh in the node
+ geometry.
+ @param geometry The node geometry whose quantization report is updated.
+ @param progress The progress of the import, checked once per chunk of
+ vertices, or NULL.
+ @return true if the error was measured, false if the import was cancelled.
+ */
+static bool measureMeshQuantization(const struct aiMesh *aiMesh,
+                                    unsigned int firstVertex,
+                                    AKNodeGeometry *geometry,
+                                    AKProgress *progress)
+{
+    AKQuantizationReport *report = &geometry->quantization;
+    const AKVertexAttributeView *views = geometry->attributes;
+    unsigned int vertex = firstVertex;
+    for (unsigned int j = 0; j < aiMesh->mNumVertices; j++, vertex++)
+    {
+        if (j % AKVertexChunkSize == 0 && !AKProgressCheckpoint(progress))
+        {
+            return false;
+        }
+        float values[4];
+        if (views[AKVertexAttributePosition].format != AKVertexFormatFloat)
+        {
+            AKNodeGeometryReadAttribute(geometry, AKVertexAttributePosition,
+                                        vertex, values);
+            aiVector3D d = aiMesh->mVertices[j] -
+                           aiVector3D(values[0], values[1], values[2]);
+            float error = d.Length();
+            if (error > report->maxPositionError)
+            {
+                report->maxPositionError = error;
+            }
+        }
+        if (aiMesh->mNormals &&
+            views[AKVertexAttributeNormal].format != AKVertexFormatFloat)
+        {
+            AKNodeGeometryReadAttribute(geometry, AKVertexAttributeNormal,
+                                        vertex, values);
+            const float original[3] = {aiMesh->mNormals[j].x,
+                                       aiMesh->mNormals[j].y,
+                                       aiMesh->mNormals[j].z};
+            float angle = angleBetween(original, values);
+            if (angle > report->maxNormalAngleError)
+            {
+                report->maxNormalAngleError = angle;
+            }
+        }
+        if (aiMesh->mTangents &&
+            views[AKVertexAttributeTangent].format != AKVertexFormatFloat)
+        {
+            AKNodeGeometryReadAttribute(geometry, AKVertexAttributeTangent,
+                                        vertex, values);
+            const float original[3] = {aiMesh->mTangents[j].x,
+                                       aiMesh->mTangents[j].y,
+                                       aiMesh->mTangents[j].z};
+            float angle = angleBetween(original, values);
+            if (angle > report->maxTangentAngleError)
+            {
+                report->maxTangentAngleError = angle;
+            }
+        }
+        if (aiMesh->mTextureCoords[0] &&
+            views[AKVertexAttributeTexCoord].format != AKVertexFormatFloat)
+        {
+            AKNodeGeometryReadAttribute(geometry, AKVertexAttributeTexCoord,
+                                        vertex, values);
+            const aiVector3D &uv = aiMesh->mTextureCoords[0][j];
+            float error =
+                fmaxf(fabsf(uv.x - values[0]), fabsf(uv.y - values[1]));
+            if (error > report->maxTexCoordError)
+            {
+                report->maxTexCoordError = error;
+            }
+        }
+    }
+    return true;
+}
+
+#pragma mark - Read and write geometry indices
+
+/**
+ Finds the narrowest index width which can address the specified number of
+ vertices.
+
+ @param nVertices The number of vertices.
+ @return The number of bytes per index: 1, 2 or 4.
+ */
+unsigned int AKBytesPerIndexForVertexCount(unsigned int nVertices)
+{
+    if (nVertices <= 0x100)
+    {
+        return sizeof(uint8_t);
+    }
+    if (nVertices <= 0x10000)
+    {
+        return sizeof(uint16_t);
+    }
+    return sizeof(uint32_t);
+}
+
+/**
+ Reads the index at the specified position of a geometry element.
+
+ @param element The geometry element, which must have indices.
+ @param i The position of the index, less than the number of indices.
+ @return The index.
+ */
+unsigned int AKGeometryElementIndexAt(const AKGeometryElement *element,
+                                      unsigned int i)
+{
+    switch (element->bytesPerIndex)
+    {
+    case sizeof(uint8_t):
+        return ((const uint8_t *)element->indices)[i];
+    case sizeof(uint16_t):
+        return ((const uint16_t *)element->indices)[i];
+    default:
+        return ((const uint32_t *)element->indices)[i];
+    }
+}
+
+/**
+ Allocates the indices of a geometry element, with the narrowest index width
+ which can address the specified number of vertices.
+
+ @param element The geometry element whose number of indices is set.
+ @param nVertices The number of vertices addressed by the element.
+ */
+static void allocIndices(AKGeometryElement *element, unsigned int nVertices)
+{
+    element->bytesPerIndex = AKBytesPerIndexForVertexCount(nVertices);
+    element->indices =
+        AKMemoryMalloc(element->nIndices * element->bytesPerIndex);
+}
+
+/**
+ Writes the index at the specified position of a geometry element.
+
+ @param element The geometry element with allocated indices.
+ @param i The position of the index.
+ @param index The index, which fits the index width of the element.
+ */
+static void setIndex(AKGeometryElement *element,
+                     unsigned int i,
+                     unsigned int index)
+{
+    switch (element->bytesPerIndex)
+    {
+    case sizeof(uint8_t):
+        ((uint8_t *)element->indices)[i] = (uint8_t)index;
+        break;
+    case sizeof(uint16_t):
+        ((uint16_t *)element->indices)[i] = (uint16_t)index;
+        break;
+    default:
+        ((uint32_t *)element->indices)[i] = index;
+        break;
+    }
+}
+
+#pragma mark - Make geometry elements
+
+/**
+ Copies the triangle indices of the mesh, offset by the specified number of
+ vertices.
+
+ @param aiMesh The assimp mesh whose faces are all triangles.
+ @param indexOffset The number of vertices of the preceding meshes.
+ @param indices The indices of the geometry element.
+ @param progress The progress of the import, checked once per chunk of
+ faces, or NULL.
+ @return true if the indices were copied, false if the import was cancelled.
+ */
+template <typename Index>
+static bool copyFaceIndices(const struct aiMesh *aiMesh,
+                            unsigned int indexOffset,
+                            Index *indices,
+                            AKProgress *progress)
+{
+    unsigned int counter = 0;
+    for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
+    {
+        if (i % AKVertexChunkSize == 0 && !AKProgressCheckpoint(progress))
+        {
+            return false;
+        }
+        const struct aiFace *aiFace = &aiMesh->mFaces[i];
+        for (unsigned int j = 0; j < aiFace->mNumIndices; j++)
+        {
+            indices[counter++] = (Index)(indexOffset + aiFace->mIndices[j]);
+        }
+    }
+    return true;
+}
+
+/**
+ Fills the geometry element for the specified mesh.
+
+ The index width is chosen to address the last vertex of the mesh in the
+ combined vertex streams of the node.
+
+ @param aiMesh The assimp mesh.
+ @param meshStats The statistics of the mesh.
+ @param indexOffset The number of vertices of the preceding meshes.
+ @param element The geometry element to fill.
+ @param progress The progress of the import, or NULL.
+ @return true if the element was filled, false if the import was cancelled.
+ */
+static bool makeElement(const struct aiMesh *aiMesh,
+                        const AKMeshStats *meshStats,
+                        unsigned int indexOffset,
+                        AKGeometryElement *element,
+                        AKProgress *progress)
+{
+    element->nPrimitives = aiMesh->mNumFaces;
+    element->nIndices = meshStats->nIndices;
+    element->bytesPerIndex = 0;
+    element->indices = NULL;
+    // we ignore meshes with faces which are not triangulated
+    if (!meshStats->triangulated)
+    {
+        return true;
+    }
+    allocIndices(element, indexOffset + aiMesh->mNumVertices);
+    switch (element->bytesPerIndex)
+    {
+    case sizeof(uint8_t):
+        return copyFaceIndices(aiMesh, indexOffset,
+                               (uint8_t *)element->indices, progress);
+    case sizeof(uint16_t):
+        return copyFaceIndices(aiMesh, indexOffset,
+                               (uint16_t *)element->indices, progress);
+    default:
+        return copyFaceIndices(aiMesh, indexOffset,
+                               (uint32_t *)element->indices, progress);
+    }
+}
+
+#pragma mark - Make geometry buffers
+
+/**
+ Creates the interleaved vertices and geometry elements for the meshes of the
+ specified node.
+
+ The position is always stored, as floats if the layout omits it.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default vertex layout.
+ @return A new node geometry which must be released with
+ AKNodeGeometryRelease, or NULL if the node has no vertices.
+ */
+AKNodeGeometry *AKNodeGeometryCreate(const struct aiNode *aiNode,
+                                     const struct aiScene *aiScene,
+                                     const AKVertexLayout *layout)
+{
+    return AKNodeGeometryCreateWithStats(aiNode, aiScene, layout, NULL);
+}
+
+/**
+ Creates the interleaved vertices and geometry elements for the meshes of the
+ specified node, sized by the statistics of the meshes.
+
+ The statistics of the meshes are found once, and then each mesh is converted
+ in a single sweep over its vertices which fills every attribute, followed by
+ its geometry element.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default vertex layout.
+ @param stats The scene statistics, or NULL to compute the statistics of the
+ meshes of the node.
+ @return A new node geometry which must be released with
+ AKNodeGeometryRelease, or NULL if the node has no vertices.
+ */
+AKNodeGeometry *AKNodeGeometryCreateWithStats(const struct aiNode *aiNode,
+                                              const struct aiScene *aiScene,
+                                              const AKVertexLayout *layout,
+                                              const AKSceneStats *stats)
+{
+    return AKNodeGeometryCreateWithProgress(aiNode, aiScene, layout, stats,
+                                            NULL);
+}
+
+/**
+ Creates the interleaved vertices and geometry elements for the meshes of the
+ specified node, advancing the geometry phase of the import by the number of
+ vertices converted.
+
+ The import is checked for cancellation once per chunk of AKVertexChunkSize
+ vertices, and the partly converted geometry is released when it is
+ cancelled.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default vertex layout.
+ @param stats The scene statistics, or NULL to compute the statistics of the
+ meshes of the node.
+ @param progress The progress of the import, or NULL.
+ @return A new node geometry which must be released with
+ AKNodeGeometryRelease, or NULL if the node has no vertices or the import was
+ cancelled.
+ */
+AKNodeGeometry *AKNodeGeometryCreateWithProgress(const struct aiNode *aiNode,
+                                                 const struct aiScene *aiScene,
+                                                 const AKVertexLayout *layout,
+                                                 const AKSceneStats *stats,
+                                                 AKProgress *progress)
+{
+    std::vector<AKMeshStats> meshStats(aiNode->mNumMeshes);
+    unsigned int nVertices = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        meshStats[i] = AKSceneStatsOfMesh(stats, aiScene, aiNode->mMeshes[i]);
+        nVertices += meshStats[i].nVertices;
+    }
+    if (nVertices == 0)
+    {
+        return NULL;
+    }
+    AKNodeGeometry *geometry =
+        (AKNodeGeometry *)AKMemoryCalloc(1, sizeof(AKNodeGeometry));
+    geometry->nVertices = nVertices;
+
+    AKVertexLayout defaultLayout = AKVertexLayoutMakeDefault();
+    layoutAttributes(meshStats, layout ? layout : &defaultLayout, geometry);
+    geometry->vertexData = (unsigned char *)AKMemoryCalloc(
+        nVertices, geometry->vertexStride);
+    makePositionTransform(aiNode, aiScene, geometry);
+    bool quantized = startQuantizationReport(geometry);
+
+    geometry->nElements = aiNode->mNumMeshes;
+    geometry->elements = (AKGeometryElement *)AKMemoryCalloc(
+        aiNode->mNumMeshes, sizeof(AKGeometryElement));
+    AKChunkScratch scratch;
+    unsigned int vertexOffset = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        unsigned int aiMeshIndex = aiNode->mMeshes[i];
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
+        geometry->elements[i].meshIndex = aiMeshIndex;
+        if (!convertMeshVertices(aiMesh, geometry,
+                                 geometry->vertexData +
+                                     (size_t)vertexOffset *
+                                         geometry->vertexStride,
+                                 &scratch, progress) ||
+            (quantized && !measureMeshQuantization(aiMesh, vertexOffset,
+                                                   geometry, progress)) ||
+            !makeElement(aiMesh, &meshStats[i], vertexOffset,
+                         &geometry->elements[i], progress))
+        {
+            AKNodeGeometryRelease(geometry);
+            return NULL;
+        }
+        vertexOffset += aiMesh->mNumVertices;
+    }
+    return geometry;
+}
+
+/**
+ Releases the node geometry and all of its buffers.
+
+ @param geometry The node geometry, may be NULL.
+ */
+void AKNodeGeometryRelease(AKNodeGeometry *geometry)
+{
+    if (geometry == NULL)
+    {
+        return;
+    }
+    AKMemoryFree(geometry->vertexData);
+    for (unsigned int i = 0; i < geometry->nElements; i++)
+    {
+        AKMemoryFree(geometry->elements[i].indices);
+    }
+    AKMemoryFree(geometry->elements);
+    AKMemoryFree(geometry->vertexMap);
+    AKMemoryFree(geometry);
+}
+
+#pragma mark - Split geometry buffers
+
+/**
+ The triangles of one element which are assigned to a chunk, with their
+ indices into the chunk's vertices.
+ */
+struct AKChunkElement
+{
+    /**
+     The index of the mesh in the assimp scene's meshes.
+     */
+    unsigned int meshIndex;
+
+    /**
+     The triangle indices into the chunk's vertices.
+     */
+    std::vector<unsigned int> indices;
+};
+
+/**
+ Creates a chunk from the vertices and the triangles assigned to it.
+
+ @param geometry The node geometry.
+ @param vertexMap The node vertex of each chunk vertex.
+ @param elements The triangles of each element assigned to the chunk.
+ @return A new chunk.
+ */
+static AKNodeGeometry *makeChunk(const AKNodeGeometry *geometry,
+                                 const std::vector<unsigned int> &vertexMap,
+                                 const std::vector<AKChunkElement> &elements)
+{
+    unsigned int nVertices = (unsigned int)vertexMap.size();
+    AKNodeGeometry *chunk =
+        (AKNodeGeometry *)AKMemoryCalloc(1, sizeof(AKNodeGeometry));
+    chunk->nVertices = nVertices;
+    chunk->vertexStride = geometry->vertexStride;
+    memcpy(chunk->attributes, geometry->attributes,
+           sizeof(geometry->attributes));
+    memcpy(chunk->positionScale, geometry->positionScale,
+           sizeof(geometry->positionScale));
+    memcpy(chunk->positionOffset, geometry->positionOffset,
+           sizeof(geometry->positionOffset));
+    chunk->quantization = geometry->quantization;
+    // gather the interleaved vertices through the vertex map
+    const size_t stride = geometry->vertexStride;
+    chunk->vertexData = (unsigned char *)AKMemoryMalloc(nVertices * stride);
+    for (unsigned int i = 0; i < nVertices; i++)
+    {
+        memcpy(chunk->vertexData + i * stride,
+               geometry->vertexData + vertexMap[i] * stride, stride);
+    }
+    chunk->vertexMap =
+        (unsigned int *)AKMemoryMalloc(nVertices * sizeof(unsigned int));
+    memcpy(chunk->vertexMap, &vertexMap[0], nVertices * sizeof(unsigned int));
+
+    chunk->nElements = (unsigned int)elements.size();
+    chunk->elements = (AKGeometryElement *)AKMemoryCalloc(
+        elements.size(), sizeof(AKGeometryElement));
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        AKGeometryElement *element = &chunk->elements[i];
+        element->meshIndex = elements[i].meshIndex;
+        element->nIndices = (unsigned int)elements[i].indices.size();
+        element->nPrimitives = element->nIndices / 3;
+        allocIndices(element, nVertices);
+        for (unsigned int j = 0; j < element->nIndices; j++)
+        {
+            setIndex(element, j, elements[i].indices[j]);
+        }
+    }
+    return chunk;
+}
+
+/**
+ Splits the node geometry into chunks of at most the specified number of
+ vertices, so that each chunk can use 16 bit indices.
+
+ @param geometry The node geometry.
+ @param maxVertices The maximum number of vertices in a chunk, at least 3.
+ @param nChunks The number of chunks.
+ @return A new array of chunks which must be released with
+ AKNodeGeometryChunksRelease.
+ */
+AKNodeGeometry **AKNodeGeometryCreateChunks(const AKNodeGeometry *geometry,
+                                            unsigned int maxVertices,
+                                            unsigned int *nChunks)
+{
+    std::vector<AKNodeGeometry *> chunks;
+    // the chunk vertex of each node vertex in the current chunk, or -1
+    std::vector<int, AKMemoryAllocator<int> > chunkVertices(
+        geometry->nVertices, -1);
+    std::vector<unsigned int> vertexMap;
+    std::vector<AKChunkElement> elements;
+
+    for (unsigned int i = 0; i < geometry->nElements; i++)
+    {
+        const AKGeometryElement *element = &geometry->elements[i];
+        if (element->indices == NULL)
+        {
+            continue;
+        }
+        bool hasChunkElement = false;
+        for (unsigned int t = 0; t + 2 < element->nIndices; t += 3)
+        {
+            unsigned int triangle[3];
+            unsigned int nNewVertices = 0;
+            for (unsigned int k = 0; k < 3; k++)
+            {
+                triangle[k] = AKGeometryElementIndexAt(element, t + k);
+                if (chunkVertices[triangle[k]] < 0 &&
+                    (k == 0 || triangle[k] != triangle[0]) &&
+                    (k < 2 || triangle[k] != triangle[1]))
+                {
+                    nNewVertices++;
+                }
+            }
+            if (vertexMap.size() + nNewVertices > maxVertices)
+            {
+                // the triangle does not fit, so start a new chunk
+                chunks.push_back(makeChunk(geometry, vertexMap, elements));
+                for (size_t v = 0; v < vertexMap.size(); v++)
+                {
+                    chunkVertices[vertexMap[v]] = -1;
+                }
+                vertexMap.clear();
+                elements.clear();
+                hasChunkElement = false;
+            }
+            if (!hasChunkElement)
+            {
+                elements.push_back(AKChunkElement());
+                elements.back().meshIndex = element->meshIndex;
+                hasChunkElement = true;
+            }
+            for (unsigned int k = 0; k < 3; k++)
+            {
+                int &chunkVertex = chunkVertices[triangle[k]];
+                if (chunkVertex < 0)
+                {
+                    chunkVertex = (int)vertexMap.size();
+                    vertexMap.push_back(triangle[k]);
+                }
+                elements.back().indices.push_back((unsigned int)chunkVertex);
+            }
+        }
+    }
+    if (!vertexMap.empty())
+    {
+        chunks.push_back(makeChunk(geometry, vertexMap, elements));
+    }
+
+    *nChunks = (unsigned int)chunks.size();
+    AKNodeGeometry **result = (AKNodeGeometry **)AKMemoryMalloc(
+        (chunks.size() > 0 ? chunks.size() : 1) * sizeof(AKNodeGeometry *));
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        result[i] = chunks[i];
+    }
+    return result;
+}
+
+/**
+ Releases the chunks of a node geometry and the array of chunks.
+
+ @param chunks The array of chunks, may be NULL.
+ @param nChunks The number of chunks.
+ */
+void AKNodeGeometryChunksRelease(AKNodeGeometry **chunks, unsigned int nChunks)
+{
+    if (chunks == NULL)
+    {
+        return;
+    }
+    for (unsigned int i = 0; i < nChunks; i++)
+    {
+        AKNodeGeometryRelease(chunks[i]);
+    }
+    AKMemoryFree(chunks);
+}
@@ -0,0 +1,502 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKGeometry_h
+#define AKGeometry_h
+
+#include "AKMeshStats.h"
+#include "AKProgress.h"
+#include "assimp/scene.h" // Output data structure
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Geometry buffers
+
+/**
+ The indices of a single mesh of a node, which map to one scenekit geometry
+ element.
+
+ The indices are offset by the number of vertices of the preceding meshes in
+ the node, so that they address the combined vertex streams of the node. Each
+ element uses the narrowest index width, 8, 16 or 32 bits, which can address
+ its highest vertex, so that no index is truncated.
+ */
+typedef struct AKGeometryElement
+{
+    /**
+     The index of the mesh in the assimp scene's meshes.
+     */
+    unsigned int meshIndex;
+
+    /**
+     The number of triangles in the element.
+     */
+    unsigned int nPrimitives;
+
+    /**
+     The number of indices in the element.
+     */
+    unsigned int nIndices;
+
+    /**
+     The number of bytes of each index: 1, 2 or 4.
+     */
+    unsigned int bytesPerIndex;
+
+    /**
+     The unsigned triangle indices of bytesPerIndex bytes each, or NULL if the
+     mesh has faces which are not triangles. Allocated with malloc, so that
+     the caller can take ownership of the indices and free them.
+     */
+    void *indices;
+} AKGeometryElement;
+
+/**
+ The vertex attributes of a node geometry, in the order of their offsets in an
+ interleaved vertex.
+ */
+typedef enum AKVertexAttribute
+{
+    /**
+     The vertex position, 3 components.
+     */
+    AKVertexAttributePosition = 0,
+
+    /**
+     The vertex normal, 3 components.
+     */
+    AKVertexAttributeNormal,
+
+    /**
+     The vertex tangent, 3 components.
+     */
+    AKVertexAttributeTangent,
+
+    /**
+     The texture coordinates of the first uv channel, 2 components.
+     */
+    AKVertexAttributeTexCoord,
+
+    /**
+     The rgb vertex color of the first color set, 3 components.
+     */
+    AKVertexAttributeColor,
+
+    /**
+     The number of vertex attributes.
+     */
+    AKVertexAttributeCount
+} AKVertexAttribute;
+
+/**
+ The storage format of the components of a vertex attribute.
+
+ A format which does not apply to an attribute stores that attribute as
+ floats. Quantized positions are stored relative to the bounds of the node
+ geometry and are restored with its position scale and offset.
+ */
+typedef enum AKVertexFormat
+{
+    /**
+     The attribute is not stored.
+     */
+    AKVertexFormatNone = 0,
+
+    /**
+     Each component is a 32 bit float.
+     */
+    AKVertexFormatFloat,
+
+    /**
+     Each component is a 16 bit half float. Applies to every attribute.
+     */
+    AKVertexFormatHalf,
+
+    /**
+     Each component is a signed normalized 16 bit integer. Applies to
+     positions, normals and tangents.
+     */
+    AKVertexFormatSNorm16,
+
+    /**
+     The unit vector is stored as the two octahedral coordinates, each a
+     signed normalized 16 bit integer. Applies to normals and tangents.
+     */
+    AKVertexFormatOctSNorm16,
+
+    /**
+     The rgba components are unsigned normalized 8 bit integers. Applies to
+     colors.
+     */
+    AKVertexFormatUNorm8
+} AKVertexFormat;
+
+/**
+ Describes which vertex attributes are written to the interleaved vertices of
+ a node geometry and in which format.
+ */
+typedef struct AKVertexLayout
+{
+    /**
+     The format of each attribute, indexed by AKVertexAttribute.
+     */
+    AKVertexFormat formats[AKVertexAttributeCount];
+} AKVertexLayout;
+
+/**
+ Where an attribute is stored in each interleaved vertex.
+ */
+typedef struct AKVertexAttributeView
+{
+    /**
+     The format of the attribute, AKVertexFormatNone if the geometry does not
+     have the attribute.
+     */
+    AKVertexFormat format;
+
+    /**
+     The number of components of the attribute.
+     */
+    unsigned int nComponents;
+
+    /**
+     The number of bytes of each component.
+     */
+    unsigned int bytesPerComponent;
+
+    /**
+     The byte offset of the attribute from the start of a vertex.
+     */
+    unsigned int offset;
+} AKVertexAttributeView;
+
+/**
+ The error and the savings of the quantized vertex attributes of a node
+ geometry.
+ */
+typedef struct AKQuantizationReport
+{
+    /**
+     The maximum distance between a restored position and its original
+     position, in scene units.
+     */
+    float maxPositionError;
+
+    /**
+     The maximum angle between a restored normal and its original normal, in
+     degrees.
+     */
+    float maxNormalAngleError;
+
+    /**
+     The maximum angle between a restored tangent and its original tangent, in
+     degrees.
+     */
+    float maxTangentAngleError;
+
+    /**
+     The maximum difference between a restored texture coordinate component
+     and its original component.
+     */
+    float maxTexCoordError;
+
+    /**
+     The number of bytes saved compared to storing the same attributes as
+     floats.
+     */
+    unsigned long bytesSaved;
+} AKQuantizationReport;
+
+/**
+ The interleaved vertices and the geometry elements for the combined meshes of
+ a node.
+
+ The vertices are stored in a single buffer with vertexStride bytes per vertex
+ in mesh order, and each attribute is a view at an offset into each vertex. An
+ attribute which is not in the vertex layout, or which no mesh of the node
+ has, is not stored. A mesh which does not have a stored normal, tangent or
+ texture coordinate attribute contributes zeros to it, while the color
+ attribute is only stored if every mesh has vertex colors.
+ */
+typedef struct AKNodeGeometry
+{
+    /**
+     The total number of vertices in the meshes of the node.
+     */
+    unsigned int nVertices;
+
+    /**
+     The number of bytes of each interleaved vertex.
+     */
+    unsigned int vertexStride;
+
+    /**
+     The view of each attribute into the vertices, indexed by
+     AKVertexAttribute.
+     */
+    AKVertexAttributeView attributes[AKVertexAttributeCount];
+
+    /**
+     The interleaved vertices, nVertices * vertexStride bytes. Allocated with
+     malloc, so that the caller can take ownership of the vertices and free
+     them.
+     */
+    unsigned char *vertexData;
+
+    /**
+     The number of geometry elements, which is the number of meshes in the node.
+     */
+    unsigned int nElements;
+
+    /**
+     The geometry elements, one for each mesh of the node.
+     */
+    AKGeometryElement *elements;
+
+    /**
+     For a chunk of a split node geometry, the index of each chunk vertex in
+     the vertices of the whole node geometry, otherwise NULL.
+     */
+    unsigned int *vertexMap;
+
+    /**
+     The scale of the stored positions, 3 floats, so that a position is the
+     stored position times the scale plus the offset. 1 unless the positions
+     are quantized.
+     */
+    float positionScale[3];
+
+    /**
+     The offset of the stored positions, 3 floats, 0 unless the positions are
+     quantized.
+     */
+    float positionOffset[3];
+
+    /**
+     The error of the quantized attributes, measured against the meshes of the
+     node when the geometry is created.
+     */
+    AKQuantizationReport quantization;
+} AKNodeGeometry;
+
+#pragma mark - Find the number of vertices and indices of a geometry
+
+/**
+ Finds the total number of vertices in the meshes of the specified node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @return The number of vertices.
+ */
+unsigned int AKNumVerticesInNode(const struct aiNode *aiNode,
+                                 const struct aiScene *aiScene);
+
+/**
+ Finds the total number of indices in the faces of the specified mesh.
+
+ @param aiMesh The assimp mesh.
+ @return The total number of indices.
+ */
+unsigned int AKNumIndicesInMesh(const struct aiMesh *aiMesh);
+
+#pragma mark - Vertex layouts
+
+/**
+ Makes the default vertex layout, which stores every attribute as floats.
+
+ @return The default vertex layout.
+ */
+AKVertexLayout AKVertexLayoutMakeDefault(void);
+
+/**
+ Reads an attribute of a vertex of the node geometry as floats, restoring the
+ quantized components.
+
+ Positions are restored with the position scale and offset, octahedral
+ normals and tangents are decoded to 3 components, and unorm8 colors have 4
+ components.
+
+ @param geometry The node geometry.
+ @param attribute The vertex attribute.
+ @param vertex The index of the vertex.
+ @param values The components of the attribute, at least 4 floats.
+ @return The number of components read, or 0 if the geometry does not store
+ the attribute.
+ */
+unsigned int AKNodeGeometryReadAttribute(const AKNodeGeometry *geometry,
+                                         AKVertexAttribute attribute,
+                                         unsigned int vertex,
+                                         float *values);
+
+/**
+ Finds the address of an attribute of a vertex of the node geometry.
+
+ @param geometry The node geometry.
+ @param attribute The vertex attribute.
+ @param vertex The index of the vertex.
+ @return The address of the first component of the attribute, or NULL if the
+ geometry does not store the attribute.
+ */
+const void *AKNodeGeometryAttributeAt(const AKNodeGeometry *geometry,
+                                      AKVertexAttribute attribute,
+                                      unsigned int vertex);
+
+#pragma mark - Read geometry indices
+
+/**
+ Finds the narrowest index width which can address the specified number of
+ vertices.
+
+ @param nVertices The number of vertices.
+ @return The number of bytes per index: 1, 2 or 4.
+ */
+unsigned int AKBytesPerIndexForVertexCount(unsigned int nVertices);
+
+/**
+ Reads the index at the specified position of a geometry element.
+
+ @param element The geometry element, which must have indices.
+ @param i The position of the index, less than the number of indices.
+ @return The index.
+ */
+unsigned int AKGeometryElementIndexAt(const AKGeometryElement *element,
+                                      unsigned int i);
+
+#pragma mark - Make geometry buffers
+
+/**
+ Creates the interleaved vertices and geometry elements for the meshes of the
+ specified node.
+
+ The position is always stored, as floats if the layout omits it.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default vertex layout.
+ @return A new node geometry which must be released with
+ AKNodeGeometryRelease, or NULL if the node has no vertices.
+ */
+AKNodeGeometry *AKNodeGeometryCreate(const struct aiNode *aiNode,
+                                     const struct aiScene *aiScene,
+                                     const AKVertexLayout *layout);
+
+/**
+ Creates the interleaved vertices and geometry elements for the meshes of the
+ specified node, sized by the statistics of the meshes.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default vertex layout.
+ @param stats The scene statistics, or NULL to compute the statistics of the
+ meshes of the node.
+ @return A new node geometry which must be released with
+ AKNodeGeometryRelease, or NULL if the node has no vertices.
+ */
+AKNodeGeometry *AKNodeGeometryCreateWithStats(const struct aiNode *aiNode,
+                                              const struct aiScene *aiScene,
+                                              const AKVertexLayout *layout,
+                                              const AKSceneStats *stats);
+
+/**
+ Creates the interleaved vertices and geometry elements for the meshes of the
+ specified node, advancing the geometry phase of the import by the number of
+ vertices converted.
+
+ The import is checked for cancellation once per chunk of AKVertexChunkSize
+ vertices.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default vertex layout.
+ @param stats The scene statistics, or NULL to compute the statistics of the
+ meshes of the node.
+ @param progress The progress of the import, or NULL.
+ @return A new node geometry which must be released with
+ AKNodeGeometryRelease, or NULL if the node has no vertices or the import was
+ cancelled.
+ */
+AKNodeGeometry *AKNodeGeometryCreateWithProgress(const struct aiNode *aiNode,
+                                                 const struct aiScene *aiScene,
+                                                 const AKVertexLayout *layout,
+                                                 const AKSceneStats *stats,
+                                                 AKProgress *progress);
+
+/**
+ Releases the node geometry and all of its buffers.
+
+ Buffers which the caller has taken ownership of must be set to NULL before
+ calling this function.
+
+ @param geometry The node geometry, may be NULL.
+ */
+void AKNodeGeometryRelease(AKNodeGeometry *geometry);
+
+#pragma mark - Split geometry buffers
+
+/**
+ Splits the node geometry into chunks of at most the specified number of
+ vertices, so that each chunk can use 16 bit indices.
+
+ The triangles of each element are assigned to chunks in order. A vertex which
+ is used by triangles in more than one chunk is copied to each of them. Each
+ chunk has an element for each mesh with triangles in that chunk, and a vertex
+ map from its vertices to the vertices of the node geometry. Elements without
+ indices are not part of any chunk.
+
+ @param geometry The node geometry.
+ @param maxVertices The maximum number of vertices in a chunk, at least 3.
+ @param nChunks The number of chunks.
+ @return A new array of chunks which must be released with
+ AKNodeGeometryChunksRelease.
+ */
+AKNodeGeometry **AKNodeGeometryCreateChunks(const AKNodeGeometry *geometry,
+                                            unsigned int maxVertices,
+                                            unsigned int *nChunks);
+
+/**
+ Releases the chunks of a node geometry and the array of chunks.
+
+ @param chunks The array of chunks, may be NULL.
+ @param nChunks The number of chunks.
+ */
+void AKNodeGeometryChunksRelease(AKNodeGeometry **chunks, unsigned int nChunks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKGeometry_h */
@@ -0,0 +1,627 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKImport.h"
+#include "assimp/IOStream.hpp"
+#include "assimp/IOSystem.hpp"
+#include "assimp/Importer.hpp"
+#include "assimp/ProgressHandler.hpp"
+#include <string.h>
+#include <string>
+
+#pragma mark - Progress handler
+
+/**
+ The assimp progress handler which reports to the progress of an import and
+ aborts the import once it is cancelled.
+ */
+class AKImportProgressHandler : public Assimp::ProgressHandler
+{
+  public:
+    /**
+     Creates a progress handler.
+
+     @param progress The progress of the import.
+     */
+    explicit AKImportProgressHandler(AKProgress *progress)
+        : progress(progress), phase(AKImportPhaseParse)
+    {
+    }
+
+    /**
+     Reports the progress of the current phase.
+
+     @param percentage The progress of the importer, unused since assimp does
+     not estimate it.
+     @return false to abort the import once it is cancelled.
+     */
+    virtual bool Update(float percentage)
+    {
+        return AKProgressAdvance(progress, phase, 0);
+    }
+
+    /**
+     The progress of the import.
+     */
+    AKProgress *progress;
+
+    /**
+     The phase which the importer is in.
+     */
+    AKImportPhase phase;
+};
+
+#pragma mark - File system
+
+/**
+ The assimp stream of a file opened from the file system of an import.
+ */
+class AKImportStream : public Assimp::IOStream
+{
+  public:
+    /**
+     Creates a stream.
+
+     @param file The file, which the stream closes.
+     */
+    explicit AKImportStream(AKFile *file) : file(file)
+    {
+    }
+
+    /**
+     Closes the file.
+     */
+    virtual ~AKImportStream()
+    {
+        AKFileClose(file);
+    }
+
+    /**
+     Reads elements from the current position.
+
+     @param buffer Receives the elements.
+     @param size The size of an element.
+     @param count The number of elements.
+     @return The number of whole elements read.
+     */
+    virtual size_t Read(void *buffer, size_t size, size_t count)
+    {
+        return size > 0 ? AKFileRead(file, buffer, size * count) / size : 0;
+    }
+
+    /**
+     Does not write, since the files are read only.
+
+     @return 0.
+     */
+    virtual size_t Write(const void *buffer, size_t size, size_t count)
+    {
+        return 0;
+    }
+
+    /**
+     Moves the current position.
+
+     @param offset The offset from the origin.
+     @param origin The start, the current position or the end of the file.
+     @return aiReturn_SUCCESS if the position is in the file.
+     */
+    virtual aiReturn Seek(size_t offset, aiOrigin origin)
+    {
+        if (origin == aiOrigin_CUR)
+        {
+            offset += AKFileTell(file);
+        }
+        else if (origin == aiOrigin_END)
+        {
+            offset = AKFileSize(file) - offset;
+        }
+        return AKFileSeek(file, offset) ? aiReturn_SUCCESS : aiReturn_FAILURE;
+    }
+
+    /**
+     Returns the current position.
+
+     @return The position in bytes.
+     */
+    virtual size_t Tell() const
+    {
+        return AKFileTell(file);
+    }
+
+    /**
+     Returns the size of the file.
+
+     @return The size in bytes.
+     */
+    virtual size_t FileSize() const
+    {
+        return AKFileSize(file);
+    }
+
+    /**
+     Does nothing, since the files are read only.
+     */
+    virtual void Flush()
+    {
+    }
+
+  private:
+    /**
+     The file.
+     */
+    AKFile *file;
+};
+
+/**
+ The assimp IO system which opens the files of an import from its file
+ system.
+ */
+class AKImportIOSystem : public Assimp::IOSystem
+{
+  public:
+    /**
+     Creates an IO system.
+
+     @param fs The file system of the import, which outlives the IO system.
+     */
+    explicit AKImportIOSystem(AKFileSystem *fs) : fs(fs)
+    {
+    }
+
+    /**
+     Determines if a file can be opened.
+
+     @param path The path of the file.
+     @return true if the file can be opened.
+     */
+    virtual bool Exists(const char *path) const
+    {
+        return AKFileSystemExists(fs, path) != 0;
+    }
+
+    /**
+     Returns the separator of the directories of a path.
+
+     @return The separator.
+     */
+    virtual char getOsSeparator() const
+    {
+        return '/';
+    }
+
+    /**
+     Opens a file to read.
+
+     @param path The path of the file.
+     @param mode The mode of the file, which must not write.
+     @return The stream of the file, or NULL if it cannot be opened.
+     */
+    virtual Assimp::IOStream *Open(const char *path, const char *mode)
+    {
+        if (strchr(mode, 'w') != NULL || strchr(mode, 'a') != NULL)
+        {
+            return NULL;
+        }
+        AKFile *file = AKFileSystemOpen(fs, path);
+        return file != NULL ? new AKImportStream(file) : NULL;
+    }
+
+    /**
+     Closes a stream.
+
+     @param stream The stream.
+     */
+    virtual void Close(Assimp::IOStream *stream)
+    {
+        delete stream;
+    }
+
+  private:
+    /**
+     The file system of the import.
+     */
+    AKFileSystem *fs;
+};
+
+#pragma mark - Import
+
+/**
+ An import of a scene file with an assimp importer of its own.
+ */
+struct AKImport
+{
+    /**
+     The assimp importer, which owns the scene.
+     */
+    Assimp::Importer importer;
+
+    /**
+     The file system which the importer reads files through.
+     */
+    AKFileSystem *fs;
+
+    /**
+     The memory account of the reads and the conversion of the import.
+     */
+    AKMemoryAccount *memory;
+
+    /**
+     The progress handler, owned by the importer, or NULL if the import has
+     no progress.
+     */
+    AKImportProgressHandler *handler;
+
+    /**
+     The progress of the import, or NULL.
+     */
+    AKProgress *progress;
+
+    /**
+     The import options of the following reads.
+     */
+    AKImportOptions options;
+
+    /**
+     The time of the parse and post process phases of the last read.
+     */
+    AKImportStats stats;
+
+    /**
+     The error of the last read which failed.
+     */
+    std::string error;
+};
+
+#pragma mark - Importing a scene file
+
+/**
+ Creates an import.
+
+ @param progress The progress of the import, or NULL. The progress must
+ outlive the import.
+ @return A new import which must be released with AKImportRelease.
+ */
+AKImport *AKImportCreate(AKProgress *progress)
+{
+    AKImport *import = new AKImport;
+    import->progress = progress;
+    import->options = AKImportOptionsMakeDefault();
+    import->stats = AKImportStatsMakeEmpty();
+    import->fs = AKFileSystemCreate();
+    import->memory = AKMemoryAccountCreate();
+    // the importer deletes its IO system
+    import->importer.SetIOHandler(new AKImportIOSystem(import->fs));
+    import->handler = NULL;
+    if (progress != NULL)
+    {
+        // the importer deletes its progress handler
+        import->handler = new AKImportProgressHandler(progress);
+        import->importer.SetProgressHandler(import->handler);
+    }
+    return import;
+}
+
+/**
+ Returns the file system which the importer reads files through, to set its
+ resolver or to memory map files.
+
+ @param import The import.
+ @return The file system, owned by the import.
+ */
+AKFileSystem *AKImportFileSystem(AKImport *import)
+{
+    return import->fs;
+}
+
+/**
+ Returns the memory account of the import, which is in the parse and post
+ process phases while the import reads its scene, and which the conversion of
+ the scene makes current and moves through the following phases.
+
+ @param import The import.
+ @return The memory account, owned by the import.
+ */
+AKMemoryAccount *AKImportMemoryAccount(AKImport *import)
+{
+    return import->memory;
+}
+
+/**
+ Sets an integer property of an assimp importer.
+
+ @param context The assimp importer.
+ @param name The name of the property.
+ @param value The value of the property.
+ */
+static void setIntegerProperty(void *context, const char *name, int value)
+{
+    static_cast<Assimp::Importer *>(context)->SetPropertyInteger(name, value);
+}
+
+/**
+ Sets a float property of an assimp importer.
+
+ @param context The assimp importer.
+ @param name The name of the property.
+ @param value The value of the property.
+ */
+static void setFloatProperty(void *context, const char *name, float value)
+{
+    static_cast<Assimp::Importer *>(context)->SetPropertyFloat(name, value);
+}
+
+/**
+ Sets the options of the importer for the following reads.
+
+ @param import The import.
+ @param options The import options.
+ @return 1 if the options were set, 0 if they are not valid, in which case
+ AKImportErrorString describes the option which is not valid.
+ */
+int AKImportSetOptions(AKImport *import, const AKImportOptions *options)
+{
+    const char *error = AKImportOptionsValidate(options);
+    if (error != NULL)
+    {
+        import->error = error;
+        return 0;
+    }
+    AKImportOptionsVisitProperties(options, setIntegerProperty,
+                                   setFloatProperty, &import->importer);
+    import->options = *options;
+    return 1;
+}
+
+/**
+ Records the error of a read which failed or was cancelled.
+
+ @param import The import.
+ @return NULL.
+ */
+static const struct aiScene *failRead(AKImport *import)
+{
+    if (AKProgressIsCancelled(import->progress))
+    {
+        import->error = "The import was cancelled";
+    }
+    else
+    {
+        const char *error = import->importer.GetErrorString();
+        import->error = error != NULL ? error : "";
+    }
+    import->importer.FreeScene();
+    return NULL;
+}
+
+/**
+ Starts reading the external textures of a scene from the disk, so that the
+ disk reads them while the scene is post processed.
+
+ @param fs The file system of the import.
+ @param aiScene The assimp scene.
+ */
+static void readAheadTextures(AKFileSystem *fs, const struct aiScene *aiScene)
+{
+    for (unsigned int i = 0; i < aiScene->mNumMaterials; i++)
+    {
+        const aiMaterial *aiMaterial = aiScene->mMaterials[i];
+        for (int type = aiTextureType_DIFFUSE; type <= aiTextureType_UNKNOWN;
+             type++)
+        {
+            unsigned int nTextures =
+                aiMaterial->GetTextureCount((aiTextureType)type);
+            for (unsigned int j = 0; j < nTextures; j++)
+            {
+                aiString path;
+                // an embedded texture is named by its index, as *0
+                if (aiMaterial->GetTexture((aiTextureType)type, j, &path) ==
+                        aiReturn_SUCCESS &&
+                    path.length > 0 && path.data[0] != '*')
+                {
+                    AKFileSystemReadAheadReference(fs, path.C_Str());
+                }
+            }
+        }
+    }
+}
+
+/**
+ Reads and post processes a scene file from the file system of the import.
+
+ @param import The import.
+ @param path The path to the scene file.
+ @param postProcessFlags The assimp post processing steps, which are trimmed
+ to the components of the import options.
+ @return The scene, owned by the import, or NULL if the file could not be
+ read or the import was cancelled.
+ */
+static const struct aiScene *readScene(AKImport *import,
+                                       const char *path,
+                                       unsigned int postProcessFlags)
+{
+    import->error.clear();
+    import->stats = AKImportStatsMakeEmpty();
+    if (!AKProgressAdvance(import->progress, AKImportPhaseParse, 0))
+    {
+        return failRead(import);
+    }
+    AKMemoryAccountSetPhase(import->memory, AKImportPhaseParse);
+    double start = AKImportStatsClock();
+    const struct aiScene *aiScene = import->importer.ReadFile(path, 0);
+    start = AKImportStatsAddPhaseTime(&import->stats, AKImportPhaseParse,
+                                      start);
+    if (aiScene == NULL ||
+        !AKProgressCompletePhase(import->progress, AKImportPhaseParse))
+    {
+        return failRead(import);
+    }
+    const unsigned int textures = AKImportComponentGeometry |
+                                  AKImportComponentMaterials |
+                                  AKImportComponentTextures;
+    if ((import->options.components & textures) == textures)
+    {
+        readAheadTextures(import->fs, aiScene);
+    }
+    if (import->handler != NULL)
+    {
+        import->handler->phase = AKImportPhasePostProcess;
+    }
+    AKMemoryAccountSetPhase(import->memory, AKImportPhasePostProcess);
+    postProcessFlags =
+        AKImportOptionsPostProcessFlags(&import->options, postProcessFlags);
+    if (postProcessFlags != 0)
+    {
+        aiScene = import->importer.ApplyPostProcessing(postProcessFlags);
+    }
+    AKImportStatsAddPhaseTime(&import->stats, AKImportPhasePostProcess, start);
+    if (aiScene == NULL ||
+        !AKProgressCompletePhase(import->progress, AKImportPhasePostProcess))
+    {
+        return failRead(import);
+    }
+    return aiScene;
+}
+
+/**
+ Reads and post processes a scene file.
+
+ @param import The import.
+ @param path The path to the scene file.
+ @param postProcessFlags The assimp post processing steps, which are trimmed
+ to the components of the import options.
+ @return The scene, owned by the import, or NULL if the file could not be
+ read or the import was cancelled.
+ */
+const struct aiScene *AKImportReadFile(AKImport *import,
+                                       const char *path,
+                                       unsigned int postProcessFlags)
+{
+    const char *separator = strrchr(path, '/');
+    std::string directory =
+        separator != NULL ? std::string(path, separator - path) : "";
+    AKFileSystemSetBaseDirectory(import->fs, directory.c_str());
+    return readScene(import, path, postProcessFlags);
+}
+
+/**
+ Reads and post processes a scene file in memory, without copying it.
+
+ The external files of the scene are read from the disk relative to the
+ current directory unless the resolver of the file system supplies them.
+
+ @param import The import.
+ @param data The bytes of the scene file, which must stay valid until the
+ import is released.
+ @param length The number of bytes of the scene file.
+ @param hint The file extension of the scene file, such as "obj", which
+ picks the loader of the file.
+ @param postProcessFlags The assimp post processing steps, which are trimmed
+ to the components of the import options.
+ @return The scene, owned by the import, or NULL if the file could not be
+ read or the import was cancelled.
+ */
+const struct aiScene *AKImportReadMemory(AKImport *import,
+                                         const void *data,
+                                         size_t length,
+                                         const char *hint,
+                                         unsigned int postProcessFlags)
+{
+    // the loader is picked by the extension of the name, as assimp does for
+    // its own reads from memory
+    std::string name = "$$AKMemory$$.";
+    if (hint != NULL)
+    {
+        name += hint[0] == '.' ? hint + 1 : hint;
+    }
+    AKFileSystemAddMemoryFile(import->fs, name.c_str(), data, length);
+    AKFileSystemSetBaseDirectory(import->fs, NULL);
+    return readScene(import, name.c_str(), postProcessFlags);
+}
+
+/**
+ Returns the stats of the last read: the time of its parse and post process
+ phases, the counts of its scene, and the files read and the memory of the
+ import.
+
+ The counts and the size of the scene are taken when the stats are asked
+ for, so that a read whose stats are not asked for does not count them.
+
+ @param import The import.
+ @return The import stats.
+ */
+AKImportStats AKImportGetStats(const AKImport *import)
+{
+    AKImportStats stats = import->stats;
+    stats.memory = AKMemoryAccountGetStats(import->memory);
+    const struct aiScene *aiScene = import->importer.GetScene();
+    if (aiScene != NULL)
+    {
+        AKImportStatsAddScene(&stats, aiScene);
+        stats.memory.sceneBytes = AKMemorySceneBytes(aiScene);
+    }
+    stats.files = AKFileSystemGetStats(import->fs);
+    return stats;
+}
+
+/**
+ Returns the error of the last read which failed.
+
+ @param import The import.
+ @return The error description, owned by the import.
+ */
+const char *AKImportErrorString(const AKImport *import)
+{
+    return import->error.c_str();
+}
+
+/**
+ Releases the import and its scene.
+
+ @param import The import, may be NULL.
+ */
+void AKImportRelease(AKImport *import)
+{
+    if (import == NULL)
+    {
+        return;
+    }
+    // the IO system of the importer uses the file system until it is deleted
+    AKFileSystem *fs = import->fs;
+    AKMemoryAccount *memory = import->memory;
+    delete import;
+    AKFileSystemRelease(fs);
+    AKMemoryAccountRelease(memory);
+}
@@ -0,0 +1,174 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKImport_h
+#define AKImport_h
+
+#include "AKFileSystem.h"
+#include "AKImportOptions.h"
+#include "AKImportStats.h"
+#include "AKMemory.h"
+#include "AKProgress.h"
+#include "assimp/scene.h" // Output data structure
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ An import of a scene file with an assimp importer of its own, which reports
+ the parse and post process phases of the import to its progress and stops
+ when the progress is cancelled.
+
+ The file is read first and post processed second, so that the import can be
+ cancelled between the two. The import owns the scene and the error of the
+ import, which are released with the import.
+
+ The importer reads the scene file and its external files through the file
+ system of the import, so a scene can be read from memory, from memory
+ mapped files or from files supplied by a resolver.
+ */
+typedef struct AKImport AKImport;
+
+#pragma mark - Importing a scene file
+
+/**
+ Creates an import.
+
+ @param progress The progress of the import, or NULL. The progress must
+ outlive the import.
+ @return A new import which must be released with AKImportRelease.
+ */
+AKImport *AKImportCreate(AKProgress *progress);
+
+/**
+ Returns the file system which the importer reads files through, to set its
+ resolver or to memory map files.
+
+ @param import The import.
+ @return The file system, owned by the import.
+ */
+AKFileSystem *AKImportFileSystem(AKImport *import);
+
+/**
+ Returns the memory account of the import, which is in the parse and post
+ process phases while the import reads its scene, and which the conversion of
+ the scene makes current and moves through the following phases.
+
+ @param import The import.
+ @return The memory account, owned by the import.
+ */
+AKMemoryAccount *AKImportMemoryAccount(AKImport *import);
+
+/**
+ Sets the options of the importer for the following reads.
+
+ @param import The import.
+ @param options The import options.
+ @return 1 if the options were set, 0 if they are not valid, in which case
+ AKImportErrorString describes the option which is not valid.
+ */
+int AKImportSetOptions(AKImport *import, const AKImportOptions *options);
+
+/**
+ Reads and post processes a scene file.
+
+ @param import The import.
+ @param path The path to the scene file.
+ @param postProcessFlags The assimp post processing steps, which are trimmed
+ to the components of the import options.
+ @return The scene, owned by the import, or NULL if the file could not be
+ read or the import was cancelled.
+ */
+const struct aiScene *AKImportReadFile(AKImport *import,
+                                       const char *path,
+                                       unsigned int postProcessFlags);
+
+/**
+ Reads and post processes a scene file in memory, without copying it.
+
+ The external files of the scene are read from the disk relative to the
+ current directory unless the resolver of the file system supplies them.
+
+ @param import The import.
+ @param data The bytes of the scene file, which must stay valid until the
+ import is released.
+ @param length The number of bytes of the scene file.
+ @param hint The file extension of the scene file, such as "obj", which
+ picks the loader of the file.
+ @param postProcessFlags The assimp post processing steps, which are trimmed
+ to the components of the import options.
+ @return The scene, owned by the import, or NULL if the file could not be
+ read or the import was cancelled.
+ */
+const struct aiScene *AKImportReadMemory(AKImport *import,
+                                         const void *data,
+                                         size_t length,
+                                         const char *hint,
+                                         unsigned int postProcessFlags);
+
+/**
+ Returns the stats of the last read: the time of its parse and post process
+ phases, the counts of its scene, and the files read and the memory of the
+ import.
+
+ The counts and the size of the scene are taken when the stats are asked
+ for, so that a read whose stats are not asked for does not count them.
+
+ @param import The import.
+ @return The import stats.
+ */
+AKImportStats AKImportGetStats(const AKImport *import);
+
+/**
+ Returns the error of the last read which failed.
+
+ @param import The import.
+ @return The error description, owned by the import.
+ */
+const char *AKImportErrorString(const AKImport *import);
+
+/**
+ Releases the import and its scene.
+
+ @param import The import, may be NULL.
+ */
+void AKImportRelease(AKImport *import);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKImport_h */
@@ -0,0 +1,228 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKImportOptions.h"
+#include "assimp/config.h"
+#include "assimp/postprocess.h"
+#include <stddef.h>
+
+#pragma mark - Import options
+
+/**
+ Makes the default import options, which are the defaults of assimp.
+
+ @return The default import options.
+ */
+AKImportOptions AKImportOptionsMakeDefault(void)
+{
+    AKImportOptions options;
+    options.splitVertexLimit = AI_SLM_DEFAULT_MAX_VERTICES;
+    options.splitTriangleLimit = AI_SLM_DEFAULT_MAX_TRIANGLES;
+    options.maxBoneWeights = AI_LMW_MAX_WEIGHTS;
+    options.vertexCacheSize = PP_ICL_PTCACHE_SIZE;
+    options.maxSmoothingAngle = 175.0f;
+    options.favourSpeed = 0;
+    options.components = AKImportComponentAll;
+    return options;
+}
+
+/**
+ Checks the import options.
+
+ @param options The import options.
+ @return NULL if the options are valid, else a description of the first
+ option which is not valid.
+ */
+const char *AKImportOptionsValidate(const AKImportOptions *options)
+{
+    // a split mesh needs room for at least one triangle
+    if (options->splitVertexLimit < 3)
+    {
+        return "The split vertex limit must be at least 3";
+    }
+    if (options->splitTriangleLimit < 1)
+    {
+        return "The split triangle limit must be at least 1";
+    }
+    if (options->maxBoneWeights < 1)
+    {
+        return "The maximum number of bone weights must be at least 1";
+    }
+    // the cache locality step needs room for the vertices of a triangle
+    if (options->vertexCacheSize < 3)
+    {
+        return "The vertex cache size must be at least 3";
+    }
+    if (!(options->maxSmoothingAngle >= 0.0f &&
+          options->maxSmoothingAngle <= 175.0f))
+    {
+        return "The maximum smoothing angle must be from 0 to 175 degrees";
+    }
+    if ((options->components & ~(unsigned int)AKImportComponentAll) != 0)
+    {
+        return "The components must be AKImportComponent flags";
+    }
+    return NULL;
+}
+
+/**
+ Returns the assimp components which the RemoveComponent step removes from
+ the scene for the components left out of an import.
+
+ The meshes are never removed, as the nodes still refer to them, but their
+ vertex attributes are once the geometry is left out. The bones are kept
+ while the animations are imported, as the skeleton is found from them.
+
+ @param components The components of the import.
+ @return The aiComponent flags to remove.
+ */
+static int removedComponents(unsigned int components)
+{
+    int removed = 0;
+    if (!(components & AKImportComponentGeometry))
+    {
+        removed |= aiComponent_NORMALS | aiComponent_TANGENTS_AND_BITANGENTS |
+                   aiComponent_COLORS | aiComponent_TEXCOORDS;
+    }
+    if (!(components & AKImportComponentGeometry) ||
+        !(components & AKImportComponentMaterials) ||
+        !(components & AKImportComponentTextures))
+    {
+        removed |= aiComponent_TEXTURES;
+    }
+    if (!(components & (AKImportComponentSkinning |
+                        AKImportComponentAnimations)))
+    {
+        removed |= aiComponent_BONEWEIGHTS;
+    }
+    if (!(components & AKImportComponentAnimations))
+    {
+        removed |= aiComponent_ANIMATIONS;
+    }
+    if (!(components & AKImportComponentCameras))
+    {
+        removed |= aiComponent_CAMERAS;
+    }
+    if (!(components & AKImportComponentLights))
+    {
+        removed |= aiComponent_LIGHTS;
+    }
+    return removed;
+}
+
+/**
+ Passes each import option to a property callback by its assimp property
+ name, to set it on an importer or an aiPropertyStore.
+
+ @param options The import options.
+ @param integerProperty Receives the integer properties.
+ @param floatProperty Receives the float properties.
+ @param context The context passed to the callbacks.
+ */
+void AKImportOptionsVisitProperties(const AKImportOptions *options,
+                                    AKImportIntegerProperty integerProperty,
+                                    AKImportFloatProperty floatProperty,
+                                    void *context)
+{
+    integerProperty(context, AI_CONFIG_PP_SLM_VERTEX_LIMIT,
+                    (int)options->splitVertexLimit);
+    integerProperty(context, AI_CONFIG_PP_SLM_TRIANGLE_LIMIT,
+                    (int)options->splitTriangleLimit);
+    integerProperty(context, AI_CONFIG_PP_LBW_MAX_WEIGHTS,
+                    (int)options->maxBoneWeights);
+    integerProperty(context, AI_CONFIG_PP_ICL_PTCACHE_SIZE,
+                    (int)options->vertexCacheSize);
+    floatProperty(context, AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE,
+                  options->maxSmoothingAngle);
+    integerProperty(context, AI_CONFIG_FAVOUR_SPEED,
+                    options->favourSpeed != 0 ? 1 : 0);
+    integerProperty(context, AI_CONFIG_PP_RVC_FLAGS,
+                    removedComponents(options->components));
+}
+
+/**
+ Trims the post processing steps of an import to the components of the import
+ options.
+
+ The steps which only serve the components left out are removed, and the
+ RemoveComponent step is added when the options remove components from the
+ assimp scene. The steps which change the node hierarchy, the bones or the
+ animations are kept while a component which depends on them is imported.
+
+ @param options The import options.
+ @param postProcessFlags The assimp post processing steps.
+ @return The post processing steps to apply.
+ */
+unsigned int AKImportOptionsPostProcessFlags(const AKImportOptions *options,
+                                             unsigned int postProcessFlags)
+{
+    unsigned int components = options->components;
+    if (!(components & AKImportComponentGeometry))
+    {
+        postProcessFlags &=
+            ~(aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices |
+              aiProcess_Triangulate | aiProcess_GenNormals |
+              aiProcess_GenSmoothNormals | aiProcess_SplitLargeMeshes |
+              aiProcess_ImproveCacheLocality | aiProcess_FixInfacingNormals |
+              aiProcess_SortByPType | aiProcess_FindDegenerates |
+              aiProcess_GenUVCoords | aiProcess_TransformUVCoords |
+              aiProcess_FindInstances | aiProcess_OptimizeMeshes |
+              aiProcess_FlipUVs | aiProcess_FlipWindingOrder);
+    }
+    if (!(components & AKImportComponentGeometry) ||
+        !(components & AKImportComponentMaterials))
+    {
+        postProcessFlags &= ~aiProcess_RemoveRedundantMaterials;
+    }
+    if (!(components & AKImportComponentGeometry) ||
+        !(components & AKImportComponentMaterials) ||
+        !(components & AKImportComponentTextures))
+    {
+        // the uv channels of the texture mappings only serve the textures
+        postProcessFlags &= ~(aiProcess_GenUVCoords |
+                              aiProcess_TransformUVCoords);
+    }
+    if (!(components & (AKImportComponentSkinning |
+                        AKImportComponentAnimations)))
+    {
+        postProcessFlags &= ~(aiProcess_LimitBoneWeights |
+                              aiProcess_SplitByBoneCount | aiProcess_Debone);
+    }
+    if (removedComponents(components) != 0)
+    {
+        postProcessFlags |= aiProcess_RemoveComponent;
+    }
+    return postProcessFlags;
+}
@@ -0,0 +1,194 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKImportOptions_h
+#define AKImportOptions_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Scene components
+
+/**
+ The parts of a scene which an import converts, combined in the components of
+ the import options.
+
+ The materials, the textures and the skinning are parts of the geometry and
+ are only converted with it. The textures left out are not loaded, so the
+ materials get the colors of their properties instead.
+ */
+typedef enum AKImportComponent
+{
+    AKImportComponentGeometry = 1 << 0,
+    AKImportComponentMaterials = 1 << 1,
+    AKImportComponentTextures = 1 << 2,
+    AKImportComponentSkinning = 1 << 3,
+    AKImportComponentAnimations = 1 << 4,
+    AKImportComponentCameras = 1 << 5,
+    AKImportComponentLights = 1 << 6,
+    AKImportComponentAll = (1 << 7) - 1
+} AKImportComponent;
+
+/**
+ The options which tune the assimp importer and its post processing steps,
+ which are set as properties of the importer before a file is read.
+
+ Each option only applies when its post processing step is requested with the
+ post processing flags of the import.
+ */
+typedef struct AKImportOptions
+{
+    /**
+     The maximum number of vertices in a mesh split by the SplitLargeMeshes
+     step, AI_CONFIG_PP_SLM_VERTEX_LIMIT.
+     */
+    unsigned int splitVertexLimit;
+
+    /**
+     The maximum number of triangles in a mesh split by the SplitLargeMeshes
+     step, AI_CONFIG_PP_SLM_TRIANGLE_LIMIT.
+     */
+    unsigned int splitTriangleLimit;
+
+    /**
+     The maximum number of bones which affect a vertex, kept by the
+     LimitBoneWeights step, AI_CONFIG_PP_LBW_MAX_WEIGHTS.
+     */
+    unsigned int maxBoneWeights;
+
+    /**
+     The number of vertices in the post transform vertex cache which the
+     ImproveCacheLocality step optimizes for, AI_CONFIG_PP_ICL_PTCACHE_SIZE.
+     */
+    unsigned int vertexCacheSize;
+
+    /**
+     The maximum angle in degrees between two face normals at a vertex which
+     the GenSmoothNormals step smooths together,
+     AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE.
+     */
+    float maxSmoothingAngle;
+
+    /**
+     Non zero to hint the importer and the post processing steps to favour
+     speed over the quality of the import, AI_CONFIG_FAVOUR_SPEED.
+     */
+    int favourSpeed;
+
+    /**
+     The parts of the scene to import, a combination of AKImportComponent
+     flags. The post processing steps which only serve the parts left out are
+     skipped, and the parts which the RemoveComponent step can remove safely
+     are removed before the other steps run, AI_CONFIG_PP_RVC_FLAGS.
+     */
+    unsigned int components;
+} AKImportOptions;
+
+/**
+ Receives an integer property of the importer.
+
+ @param context The context passed to AKImportOptionsVisitProperties.
+ @param name The name of the assimp property.
+ @param value The value of the property.
+ */
+typedef void (*AKImportIntegerProperty)(void *context,
+                                        const char *name,
+                                        int value);
+
+/**
+ Receives a float property of the importer.
+
+ @param context The context passed to AKImportOptionsVisitProperties.
+ @param name The name of the assimp property.
+ @param value The value of the property.
+ */
+typedef void (*AKImportFloatProperty)(void *context,
+                                      const char *name,
+                                      float value);
+
+#pragma mark - Import options
+
+/**
+ Makes the default import options, which are the defaults of assimp.
+
+ @return The default import options.
+ */
+AKImportOptions AKImportOptionsMakeDefault(void);
+
+/**
+ Checks the import options.
+
+ @param options The import options.
+ @return NULL if the options are valid, else a description of the first
+ option which is not valid.
+ */
+const char *AKImportOptionsValidate(const AKImportOptions *options);
+
+/**
+ Passes each import option to a property callback by its assimp property
+ name, to set it on an importer or an aiPropertyStore.
+
+ @param options The import options.
+ @param integerProperty Receives the integer properties.
+ @param floatProperty Receives the float properties.
+ @param context The context passed to the callbacks.
+ */
+void AKImportOptionsVisitProperties(const AKImportOptions *options,
+                                    AKImportIntegerProperty integerProperty,
+                                    AKImportFloatProperty floatProperty,
+                                    void *context);
+
+/**
+ Trims the post processing steps of an import to the components of the import
+ options.
+
+ The steps which only serve the components left out are removed, and the
+ RemoveComponent step is added when the options remove components from the
+ assimp scene. The steps which change the node hierarchy, the bones or the
+ animations are kept while a component which depends on them is imported.
+
+ @param options The import options.
+ @param postProcessFlags The assimp post processing steps.
+ @return The post processing steps to apply.
+ */
+unsigned int AKImportOptionsPostProcessFlags(const AKImportOptions *options,
+                                             unsigned int postProcessFlags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKImportOptions_h */
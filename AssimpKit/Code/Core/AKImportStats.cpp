@@ -0,0 +1,269 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKImportStats.h"
+#include <chrono>
+#include <set>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#pragma mark - Collecting import stats
+
+/**
+ Makes import stats with every measurement zero.
+
+ @return The import stats.
+ */
+AKImportStats AKImportStatsMakeEmpty(void)
+{
+    AKImportStats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+/**
+ Returns the time of the monotonic clock which times the phases.
+
+ @return The time in seconds.
+ */
+double AKImportStatsClock(void)
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ Adds the time since the specified start to a phase.
+
+ @param stats The import stats.
+ @param phase The phase.
+ @param start The start time from AKImportStatsClock.
+ @return The current time, to start timing the next phase.
+ */
+double AKImportStatsAddPhaseTime(AKImportStats *stats,
+                                 AKImportPhase phase,
+                                 double start)
+{
+    double now = AKImportStatsClock();
+    stats->phaseSeconds[phase] += now - start;
+    return now;
+}
+
+/**
+ Counts a node and its descendants.
+
+ @param aiNode The assimp node.
+ @return The number of nodes.
+ */
+static unsigned long countNodes(const struct aiNode *aiNode)
+{
+    unsigned long nNodes = 1;
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        nNodes += countNodes(aiNode->mChildren[i]);
+    }
+    return nNodes;
+}
+
+/**
+ Adds the nodes, meshes, bones and keyframes of an assimp scene.
+
+ @param stats The import stats.
+ @param aiScene The assimp scene.
+ */
+void AKImportStatsAddScene(AKImportStats *stats,
+                           const struct aiScene *aiScene)
+{
+    if (aiScene->mRootNode != NULL)
+    {
+        stats->nNodes += countNodes(aiScene->mRootNode);
+    }
+    stats->nMeshes += aiScene->mNumMeshes;
+    std::set<std::string> boneNames;
+    for (unsigned int i = 0; i < aiScene->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[i];
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            boneNames.insert(aiMesh->mBones[j]->mName.C_Str());
+        }
+    }
+    stats->nBones += boneNames.size();
+    for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+    {
+        const struct aiAnimation *aiAnimation = aiScene->mAnimations[i];
+        for (unsigned int j = 0; j < aiAnimation->mNumChannels; j++)
+        {
+            const struct aiNodeAnim *aiNodeAnim = aiAnimation->mChannels[j];
+            stats->nKeyframes += aiNodeAnim->mNumPositionKeys +
+                                 aiNodeAnim->mNumRotationKeys +
+                                 aiNodeAnim->mNumScalingKeys;
+        }
+    }
+}
+
+/**
+ Adds the vertices, the indices and their bytes of a converted node geometry.
+
+ @param stats The import stats.
+ @param geometry The node geometry.
+ */
+void AKImportStatsAddGeometry(AKImportStats *stats,
+                              const AKNodeGeometry *geometry)
+{
+    stats->nVertices += geometry->nVertices;
+    for (int i = 0; i < AKVertexAttributeCount; i++)
+    {
+        const AKVertexAttributeView *view = &geometry->attributes[i];
+        if (view->format == AKVertexFormatNone)
+        {
+            continue;
+        }
+        stats->attributeBytes[i] += (unsigned long)geometry->nVertices *
+                                    view->nComponents *
+                                    view->bytesPerComponent;
+    }
+    for (unsigned int i = 0; i < geometry->nElements; i++)
+    {
+        const AKGeometryElement *element = &geometry->elements[i];
+        stats->nIndices += element->nIndices;
+        stats->indexBytes +=
+            (unsigned long)element->nIndices * element->bytesPerIndex;
+    }
+}
+
+#pragma mark - Serializing import stats
+
+/**
+ The names of the phases in the JSON, indexed by AKImportPhase.
+ */
+static const char *const AKPhaseNames[AKImportPhaseCount] = {
+    "parse",    "postProcess", "geometry",  "materials",
+    "textures", "skin",        "animations"};
+
+/**
+ The names of the vertex attributes in the JSON, indexed by AKVertexAttribute.
+ */
+static const char *const AKAttributeNames[AKVertexAttributeCount] = {
+    "position", "normal", "tangent", "texCoord", "color"};
+
+/**
+ Appends formatted text to the JSON being written.
+
+ @param json The JSON written so far.
+ @param format The printf format.
+ */
+static void appendJSON(std::string *json, const char *format, ...)
+{
+    char text[128];
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(text, sizeof(text), format, arguments);
+    va_end(arguments);
+    json->append(text);
+}
+
+/**
+ Writes the import stats as a JSON object.
+
+ The object has the phase times in seconds under "phases", keyed by phase
+ name, the counts, the bytes of each attribute under "attributeBytes", keyed
+ by attribute name, the file reads under "files", and the memory under
+ "memory", with the memory of each phase under its "phases", keyed by phase
+ name.
+
+ @param stats The import stats.
+ @param buffer The buffer which receives the JSON and its terminating zero,
+ or NULL to measure it.
+ @param size The size of the buffer.
+ @return The length of the JSON, which was truncated if it is not less than
+ size.
+ */
+size_t AKImportStatsFormatJSON(const AKImportStats *stats,
+                               char *buffer,
+                               size_t size)
+{
+    std::string json = "{\"phases\":{";
+    for (int i = 0; i < AKImportPhaseCount; i++)
+    {
+        appendJSON(&json, "%s\"%s\":%.9g", i > 0 ? "," : "", AKPhaseNames[i],
+                   stats->phaseSeconds[i]);
+    }
+    appendJSON(&json, "},\"nodes\":%lu,\"meshes\":%lu,\"bones\":%lu",
+               stats->nNodes, stats->nMeshes, stats->nBones);
+    appendJSON(&json, ",\"keyframes\":%lu,\"vertices\":%lu,\"indices\":%lu",
+               stats->nKeyframes, stats->nVertices, stats->nIndices);
+    appendJSON(&json, ",\"texturesDecoded\":%lu,\"texturesCached\":%lu",
+               stats->nTexturesDecoded, stats->nTexturesCached);
+    json.append(",\"attributeBytes\":{");
+    for (int i = 0; i < AKVertexAttributeCount; i++)
+    {
+        appendJSON(&json, "%s\"%s\":%lu", i > 0 ? "," : "",
+                   AKAttributeNames[i], stats->attributeBytes[i]);
+    }
+    appendJSON(&json, "},\"indexBytes\":%lu", stats->indexBytes);
+    const AKFileSystemStats *files = &stats->files;
+    appendJSON(&json, ",\"files\":{\"opens\":%zu,\"diskOpens\":%zu",
+               files->nOpens, files->nDiskOpens);
+    appendJSON(&json, ",\"cachedOpens\":%zu,\"readAheads\":%zu",
+               files->nCachedOpens, files->nReadAheads);
+    appendJSON(&json, ",\"reads\":%zu,\"bytesRead\":%zu,\"ioSeconds\":%.9g}",
+               files->nReads, files->bytesRead, files->ioSeconds);
+    const AKMemoryStats *memory = &stats->memory;
+    json.append(",\"memory\":{\"phases\":{");
+    for (int i = 0; i < AKImportPhaseCount; i++)
+    {
+        const AKPhaseMemory *phase = &memory->phases[i];
+        appendJSON(&json, "%s\"%s\":{\"allocated\":%zu,\"retained\":%zu",
+                   i > 0 ? "," : "", AKPhaseNames[i], phase->bytesAllocated,
+                   phase->bytesRetained);
+        appendJSON(&json, ",\"peak\":%zu,\"footprint\":%zu}",
+                   phase->peakBytes, phase->footprintBytes);
+    }
+    appendJSON(&json, "},\"peak\":%zu,\"peakFootprint\":%zu",
+               memory->peakBytes, memory->peakFootprintBytes);
+    appendJSON(&json, ",\"textures\":%zu,\"scene\":%zu}}",
+               memory->textureBytes, memory->sceneBytes);
+    if (buffer != NULL && size > 0)
+    {
+        size_t length = json.size() < size ? json.size() : size - 1;
+        memcpy(buffer, json.data(), length);
+        buffer[length] = '\0';
+    }
+    return json.size();
+}
@@ -0,0 +1,199 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKImportStats_h
+#define AKImportStats_h
+
+#include "AKFileSystem.h"
+#include "AKGeometry.h"
+#include "AKMemory.h"
+#include "AKProgress.h"
+#include "assimp/scene.h" // Output data structure
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ The measurements of an import: the time of each phase, the counts of the
+ scene and of its converted geometry, and the files read.
+
+ The phases are timed with a monotonic clock. The measurements are plain
+ counters, so that collecting them costs a few clock reads per node and
+ texture, and can be serialized to JSON to aggregate them across sessions.
+ */
+typedef struct AKImportStats
+{
+    /**
+     The time spent in each phase in seconds, indexed by AKImportPhase.
+     */
+    double phaseSeconds[AKImportPhaseCount];
+
+    /**
+     The number of nodes of the assimp scene.
+     */
+    unsigned long nNodes;
+
+    /**
+     The number of meshes of the assimp scene.
+     */
+    unsigned long nMeshes;
+
+    /**
+     The number of bones of the meshes, each bone counted once by name.
+     */
+    unsigned long nBones;
+
+    /**
+     The number of position, rotation and scaling keys of the animations.
+     */
+    unsigned long nKeyframes;
+
+    /**
+     The number of vertices of the converted node geometries.
+     */
+    unsigned long nVertices;
+
+    /**
+     The number of indices of the converted node geometries.
+     */
+    unsigned long nIndices;
+
+    /**
+     The number of textures decoded.
+     */
+    unsigned long nTexturesDecoded;
+
+    /**
+     The number of textures taken from the image cache of the import.
+     */
+    unsigned long nTexturesCached;
+
+    /**
+     The number of bytes of each vertex attribute of the converted node
+     geometries, indexed by AKVertexAttribute.
+     */
+    unsigned long attributeBytes[AKVertexAttributeCount];
+
+    /**
+     The number of bytes of the indices of the converted node geometries.
+     */
+    unsigned long indexBytes;
+
+    /**
+     The files read by the import.
+     */
+    AKFileSystemStats files;
+
+    /**
+     The memory of the import, with the decoded textures apart.
+     */
+    AKMemoryStats memory;
+} AKImportStats;
+
+#pragma mark - Collecting import stats
+
+/**
+ Makes import stats with every measurement zero.
+
+ @return The import stats.
+ */
+AKImportStats AKImportStatsMakeEmpty(void);
+
+/**
+ Returns the time of the monotonic clock which times the phases.
+
+ @return The time in seconds.
+ */
+double AKImportStatsClock(void);
+
+/**
+ Adds the time since the specified start to a phase.
+
+ @param stats The import stats.
+ @param phase The phase.
+ @param start The start time from AKImportStatsClock.
+ @return The current time, to start timing the next phase.
+ */
+double AKImportStatsAddPhaseTime(AKImportStats *stats,
+                                 AKImportPhase phase,
+                                 double start);
+
+/**
+ Adds the nodes, meshes, bones and keyframes of an assimp scene.
+
+ @param stats The import stats.
+ @param aiScene The assimp scene.
+ */
+void AKImportStatsAddScene(AKImportStats *stats,
+                           const struct aiScene *aiScene);
+
+/**
+ Adds the vertices, the indices and their bytes of a converted node geometry.
+
+ @param stats The import stats.
+ @param geometry The node geometry.
+ */
+void AKImportStatsAddGeometry(AKImportStats *stats,
+                              const AKNodeGeometry *geometry);
+
+#pragma mark - Serializing import stats
+
+/**
+ Writes the import stats as a JSON object.
+
+ The object has the phase times in seconds under "phases", keyed by phase
+ name, the counts, the bytes of each attribute under "attributeBytes", keyed
+ by attribute name, the file reads under "files", and the memory under
+ "memory", with the memory of each phase under its "phases", keyed by phase
+ name.
+
+ @param stats The import stats.
+ @param buffer The buffer which receives the JSON and its terminating zero,
+ or NULL to measure it.
+ @param size The size of the buffer.
+ @return The length of the JSON, which was truncated if it is not less than
+ size.
+ */
+size_t AKImportStatsFormatJSON(const AKImportStats *stats,
+                               char *buffer,
+                               size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKImportStats_h */
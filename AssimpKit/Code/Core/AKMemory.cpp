@@ -0,0 +1,446 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKMemory.h"
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+/**
+ The memory account of an import.
+ */
+struct AKMemoryAccount
+{
+    /**
+     The phase which the allocations are charged to.
+     */
+    std::atomic<int> phase;
+
+    /**
+     The number of bytes allocated by the core and not freed yet, which is
+     negative if the core freed more than it allocated under the account.
+     */
+    std::atomic<long long> liveBytes;
+
+    /**
+     The largest number of bytes allocated at once.
+     */
+    std::atomic<long long> peakBytes;
+
+    /**
+     The number of bytes allocated in each phase.
+     */
+    std::atomic<size_t> bytesAllocated[AKImportPhaseCount];
+
+    /**
+     The largest number of bytes allocated at once in each phase.
+     */
+    std::atomic<long long> phasePeakBytes[AKImportPhaseCount];
+
+    /**
+     The number of bytes of the decoded textures.
+     */
+    std::atomic<size_t> textureBytes;
+
+    /**
+     The lock of the ends of the phases, which are recorded when the phase
+     changes.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     The bytes still allocated at the last end of each phase.
+     */
+    long long retainedBytes[AKImportPhaseCount];
+
+    /**
+     The footprint of the process at the last end of each phase.
+     */
+    size_t footprintBytes[AKImportPhaseCount];
+
+    /**
+     The largest footprint of the process at the end of a phase.
+     */
+    size_t peakFootprintBytes;
+};
+
+/**
+ The memory account current on each thread.
+ */
+static thread_local AKMemoryAccount *currentAccount = NULL;
+
+/**
+ Raises a maximum to a value.
+
+ @param maximum The maximum.
+ @param value The value.
+ */
+static void raiseMaximum(std::atomic<long long> *maximum, long long value)
+{
+    long long current = maximum->load(std::memory_order_relaxed);
+    while (value > current &&
+           !maximum->compare_exchange_weak(current, value,
+                                           std::memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ Returns the number of bytes of a malloc block, which may be more than the
+ size asked for.
+
+ @param buffer The malloc block.
+ @return The number of bytes, or 0 if the platform does not tell.
+ */
+static size_t blockSize(void *buffer)
+{
+#if defined(__APPLE__)
+    return malloc_size(buffer);
+#elif defined(__GLIBC__)
+    return malloc_usable_size(buffer);
+#else
+    (void)buffer;
+    return 0;
+#endif
+}
+
+#pragma mark - Creating a memory account
+
+/**
+ Creates a memory account, in the parse phase.
+
+ @return A new memory account which must be released with
+ AKMemoryAccountRelease.
+ */
+AKMemoryAccount *AKMemoryAccountCreate(void)
+{
+    AKMemoryAccount *account = new AKMemoryAccount;
+    account->phase = AKImportPhaseParse;
+    account->liveBytes = 0;
+    account->peakBytes = 0;
+    for (int i = 0; i < AKImportPhaseCount; i++)
+    {
+        account->bytesAllocated[i] = 0;
+        account->phasePeakBytes[i] = 0;
+        account->retainedBytes[i] = 0;
+        account->footprintBytes[i] = 0;
+    }
+    account->textureBytes = 0;
+    account->peakFootprintBytes = 0;
+    return account;
+}
+
+/**
+ Releases the memory account.
+
+ @param account The memory account, may be NULL.
+ */
+void AKMemoryAccountRelease(AKMemoryAccount *account)
+{
+    delete account;
+}
+
+#pragma mark - Charging a memory account
+
+/**
+ Makes the memory account current on the calling thread.
+
+ @param account The memory account, or NULL to charge no account.
+ @return The account which was current before, to make it current again.
+ */
+AKMemoryAccount *AKMemoryAccountMakeCurrent(AKMemoryAccount *account)
+{
+    AKMemoryAccount *previous = currentAccount;
+    currentAccount = account;
+    return previous;
+}
+
+/**
+ Returns the memory account current on the calling thread.
+
+ @return The current memory account, or NULL.
+ */
+AKMemoryAccount *AKMemoryAccountCurrent(void)
+{
+    return currentAccount;
+}
+
+/**
+ Ends the current phase of the account, recording the bytes still allocated
+ and the footprint of the process, and charges the following allocations to
+ the specified phase.
+
+ A phase may be entered again, which adds to its memory.
+
+ @param account The memory account, may be NULL.
+ @param phase The phase.
+ */
+void AKMemoryAccountSetPhase(AKMemoryAccount *account, AKImportPhase phase)
+{
+    if (account == NULL)
+    {
+        return;
+    }
+    size_t footprint = AKMemoryFootprint();
+    std::lock_guard<std::mutex> lock(account->mutex);
+    int ended = account->phase.exchange(phase);
+    long long live = account->liveBytes;
+    account->retainedBytes[ended] = live;
+    account->footprintBytes[ended] = footprint;
+    if (footprint > account->peakFootprintBytes)
+    {
+        account->peakFootprintBytes = footprint;
+    }
+    // the bytes allocated before the phase are allocated at once in it
+    raiseMaximum(&account->phasePeakBytes[phase], live);
+}
+
+/**
+ Adds the bytes of decoded textures to the account.
+
+ @param account The memory account, may be NULL.
+ @param bytes The number of bytes.
+ */
+void AKMemoryAccountAddTextureBytes(AKMemoryAccount *account, size_t bytes)
+{
+    if (account != NULL)
+    {
+        account->textureBytes += bytes;
+    }
+}
+
+/**
+ Returns the memory of the account, with the current phase ended now.
+
+ @param account The memory account.
+ @return The memory stats, whose scene bytes are 0.
+ */
+AKMemoryStats AKMemoryAccountGetStats(const AKMemoryAccount *account)
+{
+    AKMemoryStats stats;
+    size_t footprint = AKMemoryFootprint();
+    std::lock_guard<std::mutex> lock(account->mutex);
+    int current = account->phase;
+    for (int i = 0; i < AKImportPhaseCount; i++)
+    {
+        AKPhaseMemory *phase = &stats.phases[i];
+        long long retained = i == current ? account->liveBytes.load()
+                                          : account->retainedBytes[i];
+        phase->bytesAllocated = account->bytesAllocated[i];
+        phase->bytesRetained = retained > 0 ? (size_t)retained : 0;
+        long long peak = account->phasePeakBytes[i];
+        phase->peakBytes = peak > 0 ? (size_t)peak : 0;
+        phase->footprintBytes =
+            i == current ? footprint : account->footprintBytes[i];
+    }
+    long long peak = account->peakBytes;
+    stats.peakBytes = peak > 0 ? (size_t)peak : 0;
+    stats.peakFootprintBytes = footprint > account->peakFootprintBytes
+                                   ? footprint
+                                   : account->peakFootprintBytes;
+    stats.textureBytes = account->textureBytes;
+    stats.sceneBytes = 0;
+    return stats;
+}
+
+#pragma mark - Allocating buffers
+
+/**
+ Charges a malloc block to the current memory account.
+
+ @param buffer The malloc block, may be NULL.
+ @return The malloc block.
+ */
+static void *charge(void *buffer)
+{
+    AKMemoryAccount *account = currentAccount;
+    if (account == NULL || buffer == NULL)
+    {
+        return buffer;
+    }
+    size_t size = blockSize(buffer);
+    int phase = account->phase.load(std::memory_order_relaxed);
+    account->bytesAllocated[phase].fetch_add(size, std::memory_order_relaxed);
+    long long live =
+        account->liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    raiseMaximum(&account->phasePeakBytes[phase], live);
+    raiseMaximum(&account->peakBytes, live);
+    return buffer;
+}
+
+/**
+ Allocates a buffer, charged to the current memory account.
+
+ @param size The size of the buffer in bytes.
+ @return The buffer, which can be freed with AKMemoryFree or free, or NULL.
+ */
+void *AKMemoryMalloc(size_t size)
+{
+    return charge(malloc(size));
+}
+
+/**
+ Allocates a zeroed array, charged to the current memory account.
+
+ @param count The number of elements.
+ @param size The size of each element in bytes.
+ @return The buffer, which can be freed with AKMemoryFree or free, or NULL.
+ */
+void *AKMemoryCalloc(size_t count, size_t size)
+{
+    return charge(calloc(count, size));
+}
+
+/**
+ Frees a buffer allocated with AKMemoryMalloc or AKMemoryCalloc, and takes it
+ off the current memory account.
+
+ @param buffer The buffer, may be NULL.
+ */
+void AKMemoryFree(void *buffer)
+{
+    AKMemoryAccount *account = currentAccount;
+    if (account != NULL && buffer != NULL)
+    {
+        account->liveBytes.fetch_sub(blockSize(buffer),
+                                     std::memory_order_relaxed);
+    }
+    free(buffer);
+}
+
+#pragma mark - Measuring memory
+
+/**
+ Returns the memory footprint of the process: its physical footprint on Apple
+ platforms, and its resident set elsewhere.
+
+ @return The footprint in bytes, or 0 if it is not known.
+ */
+size_t AKMemoryFootprint(void)
+{
+#if defined(__APPLE__)
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info,
+                  &count) != KERN_SUCCESS)
+    {
+        return 0;
+    }
+    return (size_t)info.phys_footprint;
+#elif defined(__GLIBC__)
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == NULL)
+    {
+        return 0;
+    }
+    unsigned long nPages = 0;
+    unsigned long nResidentPages = 0;
+    int nRead = fscanf(file, "%lu %lu", &nPages, &nResidentPages);
+    fclose(file);
+    return nRead == 2 ? nResidentPages * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+/**
+ Estimates the number of bytes of an assimp scene, from the sizes of its
+ vertex streams, faces, bone weights and animation keys.
+
+ @param aiScene The assimp scene.
+ @return The number of bytes.
+ */
+size_t AKMemorySceneBytes(const struct aiScene *aiScene)
+{
+    size_t bytes = sizeof(struct aiScene);
+    for (unsigned int i = 0; i < aiScene->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[i];
+        size_t nVectors = 1 + (aiMesh->HasNormals() ? 1 : 0) +
+                          (aiMesh->HasTangentsAndBitangents() ? 2 : 0);
+        size_t perVertex = nVectors * sizeof(aiVector3D);
+        for (unsigned int j = 0; j < AI_MAX_NUMBER_OF_TEXTURECOORDS; j++)
+        {
+            perVertex += aiMesh->HasTextureCoords(j) ? sizeof(aiVector3D) : 0;
+        }
+        for (unsigned int j = 0; j < AI_MAX_NUMBER_OF_COLOR_SETS; j++)
+        {
+            perVertex += aiMesh->HasVertexColors(j) ? sizeof(aiColor4D) : 0;
+        }
+        bytes += sizeof(struct aiMesh) + aiMesh->mNumVertices * perVertex;
+        for (unsigned int j = 0; j < aiMesh->mNumFaces; j++)
+        {
+            bytes += sizeof(aiFace) +
+                     aiMesh->mFaces[j].mNumIndices * sizeof(unsigned int);
+        }
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            bytes += sizeof(aiBone) +
+                     aiMesh->mBones[j]->mNumWeights * sizeof(aiVertexWeight);
+        }
+    }
+    for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+    {
+        const struct aiAnimation *aiAnimation = aiScene->mAnimations[i];
+        for (unsigned int j = 0; j < aiAnimation->mNumChannels; j++)
+        {
+            const struct aiNodeAnim *aiNodeAnim = aiAnimation->mChannels[j];
+            bytes += sizeof(struct aiNodeAnim) +
+                     (aiNodeAnim->mNumPositionKeys +
+                      aiNodeAnim->mNumScalingKeys) *
+                         sizeof(aiVectorKey) +
+                     aiNodeAnim->mNumRotationKeys * sizeof(aiQuatKey);
+        }
+    }
+    for (unsigned int i = 0; i < aiScene->mNumTextures; i++)
+    {
+        const struct aiTexture *aiTexture = aiScene->mTextures[i];
+        // a compressed texture has its size in bytes as its width
+        bytes += sizeof(struct aiTexture) +
+                 (aiTexture->mHeight == 0
+                      ? aiTexture->mWidth
+                      : aiTexture->mWidth * aiTexture->mHeight *
+                            sizeof(aiTexel));
+    }
+    return bytes;
+}
@@ -0,0 +1,289 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKMemory_h
+#define AKMemory_h
+
+#include "AKProgress.h"
+#include "assimp/scene.h" // Output data structure
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ The memory account of an import, which counts the buffers the conversion
+ core allocates in each import phase.
+
+ The core allocates its buffers with AKMemoryMalloc and AKMemoryCalloc and
+ frees them with AKMemoryFree, which charge the account current on the
+ calling thread, if any. The buffers are plain malloc blocks, so that a buffer
+ handed over to its owner, such as the bytes of an NSData, is freed with free
+ and stays charged to the account as retained by the import.
+
+ The account is current on one thread at a time, and the work pool makes the
+ account current on the thread which runs a batch current on each of its
+ workers, so that a parallel conversion is charged to its import. The
+ allocations may be charged from several threads at the same time.
+ */
+typedef struct AKMemoryAccount AKMemoryAccount;
+
+/**
+ The memory of an import phase.
+ */
+typedef struct AKPhaseMemory
+{
+    /**
+     The number of bytes the core allocated in the phase.
+     */
+    size_t bytesAllocated;
+
+    /**
+     The number of bytes allocated by the core which were still allocated at
+     the end of the phase, whichever phase allocated them.
+     */
+    size_t bytesRetained;
+
+    /**
+     The largest number of bytes allocated by the core at once in the phase.
+     */
+    size_t peakBytes;
+
+    /**
+     The memory footprint of the process at the end of the phase, which
+     includes the memory allocated outside of the core, such as the assimp
+     scene, or 0 if the phase was not entered.
+     */
+    size_t footprintBytes;
+} AKPhaseMemory;
+
+/**
+ The memory of an import.
+ */
+typedef struct AKMemoryStats
+{
+    /**
+     The memory of each phase, indexed by AKImportPhase.
+     */
+    AKPhaseMemory phases[AKImportPhaseCount];
+
+    /**
+     The largest number of bytes allocated by the core at once in the import.
+     */
+    size_t peakBytes;
+
+    /**
+     The largest memory footprint of the process at the end of a phase.
+     */
+    size_t peakFootprintBytes;
+
+    /**
+     The number of bytes of the decoded textures, which are counted apart
+     from the phases.
+     */
+    size_t textureBytes;
+
+    /**
+     An estimate of the number of bytes of the assimp scene, from the sizes
+     of its vertex streams, faces, bone weights and animation keys.
+     */
+    size_t sceneBytes;
+} AKMemoryStats;
+
+#pragma mark - Creating a memory account
+
+/**
+ Creates a memory account, in the parse phase.
+
+ @return A new memory account which must be released with
+ AKMemoryAccountRelease.
+ */
+AKMemoryAccount *AKMemoryAccountCreate(void);
+
+/**
+ Releases the memory account.
+
+ @param account The memory account, may be NULL.
+ */
+void AKMemoryAccountRelease(AKMemoryAccount *account);
+
+#pragma mark - Charging a memory account
+
+/**
+ Makes the memory account current on the calling thread.
+
+ @param account The memory account, or NULL to charge no account.
+ @return The account which was current before, to make it current again.
+ */
+AKMemoryAccount *AKMemoryAccountMakeCurrent(AKMemoryAccount *account);
+
+/**
+ Returns the memory account current on the calling thread.
+
+ @return The current memory account, or NULL.
+ */
+AKMemoryAccount *AKMemoryAccountCurrent(void);
+
+/**
+ Ends the current phase of the account, recording the bytes still allocated
+ and the footprint of the process, and charges the following allocations to
+ the specified phase.
+
+ A phase may be entered again, which adds to its memory.
+
+ @param account The memory account, may be NULL.
+ @param phase The phase.
+ */
+void AKMemoryAccountSetPhase(AKMemoryAccount *account, AKImportPhase phase);
+
+/**
+ Adds the bytes of decoded textures to the account.
+
+ @param account The memory account, may be NULL.
+ @param bytes The number of bytes.
+ */
+void AKMemoryAccountAddTextureBytes(AKMemoryAccount *account, size_t bytes);
+
+/**
+ Returns the memory of the account, with the current phase ended now.
+
+ @param account The memory account.
+ @return The memory stats, whose scene bytes are 0.
+ */
+AKMemoryStats AKMemoryAccountGetStats(const AKMemoryAccount *account);
+
+#pragma mark - Allocating buffers
+
+/**
+ Allocates a buffer, charged to the current memory account.
+
+ @param size The size of the buffer in bytes.
+ @return The buffer, which can be freed with AKMemoryFree or free, or NULL.
+ */
+void *AKMemoryMalloc(size_t size);
+
+/**
+ Allocates a zeroed array, charged to the current memory account.
+
+ @param count The number of elements.
+ @param size The size of each element in bytes.
+ @return The buffer, which can be freed with AKMemoryFree or free, or NULL.
+ */
+void *AKMemoryCalloc(size_t count, size_t size);
+
+/**
+ Frees a buffer allocated with AKMemoryMalloc or AKMemoryCalloc, and takes it
+ off the current memory account.
+
+ @param buffer The buffer, may be NULL.
+ */
+void AKMemoryFree(void *buffer);
+
+#pragma mark - Measuring memory
+
+/**
+ Returns the memory footprint of the process: its physical footprint on Apple
+ platforms, and its resident set elsewhere.
+
+ @return The footprint in bytes, or 0 if it is not known.
+ */
+size_t AKMemoryFootprint(void);
+
+/**
+ Estimates the number of bytes of an assimp scene, from the sizes of its
+ vertex streams, faces, bone weights and animation keys.
+
+ @param aiScene The assimp scene.
+ @return The number of bytes.
+ */
+size_t AKMemorySceneBytes(const struct aiScene *aiScene);
+
+#ifdef __cplusplus
+}
+
+#include <new>
+
+/**
+ The allocator of the scratch containers of the core, such as the vertex
+ maps of a split geometry, which charges them to the current memory account.
+ */
+template <typename T> struct AKMemoryAllocator
+{
+    typedef T value_type;
+
+    AKMemoryAllocator() {}
+
+    template <typename U> AKMemoryAllocator(const AKMemoryAllocator<U> &) {}
+
+    /**
+     Allocates the elements.
+
+     @param n The number of elements.
+     @return The elements.
+     */
+    T *allocate(size_t n)
+    {
+        T *elements = (T *)AKMemoryMalloc(n * sizeof(T));
+        if (elements == NULL)
+        {
+            throw std::bad_alloc();
+        }
+        return elements;
+    }
+
+    /**
+     Frees the elements.
+
+     @param elements The elements.
+     @param n The number of elements.
+     */
+    void deallocate(T *elements, size_t n) { AKMemoryFree(elements); }
+};
+
+template <typename T, typename U>
+bool operator==(const AKMemoryAllocator<T> &, const AKMemoryAllocator<U> &)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const AKMemoryAllocator<T> &, const AKMemoryAllocator<U> &)
+{
+    return false;
+}
+#endif
+
+#endif /* AKMemory_h */
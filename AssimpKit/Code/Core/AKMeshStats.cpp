@@ -0,0 +1,161 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKMeshStats.h"
+#include "AKMemory.h"
+#include <stdlib.h>
+#include <vector>
+
+#pragma mark - Mesh statistics
+
+/**
+ Computes the statistics of a mesh in one pass over its faces and one pass
+ over its bone weights.
+
+ @param aiMesh The assimp mesh.
+ @return The statistics of the mesh.
+ */
+AKMeshStats AKMeshStatsMake(const struct aiMesh *aiMesh)
+{
+    AKMeshStats stats;
+    stats.nVertices = aiMesh->mNumVertices;
+    stats.nIndices = 0;
+    stats.triangulated = 1;
+    for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
+    {
+        unsigned int nIndices = aiMesh->mFaces[i].mNumIndices;
+        stats.nIndices += nIndices;
+        stats.triangulated = stats.triangulated && nIndices == 3;
+    }
+    stats.streams = 0;
+    if (aiMesh->mNormals != NULL)
+    {
+        stats.streams |= AKMeshStreamNormals;
+    }
+    if (aiMesh->mTangents != NULL)
+    {
+        stats.streams |= AKMeshStreamTangents;
+    }
+    if (aiMesh->mTextureCoords[0] != NULL)
+    {
+        stats.streams |= AKMeshStreamTexCoords;
+    }
+    if (aiMesh->mColors[0] != NULL)
+    {
+        stats.streams |= AKMeshStreamColors;
+    }
+    stats.nBones = aiMesh->mNumBones;
+    stats.maxWeights = 0;
+    if (aiMesh->mNumBones > 0 && aiMesh->mNumVertices > 0)
+    {
+        std::vector<unsigned int> vertexWeights(aiMesh->mNumVertices, 0);
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            const struct aiBone *aiBone = aiMesh->mBones[j];
+            for (unsigned int k = 0; k < aiBone->mNumWeights; k++)
+            {
+                // the weights of a vertex which is not in the mesh are
+                // skipped, as the node skin skips them
+                unsigned int vertex = aiBone->mWeights[k].mVertexId;
+                if (vertex >= aiMesh->mNumVertices)
+                {
+                    continue;
+                }
+                unsigned int count = ++vertexWeights[vertex];
+                if (count > stats.maxWeights)
+                {
+                    stats.maxWeights = count;
+                }
+            }
+        }
+    }
+    return stats;
+}
+
+/**
+ Creates the statistics of every mesh of the scene.
+
+ @param aiScene The assimp scene.
+ @return The new scene statistics which must be released with
+ AKSceneStatsRelease.
+ */
+AKSceneStats *AKSceneStatsCreate(const struct aiScene *aiScene)
+{
+    AKSceneStats *stats =
+        (AKSceneStats *)AKMemoryCalloc(1, sizeof(AKSceneStats));
+    stats->nMeshes = aiScene->mNumMeshes;
+    stats->meshes =
+        (AKMeshStats *)AKMemoryCalloc(aiScene->mNumMeshes, sizeof(AKMeshStats));
+    for (unsigned int i = 0; i < aiScene->mNumMeshes; i++)
+    {
+        stats->meshes[i] = AKMeshStatsMake(aiScene->mMeshes[i]);
+    }
+    return stats;
+}
+
+/**
+ Releases the scene statistics.
+
+ @param stats The scene statistics, may be NULL.
+ */
+void AKSceneStatsRelease(AKSceneStats *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+    AKMemoryFree(stats->meshes);
+    AKMemoryFree(stats);
+}
+
+/**
+ Finds the statistics of a mesh of the scene.
+
+ @param stats The scene statistics, or NULL to compute the statistics of the
+ mesh.
+ @param aiScene The assimp scene.
+ @param meshIndex The index of the mesh in the scene.
+ @return The statistics of the mesh.
+ */
+AKMeshStats AKSceneStatsOfMesh(const AKSceneStats *stats,
+                               const struct aiScene *aiScene,
+                               unsigned int meshIndex)
+{
+    if (stats != NULL && meshIndex < stats->nMeshes)
+    {
+        return stats->meshes[meshIndex];
+    }
+    return AKMeshStatsMake(aiScene->mMeshes[meshIndex]);
+}
@@ -0,0 +1,157 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKMeshStats_h
+#define AKMeshStats_h
+
+#include "assimp/scene.h" // Output data structure
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Mesh statistics
+
+/**
+ The optional vertex streams of a mesh.
+ */
+typedef enum AKMeshStream
+{
+    AKMeshStreamNormals = 1 << 0,
+    AKMeshStreamTangents = 1 << 1,
+    AKMeshStreamTexCoords = 1 << 2,
+    AKMeshStreamColors = 1 << 3
+} AKMeshStream;
+
+/**
+ The counts of a mesh which size and shape the buffers of a node geometry and
+ a node skin.
+ */
+typedef struct AKMeshStats
+{
+    /**
+     The number of vertices.
+     */
+    unsigned int nVertices;
+
+    /**
+     The total number of indices in the faces.
+     */
+    unsigned int nIndices;
+
+    /**
+     Non zero if every face is a triangle.
+     */
+    int triangulated;
+
+    /**
+     The optional vertex streams of the mesh, see AKMeshStream.
+     */
+    unsigned int streams;
+
+    /**
+     The number of bones.
+     */
+    unsigned int nBones;
+
+    /**
+     The maximum number of weights influencing any vertex.
+     */
+    unsigned int maxWeights;
+} AKMeshStats;
+
+/**
+ The statistics of every mesh of a scene.
+
+ The statistics are computed once per import, so that converting a node and
+ making its skinner later on do not walk the faces and bone weights of its
+ meshes again to size their buffers.
+ */
+typedef struct AKSceneStats
+{
+    /**
+     The number of meshes in the scene.
+     */
+    unsigned int nMeshes;
+
+    /**
+     The statistics of each mesh, indexed like the meshes of the scene.
+     */
+    AKMeshStats *meshes;
+} AKSceneStats;
+
+/**
+ Computes the statistics of a mesh in one pass over its faces and one pass
+ over its bone weights.
+
+ @param aiMesh The assimp mesh.
+ @return The statistics of the mesh.
+ */
+AKMeshStats AKMeshStatsMake(const struct aiMesh *aiMesh);
+
+/**
+ Creates the statistics of every mesh of the scene.
+
+ @param aiScene The assimp scene.
+ @return The new scene statistics which must be released with
+ AKSceneStatsRelease.
+ */
+AKSceneStats *AKSceneStatsCreate(const struct aiScene *aiScene);
+
+/**
+ Releases the scene statistics.
+
+ @param stats The scene statistics, may be NULL.
+ */
+void AKSceneStatsRelease(AKSceneStats *stats);
+
+/**
+ Finds the statistics of a mesh of the scene.
+
+ @param stats The scene statistics, or NULL to compute the statistics of the
+ mesh.
+ @param aiScene The assimp scene.
+ @param meshIndex The index of the mesh in the scene.
+ @return The statistics of the mesh.
+ */
+AKMeshStats AKSceneStatsOfMesh(const AKSceneStats *stats,
+                               const struct aiScene *aiScene,
+                               unsigned int meshIndex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKMeshStats_h */
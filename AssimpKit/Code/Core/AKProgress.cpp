@@ -0,0 +1,375 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKProgress.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+/**
+ The progress of an import.
+ */
+struct AKProgress
+{
+    /**
+     The function which receives the progress, or NULL.
+     */
+    AKProgressCallback callback;
+
+    /**
+     The context passed to the callback.
+     */
+    void *context;
+
+    /**
+     The amount of work of each phase.
+     */
+    unsigned long totals[AKImportPhaseCount];
+
+    /**
+     The amount of work completed in each phase.
+     */
+    unsigned long done[AKImportPhaseCount];
+
+    /**
+     Non zero for each phase which was completed.
+     */
+    int completed[AKImportPhaseCount];
+
+    /**
+     The phase which advanced last.
+     */
+    AKImportPhase phase;
+
+    /**
+     The completed fraction last reported to the callback, or -1 if none was
+     reported.
+     */
+    float reportedFraction;
+
+    /**
+     The phase last reported to the callback.
+     */
+    AKImportPhase reportedPhase;
+
+    /**
+     The time the import was cancelled at, in nanoseconds of the steady
+     clock, or 0 if the import was not cancelled.
+     */
+    std::atomic<long long> cancelTime;
+
+    /**
+     The cancellation latency in seconds, or -1 if it was not measured.
+     */
+    double latency;
+
+    /**
+     The lock of the work done, the reports and the latency, which are
+     updated by every worker of a parallel conversion.
+     */
+    std::mutex mutex;
+};
+
+#pragma mark - Phase shares
+
+/**
+ The share of each phase in the whole import.
+
+ Parsing takes most of an import, followed by the conversion of the geometry
+ and the loading of the textures.
+ */
+static const float kPhaseShares[AKImportPhaseCount] = {
+    0.40f, // parse
+    0.15f, // post process
+    0.20f, // geometry
+    0.05f, // materials
+    0.10f, // textures
+    0.05f, // skin
+    0.05f  // animations
+};
+
+/**
+ Returns the current time of the steady clock.
+
+ @return The time in nanoseconds, never 0.
+ */
+static long long nowNanoseconds()
+{
+    long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count();
+    return now != 0 ? now : 1;
+}
+
+#pragma mark - Creating a progress
+
+/**
+ Creates the progress of an import.
+
+ @param callback The function which receives the progress, or NULL.
+ @param context The context passed to the function.
+ @return A new progress which must be released with AKProgressRelease.
+ */
+AKProgress *AKProgressCreate(AKProgressCallback callback, void *context)
+{
+    AKProgress *progress = new AKProgress;
+    progress->callback = callback;
+    progress->context = context;
+    for (int i = 0; i < AKImportPhaseCount; i++)
+    {
+        progress->totals[i] = 0;
+        progress->done[i] = 0;
+        progress->completed[i] = 0;
+    }
+    progress->phase = AKImportPhaseParse;
+    progress->reportedFraction = -1.0f;
+    progress->reportedPhase = AKImportPhaseParse;
+    progress->cancelTime.store(0);
+    progress->latency = -1.0;
+    return progress;
+}
+
+/**
+ Releases the progress.
+
+ @param progress The progress, may be NULL.
+ */
+void AKProgressRelease(AKProgress *progress)
+{
+    delete progress;
+}
+
+#pragma mark - Reporting progress
+
+/**
+ Reports the progress to the callback when the phase changed or the completed
+ fraction grew by at least a hundredth since the last report.
+
+ @param progress The progress.
+ */
+static void reportProgress(AKProgress *progress)
+{
+    if (progress->callback == NULL)
+    {
+        return;
+    }
+    float fraction = AKProgressFractionCompleted(progress);
+    if (progress->reportedFraction < 0.0f ||
+        progress->phase != progress->reportedPhase ||
+        fraction - progress->reportedFraction >= 0.01f ||
+        (fraction == 1.0f && progress->reportedFraction < 1.0f))
+    {
+        progress->reportedFraction = fraction;
+        progress->reportedPhase = progress->phase;
+        progress->callback(progress->context, progress->phase, fraction);
+    }
+}
+
+/**
+ Sets the amount of work of a phase, such as its number of vertices or
+ materials.
+
+ A phase without work is completed when AKProgressCompletePhase is called.
+
+ @param progress The progress, may be NULL.
+ @param phase The phase.
+ @param total The amount of work of the phase.
+ */
+void AKProgressSetPhaseTotal(AKProgress *progress,
+                             AKImportPhase phase,
+                             unsigned long total)
+{
+    if (progress != NULL)
+    {
+        progress->totals[phase] = total;
+    }
+}
+
+/**
+ Advances a phase, which becomes the current phase, and checks the import was
+ not cancelled.
+
+ @param progress The progress, may be NULL.
+ @param phase The phase.
+ @param count The amount of work completed since the last advance.
+ @return true if the import should continue, false if it was cancelled.
+ */
+bool AKProgressAdvance(AKProgress *progress,
+                       AKImportPhase phase,
+                       unsigned long count)
+{
+    if (progress == NULL)
+    {
+        return true;
+    }
+    if (!AKProgressCheckpoint(progress))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(progress->mutex);
+    progress->done[phase] += count;
+    progress->phase = phase;
+    reportProgress(progress);
+    return true;
+}
+
+/**
+ Completes the work of a phase and checks the import was not cancelled.
+
+ @param progress The progress, may be NULL.
+ @param phase The phase.
+ @return true if the import should continue, false if it was cancelled.
+ */
+bool AKProgressCompletePhase(AKProgress *progress, AKImportPhase phase)
+{
+    if (progress == NULL)
+    {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(progress->mutex);
+        progress->completed[phase] = 1;
+    }
+    return AKProgressAdvance(progress, phase, 0);
+}
+
+/**
+ Returns the current phase.
+
+ @param progress The progress.
+ @return The phase which advanced last.
+ */
+AKImportPhase AKProgressPhase(const AKProgress *progress)
+{
+    return progress->phase;
+}
+
+/**
+ Returns the completed fraction of the import.
+
+ Each phase has a fixed share of the import, parsing the largest, and its
+ completed fraction is the work done over its total.
+
+ @param progress The progress.
+ @return The completed fraction, from 0 to 1.
+ */
+float AKProgressFractionCompleted(const AKProgress *progress)
+{
+    float fraction = 0.0f;
+    for (int i = 0; i < AKImportPhaseCount; i++)
+    {
+        float phaseFraction = 0.0f;
+        if (progress->completed[i])
+        {
+            phaseFraction = 1.0f;
+        }
+        else if (progress->totals[i] > 0)
+        {
+            phaseFraction = progress->done[i] < progress->totals[i]
+                                ? (float)progress->done[i] /
+                                      (float)progress->totals[i]
+                                : 1.0f;
+        }
+        fraction += kPhaseShares[i] * phaseFraction;
+    }
+    return fraction < 1.0f ? fraction : 1.0f;
+}
+
+#pragma mark - Cancelling an import
+
+/**
+ Cancels the import, which stops at its next checkpoint.
+
+ This function may be called from any thread, more than once.
+
+ @param progress The progress.
+ */
+void AKProgressCancel(AKProgress *progress)
+{
+    long long notCancelled = 0;
+    progress->cancelTime.compare_exchange_strong(notCancelled,
+                                                 nowNanoseconds());
+}
+
+/**
+ Checks the import was not cancelled, without advancing any phase.
+
+ @param progress The progress, may be NULL.
+ @return true if the import should continue, false if it was cancelled.
+ */
+bool AKProgressCheckpoint(AKProgress *progress)
+{
+    if (progress == NULL)
+    {
+        return true;
+    }
+    long long cancelTime = progress->cancelTime.load();
+    if (cancelTime == 0)
+    {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(progress->mutex);
+    if (progress->latency < 0.0)
+    {
+        progress->latency = (nowNanoseconds() - cancelTime) * 1e-9;
+    }
+    return false;
+}
+
+/**
+ Returns whether the import was cancelled.
+
+ This function may be called from any thread.
+
+ @param progress The progress, may be NULL.
+ @return true if AKProgressCancel was called.
+ */
+bool AKProgressIsCancelled(const AKProgress *progress)
+{
+    return progress != NULL && progress->cancelTime.load() != 0;
+}
+
+/**
+ Returns the time from cancelling the import to the first checkpoint which
+ stopped it.
+
+ @param progress The progress.
+ @return The cancellation latency in seconds, or a negative value if the
+ import was not cancelled or has not reached a checkpoint since.
+ */
+double AKProgressCancellationLatency(const AKProgress *progress)
+{
+    return progress->latency;
+}
@@ -0,0 +1,217 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKProgress_h
+#define AKProgress_h
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ The progress of an import, reported in phases, and its cooperative
+ cancellation.
+
+ The import reports its progress at checkpoints, which are also where it
+ stops once the import is cancelled. Parsing and post processing are checked
+ whenever the assimp importer calls its progress handler. The conversion is
+ checked at least once per chunk of AKVertexChunkSize vertices, material,
+ texture, skinned node and animation channel, so that an import stops within
+ a bounded time after it is cancelled.
+
+ The progress may be cancelled from any thread. The progress is reported and
+ checked on the threads which run the import, which may advance it at the same
+ time when the conversion runs on several workers.
+ */
+
+#pragma mark - Import phases
+
+/**
+ The phases of an import, in the order they start.
+ */
+typedef enum AKImportPhase
+{
+    AKImportPhaseParse,
+    AKImportPhasePostProcess,
+    AKImportPhaseGeometry,
+    AKImportPhaseMaterials,
+    AKImportPhaseTextures,
+    AKImportPhaseSkin,
+    AKImportPhaseAnimations,
+    AKImportPhaseCount
+} AKImportPhase;
+
+/**
+ The function which receives the progress of an import.
+
+ The function is called on a thread which runs the import, one call at a
+ time, whenever the phase changes or the completed fraction grows by at least
+ a hundredth.
+
+ @param context The context the progress was created with.
+ @param phase The current phase.
+ @param fractionCompleted The completed fraction of the whole import, from 0
+ to 1.
+ */
+typedef void (*AKProgressCallback)(void *context,
+                                   AKImportPhase phase,
+                                   float fractionCompleted);
+
+/**
+ The progress of an import.
+ */
+typedef struct AKProgress AKProgress;
+
+#pragma mark - Creating a progress
+
+/**
+ Creates the progress of an import.
+
+ @param callback The function which receives the progress, or NULL.
+ @param context The context passed to the function.
+ @return A new progress which must be released with AKProgressRelease.
+ */
+AKProgress *AKProgressCreate(AKProgressCallback callback, void *context);
+
+/**
+ Releases the progress.
+
+ @param progress The progress, may be NULL.
+ */
+void AKProgressRelease(AKProgress *progress);
+
+#pragma mark - Reporting progress
+
+/**
+ Sets the amount of work of a phase, such as its number of vertices or
+ materials.
+
+ A phase without work is completed when AKProgressCompletePhase is called.
+
+ @param progress The progress, may be NULL.
+ @param phase The phase.
+ @param total The amount of work of the phase.
+ */
+void AKProgressSetPhaseTotal(AKProgress *progress,
+                             AKImportPhase phase,
+                             unsigned long total);
+
+/**
+ Advances a phase, which becomes the current phase, and checks the import was
+ not cancelled.
+
+ @param progress The progress, may be NULL.
+ @param phase The phase.
+ @param count The amount of work completed since the last advance.
+ @return true if the import should continue, false if it was cancelled.
+ */
+bool AKProgressAdvance(AKProgress *progress,
+                       AKImportPhase phase,
+                       unsigned long count);
+
+/**
+ Completes the work of a phase and checks the import was not cancelled.
+
+ @param progress The progress, may be NULL.
+ @param phase The phase.
+ @return true if the import should continue, false if it was cancelled.
+ */
+bool AKProgressCompletePhase(AKProgress *progress, AKImportPhase phase);
+
+/**
+ Returns the current phase.
+
+ @param progress The progress.
+ @return The phase which advanced last.
+ */
+AKImportPhase AKProgressPhase(const AKProgress *progress);
+
+/**
+ Returns the completed fraction of the import.
+
+ Each phase has a fixed share of the import, parsing the largest, and its
+ completed fraction is the work done over its total.
+
+ @param progress The progress.
+ @return The completed fraction, from 0 to 1.
+ */
+float AKProgressFractionCompleted(const AKProgress *progress);
+
+#pragma mark - Cancelling an import
+
+/**
+ Cancels the import, which stops at its next checkpoint.
+
+ This function may be called from any thread, more than once.
+
+ @param progress The progress.
+ */
+void AKProgressCancel(AKProgress *progress);
+
+/**
+ Checks the import was not cancelled, without advancing any phase.
+
+ @param progress The progress, may be NULL.
+ @return true if the import should continue, false if it was cancelled.
+ */
+bool AKProgressCheckpoint(AKProgress *progress);
+
+/**
+ Returns whether the import was cancelled.
+
+ This function may be called from any thread.
+
+ @param progress The progress, may be NULL.
+ @return true if AKProgressCancel was called.
+ */
+bool AKProgressIsCancelled(const AKProgress *progress);
+
+/**
+ Returns the time from cancelling the import to the first checkpoint which
+ stopped it.
+
+ @param progress The progress.
+ @return The cancellation latency in seconds, or a negative value if the
+ import was not cancelled or has not reached a checkpoint since.
+ */
+double AKProgressCancellationLatency(const AKProgress *progress);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKProgress_h */
@@ -0,0 +1,283 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKQuantize.h"
+#include <math.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AK_QUANTIZE_NEON 1
+#endif
+
+#pragma mark - Convert single values
+
+/**
+ Converts a float to an IEEE 754 half float, rounding to the nearest even
+ half float.
+
+ @param value The float.
+ @return The bits of the half float.
+ */
+uint16_t AKFloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    uint32_t magnitude = bits & 0x7fffffff;
+    if (magnitude >= 0x7f800000)
+    {
+        // infinity stays infinity, and nan stays a quiet nan
+        return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x0200 : 0);
+    }
+    if (magnitude >= 0x477ff000)
+    {
+        // 65520 and above round to infinity
+        return sign | 0x7c00;
+    }
+    if (magnitude < 0x38800000)
+    {
+        // below the smallest normal half, in steps of 2^-24
+        float absolute;
+        memcpy(&absolute, &magnitude, sizeof(absolute));
+        return sign | (uint16_t)lrintf(absolute * 16777216.0f);
+    }
+    uint32_t half = ((magnitude >> 23) - 112) << 10 | (magnitude >> 13 & 0x3ff);
+    uint32_t remainder = magnitude & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+    {
+        half++;
+    }
+    return sign | (uint16_t)half;
+}
+
+/**
+ Converts an IEEE 754 half float to a float.
+
+ @param half The bits of the half float.
+ @return The float.
+ */
+float AKHalfToFloat(uint16_t half)
+{
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    if (exponent == 0)
+    {
+        float value = ldexpf((float)mantissa, -24);
+        return sign ? -value : value;
+    }
+    uint32_t bits = exponent == 0x1f
+                        ? sign | 0x7f800000 | mantissa << 13
+                        : sign | (exponent + 112) << 23 | mantissa << 13;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ Encodes a unit vector as the two coordinates of its octahedral projection.
+
+ @param vector The unit vector, 3 floats.
+ @param oct The octahedral coordinates in [-1, 1], 2 floats.
+ */
+void AKOctEncode(const float *vector, float *oct)
+{
+    float norm = fabsf(vector[0]) + fabsf(vector[1]) + fabsf(vector[2]);
+    if (norm == 0.0f)
+    {
+        oct[0] = 0.0f;
+        oct[1] = 0.0f;
+        return;
+    }
+    float x = vector[0] / norm;
+    float y = vector[1] / norm;
+    if (vector[2] < 0.0f)
+    {
+        // fold the lower hemisphere over the diagonals
+        float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+    oct[0] = x;
+    oct[1] = y;
+}
+
+/**
+ Decodes the octahedral coordinates of a unit vector.
+
+ @param oct The octahedral coordinates in [-1, 1], 2 floats.
+ @param vector The unit vector, 3 floats.
+ */
+void AKOctDecode(const float *oct, float *vector)
+{
+    float x = oct[0];
+    float y = oct[1];
+    float z = 1.0f - fabsf(x) - fabsf(y);
+    if (z < 0.0f)
+    {
+        float unfoldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float unfoldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = unfoldedX;
+        y = unfoldedY;
+    }
+    float length = sqrtf(x * x + y * y + z * z);
+    vector[0] = x / length;
+    vector[1] = y / length;
+    vector[2] = z / length;
+}
+
+#pragma mark - Quantize arrays
+
+/**
+ Converts an array of floats to half floats.
+
+ @param src The floats.
+ @param n The number of floats.
+ @param dst The half floats.
+ */
+void AKQuantizeHalf(const float *src, size_t n, uint16_t *dst)
+{
+    size_t i = 0;
+#if defined(__F16C__)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i halfs =
+            _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storel_epi64((__m128i *)(dst + i), halfs);
+    }
+#elif defined(AK_QUANTIZE_NEON)
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1_u16(dst + i,
+                 vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        dst[i] = AKFloatToHalf(src[i]);
+    }
+}
+
+/**
+ Converts an array of floats in [-1, 1] to signed normalized 16 bit integers,
+ clamping the floats to that range and rounding to the nearest integer.
+
+ @param src The floats.
+ @param n The number of floats.
+ @param dst The signed normalized integers.
+ */
+void AKQuantizeSNorm16(const float *src, size_t n, int16_t *dst)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 lower = _mm_set1_ps(-1.0f);
+    const __m128 upper = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), lower), upper);
+        __m128 b =
+            _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), lower), upper);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)),
+                                         _mm_cvtps_epi32(_mm_mul_ps(b, scale)));
+        _mm_storeu_si128((__m128i *)(dst + i), packed);
+    }
+#elif defined(AK_QUANTIZE_NEON)
+    const float32x4_t lower = vdupq_n_f32(-1.0f);
+    const float32x4_t upper = vdupq_n_f32(1.0f);
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4_t v = vminq_f32(vmaxq_f32(vld1q_f32(src + i), lower), upper);
+        vst1_s16(dst + i,
+                 vqmovn_s32(vcvtnq_s32_f32(vmulq_n_f32(v, 32767.0f))));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        float v = src[i] < -1.0f ? -1.0f : (src[i] > 1.0f ? 1.0f : src[i]);
+        dst[i] = (int16_t)lrintf(v * 32767.0f);
+    }
+}
+
+/**
+ Converts an array of floats in [0, 1] to unsigned normalized 8 bit integers,
+ clamping the floats to that range and rounding to the nearest integer.
+
+ @param src The floats.
+ @param n The number of floats.
+ @param dst The unsigned normalized integers.
+ */
+void AKQuantizeUNorm8(const float *src, size_t n, uint8_t *dst)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 lower = _mm_setzero_ps();
+    const __m128 upper = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), lower), upper);
+        __m128 b =
+            _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), lower), upper);
+        __m128i words = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)),
+                                        _mm_cvtps_epi32(_mm_mul_ps(b, scale)));
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_packus_epi16(words, words));
+    }
+#elif defined(AK_QUANTIZE_NEON)
+    const float32x4_t lower = vdupq_n_f32(0.0f);
+    const float32x4_t upper = vdupq_n_f32(1.0f);
+    for (; i + 8 <= n; i += 8)
+    {
+        float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(src + i), lower), upper);
+        float32x4_t b =
+            vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), lower), upper);
+        uint16x8_t words =
+            vcombine_u16(vqmovn_u32(vcvtnq_u32_f32(vmulq_n_f32(a, 255.0f))),
+                         vqmovn_u32(vcvtnq_u32_f32(vmulq_n_f32(b, 255.0f))));
+        vst1_u8(dst + i, vqmovn_u16(words));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        float v = src[i] < 0.0f ? 0.0f : (src[i] > 1.0f ? 1.0f : src[i]);
+        dst[i] = (uint8_t)lrintf(v * 255.0f);
+    }
+}
@@ -0,0 +1,119 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKQuantize_h
+#define AKQuantize_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Convert single values
+
+/**
+ Converts a float to an IEEE 754 half float, rounding to the nearest even
+ half float.
+
+ @param value The float.
+ @return The bits of the half float.
+ */
+uint16_t AKFloatToHalf(float value);
+
+/**
+ Converts an IEEE 754 half float to a float.
+
+ @param half The bits of the half float.
+ @return The float.
+ */
+float AKHalfToFloat(uint16_t half);
+
+/**
+ Encodes a unit vector as the two coordinates of its octahedral projection.
+
+ @param vector The unit vector, 3 floats.
+ @param oct The octahedral coordinates in [-1, 1], 2 floats.
+ */
+void AKOctEncode(const float *vector, float *oct);
+
+/**
+ Decodes the octahedral coordinates of a unit vector.
+
+ @param oct The octahedral coordinates in [-1, 1], 2 floats.
+ @param vector The unit vector, 3 floats.
+ */
+void AKOctDecode(const float *oct, float *vector);
+
+#pragma mark - Quantize arrays
+
+/**
+ Converts an array of floats to half floats.
+
+ Uses the F16C or NEON conversion instructions when the core is built for
+ them, which round the same way as AKFloatToHalf.
+
+ @param src The floats.
+ @param n The number of floats.
+ @param dst The half floats.
+ */
+void AKQuantizeHalf(const float *src, size_t n, uint16_t *dst);
+
+/**
+ Converts an array of floats in [-1, 1] to signed normalized 16 bit integers,
+ clamping the floats to that range and rounding to the nearest integer.
+
+ @param src The floats.
+ @param n The number of floats.
+ @param dst The signed normalized integers.
+ */
+void AKQuantizeSNorm16(const float *src, size_t n, int16_t *dst);
+
+/**
+ Converts an array of floats in [0, 1] to unsigned normalized 8 bit integers,
+ clamping the floats to that range and rounding to the nearest integer.
+
+ @param src The floats.
+ @param n The number of floats.
+ @param dst The unsigned normalized integers.
+ */
+void AKQuantizeUNorm8(const float *src, size_t n, uint8_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKQuantize_h */
@@ -0,0 +1,1856 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSceneArchive.h"
+#include "AKMemory.h"
+#include "AKSceneCache.h"
+#include <fcntl.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static_assert(sizeof(AKArchiveHeader) % 8 == 0, "header is 8 byte aligned");
+static_assert(sizeof(AKArchiveNode) % 8 == 0, "node is 8 byte aligned");
+static_assert(sizeof(AKArchiveMaterial) % 8 == 0,
+              "material is 8 byte aligned");
+static_assert(sizeof(AKArchiveTexture) % 8 == 0, "texture is 8 byte aligned");
+static_assert(sizeof(AKArchiveGeometry) % 8 == 0,
+              "geometry is 8 byte aligned");
+static_assert(sizeof(AKArchiveElement) % 8 == 0, "element is 8 byte aligned");
+static_assert(sizeof(AKArchiveSkin) % 8 == 0, "skin is 8 byte aligned");
+static_assert(sizeof(AKArchiveCamera) % 8 == 0, "camera is 8 byte aligned");
+static_assert(sizeof(AKArchiveBone) % 8 == 0, "bone is 8 byte aligned");
+static_assert(sizeof(AKArchiveAnimation) % 8 == 0,
+              "animation is 8 byte aligned");
+static_assert(sizeof(AKArchiveChannel) % 8 == 0, "channel is 8 byte aligned");
+static_assert(sizeof(AKArchiveDependency) % 8 == 0,
+              "dependency is 8 byte aligned");
+
+/**
+ The bytes at the start of a scene archive.
+ */
+static const char AKArchiveMagic[8] = {'A', 'K', 'S', 'C', 'E', 'N', 'E', 0};
+
+/**
+ Rounds a size up to a multiple of 8 bytes.
+
+ @param size The size.
+ @return The aligned size.
+ */
+static uint64_t align8(uint64_t size)
+{
+    return (size + 7) & ~(uint64_t)7;
+}
+
+#pragma mark - Scene archive writer
+
+/**
+ An embedded texture added to a writer.
+ */
+struct AKWriterTexture
+{
+    /**
+     Determines if the texture is set.
+     */
+    bool isSet;
+
+    /**
+     The file format hint, in the string pool.
+     */
+    uint32_t formatHint;
+
+    /**
+     The offset of the texture bytes in the blob.
+     */
+    uint64_t data;
+
+    /**
+     The number of bytes.
+     */
+    uint64_t nBytes;
+};
+
+/**
+ The parts of a converted scene, with the offsets of their buffers from the
+ start of the blob, which follows the header in the file.
+ */
+struct AKSceneArchiveWriter
+{
+    /**
+     The key of the converted scene.
+     */
+    uint64_t key;
+
+    /**
+     The vertex, index, weight, keyframe and texture bytes.
+     */
+    std::vector<unsigned char> blob;
+
+    /**
+     The nodes.
+     */
+    std::vector<AKArchiveNode> nodes;
+
+    /**
+     The mesh indices of the nodes.
+     */
+    std::vector<uint32_t> nodeMeshes;
+
+    /**
+     The material of each mesh.
+     */
+    std::vector<uint32_t> meshMaterials;
+
+    /**
+     The materials.
+     */
+    std::vector<AKArchiveMaterial> materials;
+
+    /**
+     Determines if each material is set.
+     */
+    std::vector<bool> materialSet;
+
+    /**
+     The embedded textures.
+     */
+    std::vector<AKWriterTexture> textures;
+
+    /**
+     The node geometries.
+     */
+    std::vector<AKArchiveGeometry> geometries;
+
+    /**
+     The geometry elements of the node geometries.
+     */
+    std::vector<AKArchiveElement> elements;
+
+    /**
+     The node skins.
+     */
+    std::vector<AKArchiveSkin> skins;
+
+    /**
+     The cameras.
+     */
+    std::vector<AKArchiveCamera> cameras;
+
+    /**
+     The bones.
+     */
+    std::vector<AKArchiveBone> bones;
+
+    /**
+     The animations.
+     */
+    std::vector<AKArchiveAnimation> animations;
+
+    /**
+     The channels of the animations.
+     */
+    std::vector<AKArchiveChannel> channels;
+
+    /**
+     The files the scene was read from.
+     */
+    std::vector<AKArchiveDependency> dependencies;
+
+    /**
+     The root node of the skeleton.
+     */
+    uint32_t skeletonNode;
+
+    /**
+     The string pool, which starts with the empty string.
+     */
+    std::string strings;
+
+    /**
+     The offset of each string in the pool.
+     */
+    std::map<std::string, uint32_t> stringOffsets;
+};
+
+/**
+ Adds a string to the string pool of a writer, once.
+
+ @param writer The writer.
+ @param string The string, or NULL for the empty string.
+ @return The offset of the string in the pool.
+ */
+static uint32_t addString(AKSceneArchiveWriter *writer, const char *string)
+{
+    if (string == NULL || string[0] == 0)
+    {
+        return 0;
+    }
+    std::map<std::string, uint32_t>::iterator found =
+        writer->stringOffsets.find(string);
+    if (found != writer->stringOffsets.end())
+    {
+        return found->second;
+    }
+    uint32_t offset = (uint32_t)writer->strings.size();
+    writer->strings.append(string);
+    writer->strings.push_back(0);
+    writer->stringOffsets[string] = offset;
+    return offset;
+}
+
+/**
+ Appends bytes to the blob of a writer, at a multiple of 8 bytes.
+
+ @param writer The writer.
+ @param bytes The bytes.
+ @param nBytes The number of bytes.
+ @return The offset of the bytes from the start of the blob.
+ */
+static uint64_t addBytes(AKSceneArchiveWriter *writer,
+                         const void *bytes,
+                         size_t nBytes)
+{
+    uint64_t offset = align8(writer->blob.size());
+    writer->blob.resize(offset + nBytes);
+    if (nBytes > 0)
+    {
+        memcpy(&writer->blob[offset], bytes, nBytes);
+    }
+    return offset;
+}
+
+/**
+ Appends the keyframes of a track to the blob of a writer.
+
+ @param writer The writer.
+ @param track The keyframe track.
+ @param archiveTrack Set to the keyframe track record.
+ */
+static void addTrack(AKSceneArchiveWriter *writer,
+                     const AKKeyframeTrack *track,
+                     AKArchiveTrack *archiveTrack)
+{
+    archiveTrack->nKeys = track->nKeys;
+    archiveTrack->nComponents = track->nComponents;
+    archiveTrack->keyTimes =
+        addBytes(writer, track->keyTimes, track->nKeys * sizeof(float));
+    archiveTrack->values =
+        addBytes(writer, track->values,
+                 (size_t)track->nKeys * track->nComponents * sizeof(float));
+}
+
+/**
+ Creates an empty scene archive writer.
+
+ @param key The key of the converted scene, stored in the header.
+ @return The new writer which must be released with
+ AKSceneArchiveWriterRelease.
+ */
+AKSceneArchiveWriter *AKSceneArchiveWriterCreate(unsigned long long key)
+{
+    AKSceneArchiveWriter *writer = new AKSceneArchiveWriter();
+    writer->key = key;
+    writer->skeletonNode = AKArchiveNone;
+    writer->strings.push_back(0);
+    return writer;
+}
+
+/**
+ Releases the writer.
+
+ @param writer The writer, may be NULL.
+ */
+void AKSceneArchiveWriterRelease(AKSceneArchiveWriter *writer)
+{
+    delete writer;
+}
+
+/**
+ Adds a node after the nodes added before, which must include its parent.
+
+ @param writer The writer.
+ @param name The name of the node.
+ @param parent The parent node, or AKArchiveNone for the root node.
+ @param transform The transform of the node, the scenekit matrix components
+ m11, m12 ... m44.
+ @param meshes The indices of the meshes of the node.
+ @param nMeshes The number of meshes of the node.
+ @return The index of the node.
+ */
+unsigned int AKSceneArchiveWriterAddNode(AKSceneArchiveWriter *writer,
+                                         const char *name,
+                                         unsigned int parent,
+                                         const float *transform,
+                                         const unsigned int *meshes,
+                                         unsigned int nMeshes)
+{
+    AKArchiveNode node;
+    memset(&node, 0, sizeof(node));
+    node.name = addString(writer, name);
+    node.parent = parent;
+    node.firstMesh = (uint32_t)writer->nodeMeshes.size();
+    node.nMeshes = nMeshes;
+    node.geometry = AKArchiveNone;
+    node.camera = AKArchiveNone;
+    memcpy(node.transform, transform, sizeof(node.transform));
+    writer->nodeMeshes.insert(writer->nodeMeshes.end(), meshes,
+                              meshes + nMeshes);
+    writer->nodes.push_back(node);
+    return (unsigned int)writer->nodes.size() - 1;
+}
+
+/**
+ Copies the vertices and the elements of the geometry of a node.
+
+ @param writer The writer.
+ @param node The node.
+ @param geometry The node geometry, before its buffers are handed off.
+ */
+void AKSceneArchiveWriterSetGeometry(AKSceneArchiveWriter *writer,
+                                     unsigned int node,
+                                     const AKNodeGeometry *geometry)
+{
+    AKArchiveGeometry record;
+    memset(&record, 0, sizeof(record));
+    record.nVertices = geometry->nVertices;
+    record.vertexStride = geometry->vertexStride;
+    for (int a = 0; a < AKVertexAttributeCount; a++)
+    {
+        const AKVertexAttributeView *view = &geometry->attributes[a];
+        record.attributes[a].format = view->format;
+        record.attributes[a].nComponents = view->nComponents;
+        record.attributes[a].bytesPerComponent = view->bytesPerComponent;
+        record.attributes[a].offset = view->offset;
+    }
+    memcpy(record.positionScale, geometry->positionScale,
+           sizeof(record.positionScale));
+    memcpy(record.positionOffset, geometry->positionOffset,
+           sizeof(record.positionOffset));
+    record.maxPositionError = geometry->quantization.maxPositionError;
+    record.maxNormalAngleError = geometry->quantization.maxNormalAngleError;
+    record.maxTangentAngleError = geometry->quantization.maxTangentAngleError;
+    record.maxTexCoordError = geometry->quantization.maxTexCoordError;
+    record.bytesSaved = geometry->quantization.bytesSaved;
+    record.firstElement = (uint32_t)writer->elements.size();
+    record.nElements = geometry->nElements;
+    record.skin = AKArchiveNone;
+    record.vertexData =
+        addBytes(writer, geometry->vertexData,
+                 (size_t)geometry->nVertices * geometry->vertexStride);
+    for (unsigned int i = 0; i < geometry->nElements; i++)
+    {
+        const AKGeometryElement *element = &geometry->elements[i];
+        AKArchiveElement archiveElement;
+        archiveElement.meshIndex = element->meshIndex;
+        archiveElement.nPrimitives = element->nPrimitives;
+        archiveElement.nIndices = element->nIndices;
+        archiveElement.bytesPerIndex = element->bytesPerIndex;
+        archiveElement.indices =
+            addBytes(writer, element->indices,
+                     (size_t)element->nIndices * element->bytesPerIndex);
+        writer->elements.push_back(archiveElement);
+    }
+    writer->nodes[node].geometry = (uint32_t)writer->geometries.size();
+    writer->geometries.push_back(record);
+}
+
+/**
+ Copies the bone weights and indices of the skin of the geometry of a node.
+
+ @param writer The writer.
+ @param node The node, whose geometry is set.
+ @param skin The node skin, before its buffers are handed off.
+ */
+void AKSceneArchiveWriterSetSkin(AKSceneArchiveWriter *writer,
+                                 unsigned int node,
+                                 const AKNodeSkin *skin)
+{
+    uint32_t geometry = writer->nodes[node].geometry;
+    if (geometry == AKArchiveNone)
+    {
+        return;
+    }
+    size_t nWeights = (size_t)skin->nVertices * skin->maxWeights;
+    AKArchiveSkin record;
+    record.nVertices = skin->nVertices;
+    record.maxWeights = skin->maxWeights;
+    record.boneWeights =
+        addBytes(writer, skin->boneWeights, nWeights * sizeof(float));
+    record.boneIndices =
+        addBytes(writer, skin->boneIndices, nWeights * sizeof(short));
+    writer->geometries[geometry].skin = (uint32_t)writer->skins.size();
+    writer->skins.push_back(record);
+}
+
+/**
+ Sets the camera of a node.
+
+ @param writer The writer.
+ @param node The node.
+ @param xFov The horizontal field of view, in radians.
+ @param zNear The distance of the near clipping plane.
+ @param zFar The distance of the far clipping plane.
+ */
+void AKSceneArchiveWriterSetCamera(AKSceneArchiveWriter *writer,
+                                   unsigned int node,
+                                   float xFov,
+                                   float zNear,
+                                   float zFar)
+{
+    AKArchiveCamera camera = {xFov, zNear, zFar, 0};
+    writer->nodes[node].camera = (uint32_t)writer->cameras.size();
+    writer->cameras.push_back(camera);
+}
+
+/**
+ Sets the material of a mesh.
+
+ @param writer The writer.
+ @param mesh The index of the mesh.
+ @param material The index of the material.
+ */
+void AKSceneArchiveWriterSetMeshMaterial(AKSceneArchiveWriter *writer,
+                                         unsigned int mesh,
+                                         unsigned int material)
+{
+    if (mesh >= writer->meshMaterials.size())
+    {
+        writer->meshMaterials.resize(mesh + 1, AKArchiveNone);
+    }
+    writer->meshMaterials[mesh] = material;
+}
+
+/**
+ Determines if a material is set.
+
+ @param writer The writer.
+ @param material The index of the material.
+ @return Non zero if the material is set.
+ */
+int AKSceneArchiveWriterHasMaterial(const AKSceneArchiveWriter *writer,
+                                    unsigned int material)
+{
+    return material < writer->materialSet.size() &&
+           writer->materialSet[material];
+}
+
+/**
+ Sets a material without properties, replacing the material at the index.
+
+ @param writer The writer.
+ @param material The index of the material.
+ @param name The name of the material.
+ @param blendMode The assimp blend mode of the material.
+ @param multiply The rgba multiply color, or NULL if the material has none.
+ */
+void AKSceneArchiveWriterSetMaterial(AKSceneArchiveWriter *writer,
+                                     unsigned int material,
+                                     const char *name,
+                                     unsigned int blendMode,
+                                     const float *multiply)
+{
+    if (material >= writer->materials.size())
+    {
+        AKArchiveMaterial empty;
+        memset(&empty, 0, sizeof(empty));
+        writer->materials.resize(material + 1, empty);
+        writer->materialSet.resize(material + 1, false);
+    }
+    AKArchiveMaterial *record = &writer->materials[material];
+    memset(record, 0, sizeof(*record));
+    record->name = addString(writer, name);
+    record->blendMode = blendMode;
+    if (multiply != NULL)
+    {
+        record->hasMultiply = 1;
+        memcpy(record->multiply, multiply, sizeof(record->multiply));
+    }
+    writer->materialSet[material] = true;
+}
+
+/**
+ Adds a property to a material, unless the material has
+ AKArchiveMaxMaterialSlots properties already.
+
+ @param writer The writer.
+ @param material The index of the material, which is set.
+ @param textureType The assimp texture type of the property.
+ @param kind What the property shows.
+ @param color The rgba color of the property, or NULL if it has none.
+ @param texture The index of the embedded texture, if the property shows
+ one.
+ @param texturePath The path of the texture file relative to the directory
+ of the scene file, if the property shows one, else NULL.
+ */
+void AKSceneArchiveWriterAddMaterialSlot(AKSceneArchiveWriter *writer,
+                                         unsigned int material,
+                                         unsigned int textureType,
+                                         AKMaterialSlotKind kind,
+                                         const float *color,
+                                         unsigned int texture,
+                                         const char *texturePath)
+{
+    AKArchiveMaterial *record = &writer->materials[material];
+    if (record->nSlots == AKArchiveMaxMaterialSlots)
+    {
+        return;
+    }
+    AKArchiveMaterialSlot *slot = &record->slots[record->nSlots++];
+    slot->textureType = textureType;
+    slot->kind = kind;
+    slot->texture = kind == AKMaterialSlotExternalTexture
+                        ? addString(writer, texturePath)
+                        : texture;
+    if (color != NULL)
+    {
+        slot->hasColor = 1;
+        memcpy(slot->color, color, sizeof(slot->color));
+    }
+}
+
+/**
+ Copies an embedded texture, unless the texture at the index is set.
+
+ @param writer The writer.
+ @param texture The index of the texture.
+ @param bytes The bytes of the texture in its compressed file format.
+ @param nBytes The number of bytes.
+ @param formatHint The file format hint, such as png.
+ */
+void AKSceneArchiveWriterSetTexture(AKSceneArchiveWriter *writer,
+                                    unsigned int texture,
+                                    const void *bytes,
+                                    size_t nBytes,
+                                    const char *formatHint)
+{
+    if (texture >= writer->textures.size())
+    {
+        AKWriterTexture empty = {false, 0, 0, 0};
+        writer->textures.resize(texture + 1, empty);
+    }
+    AKWriterTexture *record = &writer->textures[texture];
+    if (record->isSet)
+    {
+        return;
+    }
+    record->isSet = true;
+    record->formatHint = addString(writer, formatHint);
+    record->data = addBytes(writer, bytes, nBytes);
+    record->nBytes = nBytes;
+}
+
+/**
+ Adds a bone after the bones added before.
+
+ @param writer The writer.
+ @param name The name of the bone node.
+ @param inverseBindTransform The inverse bind transform of the bone, the
+ scenekit matrix components m11, m12 ... m44.
+ */
+void AKSceneArchiveWriterAddBone(AKSceneArchiveWriter *writer,
+                                 const char *name,
+                                 const float *inverseBindTransform)
+{
+    AKArchiveBone bone;
+    bone.name = addString(writer, name);
+    bone.reserved = 0;
+    memcpy(bone.inverseBindTransform, inverseBindTransform,
+           sizeof(bone.inverseBindTransform));
+    writer->bones.push_back(bone);
+}
+
+/**
+ Sets the root node of the skeleton.
+
+ @param writer The writer.
+ @param node The node, or AKArchiveNone if the skeleton is the root of the
+ scene.
+ */
+void AKSceneArchiveWriterSetSkeleton(AKSceneArchiveWriter *writer,
+                                     unsigned int node)
+{
+    writer->skeletonNode = node;
+}
+
+/**
+ Copies the keyframe tracks of an animation after the animations added
+ before.
+
+ @param writer The writer.
+ @param tracks The animation tracks.
+ */
+void AKSceneArchiveWriterAddAnimation(AKSceneArchiveWriter *writer,
+                                      const AKAnimationTracks *tracks)
+{
+    AKArchiveAnimation animation;
+    animation.duration = tracks->duration;
+    animation.firstChannel = (uint32_t)writer->channels.size();
+    animation.nChannels = tracks->nChannels;
+    animation.reserved = 0;
+    for (unsigned int j = 0; j < tracks->nChannels; j++)
+    {
+        const AKChannelTracks *channel = &tracks->channels[j];
+        AKArchiveChannel record;
+        memset(&record, 0, sizeof(record));
+        record.nodeName = addString(writer, channel->nodeName);
+        addTrack(writer, &channel->position, &record.position);
+        addTrack(writer, &channel->orientation, &record.orientation);
+        addTrack(writer, &channel->scale, &record.scale);
+        writer->channels.push_back(record);
+    }
+    writer->animations.push_back(animation);
+}
+
+/**
+ Reads the size and the hash of the bytes of a file.
+
+ @param path The path of the file.
+ @param dependency Set to the size and the hash of the file, and to if it
+ exists.
+ */
+static void hashDependency(const char *path, AKArchiveDependency *dependency)
+{
+    struct stat info;
+    unsigned long long hash = AKSceneCacheKeyMake();
+    dependency->exists = stat(path, &info) == 0 && S_ISREG(info.st_mode) &&
+                         AKSceneCacheKeyAddFile(&hash, path);
+    dependency->nBytes = dependency->exists ? (uint64_t)info.st_size : 0;
+    dependency->hash = dependency->exists ? hash : 0;
+}
+
+/**
+ Adds a file which the scene was read from, with the size and the hash of its
+ current bytes, or as a missing file if it cannot be read.
+
+ @param writer The writer.
+ @param path The path of the file.
+ */
+void AKSceneArchiveWriterAddDependency(AKSceneArchiveWriter *writer,
+                                       const char *path)
+{
+    AKArchiveDependency dependency;
+    dependency.path = addString(writer, path);
+    hashDependency(path, &dependency);
+    writer->dependencies.push_back(dependency);
+}
+
+/**
+ Writes a table of records, padded to a multiple of 8 bytes.
+
+ @param table The records.
+ @param file The file.
+ @param offset The offset in the file, advanced past the table.
+ @return The offset of the table.
+ */
+template <typename T>
+static uint64_t writeTable(const std::vector<T> &table,
+                           FILE *file,
+                           uint64_t *offset)
+{
+    static const unsigned char padding[8] = {0};
+    uint64_t tableOffset = *offset;
+    size_t nBytes = table.size() * sizeof(T);
+    if (nBytes > 0)
+    {
+        fwrite(&table[0], 1, nBytes, file);
+    }
+    size_t nPadding = (size_t)(align8(nBytes) - nBytes);
+    fwrite(padding, 1, nPadding, file);
+    *offset += nBytes + nPadding;
+    return tableOffset;
+}
+
+/**
+ Moves a blob offset to its offset in the file.
+
+ @param offset The offset from the start of the blob.
+ @param base The offset of the blob in the file.
+ */
+static void relocate(uint64_t *offset, uint64_t base)
+{
+    *offset += base;
+}
+
+/**
+ Writes the archive to a file.
+
+ The buffer offsets of the records are moved from the blob to the file as the
+ tables are written, so that the writer can keep adding parts after it.
+
+ @param writer The writer.
+ @param path The path of the file, which is replaced.
+ @return The size of the file in bytes, or 0 if it could not be written.
+ */
+size_t AKSceneArchiveWriterWriteFile(const AKSceneArchiveWriter *writer,
+                                     const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return 0;
+    }
+    uint64_t base = sizeof(AKArchiveHeader);
+
+    std::vector<AKArchiveTexture> textures(writer->textures.size());
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        const AKWriterTexture *texture = &writer->textures[i];
+        textures[i].formatHint = texture->formatHint;
+        textures[i].reserved = 0;
+        textures[i].nBytes = texture->isSet ? texture->nBytes : 0;
+        textures[i].data = texture->isSet ? texture->data + base : 0;
+    }
+    std::vector<AKArchiveGeometry> geometries(writer->geometries);
+    for (size_t i = 0; i < geometries.size(); i++)
+    {
+        relocate(&geometries[i].vertexData, base);
+    }
+    std::vector<AKArchiveElement> elements(writer->elements);
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        relocate(&elements[i].indices, base);
+    }
+    std::vector<AKArchiveSkin> skins(writer->skins);
+    for (size_t i = 0; i < skins.size(); i++)
+    {
+        relocate(&skins[i].boneWeights, base);
+        relocate(&skins[i].boneIndices, base);
+    }
+    std::vector<AKArchiveChannel> channels(writer->channels);
+    for (size_t i = 0; i < channels.size(); i++)
+    {
+        AKArchiveTrack *tracks[3] = {&channels[i].position,
+                                     &channels[i].orientation,
+                                     &channels[i].scale};
+        for (int t = 0; t < 3; t++)
+        {
+            relocate(&tracks[t]->keyTimes, base);
+            relocate(&tracks[t]->values, base);
+        }
+    }
+    std::vector<uint32_t> meshMaterials(writer->meshMaterials);
+    for (size_t i = 0; i < meshMaterials.size(); i++)
+    {
+        if (meshMaterials[i] != AKArchiveNone &&
+            !AKSceneArchiveWriterHasMaterial(writer, meshMaterials[i]))
+        {
+            meshMaterials[i] = AKArchiveNone;
+        }
+    }
+
+    AKArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+    fwrite(&header, 1, sizeof(header), file);
+    uint64_t offset = base;
+    writeTable(writer->blob, file, &offset);
+    header.nodes = writeTable(writer->nodes, file, &offset);
+    header.nodeMeshes = writeTable(writer->nodeMeshes, file, &offset);
+    header.meshMaterials = writeTable(meshMaterials, file, &offset);
+    header.materials = writeTable(writer->materials, file, &offset);
+    header.textures = writeTable(textures, file, &offset);
+    header.geometries = writeTable(geometries, file, &offset);
+    header.elements = writeTable(elements, file, &offset);
+    header.skins = writeTable(skins, file, &offset);
+    header.cameras = writeTable(writer->cameras, file, &offset);
+    header.bones = writeTable(writer->bones, file, &offset);
+    header.animations = writeTable(writer->animations, file, &offset);
+    header.channels = writeTable(channels, file, &offset);
+    header.dependencies = writeTable(writer->dependencies, file, &offset);
+    header.strings = offset;
+    header.stringBytes = writer->strings.size();
+    fwrite(writer->strings.data(), 1, writer->strings.size(), file);
+    offset += writer->strings.size();
+
+    memcpy(header.magic, AKArchiveMagic, sizeof(header.magic));
+    header.version = AK_SCENE_ARCHIVE_VERSION;
+    header.headerBytes = sizeof(AKArchiveHeader);
+    header.fileBytes = offset;
+    header.key = writer->key;
+    header.nNodes = (uint32_t)writer->nodes.size();
+    header.nNodeMeshes = (uint32_t)writer->nodeMeshes.size();
+    header.nMeshes = (uint32_t)meshMaterials.size();
+    header.nMaterials = (uint32_t)writer->materials.size();
+    header.nTextures = (uint32_t)textures.size();
+    header.nGeometries = (uint32_t)geometries.size();
+    header.nElements = (uint32_t)elements.size();
+    header.nSkins = (uint32_t)skins.size();
+    header.nCameras = (uint32_t)writer->cameras.size();
+    header.nBones = (uint32_t)writer->bones.size();
+    header.nAnimations = (uint32_t)writer->animations.size();
+    header.nChannels = (uint32_t)channels.size();
+    header.nDependencies = (uint32_t)writer->dependencies.size();
+    header.skeletonNode = writer->skeletonNode;
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, 1, sizeof(header), file);
+
+    bool failed = ferror(file) != 0;
+    if (fclose(file) != 0 || failed)
+    {
+        remove(path);
+        return 0;
+    }
+    return (size_t)offset;
+}
+
+#pragma mark - Scene archive
+
+/**
+ A mapped scene archive file.
+ */
+struct AKSceneArchive
+{
+    /**
+     The mapped file, which starts with the header.
+     */
+    const unsigned char *bytes;
+
+    /**
+     The size of the file in bytes.
+     */
+    size_t size;
+};
+
+/**
+ Determines if a range of bytes is inside the file.
+
+ @param header The header of the file.
+ @param offset The offset of the range.
+ @param nBytes The size of the range.
+ @return true if the range is inside the file.
+ */
+static bool inFile(const AKArchiveHeader *header,
+                   uint64_t offset,
+                   uint64_t nBytes)
+{
+    return offset <= header->fileBytes && nBytes <= header->fileBytes - offset;
+}
+
+/**
+ Determines if a table of records is inside the file and aligned.
+
+ @param header The header of the file.
+ @param offset The offset of the table.
+ @param count The number of records.
+ @param recordBytes The size of each record.
+ @return true if the table is inside the file.
+ */
+static bool validTable(const AKArchiveHeader *header,
+                       uint64_t offset,
+                       uint32_t count,
+                       size_t recordBytes)
+{
+    return offset % 8 == 0 &&
+           inFile(header, offset, (uint64_t)count * recordBytes);
+}
+
+/**
+ Determines if a keyframe track is inside the file.
+
+ @param header The header of the file.
+ @param track The keyframe track.
+ @return true if the track is inside the file.
+ */
+static bool validTrack(const AKArchiveHeader *header,
+                       const AKArchiveTrack *track)
+{
+    return inFile(header, track->keyTimes,
+                  (uint64_t)track->nKeys * sizeof(float)) &&
+           inFile(header, track->values, (uint64_t)track->nKeys *
+                                             track->nComponents *
+                                             sizeof(float));
+}
+
+/**
+ Determines if a vertex attribute of a node geometry is of a known format,
+ with the component size of its format, and lies inside a vertex.
+
+ @param attribute The vertex attribute.
+ @param vertexStride The number of bytes of a vertex.
+ @return true if the attribute is valid.
+ */
+static bool validAttribute(const AKArchiveAttribute *attribute,
+                           uint32_t vertexStride)
+{
+    uint32_t bytesPerComponent = 0;
+    switch (attribute->format)
+    {
+    case AKVertexFormatNone:
+        return true;
+    case AKVertexFormatFloat:
+        bytesPerComponent = sizeof(float);
+        break;
+    case AKVertexFormatHalf:
+    case AKVertexFormatSNorm16:
+    case AKVertexFormatOctSNorm16:
+        bytesPerComponent = sizeof(uint16_t);
+        break;
+    case AKVertexFormatUNorm8:
+        bytesPerComponent = sizeof(uint8_t);
+        break;
+    default:
+        return false;
+    }
+    return attribute->bytesPerComponent == bytesPerComponent &&
+           attribute->nComponents >= 1 && attribute->nComponents <= 4 &&
+           (uint64_t)attribute->offset +
+                   attribute->nComponents * attribute->bytesPerComponent <=
+               vertexStride;
+}
+
+/**
+ Determines if every index of a geometry element is a vertex of its geometry.
+
+ @param indices The indices.
+ @param nIndices The number of indices.
+ @param nVertices The number of vertices of the geometry.
+ @return true if every index is less than the number of vertices.
+ */
+template <typename T>
+static bool validIndices(const T *indices,
+                         uint32_t nIndices,
+                         uint32_t nVertices)
+{
+    for (uint32_t i = 0; i < nIndices; i++)
+    {
+        if (indices[i] >= nVertices)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ Determines if a geometry element has indices of a valid width for its
+ triangles, inside the file and each a vertex of its geometry, or no
+ indices.
+
+ @param bytes The mapped file.
+ @param element The geometry element.
+ @param geometry The geometry of the element.
+ @return true if the element is valid.
+ */
+static bool validElement(const unsigned char *bytes,
+                         const AKArchiveElement *element,
+                         const AKArchiveGeometry *geometry)
+{
+    const AKArchiveHeader *header = (const AKArchiveHeader *)bytes;
+    if (element->bytesPerIndex == 0)
+    {
+        // the element of a mesh which is not triangulated has no indices
+        return true;
+    }
+    if ((uint64_t)element->nPrimitives * 3 > element->nIndices ||
+        !inFile(header, element->indices,
+                (uint64_t)element->nIndices * element->bytesPerIndex))
+    {
+        return false;
+    }
+    const unsigned char *indices = bytes + element->indices;
+    switch (element->bytesPerIndex)
+    {
+    case sizeof(uint8_t):
+        return validIndices((const uint8_t *)indices, element->nIndices,
+                            geometry->nVertices);
+    case sizeof(uint16_t):
+        return validIndices((const uint16_t *)indices, element->nIndices,
+                            geometry->nVertices);
+    case sizeof(uint32_t):
+        return validIndices((const uint32_t *)indices, element->nIndices,
+                            geometry->nVertices);
+    default:
+        return false;
+    }
+}
+
+/**
+ Determines if the buffers of a node skin are inside the file and each of its
+ bone indices is a bone of the archive.
+
+ @param bytes The mapped file.
+ @param skin The node skin.
+ @return true if the skin is valid.
+ */
+static bool validSkin(const unsigned char *bytes, const AKArchiveSkin *skin)
+{
+    const AKArchiveHeader *header = (const AKArchiveHeader *)bytes;
+    uint64_t nWeights = (uint64_t)skin->nVertices * skin->maxWeights;
+    if (!inFile(header, skin->boneWeights, nWeights * sizeof(float)) ||
+        !inFile(header, skin->boneIndices, nWeights * sizeof(short)))
+    {
+        return false;
+    }
+    const short *boneIndices = (const short *)(bytes + skin->boneIndices);
+    for (uint64_t i = 0; i < nWeights; i++)
+    {
+        if (boneIndices[i] < 0 || (uint32_t)boneIndices[i] >= header->nBones)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ Determines if the strings of a string pool are valid UTF-8, without overlong
+ forms or surrogates, so that every name of the archive can be made a string
+ of the platform.
+
+ @param strings The string pool.
+ @param nBytes The size of the string pool in bytes.
+ @return true if the strings are valid UTF-8.
+ */
+static bool validStrings(const unsigned char *strings, uint64_t nBytes)
+{
+    uint64_t i = 0;
+    while (i < nBytes)
+    {
+        unsigned char lead = strings[i++];
+        if (lead < 0x80)
+        {
+            continue;
+        }
+        // the range of the second byte depends on the lead byte
+        unsigned int nContinuations;
+        unsigned char low = 0x80;
+        unsigned char high = 0xbf;
+        if (lead >= 0xc2 && lead <= 0xdf)
+        {
+            nContinuations = 1;
+        }
+        else if (lead >= 0xe0 && lead <= 0xef)
+        {
+            nContinuations = 2;
+            low = lead == 0xe0 ? 0xa0 : low;
+            high = lead == 0xed ? 0x9f : high;
+        }
+        else if (lead >= 0xf0 && lead <= 0xf4)
+        {
+            nContinuations = 3;
+            low = lead == 0xf0 ? 0x90 : low;
+            high = lead == 0xf4 ? 0x8f : high;
+        }
+        else
+        {
+            return false;
+        }
+        if (nBytes - i < nContinuations || strings[i] < low ||
+            strings[i] > high)
+        {
+            return false;
+        }
+        for (unsigned int c = 1; c < nContinuations; c++)
+        {
+            if ((strings[i + c] & 0xc0) != 0x80)
+            {
+                return false;
+            }
+        }
+        i += nContinuations;
+    }
+    return true;
+}
+
+/**
+ Returns a table of records of a mapped file.
+
+ @param bytes The mapped file.
+ @param offset The offset of the table.
+ @return The first record of the table.
+ */
+template <typename T>
+static const T *table(const unsigned char *bytes, uint64_t offset)
+{
+    return (const T *)(bytes + offset);
+}
+
+/**
+ Checks that every record of a mapped file refers to records and bytes
+ inside the file, that every index refers to a vertex of its geometry and
+ every bone index to a bone, and that its strings are valid UTF-8, so that a
+ damaged file is rejected before it is read.
+
+ @param bytes The mapped file.
+ @return true if the file is valid.
+ */
+static bool validateArchive(const unsigned char *bytes)
+{
+    const AKArchiveHeader *header = (const AKArchiveHeader *)bytes;
+    if (!validTable(header, header->nodes, header->nNodes,
+                    sizeof(AKArchiveNode)) ||
+        !validTable(header, header->nodeMeshes, header->nNodeMeshes,
+                    sizeof(uint32_t)) ||
+        !validTable(header, header->meshMaterials, header->nMeshes,
+                    sizeof(uint32_t)) ||
+        !validTable(header, header->materials, header->nMaterials,
+                    sizeof(AKArchiveMaterial)) ||
+        !validTable(header, header->textures, header->nTextures,
+                    sizeof(AKArchiveTexture)) ||
+        !validTable(header, header->geometries, header->nGeometries,
+                    sizeof(AKArchiveGeometry)) ||
+        !validTable(header, header->elements, header->nElements,
+                    sizeof(AKArchiveElement)) ||
+        !validTable(header, header->skins, header->nSkins,
+                    sizeof(AKArchiveSkin)) ||
+        !validTable(header, header->cameras, header->nCameras,
+                    sizeof(AKArchiveCamera)) ||
+        !validTable(header, header->bones, header->nBones,
+                    sizeof(AKArchiveBone)) ||
+        !validTable(header, header->animations, header->nAnimations,
+                    sizeof(AKArchiveAnimation)) ||
+        !validTable(header, header->channels, header->nChannels,
+                    sizeof(AKArchiveChannel)) ||
+        !validTable(header, header->dependencies, header->nDependencies,
+                    sizeof(AKArchiveDependency)) ||
+        !inFile(header, header->strings, header->stringBytes) ||
+        header->stringBytes == 0 ||
+        bytes[header->strings + header->stringBytes - 1] != 0 ||
+        !validStrings(bytes + header->strings, header->stringBytes))
+    {
+        return false;
+    }
+    if (header->skeletonNode != AKArchiveNone &&
+        header->skeletonNode >= header->nNodes)
+    {
+        return false;
+    }
+
+    const AKArchiveNode *nodes = table<AKArchiveNode>(bytes, header->nodes);
+    for (uint32_t i = 0; i < header->nNodes; i++)
+    {
+        const AKArchiveNode *node = &nodes[i];
+        if ((node->parent != AKArchiveNone && node->parent >= i) ||
+            (uint64_t)node->firstMesh + node->nMeshes > header->nNodeMeshes ||
+            (node->geometry != AKArchiveNone &&
+             node->geometry >= header->nGeometries) ||
+            (node->camera != AKArchiveNone &&
+             node->camera >= header->nCameras))
+        {
+            return false;
+        }
+    }
+    const uint32_t *meshMaterials =
+        table<uint32_t>(bytes, header->meshMaterials);
+    for (uint32_t i = 0; i < header->nMeshes; i++)
+    {
+        if (meshMaterials[i] != AKArchiveNone &&
+            meshMaterials[i] >= header->nMaterials)
+        {
+            return false;
+        }
+    }
+    const AKArchiveMaterial *materials =
+        table<AKArchiveMaterial>(bytes, header->materials);
+    for (uint32_t i = 0; i < header->nMaterials; i++)
+    {
+        if (materials[i].nSlots > AKArchiveMaxMaterialSlots)
+        {
+            return false;
+        }
+    }
+    const AKArchiveTexture *textures =
+        table<AKArchiveTexture>(bytes, header->textures);
+    for (uint32_t i = 0; i < header->nTextures; i++)
+    {
+        if (!inFile(header, textures[i].data, textures[i].nBytes))
+        {
+            return false;
+        }
+    }
+    const AKArchiveSkin *skins = table<AKArchiveSkin>(bytes, header->skins);
+    for (uint32_t i = 0; i < header->nSkins; i++)
+    {
+        if (!validSkin(bytes, &skins[i]))
+        {
+            return false;
+        }
+    }
+    const AKArchiveElement *elements =
+        table<AKArchiveElement>(bytes, header->elements);
+    const AKArchiveGeometry *geometries =
+        table<AKArchiveGeometry>(bytes, header->geometries);
+    for (uint32_t i = 0; i < header->nGeometries; i++)
+    {
+        const AKArchiveGeometry *geometry = &geometries[i];
+        if (!inFile(header, geometry->vertexData,
+                    (uint64_t)geometry->nVertices * geometry->vertexStride) ||
+            (uint64_t)geometry->firstElement + geometry->nElements >
+                header->nElements ||
+            (geometry->skin != AKArchiveNone &&
+             (geometry->skin >= header->nSkins ||
+              skins[geometry->skin].nVertices != geometry->nVertices)))
+        {
+            return false;
+        }
+        for (int a = 0; a < AKVertexAttributeCount; a++)
+        {
+            if (!validAttribute(&geometry->attributes[a],
+                                geometry->vertexStride))
+            {
+                return false;
+            }
+        }
+        // the elements of a geometry are checked against its vertices, and
+        // an element of no geometry is never read
+        for (uint32_t e = 0; e < geometry->nElements; e++)
+        {
+            if (!validElement(bytes, &elements[geometry->firstElement + e],
+                              geometry))
+            {
+                return false;
+            }
+        }
+    }
+    const AKArchiveAnimation *animations =
+        table<AKArchiveAnimation>(bytes, header->animations);
+    for (uint32_t i = 0; i < header->nAnimations; i++)
+    {
+        if ((uint64_t)animations[i].firstChannel + animations[i].nChannels >
+            header->nChannels)
+        {
+            return false;
+        }
+    }
+    const AKArchiveChannel *channels =
+        table<AKArchiveChannel>(bytes, header->channels);
+    for (uint32_t i = 0; i < header->nChannels; i++)
+    {
+        if (!validTrack(header, &channels[i].position) ||
+            !validTrack(header, &channels[i].orientation) ||
+            !validTrack(header, &channels[i].scale))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ Maps a scene archive file and checks its header and its tables.
+
+ The blobs of the file are advised to be read at random, so that reading the
+ tables and the buffers of a few nodes does not read ahead into the buffers
+ of the nodes which are never used.
+
+ @param path The path of the file.
+ @param key The key of the converted scene, or NULL for any key.
+ @return The archive, or NULL if the file does not exist, is not a scene
+ archive of this version or is the archive of another key.
+ */
+static AKSceneArchive *openArchive(const char *path,
+                                   const unsigned long long *key)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        (size_t)info.st_size < sizeof(AKArchiveHeader))
+    {
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)info.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+    const unsigned char *bytes = (const unsigned char *)mapping;
+    const AKArchiveHeader *header = (const AKArchiveHeader *)bytes;
+    if (memcmp(header->magic, AKArchiveMagic, sizeof(header->magic)) != 0 ||
+        header->version != AK_SCENE_ARCHIVE_VERSION ||
+        header->headerBytes != sizeof(AKArchiveHeader) ||
+        header->fileBytes != size || (key != NULL && header->key != *key) ||
+        !validateArchive(bytes))
+    {
+        munmap(mapping, size);
+        return NULL;
+    }
+    madvise(mapping, size, MADV_RANDOM);
+    AKSceneArchive *archive = new AKSceneArchive();
+    archive->bytes = bytes;
+    archive->size = size;
+    return archive;
+}
+
+/**
+ Maps a scene archive file and checks its header and its tables.
+
+ @param path The path of the file.
+ @param key The key of the converted scene.
+ @return The archive which must be released with AKSceneArchiveRelease, or
+ NULL if the file does not exist, is not a scene archive of this version or
+ is the archive of another key.
+ */
+AKSceneArchive *AKSceneArchiveOpen(const char *path, unsigned long long key)
+{
+    return openArchive(path, &key);
+}
+
+/**
+ Maps a scene archive file of any key, such as a scene asset compiled ahead
+ of time, and checks its header and its tables.
+
+ @param path The path of the file.
+ @return The archive which must be released with AKSceneArchiveRelease, or
+ NULL if the file does not exist or is not a scene archive of this version.
+ */
+AKSceneArchive *AKSceneArchiveOpenFile(const char *path)
+{
+    return openArchive(path, NULL);
+}
+
+/**
+ Unmaps the scene archive.
+
+ @param archive The archive, may be NULL.
+ */
+void AKSceneArchiveRelease(AKSceneArchive *archive)
+{
+    if (archive == NULL)
+    {
+        return;
+    }
+    munmap((void *)archive->bytes, archive->size);
+    delete archive;
+}
+
+#pragma mark - Reading a scene archive
+
+/**
+ Returns the header of the archive, with the number of records of each
+ table.
+
+ @param archive The archive.
+ @return The header.
+ */
+const AKArchiveHeader *AKSceneArchiveGetHeader(const AKSceneArchive *archive)
+{
+    return (const AKArchiveHeader *)archive->bytes;
+}
+
+/**
+ Returns a string of the string pool.
+
+ @param archive The archive.
+ @param offset The offset of the string in the pool.
+ @return The string, or an empty string if the offset is out of the pool.
+ */
+const char *AKSceneArchiveString(const AKSceneArchive *archive,
+                                 uint32_t offset)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    if (offset >= header->stringBytes)
+    {
+        return "";
+    }
+    return (const char *)(archive->bytes + header->strings + offset);
+}
+
+/**
+ Returns a node.
+
+ @param archive The archive.
+ @param index The index of the node, less than the number of nodes.
+ @return The node.
+ */
+const AKArchiveNode *AKSceneArchiveNodeAt(const AKSceneArchive *archive,
+                                          unsigned int index)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    return &table<AKArchiveNode>(archive->bytes, header->nodes)[index];
+}
+
+/**
+ Returns the mesh indices of a node.
+
+ @param archive The archive.
+ @param node The node.
+ @return The nMeshes mesh indices of the node.
+ */
+const uint32_t *AKSceneArchiveNodeMeshes(const AKSceneArchive *archive,
+                                         const AKArchiveNode *node)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    return table<uint32_t>(archive->bytes, header->nodeMeshes) +
+           node->firstMesh;
+}
+
+/**
+ Returns the material of a mesh.
+
+ @param archive The archive.
+ @param mesh The index of the mesh.
+ @return The material, or NULL if the mesh has none.
+ */
+const AKArchiveMaterial *AKSceneArchiveMeshMaterial(
+    const AKSceneArchive *archive,
+    unsigned int mesh)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    if (mesh >= header->nMeshes)
+    {
+        return NULL;
+    }
+    uint32_t material =
+        table<uint32_t>(archive->bytes, header->meshMaterials)[mesh];
+    if (material == AKArchiveNone)
+    {
+        return NULL;
+    }
+    return &table<AKArchiveMaterial>(archive->bytes,
+                                     header->materials)[material];
+}
+
+/**
+ Returns the bytes of an embedded texture, read in place.
+
+ @param archive The archive.
+ @param index The index of the texture.
+ @param nBytes Set to the number of bytes.
+ @param formatHint Set to the file format hint.
+ @return The bytes, or NULL if the archive has no texture at the index.
+ */
+const void *AKSceneArchiveTextureBytes(const AKSceneArchive *archive,
+                                       unsigned int index,
+                                       size_t *nBytes,
+                                       const char **formatHint)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    if (index >= header->nTextures)
+    {
+        return NULL;
+    }
+    const AKArchiveTexture *texture =
+        &table<AKArchiveTexture>(archive->bytes, header->textures)[index];
+    if (texture->nBytes == 0)
+    {
+        return NULL;
+    }
+    *nBytes = (size_t)texture->nBytes;
+    *formatHint = AKSceneArchiveString(archive, texture->formatHint);
+    return archive->bytes + texture->data;
+}
+
+/**
+ Returns a node geometry record.
+
+ @param archive The archive.
+ @param index The index of the geometry, less than the number of geometries.
+ @return The geometry record.
+ */
+const AKArchiveGeometry *AKSceneArchiveGeometryAt(
+    const AKSceneArchive *archive,
+    unsigned int index)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    return &table<AKArchiveGeometry>(archive->bytes, header->geometries)[index];
+}
+
+/**
+ Copies bytes of the archive into a new buffer.
+
+ @param archive The archive.
+ @param offset The offset of the bytes.
+ @param nBytes The number of bytes.
+ @return The new buffer, which must be freed with AKMemoryFree.
+ */
+static void *copyBytes(const AKSceneArchive *archive,
+                       uint64_t offset,
+                       size_t nBytes)
+{
+    void *buffer = AKMemoryMalloc(nBytes > 0 ? nBytes : 1);
+    if (nBytes > 0)
+    {
+        memcpy(buffer, archive->bytes + offset, nBytes);
+    }
+    return buffer;
+}
+
+/**
+ Returns bytes of the archive read in place, and advises that they are read
+ soon, so that the pages of a buffer are read ahead of its first use.
+
+ @param archive The archive.
+ @param offset The offset of the bytes.
+ @param nBytes The number of bytes.
+ @return The bytes, which are read only and are unmapped with the archive.
+ */
+static void *mappedBytes(const AKSceneArchive *archive,
+                         uint64_t offset,
+                         size_t nBytes)
+{
+    if (nBytes > 0)
+    {
+        uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t start = offset - offset % page;
+        madvise((void *)(archive->bytes + start),
+                (size_t)(offset + nBytes - start), MADV_WILLNEED);
+    }
+    return (void *)(archive->bytes + offset);
+}
+
+/**
+ Creates a node geometry from a node geometry of the archive, with either a
+ copy of its vertices and indices or the vertices and indices read in place.
+
+ @param archive The archive.
+ @param index The index of the geometry.
+ @param inPlace true to read the vertices and the indices in place.
+ @return A new node geometry, or NULL if the geometry is out of the file.
+ */
+static AKNodeGeometry *makeGeometry(const AKSceneArchive *archive,
+                                    unsigned int index,
+                                    bool inPlace)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    if (index >= header->nGeometries)
+    {
+        return NULL;
+    }
+    void *(*bytes)(const AKSceneArchive *, uint64_t, size_t) =
+        inPlace ? mappedBytes : copyBytes;
+    const AKArchiveGeometry *record = AKSceneArchiveGeometryAt(archive, index);
+    AKNodeGeometry *geometry =
+        (AKNodeGeometry *)AKMemoryCalloc(1, sizeof(AKNodeGeometry));
+    geometry->nVertices = record->nVertices;
+    geometry->vertexStride = record->vertexStride;
+    for (int a = 0; a < AKVertexAttributeCount; a++)
+    {
+        const AKArchiveAttribute *attribute = &record->attributes[a];
+        geometry->attributes[a].format = (AKVertexFormat)attribute->format;
+        geometry->attributes[a].nComponents = attribute->nComponents;
+        geometry->attributes[a].bytesPerComponent =
+            attribute->bytesPerComponent;
+        geometry->attributes[a].offset = attribute->offset;
+    }
+    geometry->vertexData = (unsigned char *)bytes(
+        archive, record->vertexData,
+        (size_t)record->nVertices * record->vertexStride);
+    geometry->nElements = record->nElements;
+    geometry->elements = (AKGeometryElement *)AKMemoryCalloc(
+        record->nElements > 0 ? record->nElements : 1,
+        sizeof(AKGeometryElement));
+    const AKArchiveElement *elements =
+        table<AKArchiveElement>(archive->bytes, header->elements) +
+        record->firstElement;
+    for (unsigned int i = 0; i < record->nElements; i++)
+    {
+        AKGeometryElement *element = &geometry->elements[i];
+        element->meshIndex = elements[i].meshIndex;
+        element->nPrimitives = elements[i].nPrimitives;
+        element->nIndices = elements[i].nIndices;
+        element->bytesPerIndex = elements[i].bytesPerIndex;
+        // an element without indices keeps them NULL, as it is ignored
+        element->indices =
+            elements[i].bytesPerIndex > 0
+                ? bytes(archive, elements[i].indices,
+                        (size_t)elements[i].nIndices *
+                            elements[i].bytesPerIndex)
+                : NULL;
+    }
+    memcpy(geometry->positionScale, record->positionScale,
+           sizeof(geometry->positionScale));
+    memcpy(geometry->positionOffset, record->positionOffset,
+           sizeof(geometry->positionOffset));
+    geometry->quantization.maxPositionError = record->maxPositionError;
+    geometry->quantization.maxNormalAngleError = record->maxNormalAngleError;
+    geometry->quantization.maxTangentAngleError =
+        record->maxTangentAngleError;
+    geometry->quantization.maxTexCoordError = record->maxTexCoordError;
+    geometry->quantization.bytesSaved = (unsigned long)record->bytesSaved;
+    return geometry;
+}
+
+/**
+ Creates a node geometry with a copy of the vertices and the indices of a
+ node geometry of the archive.
+
+ @param archive The archive.
+ @param index The index of the geometry.
+ @return A new node geometry which must be released with
+ AKNodeGeometryRelease, or NULL if the geometry is out of the file.
+ */
+AKNodeGeometry *AKSceneArchiveCreateGeometry(const AKSceneArchive *archive,
+                                             unsigned int index)
+{
+    return makeGeometry(archive, index, false);
+}
+
+/**
+ Creates a node geometry whose vertices and indices are read in place from
+ the mapped file, without a copy.
+
+ @param archive The archive.
+ @param index The index of the geometry.
+ @return A new node geometry which must be released with
+ AKSceneArchiveReleaseGeometryInPlace, or NULL if the geometry is out of the
+ file.
+ */
+AKNodeGeometry *AKSceneArchiveCreateGeometryInPlace(
+    const AKSceneArchive *archive,
+    unsigned int index)
+{
+    return makeGeometry(archive, index, true);
+}
+
+/**
+ Releases a node geometry created in place, but not its vertices and indices
+ which belong to the archive.
+
+ @param geometry The node geometry, may be NULL.
+ */
+void AKSceneArchiveReleaseGeometryInPlace(AKNodeGeometry *geometry)
+{
+    if (geometry == NULL)
+    {
+        return;
+    }
+    geometry->vertexData = NULL;
+    for (unsigned int i = 0; i < geometry->nElements; i++)
+    {
+        geometry->elements[i].indices = NULL;
+    }
+    AKNodeGeometryRelease(geometry);
+}
+
+/**
+ Creates a node skin from a skin of the archive, with either a copy of its
+ bone weights and indices or the bone weights and indices read in place.
+
+ @param archive The archive.
+ @param index The index of the skin.
+ @param inPlace true to read the bone weights and indices in place.
+ @return A new node skin, or NULL if the skin is out of the file.
+ */
+static AKNodeSkin *makeSkin(const AKSceneArchive *archive,
+                            unsigned int index,
+                            bool inPlace)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    if (index >= header->nSkins)
+    {
+        return NULL;
+    }
+    void *(*bytes)(const AKSceneArchive *, uint64_t, size_t) =
+        inPlace ? mappedBytes : copyBytes;
+    const AKArchiveSkin *record =
+        &table<AKArchiveSkin>(archive->bytes, header->skins)[index];
+    size_t nWeights = (size_t)record->nVertices * record->maxWeights;
+    AKNodeSkin *skin = (AKNodeSkin *)AKMemoryCalloc(1, sizeof(AKNodeSkin));
+    skin->nVertices = record->nVertices;
+    skin->maxWeights = record->maxWeights;
+    skin->boneWeights =
+        (float *)bytes(archive, record->boneWeights, nWeights * sizeof(float));
+    skin->boneIndices =
+        (short *)bytes(archive, record->boneIndices, nWeights * sizeof(short));
+    return skin;
+}
+
+/**
+ Creates a node skin with a copy of the bone weights and indices of a skin of
+ the archive.
+
+ @param archive The archive.
+ @param index The index of the skin.
+ @return A new node skin which must be released with AKNodeSkinRelease, or
+ NULL if the skin is out of the file.
+ */
+AKNodeSkin *AKSceneArchiveCreateSkin(const AKSceneArchive *archive,
+                                     unsigned int index)
+{
+    return makeSkin(archive, index, false);
+}
+
+/**
+ Creates a node skin whose bone weights and indices are read in place from
+ the mapped file, without a copy.
+
+ @param archive The archive.
+ @param index The index of the skin.
+ @return A new node skin which must be released with
+ AKSceneArchiveReleaseSkinInPlace, or NULL if the skin is out of the file.
+ */
+AKNodeSkin *AKSceneArchiveCreateSkinInPlace(const AKSceneArchive *archive,
+                                            unsigned int index)
+{
+    return makeSkin(archive, index, true);
+}
+
+/**
+ Releases a node skin created in place, but not its bone weights and indices
+ which belong to the archive.
+
+ @param skin The node skin, may be NULL.
+ */
+void AKSceneArchiveReleaseSkinInPlace(AKNodeSkin *skin)
+{
+    if (skin == NULL)
+    {
+        return;
+    }
+    skin->boneWeights = NULL;
+    skin->boneIndices = NULL;
+    AKNodeSkinRelease(skin);
+}
+
+/**
+ Returns a camera.
+
+ @param archive The archive.
+ @param index The index of the camera, less than the number of cameras.
+ @return The camera.
+ */
+const AKArchiveCamera *AKSceneArchiveCameraAt(const AKSceneArchive *archive,
+                                              unsigned int index)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    return &table<AKArchiveCamera>(archive->bytes, header->cameras)[index];
+}
+
+/**
+ Returns a bone.
+
+ @param archive The archive.
+ @param index The index of the bone, less than the number of bones.
+ @return The bone.
+ */
+const AKArchiveBone *AKSceneArchiveBoneAt(const AKSceneArchive *archive,
+                                          unsigned int index)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    return &table<AKArchiveBone>(archive->bytes, header->bones)[index];
+}
+
+/**
+ Copies the keyframes of a track of the archive.
+
+ @param archive The archive.
+ @param record The keyframe track record.
+ @param track Set to the keyframe track.
+ */
+static void copyTrack(const AKSceneArchive *archive,
+                      const AKArchiveTrack *record,
+                      AKKeyframeTrack *track)
+{
+    track->nKeys = record->nKeys;
+    track->nComponents = record->nComponents;
+    track->keyTimes = (float *)copyBytes(archive, record->keyTimes,
+                                         record->nKeys * sizeof(float));
+    track->values = (float *)copyBytes(
+        archive, record->values,
+        (size_t)record->nKeys * record->nComponents * sizeof(float));
+}
+
+/**
+ Creates the animation tracks with a copy of the keyframes of an animation of
+ the archive.
+
+ @param archive The archive.
+ @param index The index of the animation.
+ @return New animation tracks which must be released with
+ AKAnimationTracksRelease, or NULL if the animation is out of the file.
+ */
+AKAnimationTracks *AKSceneArchiveCreateAnimationTracks(
+    const AKSceneArchive *archive,
+    unsigned int index)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    if (index >= header->nAnimations)
+    {
+        return NULL;
+    }
+    const AKArchiveAnimation *animation =
+        &table<AKArchiveAnimation>(archive->bytes, header->animations)[index];
+    const AKArchiveChannel *channels =
+        table<AKArchiveChannel>(archive->bytes, header->channels) +
+        animation->firstChannel;
+    AKAnimationTracks *tracks =
+        (AKAnimationTracks *)AKMemoryCalloc(1, sizeof(AKAnimationTracks));
+    tracks->duration = animation->duration;
+    tracks->nChannels = animation->nChannels;
+    tracks->channels = (AKChannelTracks *)AKMemoryCalloc(
+        animation->nChannels > 0 ? animation->nChannels : 1,
+        sizeof(AKChannelTracks));
+    for (unsigned int j = 0; j < animation->nChannels; j++)
+    {
+        AKChannelTracks *channel = &tracks->channels[j];
+        channel->nodeName =
+            strdup(AKSceneArchiveString(archive, channels[j].nodeName));
+        copyTrack(archive, &channels[j].position, &channel->position);
+        copyTrack(archive, &channels[j].orientation, &channel->orientation);
+        copyTrack(archive, &channels[j].scale, &channel->scale);
+    }
+    return tracks;
+}
+
+/**
+ Determines if the files which the scene was read from are unchanged: each
+ file which existed has the same size and bytes, and each missing file is
+ still missing.
+
+ @param archive The archive.
+ @return 1 if every file is unchanged, else 0.
+ */
+int AKSceneArchiveDependenciesAreCurrent(const AKSceneArchive *archive)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    const AKArchiveDependency *dependencies =
+        table<AKArchiveDependency>(archive->bytes, header->dependencies);
+    for (uint32_t i = 0; i < header->nDependencies; i++)
+    {
+        const AKArchiveDependency *dependency = &dependencies[i];
+        AKArchiveDependency current;
+        hashDependency(AKSceneArchiveString(archive, dependency->path),
+                       &current);
+        if ((current.exists != 0) != (dependency->exists != 0) ||
+            current.nBytes != dependency->nBytes ||
+            current.hash != dependency->hash)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,1191 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKSceneArchive_h
+#define AKSceneArchive_h
+
+#include "AKAnimation.h"
+#include "AKGeometry.h"
+#include "AKSkin.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ A converted scene stored in a single file, so that a scene is loaded again
+ without reading and converting the assimp scene: the nodes, the converted
+ node geometries and skins, the materials and the embedded textures, the
+ cameras, the bones and the keyframe tracks of the animations.
+
+ The file is laid out to be memory mapped and read in place. It starts with
+ an AKArchiveHeader, followed by the vertex, index, weight, keyframe and
+ texture bytes, then by the tables of fixed size records, and ends with the
+ pool of the null terminated strings. Every record and every buffer starts at
+ a multiple of 8 bytes. The offsets of the tables and the buffers are from
+ the start of the file, the offsets of the strings from the start of the
+ string pool, and the numbers are stored in the byte order of the writer.
+
+ A reference to a record which may be missing, such as the geometry of a
+ node, is AKArchiveNone when it is missing.
+
+ The archive lists the files which the scene was read from with the hashes
+ of their bytes, so that a converted scene whose scene file or side files,
+ such as a material library, have changed since is found to be stale.
+
+ Opening an archive reads its header, its tables, and the indices and bone
+ indices it checks against the vertices and the bones. The vertices of a node
+ geometry and the bone weights of a node skin can be read in place, without a
+ copy, so that their pages are only read from the disk when the node is used,
+ and the pages of the nodes which are never used are never read. A file
+ which is mapped must be replaced by renaming a new file over it, never by
+ writing it in place.
+ */
+typedef struct AKSceneArchive AKSceneArchive;
+
+/**
+ Builds a scene archive from the parts of a converted scene, and writes it to
+ a file.
+ */
+typedef struct AKSceneArchiveWriter AKSceneArchiveWriter;
+
+#pragma mark - File format
+
+/**
+ The version of the file format, which a reader only opens files of.
+ */
+#define AK_SCENE_ARCHIVE_VERSION 2
+
+/**
+ The file extension of a scene archive, such as a scene asset compiled ahead
+ of time, which the importer loads as a scene file.
+ */
+#define AK_SCENE_ARCHIVE_EXTENSION "akscene"
+
+/**
+ The reference to a missing record.
+ */
+#define AKArchiveNone 0xffffffffu
+
+/**
+ The maximum number of material properties of a material.
+ */
+#define AKArchiveMaxMaterialSlots 12
+
+/**
+ The header at the start of a scene archive.
+ */
+typedef struct AKArchiveHeader
+{
+    /**
+     The bytes "AKSCENE" followed by a null byte.
+     */
+    char magic[8];
+
+    /**
+     The version of the file format, AK_SCENE_ARCHIVE_VERSION.
+     */
+    uint32_t version;
+
+    /**
+     The size of the header in bytes.
+     */
+    uint32_t headerBytes;
+
+    /**
+     The size of the file in bytes.
+     */
+    uint64_t fileBytes;
+
+    /**
+     The key of the converted scene, such as the key of a scene cache.
+     */
+    uint64_t key;
+
+    /**
+     The number of nodes.
+     */
+    uint32_t nNodes;
+
+    /**
+     The number of mesh indices of the nodes.
+     */
+    uint32_t nNodeMeshes;
+
+    /**
+     The number of meshes with a material.
+     */
+    uint32_t nMeshes;
+
+    /**
+     The number of materials.
+     */
+    uint32_t nMaterials;
+
+    /**
+     The number of embedded textures.
+     */
+    uint32_t nTextures;
+
+    /**
+     The number of node geometries.
+     */
+    uint32_t nGeometries;
+
+    /**
+     The number of geometry elements of the node geometries.
+     */
+    uint32_t nElements;
+
+    /**
+     The number of node skins.
+     */
+    uint32_t nSkins;
+
+    /**
+     The number of cameras.
+     */
+    uint32_t nCameras;
+
+    /**
+     The number of bones.
+     */
+    uint32_t nBones;
+
+    /**
+     The number of animations.
+     */
+    uint32_t nAnimations;
+
+    /**
+     The number of channels of the animations.
+     */
+    uint32_t nChannels;
+
+    /**
+     The node of the root of the skeleton, or AKArchiveNone if the skeleton
+     is the root of the scene.
+     */
+    uint32_t skeletonNode;
+
+    /**
+     The number of files the scene was read from.
+     */
+    uint32_t nDependencies;
+
+    /**
+     The offset of the AKArchiveNode table.
+     */
+    uint64_t nodes;
+
+    /**
+     The offset of the mesh indices of the nodes, 32 bit each.
+     */
+    uint64_t nodeMeshes;
+
+    /**
+     The offset of the material index of each mesh, 32 bit each.
+     */
+    uint64_t meshMaterials;
+
+    /**
+     The offset of the AKArchiveMaterial table.
+     */
+    uint64_t materials;
+
+    /**
+     The offset of the AKArchiveTexture table.
+     */
+    uint64_t textures;
+
+    /**
+     The offset of the AKArchiveGeometry table.
+     */
+    uint64_t geometries;
+
+    /**
+     The offset of the AKArchiveElement table.
+     */
+    uint64_t elements;
+
+    /**
+     The offset of the AKArchiveSkin table.
+     */
+    uint64_t skins;
+
+    /**
+     The offset of the AKArchiveCamera table.
+     */
+    uint64_t cameras;
+
+    /**
+     The offset of the AKArchiveBone table.
+     */
+    uint64_t bones;
+
+    /**
+     The offset of the AKArchiveAnimation table.
+     */
+    uint64_t animations;
+
+    /**
+     The offset of the AKArchiveChannel table.
+     */
+    uint64_t channels;
+
+    /**
+     The offset of the AKArchiveDependency table.
+     */
+    uint64_t dependencies;
+
+    /**
+     The offset of the string pool.
+     */
+    uint64_t strings;
+
+    /**
+     The size of the string pool in bytes.
+     */
+    uint64_t stringBytes;
+} AKArchiveHeader;
+
+/**
+ A node of the scene. The nodes are stored in pre-order, so that the parent
+ of a node comes before it.
+ */
+typedef struct AKArchiveNode
+{
+    /**
+     The name of the node, in the string pool.
+     */
+    uint32_t name;
+
+    /**
+     The parent node, or AKArchiveNone for the root node.
+     */
+    uint32_t parent;
+
+    /**
+     The first of the mesh indices of the node.
+     */
+    uint32_t firstMesh;
+
+    /**
+     The number of mesh indices of the node.
+     */
+    uint32_t nMeshes;
+
+    /**
+     The geometry of the node, or AKArchiveNone.
+     */
+    uint32_t geometry;
+
+    /**
+     The camera of the node, or AKArchiveNone.
+     */
+    uint32_t camera;
+
+    /**
+     The transform of the node, the scenekit matrix components m11, m12 ...
+     m44.
+     */
+    float transform[16];
+} AKArchiveNode;
+
+/**
+ What a material property shows.
+ */
+typedef enum AKMaterialSlotKind
+{
+    /**
+     The property keeps its default contents.
+     */
+    AKMaterialSlotNone = 0,
+
+    /**
+     The property shows the color of the slot.
+     */
+    AKMaterialSlotColor,
+
+    /**
+     The property shows an embedded texture of the archive.
+     */
+    AKMaterialSlotEmbeddedTexture,
+
+    /**
+     The property shows a texture file, at a path relative to the directory
+     of the scene file.
+     */
+    AKMaterialSlotExternalTexture
+} AKMaterialSlotKind;
+
+/**
+ A property of a material, such as its diffuse color or texture.
+ */
+typedef struct AKArchiveMaterialSlot
+{
+    /**
+     The assimp texture type of the property.
+     */
+    uint32_t textureType;
+
+    /**
+     What the property shows, an AKMaterialSlotKind.
+     */
+    uint32_t kind;
+
+    /**
+     The index of the embedded texture, or the path of the texture file in
+     the string pool, depending on the kind.
+     */
+    uint32_t texture;
+
+    /**
+     Non zero if the property has a color.
+     */
+    uint32_t hasColor;
+
+    /**
+     The rgba color of the property.
+     */
+    float color[4];
+} AKArchiveMaterialSlot;
+
+/**
+ A material, at the index of the assimp material it was made from.
+ */
+typedef struct AKArchiveMaterial
+{
+    /**
+     The name of the material, in the string pool.
+     */
+    uint32_t name;
+
+    /**
+     The assimp blend mode of the material.
+     */
+    uint32_t blendMode;
+
+    /**
+     Non zero if the material has a multiply color.
+     */
+    uint32_t hasMultiply;
+
+    /**
+     The number of material properties.
+     */
+    uint32_t nSlots;
+
+    /**
+     The rgba multiply color.
+     */
+    float multiply[4];
+
+    /**
+     The material properties, in the order they are applied.
+     */
+    AKArchiveMaterialSlot slots[AKArchiveMaxMaterialSlots];
+} AKArchiveMaterial;
+
+/**
+ An embedded texture, stored in its compressed file format.
+ */
+typedef struct AKArchiveTexture
+{
+    /**
+     The file format hint of the texture, such as png, in the string pool.
+     */
+    uint32_t formatHint;
+
+    /**
+     Unused, 0.
+     */
+    uint32_t reserved;
+
+    /**
+     The size of the texture in bytes.
+     */
+    uint64_t nBytes;
+
+    /**
+     The offset of the texture bytes.
+     */
+    uint64_t data;
+} AKArchiveTexture;
+
+/**
+ Where an attribute is stored in each interleaved vertex, as in an
+ AKVertexAttributeView.
+ */
+typedef struct AKArchiveAttribute
+{
+    /**
+     The AKVertexFormat of the attribute.
+     */
+    uint32_t format;
+
+    /**
+     The number of components of the attribute.
+     */
+    uint32_t nComponents;
+
+    /**
+     The number of bytes of each component.
+     */
+    uint32_t bytesPerComponent;
+
+    /**
+     The byte offset of the attribute from the start of a vertex.
+     */
+    uint32_t offset;
+} AKArchiveAttribute;
+
+/**
+ A node geometry, as in an AKNodeGeometry.
+ */
+typedef struct AKArchiveGeometry
+{
+    /**
+     The number of vertices.
+     */
+    uint32_t nVertices;
+
+    /**
+     The number of bytes of each interleaved vertex.
+     */
+    uint32_t vertexStride;
+
+    /**
+     The view of each attribute, indexed by AKVertexAttribute.
+     */
+    AKArchiveAttribute attributes[AKVertexAttributeCount];
+
+    /**
+     The scale of the stored positions.
+     */
+    float positionScale[3];
+
+    /**
+     The offset of the stored positions.
+     */
+    float positionOffset[3];
+
+    /**
+     The maximum position error of the quantized positions.
+     */
+    float maxPositionError;
+
+    /**
+     The maximum angle error of the quantized normals, in degrees.
+     */
+    float maxNormalAngleError;
+
+    /**
+     The maximum angle error of the quantized tangents, in degrees.
+     */
+    float maxTangentAngleError;
+
+    /**
+     The maximum error of the quantized texture coordinates.
+     */
+    float maxTexCoordError;
+
+    /**
+     The bytes saved by the quantized attributes.
+     */
+    uint64_t bytesSaved;
+
+    /**
+     The first of the geometry elements.
+     */
+    uint32_t firstElement;
+
+    /**
+     The number of geometry elements.
+     */
+    uint32_t nElements;
+
+    /**
+     The skin of the geometry, or AKArchiveNone.
+     */
+    uint32_t skin;
+
+    /**
+     Unused, 0.
+     */
+    uint32_t reserved;
+
+    /**
+     The offset of the interleaved vertices, nVertices * vertexStride bytes.
+     */
+    uint64_t vertexData;
+} AKArchiveGeometry;
+
+/**
+ A geometry element, as in an AKGeometryElement.
+ */
+typedef struct AKArchiveElement
+{
+    /**
+     The index of the mesh in the assimp scene's meshes.
+     */
+    uint32_t meshIndex;
+
+    /**
+     The number of triangles.
+     */
+    uint32_t nPrimitives;
+
+    /**
+     The number of indices.
+     */
+    uint32_t nIndices;
+
+    /**
+     The number of bytes of each index: 1, 2 or 4.
+     */
+    uint32_t bytesPerIndex;
+
+    /**
+     The offset of the indices, or 0 if the element has none.
+     */
+    uint64_t indices;
+} AKArchiveElement;
+
+/**
+ The skin of a node geometry, as in an AKNodeSkin.
+ */
+typedef struct AKArchiveSkin
+{
+    /**
+     The number of vertices.
+     */
+    uint32_t nVertices;
+
+    /**
+     The number of weights of each vertex.
+     */
+    uint32_t maxWeights;
+
+    /**
+     The offset of the bone weights, maxWeights floats per vertex.
+     */
+    uint64_t boneWeights;
+
+    /**
+     The offset of the bone indices, maxWeights shorts per vertex.
+     */
+    uint64_t boneIndices;
+} AKArchiveSkin;
+
+/**
+ A camera.
+ */
+typedef struct AKArchiveCamera
+{
+    /**
+     The horizontal field of view, in radians.
+     */
+    float xFov;
+
+    /**
+     The distance of the near clipping plane.
+     */
+    float zNear;
+
+    /**
+     The distance of the far clipping plane.
+     */
+    float zFar;
+
+    /**
+     Unused, 0.
+     */
+    float reserved;
+} AKArchiveCamera;
+
+/**
+ A bone of the skeleton, in the order of the skinner's bones.
+ */
+typedef struct AKArchiveBone
+{
+    /**
+     The name of the bone node, in the string pool.
+     */
+    uint32_t name;
+
+    /**
+     Unused, 0.
+     */
+    uint32_t reserved;
+
+    /**
+     The inverse bind transform of the bone, the scenekit matrix components
+     m11, m12 ... m44.
+     */
+    float inverseBindTransform[16];
+} AKArchiveBone;
+
+/**
+ An animation, as in an AKAnimationTracks.
+ */
+typedef struct AKArchiveAnimation
+{
+    /**
+     The duration of the animation.
+     */
+    float duration;
+
+    /**
+     The first of the channels of the animation.
+     */
+    uint32_t firstChannel;
+
+    /**
+     The number of channels.
+     */
+    uint32_t nChannels;
+
+    /**
+     Unused, 0.
+     */
+    uint32_t reserved;
+} AKArchiveAnimation;
+
+/**
+ A keyframe track, as in an AKKeyframeTrack.
+ */
+typedef struct AKArchiveTrack
+{
+    /**
+     The number of keyframes.
+     */
+    uint32_t nKeys;
+
+    /**
+     The number of float components of each keyframe value.
+     */
+    uint32_t nComponents;
+
+    /**
+     The offset of the keyframe times, one float per keyframe.
+     */
+    uint64_t keyTimes;
+
+    /**
+     The offset of the keyframe values, nComponents floats per keyframe.
+     */
+    uint64_t values;
+} AKArchiveTrack;
+
+/**
+ The keyframe tracks of an animation channel, as in an AKChannelTracks.
+ */
+typedef struct AKArchiveChannel
+{
+    /**
+     The name of the animated node, in the string pool.
+     */
+    uint32_t nodeName;
+
+    /**
+     Unused, 0.
+     */
+    uint32_t reserved;
+
+    /**
+     The position keyframes.
+     */
+    AKArchiveTrack position;
+
+    /**
+     The orientation keyframes.
+     */
+    AKArchiveTrack orientation;
+
+    /**
+     The scale keyframes.
+     */
+    AKArchiveTrack scale;
+} AKArchiveChannel;
+
+/**
+ A file which the scene was read from, such as the scene file, a material
+ library or a buffer file, or a file which the loaders looked for and did not
+ find. The converted scene is stale once any of them changes.
+ */
+typedef struct AKArchiveDependency
+{
+    /**
+     The path of the file, in the string pool.
+     */
+    uint32_t path;
+
+    /**
+     Non zero if the file existed, else the file must still not exist.
+     */
+    uint32_t exists;
+
+    /**
+     The size of the file in bytes.
+     */
+    uint64_t nBytes;
+
+    /**
+     The hash of the bytes of the file, as added to an initial scene key.
+     */
+    uint64_t hash;
+} AKArchiveDependency;
+
+#pragma mark - Writing a scene archive
+
+/**
+ Creates an empty scene archive writer.
+
+ @param key The key of the converted scene, stored in the header.
+ @return The new writer which must be released with
+ AKSceneArchiveWriterRelease.
+ */
+AKSceneArchiveWriter *AKSceneArchiveWriterCreate(unsigned long long key);
+
+/**
+ Releases the writer.
+
+ @param writer The writer, may be NULL.
+ */
+void AKSceneArchiveWriterRelease(AKSceneArchiveWriter *writer);
+
+/**
+ Adds a node after the nodes added before, which must include its parent.
+
+ @param writer The writer.
+ @param name The name of the node.
+ @param parent The parent node, or AKArchiveNone for the root node.
+ @param transform The transform of the node, the scenekit matrix components
+ m11, m12 ... m44.
+ @param meshes The indices of the meshes of the node.
+ @param nMeshes The number of meshes of the node.
+ @return The index of the node.
+ */
+unsigned int AKSceneArchiveWriterAddNode(AKSceneArchiveWriter *writer,
+                                         const char *name,
+                                         unsigned int parent,
+                                         const float *transform,
+                                         const unsigned int *meshes,
+                                         unsigned int nMeshes);
+
+/**
+ Copies the vertices and the elements of the geometry of a node.
+
+ @param writer The writer.
+ @param node The node.
+ @param geometry The node geometry, before its buffers are handed off.
+ */
+void AKSceneArchiveWriterSetGeometry(AKSceneArchiveWriter *writer,
+                                     unsigned int node,
+                                     const AKNodeGeometry *geometry);
+
+/**
+ Copies the bone weights and indices of the skin of the geometry of a node.
+
+ @param writer The writer.
+ @param node The node, whose geometry is set.
+ @param skin The node skin, before its buffers are handed off.
+ */
+void AKSceneArchiveWriterSetSkin(AKSceneArchiveWriter *writer,
+                                 unsigned int node,
+                                 const AKNodeSkin *skin);
+
+/**
+ Sets the camera of a node.
+
+ @param writer The writer.
+ @param node The node.
+ @param xFov The horizontal field of view, in radians.
+ @param zNear The distance of the near clipping plane.
+ @param zFar The distance of the far clipping plane.
+ */
+void AKSceneArchiveWriterSetCamera(AKSceneArchiveWriter *writer,
+                                   unsigned int node,
+                                   float xFov,
+                                   float zNear,
+                                   float zFar);
+
+/**
+ Sets the material of a mesh.
+
+ @param writer The writer.
+ @param mesh The index of the mesh.
+ @param material The index of the material.
+ */
+void AKSceneArchiveWriterSetMeshMaterial(AKSceneArchiveWriter *writer,
+                                         unsigned int mesh,
+                                         unsigned int material);
+
+/**
+ Determines if a material is set.
+
+ @param writer The writer.
+ @param material The index of the material.
+ @return Non zero if the material is set.
+ */
+int AKSceneArchiveWriterHasMaterial(const AKSceneArchiveWriter *writer,
+                                    unsigned int material);
+
+/**
+ Sets a material without properties, replacing the material at the index.
+
+ @param writer The writer.
+ @param material The index of the material.
+ @param name The name of the material.
+ @param blendMode The assimp blend mode of the material.
+ @param multiply The rgba multiply color, or NULL if the material has none.
+ */
+void AKSceneArchiveWriterSetMaterial(AKSceneArchiveWriter *writer,
+                                     unsigned int material,
+                                     const char *name,
+                                     unsigned int blendMode,
+                                     const float *multiply);
+
+/**
+ Adds a property to a material, unless the material has
+ AKArchiveMaxMaterialSlots properties already.
+
+ @param writer The writer.
+ @param material The index of the material, which is set.
+ @param textureType The assimp texture type of the property.
+ @param kind What the property shows.
+ @param color The rgba color of the property, or NULL if it has none.
+ @param texture The index of the embedded texture, if the property shows
+ one.
+ @param texturePath The path of the texture file relative to the directory
+ of the scene file, if the property shows one, else NULL.
+ */
+void AKSceneArchiveWriterAddMaterialSlot(AKSceneArchiveWriter *writer,
+                                         unsigned int material,
+                                         unsigned int textureType,
+                                         AKMaterialSlotKind kind,
+                                         const float *color,
+                                         unsigned int texture,
+                                         const char *texturePath);
+
+/**
+ Copies an embedded texture, unless the texture at the index is set.
+
+ @param writer The writer.
+ @param texture The index of the texture.
+ @param bytes The bytes of the texture in its compressed file format.
+ @param nBytes The number of bytes.
+ @param formatHint The file format hint, such as png.
+ */
+void AKSceneArchiveWriterSetTexture(AKSceneArchiveWriter *writer,
+                                    unsigned int texture,
+                                    const void *bytes,
+                                    size_t nBytes,
+                                    const char *formatHint);
+
+/**
+ Adds a bone after the bones added before.
+
+ @param writer The writer.
+ @param name The name of the bone node.
+ @param inverseBindTransform The inverse bind transform of the bone, the
+ scenekit matrix components m11, m12 ... m44.
+ */
+void AKSceneArchiveWriterAddBone(AKSceneArchiveWriter *writer,
+                                 const char *name,
+                                 const float *inverseBindTransform);
+
+/**
+ Sets the root node of the skeleton.
+
+ @param writer The writer.
+ @param node The node, or AKArchiveNone if the skeleton is the root of the
+ scene.
+ */
+void AKSceneArchiveWriterSetSkeleton(AKSceneArchiveWriter *writer,
+                                     unsigned int node);
+
+/**
+ Copies the keyframe tracks of an animation after the animations added
+ before.
+
+ @param writer The writer.
+ @param tracks The animation tracks.
+ */
+void AKSceneArchiveWriterAddAnimation(AKSceneArchiveWriter *writer,
+                                      const AKAnimationTracks *tracks);
+
+/**
+ Adds a file which the scene was read from, with the size and the hash of its
+ current bytes, or as a missing file if it cannot be read.
+
+ @param writer The writer.
+ @param path The path of the file.
+ */
+void AKSceneArchiveWriterAddDependency(AKSceneArchiveWriter *writer,
+                                       const char *path);
+
+/**
+ Writes the archive to a file.
+
+ @param writer The writer.
+ @param path The path of the file, which is replaced.
+ @return The size of the file in bytes, or 0 if it could not be written.
+ */
+size_t AKSceneArchiveWriterWriteFile(const AKSceneArchiveWriter *writer,
+                                     const char *path);
+
+#pragma mark - Reading a scene archive
+
+/**
+ Maps a scene archive file and checks its header and its tables.
+
+ @param path The path of the file.
+ @param key The key of the converted scene.
+ @return The archive which must be released with AKSceneArchiveRelease, or
+ NULL if the file does not exist, is not a scene archive of this version or
+ is the archive of another key.
+ */
+AKSceneArchive *AKSceneArchiveOpen(const char *path, unsigned long long key);
+
+/**
+ Maps a scene archive file of any key, such as a scene asset compiled ahead
+ of time, and checks its header and its tables.
+
+ @param path The path of the file.
+ @return The archive which must be released with AKSceneArchiveRelease, or
+ NULL if the file does not exist or is not a scene archive of this version.
+ */
+AKSceneArchive *AKSceneArchiveOpenFile(const char *path);
+
+/**
+ Unmaps the scene archive.
+
+ @param archive The archive, may be NULL.
+ */
+void AKSceneArchiveRelease(AKSceneArchive *archive);
+
+/**
+ Returns the header of the archive, with the number of records of each
+ table.
+
+ @param archive The archive.
+ @return The header.
+ */
+const AKArchiveHeader *AKSceneArchiveGetHeader(const AKSceneArchive *archive);
+
+/**
+ Returns a string of the string pool.
+
+ @param archive The archive.
+ @param offset The offset of the string in the pool.
+ @return The string, or an empty string if the offset is out of the pool.
+ */
+const char *AKSceneArchiveString(const AKSceneArchive *archive,
+                                 uint32_t offset);
+
+/**
+ Returns a node.
+
+ @param archive The archive.
+ @param index The index of the node, less than the number of nodes.
+ @return The node.
+ */
+const AKArchiveNode *AKSceneArchiveNodeAt(const AKSceneArchive *archive,
+                                          unsigned int index);
+
+/**
+ Returns the mesh indices of a node.
+
+ @param archive The archive.
+ @param node The node.
+ @return The nMeshes mesh indices of the node.
+ */
+const uint32_t *AKSceneArchiveNodeMeshes(const AKSceneArchive *archive,
+                                         const AKArchiveNode *node);
+
+/**
+ Returns the material of a mesh.
+
+ @param archive The archive.
+ @param mesh The index of the mesh.
+ @return The material, or NULL if the mesh has none.
+ */
+const AKArchiveMaterial *AKSceneArchiveMeshMaterial(
+    const AKSceneArchive *archive,
+    unsigned int mesh);
+
+/**
+ Returns the bytes of an embedded texture, read in place.
+
+ @param archive The archive.
+ @param index The index of the texture.
+ @param nBytes Set to the number of bytes.
+ @param formatHint Set to the file format hint.
+ @return The bytes, or NULL if the archive has no texture at the index.
+ */
+const void *AKSceneArchiveTextureBytes(const AKSceneArchive *archive,
+                                       unsigned int index,
+                                       size_t *nBytes,
+                                       const char **formatHint);
+
+/**
+ Returns a node geometry record.
+
+ @param archive The archive.
+ @param index The index of the geometry, less than the number of geometries.
+ @return The geometry record.
+ */
+const AKArchiveGeometry *AKSceneArchiveGeometryAt(
+    const AKSceneArchive *archive,
+    unsigned int index);
+
+/**
+ Creates a node geometry with a copy of the vertices and the indices of a
+ node geometry of the archive.
+
+ @param archive The archive.
+ @param index The index of the geometry.
+ @return A new node geometry which must be released with
+ AKNodeGeometryRelease, or NULL if the geometry is out of the file.
+ */
+AKNodeGeometry *AKSceneArchiveCreateGeometry(const AKSceneArchive *archive,
+                                             unsigned int index);
+
+/**
+ Creates a node geometry whose vertices and indices are read in place from
+ the mapped file, without a copy.
+
+ @param archive The archive.
+ @param index The index of the geometry.
+ @return A new node geometry which must be released with
+ AKSceneArchiveReleaseGeometryInPlace, or NULL if the geometry is out of the
+ file.
+ */
+AKNodeGeometry *AKSceneArchiveCreateGeometryInPlace(
+    const AKSceneArchive *archive,
+    unsigned int index);
+
+/**
+ Releases a node geometry created in place, but not its vertices and indices
+ which belong to the archive.
+
+ @param geometry The node geometry, may be NULL.
+ */
+void AKSceneArchiveReleaseGeometryInPlace(AKNodeGeometry *geometry);
+
+/**
+ Creates a node skin with a copy of the bone weights and indices of a skin of
+ the archive.
+
+ @param archive The archive.
+ @param index The index of the skin.
+ @return A new node skin which must be released with AKNodeSkinRelease, or
+ NULL if the skin is out of the file.
+ */
+AKNodeSkin *AKSceneArchiveCreateSkin(const AKSceneArchive *archive,
+                                     unsigned int index);
+
+/**
+ Creates a node skin whose bone weights and indices are read in place from
+ the mapped file, without a copy.
+
+ @param archive The archive.
+ @param index The index of the skin.
+ @return A new node skin which must be released with
+ AKSceneArchiveReleaseSkinInPlace, or NULL if the skin is out of the file.
+ */
+AKNodeSkin *AKSceneArchiveCreateSkinInPlace(const AKSceneArchive *archive,
+                                            unsigned int index);
+
+/**
+ Releases a node skin created in place, but not its bone weights and indices
+ which belong to the archive.
+
+ @param skin The node skin, may be NULL.
+ */
+void AKSceneArchiveReleaseSkinInPlace(AKNodeSkin *skin);
+
+/**
+ Returns a camera.
+
+ @param archive The archive.
+ @param index The index of the camera, less than the number of cameras.
+ @return The camera.
+ */
+const AKArchiveCamera *AKSceneArchiveCameraAt(const AKSceneArchive *archive,
+                                              unsigned int index);
+
+/**
+ Returns a bone.
+
+ @param archive The archive.
+ @param index The index of the bone, less than the number of bones.
+ @return The bone.
+ */
+const AKArchiveBone *AKSceneArchiveBoneAt(const AKSceneArchive *archive,
+                                          unsigned int index);
+
+/**
+ Creates the animation tracks with a copy of the keyframes of an animation of
+ the archive.
+
+ @param archive The archive.
+ @param index The index of the animation.
+ @return New animation tracks which must be released with
+ AKAnimationTracksRelease, or NULL if the animation is out of the file.
+ */
+AKAnimationTracks *AKSceneArchiveCreateAnimationTracks(
+    const AKSceneArchive *archive,
+    unsigned int index);
+
+/**
+ Determines if the files which the scene was read from are unchanged: each
+ file which existed has the same size and bytes, and each missing file is
+ still missing.
+
+ @param archive The archive.
+ @return 1 if every file is unchanged, else 0.
+ */
+int AKSceneArchiveDependenciesAreCurrent(const AKSceneArchive *archive);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKSceneArchive_h */
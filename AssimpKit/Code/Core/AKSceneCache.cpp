@@ -0,0 +1,556 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSceneCache.h"
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ The file name suffix of the archives of a scene cache.
+ */
+static const char AKSceneCacheSuffix[] = "." AK_SCENE_ARCHIVE_EXTENSION;
+
+/**
+ The size of the chunks a file is read in to hash it.
+ */
+static const size_t AKKeyReadSize = 64 * 1024;
+
+/**
+ A directory of scene archives.
+ */
+struct AKSceneCache
+{
+    /**
+     The path of the directory.
+     */
+    std::string directory;
+
+    /**
+     The maximum total size of the archives, or 0 for no cap.
+     */
+    size_t maxBytes;
+
+    /**
+     The counts of the lookups.
+     */
+    AKSceneCacheStats stats;
+
+    /**
+     Serializes the lookups, the stores and the evictions.
+     */
+    std::mutex mutex;
+};
+
+/**
+ An archive in the directory of a scene cache.
+ */
+struct AKCacheEntry
+{
+    /**
+     The path of the archive.
+     */
+    std::string path;
+
+    /**
+     The size of the archive in bytes.
+     */
+    size_t size;
+
+    /**
+     The time the archive was last used, in nanoseconds.
+     */
+    long long usedTime;
+};
+
+#pragma mark - Scene keys
+
+/**
+ Makes the key of a scene before anything is added to it, which is the hash
+ of the version of the archive format and of AssimpKit.
+
+ @return The initial key.
+ */
+unsigned long long AKSceneCacheKeyMake(void)
+{
+    unsigned int formatVersion = AK_SCENE_ARCHIVE_VERSION;
+    unsigned long long key = 14695981039346656037ULL;
+    key = AKSceneCacheKeyAdd(key, &formatVersion, sizeof(formatVersion));
+    return AKSceneCacheKeyAdd(key, AK_VERSION_STRING,
+                              strlen(AK_VERSION_STRING));
+}
+
+/**
+ Adds bytes to the key of a scene with the 64 bit FNV-1a hash.
+
+ @param key The key.
+ @param bytes The bytes.
+ @param nBytes The number of bytes.
+ @return The new key.
+ */
+unsigned long long AKSceneCacheKeyAdd(unsigned long long key,
+                                      const void *bytes,
+                                      size_t nBytes)
+{
+    const unsigned char *data = (const unsigned char *)bytes;
+    for (size_t i = 0; i < nBytes; i++)
+    {
+        key = (key ^ data[i]) * 1099511628211ULL;
+    }
+    return key;
+}
+
+/**
+ Adds the bytes of a file to the key of a scene.
+
+ @param key The key, which is set to the new key.
+ @param path The path of the file.
+ @return Non zero if the file was read, else the key is unchanged.
+ */
+int AKSceneCacheKeyAddFile(unsigned long long *key, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return 0;
+    }
+    std::vector<unsigned char> buffer(AKKeyReadSize);
+    unsigned long long fileKey = *key;
+    size_t nRead;
+    while ((nRead = fread(&buffer[0], 1, buffer.size(), file)) > 0)
+    {
+        fileKey = AKSceneCacheKeyAdd(fileKey, &buffer[0], nRead);
+    }
+    bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed)
+    {
+        return 0;
+    }
+    *key = fileKey;
+    return 1;
+}
+
+/**
+ Adds the import options to the key of a scene, one field at a time so that
+ the key does not depend on the padding of the options.
+
+ @param key The key.
+ @param options The import options.
+ @return The new key.
+ */
+unsigned long long AKSceneCacheKeyAddOptions(unsigned long long key,
+                                             const AKImportOptions *options)
+{
+    key = AKSceneCacheKeyAdd(key, &options->splitVertexLimit,
+                             sizeof(options->splitVertexLimit));
+    key = AKSceneCacheKeyAdd(key, &options->splitTriangleLimit,
+                             sizeof(options->splitTriangleLimit));
+    key = AKSceneCacheKeyAdd(key, &options->maxBoneWeights,
+                             sizeof(options->maxBoneWeights));
+    key = AKSceneCacheKeyAdd(key, &options->vertexCacheSize,
+                             sizeof(options->vertexCacheSize));
+    key = AKSceneCacheKeyAdd(key, &options->maxSmoothingAngle,
+                             sizeof(options->maxSmoothingAngle));
+    key = AKSceneCacheKeyAdd(key, &options->favourSpeed,
+                             sizeof(options->favourSpeed));
+    return AKSceneCacheKeyAdd(key, &options->components,
+                              sizeof(options->components));
+}
+
+#pragma mark - Cache directory
+
+/**
+ Returns the path of the archive of a scene.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @return The path of the archive.
+ */
+static std::string archivePath(const AKSceneCache *cache,
+                               unsigned long long key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx%s", key, AKSceneCacheSuffix);
+    return cache->directory + "/" + name;
+}
+
+/**
+ Determines if a file name is the name of an archive.
+
+ @param name The file name.
+ @return true if the name ends with the archive suffix.
+ */
+static bool isArchiveName(const char *name)
+{
+    size_t length = strlen(name);
+    size_t suffixLength = sizeof(AKSceneCacheSuffix) - 1;
+    return length > suffixLength &&
+           strcmp(name + length - suffixLength, AKSceneCacheSuffix) == 0;
+}
+
+/**
+ Lists the archives in the directory of a cache.
+
+ @param cache The cache.
+ @return The archives, with their sizes and the times they were last used.
+ */
+static std::vector<AKCacheEntry> listEntries(const AKSceneCache *cache)
+{
+    std::vector<AKCacheEntry> entries;
+    DIR *dir = opendir(cache->directory.c_str());
+    if (dir == NULL)
+    {
+        return entries;
+    }
+    struct dirent *dirent;
+    while ((dirent = readdir(dir)) != NULL)
+    {
+        if (!isArchiveName(dirent->d_name))
+        {
+            continue;
+        }
+        AKCacheEntry entry;
+        entry.path = cache->directory + "/" + dirent->d_name;
+        struct stat info;
+        if (stat(entry.path.c_str(), &info) != 0)
+        {
+            continue;
+        }
+        entry.size = (size_t)info.st_size;
+#ifdef __APPLE__
+        const struct timespec *mtime = &info.st_mtimespec;
+#else
+        const struct timespec *mtime = &info.st_mtim;
+#endif
+        entry.usedTime = (long long)mtime->tv_sec * 1000000000LL +
+                         (long long)mtime->tv_nsec;
+        entries.push_back(entry);
+    }
+    closedir(dir);
+    return entries;
+}
+
+/**
+ Orders archives from the one used least recently.
+
+ @param a An archive.
+ @param b Another archive.
+ @return true if a was used before b.
+ */
+static bool usedBefore(const AKCacheEntry &a, const AKCacheEntry &b)
+{
+    if (a.usedTime != b.usedTime)
+    {
+        return a.usedTime < b.usedTime;
+    }
+    return a.path < b.path;
+}
+
+/**
+ Determines if a file is an archive of the current format version, from its
+ header.
+
+ @param path The path of the file.
+ @return true if the file has the magic and the version of an archive.
+ */
+static bool isCurrentArchive(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    AKArchiveHeader header;
+    bool current = fread(&header, 1, sizeof(header), file) == sizeof(header) &&
+                   memcmp(header.magic, "AKSCENE", 8) == 0 &&
+                   header.version == AK_SCENE_ARCHIVE_VERSION;
+    fclose(file);
+    return current;
+}
+
+/**
+ Creates a directory and its parent directories.
+
+ @param directory The path of the directory.
+ @return true if the directory exists.
+ */
+static bool makeDirectory(const std::string &directory)
+{
+    for (size_t slash = directory.find('/', 1); slash != std::string::npos;
+         slash = directory.find('/', slash + 1))
+    {
+        mkdir(directory.substr(0, slash).c_str(), 0755);
+    }
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        return false;
+    }
+    struct stat info;
+    return stat(directory.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+#pragma mark - Creating a scene cache
+
+/**
+ Creates a scene cache in a directory, creating the directory if it does not
+ exist, and removes the archives of another format version from it.
+
+ @param directory The path of the directory.
+ @param maxBytes The maximum total size of the archives, or 0 for no cap.
+ @return The new cache which must be released with AKSceneCacheRelease, or
+ NULL if the directory could not be created.
+ */
+AKSceneCache *AKSceneCacheCreate(const char *directory, size_t maxBytes)
+{
+    if (directory == NULL || directory[0] == 0 || !makeDirectory(directory))
+    {
+        return NULL;
+    }
+    AKSceneCache *cache = new AKSceneCache();
+    cache->directory = directory;
+    cache->maxBytes = maxBytes;
+    memset(&cache->stats, 0, sizeof(cache->stats));
+    std::vector<AKCacheEntry> entries = listEntries(cache);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (!isCurrentArchive(entries[i].path.c_str()))
+        {
+            remove(entries[i].path.c_str());
+            cache->stats.invalidations++;
+        }
+    }
+    return cache;
+}
+
+/**
+ Releases the scene cache, keeping its archives.
+
+ @param cache The cache, may be NULL.
+ */
+void AKSceneCacheRelease(AKSceneCache *cache)
+{
+    delete cache;
+}
+
+#pragma mark - Loading and storing scenes
+
+/**
+ Opens the archive of a scene, and marks it as the archive used most
+ recently. An archive is removed when it cannot be opened, or when a file
+ which the scene was read from has changed since it was stored.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @return The archive which must be released with AKSceneArchiveRelease, or
+ NULL if the cache has no valid archive of the scene.
+ */
+AKSceneArchive *AKSceneCacheOpen(AKSceneCache *cache, unsigned long long key)
+{
+    std::string path = archivePath(cache, key);
+    struct stat info;
+    AKSceneArchive *archive = NULL;
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        if (stat(path.c_str(), &info) != 0)
+        {
+            cache->stats.misses++;
+            return NULL;
+        }
+        archive = AKSceneArchiveOpen(path.c_str(), key);
+    }
+    // the side files are hashed without the lock, so that lookups of other
+    // scenes do not wait for them; the mapping stays valid if the archive is
+    // replaced meanwhile
+    bool current =
+        archive != NULL && AKSceneArchiveDependenciesAreCurrent(archive);
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    if (!current)
+    {
+        AKSceneArchiveRelease(archive);
+        // an archive stored by another thread since it was opened is kept
+        struct stat now;
+        if (stat(path.c_str(), &now) == 0 && now.st_ino == info.st_ino &&
+            now.st_dev == info.st_dev)
+        {
+            remove(path.c_str());
+        }
+        cache->stats.invalidations++;
+        cache->stats.misses++;
+        return NULL;
+    }
+    utimes(path.c_str(), NULL);
+    cache->stats.hits++;
+    return archive;
+}
+
+/**
+ Removes the archives used least recently until the cache is under its cap,
+ keeping the archive just stored.
+
+ @param cache The cache.
+ @param keep The path of the archive to keep.
+ */
+static void evict(AKSceneCache *cache, const std::string &keep)
+{
+    if (cache->maxBytes == 0)
+    {
+        return;
+    }
+    std::vector<AKCacheEntry> entries = listEntries(cache);
+    size_t totalBytes = 0;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        totalBytes += entries[i].size;
+    }
+    std::sort(entries.begin(), entries.end(), usedBefore);
+    for (size_t i = 0; i < entries.size() && totalBytes > cache->maxBytes;
+         i++)
+    {
+        if (entries[i].path == keep || remove(entries[i].path.c_str()) != 0)
+        {
+            continue;
+        }
+        totalBytes -= entries[i].size;
+        cache->stats.evictions++;
+    }
+}
+
+/**
+ Stores the archive of a scene, replacing any archive of the same key, and
+ then removes the archives used least recently until the cache is under its
+ cap.
+
+ The archive is written to a temporary file which is then renamed, so that an
+ archive is never read while it is written.
+
+ An archive larger than the cap is not stored.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @param writer The archive writer of the converted scene.
+ @return Non zero if the archive was stored.
+ */
+int AKSceneCacheStore(AKSceneCache *cache,
+                      unsigned long long key,
+                      const AKSceneArchiveWriter *writer)
+{
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    std::string path = archivePath(cache, key);
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%d.tmp", (int)getpid());
+    std::string tempPath = path + suffix;
+    size_t size = AKSceneArchiveWriterWriteFile(writer, tempPath.c_str());
+    if (size == 0)
+    {
+        return 0;
+    }
+    if ((cache->maxBytes != 0 && size > cache->maxBytes) ||
+        rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tempPath.c_str());
+        return 0;
+    }
+    cache->stats.stores++;
+    evict(cache, path);
+    return 1;
+}
+
+/**
+ Removes the archive of a scene.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ */
+void AKSceneCacheRemove(AKSceneCache *cache, unsigned long long key)
+{
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    remove(archivePath(cache, key).c_str());
+}
+
+/**
+ Removes every archive of the cache.
+
+ @param cache The cache.
+ */
+void AKSceneCacheRemoveAll(AKSceneCache *cache)
+{
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    std::vector<AKCacheEntry> entries = listEntries(cache);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        remove(entries[i].path.c_str());
+    }
+}
+
+#pragma mark - Statistics
+
+/**
+ Returns the total size of the archives of the cache.
+
+ @param cache The cache.
+ @return The size in bytes.
+ */
+size_t AKSceneCacheBytes(AKSceneCache *cache)
+{
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    std::vector<AKCacheEntry> entries = listEntries(cache);
+    size_t totalBytes = 0;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        totalBytes += entries[i].size;
+    }
+    return totalBytes;
+}
+
+/**
+ Returns the counts of the lookups of the cache since it was created.
+
+ @param cache The cache.
+ @return The counts.
+ */
+AKSceneCacheStats AKSceneCacheGetStats(AKSceneCache *cache)
+{
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    return cache->stats;
+}
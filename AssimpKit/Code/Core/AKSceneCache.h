@@ -0,0 +1,232 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKSceneCache_h
+#define AKSceneCache_h
+
+#include "AKImportOptions.h"
+#include "AKSceneArchive.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ A directory of scene archives of converted scenes, each named after the key
+ of its scene, so that a scene imported before is loaded from its archive
+ instead of being read and converted again.
+
+ The key of a scene is a hash of everything the converted scene depends on:
+ the bytes of the scene file, the post processing flags, the import options,
+ the conversion settings, the version of the archive format and the version
+ of AssimpKit. A change to any of them gives another key, and so misses the
+ archives made before it. The other files the scene was read from, such as
+ its material library, are listed in its archive, which is stale once any of
+ them changes.
+
+ The cache keeps the total size of its archives under a cap by removing the
+ archives used least recently when an archive is stored. An archive which
+ cannot be opened, because it is damaged or of another format version, is
+ removed when it is found. A cache can be used from several threads.
+ */
+typedef struct AKSceneCache AKSceneCache;
+
+/**
+ The version of AssimpKit, which is part of the key of every scene, so that
+ the scenes converted by another version are converted again.
+ */
+#define AK_VERSION_STRING "1.0"
+
+/**
+ The counts of the lookups of a scene cache.
+ */
+typedef struct AKSceneCacheStats
+{
+    /**
+     The number of scenes loaded from the cache.
+     */
+    unsigned long hits;
+
+    /**
+     The number of scenes not found in the cache.
+     */
+    unsigned long misses;
+
+    /**
+     The number of scenes stored in the cache.
+     */
+    unsigned long stores;
+
+    /**
+     The number of archives removed to keep the cache under its cap.
+     */
+    unsigned long evictions;
+
+    /**
+     The number of damaged archives, or archives of another version, removed.
+     */
+    unsigned long invalidations;
+} AKSceneCacheStats;
+
+#pragma mark - Scene keys
+
+/**
+ Makes the key of a scene before anything is added to it, which is the hash
+ of the version of the archive format and of AssimpKit.
+
+ @return The initial key.
+ */
+unsigned long long AKSceneCacheKeyMake(void);
+
+/**
+ Adds bytes to the key of a scene with the 64 bit FNV-1a hash.
+
+ @param key The key.
+ @param bytes The bytes.
+ @param nBytes The number of bytes.
+ @return The new key.
+ */
+unsigned long long AKSceneCacheKeyAdd(unsigned long long key,
+                                      const void *bytes,
+                                      size_t nBytes);
+
+/**
+ Adds the bytes of a file to the key of a scene.
+
+ @param key The key, which is set to the new key.
+ @param path The path of the file.
+ @return Non zero if the file was read, else the key is unchanged.
+ */
+int AKSceneCacheKeyAddFile(unsigned long long *key, const char *path);
+
+/**
+ Adds the import options to the key of a scene.
+
+ @param key The key.
+ @param options The import options.
+ @return The new key.
+ */
+unsigned long long AKSceneCacheKeyAddOptions(unsigned long long key,
+                                             const AKImportOptions *options);
+
+#pragma mark - Creating a scene cache
+
+/**
+ Creates a scene cache in a directory, creating the directory if it does not
+ exist, and removes the archives of another format version from it.
+
+ @param directory The path of the directory.
+ @param maxBytes The maximum total size of the archives, or 0 for no cap.
+ @return The new cache which must be released with AKSceneCacheRelease, or
+ NULL if the directory could not be created.
+ */
+AKSceneCache *AKSceneCacheCreate(const char *directory, size_t maxBytes);
+
+/**
+ Releases the scene cache, keeping its archives.
+
+ @param cache The cache, may be NULL.
+ */
+void AKSceneCacheRelease(AKSceneCache *cache);
+
+#pragma mark - Loading and storing scenes
+
+/**
+ Opens the archive of a scene, and marks it as the archive used most
+ recently. An archive is removed when it cannot be opened, or when a file
+ which the scene was read from has changed since it was stored.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @return The archive which must be released with AKSceneArchiveRelease, or
+ NULL if the cache has no valid archive of the scene.
+ */
+AKSceneArchive *AKSceneCacheOpen(AKSceneCache *cache, unsigned long long key);
+
+/**
+ Stores the archive of a scene, replacing any archive of the same key, and
+ then removes the archives used least recently until the cache is under its
+ cap.
+
+ An archive larger than the cap is not stored.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @param writer The archive writer of the converted scene.
+ @return Non zero if the archive was stored.
+ */
+int AKSceneCacheStore(AKSceneCache *cache,
+                      unsigned long long key,
+                      const AKSceneArchiveWriter *writer);
+
+/**
+ Removes the archive of a scene.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ */
+void AKSceneCacheRemove(AKSceneCache *cache, unsigned long long key);
+
+/**
+ Removes every archive of the cache.
+
+ @param cache The cache.
+ */
+void AKSceneCacheRemoveAll(AKSceneCache *cache);
+
+#pragma mark - Statistics
+
+/**
+ Returns the total size of the archives of the cache.
+
+ @param cache The cache.
+ @return The size in bytes.
+ */
+size_t AKSceneCacheBytes(AKSceneCache *cache);
+
+/**
+ Returns the counts of the lookups of the cache since it was created.
+
+ @param cache The cache.
+ @return The counts.
+ */
+AKSceneCacheStats AKSceneCacheGetStats(AKSceneCache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKSceneCache_h */
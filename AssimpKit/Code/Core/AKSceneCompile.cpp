@@ -0,0 +1,582 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSceneCompile.h"
+#include "AKBonePalette.h"
+#include "AKImportOptions.h"
+#include "AKMeshStats.h"
+#include "AKSceneGeometry.h"
+#include "assimp/material.h" // Material properties
+#include <map>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**
+ The number of texture types of each material.
+ */
+static const unsigned int AKNumTextureTypes = 10;
+
+/**
+ The texture types of each material, in the order the importer applies
+ them.
+ */
+static const enum aiTextureType AKTextureTypes[AKNumTextureTypes] = {
+    aiTextureType_DIFFUSE,      aiTextureType_SPECULAR,
+    aiTextureType_AMBIENT,      aiTextureType_EMISSIVE,
+    aiTextureType_REFLECTION,   aiTextureType_OPACITY,
+    aiTextureType_NORMALS,      aiTextureType_HEIGHT,
+    aiTextureType_DISPLACEMENT, aiTextureType_SHININESS};
+
+/**
+ The state of the conversion of a scene into a scene archive.
+ */
+struct AKSceneCompiler
+{
+    /**
+     The assimp scene.
+     */
+    const struct aiScene *aiScene;
+
+    /**
+     The parts of the scene to convert.
+     */
+    unsigned int components;
+
+    /**
+     The writer of the archive.
+     */
+    AKSceneArchiveWriter *writer;
+
+    /**
+     The node geometries, taken as each node is added, or NULL without the
+     geometry.
+     */
+    AKSceneGeometry *sceneGeometry;
+
+    /**
+     The scene statistics.
+     */
+    AKSceneStats *stats;
+
+    /**
+     The bone palette, or NULL without the skinning and the animations.
+     */
+    AKBonePalette *palette;
+
+    /**
+     The parent of each node added, AKArchiveNone for the root node.
+     */
+    std::vector<unsigned int> parents;
+
+    /**
+     The depth of each node added, 1 for the root node.
+     */
+    std::vector<int> depths;
+
+    /**
+     The first node added with each name.
+     */
+    std::map<std::string, unsigned int> nodeIndex;
+
+    /**
+     The inverse bind transform of each bone, by the name of the bone.
+     */
+    std::map<std::string, std::vector<float> > boneTransforms;
+};
+
+#pragma mark - Transforms
+
+/**
+ Copies an assimp matrix into the scenekit matrix components m11, m12 ...
+ m44 of a transform of the archive.
+
+ @param m The assimp matrix.
+ @param transform The 16 components of the transform.
+ */
+static void copyTransform(const aiMatrix4x4 &m, float *transform)
+{
+    const float components[16] = {m.a1, m.b1, m.c1, m.d1, m.a2, m.b2,
+                                  m.c2, m.d2, m.a3, m.b3, m.c3, m.d3,
+                                  m.a4, m.b4, m.c4, m.d4};
+    memcpy(transform, components, sizeof(components));
+}
+
+#pragma mark - Materials
+
+/**
+ Returns the last path component of a texture path.
+
+ @param path The texture path.
+ @return The name of the texture file, empty if the path has none.
+ */
+static std::string lastPathComponent(const char *path)
+{
+    std::string name = path;
+    while (name.size() > 1 && name[name.size() - 1] == '/')
+    {
+        name.erase(name.size() - 1);
+    }
+    size_t slash = name.rfind('/');
+    return slash == std::string::npos || name.size() == 1
+               ? name
+               : name.substr(slash + 1);
+}
+
+/**
+ Gets the color of a material property, for the texture types which have one.
+
+ @param aiMaterial The assimp material.
+ @param textureType The texture type of the property.
+ @param color Receives the rgba color.
+ @return true if the property has a color.
+ */
+static bool getSlotColor(const struct aiMaterial *aiMaterial,
+                         enum aiTextureType textureType,
+                         float *color)
+{
+    aiColor4D aiColor;
+    aiReturn found = aiReturn_FAILURE;
+    switch (textureType)
+    {
+    case aiTextureType_DIFFUSE:
+        found = aiGetMaterialColor(aiMaterial, AI_MATKEY_COLOR_DIFFUSE,
+                                   &aiColor);
+        break;
+    case aiTextureType_SPECULAR:
+        found = aiGetMaterialColor(aiMaterial, AI_MATKEY_COLOR_SPECULAR,
+                                   &aiColor);
+        break;
+    case aiTextureType_AMBIENT:
+        found = aiGetMaterialColor(aiMaterial, AI_MATKEY_COLOR_AMBIENT,
+                                   &aiColor);
+        break;
+    case aiTextureType_REFLECTION:
+        found = aiGetMaterialColor(aiMaterial, AI_MATKEY_COLOR_REFLECTIVE,
+                                   &aiColor);
+        break;
+    case aiTextureType_EMISSIVE:
+        found = aiGetMaterialColor(aiMaterial, AI_MATKEY_COLOR_EMISSIVE,
+                                   &aiColor);
+        break;
+    case aiTextureType_OPACITY:
+        found = aiGetMaterialColor(aiMaterial, AI_MATKEY_COLOR_TRANSPARENT,
+                                   &aiColor);
+        break;
+    default:
+        break;
+    }
+    if (found != AI_SUCCESS)
+    {
+        return false;
+    }
+    color[0] = aiColor.r;
+    color[1] = aiColor.g;
+    color[2] = aiColor.b;
+    color[3] = aiColor.a;
+    return true;
+}
+
+/**
+ Adds a property of a material to the archive, showing its first texture if
+ it has one and textures are converted, else its color.
+
+ A texture is embedded if the scene embeds any texture, and is then the
+ texture its *N path refers to, or the texture at the index of the material
+ otherwise. Only the embedded textures in a compressed file format are
+ copied, as only those are made into images.
+
+ @param compiler The compiler.
+ @param material The index of the material.
+ @param textureType The texture type of the property.
+ */
+static void addMaterialSlot(AKSceneCompiler *compiler,
+                            unsigned int material,
+                            enum aiTextureType textureType)
+{
+    const struct aiScene *aiScene = compiler->aiScene;
+    const struct aiMaterial *aiMaterial = aiScene->mMaterials[material];
+    bool loadsTextures =
+        (compiler->components & AKImportComponentTextures) != 0;
+    struct aiString aiPath;
+    aiPath.length = 0;
+    aiPath.data[0] = '\0';
+    if (loadsTextures && aiGetMaterialTextureCount(aiMaterial, textureType) > 0)
+    {
+        aiGetMaterialTexture(aiMaterial, textureType, 0, &aiPath, NULL, NULL,
+                             NULL, NULL, NULL, NULL);
+    }
+    std::string name = lastPathComponent(aiPath.data);
+    if (name.empty())
+    {
+        float color[4];
+        bool hasColor = getSlotColor(aiMaterial, textureType, color);
+        AKSceneArchiveWriterAddMaterialSlot(
+            compiler->writer, material, textureType, AKMaterialSlotColor,
+            hasColor ? color : NULL, AKArchiveNone, NULL);
+    }
+    else if (aiScene->mNumTextures > 0)
+    {
+        unsigned int texture =
+            name[0] == '*' ? (unsigned int)atoi(aiPath.data + 1) : material;
+        if (texture >= aiScene->mNumTextures)
+        {
+            texture = aiScene->mNumTextures - 1;
+        }
+        const struct aiTexture *aiTexture = aiScene->mTextures[texture];
+        if (aiTexture->mHeight == 0)
+        {
+            AKSceneArchiveWriterSetTexture(compiler->writer, texture,
+                                           aiTexture->pcData,
+                                           aiTexture->mWidth,
+                                           aiTexture->achFormatHint);
+        }
+        AKSceneArchiveWriterAddMaterialSlot(
+            compiler->writer, material, textureType,
+            AKMaterialSlotEmbeddedTexture, NULL, texture, NULL);
+    }
+    else
+    {
+        AKSceneArchiveWriterAddMaterialSlot(
+            compiler->writer, material, textureType,
+            AKMaterialSlotExternalTexture, NULL, AKArchiveNone, aiPath.data);
+    }
+}
+
+/**
+ Adds a material to the archive with its properties, its blend mode and its
+ multiply color, which is its transparent color if the color has no zero
+ component.
+
+ @param compiler The compiler.
+ @param material The index of the material.
+ */
+static void addMaterial(AKSceneCompiler *compiler, unsigned int material)
+{
+    const struct aiMaterial *aiMaterial =
+        compiler->aiScene->mMaterials[material];
+    struct aiString name;
+    name.length = 0;
+    name.data[0] = '\0';
+    aiGetMaterialString(aiMaterial, AI_MATKEY_NAME, &name);
+    aiColor4D color;
+    aiReturn found =
+        aiGetMaterialColor(aiMaterial, AI_MATKEY_COLOR_TRANSPARENT, &color);
+    bool hasMultiply = found == AI_SUCCESS && color.r != 0 && color.g != 0 &&
+                       color.b != 0;
+    float multiply[4];
+    multiply[0] = color.r;
+    multiply[1] = color.g;
+    multiply[2] = color.b;
+    multiply[3] = color.a;
+    int blendMode = 0;
+    aiGetMaterialIntegerArray(aiMaterial, AI_MATKEY_BLEND_FUNC, &blendMode,
+                              NULL);
+    AKSceneArchiveWriterSetMaterial(compiler->writer, material, name.data,
+                                    (unsigned int)blendMode,
+                                    hasMultiply ? multiply : NULL);
+    for (unsigned int i = 0; i < AKNumTextureTypes; i++)
+    {
+        addMaterialSlot(compiler, material, AKTextureTypes[i]);
+    }
+}
+
+/**
+ Adds the materials of the meshes of a node to the archive, each material
+ once. A mesh whose material is not in the scene has none.
+
+ @param compiler The compiler.
+ @param aiNode The assimp node.
+ */
+static void addMaterials(AKSceneCompiler *compiler,
+                         const struct aiNode *aiNode)
+{
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        unsigned int mesh = aiNode->mMeshes[i];
+        unsigned int material =
+            compiler->aiScene->mMeshes[mesh]->mMaterialIndex;
+        if (material >= compiler->aiScene->mNumMaterials)
+        {
+            continue;
+        }
+        AKSceneArchiveWriterSetMeshMaterial(compiler->writer, mesh, material);
+        if (!AKSceneArchiveWriterHasMaterial(compiler->writer, material))
+        {
+            addMaterial(compiler, material);
+        }
+    }
+}
+
+#pragma mark - Nodes
+
+/**
+ Records the inverse bind transforms of the bones of the meshes of a node.
+ The first transform of a bone in the meshes of the node is kept, and replaces
+ the transform recorded for the bone by the nodes before.
+
+ @param compiler The compiler.
+ @param aiNode The assimp node.
+ */
+static void addBoneTransforms(AKSceneCompiler *compiler,
+                              const struct aiNode *aiNode)
+{
+    std::map<std::string, std::vector<float> > nodeTransforms;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh =
+            compiler->aiScene->mMeshes[aiNode->mMeshes[i]];
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            const struct aiBone *aiBone = aiMesh->mBones[j];
+            std::vector<float> &transform = nodeTransforms[aiBone->mName.data];
+            if (transform.empty())
+            {
+                transform.resize(16);
+                copyTransform(aiBone->mOffsetMatrix, &transform[0]);
+            }
+        }
+    }
+    for (std::map<std::string, std::vector<float> >::const_iterator it =
+             nodeTransforms.begin();
+         it != nodeTransforms.end(); ++it)
+    {
+        compiler->boneTransforms[it->first] = it->second;
+    }
+}
+
+/**
+ Adds a node and its children to the archive, in pre-order.
+
+ @param compiler The compiler.
+ @param aiNode The assimp node.
+ @param parent The parent node, or AKArchiveNone for the root node.
+ */
+static void addNode(AKSceneCompiler *compiler,
+                    const struct aiNode *aiNode,
+                    unsigned int parent)
+{
+    const struct aiScene *aiScene = compiler->aiScene;
+    float transform[16];
+    copyTransform(aiNode->mTransformation, transform);
+    unsigned int node = AKSceneArchiveWriterAddNode(
+        compiler->writer, aiNode->mName.data, parent, transform,
+        aiNode->mMeshes, aiNode->mNumMeshes);
+    compiler->parents.push_back(parent);
+    compiler->depths.push_back(
+        parent == AKArchiveNone ? 1 : compiler->depths[parent] + 1);
+    compiler->nodeIndex.insert(std::make_pair(aiNode->mName.data, node));
+
+    AKNodeGeometry *geometry =
+        compiler->sceneGeometry != NULL
+            ? AKSceneGeometryTake(compiler->sceneGeometry, aiNode)
+            : NULL;
+    if (geometry != NULL)
+    {
+        AKSceneArchiveWriterSetGeometry(compiler->writer, node, geometry);
+        AKNodeGeometryRelease(geometry);
+        if (compiler->components & AKImportComponentMaterials)
+        {
+            addMaterials(compiler, aiNode);
+        }
+        if (compiler->components & AKImportComponentSkinning)
+        {
+            AKNodeSkin *skin = AKNodeSkinCreateWithStats(
+                aiNode, aiScene, compiler->palette, compiler->stats);
+            if (skin != NULL)
+            {
+                AKSceneArchiveWriterSetSkin(compiler->writer, node, skin);
+                AKNodeSkinRelease(skin);
+            }
+        }
+    }
+    if (compiler->components & AKImportComponentCameras)
+    {
+        for (unsigned int i = 0; i < aiScene->mNumCameras; i++)
+        {
+            const struct aiCamera *aiCamera = aiScene->mCameras[i];
+            if (strcmp(aiCamera->mName.data, aiNode->mName.data) == 0)
+            {
+                AKSceneArchiveWriterSetCamera(
+                    compiler->writer, node, aiCamera->mHorizontalFOV,
+                    aiCamera->mClipPlaneNear, aiCamera->mClipPlaneFar);
+                break;
+            }
+        }
+    }
+    if (compiler->palette != NULL)
+    {
+        addBoneTransforms(compiler, aiNode);
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        if (aiNode->mChildren[i] != NULL)
+        {
+            addNode(compiler, aiNode->mChildren[i], node);
+        }
+    }
+}
+
+#pragma mark - Skeleton
+
+/**
+ Finds the root of the skeleton from the bone nodes, as the importer does: the
+ bone node of the least depth if it is the only one of that depth, else its
+ parent.
+
+ @param compiler The compiler, with every node added.
+ @return The node of the root of the skeleton, or AKArchiveNone if the
+ skeleton is the root of the scene or the scene has no bones.
+ */
+static unsigned int findSkeletonNode(const AKSceneCompiler *compiler)
+{
+    std::map<int, std::vector<unsigned int> > nodeDepths;
+    int minDepth = -1;
+    for (unsigned int i = 0; i < AKBonePaletteCount(compiler->palette); i++)
+    {
+        std::map<std::string, unsigned int>::const_iterator found =
+            compiler->nodeIndex.find(AKBonePaletteName(compiler->palette, i));
+        if (found == compiler->nodeIndex.end())
+        {
+            continue;
+        }
+        int depth = compiler->depths[found->second];
+        if (minDepth == -1 || depth <= minDepth)
+        {
+            minDepth = depth;
+            nodeDepths[minDepth].push_back(found->second);
+        }
+    }
+    if (minDepth == -1)
+    {
+        return AKArchiveNone;
+    }
+    const std::vector<unsigned int> &minDepthNodes = nodeDepths[minDepth];
+    return minDepthNodes.size() > 1 ? compiler->parents[minDepthNodes[0]]
+                                    : minDepthNodes[0];
+}
+
+/**
+ Adds the bones of the bone palette with their inverse bind transforms, and
+ the root of the skeleton.
+
+ @param compiler The compiler, with every node added.
+ */
+static void addSkeleton(AKSceneCompiler *compiler)
+{
+    const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0,
+                                0, 0, 1, 0, 0, 0, 0, 1};
+    for (unsigned int i = 0; i < AKBonePaletteCount(compiler->palette); i++)
+    {
+        const char *name = AKBonePaletteName(compiler->palette, i);
+        std::map<std::string, std::vector<float> >::const_iterator found =
+            compiler->boneTransforms.find(name);
+        AKSceneArchiveWriterAddBone(compiler->writer, name,
+                                    found != compiler->boneTransforms.end()
+                                        ? &found->second[0]
+                                        : identity);
+    }
+    AKSceneArchiveWriterSetSkeleton(compiler->writer,
+                                    findSkeletonNode(compiler));
+}
+
+#pragma mark - Compiling a scene
+
+/**
+ Converts an assimp scene into a scene archive without scenekit, as the
+ importer records the scene it converts into the archive of a scene cache, so
+ that the scene can be converted ahead of time on any platform.
+
+ The nodes are added in pre-order, each with the whole geometry of its meshes
+ and the skin of the geometry. The materials of the meshes get the colors and
+ the textures the importer picks for their properties, and the textures
+ embedded in the scene in a compressed file format are copied into the
+ archive. The bones are in the order of the bone palette of the scene, with
+ the root of the skeleton found from the depths of the bone nodes, and the
+ animations are in the order of the scene.
+
+ Requires the assimp library, to read the material properties.
+
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default vertex layout.
+ @param components The parts of the scene to convert, a combination of
+ AKImportComponent flags.
+ @param key The key of the converted scene, stored in the header.
+ @return A new writer which must be released with
+ AKSceneArchiveWriterRelease.
+ */
+AKSceneArchiveWriter *AKSceneCompile(const struct aiScene *aiScene,
+                                     const AKVertexLayout *layout,
+                                     unsigned int components,
+                                     unsigned long long key)
+{
+    AKSceneCompiler compiler;
+    compiler.aiScene = aiScene;
+    compiler.components = components;
+    compiler.writer = AKSceneArchiveWriterCreate(key);
+    compiler.stats = AKSceneStatsCreate(aiScene);
+    compiler.sceneGeometry =
+        components & AKImportComponentGeometry
+            ? AKSceneGeometryCreate(aiScene, layout, compiler.stats, NULL,
+                                    NULL)
+            : NULL;
+    compiler.palette =
+        components & (AKImportComponentSkinning | AKImportComponentAnimations)
+            ? AKBonePaletteCreate(aiScene)
+            : NULL;
+    if (aiScene->mRootNode != NULL)
+    {
+        addNode(&compiler, aiScene->mRootNode, AKArchiveNone);
+    }
+    if (compiler.palette != NULL)
+    {
+        addSkeleton(&compiler);
+    }
+    if (components & AKImportComponentAnimations)
+    {
+        for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+        {
+            AKAnimationTracks *tracks =
+                AKAnimationTracksCreate(aiScene->mAnimations[i]);
+            AKSceneArchiveWriterAddAnimation(compiler.writer, tracks);
+            AKAnimationTracksRelease(tracks);
+        }
+    }
+    AKBonePaletteRelease(compiler.palette);
+    AKSceneGeometryRelease(compiler.sceneGeometry);
+    AKSceneStatsRelease(compiler.stats);
+    return compiler.writer;
+}
@@ -0,0 +1,81 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKSceneCompile_h
+#define AKSceneCompile_h
+
+#include "AKGeometry.h"
+#include "AKSceneArchive.h"
+#include "assimp/scene.h" // Output data structure
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Compiling a scene
+
+/**
+ Converts an assimp scene into a scene archive without scenekit, as the
+ importer records the scene it converts into the archive of a scene cache, so
+ that the scene can be converted ahead of time on any platform.
+
+ The nodes are added in pre-order, each with the whole geometry of its meshes
+ and the skin of the geometry. The materials of the meshes get the colors and
+ the textures the importer picks for their properties, and the textures
+ embedded in the scene in a compressed file format are copied into the
+ archive. The bones are in the order of the bone palette of the scene, with
+ the root of the skeleton found from the depths of the bone nodes, and the
+ animations are in the order of the scene.
+
+ Requires the assimp library, to read the material properties.
+
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default vertex layout.
+ @param components The parts of the scene to convert, a combination of
+ AKImportComponent flags.
+ @param key The key of the converted scene, stored in the header.
+ @return A new writer which must be released with
+ AKSceneArchiveWriterRelease.
+ */
+AKSceneArchiveWriter *AKSceneCompile(const struct aiScene *aiScene,
+                                     const AKVertexLayout *layout,
+                                     unsigned int components,
+                                     unsigned long long key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKSceneCompile_h */
@@ -0,0 +1,322 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSceneGeometry.h"
+#include <map>
+#include <vector>
+
+/**
+ The node geometries of every node of a scene.
+ */
+struct AKSceneGeometry
+{
+    /**
+     The nodes of the scene in pre-order.
+     */
+    std::vector<const struct aiNode *> nodes;
+
+    /**
+     The geometry slot of each node, NULL if the node has no vertices or its
+     geometry was taken.
+     */
+    std::vector<AKNodeGeometry *> geometries;
+
+    /**
+     The slot of each node.
+     */
+    std::map<const struct aiNode *, unsigned int> slots;
+};
+
+/**
+ The conversion of the nodes of a scene shared by the workers.
+ */
+struct AKSceneGeometryConversion
+{
+    /**
+     The scene geometry with the slots to convert into.
+     */
+    AKSceneGeometry *sceneGeometry;
+
+    /**
+     The assimp scene.
+     */
+    const struct aiScene *aiScene;
+
+    /**
+     The vertex layout, or NULL for the default layout.
+     */
+    const AKVertexLayout *layout;
+
+    /**
+     The scene statistics, or NULL.
+     */
+    const AKSceneStats *stats;
+
+    /**
+     The progress of the import, or NULL.
+     */
+    AKProgress *progress;
+};
+
+/**
+ Adds a node and its children to the nodes of the scene geometry in
+ pre-order.
+
+ @param aiNode The assimp node.
+ @param sceneGeometry The scene geometry.
+ */
+static void addNodes(const struct aiNode *aiNode,
+                     AKSceneGeometry *sceneGeometry)
+{
+    if (aiNode == NULL)
+    {
+        return;
+    }
+    sceneGeometry->slots[aiNode] = (unsigned int)sceneGeometry->nodes.size();
+    sceneGeometry->nodes.push_back(aiNode);
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        addNodes(aiNode->mChildren[i], sceneGeometry);
+    }
+}
+
+/**
+ Converts the geometry of a node into its slot, on a worker of the pool.
+
+ @param context The conversion.
+ @param item The index of the node.
+ @param worker The index of the worker.
+ */
+static void convertNode(void *context, size_t item, unsigned int worker)
+{
+    AKSceneGeometryConversion *conversion =
+        (AKSceneGeometryConversion *)context;
+    AKSceneGeometry *sceneGeometry = conversion->sceneGeometry;
+    if (!AKProgressCheckpoint(conversion->progress))
+    {
+        return;
+    }
+    sceneGeometry->geometries[item] = AKNodeGeometryCreateWithProgress(
+        sceneGeometry->nodes[item], conversion->aiScene, conversion->layout,
+        conversion->stats, conversion->progress);
+}
+
+#pragma mark - Converting the geometry of a scene
+
+/**
+ Converts the geometry of every node of the scene on the workers of a work
+ pool, with the number of vertices of each node as its cost.
+
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default layout.
+ @param stats The scene statistics, or NULL to compute them for each mesh.
+ @param progress The progress of the import, advanced by every worker, or
+ NULL.
+ @param pool The work pool, or NULL to convert the nodes on the calling
+ thread.
+ @return The new scene geometry which must be released with
+ AKSceneGeometryRelease. If the import is cancelled, the nodes which were not
+ converted have no geometry.
+ */
+AKSceneGeometry *AKSceneGeometryCreate(const struct aiScene *aiScene,
+                                       const AKVertexLayout *layout,
+                                       const AKSceneStats *stats,
+                                       AKProgress *progress,
+                                       AKWorkPool *pool)
+{
+    AKSceneGeometry *sceneGeometry = new AKSceneGeometry;
+    addNodes(aiScene->mRootNode, sceneGeometry);
+    size_t nNodes = sceneGeometry->nodes.size();
+    sceneGeometry->geometries.assign(nNodes, NULL);
+    AKSceneGeometryConversion conversion = {sceneGeometry, aiScene, layout,
+                                            stats, progress};
+    if (pool == NULL)
+    {
+        for (size_t i = 0; i < nNodes; i++)
+        {
+            convertNode(&conversion, i, 0);
+        }
+        return sceneGeometry;
+    }
+    std::vector<size_t> costs(nNodes, 1);
+    for (size_t i = 0; i < nNodes; i++)
+    {
+        const struct aiNode *aiNode = sceneGeometry->nodes[i];
+        for (unsigned int j = 0; j < aiNode->mNumMeshes; j++)
+        {
+            costs[i] += aiScene->mMeshes[aiNode->mMeshes[j]]->mNumVertices;
+        }
+    }
+    AKWorkPoolRun(pool, nNodes, costs.data(), convertNode, &conversion);
+    return sceneGeometry;
+}
+
+/**
+ Releases the scene geometry and the node geometries it still owns.
+
+ @param sceneGeometry The scene geometry, may be NULL.
+ */
+void AKSceneGeometryRelease(AKSceneGeometry *sceneGeometry)
+{
+    if (sceneGeometry == NULL)
+    {
+        return;
+    }
+    for (size_t i = 0; i < sceneGeometry->geometries.size(); i++)
+    {
+        AKNodeGeometryRelease(sceneGeometry->geometries[i]);
+    }
+    delete sceneGeometry;
+}
+
+#pragma mark - Node geometries
+
+/**
+ Returns the number of nodes of the scene.
+
+ @param sceneGeometry The scene geometry.
+ @return The number of nodes.
+ */
+unsigned int AKSceneGeometryNodeCount(const AKSceneGeometry *sceneGeometry)
+{
+    return (unsigned int)sceneGeometry->nodes.size();
+}
+
+/**
+ Returns a node of the scene in pre-order.
+
+ @param sceneGeometry The scene geometry.
+ @param index The index of the node, less than the number of nodes.
+ @return The assimp node.
+ */
+const struct aiNode *AKSceneGeometryNodeAt(const AKSceneGeometry *sceneGeometry,
+                                           unsigned int index)
+{
+    return sceneGeometry->nodes[index];
+}
+
+/**
+ Returns the geometry of a node of the scene in pre-order.
+
+ @param sceneGeometry The scene geometry.
+ @param index The index of the node, less than the number of nodes.
+ @return The node geometry, or NULL if the node has no vertices or its
+ geometry was taken.
+ */
+const AKNodeGeometry *AKSceneGeometryAt(const AKSceneGeometry *sceneGeometry,
+                                        unsigned int index)
+{
+    return sceneGeometry->geometries[index];
+}
+
+/**
+ Takes the geometry of a node out of the scene geometry.
+
+ @param sceneGeometry The scene geometry.
+ @param aiNode The assimp node.
+ @return The node geometry which must be released with AKNodeGeometryRelease,
+ or NULL if the node has no vertices, is not a node of the scene or its
+ geometry was taken.
+ */
+AKNodeGeometry *AKSceneGeometryTake(AKSceneGeometry *sceneGeometry,
+                                    const struct aiNode *aiNode)
+{
+    std::map<const struct aiNode *, unsigned int>::const_iterator slot =
+        sceneGeometry->slots.find(aiNode);
+    if (slot == sceneGeometry->slots.end())
+    {
+        return NULL;
+    }
+    AKNodeGeometry *geometry = sceneGeometry->geometries[slot->second];
+    sceneGeometry->geometries[slot->second] = NULL;
+    return geometry;
+}
+
+#pragma mark - Verifying a conversion
+
+/**
+ Adds bytes to a 64 bit FNV-1a hash.
+
+ @param hash The hash.
+ @param bytes The bytes.
+ @param nBytes The number of bytes.
+ @return The new hash.
+ */
+static unsigned long long hashBytes(unsigned long long hash,
+                                    const void *bytes,
+                                    size_t nBytes)
+{
+    const unsigned char *data = (const unsigned char *)bytes;
+    for (size_t i = 0; i < nBytes; i++)
+    {
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ Hashes the vertices and indices of every node geometry of the scene, in the
+ order of the nodes, to compare the conversions of a scene.
+
+ @param sceneGeometry The scene geometry.
+ @return The 64 bit FNV-1a hash of the node geometries.
+ */
+unsigned long long AKSceneGeometryHash(const AKSceneGeometry *sceneGeometry)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < sceneGeometry->geometries.size(); i++)
+    {
+        const AKNodeGeometry *geometry = sceneGeometry->geometries[i];
+        unsigned int nVertices = geometry != NULL ? geometry->nVertices : 0;
+        hash = hashBytes(hash, &nVertices, sizeof(nVertices));
+        if (geometry == NULL)
+        {
+            continue;
+        }
+        hash = hashBytes(hash, geometry->vertexData,
+                         (size_t)geometry->nVertices * geometry->vertexStride);
+        for (unsigned int j = 0; j < geometry->nElements; j++)
+        {
+            const AKGeometryElement *element = &geometry->elements[j];
+            if (element->indices != NULL)
+            {
+                hash = hashBytes(hash, element->indices,
+                                 (size_t)element->nIndices *
+                                     element->bytesPerIndex);
+            }
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,148 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKSceneGeometry_h
+#define AKSceneGeometry_h
+
+#include "AKGeometry.h"
+#include "AKMeshStats.h"
+#include "AKProgress.h"
+#include "AKWorkPool.h"
+#include "assimp/scene.h" // Output data structure
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ The node geometries of every node of a scene, converted in parallel.
+
+ Each node has a slot, allocated before the conversion in the pre-order of the
+ node hierarchy, which its geometry is written to by whichever worker
+ converts it. As a node geometry depends on nothing but its node, the slots
+ hold the same geometries in the same order however many workers convert
+ them, so the scene geometry is the same as one converted serially.
+ */
+typedef struct AKSceneGeometry AKSceneGeometry;
+
+#pragma mark - Converting the geometry of a scene
+
+/**
+ Converts the geometry of every node of the scene on the workers of a work
+ pool, with the number of vertices of each node as its cost.
+
+ @param aiScene The assimp scene.
+ @param layout The vertex layout, or NULL for the default layout.
+ @param stats The scene statistics, or NULL to compute them for each mesh.
+ @param progress The progress of the import, advanced by every worker, or
+ NULL.
+ @param pool The work pool, or NULL to convert the nodes on the calling
+ thread.
+ @return The new scene geometry which must be released with
+ AKSceneGeometryRelease. If the import is cancelled, the nodes which were not
+ converted have no geometry.
+ */
+AKSceneGeometry *AKSceneGeometryCreate(const struct aiScene *aiScene,
+                                       const AKVertexLayout *layout,
+                                       const AKSceneStats *stats,
+                                       AKProgress *progress,
+                                       AKWorkPool *pool);
+
+/**
+ Releases the scene geometry and the node geometries it still owns.
+
+ @param sceneGeometry The scene geometry, may be NULL.
+ */
+void AKSceneGeometryRelease(AKSceneGeometry *sceneGeometry);
+
+#pragma mark - Node geometries
+
+/**
+ Returns the number of nodes of the scene.
+
+ @param sceneGeometry The scene geometry.
+ @return The number of nodes.
+ */
+unsigned int AKSceneGeometryNodeCount(const AKSceneGeometry *sceneGeometry);
+
+/**
+ Returns a node of the scene in pre-order.
+
+ @param sceneGeometry The scene geometry.
+ @param index The index of the node, less than the number of nodes.
+ @return The assimp node.
+ */
+const struct aiNode *AKSceneGeometryNodeAt(const AKSceneGeometry *sceneGeometry,
+                                           unsigned int index);
+
+/**
+ Returns the geometry of a node of the scene in pre-order.
+
+ @param sceneGeometry The scene geometry.
+ @param index The index of the node, less than the number of nodes.
+ @return The node geometry, or NULL if the node has no vertices or its
+ geometry was taken.
+ */
+const AKNodeGeometry *AKSceneGeometryAt(const AKSceneGeometry *sceneGeometry,
+                                        unsigned int index);
+
+/**
+ Takes the geometry of a node out of the scene geometry.
+
+ @param sceneGeometry The scene geometry.
+ @param aiNode The assimp node.
+ @return The node geometry which must be released with AKNodeGeometryRelease,
+ or NULL if the node has no vertices, is not a node of the scene or its
+ geometry was taken.
+ */
+AKNodeGeometry *AKSceneGeometryTake(AKSceneGeometry *sceneGeometry,
+                                    const struct aiNode *aiNode);
+
+#pragma mark - Verifying a conversion
+
+/**
+ Hashes the vertices and indices of every node geometry of the scene, in the
+ order of the nodes, to compare the conversions of a scene.
+
+ @param sceneGeometry The scene geometry.
+ @return The 64 bit FNV-1a hash of the node geometries.
+ */
+unsigned long long AKSceneGeometryHash(const AKSceneGeometry *sceneGeometry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKSceneGeometry_h */
@@ -0,0 +1,270 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSceneTrim.h"
+#include <vector>
+
+/**
+ The progressive release of the bulk data of an assimp scene.
+ */
+struct AKSceneTrim
+{
+    /**
+     The assimp scene, trimmed in place.
+     */
+    struct aiScene *aiScene;
+
+    /**
+     The number of nodes left to convert which use each mesh.
+     */
+    std::vector<unsigned int> meshUses;
+
+    /**
+     The bytes freed so far.
+     */
+    size_t freedBytes;
+};
+
+/**
+ Counts the uses of the meshes by a node and its children.
+
+ @param aiNode The assimp node.
+ @param meshUses The uses of each mesh.
+ */
+static void countMeshUses(const struct aiNode *aiNode,
+                          std::vector<unsigned int> *meshUses)
+{
+    if (aiNode == NULL)
+    {
+        return;
+    }
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        if (aiNode->mMeshes[i] < meshUses->size())
+        {
+            (*meshUses)[aiNode->mMeshes[i]]++;
+        }
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        countMeshUses(aiNode->mChildren[i], meshUses);
+    }
+}
+
+/**
+ Frees a vertex attribute array of a mesh.
+
+ @param attribute The array, set to NULL.
+ @param nVertices The number of vertices of the mesh.
+ @return The bytes freed.
+ */
+template <typename T>
+static size_t freeAttribute(T **attribute, unsigned int nVertices)
+{
+    if (*attribute == NULL)
+    {
+        return 0;
+    }
+    delete[] * attribute;
+    *attribute = NULL;
+    return nVertices * sizeof(T);
+}
+
+/**
+ Frees the vertices, faces and bone weights of a mesh. The bones keep their
+ names and offset matrices.
+
+ @param aiMesh The assimp mesh.
+ @return The bytes freed.
+ */
+static size_t trimMesh(struct aiMesh *aiMesh)
+{
+    unsigned int nVertices = aiMesh->mNumVertices;
+    size_t bytes = freeAttribute(&aiMesh->mVertices, nVertices);
+    bytes += freeAttribute(&aiMesh->mNormals, nVertices);
+    bytes += freeAttribute(&aiMesh->mTangents, nVertices);
+    bytes += freeAttribute(&aiMesh->mBitangents, nVertices);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; i++)
+    {
+        bytes += freeAttribute(&aiMesh->mTextureCoords[i], nVertices);
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; i++)
+    {
+        bytes += freeAttribute(&aiMesh->mColors[i], nVertices);
+    }
+    aiMesh->mNumVertices = 0;
+    if (aiMesh->mFaces != NULL)
+    {
+        for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
+        {
+            bytes += aiMesh->mFaces[i].mNumIndices * sizeof(unsigned int);
+        }
+        bytes += aiMesh->mNumFaces * sizeof(struct aiFace);
+        delete[] aiMesh->mFaces;
+        aiMesh->mFaces = NULL;
+    }
+    aiMesh->mNumFaces = 0;
+    for (unsigned int i = 0; i < aiMesh->mNumBones; i++)
+    {
+        struct aiBone *aiBone = aiMesh->mBones[i];
+        bytes += freeAttribute(&aiBone->mWeights, aiBone->mNumWeights);
+        aiBone->mNumWeights = 0;
+    }
+    return bytes;
+}
+
+#pragma mark - Creating a scene trim
+
+/**
+ Creates the trim of a scene, counting the nodes which use each mesh.
+
+ @param aiScene The assimp scene, whose bulk data is freed by the trim.
+ @return The new scene trim which must be released with AKSceneTrimRelease.
+ */
+AKSceneTrim *AKSceneTrimCreate(const struct aiScene *aiScene)
+{
+    AKSceneTrim *trim = new AKSceneTrim;
+    // the scene is owned by the caller, who hands its bulk data to the trim
+    trim->aiScene = const_cast<struct aiScene *>(aiScene);
+    trim->meshUses.assign(aiScene->mNumMeshes, 0);
+    trim->freedBytes = 0;
+    countMeshUses(aiScene->mRootNode, &trim->meshUses);
+    return trim;
+}
+
+/**
+ Releases the scene trim. The scene keeps the data which was not trimmed.
+
+ @param trim The scene trim, may be NULL.
+ */
+void AKSceneTrimRelease(AKSceneTrim *trim)
+{
+    delete trim;
+}
+
+#pragma mark - Trimming a scene
+
+/**
+ Records that a node is converted, freeing the vertices, faces and bone
+ weights of each of its meshes which no other node left to convert uses.
+
+ @param trim The scene trim, may be NULL.
+ @param aiNode The assimp node.
+ */
+void AKSceneTrimNode(AKSceneTrim *trim, const struct aiNode *aiNode)
+{
+    if (trim == NULL || aiNode == NULL)
+    {
+        return;
+    }
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        unsigned int meshIndex = aiNode->mMeshes[i];
+        if (meshIndex >= trim->meshUses.size() ||
+            trim->meshUses[meshIndex] == 0)
+        {
+            continue;
+        }
+        if (--trim->meshUses[meshIndex] == 0)
+        {
+            trim->freedBytes += trimMesh(trim->aiScene->mMeshes[meshIndex]);
+        }
+    }
+}
+
+/**
+ Frees the position, rotation and scaling keys of every channel of an
+ animation, once its tracks are made.
+
+ @param trim The scene trim, may be NULL.
+ @param index The index of the animation in the scene.
+ */
+void AKSceneTrimAnimation(AKSceneTrim *trim, unsigned int index)
+{
+    if (trim == NULL || index >= trim->aiScene->mNumAnimations)
+    {
+        return;
+    }
+    struct aiAnimation *aiAnimation = trim->aiScene->mAnimations[index];
+    for (unsigned int i = 0; i < aiAnimation->mNumChannels; i++)
+    {
+        struct aiNodeAnim *channel = aiAnimation->mChannels[i];
+        trim->freedBytes += freeAttribute(&channel->mPositionKeys,
+                                          channel->mNumPositionKeys);
+        trim->freedBytes += freeAttribute(&channel->mRotationKeys,
+                                          channel->mNumRotationKeys);
+        trim->freedBytes += freeAttribute(&channel->mScalingKeys,
+                                          channel->mNumScalingKeys);
+        channel->mNumPositionKeys = 0;
+        channel->mNumRotationKeys = 0;
+        channel->mNumScalingKeys = 0;
+    }
+}
+
+/**
+ Frees the texels of every embedded texture of the scene, once the textures
+ are decoded.
+
+ @param trim The scene trim, may be NULL.
+ */
+void AKSceneTrimTextures(AKSceneTrim *trim)
+{
+    if (trim == NULL)
+    {
+        return;
+    }
+    for (unsigned int i = 0; i < trim->aiScene->mNumTextures; i++)
+    {
+        struct aiTexture *aiTexture = trim->aiScene->mTextures[i];
+        // a compressed texture has its size in bytes as its width
+        unsigned int nTexels = aiTexture->mHeight == 0
+                                   ? (aiTexture->mWidth + 3) / 4
+                                   : aiTexture->mWidth * aiTexture->mHeight;
+        trim->freedBytes += freeAttribute(&aiTexture->pcData, nTexels);
+        aiTexture->mWidth = 0;
+        aiTexture->mHeight = 0;
+    }
+}
+
+/**
+ Returns the bytes of the scene freed by the trim so far.
+
+ @param trim The scene trim.
+ @return The bytes freed.
+ */
+size_t AKSceneTrimFreedBytes(const AKSceneTrim *trim)
+{
+    return trim->freedBytes;
+}
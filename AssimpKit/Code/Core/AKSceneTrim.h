@@ -0,0 +1,121 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKSceneTrim_h
+#define AKSceneTrim_h
+
+#include "assimp/scene.h" // Output data structure
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Scene trim
+
+/**
+ The progressive release of the bulk data of an assimp scene while it is
+ converted, so that the peak memory of an import is close to the larger of
+ the assimp scene and the converted scene instead of their sum.
+
+ The vertices, faces and bone weights of a mesh are freed once every node
+ which uses the mesh is converted. The keys of an animation are freed once its
+ tracks are made, and the embedded textures once they are decoded. The nodes,
+ the materials and the names and offset matrices of the bones are kept, so
+ that the skeleton can still be found from the bones of the meshes.
+
+ The scene is trimmed in place. It must be owned by the caller, such as the
+ scene of an AKImport, and is released as usual after the conversion.
+ */
+typedef struct AKSceneTrim AKSceneTrim;
+
+#pragma mark - Creating a scene trim
+
+/**
+ Creates the trim of a scene, counting the nodes which use each mesh.
+
+ @param aiScene The assimp scene, whose bulk data is freed by the trim.
+ @return The new scene trim which must be released with AKSceneTrimRelease.
+ */
+AKSceneTrim *AKSceneTrimCreate(const struct aiScene *aiScene);
+
+/**
+ Releases the scene trim. The scene keeps the data which was not trimmed.
+
+ @param trim The scene trim, may be NULL.
+ */
+void AKSceneTrimRelease(AKSceneTrim *trim);
+
+#pragma mark - Trimming a scene
+
+/**
+ Records that a node is converted, freeing the vertices, faces and bone
+ weights of each of its meshes which no other node left to convert uses.
+
+ @param trim The scene trim, may be NULL.
+ @param aiNode The assimp node.
+ */
+void AKSceneTrimNode(AKSceneTrim *trim, const struct aiNode *aiNode);
+
+/**
+ Frees the position, rotation and scaling keys of every channel of an
+ animation, once its tracks are made.
+
+ @param trim The scene trim, may be NULL.
+ @param index The index of the animation in the scene.
+ */
+void AKSceneTrimAnimation(AKSceneTrim *trim, unsigned int index);
+
+/**
+ Frees the texels of every embedded texture of the scene, once the textures
+ are decoded.
+
+ @param trim The scene trim, may be NULL.
+ */
+void AKSceneTrimTextures(AKSceneTrim *trim);
+
+/**
+ Returns the bytes of the scene freed by the trim so far.
+
+ @param trim The scene trim.
+ @return The bytes freed.
+ */
+size_t AKSceneTrimFreedBytes(const AKSceneTrim *trim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKSceneTrim_h */
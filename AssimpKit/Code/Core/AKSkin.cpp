@@ -0,0 +1,270 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSkin.h"
+#include "AKMemory.h"
+#include "AKBonePalette.h"
+#include "AKMeshStats.h"
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - Find the bones and weights of a skin
+
+/**
+ Finds the number of bones in the meshes of the specified node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @return The number of bones.
+ */
+unsigned int AKNumBonesInNode(const struct aiNode *aiNode,
+                              const struct aiScene *aiScene)
+{
+    unsigned int nBones = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        nBones += aiMesh->mNumBones;
+    }
+    return nBones;
+}
+
+/**
+ Finds the maximum number of weights that influence the vertices in the meshes
+ of the specified node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @return The maximum influences or weights.
+ */
+unsigned int AKMaxWeightsInNode(const struct aiNode *aiNode,
+                                const struct aiScene *aiScene)
+{
+    unsigned int maxWeights = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        AKMeshStats meshStats =
+            AKMeshStatsMake(aiScene->mMeshes[aiNode->mMeshes[i]]);
+        if (meshStats.maxWeights > maxWeights)
+        {
+            maxWeights = meshStats.maxWeights;
+        }
+    }
+    return maxWeights;
+}
+
+#pragma mark - Make skin buffers
+
+/**
+ Scatters the weights of every bone of the node into the fixed slots of the
+ influenced vertices, filling the bone weights and bone indices together.
+
+ Each vertex has maxWeights slots which are filled in bone order, so the
+ influences of a vertex keep the order in which assimp lists the bones. The
+ unused slots keep their zero weight and bone index. The weights of a vertex
+ which is not in its mesh are skipped, as are the weights of a vertex beyond
+ its maxWeights slots, so that a damaged scene never writes past the buffers.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette of the scene.
+ @param vertexWeights The number of slots already filled for each vertex,
+ zero initialised.
+ @param skin The node skin with zeroed buffers.
+ */
+static void fillVertexWeights(const struct aiNode *aiNode,
+                              const struct aiScene *aiScene,
+                              const AKBonePalette *palette,
+                              unsigned int *vertexWeights,
+                              AKNodeSkin *skin)
+{
+    const unsigned int maxWeights = skin->maxWeights;
+    unsigned int vertexOffset = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            const struct aiBone *aiBone = aiMesh->mBones[j];
+            // the bone index is the same for all the weights of a bone
+            int paletteIndex = AKBonePaletteIndexOfBone(palette, aiBone);
+            short boneIndex = paletteIndex < 0 ? 0 : (short)paletteIndex;
+            for (unsigned int k = 0; k < aiBone->mNumWeights; k++)
+            {
+                const struct aiVertexWeight *aiVertexWeight =
+                    &aiBone->mWeights[k];
+                if (aiVertexWeight->mVertexId >= aiMesh->mNumVertices)
+                {
+                    continue;
+                }
+                unsigned int vertex = vertexOffset + aiVertexWeight->mVertexId;
+                if (vertexWeights[vertex] >= maxWeights)
+                {
+                    continue;
+                }
+                unsigned int slot =
+                    vertex * maxWeights + vertexWeights[vertex]++;
+                skin->boneWeights[slot] = aiVertexWeight->mWeight;
+                skin->boneIndices[slot] = boneIndex;
+            }
+        }
+        vertexOffset += aiMesh->mNumVertices;
+    }
+}
+
+/**
+ Creates the bone weights and bone indices for the meshes of the specified
+ node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette of the scene, which orders the skinner's
+ bones.
+ @return A new node skin which must be released with AKNodeSkinRelease, or
+ NULL if the meshes of the node have no bones.
+ */
+AKNodeSkin *AKNodeSkinCreate(const struct aiNode *aiNode,
+                             const struct aiScene *aiScene,
+                             const AKBonePalette *palette)
+{
+    return AKNodeSkinCreateWithStats(aiNode, aiScene, palette, NULL);
+}
+
+/**
+ Creates the bone weights and bone indices for the meshes of the specified
+ node, sized by the statistics of the meshes.
+
+ The maximum weights of the node is the largest of the maximum weights of its
+ meshes, as the vertices of a mesh are only influenced by the bones of that
+ mesh. The weights are then scattered in a single pass over the bone weights
+ into fixed slots of maxWeights entries per vertex, which is the layout of the
+ skinner's geometry sources.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette of the scene, which orders the skinner's
+ bones.
+ @param stats The scene statistics, or NULL to compute the statistics of the
+ meshes of the node.
+ @return A new node skin which must be released with AKNodeSkinRelease, or
+ NULL if the meshes of the node have no bones.
+ */
+AKNodeSkin *AKNodeSkinCreateWithStats(const struct aiNode *aiNode,
+                                      const struct aiScene *aiScene,
+                                      const AKBonePalette *palette,
+                                      const AKSceneStats *stats)
+{
+    unsigned int nVertices = 0;
+    unsigned int nBones = 0;
+    unsigned int maxWeights = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        AKMeshStats meshStats =
+            AKSceneStatsOfMesh(stats, aiScene, aiNode->mMeshes[i]);
+        nVertices += meshStats.nVertices;
+        nBones += meshStats.nBones;
+        if (meshStats.maxWeights > maxWeights)
+        {
+            maxWeights = meshStats.maxWeights;
+        }
+    }
+    if (nBones == 0 || nVertices == 0 || maxWeights == 0)
+    {
+        return NULL;
+    }
+    AKNodeSkin *skin = (AKNodeSkin *)AKMemoryCalloc(1, sizeof(AKNodeSkin));
+    skin->nVertices = nVertices;
+    skin->maxWeights = maxWeights;
+    skin->boneWeights =
+        (float *)AKMemoryCalloc(nVertices * maxWeights, sizeof(float));
+    skin->boneIndices =
+        (short *)AKMemoryCalloc(nVertices * maxWeights, sizeof(short));
+    unsigned int *vertexWeights =
+        (unsigned int *)AKMemoryCalloc(nVertices, sizeof(unsigned int));
+    fillVertexWeights(aiNode, aiScene, palette, vertexWeights, skin);
+    AKMemoryFree(vertexWeights);
+    return skin;
+}
+
+/**
+ Creates the skin of a chunk of a split node geometry from the skin of the
+ node.
+
+ @param skin The node skin.
+ @param vertexMap The vertex map of the chunk, which maps each chunk vertex to
+ a vertex of the node.
+ @param nVertices The number of vertices in the chunk.
+ @return A new node skin for the chunk which must be released with
+ AKNodeSkinRelease.
+ */
+AKNodeSkin *AKNodeSkinCreateForVertexMap(const AKNodeSkin *skin,
+                                         const unsigned int *vertexMap,
+                                         unsigned int nVertices)
+{
+    const unsigned int maxWeights = skin->maxWeights;
+    AKNodeSkin *chunkSkin = (AKNodeSkin *)AKMemoryCalloc(1, sizeof(AKNodeSkin));
+    chunkSkin->nVertices = nVertices;
+    chunkSkin->maxWeights = maxWeights;
+    chunkSkin->boneWeights =
+        (float *)AKMemoryMalloc(nVertices * maxWeights * sizeof(float));
+    chunkSkin->boneIndices =
+        (short *)AKMemoryMalloc(nVertices * maxWeights * sizeof(short));
+    for (unsigned int i = 0; i < nVertices; i++)
+    {
+        memcpy(&chunkSkin->boneWeights[i * maxWeights],
+               &skin->boneWeights[vertexMap[i] * maxWeights],
+               maxWeights * sizeof(float));
+        memcpy(&chunkSkin->boneIndices[i * maxWeights],
+               &skin->boneIndices[vertexMap[i] * maxWeights],
+               maxWeights * sizeof(short));
+    }
+    return chunkSkin;
+}
+
+/**
+ Releases the node skin and its buffers.
+
+ @param skin The node skin, may be NULL.
+ */
+void AKNodeSkinRelease(AKNodeSkin *skin)
+{
+    if (skin == NULL)
+    {
+        return;
+    }
+    AKMemoryFree(skin->boneWeights);
+    AKMemoryFree(skin->boneIndices);
+    AKMemoryFree(skin);
+}
@@ -0,0 +1,169 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKSkin_h
+#define AKSkin_h
+
+#include "AKBonePalette.h"
+#include "AKMeshStats.h"
+#include "assimp/scene.h" // Output data structure
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#pragma mark - Skin buffers
+
+/**
+ The bone weights and bone indices for the combined meshes of a node, laid out
+ as the scenekit skinner expects them.
+
+ Each vertex has maxWeights influences. Vertices with fewer influences are
+ padded with zero weights which refer to the bone at index 0.
+ */
+typedef struct AKNodeSkin
+{
+    /**
+     The total number of vertices in the meshes of the node.
+     */
+    unsigned int nVertices;
+
+    /**
+     The maximum number of weights influencing any vertex of the node.
+     */
+    unsigned int maxWeights;
+
+    /**
+     The bone weights, maxWeights floats per vertex. Allocated with malloc,
+     so that the caller can take ownership of the weights and free them.
+     */
+    float *boneWeights;
+
+    /**
+     The indices into the skinner's bones array, maxWeights shorts per vertex.
+     Allocated with malloc, so that the caller can take ownership of the
+     indices and free them.
+     */
+    short *boneIndices;
+} AKNodeSkin;
+
+#pragma mark - Find the bones and weights of a skin
+
+/**
+ Finds the number of bones in the meshes of the specified node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @return The number of bones.
+ */
+unsigned int AKNumBonesInNode(const struct aiNode *aiNode,
+                              const struct aiScene *aiScene);
+
+/**
+ Finds the maximum number of weights that influence the vertices in the meshes
+ of the specified node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @return The maximum influences or weights.
+ */
+unsigned int AKMaxWeightsInNode(const struct aiNode *aiNode,
+                                const struct aiScene *aiScene);
+
+#pragma mark - Make skin buffers
+
+/**
+ Creates the bone weights and bone indices for the meshes of the specified
+ node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette of the scene, which orders the skinner's
+ bones.
+ @return A new node skin which must be released with AKNodeSkinRelease, or
+ NULL if the meshes of the node have no bones.
+ */
+AKNodeSkin *AKNodeSkinCreate(const struct aiNode *aiNode,
+                             const struct aiScene *aiScene,
+                             const AKBonePalette *palette);
+
+/**
+ Creates the bone weights and bone indices for the meshes of the specified
+ node, sized by the statistics of the meshes.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette of the scene, which orders the skinner's
+ bones.
+ @param stats The scene statistics, or NULL to compute the statistics of the
+ meshes of the node.
+ @return A new node skin which must be released with AKNodeSkinRelease, or
+ NULL if the meshes of the node have no bones.
+ */
+AKNodeSkin *AKNodeSkinCreateWithStats(const struct aiNode *aiNode,
+                                      const struct aiScene *aiScene,
+                                      const AKBonePalette *palette,
+                                      const AKSceneStats *stats);
+
+/**
+ Creates the skin of a chunk of a split node geometry from the skin of the
+ node.
+
+ @param skin The node skin.
+ @param vertexMap The vertex map of the chunk, which maps each chunk vertex to
+ a vertex of the node.
+ @param nVertices The number of vertices in the chunk.
+ @return A new node skin for the chunk which must be released with
+ AKNodeSkinRelease.
+ */
+AKNodeSkin *AKNodeSkinCreateForVertexMap(const AKNodeSkin *skin,
+                                         const unsigned int *vertexMap,
+                                         unsigned int nVertices);
+
+/**
+ Releases the node skin and its buffers.
+
+ Buffers which the caller has taken ownership of must be set to NULL before
+ calling this function.
+
+ @param skin The node skin, may be NULL.
+ */
+void AKNodeSkinRelease(AKNodeSkin *skin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKSkin_h */
@@ -0,0 +1,486 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKVertexKernels.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AK_VERTEX_KERNELS_NEON 1
+#endif
+
+/**
+ The number of vertices which the vectorized kernels convert at once, before
+ the block is written to the rows of the interleaved vertices.
+ */
+#define AK_VERTEX_BLOCK 8
+
+#pragma mark - Chunks
+
+/**
+ Finds the number of chunks of a vertex stream.
+
+ @param nVertices The number of vertices in the stream.
+ @return The number of chunks of at most AKVertexChunkSize vertices.
+ */
+size_t AKVertexChunkCount(size_t nVertices)
+{
+    return (nVertices + AKVertexChunkSize - 1) / AKVertexChunkSize;
+}
+
+#pragma mark - Rows
+
+/**
+ Writes a block of dense attributes to the rows of the interleaved vertices.
+
+ @param block The dense attributes.
+ @param n The number of attributes.
+ @param size The number of bytes of an attribute.
+ @param dst The first row.
+ @param dstStride The number of bytes from one row to the next.
+ */
+static inline void storeRows(const void *block,
+                             size_t n,
+                             size_t size,
+                             unsigned char *dst,
+                             size_t dstStride)
+{
+    if (dstStride == size)
+    {
+        memcpy(dst, block, n * size);
+        return;
+    }
+    const unsigned char *src = (const unsigned char *)block;
+    for (size_t i = 0; i < n; i++)
+    {
+        memcpy(dst + i * dstStride, src + i * size, size);
+    }
+}
+
+#pragma mark - Vector streams
+
+/**
+ Copies 3 component vectors.
+
+ The copy is bound by memory rather than arithmetic, so a dense destination is
+ copied at once and the rows of an interleaved destination are copied one by
+ one.
+
+ @param src The vectors, 3 floats each.
+ @param n The number of vectors.
+ @param dst The first attribute, 3 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKCopyVec3(const float *src, size_t n, void *dst, size_t dstStride)
+{
+    storeRows(src, n, 3 * sizeof(float), (unsigned char *)dst, dstStride);
+}
+
+/**
+ Copies 3 component vectors, scaling and offsetting each component.
+
+ The vectorized kernels work on the packed vectors as they are: 4 vectors are
+ 3 vector registers of x y z x, y z x y and z x y z, so each register is
+ scaled and offset by the same components rotated.
+
+ @param src The vectors, 3 floats each.
+ @param n The number of vectors.
+ @param scale The scale of each component, 3 floats.
+ @param offset The offset of each component, 3 floats.
+ @param dst The first attribute, 3 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKScaleOffsetVec3(const float *src,
+                       size_t n,
+                       const float *scale,
+                       const float *offset,
+                       void *dst,
+                       size_t dstStride)
+{
+    unsigned char *out = (unsigned char *)dst;
+    size_t i = 0;
+#if defined(__SSE2__) || defined(AK_VERTEX_KERNELS_NEON)
+    float block[AK_VERTEX_BLOCK * 3];
+#endif
+#if defined(__AVX2__)
+    const float s[3] = {scale[0], scale[1], scale[2]};
+    const float o[3] = {offset[0], offset[1], offset[2]};
+    __m256 scales[3];
+    __m256 offsets[3];
+    for (int r = 0; r < 3; r++)
+    {
+        // lane k of register r holds component (8 * r + k) % 3
+        scales[r] = _mm256_setr_ps(
+            s[(8 * r) % 3], s[(8 * r + 1) % 3], s[(8 * r + 2) % 3],
+            s[(8 * r + 3) % 3], s[(8 * r + 4) % 3], s[(8 * r + 5) % 3],
+            s[(8 * r + 6) % 3], s[(8 * r + 7) % 3]);
+        offsets[r] = _mm256_setr_ps(
+            o[(8 * r) % 3], o[(8 * r + 1) % 3], o[(8 * r + 2) % 3],
+            o[(8 * r + 3) % 3], o[(8 * r + 4) % 3], o[(8 * r + 5) % 3],
+            o[(8 * r + 6) % 3], o[(8 * r + 7) % 3]);
+    }
+    for (; i + 8 <= n; i += 8)
+    {
+        for (int r = 0; r < 3; r++)
+        {
+            __m256 v = _mm256_loadu_ps(src + 3 * i + 8 * r);
+            _mm256_storeu_ps(block + 8 * r,
+                             _mm256_add_ps(_mm256_mul_ps(v, scales[r]),
+                                           offsets[r]));
+        }
+        storeRows(block, 8, 3 * sizeof(float), out + i * dstStride,
+                  dstStride);
+    }
+#elif defined(__SSE2__)
+    const __m128 scales[3] = {
+        _mm_setr_ps(scale[0], scale[1], scale[2], scale[0]),
+        _mm_setr_ps(scale[1], scale[2], scale[0], scale[1]),
+        _mm_setr_ps(scale[2], scale[0], scale[1], scale[2])};
+    const __m128 offsets[3] = {
+        _mm_setr_ps(offset[0], offset[1], offset[2], offset[0]),
+        _mm_setr_ps(offset[1], offset[2], offset[0], offset[1]),
+        _mm_setr_ps(offset[2], offset[0], offset[1], offset[2])};
+    for (; i + 8 <= n; i += 8)
+    {
+        for (int r = 0; r < 6; r++)
+        {
+            __m128 v = _mm_loadu_ps(src + 3 * i + 4 * r);
+            _mm_storeu_ps(block + 4 * r,
+                          _mm_add_ps(_mm_mul_ps(v, scales[r % 3]),
+                                     offsets[r % 3]));
+        }
+        storeRows(block, 8, 3 * sizeof(float), out + i * dstStride,
+                  dstStride);
+    }
+#elif defined(AK_VERTEX_KERNELS_NEON)
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4x3_t v = vld3q_f32(src + 3 * i);
+        for (int k = 0; k < 3; k++)
+        {
+            v.val[k] = vaddq_f32(vmulq_n_f32(v.val[k], scale[k]),
+                                 vdupq_n_f32(offset[k]));
+        }
+        vst3q_f32(block, v);
+        storeRows(block, 4, 3 * sizeof(float), out + i * dstStride,
+                  dstStride);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        float v[3];
+        for (int k = 0; k < 3; k++)
+        {
+            v[k] = src[3 * i + k] * scale[k] + offset[k];
+        }
+        memcpy(out + i * dstStride, v, sizeof(v));
+    }
+}
+
+/**
+ Copies 3 component vectors, transforming them by an affine matrix.
+
+ The x86 kernel transforms a vector in a register as the sum of the columns of
+ the matrix scaled by its components. The arm kernel loads 4 vectors into
+ registers of their x, y and z components and transforms them together.
+
+ @param src The vectors, 3 floats each.
+ @param n The number of vectors.
+ @param matrix The 3 rows of 4 floats of the affine matrix, such as the
+ transform of a node.
+ @param w 1 to transform positions, 0 to transform directions which ignore the
+ translation of the matrix.
+ @param dst The first attribute, 3 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKTransformVec3(const float *src,
+                     size_t n,
+                     const float *matrix,
+                     float w,
+                     void *dst,
+                     size_t dstStride)
+{
+    unsigned char *out = (unsigned char *)dst;
+    size_t i = 0;
+#if defined(__SSE2__)
+    // one spare float, as each vector is stored with a fourth lane
+    float block[AK_VERTEX_BLOCK * 3 + 1];
+    const __m128 columns[4] = {
+        _mm_setr_ps(matrix[0], matrix[4], matrix[8], 0.0f),
+        _mm_setr_ps(matrix[1], matrix[5], matrix[9], 0.0f),
+        _mm_setr_ps(matrix[2], matrix[6], matrix[10], 0.0f),
+        _mm_setr_ps(matrix[3] * w, matrix[7] * w, matrix[11] * w, 0.0f)};
+    for (; i + AK_VERTEX_BLOCK <= n; i += AK_VERTEX_BLOCK)
+    {
+        for (size_t j = 0; j < AK_VERTEX_BLOCK; j++)
+        {
+            const float *v = src + 3 * (i + j);
+            __m128 r = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(v[0])),
+                           _mm_mul_ps(columns[1], _mm_set1_ps(v[1]))),
+                _mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(v[2])),
+                           columns[3]));
+            _mm_storeu_ps(block + 3 * j, r);
+        }
+        storeRows(block, AK_VERTEX_BLOCK, 3 * sizeof(float),
+                  out + i * dstStride, dstStride);
+    }
+#elif defined(AK_VERTEX_KERNELS_NEON)
+    float block[4 * 3];
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4x3_t v = vld3q_f32(src + 3 * i);
+        float32x4x3_t r;
+        for (int k = 0; k < 3; k++)
+        {
+            const float *row = matrix + 4 * k;
+            r.val[k] = vaddq_f32(
+                vaddq_f32(vmulq_n_f32(v.val[0], row[0]),
+                          vmulq_n_f32(v.val[1], row[1])),
+                vaddq_f32(vmulq_n_f32(v.val[2], row[2]),
+                          vdupq_n_f32(row[3] * w)));
+        }
+        vst3q_f32(block, r);
+        storeRows(block, 4, 3 * sizeof(float), out + i * dstStride,
+                  dstStride);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        const float *v = src + 3 * i;
+        float r[3];
+        for (int k = 0; k < 3; k++)
+        {
+            const float *row = matrix + 4 * k;
+            r[k] = (row[0] * v[0] + row[1] * v[1]) +
+                   (row[2] * v[2] + row[3] * w);
+        }
+        memcpy(out + i * dstStride, r, sizeof(r));
+    }
+}
+
+/**
+ Extracts the 2 dimensional texture coordinates from 3 component vectors.
+
+ @param src The texture coordinates, 3 floats each.
+ @param n The number of texture coordinates.
+ @param dst The first attribute, 2 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKExtractTexCoords(const float *src,
+                        size_t n,
+                        void *dst,
+                        size_t dstStride)
+{
+    unsigned char *out = (unsigned char *)dst;
+    size_t i = 0;
+#if defined(__SSE2__)
+    float block[4 * 2];
+    for (; i + 4 <= n; i += 4)
+    {
+        // x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3
+        __m128 a = _mm_loadu_ps(src + 3 * i);
+        __m128 b = _mm_loadu_ps(src + 3 * i + 4);
+        __m128 c = _mm_loadu_ps(src + 3 * i + 8);
+        __m128 t = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 3, 3));
+        _mm_storeu_ps(block, _mm_shuffle_ps(a, t, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(block + 4, _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)));
+        storeRows(block, 4, 2 * sizeof(float), out + i * dstStride,
+                  dstStride);
+    }
+#elif defined(AK_VERTEX_KERNELS_NEON)
+    float block[4 * 2];
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4x3_t v = vld3q_f32(src + 3 * i);
+        float32x4x2_t uv = {{v.val[0], v.val[1]}};
+        vst2q_f32(block, uv);
+        storeRows(block, 4, 2 * sizeof(float), out + i * dstStride,
+                  dstStride);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        memcpy(out + i * dstStride, src + 3 * i, 2 * sizeof(float));
+    }
+}
+
+#pragma mark - Color streams
+
+/**
+ Packs rgba colors to rgb colors, dropping the alpha.
+
+ @param src The colors, 4 floats each.
+ @param n The number of colors.
+ @param dst The first attribute, 3 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKPackColorsRGB(const float *src, size_t n, void *dst, size_t dstStride)
+{
+    unsigned char *out = (unsigned char *)dst;
+    size_t i = 0;
+#if defined(__SSE2__)
+    float block[4 * 3];
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 c0 = _mm_loadu_ps(src + 4 * i);
+        __m128 c1 = _mm_loadu_ps(src + 4 * i + 4);
+        __m128 c2 = _mm_loadu_ps(src + 4 * i + 8);
+        __m128 c3 = _mm_loadu_ps(src + 4 * i + 12);
+        // r0 g0 b0 r1, g1 b1 r2 g2, b2 r3 g3 b3
+        __m128 t0 = _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(0, 0, 2, 2));
+        __m128 t2 = _mm_shuffle_ps(c2, c3, _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(block, _mm_shuffle_ps(c0, t0, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(block + 4,
+                      _mm_shuffle_ps(c1, c2, _MM_SHUFFLE(1, 0, 2, 1)));
+        _mm_storeu_ps(block + 8,
+                      _mm_shuffle_ps(t2, c3, _MM_SHUFFLE(2, 1, 2, 0)));
+        storeRows(block, 4, 3 * sizeof(float), out + i * dstStride,
+                  dstStride);
+    }
+#elif defined(AK_VERTEX_KERNELS_NEON)
+    float block[4 * 3];
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4x4_t c = vld4q_f32(src + 4 * i);
+        float32x4x3_t rgb = {{c.val[0], c.val[1], c.val[2]}};
+        vst3q_f32(block, rgb);
+        storeRows(block, 4, 3 * sizeof(float), out + i * dstStride,
+                  dstStride);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        memcpy(out + i * dstStride, src + 4 * i, 3 * sizeof(float));
+    }
+}
+
+/**
+ Packs rgba colors to unsigned normalized 8 bit rgba colors, clamping the
+ components to [0, 1] and rounding to the nearest integer.
+
+ @param src The colors, 4 floats each.
+ @param n The number of colors.
+ @param dst The first attribute, 4 bytes.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKPackColorsRGBA8(const float *src,
+                       size_t n,
+                       void *dst,
+                       size_t dstStride)
+{
+    unsigned char *out = (unsigned char *)dst;
+    size_t i = 0;
+#if defined(__AVX2__)
+    uint32_t block[8];
+    const __m256 lower = _mm256_setzero_ps();
+    const __m256 upper = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(255.0f);
+    // the packs interleave the 128 bit lanes, which this puts back in order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i words[4];
+        for (int r = 0; r < 4; r++)
+        {
+            __m256 v = _mm256_loadu_ps(src + 4 * i + 8 * r);
+            v = _mm256_min_ps(_mm256_max_ps(v, lower), upper);
+            words[r] = _mm256_cvtps_epi32(_mm256_mul_ps(v, scale));
+        }
+        __m256i bytes = _mm256_packus_epi16(
+            _mm256_packs_epi32(words[0], words[1]),
+            _mm256_packs_epi32(words[2], words[3]));
+        _mm256_storeu_si256((__m256i *)block,
+                            _mm256_permutevar8x32_epi32(bytes, order));
+        storeRows(block, 8, 4, out + i * dstStride, dstStride);
+    }
+#elif defined(__SSE2__)
+    uint32_t block[4];
+    const __m128 lower = _mm_setzero_ps();
+    const __m128 upper = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i words[4];
+        for (int r = 0; r < 4; r++)
+        {
+            __m128 v = _mm_loadu_ps(src + 4 * i + 4 * r);
+            v = _mm_min_ps(_mm_max_ps(v, lower), upper);
+            words[r] = _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+        }
+        __m128i bytes =
+            _mm_packus_epi16(_mm_packs_epi32(words[0], words[1]),
+                             _mm_packs_epi32(words[2], words[3]));
+        _mm_storeu_si128((__m128i *)block, bytes);
+        storeRows(block, 4, 4, out + i * dstStride, dstStride);
+    }
+#elif defined(AK_VERTEX_KERNELS_NEON)
+    uint32_t block[4];
+    const float32x4_t lower = vdupq_n_f32(0.0f);
+    const float32x4_t upper = vdupq_n_f32(1.0f);
+    for (; i + 4 <= n; i += 4)
+    {
+        uint16x4_t words[4];
+        for (int r = 0; r < 4; r++)
+        {
+            float32x4_t v = vld1q_f32(src + 4 * i + 4 * r);
+            v = vminq_f32(vmaxq_f32(v, lower), upper);
+            words[r] = vqmovn_u32(vcvtnq_u32_f32(vmulq_n_f32(v, 255.0f)));
+        }
+        uint8x16_t bytes =
+            vcombine_u8(vqmovn_u16(vcombine_u16(words[0], words[1])),
+                        vqmovn_u16(vcombine_u16(words[2], words[3])));
+        vst1q_u8((uint8_t *)block, bytes);
+        storeRows(block, 4, 4, out + i * dstStride, dstStride);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        uint8_t rgba[4];
+        for (int k = 0; k < 4; k++)
+        {
+            float v = src[4 * i + k];
+            v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+            rgba[k] = (uint8_t)lrintf(v * 255.0f);
+        }
+        memcpy(out + i * dstStride, rgba, sizeof(rgba));
+    }
+}
@@ -0,0 +1,178 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKVertexKernels_h
+#define AKVertexKernels_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ Kernels which convert the vertex streams of assimp meshes into the attributes
+ of interleaved vertices.
+
+ The kernels are vectorized with SSE2 and AVX2 on x86 and NEON on arm64, when
+ the build targets them, and fall back to scalar code otherwise. Every build
+ produces the same values, except that the transforms may round differently
+ in the last bit where the compiler fuses multiply-adds.
+
+ The sources are the packed floats of assimp streams: 3 floats for each
+ aiVector3D and 4 floats for each aiColor4D. Each converted vertex attribute
+ is written at dst + i * dstStride, which need not be aligned. A dense
+ destination has a stride of the size of the attribute.
+
+ Every vertex is converted independently, so a stream can be split into
+ chunks which are converted on different threads, where the chunk starting at
+ vertex first reads from src + first and writes to dst + first * dstStride.
+ */
+
+#pragma mark - Chunks
+
+/**
+ The number of vertices in a chunk of a vertex stream, a multiple of every
+ vector width, sized so that the interleaved vertices of a chunk stay in the
+ cache while each of its attributes is converted.
+ */
+enum
+{
+    AKVertexChunkSize = 1024
+};
+
+/**
+ Finds the number of chunks of a vertex stream.
+
+ @param nVertices The number of vertices in the stream.
+ @return The number of chunks of at most AKVertexChunkSize vertices.
+ */
+size_t AKVertexChunkCount(size_t nVertices);
+
+#pragma mark - Vector streams
+
+/**
+ Copies 3 component vectors.
+
+ @param src The vectors, 3 floats each.
+ @param n The number of vectors.
+ @param dst The first attribute, 3 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKCopyVec3(const float *src, size_t n, void *dst, size_t dstStride);
+
+/**
+ Copies 3 component vectors, scaling and offsetting each component.
+
+ This is the transform of a uniform unit scale or of the bounds of quantized
+ positions: dst = src * scale + offset.
+
+ @param src The vectors, 3 floats each.
+ @param n The number of vectors.
+ @param scale The scale of each component, 3 floats.
+ @param offset The offset of each component, 3 floats.
+ @param dst The first attribute, 3 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKScaleOffsetVec3(const float *src,
+                       size_t n,
+                       const float *scale,
+                       const float *offset,
+                       void *dst,
+                       size_t dstStride);
+
+/**
+ Copies 3 component vectors, transforming them by an affine matrix.
+
+ @param src The vectors, 3 floats each.
+ @param n The number of vectors.
+ @param matrix The 3 rows of 4 floats of the affine matrix, such as the
+ transform of a node.
+ @param w 1 to transform positions, 0 to transform directions which ignore the
+ translation of the matrix.
+ @param dst The first attribute, 3 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKTransformVec3(const float *src,
+                     size_t n,
+                     const float *matrix,
+                     float w,
+                     void *dst,
+                     size_t dstStride);
+
+/**
+ Extracts the 2 dimensional texture coordinates from 3 component vectors.
+
+ @param src The texture coordinates, 3 floats each.
+ @param n The number of texture coordinates.
+ @param dst The first attribute, 2 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKExtractTexCoords(const float *src,
+                        size_t n,
+                        void *dst,
+                        size_t dstStride);
+
+#pragma mark - Color streams
+
+/**
+ Packs rgba colors to rgb colors, dropping the alpha.
+
+ @param src The colors, 4 floats each.
+ @param n The number of colors.
+ @param dst The first attribute, 3 floats.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKPackColorsRGB(const float *src, size_t n, void *dst, size_t dstStride);
+
+/**
+ Packs rgba colors to unsigned normalized 8 bit rgba colors, clamping the
+ components to [0, 1] and rounding to the nearest integer.
+
+ @param src The colors, 4 floats each.
+ @param n The number of colors.
+ @param dst The first attribute, 4 bytes.
+ @param dstStride The number of bytes from one attribute to the next.
+ */
+void AKPackColorsRGBA8(const float *src,
+                       size_t n,
+                       void *dst,
+                       size_t dstStride);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKVertexKernels_h */
@@ -0,0 +1,365 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKWorkPool.h"
+#include "AKMemory.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ A pool of worker threads which runs a batch of independent items.
+ */
+struct AKWorkPool
+{
+    /**
+     The number of workers.
+     */
+    unsigned int nWorkers;
+
+    /**
+     The cost budget of the items running at the same time, or 0 for no
+     budget.
+     */
+    size_t maxCostInFlight;
+
+    /**
+     The number of items of the last batch stolen from another worker.
+     */
+    std::atomic<size_t> nSteals;
+};
+
+#pragma mark - Batch state
+
+/**
+ The queue of the items dealt to a worker. The worker takes its items from
+ the front, and other workers steal from the back.
+ */
+struct AKWorkQueue
+{
+    /**
+     The lock of the queue.
+     */
+    std::mutex mutex;
+
+    /**
+     The items left in the queue.
+     */
+    std::deque<size_t> items;
+};
+
+/**
+ The state of a batch shared by its workers.
+ */
+struct AKWorkBatch
+{
+    /**
+     The work pool.
+     */
+    AKWorkPool *pool;
+
+    /**
+     The cost of each item, or NULL if every item costs 1.
+     */
+    const size_t *costs;
+
+    /**
+     The function which runs an item.
+     */
+    AKWorkFunction function;
+
+    /**
+     The context passed to the function.
+     */
+    void *context;
+
+    /**
+     The memory account current on the thread which runs the batch, which is
+     made current on every worker.
+     */
+    AKMemoryAccount *memoryAccount;
+
+    /**
+     The queue of each worker.
+     */
+    std::vector<AKWorkQueue> queues;
+
+    /**
+     The lock of the cost in flight.
+     */
+    std::mutex flightMutex;
+
+    /**
+     Signalled when an item stops running.
+     */
+    std::condition_variable flightChanged;
+
+    /**
+     The cost of the items running.
+     */
+    size_t costInFlight;
+
+    /**
+     The number of items running.
+     */
+    size_t nInFlight;
+
+    AKWorkBatch(size_t nWorkers) : queues(nWorkers) {}
+};
+
+/**
+ Takes the next item of a worker, from its own queue or else stolen from the
+ queue of another worker.
+
+ @param batch The batch.
+ @param worker The index of the worker.
+ @param item The item taken.
+ @return false if every queue is empty.
+ */
+static bool takeItem(AKWorkBatch *batch, unsigned int worker, size_t *item)
+{
+    {
+        AKWorkQueue &own = batch->queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.items.empty())
+        {
+            *item = own.items.front();
+            own.items.pop_front();
+            return true;
+        }
+    }
+    size_t nWorkers = batch->queues.size();
+    for (size_t i = 1; i < nWorkers; i++)
+    {
+        AKWorkQueue &victim = batch->queues[(worker + i) % nWorkers];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.items.empty())
+        {
+            *item = victim.items.back();
+            victim.items.pop_back();
+            batch->pool->nSteals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ Waits until the cost budget allows an item to run, and adds its cost to the
+ cost in flight.
+
+ @param batch The batch.
+ @param cost The cost of the item.
+ */
+static void beginItem(AKWorkBatch *batch, size_t cost)
+{
+    size_t maxCost = batch->pool->maxCostInFlight;
+    std::unique_lock<std::mutex> lock(batch->flightMutex);
+    if (maxCost > 0)
+    {
+        batch->flightChanged.wait(lock, [&]() {
+            return batch->nInFlight == 0 ||
+                   batch->costInFlight + cost <= maxCost;
+        });
+    }
+    batch->costInFlight += cost;
+    batch->nInFlight++;
+}
+
+/**
+ Removes the cost of an item which stopped running from the cost in flight.
+
+ @param batch The batch.
+ @param cost The cost of the item.
+ */
+static void endItem(AKWorkBatch *batch, size_t cost)
+{
+    {
+        std::lock_guard<std::mutex> lock(batch->flightMutex);
+        batch->costInFlight -= cost;
+        batch->nInFlight--;
+    }
+    batch->flightChanged.notify_all();
+}
+
+/**
+ Runs the items of a worker until every queue is empty.
+
+ @param batch The batch.
+ @param worker The index of the worker.
+ */
+static void runWorker(AKWorkBatch *batch, unsigned int worker)
+{
+    AKMemoryAccount *previous =
+        AKMemoryAccountMakeCurrent(batch->memoryAccount);
+    size_t item;
+    while (takeItem(batch, worker, &item))
+    {
+        size_t cost = batch->costs != NULL ? batch->costs[item] : 1;
+        beginItem(batch, cost);
+        batch->function(batch->context, item, worker);
+        endItem(batch, cost);
+    }
+    AKMemoryAccountMakeCurrent(previous);
+}
+
+#pragma mark - Creating a work pool
+
+/**
+ Creates a work pool.
+
+ @param nWorkers The number of workers, or 0 for one worker per hardware
+ thread.
+ @param maxCostInFlight The cost budget of the items running at the same
+ time, or 0 for no budget.
+ @return A new work pool which must be released with AKWorkPoolRelease.
+ */
+AKWorkPool *AKWorkPoolCreate(unsigned int nWorkers, size_t maxCostInFlight)
+{
+    AKWorkPool *pool = new AKWorkPool;
+    if (nWorkers == 0)
+    {
+        nWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    pool->nWorkers = nWorkers;
+    pool->maxCostInFlight = maxCostInFlight;
+    pool->nSteals = 0;
+    return pool;
+}
+
+/**
+ Releases the work pool.
+
+ @param pool The work pool, may be NULL.
+ */
+void AKWorkPoolRelease(AKWorkPool *pool)
+{
+    delete pool;
+}
+
+/**
+ Returns the number of workers of the pool.
+
+ @param pool The work pool.
+ @return The number of workers.
+ */
+unsigned int AKWorkPoolWorkerCount(const AKWorkPool *pool)
+{
+    return pool->nWorkers;
+}
+
+#pragma mark - Running a batch
+
+/**
+ Runs every item of a batch once and returns when all of them have run.
+
+ The calling thread is the first worker, and the other workers are started
+ for the batch and joined before this function returns. The memory account
+ current on the calling thread is current on every worker while it runs the
+ batch.
+
+ @param pool The work pool.
+ @param nItems The number of items.
+ @param costs The cost of each item, or NULL if every item costs 1.
+ @param function The function which runs an item.
+ @param context The context passed to the function.
+ */
+void AKWorkPoolRun(AKWorkPool *pool,
+                   size_t nItems,
+                   const size_t *costs,
+                   AKWorkFunction function,
+                   void *context)
+{
+    pool->nSteals = 0;
+    if (nItems == 0)
+    {
+        return;
+    }
+    unsigned int nWorkers =
+        (unsigned int)std::min((size_t)pool->nWorkers, nItems);
+    AKWorkBatch batch(nWorkers);
+    batch.pool = pool;
+    batch.costs = costs;
+    batch.function = function;
+    batch.context = context;
+    batch.memoryAccount = AKMemoryAccountCurrent();
+    batch.costInFlight = 0;
+    batch.nInFlight = 0;
+
+    // deal the items in turn, the most costly first
+    std::vector<size_t> order(nItems);
+    for (size_t i = 0; i < nItems; i++)
+    {
+        order[i] = i;
+    }
+    if (costs != NULL)
+    {
+        std::stable_sort(order.begin(), order.end(),
+                         [costs](size_t a, size_t b) {
+                             return costs[a] > costs[b];
+                         });
+    }
+    for (size_t i = 0; i < nItems; i++)
+    {
+        batch.queues[i % nWorkers].items.push_back(order[i]);
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned int worker = 1; worker < nWorkers; worker++)
+    {
+        workers.push_back(std::thread(runWorker, &batch, worker));
+    }
+    runWorker(&batch, 0);
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
+
+/**
+ Returns the number of items of the last batch which were stolen by a worker
+ from the queue of another worker.
+
+ @param pool The work pool.
+ @return The number of stolen items.
+ */
+size_t AKWorkPoolStealCount(const AKWorkPool *pool)
+{
+    return pool->nSteals;
+}
@@ -0,0 +1,137 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKWorkPool_h
+#define AKWorkPool_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ A pool of worker threads which runs a batch of independent items, such as the
+ imports of the files of a level.
+
+ The items are dealt to the workers in turn, the most costly first, so that
+ each worker starts with its own queue of items. A worker which runs out of
+ items steals the least costly item left in the queue of another worker, so
+ that no worker idles while items are left.
+
+ The cost of an item estimates the memory it takes while it runs, such as the
+ size of the file it imports. The items running at the same time never cost
+ more than the cost budget of the pool, except for an item which costs more
+ than the whole budget, which runs on its own.
+ */
+typedef struct AKWorkPool AKWorkPool;
+
+/**
+ The function which runs an item of a batch.
+
+ The function is called on a worker thread, and may be called on several
+ workers at the same time for different items.
+
+ @param context The context passed to AKWorkPoolRun.
+ @param item The index of the item in the batch.
+ @param worker The index of the worker which runs the item, from 0 to the
+ number of workers.
+ */
+typedef void (*AKWorkFunction)(void *context, size_t item, unsigned int worker);
+
+#pragma mark - Creating a work pool
+
+/**
+ Creates a work pool.
+
+ @param nWorkers The number of workers, or 0 for one worker per hardware
+ thread.
+ @param maxCostInFlight The cost budget of the items running at the same
+ time, or 0 for no budget.
+ @return A new work pool which must be released with AKWorkPoolRelease.
+ */
+AKWorkPool *AKWorkPoolCreate(unsigned int nWorkers, size_t maxCostInFlight);
+
+/**
+ Releases the work pool.
+
+ @param pool The work pool, may be NULL.
+ */
+void AKWorkPoolRelease(AKWorkPool *pool);
+
+/**
+ Returns the number of workers of the pool.
+
+ @param pool The work pool.
+ @return The number of workers.
+ */
+unsigned int AKWorkPoolWorkerCount(const AKWorkPool *pool);
+
+#pragma mark - Running a batch
+
+/**
+ Runs every item of a batch once and returns when all of them have run.
+
+ The calling thread is the first worker, and the other workers are started
+ for the batch and joined before this function returns. The memory account
+ current on the calling thread is current on every worker while it runs the
+ batch.
+
+ @param pool The work pool.
+ @param nItems The number of items.
+ @param costs The cost of each item, or NULL if every item costs 1.
+ @param function The function which runs an item.
+ @param context The context passed to the function.
+ */
+void AKWorkPoolRun(AKWorkPool *pool,
+                   size_t nItems,
+                   const size_t *costs,
+                   AKWorkFunction function,
+                   void *context);
+
+/**
+ Returns the number of items of the last batch which were stolen by a worker
+ from the queue of another worker.
+
+ @param pool The work pool.
+ @return The number of stolen items.
+ */
+size_t AKWorkPoolStealCount(const AKWorkPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AKWorkPool_h */
@@ -0,0 +1,244 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKBonePalette.h"
+#include "AKGeometry.h"
+#include "AKMeshStats.h"
+#include "AKSkin.h"
+#include "AKWorkPool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "AKImport.h"
+#include "assimp/postprocess.h" // Post processing flags
+#endif
+
+/**
+ Benchmarks the throughput of a batch import on a work pool of 1, 2, 4 and 8
+ workers, in files and megabytes per second.
+
+ Each file of the test assets is parsed and its geometry and skin are
+ converted, with the size of the file as its cost. Without the assimp
+ library, the batch converts synthetic characters of a range of sizes
+ instead, with the size of their mesh data as their cost.
+
+ usage: AKBatchImportBenchmark [cost budget in MB, 0 for none]
+ */
+
+#pragma mark - Batch
+
+/**
+ A file of the batch.
+ */
+struct AKBatchFile
+{
+    /**
+     The path of the file, or empty for a synthetic scene.
+     */
+    std::string path;
+
+    /**
+     The synthetic scene, or NULL for a file.
+     */
+    const struct aiScene *scene;
+
+    /**
+     The size of the file, or of the mesh data of the synthetic scene.
+     */
+    size_t bytes;
+};
+
+/**
+ Converts the geometry and the skin of a node and its children.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette of the scene.
+ @param stats The scene statistics.
+ */
+static void convertNode(const struct aiNode *aiNode,
+                        const struct aiScene *aiScene,
+                        const AKBonePalette *palette,
+                        const AKSceneStats *stats)
+{
+    AKNodeGeometryRelease(
+        AKNodeGeometryCreateWithStats(aiNode, aiScene, NULL, stats));
+    AKNodeSkinRelease(
+        AKNodeSkinCreateWithStats(aiNode, aiScene, palette, stats));
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        convertNode(aiNode->mChildren[i], aiScene, palette, stats);
+    }
+}
+
+/**
+ Converts the geometry and the skin of every node of a scene.
+
+ @param aiScene The assimp scene.
+ */
+static void convertScene(const struct aiScene *aiScene)
+{
+    if (aiScene->mRootNode == NULL)
+    {
+        return;
+    }
+    AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+    AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+    convertNode(aiScene->mRootNode, aiScene, palette, stats);
+    AKBonePaletteRelease(palette);
+    AKSceneStatsRelease(stats);
+}
+
+/**
+ Imports and converts a file of the batch.
+
+ @param context The files of the batch.
+ @param item The index of the file.
+ @param worker The index of the worker.
+ */
+static void importFile(void *context, size_t item, unsigned int worker)
+{
+    const AKBatchFile &file = (*(std::vector<AKBatchFile> *)context)[item];
+    if (file.scene != NULL)
+    {
+        convertScene(file.scene);
+        return;
+    }
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    AKImport *import = AKImportCreate(NULL);
+    const struct aiScene *aiScene = AKImportReadFile(
+        import, file.path.c_str(), aiProcess_FlipUVs | aiProcess_Triangulate);
+    if (aiScene != NULL)
+    {
+        convertScene(aiScene);
+    }
+    AKImportRelease(import);
+#endif
+}
+
+/**
+ Returns the size of the mesh data of a scene: its vertex streams and
+ indices.
+
+ @param aiScene The assimp scene.
+ @return The size in bytes.
+ */
+static size_t meshBytes(const struct aiScene *aiScene)
+{
+    size_t bytes = 0;
+    for (unsigned int i = 0; i < aiScene->mNumMeshes; i++)
+    {
+        AKMeshStats stats = AKMeshStatsMake(aiScene->mMeshes[i]);
+        size_t vertexBytes = sizeof(aiVector3D);
+        vertexBytes += stats.streams & AKMeshStreamNormals
+                           ? sizeof(aiVector3D) : 0;
+        vertexBytes += stats.streams & AKMeshStreamTangents
+                           ? 2 * sizeof(aiVector3D) : 0;
+        vertexBytes += stats.streams & AKMeshStreamTexCoords
+                           ? sizeof(aiVector3D) : 0;
+        vertexBytes += stats.streams & AKMeshStreamColors
+                           ? sizeof(aiColor4D) : 0;
+        bytes += stats.nVertices * vertexBytes +
+                 stats.nIndices * sizeof(unsigned int);
+    }
+    return bytes;
+}
+
+int main(int argc, char **argv)
+{
+    size_t budget = (size_t)(argc > 1 ? atof(argv[1]) * 1e6 : 0.0);
+    std::vector<AKBatchFile> files;
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    std::vector<std::string> paths = AKBenchmarkListAssets();
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        AKBatchFile file = {paths[i], NULL,
+                            AKBenchmarkFileSize(paths[i].c_str())};
+        files.push_back(file);
+    }
+    printf("Corpus: %zu files of the test assets\n", files.size());
+    const int nRuns = 1;
+#else
+    // characters of 10000 to 160000 vertices in a shuffled order
+    for (unsigned int i = 0; i < 32; i++)
+    {
+        AKBatchFile file;
+        file.scene =
+            AKBenchmarkMakeCharacter(10000 + (i * 7 % 16) * 10000, 40, 4);
+        file.bytes = meshBytes(file.scene);
+        files.push_back(file);
+    }
+    printf("Corpus: %zu synthetic characters, converted only as the "
+           "benchmark is built without the assimp library\n",
+           files.size());
+    const int nRuns = 3;
+#endif
+    std::vector<size_t> costs;
+    double megabytes = 0.0;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        costs.push_back(files[i].bytes);
+        megabytes += files[i].bytes / 1e6;
+    }
+    printf("Size: %.1f MB, cost budget: %s\n", megabytes,
+           budget > 0 ? (std::to_string(budget / 1000000) + " MB").c_str()
+                      : "none");
+
+    printf("%8s %10s %10s %10s %8s %8s\n", "workers", "ms", "files/s",
+           "MB/s", "speedup", "steals");
+    double singleMs = 0.0;
+    const unsigned int workerCounts[] = {1, 2, 4, 8};
+    for (int w = 0; w < 4; w++)
+    {
+        AKWorkPool *pool = AKWorkPoolCreate(workerCounts[w], budget);
+        double ms = AKBenchmarkMinMilliseconds(nRuns, [&]() {
+            AKWorkPoolRun(pool, files.size(), costs.data(), importFile,
+                          &files);
+        });
+        singleMs = w == 0 ? ms : singleMs;
+        printf("%8u %10.1f %10.1f %10.1f %7.2fx %8zu\n", workerCounts[w], ms,
+               files.size() * 1000.0 / ms, megabytes * 1000.0 / ms,
+               singleMs / ms, AKWorkPoolStealCount(pool));
+        AKWorkPoolRelease(pool);
+    }
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        AKBenchmarkReleaseScene(files[i].scene);
+    }
+    return 0;
+}
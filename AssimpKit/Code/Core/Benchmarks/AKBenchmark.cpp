@@ -0,0 +1,418 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKTestScene.h"
+#include <algorithm>
+#include <chrono>
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <set>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "assimp/cimport.h"     // Plain-C interface
+#include "assimp/postprocess.h" // Post processing flags
+#endif
+
+#pragma mark - Timing
+
+/**
+ Returns the current time of a monotonic clock.
+
+ @return The time in seconds.
+ */
+double AKBenchmarkSeconds()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+#pragma mark - Hardware counters
+
+#ifdef __linux__
+/**
+ Opens a hardware counter of the current thread in user space.
+
+ @param config The perf event of the counter.
+ @return The file descriptor of the counter, or -1 if it is not available.
+ */
+static int openCounter(unsigned long long config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/**
+ Opens the hardware counters of the current thread.
+
+ @param counters The counters to open.
+ @return true if the counters are available, false on platforms without perf
+ events or when the kernel does not allow reading them.
+ */
+bool AKBenchmarkCountersOpen(AKBenchmarkCounters *counters)
+{
+    counters->fds[0] = -1;
+    counters->fds[1] = -1;
+    counters->instructions = -1;
+    counters->cacheMisses = -1;
+#ifdef __linux__
+    counters->fds[0] = openCounter(PERF_COUNT_HW_INSTRUCTIONS);
+    counters->fds[1] = openCounter(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    if (counters->fds[0] < 0 || counters->fds[1] < 0)
+    {
+        AKBenchmarkCountersClose(counters);
+        return false;
+    }
+    return true;
+}
+
+/**
+ Resets and starts the hardware counters.
+
+ @param counters The open counters.
+ */
+void AKBenchmarkCountersStart(AKBenchmarkCounters *counters)
+{
+#ifdef __linux__
+    for (int i = 0; i < 2; i++)
+    {
+        ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+ Stops the hardware counters and reads them.
+
+ @param counters The open counters.
+ */
+void AKBenchmarkCountersStop(AKBenchmarkCounters *counters)
+{
+    long long counts[2] = {-1, -1};
+#ifdef __linux__
+    for (int i = 0; i < 2; i++)
+    {
+        ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counters->fds[i], &counts[i], sizeof(counts[i])) !=
+            sizeof(counts[i]))
+        {
+            counts[i] = -1;
+        }
+    }
+#endif
+    counters->instructions = counts[0];
+    counters->cacheMisses = counts[1];
+}
+
+/**
+ Closes the hardware counters.
+
+ @param counters The counters, which may not be available.
+ */
+void AKBenchmarkCountersClose(AKBenchmarkCounters *counters)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (counters->fds[i] >= 0)
+        {
+            close(counters->fds[i]);
+        }
+        counters->fds[i] = -1;
+    }
+}
+
+#pragma mark - Memory
+
+/**
+ Waits for a benchmark child process to exit and finds its peak resident set
+ size.
+
+ @param pid The process id of the child.
+ @return The peak resident set size of the child in kilobytes, or -1 if the
+ child failed.
+ */
+long AKBenchmarkWaitForPeakKilobytes(pid_t pid)
+{
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0)
+    {
+        return -1;
+    }
+#ifdef __APPLE__
+    // ru_maxrss is in bytes on macOS and in kilobytes elsewhere
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+#pragma mark - Assets
+
+/**
+ Adds the files of a directory and its subdirectories with one of the
+ specified extensions to a list.
+
+ @param directory The path of the directory.
+ @param extensions The extensions, in lower case.
+ @param paths The list of paths to add to.
+ */
+static void listFiles(const std::string &directory,
+                      const std::set<std::string> &extensions,
+                      std::vector<std::string> *paths)
+{
+    DIR *dir = opendir(directory.c_str());
+    if (dir == NULL)
+    {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+        std::string path = directory + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0)
+        {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode))
+        {
+            listFiles(path, extensions, paths);
+            continue;
+        }
+        size_t dot = name.rfind('.');
+        if (dot == std::string::npos)
+        {
+            continue;
+        }
+        std::string extension = name.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       ::tolower);
+        if (extensions.count(extension) > 0)
+        {
+            paths->push_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ Lists the scene files of the test assets, which are the files with an
+ extension listed in assets/valid-extensions.txt.
+
+ @return The absolute paths of the scene files, sorted.
+ */
+std::vector<std::string> AKBenchmarkListAssets()
+{
+    std::string assets = AK_ASSETS_PATH;
+    std::set<std::string> extensions;
+    FILE *file = fopen((assets + "/valid-extensions.txt").c_str(), "r");
+    if (file != NULL)
+    {
+        char line[64];
+        while (fgets(line, sizeof(line), file) != NULL)
+        {
+            std::string extension;
+            for (char *c = line; *c != '\0' && !isspace((unsigned char)*c);
+                 c++)
+            {
+                extension += (char)tolower((unsigned char)*c);
+            }
+            if (!extension.empty())
+            {
+                extensions.insert(extension);
+            }
+        }
+        fclose(file);
+    }
+    std::vector<std::string> paths;
+    listFiles(assets, extensions, &paths);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+/**
+ Returns the size of a file.
+
+ @param path The path of the file.
+ @return The size in bytes, or 0 if the file does not exist.
+ */
+size_t AKBenchmarkFileSize(const char *path)
+{
+    struct stat info;
+    return stat(path, &info) == 0 ? (size_t)info.st_size : 0;
+}
+
+/**
+ Drops a file from the page cache of the kernel, so that the next read of the
+ file reads it from the disk.
+
+ @param path The path of the file.
+ @return true if the file was dropped, false if it could not be opened or the
+ platform cannot drop files from its cache.
+ */
+bool AKBenchmarkEvictFile(const char *path)
+{
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool evicted = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return evicted;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+#pragma mark - Scenes
+
+/**
+ Imports the specified file from the test assets.
+
+ @param assetPath The path of the file relative to the assets directory, or an
+ absolute path.
+ @return The imported scene which must be released with
+ AKBenchmarkReleaseScene, or NULL if the file could not be imported or the
+ benchmark is built without the assimp library.
+ */
+const aiScene *AKBenchmarkImportScene(const char *assetPath)
+{
+    std::string path = assetPath;
+    if (path.empty() || path[0] != '/')
+    {
+        path = std::string(AK_ASSETS_PATH) + "/" + path;
+    }
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    const aiScene *aiScene = aiImportFile(
+        path.c_str(), aiProcess_FlipUVs | aiProcess_Triangulate);
+    if (aiScene == NULL)
+    {
+        fprintf(stderr, "Failed to import %s: %s\n", path.c_str(),
+                aiGetErrorString());
+    }
+    return aiScene;
+#else
+    fprintf(stderr, "Built without the assimp library, cannot import %s\n",
+            path.c_str());
+    return NULL;
+#endif
+}
+
+/**
+ Releases a scene returned by AKBenchmarkImportScene or
+ AKBenchmarkMakeCharacter.
+
+ @param aiScene The scene, may be NULL.
+ */
+void AKBenchmarkReleaseScene(const aiScene *aiScene)
+{
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    // scenes made by the benchmarks are released by the assimp library too,
+    // as they are allocated with the same operator new
+    aiReleaseImport(aiScene);
+#else
+    delete aiScene;
+#endif
+}
+
+/**
+ Creates a synthetic skinned character: one node with a single mesh whose
+ vertices are each influenced by the specified number of bones.
+
+ @param nVertices The number of vertices.
+ @param nBones The number of bones.
+ @param weightsPerVertex The number of bones influencing each vertex.
+ @return A new scene which must be released with AKBenchmarkReleaseScene.
+ */
+const aiScene *AKBenchmarkMakeCharacter(unsigned int nVertices,
+                                        unsigned int nBones,
+                                        unsigned int weightsPerVertex)
+{
+    aiMesh *mesh = AKTestMakeMesh(nVertices, nVertices / 2,
+                                  AKTestMeshAllStreams);
+    // vertex j is influenced by the bones j, j + 1, ... wrapped to nBones
+    std::vector<std::vector<std::pair<unsigned int, float> > > boneWeights(
+        nBones);
+    for (unsigned int j = 0; j < nVertices; j++)
+    {
+        for (unsigned int k = 0; k < weightsPerVertex; k++)
+        {
+            boneWeights[(j + k) % nBones].push_back(
+                std::make_pair(j, 1.0f / weightsPerVertex));
+        }
+    }
+    for (unsigned int b = 0; b < nBones; b++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "bone-%u", b);
+        AKTestAddBone(mesh, name, boneWeights[b]);
+    }
+    std::vector<aiMesh *> meshes(1, mesh);
+    return AKTestMakeScene(
+        AKTestMakeNode("character", std::vector<unsigned int>(1, 0)), meshes);
+}
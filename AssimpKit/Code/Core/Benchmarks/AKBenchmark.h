@@ -0,0 +1,268 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKBenchmark_h
+#define AKBenchmark_h
+
+#include "assimp/scene.h" // Output data structure
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ Support for the headless core benchmarks.
+
+ The benchmarks import the scene files in the test assets when they are built
+ with the assimp library, and otherwise run on synthetic in-memory scenes of a
+ comparable size.
+ */
+
+#pragma mark - Timing
+
+/**
+ Returns the current time of a monotonic clock.
+
+ @return The time in seconds.
+ */
+double AKBenchmarkSeconds();
+
+/**
+ Runs the specified block repeatedly and returns the fastest run.
+
+ @param nRuns The number of runs.
+ @param block The block to time.
+ @return The time of the fastest run in milliseconds.
+ */
+template <typename Block>
+double AKBenchmarkMinMilliseconds(int nRuns, Block block)
+{
+    double best = -1.0;
+    for (int i = 0; i < nRuns; i++)
+    {
+        double start = AKBenchmarkSeconds();
+        block();
+        double elapsed = (AKBenchmarkSeconds() - start) * 1000.0;
+        if (best < 0.0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+#pragma mark - Hardware counters
+
+/**
+ The hardware counters of the current thread which the benchmarks read, on
+ platforms with perf events.
+ */
+typedef struct AKBenchmarkCounters
+{
+    /**
+     The file descriptors of the instructions and cache misses counters, or -1
+     if the counters are not available.
+     */
+    int fds[2];
+
+    /**
+     The number of instructions retired between the last start and stop.
+     */
+    long long instructions;
+
+    /**
+     The number of cache misses between the last start and stop.
+     */
+    long long cacheMisses;
+} AKBenchmarkCounters;
+
+/**
+ Opens the hardware counters of the current thread.
+
+ @param counters The counters to open.
+ @return true if the counters are available, false on platforms without perf
+ events or when the kernel does not allow reading them.
+ */
+bool AKBenchmarkCountersOpen(AKBenchmarkCounters *counters);
+
+/**
+ Resets and starts the hardware counters.
+
+ @param counters The open counters.
+ */
+void AKBenchmarkCountersStart(AKBenchmarkCounters *counters);
+
+/**
+ Stops the hardware counters and reads them.
+
+ @param counters The open counters.
+ */
+void AKBenchmarkCountersStop(AKBenchmarkCounters *counters);
+
+/**
+ Closes the hardware counters.
+
+ @param counters The counters, which may not be available.
+ */
+void AKBenchmarkCountersClose(AKBenchmarkCounters *counters);
+
+/**
+ Runs the specified block repeatedly and reads the hardware counters of the
+ run with the fewest cache misses.
+
+ @param nRuns The number of runs.
+ @param counters The open counters, which are set to the counts of the run.
+ @param block The block to count.
+ */
+template <typename Block>
+void AKBenchmarkMinCounters(int nRuns, AKBenchmarkCounters *counters,
+                            Block block)
+{
+    long long instructions = -1;
+    long long cacheMisses = -1;
+    for (int i = 0; i < nRuns; i++)
+    {
+        AKBenchmarkCountersStart(counters);
+        block();
+        AKBenchmarkCountersStop(counters);
+        if (cacheMisses < 0 || counters->cacheMisses < cacheMisses)
+        {
+            instructions = counters->instructions;
+            cacheMisses = counters->cacheMisses;
+        }
+    }
+    counters->instructions = instructions;
+    counters->cacheMisses = cacheMisses;
+}
+
+#pragma mark - Memory
+
+/**
+ Waits for a benchmark child process to exit and finds its peak resident set
+ size.
+
+ @param pid The process id of the child.
+ @return The peak resident set size of the child in kilobytes, or -1 if the
+ child failed.
+ */
+long AKBenchmarkWaitForPeakKilobytes(pid_t pid);
+
+/**
+ Runs the specified block in a child process and measures its peak resident
+ set size.
+
+ The peak resident set size of a process never decreases, so each block runs
+ in a process of its own to measure it independently of the blocks run before.
+ The child starts with the memory of the parent, which includes the scene to
+ convert.
+
+ @param block The block to measure.
+ @return The peak resident set size of the child in kilobytes, or -1 if the
+ child failed.
+ */
+template <typename Block>
+long AKBenchmarkPeakKilobytes(Block block)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        block();
+        _exit(0);
+    }
+    return pid < 0 ? -1 : AKBenchmarkWaitForPeakKilobytes(pid);
+}
+
+#pragma mark - Assets
+
+/**
+ Lists the scene files of the test assets, which are the files with an
+ extension listed in assets/valid-extensions.txt.
+
+ @return The absolute paths of the scene files, sorted.
+ */
+std::vector<std::string> AKBenchmarkListAssets();
+
+/**
+ Returns the size of a file.
+
+ @param path The path of the file.
+ @return The size in bytes, or 0 if the file does not exist.
+ */
+size_t AKBenchmarkFileSize(const char *path);
+
+/**
+ Drops a file from the page cache of the kernel, so that the next read of the
+ file reads it from the disk.
+
+ @param path The path of the file.
+ @return true if the file was dropped, false if it could not be opened or the
+ platform cannot drop files from its cache.
+ */
+bool AKBenchmarkEvictFile(const char *path);
+
+#pragma mark - Scenes
+
+/**
+ Imports the specified file from the test assets.
+
+ @param assetPath The path of the file relative to the assets directory, or an
+ absolute path.
+ @return The imported scene which must be released with
+ AKBenchmarkReleaseScene, or NULL if the file could not be imported or the
+ benchmark is built without the assimp library.
+ */
+const aiScene *AKBenchmarkImportScene(const char *assetPath);
+
+/**
+ Releases a scene returned by AKBenchmarkImportScene or
+ AKBenchmarkMakeCharacter.
+
+ @param aiScene The scene, may be NULL.
+ */
+void AKBenchmarkReleaseScene(const aiScene *aiScene);
+
+/**
+ Creates a synthetic skinned character: one node with a single mesh whose
+ vertices are each influenced by the specified number of bones.
+
+ @param nVertices The number of vertices.
+ @param nBones The number of bones.
+ @param weightsPerVertex The number of bones influencing each vertex.
+ @return A new scene which must be released with AKBenchmarkReleaseScene.
+ */
+const aiScene *AKBenchmarkMakeCharacter(unsigned int nVertices,
+                                        unsigned int nBones,
+                                        unsigned int weightsPerVertex);
+
+#endif /* AKBenchmark_h */
@@ -0,0 +1,152 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKGeometry.h"
+#include "AKProgress.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+/**
+ Benchmarks the cancellation latency of the node conversion, the time from
+ cancelling an import on another thread to the conversion stopping.
+
+ The conversion of each node of the scene runs on a worker thread, and is
+ cancelled at a range of delays after it starts. The benchmark fails if the
+ largest latency is over the target.
+
+ usage: AKCancellationBenchmark [target latency in ms] [scene file relative
+ to the assets]
+ */
+
+#pragma mark - Benchmark
+
+/**
+ Converts the geometry of every node of the scene until the import is
+ cancelled.
+
+ @param aiNode The assimp node to start from.
+ @param aiScene The assimp scene.
+ @param stats The scene statistics.
+ @param progress The progress of the import.
+ @return false if the import was cancelled.
+ */
+static bool convertNodes(const struct aiNode *aiNode,
+                         const struct aiScene *aiScene,
+                         const AKSceneStats *stats,
+                         AKProgress *progress)
+{
+    AKNodeGeometry *geometry = AKNodeGeometryCreateWithProgress(
+        aiNode, aiScene, NULL, stats, progress);
+    AKNodeGeometryRelease(geometry);
+    if (!AKProgressCheckpoint(progress))
+    {
+        return false;
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        if (!convertNodes(aiNode->mChildren[i], aiScene, stats, progress))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    double targetMs = argc > 1 ? atof(argv[1]) : 5.0;
+    const char *assetPath =
+        argc > 2 ? argv[2]
+                 : "assimp/models-proprietary/FBX/2013_ASCII/pyramob.fbx";
+    const struct aiScene *aiScene = AKBenchmarkImportScene(assetPath);
+    std::string sceneName = assetPath;
+    if (aiScene == NULL)
+    {
+        aiScene = AKBenchmarkMakeCharacter(2000000, 80, 4);
+        sceneName = "synthetic 2000000 vertices, 80 bones, 4 weights/vertex";
+    }
+    AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+    printf("Scene: %s\n", sceneName.c_str());
+
+    double fullMs = AKBenchmarkMinMilliseconds(3, [&]() {
+        convertNodes(aiScene->mRootNode, aiScene, stats, NULL);
+    });
+    printf("Uncancelled conversion: %.3f ms\n", fullMs);
+
+    double maxLatencyMs = 0.0;
+    double sumLatencyMs = 0.0;
+    int nCancelled = 0;
+    const int nDelays = 20;
+    for (int i = 0; i < nDelays; i++)
+    {
+        AKProgress *progress = AKProgressCreate(NULL, NULL);
+        std::thread worker([&]() {
+            convertNodes(aiScene->mRootNode, aiScene, stats, progress);
+        });
+        usleep((useconds_t)(fullMs * 1000.0 * i / nDelays));
+        AKProgressCancel(progress);
+        worker.join();
+        double latency = AKProgressCancellationLatency(progress);
+        if (latency >= 0.0)
+        {
+            double latencyMs = latency * 1000.0;
+            maxLatencyMs = latencyMs > maxLatencyMs ? latencyMs : maxLatencyMs;
+            sumLatencyMs += latencyMs;
+            nCancelled++;
+        }
+        AKProgressRelease(progress);
+    }
+    AKSceneStatsRelease(stats);
+    AKBenchmarkReleaseScene(aiScene);
+    if (nCancelled == 0)
+    {
+        printf("Every conversion completed before it was cancelled\n");
+        return 0;
+    }
+    printf("Cancelled conversions: %d of %d\n", nCancelled, nDelays);
+    printf("Cancellation latency: mean %.3f ms, max %.3f ms, target %.3f "
+           "ms\n",
+           sumLatencyMs / nCancelled, maxLatencyMs, targetMs);
+    if (maxLatencyMs > targetMs)
+    {
+        printf("Cancellation latency is over the target\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,316 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKFileSystem.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "AKImport.h"
+#include "assimp/postprocess.h" // Post processing flags
+#endif
+
+/**
+ Benchmarks reading the files of the test assets with stdio against the file
+ system of the import, with a cold and a warm page cache.
+
+ Each file is read the way the assimp loaders read it: opened once to check
+ its header and opened again to read it in 4 KB reads. The file system reads
+ the files with buffered streams or memory maps, reopens them from its handle
+ cache and, in the read ahead modes, is asked to read every file ahead before
+ the first file is opened, as the import does for the textures of a scene.
+
+ The cold runs drop the files from the page cache of the kernel before each
+ run, on platforms which can. When built with the assimp library, every file
+ is also imported with each file system mode, cold and warm.
+
+ usage: AKFileIOBenchmark
+ */
+
+#pragma mark - Reading modes
+
+/**
+ The ways the benchmark reads the files.
+ */
+enum AKReadMode
+{
+    AKReadModeStdio,
+    AKReadModeBuffered,
+    AKReadModeBufferedReadAhead,
+    AKReadModeMapped,
+    AKReadModeMappedReadAhead,
+    AKReadModeCount
+};
+
+/**
+ The names of the reading modes.
+ */
+static const char *const AKReadModeNames[AKReadModeCount] = {
+    "stdio", "buffered", "buffered+ahead", "mapped", "mapped+ahead"};
+
+/**
+ The size of the reads of the loaders.
+ */
+static const size_t AKReadSize = 4096;
+
+/**
+ The number of runs of each mode, of which the fastest is reported.
+ */
+static const int AKRuns = 3;
+
+/**
+ Reads a file with stdio as a loader does.
+
+ @param path The path of the file.
+ @param buffer The buffer of AKReadSize bytes to read into.
+ @return The number of bytes read.
+ */
+static size_t readWithStdio(const char *path, char *buffer)
+{
+    size_t nBytes = 0;
+    FILE *header = fopen(path, "rb");
+    if (header == NULL)
+    {
+        return 0;
+    }
+    nBytes += fread(buffer, 1, AKReadSize, header);
+    fclose(header);
+    FILE *stream = fopen(path, "rb");
+    size_t nRead;
+    while ((nRead = fread(buffer, 1, AKReadSize, stream)) > 0)
+    {
+        nBytes += nRead;
+    }
+    fclose(stream);
+    return nBytes;
+}
+
+/**
+ Reads a file with a file system as a loader does.
+
+ @param fs The file system.
+ @param path The path of the file.
+ @param buffer The buffer of AKReadSize bytes to read into.
+ @return The number of bytes read.
+ */
+static size_t readWithFileSystem(AKFileSystem *fs,
+                                 const char *path,
+                                 char *buffer)
+{
+    size_t nBytes = 0;
+    AKFile *header = AKFileSystemOpen(fs, path);
+    if (header == NULL)
+    {
+        return 0;
+    }
+    nBytes += AKFileRead(header, buffer, AKReadSize);
+    AKFileClose(header);
+    AKFile *file = AKFileSystemOpen(fs, path);
+    size_t nRead;
+    while ((nRead = AKFileRead(file, buffer, AKReadSize)) > 0)
+    {
+        nBytes += nRead;
+    }
+    AKFileClose(file);
+    return nBytes;
+}
+
+/**
+ Drops the files from the page cache of the kernel.
+
+ @param paths The paths of the files.
+ @return true if every file was dropped.
+ */
+static bool evictFiles(const std::vector<std::string> &paths)
+{
+    bool evicted = true;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        evicted = AKBenchmarkEvictFile(paths[i].c_str()) && evicted;
+    }
+    return evicted;
+}
+
+/**
+ Reads every file in a reading mode and prints the fastest run.
+
+ @param paths The paths of the files.
+ @param mode The reading mode.
+ @param cold true to drop the files from the page cache before each run.
+ */
+static void benchmarkReads(const std::vector<std::string> &paths,
+                           AKReadMode mode,
+                           bool cold)
+{
+    std::vector<char> buffer(AKReadSize);
+    double best = -1.0;
+    size_t nBytes = 0;
+    AKFileSystemStats stats = {0, 0, 0, 0, 0, 0, 0, 0.0};
+    for (int run = 0; run < AKRuns; run++)
+    {
+        if (cold)
+        {
+            evictFiles(paths);
+        }
+        double start = AKBenchmarkSeconds();
+        nBytes = 0;
+        AKFileSystem *fs = NULL;
+        if (mode != AKReadModeStdio)
+        {
+            fs = AKFileSystemCreate();
+            AKFileSystemSetMapsFiles(fs, mode == AKReadModeMapped ||
+                                             mode == AKReadModeMappedReadAhead);
+        }
+        if (mode == AKReadModeBufferedReadAhead ||
+            mode == AKReadModeMappedReadAhead)
+        {
+            for (size_t i = 0; i < paths.size(); i++)
+            {
+                AKFileSystemReadAheadReference(fs, paths[i].c_str());
+            }
+        }
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            nBytes += fs == NULL
+                          ? readWithStdio(paths[i].c_str(), &buffer[0])
+                          : readWithFileSystem(fs, paths[i].c_str(),
+                                               &buffer[0]);
+        }
+        AKFileSystemStats runStats = {0, 0, 0, 0, 0, 0, 0, 0.0};
+        if (fs != NULL)
+        {
+            runStats = AKFileSystemGetStats(fs);
+            AKFileSystemRelease(fs);
+        }
+        double ms = (AKBenchmarkSeconds() - start) * 1000.0;
+        if (best < 0.0 || ms < best)
+        {
+            best = ms;
+            stats = runStats;
+        }
+    }
+    printf("%-16s %-5s %9.2f %9.1f %7zu %7zu %7zu %9.2f\n",
+           AKReadModeNames[mode], cold ? "cold" : "warm", best,
+           nBytes / (best / 1000.0) / (1024.0 * 1024.0), stats.nOpens,
+           stats.nDiskOpens, stats.nReads, stats.ioSeconds * 1000.0);
+}
+
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+
+#pragma mark - Imports
+
+/**
+ Imports every file with a file system mode and prints the total time and the
+ reads of the imports.
+
+ @param paths The paths of the files.
+ @param mapsFiles true to memory map the files.
+ @param cold true to drop the files from the page cache first.
+ */
+static void benchmarkImports(const std::vector<std::string> &paths,
+                             bool mapsFiles,
+                             bool cold)
+{
+    if (cold)
+    {
+        evictFiles(paths);
+    }
+    AKFileSystemStats total = {0, 0, 0, 0, 0, 0, 0, 0.0};
+    double start = AKBenchmarkSeconds();
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        AKImport *import = AKImportCreate(NULL);
+        AKFileSystemSetMapsFiles(AKImportFileSystem(import), mapsFiles);
+        AKImportReadFile(import, paths[i].c_str(),
+                         aiProcess_FlipUVs | aiProcess_Triangulate);
+        AKFileSystemStats stats =
+            AKFileSystemGetStats(AKImportFileSystem(import));
+        total.nOpens += stats.nOpens;
+        total.nDiskOpens += stats.nDiskOpens;
+        total.nCachedOpens += stats.nCachedOpens;
+        total.nReadAheads += stats.nReadAheads;
+        total.nReads += stats.nReads;
+        total.bytesRead += stats.bytesRead;
+        total.ioSeconds += stats.ioSeconds;
+        AKImportRelease(import);
+    }
+    double ms = (AKBenchmarkSeconds() - start) * 1000.0;
+    printf("%-16s %-5s %9.1f %9.1f %7zu %7zu %7zu %7zu %9.2f\n",
+           mapsFiles ? "import mapped" : "import buffered",
+           cold ? "cold" : "warm", ms, total.bytesRead / (1024.0 * 1024.0),
+           total.nOpens, total.nDiskOpens, total.nReadAheads, total.nReads,
+           total.ioSeconds * 1000.0);
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> paths = AKBenchmarkListAssets();
+    size_t nBytes = 0;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        nBytes += AKBenchmarkFileSize(paths[i].c_str());
+    }
+    bool evicts = evictFiles(paths);
+    printf("Corpus: %zu files of the test assets, %.1f MB, %zu byte reads, "
+           "fastest of %d runs\n",
+           paths.size(), nBytes / (1024.0 * 1024.0), AKReadSize, AKRuns);
+    if (!evicts)
+    {
+        printf("The page cache cannot be dropped, the cold runs are warm\n");
+    }
+    printf("%-16s %-5s %9s %9s %7s %7s %7s %9s\n", "mode", "cache", "ms",
+           "MB/s", "opens", "disk", "reads", "io ms");
+    for (int mode = 0; mode < AKReadModeCount; mode++)
+    {
+        benchmarkReads(paths, (AKReadMode)mode, true);
+        benchmarkReads(paths, (AKReadMode)mode, false);
+    }
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    printf("\n%-16s %-5s %9s %9s %7s %7s %7s %7s %9s\n", "import", "cache",
+           "ms", "MB", "opens", "disk", "ahead", "reads", "io ms");
+    for (int mapped = 0; mapped < 2; mapped++)
+    {
+        benchmarkImports(paths, mapped == 1, true);
+        benchmarkImports(paths, mapped == 1, false);
+    }
+#else
+    printf("\nBuilt without the assimp library, the imports cannot be "
+           "benchmarked\n");
+#endif
+    return 0;
+}
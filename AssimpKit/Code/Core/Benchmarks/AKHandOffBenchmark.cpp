@@ -0,0 +1,198 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKBonePalette.h"
+#include "AKGeometry.h"
+#include "AKSkin.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**
+ Measures the peak resident set size of converting the geometry and skins of a
+ scene into the buffers that are handed to scenekit, when the buffers are
+ copied into the data objects of the geometry sources, as they were, and when
+ their ownership is handed off to the data objects without a copy.
+
+ The converted buffers of every node are kept until the whole scene has been
+ converted, just as the scenekit scene keeps its geometry sources.
+
+ usage: AKHandOffBenchmark [scene file relative to the assets]
+ */
+
+#pragma mark - Conversion
+
+/**
+ Stands in for a data object made from a buffer of the conversion, which
+ either copies the buffer or takes ownership of it.
+
+ @param buffer The buffer, allocated with malloc.
+ @param length The number of bytes of the buffer.
+ @param copy Whether to copy the buffer, leaving it with the caller.
+ @param retained The data objects of the scene.
+ @return Whether the ownership of the buffer was taken.
+ */
+static bool makeData(void *buffer,
+                     size_t length,
+                     bool copy,
+                     std::vector<void *> &retained)
+{
+    if (!copy)
+    {
+        retained.push_back(buffer);
+        return true;
+    }
+    void *data = malloc(length);
+    memcpy(data, buffer, length);
+    retained.push_back(data);
+    return false;
+}
+
+/**
+ Converts the geometry and skin of the node and of its children.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette of the scene.
+ @param copy Whether the data objects copy the buffers.
+ @param retained The data objects of the scene.
+ */
+static void convertNode(const struct aiNode *aiNode,
+                        const struct aiScene *aiScene,
+                        const AKBonePalette *palette,
+                        bool copy,
+                        std::vector<void *> &retained)
+{
+    AKNodeGeometry *geometry = AKNodeGeometryCreate(aiNode, aiScene, NULL);
+    if (geometry != NULL)
+    {
+        if (makeData(geometry->vertexData,
+                     (size_t)geometry->nVertices * geometry->vertexStride,
+                     copy, retained))
+        {
+            geometry->vertexData = NULL;
+        }
+        for (unsigned int i = 0; i < geometry->nElements; i++)
+        {
+            AKGeometryElement *element = &geometry->elements[i];
+            if (element->indices != NULL &&
+                makeData(element->indices,
+                         (size_t)element->nIndices * element->bytesPerIndex,
+                         copy, retained))
+            {
+                element->indices = NULL;
+            }
+        }
+        AKNodeGeometryRelease(geometry);
+    }
+    AKNodeSkin *skin = AKNodeSkinCreate(aiNode, aiScene, palette);
+    if (skin != NULL)
+    {
+        size_t nWeights = (size_t)skin->nVertices * skin->maxWeights;
+        if (makeData(skin->boneWeights, nWeights * sizeof(float), copy,
+                     retained))
+        {
+            skin->boneWeights = NULL;
+        }
+        if (makeData(skin->boneIndices, nWeights * sizeof(short), copy,
+                     retained))
+        {
+            skin->boneIndices = NULL;
+        }
+        AKNodeSkinRelease(skin);
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        convertNode(aiNode->mChildren[i], aiScene, palette, copy, retained);
+    }
+}
+
+/**
+ Converts the scene and releases the data objects.
+
+ @param aiScene The assimp scene.
+ @param copy Whether the data objects copy the buffers.
+ */
+static void convertScene(const struct aiScene *aiScene, bool copy)
+{
+    std::vector<void *> retained;
+    AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+    convertNode(aiScene->mRootNode, aiScene, palette, copy, retained);
+    AKBonePaletteRelease(palette);
+    for (size_t i = 0; i < retained.size(); i++)
+    {
+        free(retained[i]);
+    }
+}
+
+#pragma mark - Benchmark
+
+int main(int argc, char **argv)
+{
+    const char *assetPath =
+        argc > 1 ? argv[1]
+                 : "assimp/models-proprietary/FBX/2013_ASCII/pyramob.fbx";
+    const struct aiScene *aiScene = AKBenchmarkImportScene(assetPath);
+    std::string sceneName = assetPath;
+    if (aiScene == NULL)
+    {
+        // a skinned character larger than any asset of the corpus
+        aiScene = AKBenchmarkMakeCharacter(1000000, 80, 4);
+        sceneName = "synthetic 1000000 vertices, 80 bones, 4 weights/vertex";
+    }
+    printf("Scene: %s\n", sceneName.c_str());
+
+    long sceneKb = AKBenchmarkPeakKilobytes([]() {});
+    long copyKb =
+        AKBenchmarkPeakKilobytes([&]() { convertScene(aiScene, true); });
+    long handOffKb =
+        AKBenchmarkPeakKilobytes([&]() { convertScene(aiScene, false); });
+    AKBenchmarkReleaseScene(aiScene);
+    if (sceneKb < 0 || copyKb < 0 || handOffKb < 0)
+    {
+        fprintf(stderr, "A benchmark process failed\n");
+        return 1;
+    }
+
+    printf("Peak RSS of the imported scene: %9ld KB\n", sceneKb);
+    printf("Peak RSS, copied buffers:       %9ld KB (+%ld KB)\n", copyKb,
+           copyKb - sceneKb);
+    printf("Peak RSS, handed off buffers:   %9ld KB (+%ld KB)\n", handOffKb,
+           handOffKb - sceneKb);
+    return 0;
+}
@@ -0,0 +1,331 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAnimation.h"
+#include "AKBenchmark.h"
+#include "AKBonePalette.h"
+#include "AKImportOptions.h"
+#include "AKMeshStats.h"
+#include "AKSceneGeometry.h"
+#include "AKSkin.h"
+#include "assimp/postprocess.h" // Post processing flags
+#include <stdio.h>
+#include <string>
+#include <vector>
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "AKFileSystem.h"
+#include "AKImport.h"
+#endif
+
+/**
+ Benchmarks the import of the Apple Collada animation files for each set of
+ scene components, such as only the animations of a file which animates a
+ model imported before.
+
+ For each set, the post processing steps kept of a typical realtime set of
+ steps are listed, then every file is imported and converted by the core the
+ way the importer does for the components: the node geometries, the skins,
+ the bone palette and the animation tracks. The bytes read show the textures
+ which are no longer read ahead.
+
+ Without the assimp library, the conversion is measured on a synthetic
+ skinned character instead.
+
+ usage: AKImportComponentsBenchmark
+ */
+
+#pragma mark - Component sets
+
+/**
+ A set of scene components.
+ */
+struct AKComponentSet
+{
+    /**
+     The name of the set.
+     */
+    const char *name;
+
+    /**
+     The AKImportComponent flags.
+     */
+    unsigned int components;
+};
+
+/**
+ The component sets of the benchmark.
+ */
+static const AKComponentSet AKComponentSets[] = {
+    {"all", AKImportComponentAll},
+    {"no textures", AKImportComponentAll & ~AKImportComponentTextures},
+    {"geometry", AKImportComponentGeometry | AKImportComponentMaterials |
+                     AKImportComponentTextures},
+    {"animations", AKImportComponentAnimations}};
+
+/**
+ The number of component sets.
+ */
+static const int AKNumComponentSets =
+    sizeof(AKComponentSets) / sizeof(AKComponentSets[0]);
+
+/**
+ The post processing steps of the benchmark, a typical realtime set.
+ */
+static const unsigned int AKBenchmarkFlags =
+    aiProcess_FlipUVs | aiProcess_Triangulate |
+    aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals |
+    aiProcess_ImproveCacheLocality | aiProcess_LimitBoneWeights |
+    aiProcess_RemoveRedundantMaterials | aiProcess_SortByPType;
+
+/**
+ Counts the post processing steps of a set of flags.
+
+ @param flags The post processing steps.
+ @return The number of steps.
+ */
+static int countSteps(unsigned int flags)
+{
+    int n = 0;
+    for (; flags != 0; flags &= flags - 1)
+    {
+        n++;
+    }
+    return n;
+}
+
+#pragma mark - Conversion
+
+/**
+ Makes the skins of a node and its children.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette.
+ @param stats The scene statistics.
+ */
+static void makeSkins(const struct aiNode *aiNode,
+                      const struct aiScene *aiScene,
+                      const AKBonePalette *palette,
+                      const AKSceneStats *stats)
+{
+    AKNodeSkinRelease(
+        AKNodeSkinCreateWithStats(aiNode, aiScene, palette, stats));
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        makeSkins(aiNode->mChildren[i], aiScene, palette, stats);
+    }
+}
+
+/**
+ Converts a scene with the core the way the importer does for the specified
+ components.
+
+ @param aiScene The assimp scene.
+ @param components The AKImportComponent flags.
+ */
+static void convertScene(const struct aiScene *aiScene,
+                         unsigned int components)
+{
+    AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+    if (components & AKImportComponentGeometry)
+    {
+        AKSceneGeometryRelease(
+            AKSceneGeometryCreate(aiScene, NULL, stats, NULL, NULL));
+    }
+    if (components & (AKImportComponentSkinning | AKImportComponentAnimations))
+    {
+        AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+        if ((components & AKImportComponentGeometry) &&
+            (components & AKImportComponentSkinning))
+        {
+            makeSkins(aiScene->mRootNode, aiScene, palette, stats);
+        }
+        AKBonePaletteRelease(palette);
+    }
+    if (components & AKImportComponentAnimations)
+    {
+        for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+        {
+            AKAnimationTracksRelease(
+                AKAnimationTracksCreate(aiScene->mAnimations[i]));
+        }
+    }
+    AKSceneStatsRelease(stats);
+}
+
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+
+#pragma mark - Imports
+
+/**
+ The cost of importing the files with a set of components.
+ */
+struct AKImportCost
+{
+    /**
+     The time to read and post process the files, in milliseconds.
+     */
+    double importMs;
+
+    /**
+     The time to convert the files, in milliseconds.
+     */
+    double convertMs;
+
+    /**
+     The number of bytes read.
+     */
+    size_t bytesRead;
+};
+
+/**
+ Imports and converts a file with a set of components, keeping the fastest of
+ three runs.
+
+ @param path The path of the file.
+ @param components The AKImportComponent flags.
+ @param cost The cost to add to.
+ */
+static void importFile(const std::string &path,
+                       unsigned int components,
+                       AKImportCost *cost)
+{
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    options.components = components;
+    double importMs = -1.0;
+    double convertMs = -1.0;
+    size_t bytesRead = 0;
+    for (int run = 0; run < 3; run++)
+    {
+        AKImport *import = AKImportCreate(NULL);
+        AKImportSetOptions(import, &options);
+        double start = AKBenchmarkSeconds();
+        const struct aiScene *aiScene =
+            AKImportReadFile(import, path.c_str(), AKBenchmarkFlags);
+        double ms = (AKBenchmarkSeconds() - start) * 1000.0;
+        importMs = importMs < 0.0 || ms < importMs ? ms : importMs;
+        if (aiScene != NULL)
+        {
+            start = AKBenchmarkSeconds();
+            convertScene(aiScene, components);
+            ms = (AKBenchmarkSeconds() - start) * 1000.0;
+            convertMs = convertMs < 0.0 || ms < convertMs ? ms : convertMs;
+        }
+        bytesRead = AKFileSystemGetStats(AKImportFileSystem(import)).bytesRead;
+        AKImportRelease(import);
+    }
+    cost->importMs += importMs;
+    cost->convertMs += convertMs > 0.0 ? convertMs : 0.0;
+    cost->bytesRead += bytesRead;
+}
+
+/**
+ Lists the Apple Collada files of the test assets.
+
+ @return The paths of the files.
+ */
+static std::vector<std::string> listAppleColladaFiles()
+{
+    std::vector<std::string> assets = AKBenchmarkListAssets();
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < assets.size(); i++)
+    {
+        const std::string &path = assets[i];
+        if (path.find("/apple/") != std::string::npos &&
+            path.size() > 4 && path.compare(path.size() - 4, 4, ".dae") == 0)
+        {
+            paths.push_back(path);
+        }
+    }
+    return paths;
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+    printf("%-12s %6s %s\n", "components", "steps", "removed");
+    for (int s = 0; s < AKNumComponentSets; s++)
+    {
+        AKImportOptions options = AKImportOptionsMakeDefault();
+        options.components = AKComponentSets[s].components;
+        unsigned int flags =
+            AKImportOptionsPostProcessFlags(&options, AKBenchmarkFlags);
+        printf("%-12s %3d/%-2d %s\n", AKComponentSets[s].name,
+               countSteps(flags & ~aiProcess_RemoveComponent),
+               countSteps(AKBenchmarkFlags),
+               flags & aiProcess_RemoveComponent ? "yes" : "no");
+    }
+    printf("\n");
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    std::vector<std::string> paths = listAppleColladaFiles();
+    printf("Corpus: %zu Apple Collada files, fastest of 3 runs per file\n",
+           paths.size());
+    printf("%-12s %10s %10s %10s %8s %10s\n", "components", "import ms",
+           "convert ms", "total ms", "saving", "KB read");
+    double allMs = 0.0;
+    for (int s = 0; s < AKNumComponentSets; s++)
+    {
+        AKImportCost cost = {0.0, 0.0, 0};
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            importFile(paths[i], AKComponentSets[s].components, &cost);
+        }
+        double totalMs = cost.importMs + cost.convertMs;
+        allMs = s == 0 ? totalMs : allMs;
+        printf("%-12s %10.1f %10.1f %10.1f %7.1f%% %10.1f\n",
+               AKComponentSets[s].name, cost.importMs, cost.convertMs,
+               totalMs, allMs > 0.0 ? 100.0 * (1.0 - totalMs / allMs) : 0.0,
+               cost.bytesRead / 1024.0);
+    }
+#else
+    const struct aiScene *aiScene = AKBenchmarkMakeCharacter(60000, 80, 4);
+    printf("Built without the assimp library, converting a synthetic "
+           "character of 60000 vertices and 80 bones\n");
+    printf("%-12s %10s %8s\n", "components", "convert ms", "saving");
+    double allMs = 0.0;
+    for (int s = 0; s < AKNumComponentSets; s++)
+    {
+        unsigned int components = AKComponentSets[s].components;
+        double ms = AKBenchmarkMinMilliseconds(
+            5, [&]() { convertScene(aiScene, components); });
+        allMs = s == 0 ? ms : allMs;
+        printf("%-12s %10.2f %7.1f%%\n", AKComponentSets[s].name, ms,
+               allMs > 0.0 ? 100.0 * (1.0 - ms / allMs) : 0.0);
+    }
+    AKBenchmarkReleaseScene(aiScene);
+#endif
+    return 0;
+}
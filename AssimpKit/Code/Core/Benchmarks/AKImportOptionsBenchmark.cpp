@@ -0,0 +1,282 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKImportOptions.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "AKImport.h"
+#include "assimp/postprocess.h" // Post processing flags
+#endif
+
+/**
+ Benchmarks the import time of the test assets against the render cost of the
+ imported meshes for a range of import options.
+
+ For each set of options, every file of the test assets is imported with the
+ post processing steps which the options tune. The render cost is measured as
+ the number of meshes, which each take a draw call, the number of vertices,
+ the largest number of bones which affect a vertex and the average cache miss
+ ratio (ACMR) of the triangles on a 32 entry FIFO post transform vertex cache.
+
+ The options tune assimp only, so the benchmark needs the assimp library.
+
+ usage: AKImportOptionsBenchmark
+ */
+
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+
+#pragma mark - Render cost
+
+/**
+ The render cost of the meshes of the imported scenes.
+ */
+struct AKRenderCost
+{
+    /**
+     The number of meshes.
+     */
+    size_t nMeshes;
+
+    /**
+     The number of vertices.
+     */
+    size_t nVertices;
+
+    /**
+     The number of triangles.
+     */
+    size_t nTriangles;
+
+    /**
+     The number of vertices transformed by a FIFO vertex cache.
+     */
+    size_t nCacheMisses;
+
+    /**
+     The largest number of bones which affect a vertex.
+     */
+    unsigned int maxBoneWeights;
+};
+
+/**
+ The number of entries of the simulated post transform vertex cache.
+ */
+static const size_t AKCacheSize = 32;
+
+/**
+ Counts the vertices which miss a FIFO post transform vertex cache when the
+ triangles of a mesh are drawn in order.
+
+ @param aiMesh The assimp mesh.
+ @return The number of cache misses.
+ */
+static size_t countCacheMisses(const struct aiMesh *aiMesh)
+{
+    std::vector<unsigned int> stamps(aiMesh->mNumVertices, 0);
+    unsigned int clock = 0;
+    size_t misses = 0;
+    for (unsigned int i = 0; i < aiMesh->mNumFaces; i++)
+    {
+        const struct aiFace *aiFace = &aiMesh->mFaces[i];
+        for (unsigned int j = 0; j < aiFace->mNumIndices; j++)
+        {
+            unsigned int index = aiFace->mIndices[j];
+            // a vertex stays in the cache until AKCacheSize newer misses
+            if (stamps[index] == 0 || clock - stamps[index] >= AKCacheSize)
+            {
+                stamps[index] = ++clock;
+                misses++;
+            }
+        }
+    }
+    return misses;
+}
+
+/**
+ Adds the render cost of the meshes of a scene.
+
+ @param aiScene The assimp scene.
+ @param cost The render cost to add to.
+ */
+static void addRenderCost(const struct aiScene *aiScene, AKRenderCost *cost)
+{
+    for (unsigned int i = 0; i < aiScene->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[i];
+        cost->nMeshes++;
+        cost->nVertices += aiMesh->mNumVertices;
+        cost->nTriangles += aiMesh->mNumFaces;
+        cost->nCacheMisses += countCacheMisses(aiMesh);
+        std::vector<unsigned int> weights(aiMesh->mNumVertices, 0);
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            const struct aiBone *aiBone = aiMesh->mBones[j];
+            for (unsigned int k = 0; k < aiBone->mNumWeights; k++)
+            {
+                unsigned int n = ++weights[aiBone->mWeights[k].mVertexId];
+                cost->maxBoneWeights =
+                    n > cost->maxBoneWeights ? n : cost->maxBoneWeights;
+            }
+        }
+    }
+}
+
+#pragma mark - Option sets
+
+/**
+ A set of import options and the post processing steps which they tune.
+ */
+struct AKOptionSet
+{
+    /**
+     The name of the set.
+     */
+    const char *name;
+
+    /**
+     The post processing steps.
+     */
+    unsigned int postProcessFlags;
+
+    /**
+     The import options.
+     */
+    AKImportOptions options;
+};
+
+/**
+ Makes the option sets of the benchmark, each tuning one option of the
+ default options.
+
+ @return The option sets.
+ */
+static std::vector<AKOptionSet> makeOptionSets()
+{
+    const unsigned int flags = aiProcess_FlipUVs | aiProcess_Triangulate |
+                               aiProcess_JoinIdenticalVertices;
+    const AKImportOptions defaults = AKImportOptionsMakeDefault();
+    std::vector<AKOptionSet> sets;
+    AKOptionSet set = {"default", flags, defaults};
+    sets.push_back(set);
+
+    const unsigned int splitLimits[] = {65535, 21845};
+    for (int i = 0; i < 2; i++)
+    {
+        set.name = i == 0 ? "split 65535" : "split 21845";
+        set.postProcessFlags = flags | aiProcess_SplitLargeMeshes;
+        set.options = defaults;
+        set.options.splitVertexLimit = splitLimits[i];
+        set.options.splitTriangleLimit = splitLimits[i];
+        sets.push_back(set);
+    }
+
+    const unsigned int boneWeights[] = {4, 2, 1};
+    const char *boneWeightNames[] = {"weights 4", "weights 2", "weights 1"};
+    for (int i = 0; i < 3; i++)
+    {
+        set.name = boneWeightNames[i];
+        set.postProcessFlags = flags | aiProcess_LimitBoneWeights;
+        set.options = defaults;
+        set.options.maxBoneWeights = boneWeights[i];
+        sets.push_back(set);
+    }
+
+    const unsigned int cacheSizes[] = {12, 24, 32};
+    const char *cacheNames[] = {"cache 12", "cache 24", "cache 32"};
+    for (int i = 0; i < 3; i++)
+    {
+        set.name = cacheNames[i];
+        set.postProcessFlags = flags | aiProcess_ImproveCacheLocality;
+        set.options = defaults;
+        set.options.vertexCacheSize = cacheSizes[i];
+        sets.push_back(set);
+    }
+
+    set.name = "smooth 80";
+    set.postProcessFlags = flags | aiProcess_GenSmoothNormals;
+    set.options = defaults;
+    set.options.maxSmoothingAngle = 80.0f;
+    sets.push_back(set);
+    set.name = "smooth fast";
+    set.options.favourSpeed = 1;
+    sets.push_back(set);
+    return sets;
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    std::vector<std::string> paths = AKBenchmarkListAssets();
+    printf("Corpus: %zu files of the test assets, FIFO cache of %zu\n",
+           paths.size(), AKCacheSize);
+    printf("%-12s %10s %8s %10s %10s %6s %8s\n", "options", "ms", "meshes",
+           "vertices", "triangles", "bones", "ACMR");
+    std::vector<AKOptionSet> sets = makeOptionSets();
+    for (size_t s = 0; s < sets.size(); s++)
+    {
+        AKRenderCost cost = {0, 0, 0, 0, 0};
+        double ms = 0.0;
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            AKImport *import = AKImportCreate(NULL);
+            AKImportSetOptions(import, &sets[s].options);
+            double start = AKBenchmarkSeconds();
+            const struct aiScene *aiScene = AKImportReadFile(
+                import, paths[i].c_str(), sets[s].postProcessFlags);
+            ms += (AKBenchmarkSeconds() - start) * 1000.0;
+            if (aiScene != NULL)
+            {
+                addRenderCost(aiScene, &cost);
+            }
+            AKImportRelease(import);
+        }
+        printf("%-12s %10.1f %8zu %10zu %10zu %6u %8.3f\n", sets[s].name, ms,
+               cost.nMeshes, cost.nVertices, cost.nTriangles,
+               cost.maxBoneWeights,
+               cost.nTriangles > 0
+                   ? (double)cost.nCacheMisses / cost.nTriangles
+                   : 0.0);
+    }
+#else
+    printf("Built without the assimp library, the import options cannot be "
+           "benchmarked\n");
+#endif
+    return 0;
+}
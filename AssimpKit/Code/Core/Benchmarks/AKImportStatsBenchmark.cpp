@@ -0,0 +1,172 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKImportStats.h"
+#include "AKSceneGeometry.h"
+#include "AKTestScene.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/**
+ Benchmarks the overhead of measuring an import: converts the geometry of
+ every node of a scene as the importer does, without and with the import
+ stats, which count the scene, add the bytes of each node geometry and read
+ the clock around the materials of each node, and prints the JSON of the
+ measured conversion.
+
+ usage: AKImportStatsBenchmark [scene file relative to the assets]
+ */
+
+#pragma mark - Scenes
+
+/**
+ Creates a synthetic architectural scene: a root with 50 floors of 100 parts,
+ each part a node with its own mesh of 30 to 930 vertices.
+
+ @return A new scene which must be released with AKBenchmarkReleaseScene.
+ */
+static const aiScene *makeBuilding()
+{
+    aiNode *root = AKTestMakeNode("building");
+    std::vector<aiMesh *> meshes;
+    for (unsigned int f = 0; f < 50; f++)
+    {
+        aiNode *floor = AKTestMakeNode("floor");
+        for (unsigned int p = 0; p < 100; p++)
+        {
+            unsigned int nVertices = 30 + (f * 100 + p) * 37 % 900;
+            meshes.push_back(AKTestMakeMesh(nVertices, nVertices - 2,
+                                            AKTestMeshAllStreams,
+                                            (float)meshes.size()));
+            AKTestAddChild(
+                floor, AKTestMakeNode("part", std::vector<unsigned int>(
+                                                  1, meshes.size() - 1)));
+        }
+        AKTestAddChild(root, floor);
+    }
+    return AKTestMakeScene(root, meshes);
+}
+
+#pragma mark - Conversion
+
+/**
+ Converts the geometry of every node of the scene and takes it as the
+ importer does, measuring the conversion if stats are given.
+
+ @param aiScene The assimp scene.
+ @param sceneStats The statistics of the meshes of the scene.
+ @param stats The import stats, or NULL to convert without measuring.
+ */
+static void convertScene(const struct aiScene *aiScene,
+                         const AKSceneStats *sceneStats,
+                         AKImportStats *stats)
+{
+    double start = stats != NULL ? AKImportStatsClock() : 0;
+    if (stats != NULL)
+    {
+        AKImportStatsAddScene(stats, aiScene);
+    }
+    AKSceneGeometry *sceneGeometry =
+        AKSceneGeometryCreate(aiScene, NULL, sceneStats, NULL, NULL);
+    for (unsigned int i = 0; i < AKSceneGeometryNodeCount(sceneGeometry); i++)
+    {
+        AKNodeGeometry *geometry = AKSceneGeometryTake(
+            sceneGeometry, AKSceneGeometryNodeAt(sceneGeometry, i));
+        if (geometry == NULL)
+        {
+            continue;
+        }
+        if (stats != NULL)
+        {
+            AKImportStatsAddGeometry(stats, geometry);
+            AKImportStatsAddPhaseTime(stats, AKImportPhaseMaterials,
+                                      AKImportStatsClock());
+        }
+        AKNodeGeometryRelease(geometry);
+    }
+    AKSceneGeometryRelease(sceneGeometry);
+    if (stats != NULL)
+    {
+        AKImportStatsAddPhaseTime(stats, AKImportPhaseGeometry, start);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const struct aiScene *aiScene = NULL;
+    std::string sceneName;
+    if (argc > 1)
+    {
+        aiScene = AKBenchmarkImportScene(argv[1]);
+        sceneName = argv[1];
+    }
+    if (aiScene == NULL)
+    {
+        aiScene = makeBuilding();
+        sceneName = "synthetic building, 50 floors of 100 parts";
+    }
+    AKSceneStats *sceneStats = AKSceneStatsCreate(aiScene);
+    printf("Scene: %s, %u meshes\n", sceneName.c_str(), sceneStats->nMeshes);
+
+    // the runs alternate, so that both conversions see the same heap
+    double plainMs = -1.0;
+    double measuredMs = -1.0;
+    AKImportStats stats = AKImportStatsMakeEmpty();
+    for (int i = 0; i < 9; i++)
+    {
+        double ms = AKBenchmarkMinMilliseconds(1, [&]() {
+            convertScene(aiScene, sceneStats, NULL);
+        });
+        plainMs = plainMs < 0.0 || ms < plainMs ? ms : plainMs;
+        ms = AKBenchmarkMinMilliseconds(1, [&]() {
+            stats = AKImportStatsMakeEmpty();
+            convertScene(aiScene, sceneStats, &stats);
+        });
+        measuredMs = measuredMs < 0.0 || ms < measuredMs ? ms : measuredMs;
+    }
+    printf("%-10s %10s %10s\n", "stats", "ms", "overhead");
+    printf("%-10s %10.2f %9.2f%%\n", "off", plainMs, 0.0);
+    printf("%-10s %10.2f %9.2f%%\n", "on", measuredMs,
+           (measuredMs - plainMs) * 100.0 / plainMs);
+
+    std::vector<char> json(AKImportStatsFormatJSON(&stats, NULL, 0) + 1);
+    AKImportStatsFormatJSON(&stats, &json[0], json.size());
+    printf("%s\n", &json[0]);
+    AKSceneStatsRelease(sceneStats);
+    AKBenchmarkReleaseScene(aiScene);
+    return 0;
+}
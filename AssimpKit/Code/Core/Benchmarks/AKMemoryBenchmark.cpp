@@ -0,0 +1,286 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAnimation.h"
+#include "AKBenchmark.h"
+#include "AKBonePalette.h"
+#include "AKImportStats.h"
+#include "AKMemory.h"
+#include "AKMeshStats.h"
+#include "AKSceneGeometry.h"
+#include "AKSkin.h"
+#include "assimp/postprocess.h" // Post processing flags
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "AKImport.h"
+#endif
+
+/**
+ Prints the memory profile of the import of every file of the test assets, so
+ that a change which makes an import phase allocate or retain more memory is
+ seen in the numbers of the files it affects.
+
+ Each file is read and post processed by assimp, then converted by the core
+ the way the importer does: the node geometries, the bone palette and the
+ skins, and the animation tracks, each in its own phase of the memory account
+ of the import. The buffers of the conversion are kept until every phase has
+ run, like the scene made by the importer keeps them. Once they are released,
+ the account must be back to no live bytes, or the benchmark fails with the
+ leaking files.
+
+ Without the assimp library, the conversion is profiled on synthetic skinned
+ characters instead.
+
+ usage: AKMemoryBenchmark [--json]
+
+ --json prints the import stats of each file as JSON after its row.
+ */
+
+#pragma mark - Conversion
+
+/**
+ The post processing steps of the benchmark, a typical realtime set.
+ */
+static const unsigned int AKBenchmarkFlags =
+    aiProcess_FlipUVs | aiProcess_Triangulate |
+    aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals |
+    aiProcess_ImproveCacheLocality | aiProcess_LimitBoneWeights |
+    aiProcess_RemoveRedundantMaterials | aiProcess_SortByPType;
+
+/**
+ Makes the skins of a node and its children.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette.
+ @param stats The scene statistics.
+ @param skins The skins to add to.
+ */
+static void makeSkins(const struct aiNode *aiNode,
+                      const struct aiScene *aiScene,
+                      const AKBonePalette *palette,
+                      const AKSceneStats *stats,
+                      std::vector<AKNodeSkin *> *skins)
+{
+    AKNodeSkin *skin =
+        AKNodeSkinCreateWithStats(aiNode, aiScene, palette, stats);
+    if (skin != NULL)
+    {
+        skins->push_back(skin);
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        makeSkins(aiNode->mChildren[i], aiScene, palette, stats, skins);
+    }
+}
+
+/**
+ Converts a scene with the core the way the importer does, charging each
+ phase of the conversion to a memory account.
+
+ @param aiScene The assimp scene.
+ @param account The memory account.
+ @return The memory stats of the account before the buffers of the
+ conversion are released.
+ */
+static AKMemoryStats convertScene(const struct aiScene *aiScene,
+                                  AKMemoryAccount *account)
+{
+    AKMemoryAccount *previous = AKMemoryAccountMakeCurrent(account);
+    AKMemoryAccountSetPhase(account, AKImportPhaseGeometry);
+    AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+    AKSceneGeometry *sceneGeometry =
+        AKSceneGeometryCreate(aiScene, NULL, stats, NULL, NULL);
+    AKMemoryAccountSetPhase(account, AKImportPhaseSkin);
+    AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+    std::vector<AKNodeSkin *> skins;
+    makeSkins(aiScene->mRootNode, aiScene, palette, stats, &skins);
+    AKMemoryAccountSetPhase(account, AKImportPhaseAnimations);
+    std::vector<AKAnimationTracks *> tracks;
+    for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+    {
+        tracks.push_back(AKAnimationTracksCreate(aiScene->mAnimations[i]));
+    }
+    AKMemoryStats memory = AKMemoryAccountGetStats(account);
+    for (size_t i = 0; i < tracks.size(); i++)
+    {
+        AKAnimationTracksRelease(tracks[i]);
+    }
+    for (size_t i = 0; i < skins.size(); i++)
+    {
+        AKNodeSkinRelease(skins[i]);
+    }
+    AKBonePaletteRelease(palette);
+    AKSceneGeometryRelease(sceneGeometry);
+    AKSceneStatsRelease(stats);
+    AKMemoryAccountMakeCurrent(previous);
+    return memory;
+}
+
+/**
+ Returns the bytes of the account still live in the current phase, which are
+ the bytes leaked once every buffer of the conversion is released.
+
+ @param account The memory account.
+ @return The live bytes.
+ */
+static size_t liveBytes(const AKMemoryAccount *account)
+{
+    AKMemoryStats memory = AKMemoryAccountGetStats(account);
+    return memory.phases[AKImportPhaseAnimations].bytesRetained;
+}
+
+#pragma mark - Report
+
+/**
+ Prints the header of the memory profile.
+ */
+static void printHeader()
+{
+    printf("%-28s %9s %9s %9s %9s %9s %9s %9s\n", "file", "scene KB",
+           "geom KB", "geom pk", "skin pk", "anim pk", "peak KB",
+           "RSS KB");
+}
+
+/**
+ Prints the memory profile of a file.
+
+ @param name The name of the file.
+ @param memory The memory stats of its import.
+ */
+static void printRow(const std::string &name, const AKMemoryStats &memory)
+{
+    std::string shortName = name.size() > 28 ? name.substr(0, 28) : name;
+    printf("%-28s %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+           shortName.c_str(), memory.sceneBytes / 1024.0,
+           memory.phases[AKImportPhaseGeometry].bytesAllocated / 1024.0,
+           memory.phases[AKImportPhaseGeometry].peakBytes / 1024.0,
+           memory.phases[AKImportPhaseSkin].peakBytes / 1024.0,
+           memory.phases[AKImportPhaseAnimations].peakBytes / 1024.0,
+           memory.peakBytes / 1024.0, memory.peakFootprintBytes / 1024.0);
+}
+
+/**
+ Prints the import stats of a file as JSON.
+
+ @param stats The import stats.
+ */
+static void printJSON(const AKImportStats &stats)
+{
+    std::vector<char> json(AKImportStatsFormatJSON(&stats, NULL, 0) + 1);
+    AKImportStatsFormatJSON(&stats, json.data(), json.size());
+    printf("%s\n", json.data());
+}
+
+int main(int argc, char **argv)
+{
+    bool printsJSON = argc > 1 && strcmp(argv[1], "--json") == 0;
+    int nLeaks = 0;
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    std::vector<std::string> paths = AKBenchmarkListAssets();
+    printf("Corpus: %zu files\n", paths.size());
+    printHeader();
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        const std::string &path = paths[i];
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        AKImport *import = AKImportCreate(NULL);
+        const struct aiScene *aiScene =
+            AKImportReadFile(import, path.c_str(), AKBenchmarkFlags);
+        if (aiScene == NULL)
+        {
+            printf("%-28s failed to import\n", name.c_str());
+            AKImportRelease(import);
+            continue;
+        }
+        AKMemoryAccount *account = AKImportMemoryAccount(import);
+        AKImportStats stats = AKImportGetStats(import);
+        stats.memory = convertScene(aiScene, account);
+        stats.memory.sceneBytes = AKMemorySceneBytes(aiScene);
+        printRow(name, stats.memory);
+        if (printsJSON)
+        {
+            printJSON(stats);
+        }
+        if (liveBytes(account) != 0)
+        {
+            printf("%-28s leaks %zu bytes\n", name.c_str(),
+                   liveBytes(account));
+            nLeaks++;
+        }
+        AKImportRelease(import);
+    }
+#else
+    const unsigned int nVertices[] = {5000, 20000, 60000, 120000};
+    const unsigned int nBones[] = {20, 40, 80, 120};
+    printf("Built without the assimp library, profiling synthetic "
+           "characters\n");
+    printHeader();
+    for (int i = 0; i < 4; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "character %u/%u", nVertices[i],
+                 nBones[i]);
+        const struct aiScene *aiScene =
+            AKBenchmarkMakeCharacter(nVertices[i], nBones[i], 4);
+        AKMemoryAccount *account = AKMemoryAccountCreate();
+        AKImportStats stats = AKImportStatsMakeEmpty();
+        stats.memory = convertScene(aiScene, account);
+        stats.memory.sceneBytes = AKMemorySceneBytes(aiScene);
+        printRow(name, stats.memory);
+        if (printsJSON)
+        {
+            AKImportStatsAddScene(&stats, aiScene);
+            printJSON(stats);
+        }
+        if (liveBytes(account) != 0)
+        {
+            printf("%-28s leaks %zu bytes\n", name, liveBytes(account));
+            nLeaks++;
+        }
+        AKMemoryAccountRelease(account);
+        AKBenchmarkReleaseScene(aiScene);
+    }
+#endif
+    if (nLeaks > 0)
+    {
+        printf("%d imports leak memory\n", nLeaks);
+        return 1;
+    }
+    return 0;
+}
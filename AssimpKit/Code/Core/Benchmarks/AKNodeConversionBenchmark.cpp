@@ -0,0 +1,409 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKBonePalette.h"
+#include "AKGeometry.h"
+#include "AKMeshStats.h"
+#include "AKSkin.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**
+ Benchmarks the fused node conversion, which finds the statistics of every
+ mesh once per scene and fills every attribute of a mesh in one sweep over its
+ vertices, against the multi pass conversion it replaced, which walked the
+ meshes of a node once to count the vertices, once per attribute to find if
+ the node has it, once per attribute to copy it, once for the indices and
+ three more times for the skin.
+
+ The time, and where the platform allows it the instructions and cache misses,
+ are reported per vertex.
+
+ usage: AKNodeConversionBenchmark [scene file relative to the assets]
+ */
+
+#pragma mark - Multi pass conversion
+
+/**
+ The buffers of a node made by the multi pass conversion, with every attribute
+ stored as floats and colors without alpha, as in the default vertex layout.
+ */
+struct AKMultiPassNode
+{
+    std::vector<unsigned char> vertexData;
+    std::vector<std::vector<unsigned int> > indices;
+    std::vector<float> boneWeights;
+    std::vector<short> boneIndices;
+};
+
+/**
+ Copies a vector stream of each mesh of the node into an attribute of the
+ interleaved vertices, like the multi pass conversion did for each attribute.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param stream Returns the stream of a mesh or NULL if the mesh has none.
+ @param nComponents The number of components of the attribute.
+ @param offset The offset of the attribute in a vertex.
+ @param stride The number of bytes of a vertex.
+ @param dst The interleaved vertices.
+ */
+template <typename StreamAccessor>
+static void copyStream(const struct aiNode *aiNode,
+                       const struct aiScene *aiScene,
+                       StreamAccessor stream,
+                       unsigned int nComponents,
+                       unsigned int offset,
+                       unsigned int stride,
+                       unsigned char *dst)
+{
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        const aiVector3D *src = stream(aiMesh);
+        for (unsigned int j = 0; src != NULL && j < aiMesh->mNumVertices; j++)
+        {
+            const float v[3] = {src[j].x, src[j].y, src[j].z};
+            memcpy(dst + (size_t)j * stride + offset, v,
+                   nComponents * sizeof(float));
+        }
+        dst += (size_t)aiMesh->mNumVertices * stride;
+    }
+}
+
+/**
+ Finds if any mesh of the node has a stream, walking the meshes of the node.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param stream Returns the stream of a mesh or NULL if the mesh has none.
+ @return true if any mesh has the stream.
+ */
+template <typename StreamAccessor>
+static bool anyMeshHasStream(const struct aiNode *aiNode,
+                             const struct aiScene *aiScene,
+                             StreamAccessor stream)
+{
+    bool has = false;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        has = has || stream(aiScene->mMeshes[aiNode->mMeshes[i]]) != NULL;
+    }
+    return has;
+}
+
+/**
+ Converts the geometry and skin of a node like the multi pass conversion did.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param palette The bone palette of the scene.
+ @param node The converted buffers.
+ */
+static void convertMultiPass(const struct aiNode *aiNode,
+                             const struct aiScene *aiScene,
+                             const AKBonePalette *palette,
+                             AKMultiPassNode &node)
+{
+    const aiVector3D *(*streams[4])(const struct aiMesh *) = {
+        [](const struct aiMesh *m) -> const aiVector3D * {
+            return m->mVertices;
+        },
+        [](const struct aiMesh *m) -> const aiVector3D * {
+            return m->mNormals;
+        },
+        [](const struct aiMesh *m) -> const aiVector3D * {
+            return m->mTangents;
+        },
+        [](const struct aiMesh *m) -> const aiVector3D * {
+            return m->mTextureCoords[0];
+        }};
+    const unsigned int components[4] = {3, 3, 3, 2};
+    unsigned int nVertices = AKNumVerticesInNode(aiNode, aiScene);
+    unsigned int offsets[4];
+    unsigned int stride = 0;
+    for (int a = 0; a < 4; a++)
+    {
+        offsets[a] = stride;
+        if (anyMeshHasStream(aiNode, aiScene, streams[a]))
+        {
+            stride += components[a] * sizeof(float);
+        }
+    }
+    bool hasColors = aiNode->mNumMeshes > 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        hasColors = hasColors &&
+                    aiScene->mMeshes[aiNode->mMeshes[i]]->mColors[0] != NULL;
+    }
+    unsigned int colorOffset = stride;
+    stride += hasColors ? 3 * sizeof(float) : 0;
+    node.vertexData.assign((size_t)nVertices * stride, 0);
+    for (int a = 0; a < 4; a++)
+    {
+        if (anyMeshHasStream(aiNode, aiScene, streams[a]))
+        {
+            copyStream(aiNode, aiScene, streams[a], components[a],
+                       offsets[a], stride, node.vertexData.data());
+        }
+    }
+    unsigned char *dst = node.vertexData.data();
+    for (unsigned int i = 0; hasColors && i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        for (unsigned int j = 0; j < aiMesh->mNumVertices; j++)
+        {
+            const aiColor4D &c = aiMesh->mColors[0][j];
+            const float rgb[3] = {c.r, c.g, c.b};
+            memcpy(dst + (size_t)j * stride + colorOffset, rgb, sizeof(rgb));
+        }
+        dst += (size_t)aiMesh->mNumVertices * stride;
+    }
+
+    node.indices.resize(aiNode->mNumMeshes);
+    unsigned int indexOffset = 0;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        std::vector<unsigned int> &indices = node.indices[i];
+        indices.clear();
+        indices.reserve(AKNumIndicesInMesh(aiMesh));
+        for (unsigned int f = 0; f < aiMesh->mNumFaces; f++)
+        {
+            const struct aiFace *aiFace = &aiMesh->mFaces[f];
+            for (unsigned int k = 0; k < aiFace->mNumIndices; k++)
+            {
+                indices.push_back(indexOffset + aiFace->mIndices[k]);
+            }
+        }
+        indexOffset += aiMesh->mNumVertices;
+    }
+
+    // the skin counted the vertices and the weights before filling them
+    unsigned int maxWeights = AKNumBonesInNode(aiNode, aiScene) > 0
+                                  ? AKMaxWeightsInNode(aiNode, aiScene)
+                                  : 0;
+    node.boneWeights.assign((size_t)nVertices * maxWeights, 0.0f);
+    node.boneIndices.assign((size_t)nVertices * maxWeights, 0);
+    std::vector<unsigned short> slots(nVertices, 0);
+    unsigned int vertexOffset = 0;
+    for (unsigned int i = 0; maxWeights > 0 && i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        for (unsigned int b = 0; b < aiMesh->mNumBones; b++)
+        {
+            const struct aiBone *aiBone = aiMesh->mBones[b];
+            int paletteIndex = AKBonePaletteIndexOfBone(palette, aiBone);
+            short boneIndex = paletteIndex < 0 ? 0 : (short)paletteIndex;
+            for (unsigned int k = 0; k < aiBone->mNumWeights; k++)
+            {
+                unsigned int vertex =
+                    vertexOffset + aiBone->mWeights[k].mVertexId;
+                size_t slot = (size_t)vertex * maxWeights + slots[vertex]++;
+                node.boneWeights[slot] = aiBone->mWeights[k].mWeight;
+                node.boneIndices[slot] = boneIndex;
+            }
+        }
+        vertexOffset += aiMesh->mNumVertices;
+    }
+}
+
+#pragma mark - Benchmark
+
+/**
+ Collects the nodes of the scene which have meshes.
+
+ @param aiNode The assimp node to start from.
+ @param nodes The nodes with meshes.
+ */
+static void collectMeshNodes(const struct aiNode *aiNode,
+                             std::vector<const struct aiNode *> &nodes)
+{
+    if (aiNode->mNumMeshes > 0)
+    {
+        nodes.push_back(aiNode);
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        collectMeshNodes(aiNode->mChildren[i], nodes);
+    }
+}
+
+/**
+ Prints the cost of a conversion per vertex.
+
+ @param name The name of the conversion.
+ @param ms The time of the conversion in milliseconds.
+ @param counters The counters of the conversion, -1 if not available.
+ @param nVertices The number of vertices converted.
+ */
+static void printCost(const char *name,
+                      double ms,
+                      const AKBenchmarkCounters *counters,
+                      unsigned int nVertices)
+{
+    printf("%-24s %9.3f ms %8.2f ns/vertex", name, ms,
+           ms * 1e6 / nVertices);
+    if (counters->instructions >= 0)
+    {
+        printf(" %8.1f instructions/vertex %6.3f cache misses/vertex",
+               (double)counters->instructions / nVertices,
+               (double)counters->cacheMisses / nVertices);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *assetPath =
+        argc > 1 ? argv[1]
+                 : "apple/models-proprietary/Collada/explorer_skinned.dae";
+    const struct aiScene *aiScene = AKBenchmarkImportScene(assetPath);
+    std::string sceneName = assetPath;
+    if (aiScene == NULL)
+    {
+        aiScene = AKBenchmarkMakeCharacter(300000, 80, 4);
+        sceneName = "synthetic 300000 vertices, 80 bones, 4 weights/vertex";
+    }
+
+    std::vector<const struct aiNode *> nodes;
+    collectMeshNodes(aiScene->mRootNode, nodes);
+    unsigned int nVertices = 0;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        nVertices += AKNumVerticesInNode(nodes[i], aiScene);
+    }
+    printf("Scene: %s\n", sceneName.c_str());
+    printf("Nodes with meshes: %zu, vertices: %u\n", nodes.size(), nVertices);
+    if (nVertices == 0)
+    {
+        AKBenchmarkReleaseScene(aiScene);
+        return 0;
+    }
+
+    AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+    std::vector<AKMultiPassNode> multiPassNodes(nodes.size());
+    auto multiPass = [&]() {
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            convertMultiPass(nodes[i], aiScene, palette, multiPassNodes[i]);
+        }
+    };
+    auto fused = [&]() {
+        AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            AKNodeGeometryRelease(AKNodeGeometryCreateWithStats(
+                nodes[i], aiScene, NULL, stats));
+            AKNodeSkinRelease(
+                AKNodeSkinCreateWithStats(nodes[i], aiScene, palette, stats));
+        }
+        AKSceneStatsRelease(stats);
+    };
+    double multiPassMs = AKBenchmarkMinMilliseconds(5, multiPass);
+    double fusedMs = AKBenchmarkMinMilliseconds(5, fused);
+    AKBenchmarkCounters multiPassCounters;
+    AKBenchmarkCounters fusedCounters;
+    if (AKBenchmarkCountersOpen(&multiPassCounters))
+    {
+        AKBenchmarkMinCounters(5, &multiPassCounters, multiPass);
+        AKBenchmarkCountersClose(&multiPassCounters);
+    }
+    if (AKBenchmarkCountersOpen(&fusedCounters))
+    {
+        AKBenchmarkMinCounters(5, &fusedCounters, fused);
+        AKBenchmarkCountersClose(&fusedCounters);
+    }
+
+    // both conversions must produce the same buffers
+    int status = 0;
+    AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        const AKMultiPassNode &node = multiPassNodes[i];
+        AKNodeGeometry *geometry =
+            AKNodeGeometryCreateWithStats(nodes[i], aiScene, NULL, stats);
+        AKNodeSkin *skin =
+            AKNodeSkinCreateWithStats(nodes[i], aiScene, palette, stats);
+        bool same =
+            node.vertexData.size() ==
+                (size_t)geometry->nVertices * geometry->vertexStride &&
+            memcmp(node.vertexData.data(), geometry->vertexData,
+                   node.vertexData.size()) == 0;
+        for (unsigned int j = 0; same && j < geometry->nElements; j++)
+        {
+            const AKGeometryElement *element = &geometry->elements[j];
+            for (unsigned int k = 0;
+                 element->indices != NULL && k < element->nIndices; k++)
+            {
+                same = same && AKGeometryElementIndexAt(element, k) ==
+                                   node.indices[j][k];
+            }
+        }
+        size_t nWeights = skin ? (size_t)skin->nVertices * skin->maxWeights
+                               : 0;
+        same = same && nWeights == node.boneWeights.size() &&
+               (nWeights == 0 ||
+                (memcmp(skin->boneWeights, node.boneWeights.data(),
+                        nWeights * sizeof(float)) == 0 &&
+                 memcmp(skin->boneIndices, node.boneIndices.data(),
+                        nWeights * sizeof(short)) == 0));
+        if (!same)
+        {
+            fprintf(stderr, "Conversion mismatch at node %s\n",
+                    nodes[i]->mName.data);
+            status = 1;
+        }
+        AKNodeSkinRelease(skin);
+        AKNodeGeometryRelease(geometry);
+    }
+    AKSceneStatsRelease(stats);
+    AKBonePaletteRelease(palette);
+
+    printCost("Multi pass conversion:", multiPassMs, &multiPassCounters,
+              nVertices);
+    printCost("Fused conversion:", fusedMs, &fusedCounters, nVertices);
+    if (fusedCounters.instructions < 0)
+    {
+        printf("Hardware counters are not available on this system\n");
+    }
+    printf("Speedup: %.1fx\n", multiPassMs / fusedMs);
+    AKBenchmarkReleaseScene(aiScene);
+    return status;
+}
@@ -0,0 +1,301 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAnimation.h"
+#include "AKBenchmark.h"
+#include "AKBonePalette.h"
+#include "AKMeshStats.h"
+#include "AKSceneCache.h"
+#include "AKSceneGeometry.h"
+#include "AKSkin.h"
+#include "assimp/postprocess.h" // Post processing flags
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "AKImport.h"
+#endif
+
+/**
+ Measures the cold and the warm load of every file of the test assets through
+ a scene cache.
+
+ The cold load hashes the file into its key, reads and post processes it with
+ assimp, converts the node geometries, the skins and the animation tracks,
+ and stores them in the cache. The warm load hashes the file into its key,
+ opens its archive and makes the node geometries, the skins and the animation
+ tracks from it, which are the buffers the importer hands to scenekit. Both
+ are the fastest of several runs, and the speedup is their ratio.
+
+ Without the assimp library, the cold load of synthetic skinned characters is
+ their conversion from an assimp scene in memory, without reading a file.
+
+ usage: AKSceneCacheBenchmark [number of runs]
+ */
+
+#pragma mark - Conversion
+
+/**
+ The post processing steps of the benchmark, a typical realtime set.
+ */
+static const unsigned int AKBenchmarkFlags =
+    aiProcess_FlipUVs | aiProcess_Triangulate |
+    aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals |
+    aiProcess_ImproveCacheLocality | aiProcess_LimitBoneWeights |
+    aiProcess_RemoveRedundantMaterials | aiProcess_SortByPType;
+
+/**
+ Converts a scene with the core and stores it in the cache.
+
+ The nodes are added in pre-order, the order of the nodes of the scene
+ geometry, with their transforms in the column order of scenekit.
+
+ @param aiScene The assimp scene.
+ @param cache The cache.
+ @param key The key of the scene.
+ */
+static void storeScene(const struct aiScene *aiScene,
+                       AKSceneCache *cache,
+                       unsigned long long key)
+{
+    AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+    AKSceneGeometry *sceneGeometry =
+        AKSceneGeometryCreate(aiScene, NULL, stats, NULL, NULL);
+    AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+    AKSceneArchiveWriter *writer = AKSceneArchiveWriterCreate(key);
+    std::map<const struct aiNode *, unsigned int> indices;
+    for (unsigned int i = 0; i < AKSceneGeometryNodeCount(sceneGeometry); i++)
+    {
+        const struct aiNode *aiNode = AKSceneGeometryNodeAt(sceneGeometry, i);
+        const aiMatrix4x4 &m = aiNode->mTransformation;
+        float transform[16] = {m.a1, m.b1, m.c1, m.d1, m.a2, m.b2, m.c2, m.d2,
+                               m.a3, m.b3, m.c3, m.d3, m.a4, m.b4, m.c4, m.d4};
+        unsigned int parent = aiNode->mParent != NULL
+                                  ? indices[aiNode->mParent]
+                                  : AKArchiveNone;
+        unsigned int node = AKSceneArchiveWriterAddNode(
+            writer, aiNode->mName.C_Str(), parent, transform,
+            aiNode->mMeshes, aiNode->mNumMeshes);
+        indices[aiNode] = node;
+        const AKNodeGeometry *geometry = AKSceneGeometryAt(sceneGeometry, i);
+        if (geometry == NULL)
+        {
+            continue;
+        }
+        AKSceneArchiveWriterSetGeometry(writer, node, geometry);
+        AKNodeSkin *skin =
+            AKNodeSkinCreateWithStats(aiNode, aiScene, palette, stats);
+        if (skin != NULL)
+        {
+            AKSceneArchiveWriterSetSkin(writer, node, skin);
+            AKNodeSkinRelease(skin);
+        }
+    }
+    for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+    {
+        AKAnimationTracks *tracks =
+            AKAnimationTracksCreate(aiScene->mAnimations[i]);
+        AKSceneArchiveWriterAddAnimation(writer, tracks);
+        AKAnimationTracksRelease(tracks);
+    }
+    AKSceneCacheStore(cache, key, writer);
+    AKSceneArchiveWriterRelease(writer);
+    AKBonePaletteRelease(palette);
+    AKSceneGeometryRelease(sceneGeometry);
+    AKSceneStatsRelease(stats);
+}
+
+/**
+ Loads a scene from the cache, making the node geometries, the skins and the
+ animation tracks from its archive.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @return true if the scene was in the cache.
+ */
+static bool loadScene(AKSceneCache *cache, unsigned long long key)
+{
+    AKSceneArchive *archive = AKSceneCacheOpen(cache, key);
+    if (archive == NULL)
+    {
+        return false;
+    }
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    for (unsigned int i = 0; i < header->nGeometries; i++)
+    {
+        AKNodeGeometryRelease(AKSceneArchiveCreateGeometry(archive, i));
+    }
+    for (unsigned int i = 0; i < header->nSkins; i++)
+    {
+        AKNodeSkinRelease(AKSceneArchiveCreateSkin(archive, i));
+    }
+    for (unsigned int i = 0; i < header->nAnimations; i++)
+    {
+        AKAnimationTracksRelease(
+            AKSceneArchiveCreateAnimationTracks(archive, i));
+    }
+    AKSceneArchiveRelease(archive);
+    return true;
+}
+
+#pragma mark - Report
+
+/**
+ Prints the header of the report.
+ */
+static void printHeader()
+{
+    printf("%-28s %10s %10s %10s %8s\n", "file", "archive KB", "cold ms",
+           "warm ms", "speedup");
+}
+
+/**
+ Prints the cold and warm loads of a file.
+
+ @param name The name of the file.
+ @param cache The cache, which holds only the archive of the file.
+ @param cold The time of the cold load in milliseconds.
+ @param warm The time of the warm load in milliseconds.
+ */
+static void printRow(const std::string &name,
+                     AKSceneCache *cache,
+                     double cold,
+                     double warm)
+{
+    std::string shortName = name.size() > 28 ? name.substr(0, 28) : name;
+    printf("%-28s %10.1f %10.2f %10.2f %7.1fx\n", shortName.c_str(),
+           AKSceneCacheBytes(cache) / 1024.0, cold, warm,
+           warm > 0.0 ? cold / warm : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+    int nRuns = argc > 1 ? atoi(argv[1]) : 5;
+    char directory[] = "/tmp/AKSceneCacheBenchmarkXXXXXX";
+    if (mkdtemp(directory) == NULL)
+    {
+        printf("could not create the cache directory\n");
+        return 1;
+    }
+    AKSceneCache *cache = AKSceneCacheCreate(directory, 0);
+    double totalCold = 0.0;
+    double totalWarm = 0.0;
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    std::vector<std::string> paths = AKBenchmarkListAssets();
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    printf("Corpus: %zu files, %d runs\n", paths.size(), nRuns);
+    printHeader();
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        const std::string &path = paths[i];
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        unsigned long long key = 0;
+        bool imported = true;
+        double cold = AKBenchmarkMinMilliseconds(nRuns, [&]() {
+            key = AKSceneCacheKeyMake();
+            AKSceneCacheKeyAddFile(&key, path.c_str());
+            key = AKSceneCacheKeyAdd(key, &AKBenchmarkFlags,
+                                     sizeof(AKBenchmarkFlags));
+            key = AKSceneCacheKeyAddOptions(key, &options);
+            AKImport *import = AKImportCreate(NULL);
+            AKImportSetOptions(import, &options);
+            const struct aiScene *aiScene =
+                AKImportReadFile(import, path.c_str(), AKBenchmarkFlags);
+            if (aiScene == NULL)
+            {
+                imported = false;
+            }
+            else
+            {
+                storeScene(aiScene, cache, key);
+            }
+            AKImportRelease(import);
+        });
+        if (!imported)
+        {
+            printf("%-28s failed to import\n", name.c_str());
+            continue;
+        }
+        double warm = AKBenchmarkMinMilliseconds(nRuns, [&]() {
+            unsigned long long warmKey = AKSceneCacheKeyMake();
+            AKSceneCacheKeyAddFile(&warmKey, path.c_str());
+            warmKey = AKSceneCacheKeyAdd(warmKey, &AKBenchmarkFlags,
+                                         sizeof(AKBenchmarkFlags));
+            warmKey = AKSceneCacheKeyAddOptions(warmKey, &options);
+            loadScene(cache, warmKey);
+        });
+        printRow(name, cache, cold, warm);
+        totalCold += cold;
+        totalWarm += warm;
+        AKSceneCacheRemoveAll(cache);
+    }
+#else
+    const unsigned int nVertices[] = {5000, 20000, 60000, 120000};
+    const unsigned int nBones[] = {20, 40, 80, 120};
+    printf("Built without the assimp library, loading synthetic characters, "
+           "%d runs\n", nRuns);
+    printHeader();
+    for (int i = 0; i < 4; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "character %u/%u", nVertices[i],
+                 nBones[i]);
+        const struct aiScene *aiScene =
+            AKBenchmarkMakeCharacter(nVertices[i], nBones[i], 4);
+        unsigned long long key =
+            AKSceneCacheKeyAdd(AKSceneCacheKeyMake(), name, sizeof(name));
+        double cold = AKBenchmarkMinMilliseconds(
+            nRuns, [&]() { storeScene(aiScene, cache, key); });
+        double warm = AKBenchmarkMinMilliseconds(
+            nRuns, [&]() { loadScene(cache, key); });
+        printRow(name, cache, cold, warm);
+        totalCold += cold;
+        totalWarm += warm;
+        AKSceneCacheRemoveAll(cache);
+        AKBenchmarkReleaseScene(aiScene);
+    }
+#endif
+    printf("%-28s %10s %10.2f %10.2f %7.1fx\n", "total", "", totalCold,
+           totalWarm, totalWarm > 0.0 ? totalCold / totalWarm : 0.0);
+    AKSceneCacheStats stats = AKSceneCacheGetStats(cache);
+    printf("hits %lu, misses %lu, stores %lu\n", stats.hits, stats.misses,
+           stats.stores);
+    AKSceneCacheRelease(cache);
+    rmdir(directory);
+    return stats.misses == 0 ? 0 : 1;
+}
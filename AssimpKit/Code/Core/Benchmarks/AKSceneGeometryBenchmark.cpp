@@ -0,0 +1,141 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKSceneGeometry.h"
+#include "AKTestScene.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/**
+ Benchmarks the conversion of the geometry of every node of a scene with
+ thousands of mesh nodes, serially and on a work pool of 1, 2, 4 and 8
+ workers, and checks every parallel conversion hashes the same as the serial
+ conversion.
+
+ usage: AKSceneGeometryBenchmark [scene file relative to the assets]
+ */
+
+#pragma mark - Scenes
+
+/**
+ Creates a synthetic architectural scene: a root with 50 floors of 100 parts,
+ each part a node with its own mesh of 30 to 930 vertices.
+
+ @return A new scene which must be released with AKBenchmarkReleaseScene.
+ */
+static const aiScene *makeBuilding()
+{
+    aiNode *root = AKTestMakeNode("building");
+    std::vector<aiMesh *> meshes;
+    for (unsigned int f = 0; f < 50; f++)
+    {
+        aiNode *floor = AKTestMakeNode("floor");
+        for (unsigned int p = 0; p < 100; p++)
+        {
+            unsigned int nVertices = 30 + (f * 100 + p) * 37 % 900;
+            meshes.push_back(AKTestMakeMesh(nVertices, nVertices - 2,
+                                            AKTestMeshAllStreams,
+                                            (float)meshes.size()));
+            AKTestAddChild(
+                floor, AKTestMakeNode("part", std::vector<unsigned int>(
+                                                  1, meshes.size() - 1)));
+        }
+        AKTestAddChild(root, floor);
+    }
+    return AKTestMakeScene(root, meshes);
+}
+
+int main(int argc, char **argv)
+{
+    const struct aiScene *aiScene = NULL;
+    std::string sceneName;
+    if (argc > 1)
+    {
+        aiScene = AKBenchmarkImportScene(argv[1]);
+        sceneName = argv[1];
+    }
+    if (aiScene == NULL)
+    {
+        aiScene = makeBuilding();
+        sceneName = "synthetic building, 50 floors of 100 parts";
+    }
+    AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+    unsigned long nVertices = 0;
+    for (unsigned int i = 0; i < stats->nMeshes; i++)
+    {
+        nVertices += stats->meshes[i].nVertices;
+    }
+    printf("Scene: %s, %u meshes, %lu vertices\n", sceneName.c_str(),
+           stats->nMeshes, nVertices);
+
+    unsigned long long serialHash = 0;
+    double serialMs = AKBenchmarkMinMilliseconds(5, [&]() {
+        AKSceneGeometry *sceneGeometry =
+            AKSceneGeometryCreate(aiScene, NULL, stats, NULL, NULL);
+        serialHash = AKSceneGeometryHash(sceneGeometry);
+        AKSceneGeometryRelease(sceneGeometry);
+    });
+    printf("%8s %10s %8s %18s\n", "workers", "ms", "speedup", "hash");
+    printf("%8s %10.2f %7.2fx %18llx\n", "serial", serialMs, 1.0, serialHash);
+
+    bool deterministic = true;
+    const unsigned int workerCounts[] = {1, 2, 4, 8};
+    for (int w = 0; w < 4; w++)
+    {
+        AKWorkPool *pool = AKWorkPoolCreate(workerCounts[w], 0);
+        unsigned long long hash = 0;
+        double ms = AKBenchmarkMinMilliseconds(5, [&]() {
+            AKSceneGeometry *sceneGeometry =
+                AKSceneGeometryCreate(aiScene, NULL, stats, NULL, pool);
+            hash = AKSceneGeometryHash(sceneGeometry);
+            deterministic = deterministic && hash == serialHash;
+            AKSceneGeometryRelease(sceneGeometry);
+        });
+        printf("%8u %10.2f %7.2fx %18llx\n", workerCounts[w], ms,
+               serialMs / ms, hash);
+        AKWorkPoolRelease(pool);
+    }
+    AKSceneStatsRelease(stats);
+    AKBenchmarkReleaseScene(aiScene);
+    if (!deterministic)
+    {
+        printf("A parallel conversion differs from the serial conversion\n");
+        return 1;
+    }
+    printf("Every parallel conversion matches the serial conversion\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKGeometry.h"
+#include "AKSkin.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**
+ Benchmarks the skin data builder, including making the bone palette, against
+ the multi pass builder it replaced, which built a table of weights and a table
+ of bone indices per mesh, each with a list per vertex, and looked up the bone
+ index of every weight by name in the array of bone names.
+
+ usage: AKSkinBenchmark [scene file relative to the assets]
+ */
+
+#pragma mark - Multi pass skin builder
+
+/**
+ Builds the skin of a node like the multi pass builder did.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param boneNames The unique bone names.
+ @param weights The bone weights, maxWeights per vertex.
+ @param indices The bone indices, maxWeights per vertex.
+ */
+static void makeMultiPassSkin(const struct aiNode *aiNode,
+                              const struct aiScene *aiScene,
+                              const std::vector<const char *> &boneNames,
+                              std::vector<float> &weights,
+                              std::vector<short> &indices)
+{
+    unsigned int maxWeights = AKMaxWeightsInNode(aiNode, aiScene);
+    weights.clear();
+    indices.clear();
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        std::vector<std::vector<float> > meshWeights(aiMesh->mNumVertices);
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            const struct aiBone *aiBone = aiMesh->mBones[j];
+            for (unsigned int k = 0; k < aiBone->mNumWeights; k++)
+            {
+                meshWeights[aiBone->mWeights[k].mVertexId].push_back(
+                    aiBone->mWeights[k].mWeight);
+            }
+        }
+        for (unsigned int j = 0; j < aiMesh->mNumVertices; j++)
+        {
+            weights.insert(weights.end(), meshWeights[j].begin(),
+                           meshWeights[j].end());
+            weights.resize(weights.size() + maxWeights - meshWeights[j].size(),
+                           0.0f);
+        }
+
+        std::vector<std::vector<short> > meshIndices(aiMesh->mNumVertices);
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            const struct aiBone *aiBone = aiMesh->mBones[j];
+            for (unsigned int k = 0; k < aiBone->mNumWeights; k++)
+            {
+                short boneIndex = 0;
+                for (size_t b = 0; b < boneNames.size(); b++)
+                {
+                    if (strcmp(aiBone->mName.data, boneNames[b]) == 0)
+                    {
+                        boneIndex = (short)b;
+                        break;
+                    }
+                }
+                meshIndices[aiBone->mWeights[k].mVertexId].push_back(
+                    boneIndex);
+            }
+        }
+        for (unsigned int j = 0; j < aiMesh->mNumVertices; j++)
+        {
+            indices.insert(indices.end(), meshIndices[j].begin(),
+                           meshIndices[j].end());
+            indices.resize(indices.size() + maxWeights - meshIndices[j].size(),
+                           0);
+        }
+    }
+}
+
+#pragma mark - Benchmark
+
+/**
+ Collects the skinned nodes and the unique bone names of the scene.
+
+ @param aiNode The assimp node to start from.
+ @param aiScene The assimp scene.
+ @param nodes The skinned nodes.
+ @param boneNames The unique bone names in the order they are found.
+ */
+static void collectSkinnedNodes(const struct aiNode *aiNode,
+                                const struct aiScene *aiScene,
+                                std::vector<const struct aiNode *> &nodes,
+                                std::vector<const char *> &boneNames)
+{
+    if (AKNumBonesInNode(aiNode, aiScene) > 0)
+    {
+        nodes.push_back(aiNode);
+    }
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        for (unsigned int j = 0; j < aiMesh->mNumBones; j++)
+        {
+            const char *name = aiMesh->mBones[j]->mName.data;
+            bool found = false;
+            for (size_t b = 0; b < boneNames.size() && !found; b++)
+            {
+                found = strcmp(name, boneNames[b]) == 0;
+            }
+            if (!found)
+            {
+                boneNames.push_back(name);
+            }
+        }
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        collectSkinnedNodes(aiNode->mChildren[i], aiScene, nodes, boneNames);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *assetPath =
+        argc > 1 ? argv[1]
+                 : "apple/models-proprietary/Collada/explorer_skinned.dae";
+    const struct aiScene *aiScene = AKBenchmarkImportScene(assetPath);
+    std::string sceneName = assetPath;
+    if (aiScene == NULL)
+    {
+        // a character of the size which made the multi pass builder slow
+        aiScene = AKBenchmarkMakeCharacter(60000, 80, 4);
+        sceneName = "synthetic 60000 vertices, 80 bones, 4 weights/vertex";
+    }
+
+    std::vector<const struct aiNode *> nodes;
+    std::vector<const char *> boneNames;
+    collectSkinnedNodes(aiScene->mRootNode, aiScene, nodes, boneNames);
+    unsigned int nVertices = 0;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        nVertices += AKNumVerticesInNode(nodes[i], aiScene);
+    }
+    printf("Scene: %s\n", sceneName.c_str());
+    printf("Skinned nodes: %zu, vertices: %u, bones: %zu\n", nodes.size(),
+           nVertices, boneNames.size());
+
+    std::vector<float> weights;
+    std::vector<short> indices;
+    double multiPassMs = AKBenchmarkMinMilliseconds(5, [&]() {
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            makeMultiPassSkin(nodes[i], aiScene, boneNames, weights, indices);
+        }
+    });
+    double singlePassMs = AKBenchmarkMinMilliseconds(5, [&]() {
+        AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            AKNodeSkinRelease(AKNodeSkinCreate(nodes[i], aiScene, palette));
+        }
+        AKBonePaletteRelease(palette);
+    });
+
+    // both builders must produce the same skin
+    int status = 0;
+    AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        makeMultiPassSkin(nodes[i], aiScene, boneNames, weights, indices);
+        AKNodeSkin *skin = AKNodeSkinCreate(nodes[i], aiScene, palette);
+        size_t n = skin->nVertices * skin->maxWeights;
+        if (n != weights.size() ||
+            memcmp(skin->boneWeights, &weights[0], n * sizeof(float)) != 0 ||
+            memcmp(skin->boneIndices, &indices[0], n * sizeof(short)) != 0)
+        {
+            fprintf(stderr, "Skin mismatch at node %s\n",
+                    nodes[i]->mName.data);
+            status = 1;
+        }
+        AKNodeSkinRelease(skin);
+    }
+    AKBonePaletteRelease(palette);
+
+    printf("Multi pass skin builder:  %9.3f ms\n", multiPassMs);
+    printf("Single pass skin builder: %9.3f ms\n", singlePassMs);
+    printf("Speedup: %.1fx\n", multiPassMs / singlePassMs);
+    AKBenchmarkReleaseScene(aiScene);
+    return status;
+}
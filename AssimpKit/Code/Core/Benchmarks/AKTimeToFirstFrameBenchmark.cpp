@@ -0,0 +1,447 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAnimation.h"
+#include "AKBenchmark.h"
+#include "AKBonePalette.h"
+#include "AKMeshStats.h"
+#include "AKSceneArchive.h"
+#include "AKSceneGeometry.h"
+#include "AKSkin.h"
+#include "assimp/postprocess.h" // Post processing flags
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "AKImport.h"
+#endif
+
+/**
+ Measures the time to the first frame of the .dae and .fbx files of the test
+ assets, imported with assimp and loaded from a compiled scene asset.
+
+ The import reads and post processes the file with assimp, and converts the
+ node geometries, the skins and the animation tracks, which are the buffers
+ the importer hands to scenekit. The asset load maps the compiled asset, makes
+ the node geometries and the skins read in place and the animation tracks,
+ and reads every byte of the vertices, indices and bone weights, as the first
+ frame uploads them. The first node load only maps the asset and reads the
+ geometry of its first node, which is what a lazy load of a scene pays
+ before it shows its first node. Every load is the fastest of several runs,
+ so the asset is read from the page cache.
+
+ Without the assimp library, the import of synthetic skinned characters is
+ their conversion from an assimp scene in memory, without reading a file.
+
+ usage: AKTimeToFirstFrameBenchmark [number of runs]
+ */
+
+#pragma mark - Conversion
+
+/**
+ The post processing steps of the benchmark, a typical realtime set.
+ */
+static const unsigned int AKBenchmarkFlags =
+    aiProcess_FlipUVs | aiProcess_Triangulate |
+    aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals |
+    aiProcess_ImproveCacheLocality | aiProcess_LimitBoneWeights |
+    aiProcess_RemoveRedundantMaterials | aiProcess_SortByPType;
+
+/**
+ Converts a scene with the core, and optionally writes it to a scene asset.
+
+ The nodes are added in pre-order, the order of the nodes of the scene
+ geometry, with their transforms in the column order of scenekit.
+
+ @param aiScene The assimp scene.
+ @param path The path of the asset to write, or NULL to only convert the
+ scene.
+ @return The size of the asset in bytes, or 0 if no asset was written.
+ */
+static size_t convertScene(const struct aiScene *aiScene, const char *path)
+{
+    AKSceneStats *stats = AKSceneStatsCreate(aiScene);
+    AKSceneGeometry *sceneGeometry =
+        AKSceneGeometryCreate(aiScene, NULL, stats, NULL, NULL);
+    AKBonePalette *palette = AKBonePaletteCreate(aiScene);
+    AKSceneArchiveWriter *writer =
+        path != NULL ? AKSceneArchiveWriterCreate(0) : NULL;
+    std::map<const struct aiNode *, unsigned int> indices;
+    for (unsigned int i = 0; i < AKSceneGeometryNodeCount(sceneGeometry); i++)
+    {
+        const struct aiNode *aiNode = AKSceneGeometryNodeAt(sceneGeometry, i);
+        const AKNodeGeometry *geometry = AKSceneGeometryAt(sceneGeometry, i);
+        AKNodeSkin *skin =
+            geometry != NULL
+                ? AKNodeSkinCreateWithStats(aiNode, aiScene, palette, stats)
+                : NULL;
+        if (writer != NULL)
+        {
+            const aiMatrix4x4 &m = aiNode->mTransformation;
+            float transform[16] = {m.a1, m.b1, m.c1, m.d1, m.a2, m.b2,
+                                   m.c2, m.d2, m.a3, m.b3, m.c3, m.d3,
+                                   m.a4, m.b4, m.c4, m.d4};
+            unsigned int parent = aiNode->mParent != NULL
+                                      ? indices[aiNode->mParent]
+                                      : AKArchiveNone;
+            unsigned int node = AKSceneArchiveWriterAddNode(
+                writer, aiNode->mName.C_Str(), parent, transform,
+                aiNode->mMeshes, aiNode->mNumMeshes);
+            indices[aiNode] = node;
+            if (geometry != NULL)
+            {
+                AKSceneArchiveWriterSetGeometry(writer, node, geometry);
+            }
+            if (skin != NULL)
+            {
+                AKSceneArchiveWriterSetSkin(writer, node, skin);
+            }
+        }
+        AKNodeSkinRelease(skin);
+    }
+    for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+    {
+        AKAnimationTracks *tracks =
+            AKAnimationTracksCreate(aiScene->mAnimations[i]);
+        if (writer != NULL)
+        {
+            AKSceneArchiveWriterAddAnimation(writer, tracks);
+        }
+        AKAnimationTracksRelease(tracks);
+    }
+    size_t size = 0;
+    if (writer != NULL)
+    {
+        size = AKSceneArchiveWriterWriteFile(writer, path);
+        AKSceneArchiveWriterRelease(writer);
+    }
+    AKBonePaletteRelease(palette);
+    AKSceneGeometryRelease(sceneGeometry);
+    AKSceneStatsRelease(stats);
+    return size;
+}
+
+#pragma mark - Asset load
+
+/**
+ The sum of the bytes read, stored so that the reads are not optimized away.
+ */
+static volatile uint64_t AKTouchedSum = 0;
+
+/**
+ Reads every byte of a buffer, as the upload of the buffer to the GPU does.
+
+ @param bytes The buffer.
+ @param nBytes The size of the buffer in bytes.
+ @return A sum of the bytes, so that the reads are not optimized away.
+ */
+static uint64_t touchBytes(const void *bytes, size_t nBytes)
+{
+    const unsigned char *p = (const unsigned char *)bytes;
+    uint64_t sum = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= nBytes; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        sum += word;
+    }
+    for (; i < nBytes; i++)
+    {
+        sum += p[i];
+    }
+    return sum;
+}
+
+/**
+ Reads every byte of the vertices and the indices of a node geometry read in
+ place, and releases it.
+
+ @param geometry The node geometry, may be NULL.
+ @return A sum of the bytes.
+ */
+static uint64_t touchGeometry(AKNodeGeometry *geometry)
+{
+    if (geometry == NULL)
+    {
+        return 0;
+    }
+    uint64_t sum = touchBytes(geometry->vertexData,
+                              (size_t)geometry->nVertices *
+                                  geometry->vertexStride);
+    for (unsigned int i = 0; i < geometry->nElements; i++)
+    {
+        const AKGeometryElement *element = &geometry->elements[i];
+        sum += touchBytes(element->indices,
+                          (size_t)element->nIndices * element->bytesPerIndex);
+    }
+    AKSceneArchiveReleaseGeometryInPlace(geometry);
+    return sum;
+}
+
+/**
+ Loads a scene asset, making its node geometries and skins read in place and
+ its animation tracks, and reads every byte of the geometries and the skins.
+
+ @param path The path of the asset.
+ @param sum Added the sum of the bytes read.
+ @return true if the asset was loaded.
+ */
+static bool loadAsset(const char *path, uint64_t *sum)
+{
+    AKSceneArchive *archive = AKSceneArchiveOpenFile(path);
+    if (archive == NULL)
+    {
+        return false;
+    }
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    for (unsigned int i = 0; i < header->nGeometries; i++)
+    {
+        *sum += touchGeometry(AKSceneArchiveCreateGeometryInPlace(archive, i));
+    }
+    for (unsigned int i = 0; i < header->nSkins; i++)
+    {
+        AKNodeSkin *skin = AKSceneArchiveCreateSkinInPlace(archive, i);
+        size_t nWeights = (size_t)skin->nVertices * skin->maxWeights;
+        *sum += touchBytes(skin->boneWeights, nWeights * sizeof(float));
+        *sum += touchBytes(skin->boneIndices, nWeights * sizeof(short));
+        AKSceneArchiveReleaseSkinInPlace(skin);
+    }
+    for (unsigned int i = 0; i < header->nAnimations; i++)
+    {
+        AKAnimationTracksRelease(
+            AKSceneArchiveCreateAnimationTracks(archive, i));
+    }
+    AKSceneArchiveRelease(archive);
+    return true;
+}
+
+/**
+ Loads the geometry of the first node with a geometry of a scene asset, read
+ in place, and reads every byte of it.
+
+ @param path The path of the asset.
+ @param sum Added the sum of the bytes read.
+ */
+static void loadFirstNode(const char *path, uint64_t *sum)
+{
+    AKSceneArchive *archive = AKSceneArchiveOpenFile(path);
+    if (archive == NULL)
+    {
+        return;
+    }
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    for (unsigned int i = 0; i < header->nNodes; i++)
+    {
+        const AKArchiveNode *node = AKSceneArchiveNodeAt(archive, i);
+        if (node->geometry != AKArchiveNone)
+        {
+            *sum += touchGeometry(
+                AKSceneArchiveCreateGeometryInPlace(archive, node->geometry));
+            break;
+        }
+    }
+    AKSceneArchiveRelease(archive);
+}
+
+#pragma mark - Report
+
+/**
+ Prints the header of the report.
+ */
+static void printHeader()
+{
+    printf("%-28s %10s %10s %10s %10s %8s\n", "file", "asset KB", "import ms",
+           "asset ms", "node ms", "speedup");
+}
+
+/**
+ Prints the time to the first frame of a file.
+
+ @param name The name of the file.
+ @param assetBytes The size of the compiled asset in bytes.
+ @param import The time of the import in milliseconds.
+ @param asset The time of the asset load in milliseconds.
+ @param firstNode The time of the first node load in milliseconds.
+ */
+static void printRow(const std::string &name,
+                     size_t assetBytes,
+                     double import,
+                     double asset,
+                     double firstNode)
+{
+    std::string shortName = name.size() > 28 ? name.substr(0, 28) : name;
+    printf("%-28s %10.1f %10.2f %10.2f %10.3f %7.1fx\n", shortName.c_str(),
+           assetBytes / 1024.0, import, asset, firstNode,
+           asset > 0.0 ? import / asset : 0.0);
+}
+
+/**
+ Measures the asset loads of a scene asset, and prints them with the time of
+ the import of its file.
+
+ @param name The name of the file.
+ @param assetPath The path of the compiled asset.
+ @param assetBytes The size of the compiled asset in bytes.
+ @param import The time of the import in milliseconds.
+ @param nRuns The number of runs.
+ @param totalImport Added the time of the import.
+ @param totalAsset Added the time of the asset load.
+ @return true if the asset was loaded.
+ */
+static bool measureAsset(const std::string &name,
+                         const char *assetPath,
+                         size_t assetBytes,
+                         double import,
+                         int nRuns,
+                         double *totalImport,
+                         double *totalAsset)
+{
+    uint64_t sum = 0;
+    bool loaded = true;
+    double asset = AKBenchmarkMinMilliseconds(
+        nRuns, [&]() { loaded = loadAsset(assetPath, &sum) && loaded; });
+    double firstNode = AKBenchmarkMinMilliseconds(
+        nRuns, [&]() { loadFirstNode(assetPath, &sum); });
+    if (!loaded)
+    {
+        printf("%-28s failed to load the asset\n", name.c_str());
+        return false;
+    }
+    printRow(name, assetBytes, import, asset, firstNode);
+    *totalImport += import;
+    *totalAsset += asset;
+    AKTouchedSum = sum;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int nRuns = argc > 1 ? atoi(argv[1]) : 5;
+    char assetPath[] = "/tmp/AKTimeToFirstFrameBenchmarkXXXXXX";
+    int fd = mkstemp(assetPath);
+    if (fd < 0)
+    {
+        printf("could not create the asset file\n");
+        return 1;
+    }
+    close(fd);
+    double totalImport = 0.0;
+    double totalAsset = 0.0;
+    bool loaded = true;
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    std::vector<std::string> paths;
+    std::vector<std::string> assets = AKBenchmarkListAssets();
+    for (size_t i = 0; i < assets.size(); i++)
+    {
+        std::string extension =
+            assets[i].substr(assets[i].find_last_of('.') + 1);
+        for (size_t c = 0; c < extension.size(); c++)
+        {
+            extension[c] = (char)tolower(extension[c]);
+        }
+        if (extension == "dae" || extension == "fbx")
+        {
+            paths.push_back(assets[i]);
+        }
+    }
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    printf("Corpus: %zu .dae and .fbx files, %d runs\n", paths.size(), nRuns);
+    printHeader();
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        const std::string &path = paths[i];
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        bool imported = true;
+        double importTime = AKBenchmarkMinMilliseconds(nRuns, [&]() {
+            AKImport *import = AKImportCreate(NULL);
+            AKImportSetOptions(import, &options);
+            const struct aiScene *aiScene =
+                AKImportReadFile(import, path.c_str(), AKBenchmarkFlags);
+            imported = aiScene != NULL;
+            if (imported)
+            {
+                convertScene(aiScene, NULL);
+            }
+            AKImportRelease(import);
+        });
+        AKImport *import = AKImportCreate(NULL);
+        AKImportSetOptions(import, &options);
+        const struct aiScene *aiScene =
+            AKImportReadFile(import, path.c_str(), AKBenchmarkFlags);
+        size_t assetBytes =
+            aiScene != NULL ? convertScene(aiScene, assetPath) : 0;
+        AKImportRelease(import);
+        if (!imported || assetBytes == 0)
+        {
+            printf("%-28s failed to import\n", name.c_str());
+            continue;
+        }
+        loaded = measureAsset(name, assetPath, assetBytes, importTime, nRuns,
+                              &totalImport, &totalAsset) &&
+                 loaded;
+    }
+#else
+    const unsigned int nVertices[] = {5000, 20000, 60000, 120000};
+    const unsigned int nBones[] = {20, 40, 80, 120};
+    printf("Built without the assimp library, loading synthetic characters, "
+           "%d runs\n", nRuns);
+    printHeader();
+    for (int i = 0; i < 4; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "character %u/%u", nVertices[i],
+                 nBones[i]);
+        const struct aiScene *aiScene =
+            AKBenchmarkMakeCharacter(nVertices[i], nBones[i], 4);
+        double importTime = AKBenchmarkMinMilliseconds(
+            nRuns, [&]() { convertScene(aiScene, NULL); });
+        size_t assetBytes = convertScene(aiScene, assetPath);
+        loaded = measureAsset(name, assetPath, assetBytes, importTime, nRuns,
+                              &totalImport, &totalAsset) &&
+                 loaded;
+        AKBenchmarkReleaseScene(aiScene);
+    }
+#endif
+    printf("%-28s %10s %10.2f %10.2f %10s %7.1fx\n", "total", "", totalImport,
+           totalAsset, "", totalAsset > 0.0 ? totalImport / totalAsset : 0.0);
+    remove(assetPath);
+    return loaded ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBenchmark.h"
+#include "AKVertexKernels.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/**
+ Benchmarks the vertex kernels against the scalar loops they replaced, which
+ copied each aiVector3D and aiColor4D of an assimp stream component by
+ component into the interleaved vertices.
+
+ The streams are synthetic, so the benchmark runs the same without the assimp
+ library.
+
+ usage: AKVertexKernelsBenchmark [number of vertices]
+ */
+
+#pragma mark - Scalar loops
+
+/**
+ Stores a float of an interleaved vertex.
+
+ @param dst The start of the attribute.
+ @param k The index of the component.
+ @param value The component.
+ */
+static inline void storeFloat(unsigned char *dst, size_t k, float value)
+{
+    memcpy(dst + k * sizeof(float), &value, sizeof(value));
+}
+
+/**
+ Copies vectors like the scalar loop did.
+
+ @param src The packed vectors.
+ @param n The number of vectors.
+ @param dst The interleaved vertices.
+ @param stride The stride of the interleaved vertices.
+ */
+static void scalarCopyVec3(const float *src, size_t n, unsigned char *dst,
+                           size_t stride)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t k = 0; k < 3; k++)
+        {
+            storeFloat(dst + i * stride, k, src[3 * i + k]);
+        }
+    }
+}
+
+/**
+ Scales and offsets vectors like the scalar quantization loop did.
+
+ @param src The packed vectors.
+ @param n The number of vectors.
+ @param scale The scale of each component.
+ @param offset The offset of each component.
+ @param dst The interleaved vertices.
+ @param stride The stride of the interleaved vertices.
+ */
+static void scalarScaleOffsetVec3(const float *src, size_t n,
+                                  const float *scale, const float *offset,
+                                  unsigned char *dst, size_t stride)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t k = 0; k < 3; k++)
+        {
+            storeFloat(dst + i * stride, k,
+                       src[3 * i + k] * scale[k] + offset[k]);
+        }
+    }
+}
+
+/**
+ Transforms points by an affine matrix with a scalar loop.
+
+ @param src The packed vectors.
+ @param n The number of vectors.
+ @param m The 3x4 row major matrix.
+ @param dst The interleaved vertices.
+ @param stride The stride of the interleaved vertices.
+ */
+static void scalarTransformVec3(const float *src, size_t n, const float *m,
+                                unsigned char *dst, size_t stride)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        const float *v = src + 3 * i;
+        for (size_t k = 0; k < 3; k++)
+        {
+            storeFloat(dst + i * stride, k,
+                       m[4 * k] * v[0] + m[4 * k + 1] * v[1] +
+                           m[4 * k + 2] * v[2] + m[4 * k + 3]);
+        }
+    }
+}
+
+/**
+ Extracts texture coordinates like the scalar loop did.
+
+ @param src The packed texture coordinates.
+ @param n The number of texture coordinates.
+ @param dst The interleaved vertices.
+ @param stride The stride of the interleaved vertices.
+ */
+static void scalarExtractTexCoords(const float *src, size_t n,
+                                   unsigned char *dst, size_t stride)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        storeFloat(dst + i * stride, 0, src[3 * i]);
+        storeFloat(dst + i * stride, 1, src[3 * i + 1]);
+    }
+}
+
+/**
+ Packs rgba colors to rgb like the scalar loop did.
+
+ @param src The packed colors.
+ @param n The number of colors.
+ @param dst The interleaved vertices.
+ @param stride The stride of the interleaved vertices.
+ */
+static void scalarPackColorsRGB(const float *src, size_t n,
+                                unsigned char *dst, size_t stride)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t k = 0; k < 3; k++)
+        {
+            storeFloat(dst + i * stride, k, src[4 * i + k]);
+        }
+    }
+}
+
+/**
+ Packs rgba colors to unorm8 like the scalar quantization loop did.
+
+ @param src The packed colors.
+ @param n The number of colors.
+ @param dst The interleaved vertices.
+ @param stride The stride of the interleaved vertices.
+ */
+static void scalarPackColorsRGBA8(const float *src, size_t n,
+                                  unsigned char *dst, size_t stride)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t k = 0; k < 4; k++)
+        {
+            float v = src[4 * i + k];
+            v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+            dst[i * stride + k] = (unsigned char)lrintf(v * 255.0f);
+        }
+    }
+}
+
+#pragma mark - Benchmark
+
+/**
+ Times a kernel against its scalar loop and prints both.
+
+ @param name The name of the kernel.
+ @param nVertices The number of vertices converted per run.
+ @param scalar The scalar loop.
+ @param kernel The kernel.
+ */
+template <typename Scalar, typename Kernel>
+static void compare(const char *name, size_t nVertices, Scalar scalar,
+                    Kernel kernel)
+{
+    double scalarMs = AKBenchmarkMinMilliseconds(10, scalar);
+    double kernelMs = AKBenchmarkMinMilliseconds(10, kernel);
+    printf("%-20s scalar %8.3f ms (%6.3f ns/vertex), kernel %8.3f ms "
+           "(%6.3f ns/vertex), %.2fx\n",
+           name, scalarMs, scalarMs * 1e6 / nVertices, kernelMs,
+           kernelMs * 1e6 / nVertices, scalarMs / kernelMs);
+}
+
+int main(int argc, char **argv)
+{
+    size_t nVertices = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 1000000;
+    if (nVertices == 0)
+    {
+        fprintf(stderr, "usage: AKVertexKernelsBenchmark [vertices]\n");
+        return 1;
+    }
+
+    std::vector<float> vectors(3 * nVertices);
+    std::vector<float> colors(4 * nVertices);
+    for (size_t i = 0; i < vectors.size(); i++)
+    {
+        vectors[i] = (float)(i % 1000) * 0.001f;
+    }
+    for (size_t i = 0; i < colors.size(); i++)
+    {
+        colors[i] = (float)(i % 997) * 0.0011f - 0.05f;
+    }
+    // position, normal, texture coordinates and a float color
+    const size_t stride = 11 * sizeof(float);
+    std::vector<unsigned char> vertices(nVertices * stride);
+    unsigned char *dst = vertices.data();
+    const float scale[3] = {32767.0f, 32767.0f, 32767.0f};
+    const float offset[3] = {-1.0f, -1.0f, -1.0f};
+    const float matrix[12] = {0.0f, -1.0f, 0.0f, 1.0f, //
+                              1.0f, 0.0f,  0.0f, 2.0f, //
+                              0.0f, 0.0f,  1.0f, 3.0f};
+
+    printf("Vertices: %zu, interleaved stride: %zu bytes\n", nVertices,
+           stride);
+    compare(
+        "copy vec3", nVertices,
+        [&]() { scalarCopyVec3(vectors.data(), nVertices, dst, stride); },
+        [&]() { AKCopyVec3(vectors.data(), nVertices, dst, stride); });
+    compare("scale offset vec3", nVertices,
+            [&]() {
+                scalarScaleOffsetVec3(vectors.data(), nVertices, scale,
+                                      offset, dst, stride);
+            },
+            [&]() {
+                AKScaleOffsetVec3(vectors.data(), nVertices, scale, offset,
+                                  dst, stride);
+            });
+    compare("transform vec3", nVertices,
+            [&]() {
+                scalarTransformVec3(vectors.data(), nVertices, matrix, dst,
+                                    stride);
+            },
+            [&]() {
+                AKTransformVec3(vectors.data(), nVertices, matrix, 1.0f, dst,
+                                stride);
+            });
+    compare("texcoords", nVertices,
+            [&]() {
+                scalarExtractTexCoords(vectors.data(), nVertices, dst,
+                                       stride);
+            },
+            [&]() {
+                AKExtractTexCoords(vectors.data(), nVertices, dst, stride);
+            });
+    compare(
+        "colors rgb", nVertices,
+        [&]() { scalarPackColorsRGB(colors.data(), nVertices, dst, stride); },
+        [&]() { AKPackColorsRGB(colors.data(), nVertices, dst, stride); });
+    compare("colors rgba8", nVertices,
+            [&]() {
+                scalarPackColorsRGBA8(colors.data(), nVertices, dst, stride);
+            },
+            [&]() {
+                AKPackColorsRGBA8(colors.data(), nVertices, dst, stride);
+            });
+    return 0;
+}
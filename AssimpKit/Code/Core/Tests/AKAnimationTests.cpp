@@ -0,0 +1,84 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAnimation.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <string.h>
+
+#pragma mark - Keyframe tracks
+
+/**
+ Tests each channel gets position, orientation and scale tracks with the
+ assimp key times and values.
+ */
+AK_TEST(testChannelTracks)
+{
+    std::vector<const char *> nodeNames;
+    nodeNames.push_back("hip");
+    nodeNames.push_back("leg");
+    aiAnimation *animation = AKTestMakeAnimation(nodeNames, 3, 48.0, 24.0);
+    AKAnimationTracks *tracks = AKAnimationTracksCreate(animation);
+
+    AKAssertEqualWithAccuracy(tracks->duration, 2.0, 1e-6);
+    AKAssertEqual(tracks->nChannels, 2u);
+    AKChannelTracks *leg = &tracks->channels[1];
+    AKAssertEqual(strcmp(leg->nodeName, "leg"), 0);
+    AKAssertEqual(leg->position.nKeys, 3u);
+    AKAssertEqual(leg->position.nComponents, 3u);
+    AKAssertEqualWithAccuracy(leg->position.keyTimes[2], 2.0, 1e-6);
+    AKAssertEqualWithAccuracy(leg->position.values[2 * 3 + 1], 3.0, 1e-6);
+    AKAssertEqual(leg->orientation.nComponents, 4u);
+    // quaternions are stored as x, y, z, w
+    AKAssertEqualWithAccuracy(leg->orientation.values[2 * 4 + 2], 2.0, 1e-6);
+    AKAssertEqualWithAccuracy(leg->orientation.values[2 * 4 + 3], 1.0, 1e-6);
+    AKAssertEqualWithAccuracy(leg->scale.values[1 * 3 + 2], 1.0, 1e-6);
+
+    AKAnimationTracksRelease(tracks);
+    delete animation;
+}
+
+/**
+ Tests the duration is in ticks when the ticks per second are unknown.
+ */
+AK_TEST(testDurationWithoutTicksPerSecond)
+{
+    std::vector<const char *> nodeNames(1, "hip");
+    aiAnimation *animation = AKTestMakeAnimation(nodeNames, 1, 10.0, 0.0);
+    AKAnimationTracks *tracks = AKAnimationTracksCreate(animation);
+    AKAssertEqualWithAccuracy(tracks->duration, 10.0, 1e-6);
+    AKAnimationTracksRelease(tracks);
+    delete animation;
+}
@@ -0,0 +1,373 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAssetCompiler.h"
+#include "AKSceneArchive.h"
+#include "AKTest.h"
+#include <atomic>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#pragma mark - Asset directories
+
+/**
+ The number of files compiled by compileScene.
+ */
+static std::atomic<int> nCompiled(0);
+
+/**
+ Compiles a file into a scene archive with one node named after the bytes of
+ the file, and fails the files which hold "bad".
+
+ @param context Unused.
+ @param path The path of the file.
+ @param assetPath The path of the archive to write.
+ @param key The key of the archive.
+ @param error The buffer which receives the description of a failure.
+ @param nErrorBytes The size of the error buffer.
+ @return The size of the archive, or 0 if the file failed.
+ */
+static size_t compileScene(void *context,
+                           const char *path,
+                           const char *assetPath,
+                           unsigned long long key,
+                           char *error,
+                           size_t nErrorBytes)
+{
+    nCompiled++;
+    char name[64] = "";
+    FILE *file = fopen(path, "r");
+    size_t nRead = fread(name, 1, sizeof(name) - 1, file);
+    name[nRead] = '\0';
+    fclose(file);
+    if (strcmp(name, "bad") == 0)
+    {
+        snprintf(error, nErrorBytes, "bad scene");
+        return 0;
+    }
+    float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    AKSceneArchiveWriter *writer = AKSceneArchiveWriterCreate(key);
+    AKSceneArchiveWriterAddNode(writer, name, AKArchiveNone, identity, NULL,
+                                0);
+    size_t size = AKSceneArchiveWriterWriteFile(writer, assetPath);
+    AKSceneArchiveWriterRelease(writer);
+    return size;
+}
+
+/**
+ Writes a file.
+
+ @param path The path of the file.
+ @param contents The contents of the file.
+ */
+static void writeFile(const std::string &path, const char *contents)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    fputs(contents, file);
+    fclose(file);
+}
+
+/**
+ Makes an input directory of scene files: a.obj, b.DAE, models/c.obj, and
+ notes.txt which is not a scene file.
+
+ @return The path of the directory, which the caller removes with
+ removeDirectory.
+ */
+static std::string makeInputDirectory()
+{
+    char path[] = "/tmp/AKAssetCompilerTestsXXXXXX";
+    std::string directory = mkdtemp(path);
+    mkdir((directory + "/models").c_str(), 0755);
+    writeFile(directory + "/a.obj", "a");
+    writeFile(directory + "/b.DAE", "b");
+    writeFile(directory + "/models/c.obj", "c");
+    writeFile(directory + "/notes.txt", "notes");
+    return directory;
+}
+
+/**
+ Removes a directory with its files and subdirectories.
+
+ @param directory The path of the directory.
+ */
+static void removeDirectory(const std::string &directory)
+{
+    DIR *dir = opendir(directory.c_str());
+    if (dir == NULL)
+    {
+        return;
+    }
+    struct dirent *dirent;
+    while ((dirent = readdir(dir)) != NULL)
+    {
+        std::string name = dirent->d_name;
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+        std::string path = directory + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+        {
+            removeDirectory(path);
+        }
+        else
+        {
+            remove(path.c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+/**
+ Makes a compiler of the obj and dae files of an input directory into its
+ assets subdirectory.
+
+ @param directory The input directory.
+ @param settingsKey The settings key.
+ @return A new compiler.
+ */
+static AKAssetCompiler *makeCompiler(const std::string &directory,
+                                     unsigned long long settingsKey)
+{
+    std::string assets = directory + "/assets";
+    AKAssetCompiler *compiler =
+        AKAssetCompilerCreate(directory.c_str(), assets.c_str(), settingsKey,
+                              compileScene, NULL);
+    AKAssetCompilerAddExtension(compiler, "obj");
+    AKAssetCompilerAddExtension(compiler, "Dae");
+    return compiler;
+}
+
+/**
+ Reads the manifest of the assets of an input directory.
+
+ @param directory The input directory.
+ @return The contents of the manifest.
+ */
+static std::string readManifest(const std::string &directory)
+{
+    std::string contents;
+    FILE *file =
+        fopen((directory + "/assets/" AK_ASSET_MANIFEST_NAME).c_str(), "r");
+    if (file == NULL)
+    {
+        return contents;
+    }
+    int c;
+    while ((c = fgetc(file)) != EOF)
+    {
+        contents += (char)c;
+    }
+    fclose(file);
+    return contents;
+}
+
+#pragma mark - Compiling assets
+
+/**
+ Tests every file with one of the extensions is compiled into an asset at
+ the same relative path, which opens with the key of its report, and the
+ manifest lists the assets in the order of their files.
+ */
+AK_TEST(testCompile)
+{
+    std::string directory = makeInputDirectory();
+    AKAssetCompiler *compiler = makeCompiler(directory, 1);
+    nCompiled = 0;
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+    AKAssertEqual(nCompiled, 3);
+    AKAssertEqual(AKAssetCompilerReportCount(compiler), 3u);
+
+    const char *paths[] = {"a.obj", "b.DAE", "models/c.obj"};
+    const char *names[] = {"a", "b", "c"};
+    std::string manifest = "AKASSETS 1 0000000000000001\n";
+    for (size_t i = 0; i < 3; i++)
+    {
+        AKAssetReport report = AKAssetCompilerReportAt(compiler, i);
+        AKAssertEqual(std::string(report.path), paths[i]);
+        AKAssertEqual(std::string(report.assetPath),
+                      std::string(paths[i]) + ".akscene");
+        AKAssertEqual(report.status, AKAssetCompiled);
+        AKAssertEqual(report.fileBytes, 1u);
+        AKAssertTrue(report.assetBytes > 0);
+        AKAssertEqual(std::string(report.error), "");
+
+        std::string assetPath = directory + "/assets/" + report.assetPath;
+        AKSceneArchive *archive =
+            AKSceneArchiveOpen(assetPath.c_str(), report.key);
+        AKAssertTrue(archive != NULL);
+        AKAssertEqual(std::string(AKSceneArchiveString(
+                          archive, AKSceneArchiveNodeAt(archive, 0)->name)),
+                      names[i]);
+        AKSceneArchiveRelease(archive);
+
+        char line[256];
+        snprintf(line, sizeof(line), "%016llx\t%zu\t%s\t%s\n", report.key,
+                 report.assetBytes, report.path, report.assetPath);
+        manifest += line;
+    }
+    AKAssertEqual(readManifest(directory), manifest);
+    AKAssetCompilerRelease(compiler);
+    removeDirectory(directory);
+}
+
+/**
+ Tests a run compiles only the files which changed since the last run, and
+ every file when the settings change.
+ */
+AK_TEST(testIncremental)
+{
+    std::string directory = makeInputDirectory();
+    AKAssetCompiler *compiler = makeCompiler(directory, 1);
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+    unsigned long long key = AKAssetCompilerReportAt(compiler, 0).key;
+    std::string manifest = readManifest(directory);
+    AKAssetCompilerRelease(compiler);
+
+    compiler = makeCompiler(directory, 1);
+    nCompiled = 0;
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+    AKAssertEqual(nCompiled, 0);
+    for (size_t i = 0; i < 3; i++)
+    {
+        AKAssertEqual(AKAssetCompilerReportAt(compiler, i).status,
+                      AKAssetUpToDate);
+    }
+    AKAssertEqual(readManifest(directory), manifest);
+
+    writeFile(directory + "/a.obj", "A");
+    nCompiled = 0;
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+    AKAssertEqual(nCompiled, 1);
+    AKAssertEqual(AKAssetCompilerReportAt(compiler, 0).status,
+                  AKAssetCompiled);
+    AKAssertTrue(AKAssetCompilerReportAt(compiler, 0).key != key);
+    AKAssertEqual(AKAssetCompilerReportAt(compiler, 1).status,
+                  AKAssetUpToDate);
+
+    // an asset which is not the one of the manifest is compiled again
+    writeFile(directory + "/assets/b.DAE.akscene", "damaged");
+    nCompiled = 0;
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+    AKAssertEqual(nCompiled, 1);
+    AKAssertEqual(AKAssetCompilerReportAt(compiler, 1).status,
+                  AKAssetCompiled);
+    AKAssetCompilerRelease(compiler);
+
+    compiler = makeCompiler(directory, 2);
+    nCompiled = 0;
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+    AKAssertEqual(nCompiled, 3);
+    AKAssetCompilerRelease(compiler);
+    removeDirectory(directory);
+}
+
+/**
+ Tests the asset of a file which is gone is removed, and a file which fails
+ has no asset, is left out of the manifest and is compiled again by the next
+ run.
+ */
+AK_TEST(testRemovedAndFailedFiles)
+{
+    std::string directory = makeInputDirectory();
+    AKAssetCompiler *compiler = makeCompiler(directory, 1);
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+
+    remove((directory + "/models/c.obj").c_str());
+    writeFile(directory + "/b.DAE", "bad");
+    nCompiled = 0;
+    AKAssertFalse(AKAssetCompilerRun(compiler, NULL));
+    AKAssertEqual(nCompiled, 1);
+    AKAssertEqual(AKAssetCompilerRemovedCount(compiler), 1u);
+    AKAssertEqual(AKAssetCompilerReportCount(compiler), 2u);
+    AKAssetReport report = AKAssetCompilerReportAt(compiler, 1);
+    AKAssertEqual(report.status, AKAssetFailed);
+    AKAssertEqual(std::string(report.error), "bad scene");
+    AKAssertEqual(report.assetBytes, 0u);
+    AKAssertTrue(
+        access((directory + "/assets/models/c.obj.akscene").c_str(), F_OK) !=
+        0);
+    AKAssertTrue(
+        access((directory + "/assets/b.DAE.akscene").c_str(), F_OK) != 0);
+    std::string manifest = readManifest(directory);
+    AKAssertTrue(manifest.find("a.obj") != std::string::npos);
+    AKAssertTrue(manifest.find("b.DAE") == std::string::npos);
+
+    writeFile(directory + "/b.DAE", "b");
+    nCompiled = 0;
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+    AKAssertEqual(nCompiled, 1);
+    AKAssertEqual(AKAssetCompilerRemovedCount(compiler), 0u);
+    AKAssetCompilerRelease(compiler);
+    removeDirectory(directory);
+}
+
+/**
+ Tests the files compiled on the workers of a pool get the same assets and
+ manifest as the files compiled on the calling thread.
+ */
+AK_TEST(testWorkPool)
+{
+    std::string directory = makeInputDirectory();
+    for (int i = 0; i < 16; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "/models/scene%02d.obj", i);
+        writeFile(directory + name, name + 8);
+    }
+    AKAssetCompiler *compiler = makeCompiler(directory, 1);
+    AKAssertTrue(AKAssetCompilerRun(compiler, NULL));
+    std::string manifest = readManifest(directory);
+    AKAssetCompilerRelease(compiler);
+    removeDirectory(directory + "/assets");
+
+    compiler = makeCompiler(directory, 1);
+    AKWorkPool *pool = AKWorkPoolCreate(4, 0);
+    nCompiled = 0;
+    AKAssertTrue(AKAssetCompilerRun(compiler, pool));
+    AKAssertEqual(nCompiled, 19);
+    AKAssertEqual(readManifest(directory), manifest);
+    AKWorkPoolRelease(pool);
+    AKAssetCompilerRelease(compiler);
+    removeDirectory(directory);
+}
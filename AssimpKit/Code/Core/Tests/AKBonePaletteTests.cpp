@@ -0,0 +1,142 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBonePalette.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <stdio.h>
+#include <string.h>
+
+#pragma mark - Bone order
+
+/**
+ Makes a scene whose root node has a mesh with the bones hip and spine, and a
+ child node with a mesh with the bones spine and arm.
+
+ @return A new scene.
+ */
+static aiScene *makeBoneScene()
+{
+    std::vector<std::pair<unsigned int, float> > weights(
+        1, std::make_pair(0u, 1.0f));
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(3, 1, 0));
+    AKTestAddBone(meshes[0], "hip", weights);
+    AKTestAddBone(meshes[0], "spine", weights);
+    meshes.push_back(AKTestMakeMesh(3, 1, 0));
+    AKTestAddBone(meshes[1], "spine", weights);
+    AKTestAddBone(meshes[1], "arm", weights);
+    aiNode *root = AKTestMakeNode("root", std::vector<unsigned int>(1, 0));
+    AKTestAddChild(root,
+                   AKTestMakeNode("body", std::vector<unsigned int>(1, 1)));
+    return AKTestMakeScene(root, meshes);
+}
+
+/**
+ Tests the palette has each bone once, in depth first order of appearance.
+ */
+AK_TEST(testBoneOrder)
+{
+    aiScene *scene = makeBoneScene();
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+    AKAssertEqual(AKBonePaletteCount(palette), 3u);
+    AKAssertEqual(strcmp(AKBonePaletteName(palette, 0), "hip"), 0);
+    AKAssertEqual(strcmp(AKBonePaletteName(palette, 1), "spine"), 0);
+    AKAssertEqual(strcmp(AKBonePaletteName(palette, 2), "arm"), 0);
+    AKBonePaletteRelease(palette);
+    delete scene;
+}
+
+#pragma mark - Bone lookup
+
+/**
+ Tests the bones are found by name and by assimp bone.
+ */
+AK_TEST(testBoneLookup)
+{
+    aiScene *scene = makeBoneScene();
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+    AKAssertEqual(AKBonePaletteIndexOfName(palette, "arm"), 2);
+    AKAssertEqual(AKBonePaletteIndexOfName(palette, "hip"), 0);
+    AKAssertEqual(AKBonePaletteIndexOfName(palette, "leg"), -1);
+    AKAssertEqual(AKBonePaletteIndexOfName(palette, "spin"), -1);
+    AKAssertEqual(
+        AKBonePaletteIndexOfBone(palette, scene->mMeshes[1]->mBones[0]), 1);
+    AKBonePaletteRelease(palette);
+    delete scene;
+}
+
+/**
+ Tests every bone of a large skeleton is found at its own index.
+ */
+AK_TEST(testLargeSkeleton)
+{
+    std::vector<std::pair<unsigned int, float> > weights(
+        1, std::make_pair(0u, 1.0f));
+    std::vector<aiMesh *> meshes(1, AKTestMakeMesh(3, 1, 0));
+    const unsigned int nBones = 1000;
+    for (unsigned int i = 0; i < nBones; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "bone-%u", i);
+        AKTestAddBone(meshes[0], name, weights);
+    }
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+    AKAssertEqual(AKBonePaletteCount(palette), nBones);
+    for (unsigned int i = 0; i < nBones; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "bone-%u", i);
+        AKAssertEqual(AKBonePaletteIndexOfName(palette, name), (int)i);
+    }
+    AKBonePaletteRelease(palette);
+    delete scene;
+}
+
+/**
+ Tests a scene without bones has an empty palette.
+ */
+AK_TEST(testEmptyPalette)
+{
+    aiScene *scene =
+        AKTestMakeScene(AKTestMakeNode("root"), std::vector<aiMesh *>());
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+    AKAssertEqual(AKBonePaletteCount(palette), 0u);
+    AKAssertEqual(AKBonePaletteIndexOfName(palette, "hip"), -1);
+    AKBonePaletteRelease(palette);
+    delete scene;
+}
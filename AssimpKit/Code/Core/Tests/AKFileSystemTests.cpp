@@ -0,0 +1,307 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKFileSystem.h"
+#include "AKTest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#pragma mark - Files
+
+/**
+ Writes a temporary file.
+
+ @param contents The contents of the file.
+ @return The path of the file, which the caller removes.
+ */
+static std::string writeTemporaryFile(const std::string &contents)
+{
+    char path[] = "/tmp/AKFileSystemTestsXXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0)
+    {
+        ssize_t written = write(fd, contents.data(), contents.size());
+        (void)written;
+        close(fd);
+    }
+    return path;
+}
+
+/**
+ Reads the rest of a file.
+
+ @param file The file.
+ @return The bytes read.
+ */
+static std::string readRest(AKFile *file)
+{
+    std::string contents;
+    char buffer[7];
+    size_t n;
+    while ((n = AKFileRead(file, buffer, sizeof(buffer))) > 0)
+    {
+        contents.append(buffer, n);
+    }
+    return contents;
+}
+
+/**
+ The requests of a resolver.
+ */
+struct AKTestResolver
+{
+    /**
+     The names which the resolver was asked for.
+     */
+    std::vector<std::string> names;
+
+    /**
+     The contents of the only file which the resolver supplies.
+     */
+    std::string contents;
+};
+
+/**
+ Supplies the file named textures/wood.png.
+
+ @param context The resolver.
+ @param name The name of the file.
+ @param data Receives the bytes of the file.
+ @param length Receives the number of bytes of the file.
+ @return 1 if the file was resolved.
+ */
+static int resolveFile(void *context,
+                       const char *name,
+                       const void **data,
+                       size_t *length)
+{
+    AKTestResolver *resolver = (AKTestResolver *)context;
+    resolver->names.push_back(name);
+    if (strcmp(name, "textures/wood.png") != 0)
+    {
+        return 0;
+    }
+    *data = resolver->contents.data();
+    *length = resolver->contents.size();
+    return 1;
+}
+
+/**
+ Tests a memory file is read in place, and reads and seeks stay in the file.
+ */
+AK_TEST(testMemoryFile)
+{
+    const std::string contents = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+    AKFileSystem *fs = AKFileSystemCreate();
+    AKFileSystemAddMemoryFile(fs, "scene.obj", contents.data(),
+                              contents.size());
+    AKAssertTrue(AKFileSystemExists(fs, "scene.obj"));
+    AKAssertTrue(!AKFileSystemExists(fs, "/no/such/scene.obj"));
+    AKAssertTrue(AKFileSystemOpen(fs, "/no/such/scene.obj") == NULL);
+
+    AKFile *file = AKFileSystemOpen(fs, "scene.obj");
+    AKAssertTrue(file != NULL);
+    AKAssertTrue(AKFileBytes(file) == contents.data());
+    AKAssertEqual(AKFileSize(file), contents.size());
+    AKAssertTrue(readRest(file) == contents);
+    AKAssertEqual(AKFileTell(file), contents.size());
+    AKAssertTrue(AKFileSeek(file, 8));
+    AKAssertTrue(!AKFileSeek(file, contents.size() + 1));
+    AKAssertEqual(AKFileTell(file), 8u);
+    AKAssertTrue(readRest(file) == contents.substr(8));
+    AKFileClose(file);
+    AKFileSystemRelease(fs);
+}
+
+/**
+ Tests the resolver is asked once for each file, by its name relative to the
+ base directory, its files are read in place, and the files it does not
+ resolve are looked for on the disk.
+ */
+AK_TEST(testResolver)
+{
+    AKTestResolver resolver;
+    resolver.contents = "not really a png";
+    AKFileSystem *fs = AKFileSystemCreate();
+    AKFileSystemSetResolver(fs, resolveFile, &resolver);
+    AKFileSystemSetBaseDirectory(fs, "/packs/level1");
+
+    AKAssertTrue(AKFileSystemExists(fs, "/packs/level1/textures/wood.png"));
+    AKFile *file = AKFileSystemOpen(fs, "/packs/level1/textures/wood.png");
+    AKAssertTrue(file != NULL);
+    AKAssertTrue(AKFileBytes(file) == resolver.contents.data());
+    AKAssertTrue(readRest(file) == resolver.contents);
+    AKFileClose(file);
+
+    AKAssertTrue(!AKFileSystemExists(fs, "/packs/level1/scene.mtl"));
+    AKAssertTrue(AKFileSystemOpen(fs, "/packs/level1/scene.mtl") == NULL);
+    AKAssertTrue(!AKFileSystemExists(fs, "/elsewhere/scene.mtl"));
+
+    AKAssertEqual(resolver.names.size(), 3u);
+    AKAssertTrue(resolver.names[0] == "textures/wood.png");
+    AKAssertTrue(resolver.names[1] == "scene.mtl");
+    AKAssertTrue(resolver.names[2] == "/elsewhere/scene.mtl");
+    AKAssertEqual(AKFileSystemGetStats(fs).nResolved, 1u);
+
+    // the files which are not resolved are looked for on the disk
+    AKAssertEqual(AKFileSystemDiskPathCount(fs), 2u);
+    AKAssertTrue(strcmp(AKFileSystemDiskPath(fs, 0),
+                        "/packs/level1/scene.mtl") == 0);
+    AKAssertTrue(strcmp(AKFileSystemDiskPath(fs, 1),
+                        "/elsewhere/scene.mtl") == 0);
+    AKFileSystemRelease(fs);
+}
+
+/**
+ Tests a file on the disk reads the same whether it is memory mapped or read
+ with buffered reads.
+ */
+AK_TEST(testDiskFiles)
+{
+    std::string contents;
+    for (int i = 0; i < 10000; i++)
+    {
+        contents += "v " + std::to_string(i) + " 0 0\n";
+    }
+    std::string path = writeTemporaryFile(contents);
+    for (int mapsFiles = 0; mapsFiles < 2; mapsFiles++)
+    {
+        AKFileSystem *fs = AKFileSystemCreate();
+        AKFileSystemSetMapsFiles(fs, mapsFiles);
+        AKAssertTrue(AKFileSystemExists(fs, path.c_str()));
+        AKFile *file = AKFileSystemOpen(fs, path.c_str());
+        AKAssertTrue(file != NULL);
+        AKAssertEqual(AKFileBytes(file) != NULL, mapsFiles != 0);
+        AKAssertEqual(AKFileSize(file), contents.size());
+        AKAssertTrue(readRest(file) == contents);
+        AKAssertTrue(AKFileSeek(file, contents.size() - 5));
+        AKAssertTrue(readRest(file) == contents.substr(contents.size() - 5));
+        AKFileClose(file);
+        AKFileSystemRelease(fs);
+    }
+
+    // an empty file cannot be mapped and is read with buffered reads
+    std::string emptyPath = writeTemporaryFile("");
+    AKFileSystem *fs = AKFileSystemCreate();
+    AKFileSystemSetMapsFiles(fs, 1);
+    AKFile *file = AKFileSystemOpen(fs, emptyPath.c_str());
+    AKAssertTrue(file != NULL);
+    AKAssertEqual(AKFileSize(file), 0u);
+    AKAssertTrue(readRest(file).empty());
+    AKFileClose(file);
+    AKFileSystemRelease(fs);
+    remove(emptyPath.c_str());
+    remove(path.c_str());
+}
+
+/**
+ Tests a file on the disk is opened from the disk once, whether it is mapped
+ or read with buffered reads, and its reads are counted.
+ */
+AK_TEST(testHandleCache)
+{
+    std::string contents(100000, 'x');
+    std::string path = writeTemporaryFile(contents);
+    for (int mapsFiles = 0; mapsFiles < 2; mapsFiles++)
+    {
+        AKFileSystem *fs = AKFileSystemCreate();
+        AKFileSystemSetMapsFiles(fs, mapsFiles);
+        for (int i = 0; i < 3; i++)
+        {
+            AKFile *file = AKFileSystemOpen(fs, path.c_str());
+            AKAssertTrue(file != NULL);
+            AKAssertEqual(AKFileTell(file), 0u);
+            AKAssertTrue(readRest(file) == contents);
+            AKFileClose(file);
+        }
+        // a file opened twice at the same time has a stream of its own
+        AKFile *first = AKFileSystemOpen(fs, path.c_str());
+        AKFile *second = AKFileSystemOpen(fs, path.c_str());
+        char byte;
+        AKAssertTrue(AKFileSeek(first, 10));
+        AKAssertEqual(AKFileRead(second, &byte, 1), 1u);
+        AKAssertEqual(AKFileTell(second), 1u);
+        AKFileClose(first);
+        AKFileClose(second);
+
+        AKFileSystemStats stats = AKFileSystemGetStats(fs);
+        AKAssertEqual(stats.nOpens, 5u);
+        AKAssertEqual(stats.nDiskOpens, mapsFiles ? 1u : 2u);
+        AKAssertEqual(stats.nCachedOpens, mapsFiles ? 4u : 3u);
+        AKAssertEqual(stats.bytesRead, 3 * contents.size() + 1);
+        AKAssertTrue(stats.nReads > 3 * contents.size() / 7);
+        AKAssertTrue(stats.ioSeconds > 0.0);
+        AKFileSystemRelease(fs);
+    }
+    remove(path.c_str());
+}
+
+/**
+ Tests a file which a scene refers to is found by its name in the scene, and
+ a file read ahead is not opened from the disk again.
+ */
+AK_TEST(testReadAheadReference)
+{
+    std::string contents = "newmtl Skin\nmap_Kd .\\wood.jpg\n";
+    std::string path = writeTemporaryFile(contents);
+    std::string directory = path.substr(0, path.rfind('/'));
+    std::string name = ".\\" + path.substr(directory.size() + 1);
+    for (int mapsFiles = 0; mapsFiles < 2; mapsFiles++)
+    {
+        AKFileSystem *fs = AKFileSystemCreate();
+        AKFileSystemSetMapsFiles(fs, mapsFiles);
+        AKFileSystemSetBaseDirectory(fs, directory.c_str());
+        AKFileSystemReadAheadReference(fs, name.c_str());
+        AKFileSystemReadAheadReference(fs, "no-such-texture.jpg");
+        AKFile *file = AKFileSystemOpenReference(fs, name.c_str());
+        AKAssertTrue(file != NULL);
+        AKAssertTrue(readRest(file) == contents);
+        AKFileClose(file);
+        // an absolute name is not relative to the base directory
+        file = AKFileSystemOpenReference(fs, path.c_str());
+        AKAssertTrue(file != NULL);
+        AKFileClose(file);
+
+        AKFileSystemStats stats = AKFileSystemGetStats(fs);
+        AKAssertEqual(stats.nReadAheads, 1u);
+        AKAssertEqual(stats.nDiskOpens, 1u);
+        AKFileSystemRelease(fs);
+    }
+    remove(path.c_str());
+}
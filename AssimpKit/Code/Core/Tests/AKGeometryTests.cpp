@@ -0,0 +1,590 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKGeometry.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#pragma mark - Vertex attributes
+
+/**
+ Finds the float components of an attribute of a vertex.
+
+ @param geometry The node geometry.
+ @param attribute The vertex attribute, stored as floats.
+ @param vertex The index of the vertex.
+ @return The components of the attribute.
+ */
+static const float *floatsAt(const AKNodeGeometry *geometry,
+                             AKVertexAttribute attribute,
+                             unsigned int vertex)
+{
+    return (const float *)AKNodeGeometryAttributeAt(geometry, attribute,
+                                                    vertex);
+}
+
+/**
+ Tests the vertex streams of a node with two meshes are combined in mesh order.
+ */
+AK_TEST(testNodeVertexStreams)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(4, 2, AKTestMeshAllStreams));
+    meshes.push_back(AKTestMakeMesh(3, 1, AKTestMeshAllStreams, 100.0f));
+    unsigned int meshIndices[] = {0, 1};
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(meshIndices,
+                                                         meshIndices + 2)),
+        meshes);
+
+    AKAssertEqual(AKNumVerticesInNode(scene->mRootNode, scene), 7u);
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKAssertTrue(geometry != NULL);
+    AKAssertEqual(geometry->nVertices, 7u);
+    // The attributes are interleaved: 3 + 3 + 3 + 2 + 3 floats per vertex
+    AKAssertEqual(geometry->vertexStride, 14 * 4u);
+    AKAssertEqual(geometry->attributes[AKVertexAttributeTexCoord].offset,
+                  9 * 4u);
+    // The first vertex of the second mesh follows the vertices of the first
+    const float *position = floatsAt(geometry, AKVertexAttributePosition, 4);
+    AKAssertEqualWithAccuracy(position[0], 100.0, 1e-6);
+    AKAssertEqualWithAccuracy(position[1], 100.25, 1e-6);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributePosition, 6)[2], 102.5, 1e-6);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributeNormal, 6)[2], 1.0, 1e-6);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributeTangent, 5)[0], 1.0, 1e-6);
+    // Texture coordinates have 2 components per vertex
+    const float *texCoord = floatsAt(geometry, AKVertexAttributeTexCoord, 1);
+    AKAssertEqualWithAccuracy(texCoord[0], 0.25, 1e-6);
+    AKAssertEqualWithAccuracy(texCoord[1], 0.75, 1e-6);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributeColor, 6)[2], 0.3, 1e-6);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+/**
+ Tests a mesh without normals or colors keeps the other streams aligned and
+ drops the color stream for the node.
+ */
+AK_TEST(testMissingStreams)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(3, 1, 0));
+    meshes.push_back(AKTestMakeMesh(3, 1, AKTestMeshAllStreams));
+    unsigned int meshIndices[] = {0, 1};
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(meshIndices,
+                                                         meshIndices + 2)),
+        meshes);
+
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributeNormal, 0)[2], 0.0, 1e-6);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributeNormal, 3)[2], 1.0, 1e-6);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributeTexCoord, 3)[1], 1.0, 1e-6);
+    AKAssertTrue(floatsAt(geometry, AKVertexAttributeColor, 0) == NULL);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+/**
+ Tests the attributes which no mesh of the node has are not stored.
+ */
+AK_TEST(testSkipsAbsentAttributes)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(3, 1, AKTestMeshTexCoords));
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKAssertEqual(geometry->vertexStride, 5 * 4u);
+    AKAssertEqual(geometry->attributes[AKVertexAttributeNormal].format,
+                  AKVertexFormatNone);
+    AKAssertEqual(geometry->attributes[AKVertexAttributeTangent].format,
+                  AKVertexFormatNone);
+    AKAssertEqual(geometry->attributes[AKVertexAttributeTexCoord].offset,
+                  3 * 4u);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributeTexCoord, 2)[1], 1.0 / 3.0,
+        1e-6);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+/**
+ Tests the vertex layout picks the stored attributes, and the position is
+ stored even if the layout omits it.
+ */
+AK_TEST(testVertexLayout)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(4, 2, AKTestMeshAllStreams));
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+
+    AKVertexLayout layout = AKVertexLayoutMakeDefault();
+    layout.formats[AKVertexAttributePosition] = AKVertexFormatNone;
+    layout.formats[AKVertexAttributeTangent] = AKVertexFormatNone;
+    layout.formats[AKVertexAttributeColor] = AKVertexFormatNone;
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, &layout);
+    AKAssertEqual(geometry->vertexStride, 8 * 4u);
+    AKAssertEqual(geometry->attributes[AKVertexAttributePosition].format,
+                  AKVertexFormatFloat);
+    AKAssertEqual(geometry->attributes[AKVertexAttributeNormal].offset,
+                  3 * 4u);
+    AKAssertTrue(floatsAt(geometry, AKVertexAttributeTangent, 0) == NULL);
+    AKAssertTrue(floatsAt(geometry, AKVertexAttributeColor, 0) == NULL);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributePosition, 3)[2], 3.5, 1e-6);
+    AKAssertEqualWithAccuracy(
+        floatsAt(geometry, AKVertexAttributeTexCoord, 2)[0], 0.5, 1e-6);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+/**
+ Tests a node without meshes has no geometry.
+ */
+AK_TEST(testEmptyNode)
+{
+    aiScene *scene =
+        AKTestMakeScene(AKTestMakeNode("root"), std::vector<aiMesh *>());
+    AKAssertTrue(AKNodeGeometryCreate(scene->mRootNode, scene, NULL) == NULL);
+    delete scene;
+}
+
+#pragma mark - Quantized vertex attributes
+
+/**
+ Tests the quantized formats shrink the vertices, restore the attributes
+ within their precision and report the error and the bytes saved.
+ */
+AK_TEST(testQuantizedLayout)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(1000, 998, AKTestMeshAllStreams));
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+
+    AKVertexLayout layout;
+    layout.formats[AKVertexAttributePosition] = AKVertexFormatSNorm16;
+    layout.formats[AKVertexAttributeNormal] = AKVertexFormatOctSNorm16;
+    layout.formats[AKVertexAttributeTangent] = AKVertexFormatOctSNorm16;
+    layout.formats[AKVertexAttributeTexCoord] = AKVertexFormatHalf;
+    layout.formats[AKVertexAttributeColor] = AKVertexFormatUNorm8;
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, &layout);
+    // 6 + 2 padding, 4, 4, 4 and 4 bytes instead of 56 bytes of floats
+    AKAssertEqual(geometry->vertexStride, 24u);
+    AKAssertEqual(geometry->attributes[AKVertexAttributeNormal].nComponents,
+                  2u);
+    AKAssertEqual(geometry->attributes[AKVertexAttributeColor].nComponents,
+                  4u);
+    AKAssertEqual(geometry->quantization.bytesSaved, 1000ul * (56 - 24));
+    // the positions span [0, 999.5] mapped to [-1, 1]
+    AKAssertEqualWithAccuracy(geometry->positionOffset[0], 499.5, 1e-3);
+    AKAssertEqualWithAccuracy(geometry->positionScale[0], 499.5, 1e-3);
+
+    float values[4];
+    AKAssertEqual(AKNodeGeometryReadAttribute(
+                      geometry, AKVertexAttributePosition, 700, values),
+                  3u);
+    AKAssertEqualWithAccuracy(values[1], 700.25, 499.5 / 32767.0);
+    AKAssertEqual(AKNodeGeometryReadAttribute(
+                      geometry, AKVertexAttributeNormal, 3, values),
+                  3u);
+    AKAssertEqualWithAccuracy(values[2], 1.0, 1e-6);
+    AKNodeGeometryReadAttribute(geometry, AKVertexAttributeTexCoord, 250,
+                                values);
+    AKAssertEqualWithAccuracy(values[0], 0.25, 1e-3);
+    AKAssertEqual(AKNodeGeometryReadAttribute(
+                      geometry, AKVertexAttributeColor, 0, values),
+                  4u);
+    AKAssertEqualWithAccuracy(values[3], 0.4, 0.5 / 255.0);
+
+    const AKQuantizationReport *report = &geometry->quantization;
+    AKAssertTrue(report->maxPositionError > 0.0f);
+    AKAssertTrue(report->maxPositionError <= 499.5f / 32767.0f);
+    AKAssertTrue(report->maxNormalAngleError < 0.01f);
+    AKAssertTrue(report->maxTangentAngleError < 0.01f);
+    AKAssertTrue(report->maxTexCoordError <= 1.0f / 4096.0f);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+/**
+ Tests half float positions are restored by the position transform, and a
+ format which does not apply to an attribute stores it as floats.
+ */
+AK_TEST(testHalfPositions)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(4, 2, AKTestMeshAllStreams, 5000.0f));
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+
+    AKVertexLayout layout = AKVertexLayoutMakeDefault();
+    layout.formats[AKVertexAttributePosition] = AKVertexFormatHalf;
+    layout.formats[AKVertexAttributeTexCoord] = AKVertexFormatSNorm16;
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, &layout);
+    AKAssertEqual(geometry->attributes[AKVertexAttributeTexCoord].format,
+                  AKVertexFormatFloat);
+    float values[4];
+    AKNodeGeometryReadAttribute(geometry, AKVertexAttributePosition, 3,
+                                values);
+    // far from the origin, yet as precise as half floats in [-1, 1]
+    AKAssertEqualWithAccuracy(values[0], 5003.0, 1e-3);
+    AKAssertEqualWithAccuracy(values[2], 5003.5, 1e-3);
+    AKAssertTrue(geometry->quantization.maxPositionError < 1e-3f);
+    AKAssertEqualWithAccuracy(geometry->quantization.maxNormalAngleError, 0.0,
+                              1e-9);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+#pragma mark - Geometry elements
+
+/**
+ Tests each mesh maps to an element whose indices are offset by the vertices
+ of the preceding meshes.
+ */
+AK_TEST(testElementIndexOffsets)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(4, 2, 0));
+    meshes.push_back(AKTestMakeMesh(3, 1, 0));
+    unsigned int meshIndices[] = {1, 0};
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(meshIndices,
+                                                         meshIndices + 2)),
+        meshes);
+
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKAssertEqual(geometry->nElements, 2u);
+    AKAssertEqual(geometry->elements[0].meshIndex, 1u);
+    AKAssertEqual(geometry->elements[0].nPrimitives, 1u);
+    AKAssertEqual(geometry->elements[1].nIndices, 6u);
+    AKAssertEqual(geometry->elements[1].bytesPerIndex, 1u);
+    AKAssertEqual(AKGeometryElementIndexAt(&geometry->elements[1], 0), 3u);
+    AKAssertEqual(AKGeometryElementIndexAt(&geometry->elements[1], 5), 3u + 3);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+/**
+ Tests a mesh with faces which are not triangles has no indices.
+ */
+AK_TEST(testNonTriangulatedMesh)
+{
+    std::vector<aiMesh *> meshes;
+    aiMesh *mesh = AKTestMakeMesh(4, 1, 0);
+    aiFace &face = mesh->mFaces[0];
+    delete[] face.mIndices;
+    face.mNumIndices = 4;
+    face.mIndices = new unsigned int[4];
+    for (unsigned int k = 0; k < 4; k++)
+    {
+        face.mIndices[k] = k;
+    }
+    meshes.push_back(mesh);
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+
+    AKAssertEqual(AKNumIndicesInMesh(mesh), 4u);
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKAssertTrue(geometry->elements[0].indices == NULL);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+#pragma mark - Index widths
+
+/**
+ Tests the index width is the narrowest one which addresses all vertices.
+ */
+AK_TEST(testBytesPerIndex)
+{
+    AKAssertEqual(AKBytesPerIndexForVertexCount(3), 1u);
+    AKAssertEqual(AKBytesPerIndexForVertexCount(256), 1u);
+    AKAssertEqual(AKBytesPerIndexForVertexCount(257), 2u);
+    AKAssertEqual(AKBytesPerIndexForVertexCount(65536), 2u);
+    AKAssertEqual(AKBytesPerIndexForVertexCount(65537), 4u);
+}
+
+/**
+ Tests the indices of a mesh which follows a mesh with more than 32767
+ vertices are neither wrapped nor truncated, and each element gets its own
+ index width.
+ */
+AK_TEST(testLargeIndexOffsets)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(200, 1, 0));
+    meshes.push_back(AKTestMakeMesh(40000, 1, 0));
+    meshes.push_back(AKTestMakeMesh(30000, 10, 0));
+    unsigned int meshIndices[] = {0, 1, 2};
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(meshIndices,
+                                                         meshIndices + 3)),
+        meshes);
+
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKAssertEqual(geometry->elements[0].bytesPerIndex, 1u);
+    AKAssertEqual(geometry->elements[1].bytesPerIndex, 2u);
+    AKAssertEqual(geometry->elements[2].bytesPerIndex, 4u);
+    // every index is the face index offset by the preceding vertices
+    for (unsigned int e = 0; e < 3; e++)
+    {
+        const AKGeometryElement *element = &geometry->elements[e];
+        const aiMesh *mesh = meshes[e];
+        unsigned int offset = e == 0 ? 0 : (e == 1 ? 200 : 40200);
+        for (unsigned int i = 0; i < element->nIndices; i++)
+        {
+            AKAssertEqual(AKGeometryElementIndexAt(element, i),
+                          offset + mesh->mFaces[i / 3].mIndices[i % 3]);
+        }
+    }
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+#pragma mark - Split geometry
+
+/**
+ Tests a node geometry with more vertices than a chunk can hold is split into
+ chunks with 16 bit indices which reproduce every triangle.
+ */
+AK_TEST(testSplitIntoChunks)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(50000, 49998, AKTestMeshAllStreams));
+    meshes.push_back(AKTestMakeMesh(30000, 29998, AKTestMeshTexCoords));
+    unsigned int meshIndices[] = {0, 1};
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(meshIndices,
+                                                         meshIndices + 2)),
+        meshes);
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKAssertEqual(geometry->elements[1].bytesPerIndex, 4u);
+
+    unsigned int nChunks = 0;
+    AKNodeGeometry **chunks =
+        AKNodeGeometryCreateChunks(geometry, 65535, &nChunks);
+    AKAssertEqual(nChunks, 2u);
+    unsigned int nTriangles[2] = {0, 0};
+    for (unsigned int c = 0; c < nChunks; c++)
+    {
+        const AKNodeGeometry *chunk = chunks[c];
+        AKAssertTrue(chunk->nVertices <= 65535);
+        AKAssertTrue(floatsAt(chunk, AKVertexAttributeColor, 0) == NULL);
+        for (unsigned int e = 0; e < chunk->nElements; e++)
+        {
+            const AKGeometryElement *element = &chunk->elements[e];
+            AKAssertEqual(element->bytesPerIndex, 2u);
+            unsigned int m = element->meshIndex;
+            unsigned int offset = m == 0 ? 0 : 50000;
+            for (unsigned int i = 0; i < element->nIndices; i++)
+            {
+                unsigned int t = nTriangles[m] + i / 3;
+                unsigned int vertex =
+                    chunk->vertexMap[AKGeometryElementIndexAt(element, i)];
+                AKAssertEqual(vertex,
+                              offset + meshes[m]->mFaces[t].mIndices[i % 3]);
+            }
+            nTriangles[m] += element->nPrimitives;
+        }
+        // the vertices are gathered through the vertex map
+        unsigned int last = chunk->nVertices - 1;
+        unsigned int mapped = chunk->vertexMap[last];
+        AKAssertEqualWithAccuracy(
+            floatsAt(chunk, AKVertexAttributePosition, last)[0],
+            floatsAt(geometry, AKVertexAttributePosition, mapped)[0], 1e-6);
+        AKAssertEqualWithAccuracy(
+            floatsAt(chunk, AKVertexAttributeTexCoord, last)[1],
+            floatsAt(geometry, AKVertexAttributeTexCoord, mapped)[1], 1e-6);
+    }
+    AKAssertEqual(nTriangles[0], 49998u);
+    AKAssertEqual(nTriangles[1], 29998u);
+    AKNodeGeometryChunksRelease(chunks, nChunks);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+/**
+ Tests a triangle which does not fit the current chunk starts a new chunk and
+ the vertices it shares with the previous chunk are copied.
+ */
+AK_TEST(testSplitSharedVertices)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(5, 3, 0));
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+
+    // triangles (0, 1, 2), (1, 2, 3), (2, 3, 4) with at most 4 vertices
+    unsigned int nChunks = 0;
+    AKNodeGeometry **chunks = AKNodeGeometryCreateChunks(geometry, 4, &nChunks);
+    AKAssertEqual(nChunks, 2u);
+    AKAssertEqual(chunks[0]->nVertices, 4u);
+    AKAssertEqual(chunks[0]->elements[0].nPrimitives, 2u);
+    AKAssertEqual(chunks[1]->nVertices, 3u);
+    AKAssertEqual(chunks[1]->vertexMap[0], 2u);
+    AKAssertEqual(chunks[1]->vertexMap[2], 4u);
+    AKAssertEqual(chunks[1]->elements[0].bytesPerIndex, 1u);
+    AKNodeGeometryChunksRelease(chunks, nChunks);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+}
+
+#pragma mark - Buffer ownership
+
+/**
+ Tests the caller can take ownership of the vertices and indices of a node
+ geometry, which outlive the geometry and are released with free.
+ */
+AK_TEST(testTakeBuffers)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(4, 2, AKTestMeshAllStreams));
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+
+    unsigned char *vertexData = geometry->vertexData;
+    void *indices = geometry->elements[0].indices;
+    unsigned int stride = geometry->vertexStride;
+    geometry->vertexData = NULL;
+    geometry->elements[0].indices = NULL;
+    AKNodeGeometryRelease(geometry);
+    AKAssertEqualWithAccuracy(((const float *)(vertexData + 3 * stride))[1],
+                              3.25, 1e-6);
+    AKAssertEqual(((const unsigned char *)indices)[5], 3u);
+    free(vertexData);
+    free(indices);
+    delete scene;
+}
+
+#pragma mark - Background conversion
+
+/**
+ Checks two node geometries have the same vertices and indices.
+
+ @param a The first geometry.
+ @param b The second geometry.
+ @return true if the geometries are the same.
+ */
+static bool sameGeometry(const AKNodeGeometry *a, const AKNodeGeometry *b)
+{
+    if (a->nVertices != b->nVertices || a->vertexStride != b->vertexStride ||
+        a->nElements != b->nElements ||
+        memcmp(a->vertexData, b->vertexData,
+               (size_t)a->nVertices * a->vertexStride) != 0)
+    {
+        return false;
+    }
+    for (unsigned int i = 0; i < a->nElements; i++)
+    {
+        const AKGeometryElement *ea = &a->elements[i];
+        const AKGeometryElement *eb = &b->elements[i];
+        if (ea->nIndices != eb->nIndices ||
+            ea->bytesPerIndex != eb->bytesPerIndex ||
+            memcmp(ea->indices, eb->indices,
+                   (size_t)ea->nIndices * ea->bytesPerIndex) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ Tests node geometries converted off the calling thread, concurrently with
+ each other, are the same as a geometry converted on the calling thread, so
+ that the asynchronous import can run the conversion in the background.
+ */
+AK_TEST(testConvertOffCallingThread)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(1500, 1400, AKTestMeshAllStreams));
+    meshes.push_back(AKTestMakeMesh(1200, 1000, AKTestMeshAllStreams, 7));
+    std::vector<unsigned int> meshIndices;
+    meshIndices.push_back(0);
+    meshIndices.push_back(1);
+    aiScene *scene = AKTestMakeScene(AKTestMakeNode("root", meshIndices),
+                                     meshes);
+    AKNodeGeometry *expected =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+
+    AKNodeGeometry *converted[2] = {NULL, NULL};
+    std::thread threads[2];
+    for (int i = 0; i < 2; i++)
+    {
+        threads[i] = std::thread([&converted, scene, i]() {
+            AKSceneStats *stats = AKSceneStatsCreate(scene);
+            converted[i] = AKNodeGeometryCreateWithStats(scene->mRootNode,
+                                                         scene, NULL, stats);
+            AKSceneStatsRelease(stats);
+        });
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        threads[i].join();
+        AKAssertTrue(sameGeometry(expected, converted[i]));
+        AKNodeGeometryRelease(converted[i]);
+    }
+    AKNodeGeometryRelease(expected);
+    delete scene;
+}
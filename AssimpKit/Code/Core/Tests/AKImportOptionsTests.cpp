@@ -0,0 +1,277 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKImportOptions.h"
+#include "AKTest.h"
+#include "assimp/config.h"
+#include "assimp/postprocess.h"
+#include <map>
+#include <string>
+
+#pragma mark - Importer properties
+
+/**
+ The properties received from import options.
+ */
+struct AKTestProperties
+{
+    /**
+     The integer properties by name.
+     */
+    std::map<std::string, int> integers;
+
+    /**
+     The float properties by name.
+     */
+    std::map<std::string, float> floats;
+};
+
+/**
+ Records an integer property.
+
+ @param context The properties.
+ @param name The name of the property.
+ @param value The value of the property.
+ */
+static void recordIntegerProperty(void *context, const char *name, int value)
+{
+    ((AKTestProperties *)context)->integers[name] = value;
+}
+
+/**
+ Records a float property.
+
+ @param context The properties.
+ @param name The name of the property.
+ @param value The value of the property.
+ */
+static void recordFloatProperty(void *context, const char *name, float value)
+{
+    ((AKTestProperties *)context)->floats[name] = value;
+}
+
+/**
+ Tests the default options are valid and are the defaults of assimp.
+ */
+AK_TEST(testDefaults)
+{
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    AKAssertTrue(AKImportOptionsValidate(&options) == NULL);
+
+    AKTestProperties properties;
+    AKImportOptionsVisitProperties(&options, recordIntegerProperty,
+                                   recordFloatProperty, &properties);
+    AKAssertEqual(properties.integers.size(), 6u);
+    AKAssertEqual(properties.floats.size(), 1u);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_SLM_VERTEX_LIMIT],
+                  AI_SLM_DEFAULT_MAX_VERTICES);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_SLM_TRIANGLE_LIMIT],
+                  AI_SLM_DEFAULT_MAX_TRIANGLES);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_LBW_MAX_WEIGHTS],
+                  AI_LMW_MAX_WEIGHTS);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_ICL_PTCACHE_SIZE],
+                  PP_ICL_PTCACHE_SIZE);
+    AKAssertEqual(properties.integers[AI_CONFIG_FAVOUR_SPEED], 0);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_RVC_FLAGS], 0);
+    AKAssertEqualWithAccuracy(
+        properties.floats[AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE], 175.0, 1e-6);
+    AKAssertEqual(options.components, (unsigned int)AKImportComponentAll);
+}
+
+/**
+ Tests each option reaches its assimp property.
+ */
+AK_TEST(testProperties)
+{
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    options.splitVertexLimit = 65535;
+    options.splitTriangleLimit = 21845;
+    options.maxBoneWeights = 2;
+    options.vertexCacheSize = 32;
+    options.maxSmoothingAngle = 80.0f;
+    options.favourSpeed = 7;
+    AKAssertTrue(AKImportOptionsValidate(&options) == NULL);
+
+    AKTestProperties properties;
+    AKImportOptionsVisitProperties(&options, recordIntegerProperty,
+                                   recordFloatProperty, &properties);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_SLM_VERTEX_LIMIT], 65535);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_SLM_TRIANGLE_LIMIT],
+                  21845);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_LBW_MAX_WEIGHTS], 2);
+    AKAssertEqual(properties.integers[AI_CONFIG_PP_ICL_PTCACHE_SIZE], 32);
+    AKAssertEqual(properties.integers[AI_CONFIG_FAVOUR_SPEED], 1);
+    AKAssertEqualWithAccuracy(
+        properties.floats[AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE], 80.0, 1e-6);
+}
+
+/**
+ Tests options which would stall or break a post processing step are not
+ valid.
+ */
+AK_TEST(testInvalidOptions)
+{
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    options.splitVertexLimit = 2;
+    AKAssertTrue(AKImportOptionsValidate(&options) != NULL);
+
+    options = AKImportOptionsMakeDefault();
+    options.splitTriangleLimit = 0;
+    AKAssertTrue(AKImportOptionsValidate(&options) != NULL);
+
+    options = AKImportOptionsMakeDefault();
+    options.maxBoneWeights = 0;
+    AKAssertTrue(AKImportOptionsValidate(&options) != NULL);
+
+    options = AKImportOptionsMakeDefault();
+    options.vertexCacheSize = 2;
+    AKAssertTrue(AKImportOptionsValidate(&options) != NULL);
+
+    options = AKImportOptionsMakeDefault();
+    options.maxSmoothingAngle = 180.0f;
+    AKAssertTrue(AKImportOptionsValidate(&options) != NULL);
+    options = AKImportOptionsMakeDefault();
+    options.components = AKImportComponentAll + 1;
+    AKAssertTrue(AKImportOptionsValidate(&options) != NULL);
+}
+
+#pragma mark - Scene components
+
+/**
+ The post processing steps of the examples, with a step for each component.
+ */
+static const unsigned int AKTestFlags =
+    aiProcess_FlipUVs | aiProcess_Triangulate |
+    aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals |
+    aiProcess_ImproveCacheLocality | aiProcess_RemoveRedundantMaterials |
+    aiProcess_GenUVCoords | aiProcess_LimitBoneWeights |
+    aiProcess_MakeLeftHanded | aiProcess_OptimizeGraph;
+
+/**
+ Returns the components removed by the RemoveComponent step for the specified
+ import components.
+
+ @param components The import components.
+ @return The aiComponent flags.
+ */
+static int removedComponents(unsigned int components)
+{
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    options.components = components;
+    AKTestProperties properties;
+    AKImportOptionsVisitProperties(&options, recordIntegerProperty,
+                                   recordFloatProperty, &properties);
+    return properties.integers[AI_CONFIG_PP_RVC_FLAGS];
+}
+
+/**
+ Returns the post processing steps of the examples trimmed to the specified
+ import components.
+
+ @param components The import components.
+ @return The post processing steps.
+ */
+static unsigned int trimmedFlags(unsigned int components)
+{
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    options.components = components;
+    return AKImportOptionsPostProcessFlags(&options, AKTestFlags);
+}
+
+/**
+ Tests every step is kept and nothing is removed when every component is
+ imported.
+ */
+AK_TEST(testAllComponents)
+{
+    AKAssertEqual(trimmedFlags(AKImportComponentAll), AKTestFlags);
+    AKAssertEqual(trimmedFlags(AKImportComponentAll) &
+                      aiProcess_RemoveComponent,
+                  0u);
+    AKAssertEqual(removedComponents(AKImportComponentAll), 0);
+}
+
+/**
+ Tests an import of the animations only skips the geometry steps, but keeps
+ the bones which the skeleton is found from and the steps which change the
+ nodes or the bones.
+ */
+AK_TEST(testAnimationsOnly)
+{
+    unsigned int flags = trimmedFlags(AKImportComponentAnimations);
+    AKAssertEqual(flags,
+                  (unsigned int)(aiProcess_LimitBoneWeights |
+                                 aiProcess_MakeLeftHanded |
+                                 aiProcess_OptimizeGraph |
+                                 aiProcess_RemoveComponent));
+    int removed = removedComponents(AKImportComponentAnimations);
+    AKAssertEqual(removed & aiComponent_ANIMATIONS, 0);
+    AKAssertEqual(removed & aiComponent_BONEWEIGHTS, 0);
+    AKAssertEqual(removed & aiComponent_MESHES, 0);
+    AKAssertTrue((removed & aiComponent_NORMALS) != 0);
+    AKAssertTrue((removed & aiComponent_TEXTURES) != 0);
+    AKAssertTrue((removed & aiComponent_CAMERAS) != 0);
+    AKAssertTrue((removed & aiComponent_LIGHTS) != 0);
+}
+
+/**
+ Tests an import without textures keeps the geometry steps and skips only the
+ steps which make the uv channels of texture mappings.
+ */
+AK_TEST(testWithoutTextures)
+{
+    unsigned int components = AKImportComponentAll & ~AKImportComponentTextures;
+    AKAssertEqual(trimmedFlags(components),
+                  (AKTestFlags & ~aiProcess_GenUVCoords) |
+                      aiProcess_RemoveComponent);
+    AKAssertEqual(removedComponents(components), (int)aiComponent_TEXTURES);
+}
+
+/**
+ Tests an import of the geometry only removes the bones, the animations, the
+ cameras and the lights, and skips the bone steps.
+ */
+AK_TEST(testGeometryOnly)
+{
+    unsigned int components =
+        AKImportComponentGeometry | AKImportComponentMaterials |
+        AKImportComponentTextures;
+    AKAssertEqual(trimmedFlags(components),
+                  (AKTestFlags & ~aiProcess_LimitBoneWeights) |
+                      aiProcess_RemoveComponent);
+    AKAssertEqual(removedComponents(components),
+                  (int)(aiComponent_BONEWEIGHTS | aiComponent_ANIMATIONS |
+                        aiComponent_CAMERAS | aiComponent_LIGHTS));
+}
@@ -0,0 +1,187 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKImportStats.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+#pragma mark - Scenes
+
+/**
+ Creates a scene of two mesh nodes under a root, where both meshes are
+ skinned by the same bone and the second also by another bone, and an
+ animation of the two mesh nodes.
+
+ @return A new scene.
+ */
+static aiScene *makeSkinnedScene()
+{
+    aiNode *root = AKTestMakeNode("root");
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(10, 8, AKTestMeshAllStreams));
+    meshes.push_back(AKTestMakeMesh(20, 18, AKTestMeshNormals));
+    std::vector<std::pair<unsigned int, float> > weights(
+        1, std::make_pair(0u, 1.0f));
+    AKTestAddBone(meshes[0], "hip", weights);
+    AKTestAddBone(meshes[1], "hip", weights);
+    AKTestAddBone(meshes[1], "knee", weights);
+    AKTestAddChild(root, AKTestMakeNode("a", std::vector<unsigned int>(1, 0)));
+    AKTestAddChild(root, AKTestMakeNode("b", std::vector<unsigned int>(1, 1)));
+    aiScene *scene = AKTestMakeScene(root, meshes);
+    std::vector<const char *> nodeNames;
+    nodeNames.push_back("a");
+    nodeNames.push_back("b");
+    AKTestAddAnimation(scene, AKTestMakeAnimation(nodeNames, 5, 4.0, 1.0));
+    return scene;
+}
+
+#pragma mark - Tests
+
+/**
+ Tests the counts of a scene, with each bone counted once.
+ */
+AK_TEST(testSceneCounts)
+{
+    aiScene *scene = makeSkinnedScene();
+    AKImportStats stats = AKImportStatsMakeEmpty();
+    AKImportStatsAddScene(&stats, scene);
+    AKAssertEqual(stats.nNodes, 3ul);
+    AKAssertEqual(stats.nMeshes, 2ul);
+    AKAssertEqual(stats.nBones, 2ul);
+    AKAssertEqual(stats.nKeyframes, 2ul * 3ul * 5ul);
+    delete scene;
+}
+
+/**
+ Tests the vertices, indices and bytes of converted geometries add up to the
+ sizes of their buffers.
+ */
+AK_TEST(testGeometryBytes)
+{
+    aiScene *scene = makeSkinnedScene();
+    AKImportStats stats = AKImportStatsMakeEmpty();
+    unsigned long vertexBytes = 0;
+    unsigned long indexBytes = 0;
+    for (unsigned int i = 0; i < scene->mRootNode->mNumChildren; i++)
+    {
+        AKNodeGeometry *geometry = AKNodeGeometryCreate(
+            scene->mRootNode->mChildren[i], scene, NULL);
+        AKImportStatsAddGeometry(&stats, geometry);
+        vertexBytes += geometry->nVertices * geometry->vertexStride;
+        for (unsigned int j = 0; j < geometry->nElements; j++)
+        {
+            indexBytes += geometry->elements[j].nIndices *
+                          geometry->elements[j].bytesPerIndex;
+        }
+        AKNodeGeometryRelease(geometry);
+    }
+    AKAssertEqual(stats.nVertices, 30ul);
+    AKAssertEqual(stats.nIndices, 3ul * (8ul + 18ul));
+    AKAssertEqual(stats.indexBytes, indexBytes);
+    AKAssertEqual(stats.attributeBytes[AKVertexAttributePosition],
+                  30ul * 3ul * 4ul);
+    AKAssertEqual(stats.attributeBytes[AKVertexAttributeColor],
+                  10ul * 3ul * 4ul);
+    unsigned long attributeBytes = 0;
+    for (int i = 0; i < AKVertexAttributeCount; i++)
+    {
+        attributeBytes += stats.attributeBytes[i];
+    }
+    AKAssertEqual(attributeBytes, vertexBytes);
+    delete scene;
+}
+
+/**
+ Tests the phase times add up and only the timed phase grows.
+ */
+AK_TEST(testPhaseTimes)
+{
+    AKImportStats stats = AKImportStatsMakeEmpty();
+    double start = AKImportStatsClock();
+    double now = AKImportStatsAddPhaseTime(&stats, AKImportPhaseParse, start);
+    AKAssertTrue(now >= start);
+    AKImportStatsAddPhaseTime(&stats, AKImportPhaseParse, now - 0.5);
+    AKAssertTrue(stats.phaseSeconds[AKImportPhaseParse] >= 0.5);
+    for (int i = AKImportPhasePostProcess; i < AKImportPhaseCount; i++)
+    {
+        AKAssertEqual(stats.phaseSeconds[i], 0.0);
+    }
+}
+
+/**
+ Tests the JSON has every key, and is measured and truncated like snprintf.
+ */
+AK_TEST(testJSON)
+{
+    AKImportStats stats = AKImportStatsMakeEmpty();
+    stats.phaseSeconds[AKImportPhaseSkin] = 0.25;
+    stats.nKeyframes = 42;
+    stats.attributeBytes[AKVertexAttributeTexCoord] = 800;
+    stats.files.bytesRead = 4096;
+    size_t length = AKImportStatsFormatJSON(&stats, NULL, 0);
+    std::vector<char> buffer(length + 1);
+    AKAssertEqual(AKImportStatsFormatJSON(&stats, &buffer[0], buffer.size()),
+                  length);
+    std::string json(&buffer[0]);
+    AKAssertEqual(json.size(), length);
+    AKAssertEqual(json[0], '{');
+    AKAssertEqual(json[length - 1], '}');
+    AKAssertTrue(json.find("\"skin\":0.25") != std::string::npos);
+    AKAssertTrue(json.find("\"keyframes\":42") != std::string::npos);
+    AKAssertTrue(json.find("\"texCoord\":800") != std::string::npos);
+    AKAssertTrue(json.find("\"bytesRead\":4096") != std::string::npos);
+    const char *keys[] = {"\"phases\"",         "\"parse\"",
+                          "\"animations\"",     "\"nodes\"",
+                          "\"meshes\"",         "\"bones\"",
+                          "\"vertices\"",       "\"indices\"",
+                          "\"texturesDecoded\"", "\"texturesCached\"",
+                          "\"attributeBytes\"", "\"indexBytes\"",
+                          "\"files\"",          "\"ioSeconds\"",
+                          "\"memory\"",         "\"peakFootprint\"",
+                          "\"retained\"",       "\"textures\""};
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+    {
+        AKAssertTrue(json.find(keys[i]) != std::string::npos);
+    }
+
+    char truncated[8];
+    AKAssertEqual(AKImportStatsFormatJSON(&stats, truncated, sizeof(truncated)),
+                  length);
+    AKAssertEqual(strlen(truncated), sizeof(truncated) - 1);
+    AKAssertEqual(strncmp(truncated, json.c_str(), 7), 0);
+}
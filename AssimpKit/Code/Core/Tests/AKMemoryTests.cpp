@@ -0,0 +1,211 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKGeometry.h"
+#include "AKMemory.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include "AKWorkPool.h"
+#include <vector>
+
+#pragma mark - Work pool items
+
+/**
+ The buffers allocated by the items of a batch.
+ */
+struct AKTestBuffers
+{
+    /**
+     The buffer of each item.
+     */
+    std::vector<void *> buffers;
+};
+
+/**
+ Allocates the buffer of an item.
+
+ @param context The buffers.
+ @param item The index of the item.
+ @param worker Unused.
+ */
+static void allocateBuffer(void *context, size_t item, unsigned int worker)
+{
+    ((AKTestBuffers *)context)->buffers[item] = AKMemoryMalloc(4096);
+}
+
+#pragma mark - Tests
+
+/**
+ Tests the allocations are charged to the phase of the current account, and
+ the bytes retained and the peak of each phase.
+ */
+AK_TEST(testPhases)
+{
+    AKMemoryAccount *account = AKMemoryAccountCreate();
+    void *uncharged = AKMemoryMalloc(1000);
+    AKAssertTrue(AKMemoryAccountMakeCurrent(account) == NULL);
+    AKAssertTrue(AKMemoryAccountCurrent() == account);
+
+    AKMemoryAccountSetPhase(account, AKImportPhaseGeometry);
+    void *scratch = AKMemoryMalloc(8000);
+    void *kept = AKMemoryCalloc(100, 20);
+    AKMemoryFree(scratch);
+    AKMemoryAccountSetPhase(account, AKImportPhaseSkin);
+    void *skin = AKMemoryMalloc(500);
+    AKMemoryFree(skin);
+
+    AKMemoryStats stats = AKMemoryAccountGetStats(account);
+    const AKPhaseMemory *geometry = &stats.phases[AKImportPhaseGeometry];
+    AKAssertTrue(geometry->bytesAllocated >= 10000);
+    AKAssertTrue(geometry->peakBytes >= 10000);
+    AKAssertTrue(geometry->bytesRetained >= 2000);
+    AKAssertTrue(geometry->bytesRetained < 8000);
+    AKAssertTrue(geometry->footprintBytes > 0);
+    const AKPhaseMemory *skinPhase = &stats.phases[AKImportPhaseSkin];
+    AKAssertTrue(skinPhase->bytesAllocated >= 500);
+    AKAssertTrue(skinPhase->bytesAllocated < 2000);
+    // the bytes kept from the geometry are allocated at once in the skin
+    AKAssertTrue(skinPhase->peakBytes >= geometry->bytesRetained + 500);
+    AKAssertEqual(skinPhase->bytesRetained, geometry->bytesRetained);
+    AKAssertEqual(stats.phases[AKImportPhaseAnimations].bytesAllocated, 0u);
+    AKAssertEqual(stats.phases[AKImportPhaseAnimations].footprintBytes, 0u);
+    AKAssertEqual(stats.peakBytes, geometry->peakBytes);
+
+    AKMemoryFree(kept);
+    AKAssertEqual(AKMemoryAccountGetStats(account)
+                      .phases[AKImportPhaseSkin]
+                      .bytesRetained,
+                  0u);
+    AKAssertTrue(AKMemoryAccountMakeCurrent(NULL) == account);
+    AKMemoryFree(uncharged);
+    AKMemoryAccountRelease(account);
+}
+
+/**
+ Tests the allocations of the workers of a batch are charged to the account
+ current on the thread which runs the batch.
+ */
+AK_TEST(testWorkPool)
+{
+    AKMemoryAccount *account = AKMemoryAccountCreate();
+    AKMemoryAccountMakeCurrent(account);
+    AKMemoryAccountSetPhase(account, AKImportPhaseGeometry);
+    AKTestBuffers buffers;
+    buffers.buffers.resize(64);
+    AKWorkPool *pool = AKWorkPoolCreate(4, 0);
+    AKWorkPoolRun(pool, buffers.buffers.size(), NULL, allocateBuffer,
+                  &buffers);
+    AKWorkPoolRelease(pool);
+    AKMemoryStats stats = AKMemoryAccountGetStats(account);
+    AKAssertTrue(stats.phases[AKImportPhaseGeometry].bytesAllocated >=
+                 64u * 4096u);
+    for (size_t i = 0; i < buffers.buffers.size(); i++)
+    {
+        AKMemoryFree(buffers.buffers[i]);
+    }
+    stats = AKMemoryAccountGetStats(account);
+    AKAssertEqual(stats.phases[AKImportPhaseGeometry].bytesRetained, 0u);
+    AKMemoryAccountMakeCurrent(NULL);
+    AKMemoryAccountRelease(account);
+}
+
+/**
+ Tests a node geometry is charged to the current account, and that releasing
+ it takes all of it off the account.
+ */
+AK_TEST(testNodeGeometry)
+{
+    aiMesh *mesh = AKTestMakeMesh(1000, 998, AKTestMeshAllStreams);
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("node", std::vector<unsigned int>(1, 0)),
+        std::vector<aiMesh *>(1, mesh));
+    AKMemoryAccount *account = AKMemoryAccountCreate();
+    AKMemoryAccountMakeCurrent(account);
+    AKMemoryAccountSetPhase(account, AKImportPhaseGeometry);
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKMemoryStats stats = AKMemoryAccountGetStats(account);
+    size_t geometryBytes = geometry->nVertices * geometry->vertexStride;
+    AKAssertTrue(stats.phases[AKImportPhaseGeometry].bytesRetained >=
+                 geometryBytes);
+    AKAssertTrue(stats.phases[AKImportPhaseGeometry].peakBytes >=
+                 stats.phases[AKImportPhaseGeometry].bytesRetained);
+    AKNodeGeometryRelease(geometry);
+    stats = AKMemoryAccountGetStats(account);
+    AKAssertEqual(stats.phases[AKImportPhaseGeometry].bytesRetained, 0u);
+    AKMemoryAccountMakeCurrent(NULL);
+    AKMemoryAccountRelease(account);
+    delete scene;
+}
+
+/**
+ Tests the decoded textures are counted apart from the phases, and the
+ estimate of the size of a scene.
+ */
+AK_TEST(testTexturesAndScene)
+{
+    AKMemoryAccount *account = AKMemoryAccountCreate();
+    AKMemoryAccountAddTextureBytes(account, 1024 * 1024 * 4);
+    AKMemoryAccountAddTextureBytes(NULL, 1);
+    AKMemoryStats stats = AKMemoryAccountGetStats(account);
+    AKAssertEqual(stats.textureBytes, 1024u * 1024u * 4u);
+    for (int i = 0; i < AKImportPhaseCount; i++)
+    {
+        AKAssertEqual(stats.phases[i].bytesAllocated, 0u);
+    }
+    AKAssertEqual(stats.sceneBytes, 0u);
+    AKMemoryAccountRelease(account);
+
+    aiMesh *mesh = AKTestMakeMesh(1000, 998, AKTestMeshNormals);
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("node", std::vector<unsigned int>(1, 0)),
+        std::vector<aiMesh *>(1, mesh));
+    size_t streamBytes = 1000 * 2 * sizeof(aiVector3D);
+    size_t faceBytes = 998 * 3 * sizeof(unsigned int);
+    AKAssertTrue(AKMemorySceneBytes(scene) >= streamBytes + faceBytes);
+    AKAssertTrue(AKMemorySceneBytes(scene) < 2 * (streamBytes + faceBytes));
+    delete scene;
+}
+
+/**
+ Tests the footprint of the process is known.
+ */
+AK_TEST(testFootprint)
+{
+    size_t footprint = AKMemoryFootprint();
+    AKAssertTrue(footprint > 0);
+    std::vector<char> touched(64 * 1024 * 1024, 1);
+    AKAssertTrue(AKMemoryFootprint() > footprint);
+}
@@ -0,0 +1,166 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKGeometry.h"
+#include "AKMeshStats.h"
+#include "AKSkin.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <string.h>
+
+#pragma mark - Mesh statistics
+
+/**
+ Tests the counts and streams of a skinned triangle mesh.
+ */
+AK_TEST(testMeshStats)
+{
+    aiMesh *mesh = AKTestMakeMesh(
+        4, 2, AKTestMeshNormals | AKTestMeshTexCoords);
+    std::vector<std::pair<unsigned int, float> > hipWeights;
+    hipWeights.push_back(std::make_pair(0u, 1.0f));
+    hipWeights.push_back(std::make_pair(1u, 0.5f));
+    AKTestAddBone(mesh, "hip", hipWeights);
+    std::vector<std::pair<unsigned int, float> > legWeights;
+    legWeights.push_back(std::make_pair(1u, 0.5f));
+    AKTestAddBone(mesh, "leg", legWeights);
+
+    AKMeshStats stats = AKMeshStatsMake(mesh);
+    AKAssertEqual(stats.nVertices, 4u);
+    AKAssertEqual(stats.nIndices, 6u);
+    AKAssertTrue(stats.triangulated);
+    AKAssertEqual(stats.streams,
+                  (unsigned int)(AKMeshStreamNormals | AKMeshStreamTexCoords));
+    AKAssertEqual(stats.nBones, 2u);
+    AKAssertEqual(stats.maxWeights, 2u);
+    delete mesh;
+}
+
+/**
+ Tests a mesh with a quad is not triangulated.
+ */
+AK_TEST(testNonTriangulatedMeshStats)
+{
+    aiMesh *mesh = AKTestMakeMesh(4, 2, 0);
+    aiFace &face = mesh->mFaces[1];
+    delete[] face.mIndices;
+    face.mNumIndices = 4;
+    face.mIndices = new unsigned int[4];
+    for (unsigned int k = 0; k < 4; k++)
+    {
+        face.mIndices[k] = k;
+    }
+
+    AKMeshStats stats = AKMeshStatsMake(mesh);
+    AKAssertEqual(stats.nIndices, 7u);
+    AKAssertTrue(!stats.triangulated);
+    AKAssertEqual(stats.maxWeights, 0u);
+    delete mesh;
+}
+
+/**
+ Tests the weights of a vertex which is not in the mesh are not counted, and
+ that the weights of a vertex are counted past 16 bits without wrapping.
+ */
+AK_TEST(testDamagedWeightStats)
+{
+    aiMesh *mesh = AKTestMakeMesh(4, 2, 0);
+    std::vector<std::pair<unsigned int, float> > hipWeights;
+    hipWeights.push_back(std::make_pair(4u, 1.0f));
+    hipWeights.push_back(std::make_pair(1000000u, 1.0f));
+    hipWeights.push_back(std::make_pair(2u, 1.0f));
+    AKTestAddBone(mesh, "hip", hipWeights);
+    AKMeshStats stats = AKMeshStatsMake(mesh);
+    AKAssertEqual(stats.maxWeights, 1u);
+
+    std::vector<std::pair<unsigned int, float> > legWeights(
+        70000, std::make_pair(0u, 1.0f));
+    AKTestAddBone(mesh, "leg", legWeights);
+    stats = AKMeshStatsMake(mesh);
+    AKAssertEqual(stats.maxWeights, 70000u);
+    delete mesh;
+}
+
+#pragma mark - Scene statistics
+
+/**
+ Tests a node geometry and skin made with the scene statistics are the same as
+ the ones which compute the statistics of the node.
+ */
+AK_TEST(testSceneStats)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(5, 3, AKTestMeshAllStreams));
+    meshes.push_back(AKTestMakeMesh(3, 1, AKTestMeshNormals, 10.0f));
+    std::vector<std::pair<unsigned int, float> > weights;
+    weights.push_back(std::make_pair(2u, 1.0f));
+    AKTestAddBone(meshes[1], "arm", weights);
+    unsigned int meshIndices[] = {0, 1};
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(meshIndices,
+                                                         meshIndices + 2)),
+        meshes);
+
+    AKSceneStats *stats = AKSceneStatsCreate(scene);
+    AKAssertEqual(stats->nMeshes, 2u);
+    AKAssertEqual(stats->meshes[1].nVertices, 3u);
+    AKAssertEqual(AKSceneStatsOfMesh(stats, scene, 0).nIndices, 9u);
+    AKAssertEqual(AKSceneStatsOfMesh(NULL, scene, 1).nBones, 1u);
+
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode, scene, NULL);
+    AKNodeGeometry *statsGeometry =
+        AKNodeGeometryCreateWithStats(scene->mRootNode, scene, NULL, stats);
+    AKAssertEqual(statsGeometry->nVertices, 8u);
+    AKAssertEqual(statsGeometry->vertexStride, geometry->vertexStride);
+    AKAssertTrue(memcmp(statsGeometry->vertexData, geometry->vertexData,
+                        8 * geometry->vertexStride) == 0);
+    AKAssertEqual(statsGeometry->elements[1].nIndices, 3u);
+    AKAssertEqual(AKGeometryElementIndexAt(&statsGeometry->elements[1], 2),
+                  7u);
+    AKNodeGeometryRelease(statsGeometry);
+    AKNodeGeometryRelease(geometry);
+
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+    AKNodeSkin *skin =
+        AKNodeSkinCreateWithStats(scene->mRootNode, scene, palette, stats);
+    AKAssertEqual(skin->nVertices, 8u);
+    AKAssertEqual(skin->maxWeights, 1u);
+    AKAssertEqualWithAccuracy(skin->boneWeights[7], 1.0, 1e-6);
+    AKNodeSkinRelease(skin);
+    AKBonePaletteRelease(palette);
+    AKSceneStatsRelease(stats);
+    delete scene;
+}
@@ -0,0 +1,198 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKGeometry.h"
+#include "AKProgress.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <vector>
+
+#pragma mark - Progress reports
+
+/**
+ The progress reports received by a progress callback.
+ */
+struct AKTestReports
+{
+    /**
+     The phase of each report.
+     */
+    std::vector<AKImportPhase> phases;
+
+    /**
+     The completed fraction of each report.
+     */
+    std::vector<float> fractions;
+};
+
+/**
+ Records a progress report.
+
+ @param context The reports.
+ @param phase The current phase.
+ @param fractionCompleted The completed fraction of the import.
+ */
+static void recordReport(void *context,
+                         AKImportPhase phase,
+                         float fractionCompleted)
+{
+    AKTestReports *reports = (AKTestReports *)context;
+    reports->phases.push_back(phase);
+    reports->fractions.push_back(fractionCompleted);
+}
+
+/**
+ Tests the phases share the import and report a growing fraction.
+ */
+AK_TEST(testPhases)
+{
+    AKTestReports reports;
+    AKProgress *progress = AKProgressCreate(recordReport, &reports);
+    AKAssertEqualWithAccuracy(AKProgressFractionCompleted(progress), 0.0,
+                              1e-6);
+    AKAssertTrue(AKProgressCompletePhase(progress, AKImportPhaseParse));
+    AKAssertTrue(AKProgressCompletePhase(progress, AKImportPhasePostProcess));
+    AKProgressSetPhaseTotal(progress, AKImportPhaseGeometry, 1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        AKAssertTrue(AKProgressAdvance(progress, AKImportPhaseGeometry, 1));
+    }
+    AKAssertEqual(AKProgressPhase(progress), AKImportPhaseGeometry);
+    for (int phase = AKImportPhaseMaterials; phase < AKImportPhaseCount;
+         phase++)
+    {
+        AKAssertTrue(AKProgressCompletePhase(progress, (AKImportPhase)phase));
+    }
+    AKAssertEqualWithAccuracy(AKProgressFractionCompleted(progress), 1.0,
+                              1e-6);
+
+    // every phase is reported, and each report advances by a hundredth or
+    // changes the phase
+    AKAssertEqual(reports.phases.front(), AKImportPhaseParse);
+    AKAssertEqual(reports.phases.back(), AKImportPhaseAnimations);
+    AKAssertEqualWithAccuracy(reports.fractions.back(), 1.0, 1e-6);
+    AKAssertTrue(reports.fractions.size() < 40);
+    for (size_t i = 1; i < reports.fractions.size(); i++)
+    {
+        AKAssertTrue(reports.fractions[i] >= reports.fractions[i - 1]);
+        AKAssertTrue(reports.phases[i] != reports.phases[i - 1] ||
+                     reports.fractions[i] - reports.fractions[i - 1] >=
+                         0.0099f);
+    }
+    AKProgressRelease(progress);
+}
+
+/**
+ Tests work done past the total of a phase does not complete more than the
+ share of the phase.
+ */
+AK_TEST(testPhaseOverrun)
+{
+    AKProgress *progress = AKProgressCreate(NULL, NULL);
+    AKProgressSetPhaseTotal(progress, AKImportPhaseTextures, 2);
+    AKProgressAdvance(progress, AKImportPhaseTextures, 5);
+    AKAssertEqualWithAccuracy(AKProgressFractionCompleted(progress), 0.1,
+                              1e-6);
+    AKProgressRelease(progress);
+}
+
+#pragma mark - Cancellation
+
+/**
+ Tests a cancelled import stops at its next checkpoint and measures the
+ cancellation latency once.
+ */
+AK_TEST(testCancel)
+{
+    AKProgress *progress = AKProgressCreate(NULL, NULL);
+    AKAssertTrue(AKProgressCheckpoint(progress));
+    AKAssertTrue(!AKProgressIsCancelled(progress));
+    AKAssertTrue(AKProgressCancellationLatency(progress) < 0.0);
+
+    AKProgressCancel(progress);
+    AKProgressCancel(progress);
+    AKAssertTrue(AKProgressIsCancelled(progress));
+    AKAssertTrue(AKProgressCancellationLatency(progress) < 0.0);
+    AKAssertTrue(!AKProgressAdvance(progress, AKImportPhaseSkin, 1));
+    double latency = AKProgressCancellationLatency(progress);
+    AKAssertTrue(latency >= 0.0 && latency < 1.0);
+    AKAssertTrue(!AKProgressCheckpoint(progress));
+    AKAssertTrue(!AKProgressCompletePhase(progress, AKImportPhaseSkin));
+    AKAssertEqual(AKProgressCancellationLatency(progress), latency);
+    AKProgressRelease(progress);
+}
+
+/**
+ Tests no progress never stops an import.
+ */
+AK_TEST(testNoProgress)
+{
+    AKAssertTrue(AKProgressCheckpoint(NULL));
+    AKAssertTrue(AKProgressAdvance(NULL, AKImportPhaseGeometry, 1));
+    AKAssertTrue(AKProgressCompletePhase(NULL, AKImportPhaseGeometry));
+    AKAssertTrue(!AKProgressIsCancelled(NULL));
+}
+
+#pragma mark - Geometry checkpoints
+
+/**
+ Tests converting a node geometry advances the geometry phase by its
+ vertices, and a cancelled conversion stops without a geometry.
+ */
+AK_TEST(testGeometryCheckpoints)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(3000, 2000, AKTestMeshAllStreams));
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+
+    AKProgress *progress = AKProgressCreate(NULL, NULL);
+    AKProgressSetPhaseTotal(progress, AKImportPhaseGeometry, 6000);
+    AKNodeGeometry *geometry = AKNodeGeometryCreateWithProgress(
+        scene->mRootNode, scene, NULL, NULL, progress);
+    AKAssertTrue(geometry != NULL);
+    AKAssertEqual(AKProgressPhase(progress), AKImportPhaseGeometry);
+    AKAssertEqualWithAccuracy(AKProgressFractionCompleted(progress), 0.1,
+                              1e-6);
+    AKNodeGeometryRelease(geometry);
+
+    AKProgressCancel(progress);
+    geometry = AKNodeGeometryCreateWithProgress(scene->mRootNode, scene, NULL,
+                                                NULL, progress);
+    AKAssertTrue(geometry == NULL);
+    AKAssertTrue(AKProgressCancellationLatency(progress) >= 0.0);
+    AKProgressRelease(progress);
+    delete scene;
+}
@@ -0,0 +1,156 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKQuantize.h"
+#include "AKTest.h"
+#include <math.h>
+#include <vector>
+
+#pragma mark - Half floats
+
+/**
+ Tests half floats round to nearest even and keep the special values.
+ */
+AK_TEST(testHalfConversion)
+{
+    AKAssertEqual(AKFloatToHalf(0.0f), 0x0000);
+    AKAssertEqual(AKFloatToHalf(-0.0f), 0x8000);
+    AKAssertEqual(AKFloatToHalf(1.0f), 0x3c00);
+    AKAssertEqual(AKFloatToHalf(-2.0f), 0xc000);
+    AKAssertEqual(AKFloatToHalf(65504.0f), 0x7bff);
+    AKAssertEqual(AKFloatToHalf(65520.0f), 0x7c00);
+    AKAssertEqual(AKFloatToHalf(INFINITY), 0x7c00);
+    AKAssertTrue((AKFloatToHalf(NAN) & 0x7fff) > 0x7c00);
+    // the smallest subnormal half
+    AKAssertEqual(AKFloatToHalf(ldexpf(1.0f, -24)), 0x0001);
+    // 1 + 2^-11 is halfway between two halfs and rounds to the even one
+    AKAssertEqual(AKFloatToHalf(1.0f + ldexpf(1.0f, -11)), 0x3c00);
+    AKAssertEqual(AKFloatToHalf(1.0f + 3.0f * ldexpf(1.0f, -11)), 0x3c02);
+    for (unsigned int h = 0; h < 0x7c00; h++)
+    {
+        AKAssertEqual(AKFloatToHalf(AKHalfToFloat((uint16_t)h)), h);
+    }
+}
+
+/**
+ Tests the array conversion matches the conversion of single values, for the
+ vectorized part and the remainder.
+ */
+AK_TEST(testQuantizeHalfMatchesScalar)
+{
+    std::vector<float> src;
+    for (int i = 0; i < 1003; i++)
+    {
+        src.push_back(sinf((float)i) * 1000.0f / (float)(i + 1));
+    }
+    std::vector<uint16_t> dst(src.size());
+    AKQuantizeHalf(src.data(), src.size(), dst.data());
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        AKAssertEqual(dst[i], AKFloatToHalf(src[i]));
+    }
+}
+
+#pragma mark - Normalized integers
+
+/**
+ Tests signed normalized integers are clamped and rounded to nearest, for the
+ vectorized part and the remainder.
+ */
+AK_TEST(testQuantizeSNorm16)
+{
+    float src[11] = {-2.0f, -1.0f, -0.5f, 0.0f, 0.25f, 1.0f,
+                     3.0f,  0.5f,  1e-5f, -1e-5f, 0.999f};
+    int16_t dst[11];
+    AKQuantizeSNorm16(src, 11, dst);
+    AKAssertEqual(dst[0], -32767);
+    AKAssertEqual(dst[1], -32767);
+    AKAssertEqual(dst[2], -16384);
+    AKAssertEqual(dst[3], 0);
+    AKAssertEqual(dst[4], 8192);
+    AKAssertEqual(dst[5], 32767);
+    AKAssertEqual(dst[6], 32767);
+    AKAssertEqual(dst[8], 0);
+    AKAssertEqual(dst[10], 32734);
+    for (int i = 0; i < 11; i++)
+    {
+        float v = src[i] < -1.0f ? -1.0f : (src[i] > 1.0f ? 1.0f : src[i]);
+        AKAssertEqual(dst[i], (int16_t)lrintf(v * 32767.0f));
+    }
+}
+
+/**
+ Tests unsigned normalized bytes are clamped and rounded to nearest.
+ */
+AK_TEST(testQuantizeUNorm8)
+{
+    float src[10] = {-1.0f, 0.0f, 0.1f, 0.5f, 1.0f, 2.0f, 0.2f, 0.6f, 0.4f,
+                     0.9f};
+    uint8_t dst[10];
+    AKQuantizeUNorm8(src, 10, dst);
+    uint8_t expected[10] = {0, 0, 26, 128, 255, 255, 51, 153, 102, 230};
+    for (int i = 0; i < 10; i++)
+    {
+        AKAssertEqual(dst[i], expected[i]);
+    }
+}
+
+#pragma mark - Octahedral vectors
+
+/**
+ Tests unit vectors in every octant survive octahedral encoding.
+ */
+AK_TEST(testOctRoundTrip)
+{
+    for (int i = 0; i < 200; i++)
+    {
+        float theta = (float)i * 0.37f;
+        float z = cosf((float)i * 0.11f);
+        float r = sqrtf(1.0f - z * z);
+        float vector[3] = {r * cosf(theta), r * sinf(theta), z};
+        float oct[2], decoded[3];
+        AKOctEncode(vector, oct);
+        AKAssertTrue(fabsf(oct[0]) <= 1.0f && fabsf(oct[1]) <= 1.0f);
+        AKOctDecode(oct, decoded);
+        for (int k = 0; k < 3; k++)
+        {
+            AKAssertEqualWithAccuracy(decoded[k], vector[k], 1e-5);
+        }
+    }
+    float down[3] = {0.0f, 0.0f, -1.0f}, oct[2], decoded[3];
+    AKOctEncode(down, oct);
+    AKOctDecode(oct, decoded);
+    AKAssertEqualWithAccuracy(decoded[2], -1.0, 1e-6);
+}
@@ -0,0 +1,505 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKBonePalette.h"
+#include "AKSceneArchive.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#pragma mark - Archive data
+
+/**
+ The key of the archives of the tests.
+ */
+static const unsigned long long AKTestKey = 0x1234abcd5678ef90ULL;
+
+/**
+ The parts of a converted scene written to an archive.
+ */
+struct AKTestParts
+{
+    aiScene *scene;
+    AKNodeGeometry *geometry;
+    AKNodeSkin *skin;
+    AKAnimationTracks *tracks;
+};
+
+/**
+ Converts a skinned, animated node with two meshes.
+
+ @return The converted parts, released with releaseParts.
+ */
+static AKTestParts makeParts()
+{
+    std::vector<aiMesh *> meshes;
+    aiMesh *mesh0 = AKTestMakeMesh(4, 2, AKTestMeshAllStreams);
+    std::vector<std::pair<unsigned int, float> > weights;
+    weights.push_back(std::make_pair(0u, 1.0f));
+    weights.push_back(std::make_pair(3u, 0.5f));
+    AKTestAddBone(mesh0, "hip", weights);
+    meshes.push_back(mesh0);
+    meshes.push_back(AKTestMakeMesh(3, 1, AKTestMeshAllStreams, 2.0f));
+    unsigned int meshIndices[] = {0, 1};
+    AKTestParts parts;
+    parts.scene = AKTestMakeScene(
+        AKTestMakeNode("body", std::vector<unsigned int>(meshIndices,
+                                                         meshIndices + 2)),
+        meshes);
+    parts.geometry =
+        AKNodeGeometryCreate(parts.scene->mRootNode, parts.scene, NULL);
+    AKBonePalette *palette = AKBonePaletteCreate(parts.scene);
+    parts.skin = AKNodeSkinCreate(parts.scene->mRootNode, parts.scene, palette);
+    AKBonePaletteRelease(palette);
+    std::vector<const char *> nodeNames;
+    nodeNames.push_back("hip");
+    aiAnimation *animation = AKTestMakeAnimation(nodeNames, 3, 48.0, 24.0);
+    parts.tracks = AKAnimationTracksCreate(animation);
+    delete animation;
+    return parts;
+}
+
+/**
+ Releases the converted parts.
+
+ @param parts The parts.
+ */
+static void releaseParts(AKTestParts *parts)
+{
+    AKNodeGeometryRelease(parts->geometry);
+    AKNodeSkinRelease(parts->skin);
+    AKAnimationTracksRelease(parts->tracks);
+    delete parts->scene;
+}
+
+/**
+ Writes an archive of a body node with a camera child, a material with a
+ color and a texture file, an embedded texture, a bone and an animation.
+
+ @param parts The converted parts.
+ @return The path of the archive, which the caller removes.
+ */
+static std::string writeArchive(const AKTestParts *parts)
+{
+    float transform[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 5, 6, 7, 1};
+    unsigned int meshes[] = {0, 1};
+    AKSceneArchiveWriter *writer = AKSceneArchiveWriterCreate(AKTestKey);
+    unsigned int body =
+        AKSceneArchiveWriterAddNode(writer, "body", AKArchiveNone, transform,
+                                    meshes, 2);
+    AKSceneArchiveWriterSetGeometry(writer, body, parts->geometry);
+    AKSceneArchiveWriterSetSkin(writer, body, parts->skin);
+    unsigned int camera = AKSceneArchiveWriterAddNode(writer, "camera", body,
+                                                      transform, NULL, 0);
+    AKSceneArchiveWriterSetCamera(writer, camera, 0.5f, 0.1f, 100.0f);
+
+    float red[4] = {1, 0, 0, 1};
+    AKSceneArchiveWriterSetMaterial(writer, 2, "skin", 1, NULL);
+    AKSceneArchiveWriterAddMaterialSlot(writer, 2, 1, AKMaterialSlotColor, red,
+                                        0, NULL);
+    AKSceneArchiveWriterAddMaterialSlot(writer, 2, 2,
+                                        AKMaterialSlotExternalTexture, NULL, 0,
+                                        "textures/skin.png");
+    AKSceneArchiveWriterSetMeshMaterial(writer, 0, 2);
+    AKSceneArchiveWriterSetMeshMaterial(writer, 1, 2);
+    const char png[] = "\x89PNG fake";
+    AKSceneArchiveWriterSetTexture(writer, 0, png, sizeof(png), "png");
+
+    float inverseBind[16] = {2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 1};
+    AKSceneArchiveWriterAddBone(writer, "hip", inverseBind);
+    AKSceneArchiveWriterSetSkeleton(writer, body);
+    AKSceneArchiveWriterAddAnimation(writer, parts->tracks);
+
+    char path[] = "/tmp/AKSceneArchiveTestsXXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    AKAssertTrue(AKSceneArchiveWriterWriteFile(writer, path) > 0);
+    AKSceneArchiveWriterRelease(writer);
+    return path;
+}
+
+/**
+ Reads a whole file.
+
+ @param path The path of the file.
+ @return The bytes of the file.
+ */
+static std::vector<unsigned char> readFile(const std::string &path)
+{
+    std::vector<unsigned char> bytes;
+    FILE *file = fopen(path.c_str(), "rb");
+    unsigned char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        bytes.insert(bytes.end(), buffer, buffer + n);
+    }
+    fclose(file);
+    return bytes;
+}
+
+/**
+ Replaces a file.
+
+ @param path The path of the file.
+ @param bytes The new bytes of the file.
+ */
+static void writeFile(const std::string &path,
+                      const std::vector<unsigned char> &bytes)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    fwrite(&bytes[0], 1, bytes.size(), file);
+    fclose(file);
+}
+
+#pragma mark - Round trip
+
+/**
+ Tests the nodes, the geometry, the skin, the materials, the textures, the
+ bones and the animations read back from an archive are those written.
+ */
+AK_TEST(testRoundTrip)
+{
+    AKTestParts parts = makeParts();
+    std::string path = writeArchive(&parts);
+    AKSceneArchive *archive = AKSceneArchiveOpen(path.c_str(), AKTestKey);
+    AKAssertTrue(archive != NULL);
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    AKAssertEqual(header->version, (uint32_t)AK_SCENE_ARCHIVE_VERSION);
+    AKAssertEqual(header->nNodes, 2u);
+    AKAssertEqual(header->skeletonNode, 0u);
+
+    const AKArchiveNode *body = AKSceneArchiveNodeAt(archive, 0);
+    AKAssertEqual(strcmp(AKSceneArchiveString(archive, body->name), "body"),
+                  0);
+    AKAssertEqual(body->parent, AKArchiveNone);
+    AKAssertEqual(body->nMeshes, 2u);
+    AKAssertEqual(AKSceneArchiveNodeMeshes(archive, body)[1], 1u);
+    AKAssertEqualWithAccuracy(body->transform[13], 6.0, 1e-6);
+    const AKArchiveNode *cameraNode = AKSceneArchiveNodeAt(archive, 1);
+    AKAssertEqual(cameraNode->parent, 0u);
+    AKAssertEqual(cameraNode->geometry, AKArchiveNone);
+    const AKArchiveCamera *camera =
+        AKSceneArchiveCameraAt(archive, cameraNode->camera);
+    AKAssertEqualWithAccuracy(camera->zFar, 100.0, 1e-6);
+
+    AKNodeGeometry *geometry =
+        AKSceneArchiveCreateGeometry(archive, body->geometry);
+    AKAssertEqual(geometry->nVertices, parts.geometry->nVertices);
+    AKAssertEqual(geometry->vertexStride, parts.geometry->vertexStride);
+    AKAssertEqual(memcmp(geometry->attributes, parts.geometry->attributes,
+                         sizeof(geometry->attributes)),
+                  0);
+    AKAssertEqual(memcmp(geometry->vertexData, parts.geometry->vertexData,
+                         geometry->nVertices * geometry->vertexStride),
+                  0);
+    AKAssertEqual(geometry->nElements, 2u);
+    for (unsigned int i = 0; i < geometry->nElements; i++)
+    {
+        const AKGeometryElement *element = &geometry->elements[i];
+        const AKGeometryElement *original = &parts.geometry->elements[i];
+        AKAssertEqual(element->meshIndex, original->meshIndex);
+        AKAssertEqual(element->nPrimitives, original->nPrimitives);
+        AKAssertEqual(element->bytesPerIndex, original->bytesPerIndex);
+        AKAssertEqual(memcmp(element->indices, original->indices,
+                             element->nIndices * element->bytesPerIndex),
+                      0);
+    }
+    AKAssertTrue(geometry->vertexMap == NULL);
+    AKNodeGeometryRelease(geometry);
+
+    const AKArchiveGeometry *record =
+        AKSceneArchiveGeometryAt(archive, body->geometry);
+    AKNodeSkin *skin = AKSceneArchiveCreateSkin(archive, record->skin);
+    AKAssertEqual(skin->maxWeights, parts.skin->maxWeights);
+    AKAssertEqual(memcmp(skin->boneWeights, parts.skin->boneWeights,
+                         skin->nVertices * skin->maxWeights * sizeof(float)),
+                  0);
+    AKAssertEqual(memcmp(skin->boneIndices, parts.skin->boneIndices,
+                         skin->nVertices * skin->maxWeights * sizeof(short)),
+                  0);
+    AKNodeSkinRelease(skin);
+
+    const AKArchiveMaterial *material = AKSceneArchiveMeshMaterial(archive, 1);
+    AKAssertTrue(material != NULL);
+    AKAssertEqual(strcmp(AKSceneArchiveString(archive, material->name), "skin"),
+                  0);
+    AKAssertEqual(material->nSlots, 2u);
+    AKAssertEqual(material->hasMultiply, 0u);
+    AKAssertEqual(material->slots[0].kind, (uint32_t)AKMaterialSlotColor);
+    AKAssertEqualWithAccuracy(material->slots[0].color[0], 1.0, 1e-6);
+    AKAssertEqual(strcmp(AKSceneArchiveString(archive,
+                                              material->slots[1].texture),
+                         "textures/skin.png"),
+                  0);
+    AKAssertTrue(AKSceneArchiveMeshMaterial(archive, 2) == NULL);
+
+    size_t nBytes = 0;
+    const char *hint = NULL;
+    const void *texture =
+        AKSceneArchiveTextureBytes(archive, 0, &nBytes, &hint);
+    AKAssertEqual(nBytes, sizeof("\x89PNG fake"));
+    AKAssertEqual(memcmp(texture, "\x89PNG fake", nBytes), 0);
+    AKAssertEqual(strcmp(hint, "png"), 0);
+
+    const AKArchiveBone *bone = AKSceneArchiveBoneAt(archive, 0);
+    AKAssertEqual(strcmp(AKSceneArchiveString(archive, bone->name), "hip"), 0);
+    AKAssertEqualWithAccuracy(bone->inverseBindTransform[5], 2.0, 1e-6);
+
+    AKAnimationTracks *tracks = AKSceneArchiveCreateAnimationTracks(archive, 0);
+    AKAssertEqualWithAccuracy(tracks->duration, parts.tracks->duration, 1e-6);
+    AKAssertEqual(tracks->nChannels, 1u);
+    AKAssertEqual(strcmp(tracks->channels[0].nodeName, "hip"), 0);
+    const AKKeyframeTrack *orientation = &tracks->channels[0].orientation;
+    AKAssertEqual(orientation->nKeys, 3u);
+    AKAssertEqual(memcmp(orientation->values,
+                         parts.tracks->channels[0].orientation.values,
+                         3 * orientation->nComponents * sizeof(float)),
+                  0);
+    AKAnimationTracksRelease(tracks);
+    AKAssertTrue(AKSceneArchiveCreateAnimationTracks(archive, 1) == NULL);
+
+    AKSceneArchiveRelease(archive);
+    remove(path.c_str());
+    releaseParts(&parts);
+}
+
+#pragma mark - Reading in place
+
+/**
+ Determines if a buffer read in place lies inside the mapped file and starts
+ at a multiple of 8 bytes.
+
+ @param archive The archive.
+ @param buffer The buffer.
+ @param nBytes The size of the buffer.
+ @return true if the buffer is aligned inside the file.
+ */
+static bool isMapped(const AKSceneArchive *archive,
+                     const void *buffer,
+                     size_t nBytes)
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    const unsigned char *start = (const unsigned char *)header;
+    const unsigned char *bytes = (const unsigned char *)buffer;
+    return bytes >= start && bytes + nBytes <= start + header->fileBytes &&
+           (bytes - start) % 8 == 0;
+}
+
+/**
+ Tests an archive of any key is opened as a file, and the geometry and the
+ skin read in place are the buffers of the mapped file with the bytes
+ written.
+ */
+AK_TEST(testReadsInPlace)
+{
+    AKTestParts parts = makeParts();
+    std::string path = writeArchive(&parts);
+    AKAssertTrue(AKSceneArchiveOpenFile("/tmp/AKSceneArchiveTestsMissing") ==
+                 NULL);
+    AKSceneArchive *archive = AKSceneArchiveOpenFile(path.c_str());
+    AKAssertTrue(archive != NULL);
+    const AKArchiveNode *body = AKSceneArchiveNodeAt(archive, 0);
+
+    AKNodeGeometry *geometry =
+        AKSceneArchiveCreateGeometryInPlace(archive, body->geometry);
+    size_t nVertexBytes = geometry->nVertices * geometry->vertexStride;
+    AKAssertTrue(isMapped(archive, geometry->vertexData, nVertexBytes));
+    AKAssertEqual(memcmp(geometry->vertexData, parts.geometry->vertexData,
+                         nVertexBytes),
+                  0);
+    AKAssertEqual(geometry->nElements, 2u);
+    for (unsigned int i = 0; i < geometry->nElements; i++)
+    {
+        const AKGeometryElement *element = &geometry->elements[i];
+        size_t nIndexBytes = element->nIndices * element->bytesPerIndex;
+        AKAssertTrue(isMapped(archive, element->indices, nIndexBytes));
+        AKAssertEqual(memcmp(element->indices,
+                             parts.geometry->elements[i].indices, nIndexBytes),
+                      0);
+    }
+    AKSceneArchiveReleaseGeometryInPlace(geometry);
+    AKAssertTrue(AKSceneArchiveCreateGeometryInPlace(archive, 1) == NULL);
+
+    const AKArchiveGeometry *record =
+        AKSceneArchiveGeometryAt(archive, body->geometry);
+    AKNodeSkin *skin = AKSceneArchiveCreateSkinInPlace(archive, record->skin);
+    size_t nWeights = skin->nVertices * skin->maxWeights;
+    AKAssertTrue(
+        isMapped(archive, skin->boneWeights, nWeights * sizeof(float)));
+    AKAssertTrue(
+        isMapped(archive, skin->boneIndices, nWeights * sizeof(short)));
+    AKAssertEqual(memcmp(skin->boneWeights, parts.skin->boneWeights,
+                         nWeights * sizeof(float)),
+                  0);
+    AKSceneArchiveReleaseSkinInPlace(skin);
+    AKSceneArchiveReleaseGeometryInPlace(NULL);
+    AKSceneArchiveReleaseSkinInPlace(NULL);
+
+    AKSceneArchiveRelease(archive);
+    remove(path.c_str());
+    releaseParts(&parts);
+}
+
+#pragma mark - Invalid archives
+
+/**
+ Tests an archive is rejected when it is of another key, of another version,
+ truncated, refers to bytes outside the file, has a vertex attribute of an
+ unknown format, of a wrong component size or past the end of a vertex,
+ indices of an unknown width or out of the vertices of their geometry, a skin
+ of another number of vertices than its geometry, a bone index out of the
+ bones, or a string which is not valid UTF-8.
+ */
+AK_TEST(testRejectsInvalidArchives)
+{
+    AKTestParts parts = makeParts();
+    std::string path = writeArchive(&parts);
+    std::vector<unsigned char> bytes = readFile(path);
+
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey + 1) == NULL);
+    AKAssertTrue(AKSceneArchiveOpen("/tmp/AKSceneArchiveTestsMissing",
+                                    AKTestKey) == NULL);
+
+    std::vector<unsigned char> version(bytes);
+    ((AKArchiveHeader *)&version[0])->version = AK_SCENE_ARCHIVE_VERSION + 1;
+    writeFile(path, version);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> truncated(bytes.begin(), bytes.end() - 8);
+    writeFile(path, truncated);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> table(bytes);
+    ((AKArchiveHeader *)&table[0])->nodes = bytes.size() - 8;
+    writeFile(path, table);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> geometry(bytes);
+    const AKArchiveHeader *header = (const AKArchiveHeader *)&bytes[0];
+    AKArchiveGeometry *record =
+        (AKArchiveGeometry *)&geometry[header->geometries];
+    record->nVertices = 1u << 30;
+    writeFile(path, geometry);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> format(bytes);
+    record = (AKArchiveGeometry *)&format[header->geometries];
+    record->attributes[AKVertexAttributePosition].format = 99;
+    writeFile(path, format);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> componentSize(bytes);
+    record = (AKArchiveGeometry *)&componentSize[header->geometries];
+    record->attributes[AKVertexAttributePosition].bytesPerComponent = 3;
+    writeFile(path, componentSize);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> attributeEnd(bytes);
+    record = (AKArchiveGeometry *)&attributeEnd[header->geometries];
+    record->attributes[AKVertexAttributePosition].offset =
+        record->vertexStride - 4;
+    writeFile(path, attributeEnd);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> indexWidth(bytes);
+    AKArchiveElement *element =
+        (AKArchiveElement *)&indexWidth[header->elements];
+    element->bytesPerIndex = 3;
+    writeFile(path, indexWidth);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> indexRange(bytes);
+    record = (AKArchiveGeometry *)&indexRange[header->geometries];
+    element = (AKArchiveElement *)&indexRange[header->elements] +
+              record->firstElement;
+    // the largest index of the width is past the vertices of the geometry
+    memset(&indexRange[element->indices], 0xff, element->bytesPerIndex);
+    writeFile(path, indexRange);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> skinVertices(bytes);
+    record = (AKArchiveGeometry *)&skinVertices[header->geometries];
+    AKArchiveSkin *skin =
+        (AKArchiveSkin *)&skinVertices[header->skins] + record->skin;
+    skin->nVertices--;
+    writeFile(path, skinVertices);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    short badBones[2] = {(short)header->nBones, -1};
+    for (int i = 0; i < 2; i++)
+    {
+        std::vector<unsigned char> boneIndex(bytes);
+        skin = (AKArchiveSkin *)&boneIndex[header->skins];
+        memcpy(&boneIndex[skin->boneIndices], &badBones[i], sizeof(short));
+        writeFile(path, boneIndex);
+        AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+    }
+
+    // the name of the first node starts the string pool, after the empty
+    // string
+    std::vector<unsigned char> leadByte(bytes);
+    leadByte[header->strings + 1] = 0xff;
+    writeFile(path, leadByte);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> sequence(bytes);
+    sequence[header->strings + 1] = 0xe2;
+    sequence[header->strings + 2] = 0x82;
+    writeFile(path, sequence);
+    AKAssertTrue(AKSceneArchiveOpen(path.c_str(), AKTestKey) == NULL);
+
+    std::vector<unsigned char> accented(bytes);
+    accented[header->strings + 1] = 0xc3;
+    accented[header->strings + 2] = 0xa9;
+    writeFile(path, accented);
+    AKSceneArchive *archive = AKSceneArchiveOpen(path.c_str(), AKTestKey);
+    AKAssertTrue(archive != NULL);
+    AKAssertTrue(strcmp(AKSceneArchiveString(archive, 1), "\xc3\xa9" "dy") ==
+                 0);
+    AKSceneArchiveRelease(archive);
+
+    writeFile(path, bytes);
+    archive = AKSceneArchiveOpen(path.c_str(), AKTestKey);
+    AKAssertTrue(archive != NULL);
+    AKSceneArchiveRelease(archive);
+    remove(path.c_str());
+    releaseParts(&parts);
+}
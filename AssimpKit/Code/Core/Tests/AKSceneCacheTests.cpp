@@ -0,0 +1,329 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSceneCache.h"
+#include "AKTest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+#pragma mark - Cache directories
+
+/**
+ Makes an empty temporary directory.
+
+ @return The path of the directory, which the caller removes with
+ removeDirectory.
+ */
+static std::string makeDirectory()
+{
+    char path[] = "/tmp/AKSceneCacheTestsXXXXXX";
+    return mkdtemp(path);
+}
+
+/**
+ Removes the archives of a cache and its directory.
+
+ @param cache The cache, which is released.
+ @param directory The directory of the cache.
+ */
+static void removeDirectory(AKSceneCache *cache, const std::string &directory)
+{
+    AKSceneCacheRemoveAll(cache);
+    AKSceneCacheRelease(cache);
+    rmdir(directory.c_str());
+}
+
+/**
+ Makes the archive writer of a scene with one node.
+
+ @param key The key of the scene.
+ @param name The name of the node, so that the archives of the tests differ.
+ @return A new writer.
+ */
+static AKSceneArchiveWriter *makeWriter(unsigned long long key,
+                                        const char *name)
+{
+    float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    AKSceneArchiveWriter *writer = AKSceneArchiveWriterCreate(key);
+    AKSceneArchiveWriterAddNode(writer, name, AKArchiveNone, identity, NULL,
+                                0);
+    return writer;
+}
+
+/**
+ Stores the archive of a scene with one node.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @return Non zero if the archive was stored.
+ */
+static int store(AKSceneCache *cache, unsigned long long key)
+{
+    AKSceneArchiveWriter *writer = makeWriter(key, "root");
+    int stored = AKSceneCacheStore(cache, key, writer);
+    AKSceneArchiveWriterRelease(writer);
+    return stored;
+}
+
+/**
+ Determines if the cache has a valid archive of a scene.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @return true if the archive was opened.
+ */
+static bool contains(AKSceneCache *cache, unsigned long long key)
+{
+    AKSceneArchive *archive = AKSceneCacheOpen(cache, key);
+    AKSceneArchiveRelease(archive);
+    return archive != NULL;
+}
+
+/**
+ Returns the size of the archive of a scene with one node.
+
+ @return The size in bytes.
+ */
+static size_t archiveBytes()
+{
+    AKSceneArchiveWriter *writer = makeWriter(1, "root");
+    std::string path = makeDirectory() + "/size.akscene";
+    size_t size = AKSceneArchiveWriterWriteFile(writer, path.c_str());
+    AKSceneArchiveWriterRelease(writer);
+    remove(path.c_str());
+    rmdir(path.substr(0, path.rfind('/')).c_str());
+    return size;
+}
+
+#pragma mark - Scene keys
+
+/**
+ Tests the key of a scene changes with each byte and each import option
+ added to it.
+ */
+AK_TEST(testKeys)
+{
+    unsigned long long key = AKSceneCacheKeyMake();
+    AKAssertEqual(key, AKSceneCacheKeyMake());
+    AKAssertTrue(AKSceneCacheKeyAdd(key, "a", 1) !=
+                 AKSceneCacheKeyAdd(key, "b", 1));
+    AKAssertEqual(AKSceneCacheKeyAdd(key, NULL, 0), key);
+
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    unsigned long long optionsKey = AKSceneCacheKeyAddOptions(key, &options);
+    AKAssertEqual(optionsKey, AKSceneCacheKeyAddOptions(key, &options));
+    options.maxSmoothingAngle = 80.0f;
+    AKAssertTrue(AKSceneCacheKeyAddOptions(key, &options) != optionsKey);
+    options = AKImportOptionsMakeDefault();
+    options.components &= ~AKImportComponentTextures;
+    AKAssertTrue(AKSceneCacheKeyAddOptions(key, &options) != optionsKey);
+
+    char path[] = "/tmp/AKSceneCacheTestsXXXXXX";
+    int fd = mkstemp(path);
+    ssize_t written = write(fd, "scene", 5);
+    (void)written;
+    close(fd);
+    unsigned long long fileKey = key;
+    AKAssertTrue(AKSceneCacheKeyAddFile(&fileKey, path));
+    AKAssertEqual(fileKey, AKSceneCacheKeyAdd(key, "scene", 5));
+    remove(path);
+    unsigned long long missingKey = key;
+    AKAssertFalse(AKSceneCacheKeyAddFile(&missingKey, path));
+    AKAssertEqual(missingKey, key);
+}
+
+#pragma mark - Loading and storing scenes
+
+/**
+ Tests a stored scene is found by its key only, and the lookups are counted.
+ */
+AK_TEST(testStoreAndOpen)
+{
+    std::string directory = makeDirectory() + "/nested/cache";
+    AKSceneCache *cache = AKSceneCacheCreate(directory.c_str(), 0);
+    AKAssertTrue(cache != NULL);
+    AKAssertFalse(contains(cache, 7));
+    AKAssertTrue(store(cache, 7));
+    AKAssertTrue(contains(cache, 7));
+    AKAssertFalse(contains(cache, 8));
+    AKAssertEqual(AKSceneCacheBytes(cache), archiveBytes());
+
+    AKSceneCacheStats stats = AKSceneCacheGetStats(cache);
+    AKAssertEqual(stats.hits, 1ul);
+    AKAssertEqual(stats.misses, 2ul);
+    AKAssertEqual(stats.stores, 1ul);
+
+    AKSceneCacheRemove(cache, 7);
+    AKAssertFalse(contains(cache, 7));
+    removeDirectory(cache, directory);
+    rmdir(directory.substr(0, directory.rfind('/')).c_str());
+    rmdir(directory.substr(0, directory.find("/nested")).c_str());
+}
+
+/**
+ Tests the archive used least recently is removed when the cache is over its
+ cap, and an archive over the cap is not stored.
+ */
+AK_TEST(testEviction)
+{
+    std::string directory = makeDirectory();
+    size_t size = archiveBytes();
+    AKSceneCache *cache = AKSceneCacheCreate(directory.c_str(), 2 * size);
+    AKAssertTrue(store(cache, 1));
+    usleep(20000);
+    AKAssertTrue(store(cache, 2));
+    usleep(20000);
+    AKAssertTrue(contains(cache, 1));
+    usleep(20000);
+    AKAssertTrue(store(cache, 3));
+
+    AKAssertTrue(contains(cache, 1));
+    AKAssertFalse(contains(cache, 2));
+    AKAssertTrue(contains(cache, 3));
+    AKAssertEqual(AKSceneCacheGetStats(cache).evictions, 1ul);
+    AKAssertEqual(AKSceneCacheBytes(cache), 2 * size);
+    removeDirectory(cache, directory);
+
+    cache = AKSceneCacheCreate(directory.c_str(), size - 1);
+    AKAssertFalse(store(cache, 1));
+    AKAssertEqual(AKSceneCacheBytes(cache), 0u);
+    removeDirectory(cache, directory);
+}
+
+/**
+ Tests a damaged archive is removed when it is opened, and an archive of
+ another format version when the cache is created.
+ */
+AK_TEST(testInvalidation)
+{
+    std::string directory = makeDirectory();
+    AKSceneCache *cache = AKSceneCacheCreate(directory.c_str(), 0);
+    AKAssertTrue(store(cache, 0x10));
+    AKAssertTrue(store(cache, 0x20));
+
+    std::string damaged = directory + "/0000000000000010.akscene";
+    FILE *file = fopen(damaged.c_str(), "r+b");
+    fseek(file, 0, SEEK_END);
+    fputc(0, file);
+    fclose(file);
+    AKAssertFalse(contains(cache, 0x10));
+    AKAssertEqual(AKSceneCacheGetStats(cache).invalidations, 1ul);
+    AKAssertTrue(access(damaged.c_str(), F_OK) != 0);
+    AKSceneCacheRelease(cache);
+
+    std::string old = directory + "/0000000000000020.akscene";
+    file = fopen(old.c_str(), "r+b");
+    AKArchiveHeader header;
+    size_t nRead = fread(&header, 1, sizeof(header), file);
+    AKAssertEqual(nRead, sizeof(header));
+    header.version = AK_SCENE_ARCHIVE_VERSION - 1;
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, 1, sizeof(header), file);
+    fclose(file);
+    cache = AKSceneCacheCreate(directory.c_str(), 0);
+    AKAssertEqual(AKSceneCacheGetStats(cache).invalidations, 1ul);
+    AKAssertTrue(access(old.c_str(), F_OK) != 0);
+    AKAssertEqual(AKSceneCacheBytes(cache), 0u);
+    removeDirectory(cache, directory);
+}
+
+/**
+ Writes a file.
+
+ @param path The path of the file.
+ @param contents The contents of the file.
+ */
+static void writeFile(const std::string &path, const char *contents)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    fputs(contents, file);
+    fclose(file);
+}
+
+/**
+ Stores the archive of a scene read from a material library, which depends
+ on the library and on a texture which was not found.
+
+ @param cache The cache.
+ @param key The key of the scene.
+ @param library The path of the material library.
+ @param texture The path of the missing texture.
+ @return Non zero if the archive was stored.
+ */
+static int storeWithSideFiles(AKSceneCache *cache,
+                              unsigned long long key,
+                              const std::string &library,
+                              const std::string &texture)
+{
+    AKSceneArchiveWriter *writer = makeWriter(key, "root");
+    AKSceneArchiveWriterAddDependency(writer, library.c_str());
+    AKSceneArchiveWriterAddDependency(writer, texture.c_str());
+    int stored = AKSceneCacheStore(cache, key, writer);
+    AKSceneArchiveWriterRelease(writer);
+    return stored;
+}
+
+/**
+ Tests an archive is removed when a side file of its scene changes or a file
+ which was missing appears, although the key of the scene is the same.
+ */
+AK_TEST(testStaleSideFiles)
+{
+    std::string directory = makeDirectory();
+    std::string library = directory + "/scene.mtl";
+    std::string texture = directory + "/wood.png";
+    writeFile(library, "newmtl wood\n");
+    AKSceneCache *cache = AKSceneCacheCreate(directory.c_str(), 0);
+    AKAssertTrue(storeWithSideFiles(cache, 0x30, library, texture));
+    AKAssertTrue(contains(cache, 0x30));
+
+    // the same size with other bytes
+    writeFile(library, "newmtl iron\n");
+    AKAssertFalse(contains(cache, 0x30));
+    AKAssertEqual(AKSceneCacheGetStats(cache).invalidations, 1ul);
+
+    AKAssertTrue(storeWithSideFiles(cache, 0x30, library, texture));
+    AKAssertTrue(contains(cache, 0x30));
+    writeFile(texture, "not really a png");
+    AKAssertFalse(contains(cache, 0x30));
+    AKAssertEqual(AKSceneCacheGetStats(cache).invalidations, 2ul);
+
+    remove(library.c_str());
+    remove(texture.c_str());
+    removeDirectory(cache, directory);
+}
@@ -0,0 +1,159 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSceneGeometry.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <vector>
+
+#pragma mark - Scenes
+
+/**
+ Creates a scene of many small mesh nodes under groups, like an architectural
+ scene: a root with nGroups groups of nNodes nodes, each with its own mesh of
+ a different size.
+
+ @param nGroups The number of groups.
+ @param nNodes The number of mesh nodes of each group.
+ @return A new scene.
+ */
+static aiScene *makeArchitecture(unsigned int nGroups, unsigned int nNodes)
+{
+    aiNode *root = AKTestMakeNode("root");
+    std::vector<aiMesh *> meshes;
+    for (unsigned int g = 0; g < nGroups; g++)
+    {
+        aiNode *group = AKTestMakeNode("group");
+        for (unsigned int n = 0; n < nNodes; n++)
+        {
+            unsigned int nVertices = 30 + (g * nNodes + n) * 17 % 900;
+            meshes.push_back(AKTestMakeMesh(nVertices, nVertices - 2,
+                                            AKTestMeshAllStreams,
+                                            (float)meshes.size()));
+            AKTestAddChild(
+                group, AKTestMakeNode("part", std::vector<unsigned int>(
+                                                  1, meshes.size() - 1)));
+        }
+        AKTestAddChild(root, group);
+    }
+    return AKTestMakeScene(root, meshes);
+}
+
+#pragma mark - Tests
+
+/**
+ Tests the parallel conversion of a scene on 1 to 8 workers is the same as
+ the serial conversion, and that each slot holds the geometry of its node.
+ */
+AK_TEST(testParallelMatchesSerial)
+{
+    aiScene *scene = makeArchitecture(8, 40);
+    AKSceneStats *stats = AKSceneStatsCreate(scene);
+    AKSceneGeometry *serial =
+        AKSceneGeometryCreate(scene, NULL, stats, NULL, NULL);
+    AKAssertEqual(AKSceneGeometryNodeCount(serial), 1u + 8u + 8u * 40u);
+    unsigned long long serialHash = AKSceneGeometryHash(serial);
+    const unsigned int workerCounts[] = {1, 2, 4, 8};
+    for (int w = 0; w < 4; w++)
+    {
+        AKWorkPool *pool = AKWorkPoolCreate(workerCounts[w], 0);
+        AKSceneGeometry *parallel =
+            AKSceneGeometryCreate(scene, NULL, stats, NULL, pool);
+        AKAssertEqual(AKSceneGeometryHash(parallel), serialHash);
+        AKSceneGeometryRelease(parallel);
+        AKWorkPoolRelease(pool);
+    }
+    for (unsigned int i = 0; i < AKSceneGeometryNodeCount(serial); i++)
+    {
+        const aiNode *aiNode = AKSceneGeometryNodeAt(serial, i);
+        const AKNodeGeometry *geometry = AKSceneGeometryAt(serial, i);
+        AKAssertEqual(geometry == NULL, aiNode->mNumMeshes == 0);
+        if (geometry != NULL)
+        {
+            AKAssertEqual(geometry->nVertices,
+                          scene->mMeshes[aiNode->mMeshes[0]]->mNumVertices);
+        }
+    }
+    AKSceneGeometryRelease(serial);
+    AKSceneStatsRelease(stats);
+    delete scene;
+}
+
+/**
+ Tests the geometry of a node is taken once, and nodes of another scene have
+ no geometry.
+ */
+AK_TEST(testTake)
+{
+    aiScene *scene = makeArchitecture(2, 3);
+    aiScene *other = makeArchitecture(1, 1);
+    AKSceneGeometry *sceneGeometry =
+        AKSceneGeometryCreate(scene, NULL, NULL, NULL, NULL);
+    const aiNode *part = scene->mRootNode->mChildren[1]->mChildren[2];
+    AKNodeGeometry *geometry = AKSceneGeometryTake(sceneGeometry, part);
+    AKAssertTrue(geometry != NULL);
+    AKAssertTrue(AKSceneGeometryTake(sceneGeometry, part) == NULL);
+    AKAssertTrue(AKSceneGeometryTake(sceneGeometry, scene->mRootNode) == NULL);
+    AKAssertTrue(
+        AKSceneGeometryTake(sceneGeometry,
+                            other->mRootNode->mChildren[0]->mChildren[0]) ==
+        NULL);
+    AKNodeGeometryRelease(geometry);
+    AKSceneGeometryRelease(sceneGeometry);
+    delete other;
+    delete scene;
+}
+
+/**
+ Tests a cancelled conversion converts no node and leaves every slot empty.
+ */
+AK_TEST(testCancelled)
+{
+    aiScene *scene = makeArchitecture(4, 10);
+    AKProgress *progress = AKProgressCreate(NULL, NULL);
+    AKProgressCancel(progress);
+    AKWorkPool *pool = AKWorkPoolCreate(4, 0);
+    AKSceneGeometry *sceneGeometry =
+        AKSceneGeometryCreate(scene, NULL, NULL, progress, pool);
+    for (unsigned int i = 0; i < AKSceneGeometryNodeCount(sceneGeometry); i++)
+    {
+        AKAssertTrue(AKSceneGeometryAt(sceneGeometry, i) == NULL);
+    }
+    AKAssertTrue(AKProgressCancellationLatency(progress) >= 0.0);
+    AKSceneGeometryRelease(sceneGeometry);
+    AKWorkPoolRelease(pool);
+    AKProgressRelease(progress);
+    delete scene;
+}
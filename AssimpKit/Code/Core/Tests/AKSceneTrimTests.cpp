@@ -0,0 +1,372 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKGeometry.h"
+#include "AKMemory.h"
+#include "AKSceneGeometry.h"
+#include "AKSceneTrim.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <algorithm>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ Non zero if the tests measure the resident set size of the process, which
+ the shadow memory and the quarantine of the address sanitizer distort.
+ */
+#if defined(__SANITIZE_ADDRESS__)
+#define AK_TEST_MEASURES_RSS 0
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define AK_TEST_MEASURES_RSS 0
+#endif
+#endif
+#ifndef AK_TEST_MEASURES_RSS
+#define AK_TEST_MEASURES_RSS 1
+#endif
+
+#pragma mark - Peak footprint
+
+/**
+ The number of nodes of the scene of the peak footprint test.
+ */
+static const unsigned int AKTestNumNodes = 12;
+
+/**
+ The number of vertices of each mesh of the scene of the peak footprint test.
+ */
+static const unsigned int AKTestNumVertices = 60000;
+
+/**
+ Makes a scene with one mesh for each node, large enough for its buffers to
+ dominate the footprint of the process.
+
+ @return A new scene.
+ */
+static aiScene *makeLargeScene()
+{
+    aiNode *root = AKTestMakeNode("root");
+    std::vector<aiMesh *> meshes;
+    for (unsigned int i = 0; i < AKTestNumNodes; i++)
+    {
+        meshes.push_back(AKTestMakeMesh(
+            AKTestNumVertices, AKTestNumVertices / 3,
+            AKTestMeshNormals | AKTestMeshTangents | AKTestMeshTexCoords,
+            (float)i));
+        AKTestAddChild(root, AKTestMakeNode("node",
+                                            std::vector<unsigned int>(1, i)));
+    }
+    return AKTestMakeScene(root, meshes);
+}
+
+/**
+ Converts the geometry of every node of a large scene and keeps it until the
+ scene is released, like the scene made by the importer keeps it, charging
+ the converted geometry to a memory account.
+
+ The footprint of each step is the size of the assimp scene before the step
+ plus the peak of the bytes of the account after it, which bounds the memory
+ of the scene and of the converted geometry at any time of the step.
+
+ @param trims YES to trim the scene while the nodes are converted one at a
+ time, NO to convert the nodes together before the scene is released.
+ @return The peak footprint of the conversion in bytes.
+ */
+static size_t accountLargeScene(bool trims)
+{
+    AKMemoryAccount *account = AKMemoryAccountCreate();
+    AKMemoryAccount *previous = AKMemoryAccountMakeCurrent(account);
+    aiScene *scene = makeLargeScene();
+    std::vector<AKNodeGeometry *> geometries;
+    size_t peak = 0;
+    if (trims)
+    {
+        AKSceneTrim *trim = AKSceneTrimCreate(scene);
+        for (unsigned int i = 0; i < scene->mRootNode->mNumChildren; i++)
+        {
+            const aiNode *node = scene->mRootNode->mChildren[i];
+            size_t sceneBytes = AKMemorySceneBytes(scene);
+            geometries.push_back(AKNodeGeometryCreate(node, scene, NULL));
+            peak = std::max(peak, sceneBytes +
+                                      AKMemoryAccountGetStats(account)
+                                          .peakBytes);
+            AKSceneTrimNode(trim, node);
+        }
+        AKSceneTrimRelease(trim);
+    }
+    else
+    {
+        size_t sceneBytes = AKMemorySceneBytes(scene);
+        AKSceneGeometry *sceneGeometry =
+            AKSceneGeometryCreate(scene, NULL, NULL, NULL, NULL);
+        for (unsigned int i = 0; i < scene->mRootNode->mNumChildren; i++)
+        {
+            geometries.push_back(AKSceneGeometryTake(
+                sceneGeometry, scene->mRootNode->mChildren[i]));
+        }
+        AKSceneGeometryRelease(sceneGeometry);
+        peak = sceneBytes + AKMemoryAccountGetStats(account).peakBytes;
+    }
+    delete scene;
+    for (size_t i = 0; i < geometries.size(); i++)
+    {
+        AKNodeGeometryRelease(geometries[i]);
+    }
+    AKMemoryAccountMakeCurrent(previous);
+    AKMemoryAccountRelease(account);
+    return peak;
+}
+
+#if AK_TEST_MEASURES_RSS
+/**
+ Converts the geometry of every node of a large scene and keeps it until the
+ scene is released, like the scene made by the importer keeps it, sampling
+ the footprint of the process.
+
+ @param trims YES to trim the scene while the nodes are converted one at a
+ time, NO to convert the nodes together before the scene is released.
+ @return The peak footprint of the conversion above the footprint before the
+ scene was made, in bytes.
+ */
+static size_t convertLargeScene(bool trims)
+{
+    size_t base = AKMemoryFootprint();
+    size_t peak = base;
+    aiScene *scene = makeLargeScene();
+    std::vector<AKNodeGeometry *> geometries;
+    if (trims)
+    {
+        AKSceneTrim *trim = AKSceneTrimCreate(scene);
+        for (unsigned int i = 0; i < scene->mRootNode->mNumChildren; i++)
+        {
+            const aiNode *node = scene->mRootNode->mChildren[i];
+            geometries.push_back(AKNodeGeometryCreate(node, scene, NULL));
+            AKSceneTrimNode(trim, node);
+            peak = std::max(peak, AKMemoryFootprint());
+        }
+        AKSceneTrimRelease(trim);
+    }
+    else
+    {
+        AKSceneGeometry *sceneGeometry =
+            AKSceneGeometryCreate(scene, NULL, NULL, NULL, NULL);
+        for (unsigned int i = 0; i < scene->mRootNode->mNumChildren; i++)
+        {
+            geometries.push_back(AKSceneGeometryTake(
+                sceneGeometry, scene->mRootNode->mChildren[i]));
+        }
+        AKSceneGeometryRelease(sceneGeometry);
+        peak = std::max(peak, AKMemoryFootprint());
+    }
+    delete scene;
+    for (size_t i = 0; i < geometries.size(); i++)
+    {
+        AKNodeGeometryRelease(geometries[i]);
+    }
+    return peak - base;
+}
+
+/**
+ Measures the peak footprint of the conversion of a large scene in a child
+ process, so that neither conversion reuses the memory freed by the other.
+
+ @param trims YES to trim the scene while it is converted.
+ @return The peak footprint of the conversion in bytes, or 0 if the child
+ process failed.
+ */
+static size_t measurePeakFootprint(bool trims)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return 0;
+    }
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        size_t peak = convertLargeScene(trims);
+        ssize_t written = write(fds[1], &peak, sizeof(peak));
+        _exit(written == sizeof(peak) ? 0 : 1);
+    }
+    close(fds[1]);
+    size_t peak = 0;
+    if (pid < 0 || read(fds[0], &peak, sizeof(peak)) != sizeof(peak))
+    {
+        peak = 0;
+    }
+    close(fds[0]);
+    if (pid > 0)
+    {
+        waitpid(pid, NULL, 0);
+    }
+    return peak;
+}
+#endif
+
+#pragma mark - Tests
+
+/**
+ Tests a mesh used by two nodes is freed once both nodes are converted, and
+ its bones keep their names and offset matrices.
+ */
+AK_TEST(testSharedMesh)
+{
+    aiMesh *shared = AKTestMakeMesh(100, 98, AKTestMeshAllStreams);
+    AKTestAddBone(shared, "bone", std::vector<std::pair<unsigned int, float> >(
+                                      1, std::make_pair(0u, 1.0f)));
+    shared->mBones[0]->mOffsetMatrix.a4 = 2.0f;
+    aiMesh *single = AKTestMakeMesh(10, 8, 0);
+    aiNode *root = AKTestMakeNode("root", std::vector<unsigned int>(1, 0));
+    aiNode *first = AKTestMakeNode("first", std::vector<unsigned int>(1, 0));
+    std::vector<unsigned int> both;
+    both.push_back(0);
+    both.push_back(1);
+    aiNode *second = AKTestMakeNode("second", both);
+    AKTestAddChild(root, first);
+    AKTestAddChild(root, second);
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(shared);
+    meshes.push_back(single);
+    aiScene *scene = AKTestMakeScene(root, meshes);
+
+    AKSceneTrim *trim = AKSceneTrimCreate(scene);
+    AKSceneTrimNode(trim, root);
+    AKSceneTrimNode(trim, first);
+    AKAssertEqual(shared->mNumVertices, 100u);
+    AKAssertTrue(shared->mVertices != NULL);
+    AKAssertEqual(AKSceneTrimFreedBytes(trim), (size_t)0);
+
+    AKSceneTrimNode(trim, second);
+    AKAssertEqual(shared->mNumVertices, 0u);
+    AKAssertEqual(shared->mNumFaces, 0u);
+    AKAssertTrue(shared->mVertices == NULL);
+    AKAssertTrue(shared->mNormals == NULL);
+    AKAssertTrue(shared->mTextureCoords[0] == NULL);
+    AKAssertTrue(shared->mColors[0] == NULL);
+    AKAssertTrue(shared->mFaces == NULL);
+    AKAssertEqual(single->mNumVertices, 0u);
+    AKAssertEqual(shared->mNumBones, 1u);
+    AKAssertEqual(shared->mBones[0]->mNumWeights, 0u);
+    AKAssertTrue(shared->mBones[0]->mName == aiString("bone"));
+    AKAssertEqualWithAccuracy(shared->mBones[0]->mOffsetMatrix.a4, 2.0f,
+                              0.0f);
+    size_t vertexBytes = 100 * (5 * sizeof(aiVector3D) + sizeof(aiColor4D)) +
+                         10 * sizeof(aiVector3D);
+    size_t faceBytes = 106 * (sizeof(aiFace) + 3 * sizeof(unsigned int));
+    AKAssertEqual(AKSceneTrimFreedBytes(trim),
+                  vertexBytes + faceBytes + sizeof(aiVertexWeight));
+
+    // a node converted again frees nothing more
+    AKSceneTrimNode(trim, second);
+    AKAssertEqual(AKSceneTrimFreedBytes(trim),
+                  vertexBytes + faceBytes + sizeof(aiVertexWeight));
+    AKSceneTrimRelease(trim);
+    delete scene;
+}
+
+/**
+ Tests the keys of an animation are freed and its channels keep their node
+ names.
+ */
+AK_TEST(testAnimation)
+{
+    aiScene *scene = AKTestMakeScene(AKTestMakeNode("root"),
+                                     std::vector<aiMesh *>());
+    std::vector<const char *> names;
+    names.push_back("a");
+    names.push_back("b");
+    AKTestAddAnimation(scene, AKTestMakeAnimation(names, 5, 4.0, 1.0));
+    AKTestAddAnimation(scene, AKTestMakeAnimation(names, 3, 2.0, 1.0));
+
+    AKSceneTrim *trim = AKSceneTrimCreate(scene);
+    AKSceneTrimAnimation(trim, 1);
+    AKSceneTrimAnimation(trim, 2);
+    const aiNodeAnim *kept = scene->mAnimations[0]->mChannels[0];
+    const aiNodeAnim *trimmed = scene->mAnimations[1]->mChannels[1];
+    AKAssertEqual(kept->mNumPositionKeys, 5u);
+    AKAssertTrue(kept->mPositionKeys != NULL);
+    AKAssertEqual(trimmed->mNumPositionKeys, 0u);
+    AKAssertEqual(trimmed->mNumRotationKeys, 0u);
+    AKAssertEqual(trimmed->mNumScalingKeys, 0u);
+    AKAssertTrue(trimmed->mRotationKeys == NULL);
+    AKAssertTrue(trimmed->mNodeName == aiString("b"));
+    AKAssertEqual(AKSceneTrimFreedBytes(trim),
+                  2 * 3 * (2 * sizeof(aiVectorKey) + sizeof(aiQuatKey)));
+    AKSceneTrimRelease(trim);
+    delete scene;
+}
+
+/**
+ Tests trimming a scene while its nodes are converted one at a time lowers
+ the peak footprint of the conversion, as charged to its memory account, from
+ the sum of the scene and the converted geometry to close to the larger of
+ them.
+ */
+AK_TEST(testPeakFootprint)
+{
+    size_t wholePeak = accountLargeScene(false);
+    size_t trimmedPeak = accountLargeScene(true);
+
+    aiScene *scene = makeLargeScene();
+    size_t sceneBytes = AKMemorySceneBytes(scene);
+    AKNodeGeometry *geometry =
+        AKNodeGeometryCreate(scene->mRootNode->mChildren[0], scene, NULL);
+    size_t outputBytes = AKTestNumNodes * (geometry->nVertices *
+                                           geometry->vertexStride);
+    AKNodeGeometryRelease(geometry);
+    delete scene;
+    AKAssertTrue(wholePeak >= sceneBytes + outputBytes);
+    AKAssertTrue(trimmedPeak < sceneBytes + outputBytes / 2);
+    AKAssertTrue(trimmedPeak * 4 < wholePeak * 3);
+}
+
+#if AK_TEST_MEASURES_RSS
+/**
+ Tests trimming a scene lowers the peak resident set size of the conversion
+ too. The margins are loose, as the allocator of the process may keep some of
+ the memory it is given back.
+ */
+AK_TEST(testPeakResidentSetSize)
+{
+    size_t wholePeak = measurePeakFootprint(false);
+    size_t trimmedPeak = measurePeakFootprint(true);
+    AKAssertTrue(wholePeak > 0);
+    AKAssertTrue(trimmedPeak > 0);
+    AKAssertTrue(trimmedPeak < wholePeak);
+}
+#endif
@@ -0,0 +1,203 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKSkin.h"
+#include "AKTest.h"
+#include "AKTestScene.h"
+#include <string.h>
+
+#pragma mark - Skin data
+
+/**
+ Makes a node with two skinned meshes, where vertex 1 of the first mesh is
+ influenced by both bones.
+
+ @return A new scene.
+ */
+static aiScene *makeSkinnedScene()
+{
+    std::vector<aiMesh *> meshes;
+    aiMesh *mesh0 = AKTestMakeMesh(3, 1, 0);
+    std::vector<std::pair<unsigned int, float> > hipWeights;
+    hipWeights.push_back(std::make_pair(0u, 1.0f));
+    hipWeights.push_back(std::make_pair(1u, 0.25f));
+    AKTestAddBone(mesh0, "hip", hipWeights);
+    std::vector<std::pair<unsigned int, float> > legWeights;
+    legWeights.push_back(std::make_pair(1u, 0.75f));
+    legWeights.push_back(std::make_pair(2u, 1.0f));
+    AKTestAddBone(mesh0, "leg", legWeights);
+    meshes.push_back(mesh0);
+
+    aiMesh *mesh1 = AKTestMakeMesh(2, 1, 0);
+    std::vector<std::pair<unsigned int, float> > armWeights;
+    armWeights.push_back(std::make_pair(0u, 1.0f));
+    AKTestAddBone(mesh1, "arm", armWeights);
+    meshes.push_back(mesh1);
+
+    unsigned int meshIndices[] = {0, 1};
+    return AKTestMakeScene(
+        AKTestMakeNode("body", std::vector<unsigned int>(meshIndices,
+                                                         meshIndices + 2)),
+        meshes);
+}
+
+/**
+ Tests the bone and weight counts of a skinned node.
+ */
+AK_TEST(testBoneAndWeightCounts)
+{
+    aiScene *scene = makeSkinnedScene();
+    AKAssertEqual(AKNumBonesInNode(scene->mRootNode, scene), 3u);
+    AKAssertEqual(AKMaxWeightsInNode(scene->mRootNode, scene), 2u);
+    delete scene;
+}
+
+/**
+ Tests the weights and bone indices are padded to the maximum weights and
+ refer to the bone palette order: hip, leg, arm.
+ */
+AK_TEST(testSkinBuffers)
+{
+    aiScene *scene = makeSkinnedScene();
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+    AKNodeSkin *skin = AKNodeSkinCreate(scene->mRootNode, scene, palette);
+    AKAssertTrue(skin != NULL);
+    AKAssertEqual(skin->nVertices, 5u);
+    AKAssertEqual(skin->maxWeights, 2u);
+
+    // vertex 0: hip
+    AKAssertEqualWithAccuracy(skin->boneWeights[0], 1.0, 1e-6);
+    AKAssertEqualWithAccuracy(skin->boneWeights[1], 0.0, 1e-6);
+    AKAssertEqual(skin->boneIndices[0], 0);
+    // vertex 1: hip then leg
+    AKAssertEqualWithAccuracy(skin->boneWeights[2], 0.25, 1e-6);
+    AKAssertEqualWithAccuracy(skin->boneWeights[3], 0.75, 1e-6);
+    AKAssertEqual(skin->boneIndices[2], 0);
+    AKAssertEqual(skin->boneIndices[3], 1);
+    // vertex 3 is the first vertex of the second mesh: arm
+    AKAssertEqual(skin->boneIndices[6], 2);
+    AKAssertEqualWithAccuracy(skin->boneWeights[6], 1.0, 1e-6);
+    // vertex 4 has no weights
+    AKAssertEqualWithAccuracy(skin->boneWeights[8], 0.0, 1e-6);
+    AKAssertEqualWithAccuracy(skin->boneWeights[9], 0.0, 1e-6);
+    AKNodeSkinRelease(skin);
+    AKBonePaletteRelease(palette);
+    delete scene;
+}
+
+/**
+ Tests the skin of a chunk has the influences of the mapped node vertices.
+ */
+AK_TEST(testChunkSkin)
+{
+    aiScene *scene = makeSkinnedScene();
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+    AKNodeSkin *skin = AKNodeSkinCreate(scene->mRootNode, scene, palette);
+    unsigned int vertexMap[] = {3, 1};
+    AKNodeSkin *chunkSkin = AKNodeSkinCreateForVertexMap(skin, vertexMap, 2);
+    AKAssertEqual(chunkSkin->nVertices, 2u);
+    AKAssertEqual(chunkSkin->maxWeights, 2u);
+    AKAssertEqual(chunkSkin->boneIndices[0], 2);
+    AKAssertEqualWithAccuracy(chunkSkin->boneWeights[2], 0.25, 1e-6);
+    AKAssertEqual(chunkSkin->boneIndices[3], 1);
+    AKNodeSkinRelease(chunkSkin);
+    AKNodeSkinRelease(skin);
+    AKBonePaletteRelease(palette);
+    delete scene;
+}
+
+/**
+ Tests a node without bones has no skin.
+ */
+AK_TEST(testUnskinnedNode)
+{
+    std::vector<aiMesh *> meshes;
+    meshes.push_back(AKTestMakeMesh(3, 1, 0));
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("root", std::vector<unsigned int>(1, 0)), meshes);
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+    AKAssertTrue(AKNodeSkinCreate(scene->mRootNode, scene, palette) == NULL);
+    AKBonePaletteRelease(palette);
+    delete scene;
+}
+
+#pragma mark - Damaged skin data
+
+/**
+ Tests the weights of a vertex which is not in its mesh are skipped, and that
+ a vertex never fills more slots than the maximum weights of the skin, even
+ when the statistics understate them.
+ */
+AK_TEST(testOutOfRangeWeights)
+{
+    std::vector<aiMesh *> meshes;
+    aiMesh *mesh = AKTestMakeMesh(2, 1, 0);
+    std::vector<std::pair<unsigned int, float> > hipWeights;
+    hipWeights.push_back(std::make_pair(0u, 0.5f));
+    hipWeights.push_back(std::make_pair(1000u, 1.0f));
+    AKTestAddBone(mesh, "hip", hipWeights);
+    std::vector<std::pair<unsigned int, float> > legWeights;
+    legWeights.push_back(std::make_pair(0u, 0.5f));
+    legWeights.push_back(std::make_pair(1u, 1.0f));
+    AKTestAddBone(mesh, "leg", legWeights);
+    meshes.push_back(mesh);
+    aiScene *scene = AKTestMakeScene(
+        AKTestMakeNode("body", std::vector<unsigned int>(1, 0)), meshes);
+    AKBonePalette *palette = AKBonePaletteCreate(scene);
+
+    // statistics which understate the two weights of vertex 0
+    AKMeshStats meshStats;
+    memset(&meshStats, 0, sizeof(meshStats));
+    meshStats.nVertices = 2;
+    meshStats.nBones = 2;
+    meshStats.maxWeights = 1;
+    AKSceneStats stats;
+    stats.nMeshes = 1;
+    stats.meshes = &meshStats;
+    AKNodeSkin *skin =
+        AKNodeSkinCreateWithStats(scene->mRootNode, scene, palette, &stats);
+    AKAssertTrue(skin != NULL);
+    AKAssertEqual(skin->nVertices, 2u);
+    AKAssertEqual(skin->maxWeights, 1u);
+    // vertex 0 keeps its first weight, of the hip
+    AKAssertEqualWithAccuracy(skin->boneWeights[0], 0.5, 1e-6);
+    AKAssertEqual(skin->boneIndices[0], 0);
+    // vertex 1 has the leg only, the hip weight of vertex 1000 is skipped
+    AKAssertEqualWithAccuracy(skin->boneWeights[1], 1.0, 1e-6);
+    AKAssertEqual(skin->boneIndices[1], 1);
+    AKNodeSkinRelease(skin);
+    AKBonePaletteRelease(palette);
+    delete scene;
+}
@@ -0,0 +1,114 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKTest.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#pragma mark - Test registry
+
+/**
+ A registered test function and its name.
+ */
+struct AKRegisteredTest
+{
+    const char *name;
+    AKTestFunction function;
+};
+
+/**
+ Returns the tests registered by the test file.
+
+ @return The registered tests, in registration order.
+ */
+static std::vector<AKRegisteredTest> &registeredTests()
+{
+    static std::vector<AKRegisteredTest> tests;
+    return tests;
+}
+
+/**
+ The number of failures recorded by the running test.
+ */
+static int currentFailures = 0;
+
+AKTestCase::AKTestCase(const char *name, AKTestFunction function)
+{
+    AKRegisteredTest test = {name, function};
+    registeredTests().push_back(test);
+}
+
+void AKTestRecordFailure(const char *file, int line, const char *expression)
+{
+    fprintf(stderr, "%s:%d: error: assertion failed: %s\n", file, line,
+            expression);
+    ++currentFailures;
+}
+
+#pragma mark - Run tests
+
+/**
+ Runs every registered test, or only the tests named on the command line.
+
+ @return 0 if every test passed, 1 otherwise.
+ */
+int main(int argc, char **argv)
+{
+    int nFailed = 0;
+    int nRun = 0;
+    for (const AKRegisteredTest &test : registeredTests())
+    {
+        bool selected = (argc < 2);
+        for (int i = 1; i < argc; i++)
+        {
+            selected = selected || (strcmp(argv[i], test.name) == 0);
+        }
+        if (!selected)
+        {
+            continue;
+        }
+        currentFailures = 0;
+        test.function();
+        ++nRun;
+        printf("%s %s\n", currentFailures == 0 ? "PASS" : "FAIL", test.name);
+        if (currentFailures > 0)
+        {
+            ++nFailed;
+        }
+    }
+    printf("%d of %d tests passed\n", nRun - nFailed, nRun);
+    return nFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKTest_h
+#define AKTest_h
+
+#include <math.h>
+
+/**
+ A minimal test harness for the headless AssimpKit core tests.
+
+ Each test file registers its test functions with AK_TEST and links against
+ AKTest.cpp, which provides main() and runs every registered test. The assert
+ macros mirror the XCTest asserts used by the SceneKit tests.
+ */
+
+typedef void (*AKTestFunction)(void);
+
+/**
+ Registers a test function when a test file is loaded.
+ */
+struct AKTestCase
+{
+    AKTestCase(const char *name, AKTestFunction function);
+};
+
+/**
+ Records an assertion failure for the currently running test.
+
+ @param file The source file of the assertion.
+ @param line The source line of the assertion.
+ @param expression The failed expression.
+ */
+void AKTestRecordFailure(const char *file, int line, const char *expression);
+
+#define AK_TEST(name)                                                          \
+    static void name();                                                        \
+    static AKTestCase name##Case(#name, name);                                 \
+    static void name()
+
+#define AKAssertTrue(expression)                                               \
+    do                                                                         \
+    {                                                                          \
+        if (!(expression))                                                     \
+        {                                                                      \
+            AKTestRecordFailure(__FILE__, __LINE__, #expression);              \
+        }                                                                      \
+    } while (0)
+
+#define AKAssertFalse(expression) AKAssertTrue(!(expression))
+
+#define AKAssertEqual(a, b) AKAssertTrue((a) == (b))
+
+#define AKAssertEqualWithAccuracy(a, b, accuracy)                              \
+    AKAssertTrue(fabs((double)(a) - (double)(b)) <= (accuracy))
+
+#endif /* AKTest_h */
@@ -0,0 +1,253 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKTestScene.h"
+#include <string.h>
+
+#pragma mark - Scene lifetime
+
+#ifndef AK_HAVE_ASSIMP_LIBRARY
+/*
+ The core does not link against assimp, and the aiScene constructor and
+ destructor are only defined in the assimp library. When the tests are built
+ without it, provide the equivalent definitions for the in-memory scenes.
+ */
+aiScene::aiScene()
+    : mFlags(0), mRootNode(NULL), mNumMeshes(0), mMeshes(NULL),
+      mNumMaterials(0), mMaterials(NULL), mNumAnimations(0),
+      mAnimations(NULL), mNumTextures(0), mTextures(NULL), mNumLights(0),
+      mLights(NULL), mNumCameras(0), mCameras(NULL), mPrivate(NULL)
+{
+}
+
+aiScene::~aiScene()
+{
+    delete mRootNode;
+    for (unsigned int i = 0; i < mNumMeshes; i++)
+    {
+        delete mMeshes[i];
+    }
+    delete[] mMeshes;
+    for (unsigned int i = 0; i < mNumAnimations; i++)
+    {
+        delete mAnimations[i];
+    }
+    delete[] mAnimations;
+}
+#endif
+
+#pragma mark - Meshes
+
+aiMesh *AKTestMakeMesh(unsigned int nVertices,
+                       unsigned int nTriangles,
+                       unsigned int streams,
+                       float seed)
+{
+    aiMesh *mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mNumVertices = nVertices;
+    mesh->mVertices = new aiVector3D[nVertices];
+    if (streams & AKTestMeshNormals)
+    {
+        mesh->mNormals = new aiVector3D[nVertices];
+    }
+    if (streams & AKTestMeshTangents)
+    {
+        mesh->mTangents = new aiVector3D[nVertices];
+        mesh->mBitangents = new aiVector3D[nVertices];
+    }
+    if (streams & AKTestMeshTexCoords)
+    {
+        mesh->mTextureCoords[0] = new aiVector3D[nVertices];
+        mesh->mNumUVComponents[0] = 2;
+    }
+    if (streams & AKTestMeshColors)
+    {
+        mesh->mColors[0] = new aiColor4D[nVertices];
+    }
+    for (unsigned int j = 0; j < nVertices; j++)
+    {
+        float v = (float)j + seed;
+        mesh->mVertices[j] = aiVector3D(v, v + 0.25f, v + 0.5f);
+        if (mesh->mNormals)
+        {
+            mesh->mNormals[j] = aiVector3D(0.0f, 0.0f, 1.0f);
+        }
+        if (mesh->mTangents)
+        {
+            mesh->mTangents[j] = aiVector3D(1.0f, 0.0f, 0.0f);
+            mesh->mBitangents[j] = aiVector3D(0.0f, 1.0f, 0.0f);
+        }
+        if (mesh->mTextureCoords[0])
+        {
+            float u = (float)j / (float)nVertices;
+            mesh->mTextureCoords[0][j] = aiVector3D(u, 1.0f - u, 0.0f);
+        }
+        if (mesh->mColors[0])
+        {
+            mesh->mColors[0][j] = aiColor4D(0.1f, 0.2f, 0.3f, 0.4f);
+        }
+    }
+    mesh->mNumFaces = nTriangles;
+    mesh->mFaces = new aiFace[nTriangles];
+    for (unsigned int t = 0; t < nTriangles; t++)
+    {
+        aiFace &face = mesh->mFaces[t];
+        face.mNumIndices = 3;
+        face.mIndices = new unsigned int[3];
+        for (unsigned int k = 0; k < 3; k++)
+        {
+            face.mIndices[k] = (t + k) % nVertices;
+        }
+    }
+    return mesh;
+}
+
+void AKTestAddBone(aiMesh *aiMesh,
+                   const char *name,
+                   const std::vector<std::pair<unsigned int, float> > &weights)
+{
+    aiBone *bone = new aiBone();
+    bone->mName.Set(name);
+    bone->mNumWeights = (unsigned int)weights.size();
+    bone->mWeights = new aiVertexWeight[weights.size()];
+    for (size_t i = 0; i < weights.size(); i++)
+    {
+        bone->mWeights[i] = aiVertexWeight(weights[i].first, weights[i].second);
+    }
+    aiBone **bones = new aiBone *[aiMesh->mNumBones + 1];
+    for (unsigned int i = 0; i < aiMesh->mNumBones; i++)
+    {
+        bones[i] = aiMesh->mBones[i];
+    }
+    bones[aiMesh->mNumBones] = bone;
+    delete[] aiMesh->mBones;
+    aiMesh->mBones = bones;
+    aiMesh->mNumBones++;
+}
+
+#pragma mark - Nodes and scenes
+
+aiNode *AKTestMakeNode(const char *name,
+                       const std::vector<unsigned int> &meshIndices)
+{
+    aiNode *node = new aiNode(name);
+    node->mNumMeshes = (unsigned int)meshIndices.size();
+    if (!meshIndices.empty())
+    {
+        node->mMeshes = new unsigned int[meshIndices.size()];
+        memcpy(node->mMeshes, meshIndices.data(),
+               meshIndices.size() * sizeof(unsigned int));
+    }
+    return node;
+}
+
+void AKTestAddChild(aiNode *parent, aiNode *child)
+{
+    aiNode **children = new aiNode *[parent->mNumChildren + 1];
+    for (unsigned int i = 0; i < parent->mNumChildren; i++)
+    {
+        children[i] = parent->mChildren[i];
+    }
+    children[parent->mNumChildren] = child;
+    delete[] parent->mChildren;
+    parent->mChildren = children;
+    parent->mNumChildren++;
+    child->mParent = parent;
+}
+
+aiScene *AKTestMakeScene(aiNode *rootNode, const std::vector<aiMesh *> &meshes)
+{
+    aiScene *scene = new aiScene();
+    scene->mRootNode = rootNode;
+    scene->mNumMeshes = (unsigned int)meshes.size();
+    scene->mMeshes = new aiMesh *[meshes.size()];
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        scene->mMeshes[i] = meshes[i];
+    }
+    return scene;
+}
+
+#pragma mark - Animations
+
+aiAnimation *AKTestMakeAnimation(const std::vector<const char *> &nodeNames,
+                                 unsigned int nKeys,
+                                 double duration,
+                                 double ticksPerSecond)
+{
+    aiAnimation *animation = new aiAnimation();
+    animation->mDuration = duration;
+    animation->mTicksPerSecond = ticksPerSecond;
+    animation->mNumChannels = (unsigned int)nodeNames.size();
+    animation->mChannels = new aiNodeAnim *[nodeNames.size()];
+    for (size_t i = 0; i < nodeNames.size(); i++)
+    {
+        aiNodeAnim *channel = new aiNodeAnim();
+        channel->mNodeName.Set(nodeNames[i]);
+        channel->mNumPositionKeys = nKeys;
+        channel->mNumRotationKeys = nKeys;
+        channel->mNumScalingKeys = nKeys;
+        channel->mPositionKeys = new aiVectorKey[nKeys];
+        channel->mRotationKeys = new aiQuatKey[nKeys];
+        channel->mScalingKeys = new aiVectorKey[nKeys];
+        for (unsigned int k = 0; k < nKeys; k++)
+        {
+            float v = (float)k;
+            channel->mPositionKeys[k] =
+                aiVectorKey(k, aiVector3D(v, v + 1.0f, v + 2.0f));
+            channel->mRotationKeys[k] =
+                aiQuatKey(k, aiQuaternion(1.0f, 0.0f, 0.0f, v));
+            channel->mScalingKeys[k] =
+                aiVectorKey(k, aiVector3D(1.0f, 1.0f, v));
+        }
+        animation->mChannels[i] = channel;
+    }
+    return animation;
+}
+
+void AKTestAddAnimation(aiScene *aiScene, aiAnimation *aiAnimation)
+{
+    struct aiAnimation **animations =
+        new struct aiAnimation *[aiScene->mNumAnimations + 1];
+    for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+    {
+        animations[i] = aiScene->mAnimations[i];
+    }
+    animations[aiScene->mNumAnimations] = aiAnimation;
+    delete[] aiScene->mAnimations;
+    aiScene->mAnimations = animations;
+    aiScene->mNumAnimations++;
+}
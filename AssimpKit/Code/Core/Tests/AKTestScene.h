@@ -0,0 +1,146 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#ifndef AKTestScene_h
+#define AKTestScene_h
+
+#include <utility>
+#include <vector>
+#include "assimp/scene.h" // Output data structure
+
+/**
+ Builders for small in-memory assimp scenes used by the headless core tests.
+
+ The scenes are owned by the caller and released with delete, just like the
+ scenes created by the assimp importers.
+ */
+
+#pragma mark - Meshes
+
+/**
+ The optional vertex streams of a test mesh.
+ */
+enum AKTestMeshStreams
+{
+    AKTestMeshNormals = 1 << 0,
+    AKTestMeshTangents = 1 << 1,
+    AKTestMeshTexCoords = 1 << 2,
+    AKTestMeshColors = 1 << 3,
+    AKTestMeshAllStreams = 0xf
+};
+
+/**
+ Creates a triangle mesh whose vertex j has the position (j, j + 0.25, j + 0.5)
+ offset by the seed, and whose triangle t has the indices t, t + 1 and t + 2
+ wrapped to the number of vertices.
+
+ @param nVertices The number of vertices.
+ @param nTriangles The number of triangles.
+ @param streams The optional streams to generate, see AKTestMeshStreams.
+ @param seed The offset added to each position component.
+ @return A new mesh.
+ */
+aiMesh *AKTestMakeMesh(unsigned int nVertices,
+                       unsigned int nTriangles,
+                       unsigned int streams,
+                       float seed = 0.0f);
+
+/**
+ Adds a bone with the specified vertex weights to the mesh.
+
+ @param aiMesh The mesh.
+ @param name The bone name.
+ @param weights The pairs of vertex id and weight.
+ */
+void AKTestAddBone(aiMesh *aiMesh,
+                   const char *name,
+                   const std::vector<std::pair<unsigned int, float> > &weights);
+
+#pragma mark - Nodes and scenes
+
+/**
+ Creates a node which refers to the specified meshes.
+
+ @param name The node name.
+ @param meshIndices The indices of the meshes in the scene.
+ @return A new node.
+ */
+aiNode *AKTestMakeNode(const char *name,
+                       const std::vector<unsigned int> &meshIndices =
+                           std::vector<unsigned int>());
+
+/**
+ Appends a child node to the parent node.
+
+ @param parent The parent node.
+ @param child The child node, owned by the parent from now on.
+ */
+void AKTestAddChild(aiNode *parent, aiNode *child);
+
+/**
+ Creates a scene with the specified root node and meshes.
+
+ @param rootNode The root node, owned by the scene.
+ @param meshes The meshes, owned by the scene.
+ @return A new scene.
+ */
+aiScene *AKTestMakeScene(aiNode *rootNode, const std::vector<aiMesh *> &meshes);
+
+#pragma mark - Animations
+
+/**
+ Creates an animation with one channel per node name, where each channel has
+ nKeys position, rotation and scaling keys at times 0, 1, 2...
+
+ @param nodeNames The names of the animated nodes.
+ @param nKeys The number of keys of each kind in each channel.
+ @param duration The duration in ticks.
+ @param ticksPerSecond The ticks per second.
+ @return A new animation.
+ */
+aiAnimation *AKTestMakeAnimation(const std::vector<const char *> &nodeNames,
+                                 unsigned int nKeys,
+                                 double duration,
+                                 double ticksPerSecond);
+
+/**
+ Appends an animation to the scene.
+
+ @param aiScene The scene.
+ @param aiAnimation The animation, owned by the scene from now on.
+ */
+void AKTestAddAnimation(aiScene *aiScene, aiAnimation *aiAnimation);
+
+#endif /* AKTestScene_h */
@@ -0,0 +1,296 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKTest.h"
+#include "AKVertexKernels.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#pragma mark - Test streams
+
+/**
+ The largest stream of the tests, which covers the vectorized blocks and the
+ scalar tail of every kernel.
+ */
+static const size_t kMaxVertices = 37;
+
+/**
+ The stride of an interleaved destination, with room for 4 floats and a
+ marker between attributes.
+ */
+static const size_t kStride = 5 * sizeof(float);
+
+/**
+ Makes a stream of packed floats whose values differ and include values out of
+ [0, 1].
+
+ @param nFloats The number of floats.
+ @return The stream.
+ */
+static std::vector<float> makeStream(size_t nFloats)
+{
+    std::vector<float> stream(nFloats);
+    for (size_t i = 0; i < nFloats; i++)
+    {
+        stream[i] = (float)((i * 37) % 101) / 80.0f - 0.125f;
+    }
+    return stream;
+}
+
+/**
+ Makes an interleaved destination filled with a marker byte, so that writes
+ past an attribute are detected.
+
+ @return The destination for kMaxVertices attributes.
+ */
+static std::vector<unsigned char> makeRows()
+{
+    return std::vector<unsigned char>(kMaxVertices * kStride, 0xab);
+}
+
+/**
+ Checks the bytes after each attribute of an interleaved destination still
+ hold the marker.
+
+ @param rows The interleaved destination.
+ @param n The number of attributes written.
+ @param size The number of bytes of an attribute.
+ @return true if no attribute was written past its size.
+ */
+static bool markersIntact(const std::vector<unsigned char> &rows,
+                          size_t n,
+                          size_t size)
+{
+    for (size_t i = 0; i < kMaxVertices; i++)
+    {
+        size_t start = i < n ? i * kStride + size : i * kStride;
+        for (size_t b = start; b < (i + 1) * kStride; b++)
+        {
+            if (rows[b] != 0xab)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ Reads a float of an interleaved destination.
+
+ @param rows The interleaved destination.
+ @param i The index of the attribute.
+ @param k The index of the component.
+ @return The component.
+ */
+static float floatAt(const std::vector<unsigned char> &rows,
+                     size_t i,
+                     size_t k)
+{
+    float value;
+    memcpy(&value, &rows[i * kStride + k * sizeof(float)], sizeof(value));
+    return value;
+}
+
+#pragma mark - Vector streams
+
+/**
+ Tests copying vectors into interleaved and dense destinations.
+ */
+AK_TEST(testCopyVec3)
+{
+    std::vector<float> src = makeStream(kMaxVertices * 3);
+    for (size_t n = 0; n <= kMaxVertices; n++)
+    {
+        std::vector<unsigned char> rows = makeRows();
+        AKCopyVec3(src.data(), n, rows.data(), kStride);
+        AKAssertTrue(markersIntact(rows, n, 3 * sizeof(float)));
+        for (size_t i = 0; i < n; i++)
+        {
+            AKAssertTrue(memcmp(&rows[i * kStride], &src[3 * i],
+                                3 * sizeof(float)) == 0);
+        }
+    }
+    std::vector<float> dense(kMaxVertices * 3);
+    AKCopyVec3(src.data(), kMaxVertices, dense.data(), 3 * sizeof(float));
+    AKAssertTrue(dense == src);
+}
+
+/**
+ Tests scaling and offsetting vectors matches the scalar transform.
+ */
+AK_TEST(testScaleOffsetVec3)
+{
+    std::vector<float> src = makeStream(kMaxVertices * 3);
+    const float scale[3] = {2.0f, -0.5f, 0.25f};
+    const float offset[3] = {1.0f, 0.0f, -3.0f};
+    for (size_t n = 0; n <= kMaxVertices; n++)
+    {
+        std::vector<unsigned char> rows = makeRows();
+        AKScaleOffsetVec3(src.data(), n, scale, offset, rows.data(), kStride);
+        AKAssertTrue(markersIntact(rows, n, 3 * sizeof(float)));
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t k = 0; k < 3; k++)
+            {
+                AKAssertEqualWithAccuracy(
+                    floatAt(rows, i, k), src[3 * i + k] * scale[k] + offset[k],
+                    1e-6);
+            }
+        }
+    }
+}
+
+/**
+ Tests transforming positions and directions by an affine matrix.
+ */
+AK_TEST(testTransformVec3)
+{
+    std::vector<float> src = makeStream(kMaxVertices * 3);
+    // a rotation of 90 degrees about z, a scale of 2 and a translation
+    const float matrix[12] = {0.0f, -2.0f, 0.0f, 1.0f, //
+                              2.0f, 0.0f,  0.0f, 2.0f, //
+                              0.0f, 0.0f,  2.0f, 3.0f};
+    for (size_t n = 0; n <= kMaxVertices; n++)
+    {
+        std::vector<unsigned char> points = makeRows();
+        std::vector<unsigned char> directions = makeRows();
+        AKTransformVec3(src.data(), n, matrix, 1.0f, points.data(), kStride);
+        AKTransformVec3(src.data(), n, matrix, 0.0f, directions.data(),
+                        kStride);
+        AKAssertTrue(markersIntact(points, n, 3 * sizeof(float)));
+        AKAssertTrue(markersIntact(directions, n, 3 * sizeof(float)));
+        for (size_t i = 0; i < n; i++)
+        {
+            const float *v = &src[3 * i];
+            AKAssertEqualWithAccuracy(floatAt(points, i, 0),
+                                      -2.0f * v[1] + 1.0f, 1e-5);
+            AKAssertEqualWithAccuracy(floatAt(points, i, 1),
+                                      2.0f * v[0] + 2.0f, 1e-5);
+            AKAssertEqualWithAccuracy(floatAt(points, i, 2),
+                                      2.0f * v[2] + 3.0f, 1e-5);
+            AKAssertEqualWithAccuracy(floatAt(directions, i, 0),
+                                      -2.0f * v[1], 1e-5);
+            AKAssertEqualWithAccuracy(floatAt(directions, i, 2), 2.0f * v[2],
+                                      1e-5);
+        }
+    }
+}
+
+/**
+ Tests extracting 2 dimensional texture coordinates.
+ */
+AK_TEST(testExtractTexCoords)
+{
+    std::vector<float> src = makeStream(kMaxVertices * 3);
+    for (size_t n = 0; n <= kMaxVertices; n++)
+    {
+        std::vector<unsigned char> rows = makeRows();
+        AKExtractTexCoords(src.data(), n, rows.data(), kStride);
+        AKAssertTrue(markersIntact(rows, n, 2 * sizeof(float)));
+        for (size_t i = 0; i < n; i++)
+        {
+            AKAssertEqual(floatAt(rows, i, 0), src[3 * i]);
+            AKAssertEqual(floatAt(rows, i, 1), src[3 * i + 1]);
+        }
+    }
+}
+
+#pragma mark - Color streams
+
+/**
+ Tests packing rgba colors to rgb colors.
+ */
+AK_TEST(testPackColorsRGB)
+{
+    std::vector<float> src = makeStream(kMaxVertices * 4);
+    for (size_t n = 0; n <= kMaxVertices; n++)
+    {
+        std::vector<unsigned char> rows = makeRows();
+        AKPackColorsRGB(src.data(), n, rows.data(), kStride);
+        AKAssertTrue(markersIntact(rows, n, 3 * sizeof(float)));
+        for (size_t i = 0; i < n; i++)
+        {
+            AKAssertTrue(memcmp(&rows[i * kStride], &src[4 * i],
+                                3 * sizeof(float)) == 0);
+        }
+    }
+}
+
+/**
+ Tests packing rgba colors to clamped and rounded unorm8 colors.
+ */
+AK_TEST(testPackColorsRGBA8)
+{
+    std::vector<float> src = makeStream(kMaxVertices * 4);
+    // halfway values round to even
+    src[0] = 0.5f / 255.0f;
+    src[1] = 1.5f / 255.0f;
+    for (size_t n = 0; n <= kMaxVertices; n++)
+    {
+        std::vector<unsigned char> rows = makeRows();
+        AKPackColorsRGBA8(src.data(), n, rows.data(), kStride);
+        AKAssertTrue(markersIntact(rows, n, 4));
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t k = 0; k < 4; k++)
+            {
+                float v = src[4 * i + k];
+                v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+                AKAssertEqual((unsigned int)rows[i * kStride + k],
+                              (unsigned int)lrintf(v * 255.0f));
+            }
+        }
+    }
+    std::vector<unsigned char> rows = makeRows();
+    AKPackColorsRGBA8(src.data(), 1, rows.data(), kStride);
+    AKAssertEqual((unsigned int)rows[0], 0u);
+    AKAssertEqual((unsigned int)rows[1], 2u);
+}
+
+#pragma mark - Chunks
+
+/**
+ Tests the number of chunks of a stream.
+ */
+AK_TEST(testChunkCount)
+{
+    AKAssertEqual(AKVertexChunkCount(0), (size_t)0);
+    AKAssertEqual(AKVertexChunkCount(1), (size_t)1);
+    AKAssertEqual(AKVertexChunkCount(AKVertexChunkSize), (size_t)1);
+    AKAssertEqual(AKVertexChunkCount(AKVertexChunkSize + 1), (size_t)2);
+}
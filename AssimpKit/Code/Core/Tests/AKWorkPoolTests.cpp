@@ -0,0 +1,177 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKTest.h"
+#include "AKWorkPool.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#pragma mark - Batch items
+
+/**
+ The record of the items of a batch which ran.
+ */
+struct AKTestBatch
+{
+    /**
+     The number of times each item ran.
+     */
+    std::vector<std::atomic<int>> runs;
+
+    /**
+     The number of items running.
+     */
+    std::atomic<int> nRunning;
+
+    /**
+     The largest number of items running at the same time.
+     */
+    std::atomic<int> maxRunning;
+
+    /**
+     The time each item sleeps for, in milliseconds, where the index is the
+     item modulo the number of sleeps.
+     */
+    std::vector<int> sleeps;
+
+    AKTestBatch(size_t nItems) : runs(nItems), nRunning(0), maxRunning(0)
+    {
+        for (size_t i = 0; i < nItems; i++)
+        {
+            runs[i] = 0;
+        }
+    }
+};
+
+/**
+ Runs an item: records it ran, and sleeps for the time of the item.
+
+ @param context The test batch.
+ @param item The index of the item.
+ @param worker The index of the worker.
+ */
+static void runItem(void *context, size_t item, unsigned int worker)
+{
+    AKTestBatch *batch = (AKTestBatch *)context;
+    batch->runs[item]++;
+    int running = ++batch->nRunning;
+    int maxRunning = batch->maxRunning;
+    while (running > maxRunning &&
+           !batch->maxRunning.compare_exchange_weak(maxRunning, running))
+    {
+    }
+    if (!batch->sleeps.empty())
+    {
+        int ms = batch->sleeps[item % batch->sleeps.size()];
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+    batch->nRunning--;
+}
+
+#pragma mark - Tests
+
+/**
+ Tests every item of a batch runs once, with more items than workers, fewer
+ items than workers and no items.
+ */
+AK_TEST(testRunsEveryItemOnce)
+{
+    AKWorkPool *pool = AKWorkPoolCreate(4, 0);
+    AKAssertEqual(AKWorkPoolWorkerCount(pool), 4u);
+    const size_t counts[] = {100, 3, 0};
+    for (size_t c = 0; c < 3; c++)
+    {
+        AKTestBatch batch(counts[c]);
+        AKWorkPoolRun(pool, counts[c], NULL, runItem, &batch);
+        for (size_t i = 0; i < counts[c]; i++)
+        {
+            AKAssertEqual(batch.runs[i].load(), 1);
+        }
+    }
+    AKWorkPoolRelease(pool);
+}
+
+/**
+ Tests a worker which runs out of items steals the items left to another
+ worker.
+
+ The items are dealt in turn to two workers, so the first worker gets the
+ slow even items and the second the fast odd items.
+ */
+AK_TEST(testStealsFromBusyWorker)
+{
+    AKWorkPool *pool = AKWorkPoolCreate(2, 0);
+    AKTestBatch batch(16);
+    batch.sleeps.push_back(10);
+    batch.sleeps.push_back(0);
+    AKWorkPoolRun(pool, 16, NULL, runItem, &batch);
+    AKAssertTrue(AKWorkPoolStealCount(pool) > 0);
+    for (size_t i = 0; i < 16; i++)
+    {
+        AKAssertEqual(batch.runs[i].load(), 1);
+    }
+    AKWorkPoolRelease(pool);
+}
+
+/**
+ Tests the items running at the same time stay within the cost budget, and an
+ item over the whole budget runs on its own.
+ */
+AK_TEST(testCostBudget)
+{
+    AKWorkPool *pool = AKWorkPoolCreate(8, 4);
+    AKTestBatch batch(32);
+    batch.sleeps.push_back(2);
+    std::vector<size_t> costs(32, 2);
+    AKWorkPoolRun(pool, 32, costs.data(), runItem, &batch);
+    AKAssertTrue(batch.maxRunning <= 2);
+    for (size_t i = 0; i < 32; i++)
+    {
+        AKAssertEqual(batch.runs[i].load(), 1);
+    }
+
+    AKTestBatch oversized(8);
+    oversized.sleeps.push_back(2);
+    std::vector<size_t> oversizedCosts(8, 5);
+    AKWorkPoolRun(pool, 8, oversizedCosts.data(), runItem, &oversized);
+    AKAssertEqual(oversized.maxRunning.load(), 1);
+    for (size_t i = 0; i < 8; i++)
+    {
+        AKAssertEqual(oversized.runs[i].load(), 1);
+    }
+    AKWorkPoolRelease(pool);
+}
@@ -0,0 +1,390 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#include "AKAssetCompiler.h"
+#include "AKGeometry.h"
+#include "AKImportOptions.h"
+#include "AKImportStats.h"
+#include "AKSceneCache.h"
+#include "AKWorkPool.h"
+#include "assimp/postprocess.h" // Post processing flags
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+#include "AKImport.h"
+#include "AKSceneCompile.h"
+#endif
+
+/**
+ Compiles the scene files of a directory tree into scene archives, the
+ runtime assets which the importer loads without reading the files with
+ assimp, so that the scenes are converted on the build server instead of on
+ the device.
+
+ Each file with one of the listed extensions is read and post processed with
+ assimp and converted on a worker of a work pool, and its archive is written
+ at the same relative path in the output directory with the .akscene suffix
+ added. The manifest of the output directory lists the key and the size of
+ each asset. The files whose bytes and settings are unchanged since the last
+ run are not compiled again. A line per file reports what was done with it,
+ the sizes of the file and of its asset and the time taken.
+
+ usage: AKCompileAssets [-j workers] [-m max MB in flight] [-e extensions]
+                        [-p fast|quality|max] [-c components] [-q]
+                        input-directory output-directory
+
+ -j The number of workers, 0 for one per hardware thread, the default.
+ -m The total size in MB of the files compiled at the same time, 0 for no
+    cap, the default.
+ -e The list of extensions, one per line, by default the
+    valid-extensions.txt of the input directory.
+ -p The assimp post processing preset, quality by default.
+ -c The comma separated parts of the scenes to compile: geometry,
+    materials, textures, skinning, animations and cameras, all by default.
+ -q Quantizes the vertices: the positions, the normals and the tangents in
+    16 bits, the texture coordinates in half floats and the colors in 8 bits.
+
+ The exit status is 0 if every file was compiled or up to date.
+ */
+
+#pragma mark - Settings
+
+/**
+ The settings every file is compiled with.
+ */
+typedef struct AKCompileSettings
+{
+    /**
+     The assimp post processing steps.
+     */
+    unsigned int postProcessFlags;
+
+    /**
+     The import options, with the parts of the scenes to compile.
+     */
+    AKImportOptions options;
+
+    /**
+     The vertex layout of the node geometries.
+     */
+    AKVertexLayout layout;
+} AKCompileSettings;
+
+/**
+ Parses a post processing preset.
+
+ @param name The name of the preset.
+ @param flags Set to the post processing steps of the preset.
+ @return true if the preset is known.
+ */
+static bool parsePreset(const char *name, unsigned int *flags)
+{
+    if (strcmp(name, "fast") == 0)
+    {
+        *flags = aiProcessPreset_TargetRealtime_Fast;
+    }
+    else if (strcmp(name, "quality") == 0)
+    {
+        *flags = aiProcessPreset_TargetRealtime_Quality;
+    }
+    else if (strcmp(name, "max") == 0)
+    {
+        *flags = aiProcessPreset_TargetRealtime_MaxQuality;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ Parses a comma separated list of the parts of a scene.
+
+ @param list The list.
+ @param components Set to the AKImportComponent flags of the list.
+ @return true if every part is known.
+ */
+static bool parseComponents(const char *list, unsigned int *components)
+{
+    static const char *names[] = {"geometry", "materials", "textures",
+                                  "skinning", "animations", "cameras"};
+    static const unsigned int flags[] = {
+        AKImportComponentGeometry,   AKImportComponentMaterials,
+        AKImportComponentTextures,   AKImportComponentSkinning,
+        AKImportComponentAnimations, AKImportComponentCameras};
+    *components = 0;
+    std::string parts = list;
+    size_t start = 0;
+    while (start <= parts.size())
+    {
+        size_t comma = parts.find(',', start);
+        if (comma == std::string::npos)
+        {
+            comma = parts.size();
+        }
+        std::string part = parts.substr(start, comma - start);
+        unsigned int i = 0;
+        while (i < 6 && part != names[i])
+        {
+            i++;
+        }
+        if (i == 6)
+        {
+            return false;
+        }
+        *components |= flags[i];
+        start = comma + 1;
+    }
+    return true;
+}
+
+/**
+ Makes the settings key of the compiler, which changes with any setting the
+ assets depend on.
+
+ @param settings The settings.
+ @return The settings key.
+ */
+static unsigned long long makeSettingsKey(const AKCompileSettings *settings)
+{
+    unsigned long long key = AKSceneCacheKeyMake();
+    key = AKSceneCacheKeyAdd(key, &settings->postProcessFlags,
+                             sizeof(settings->postProcessFlags));
+    key = AKSceneCacheKeyAddOptions(key, &settings->options);
+    return AKSceneCacheKeyAdd(key, &settings->layout,
+                              sizeof(settings->layout));
+}
+
+#pragma mark - Compiling a file
+
+/**
+ Reads a scene file with assimp, converts its scene and writes its archive.
+
+ @param context The compile settings.
+ @param path The path of the file.
+ @param assetPath The path of the archive to write.
+ @param key The key of the archive.
+ @param error The buffer which receives the description of a failure.
+ @param nErrorBytes The size of the error buffer.
+ @return The size of the archive in bytes, or 0 if the file failed.
+ */
+static size_t compileFile(void *context,
+                          const char *path,
+                          const char *assetPath,
+                          unsigned long long key,
+                          char *error,
+                          size_t nErrorBytes)
+{
+#ifdef AK_HAVE_ASSIMP_LIBRARY
+    const AKCompileSettings *settings = (const AKCompileSettings *)context;
+    AKImport *import = AKImportCreate(NULL);
+    AKImportSetOptions(import, &settings->options);
+    const struct aiScene *aiScene =
+        AKImportReadFile(import, path, settings->postProcessFlags);
+    size_t size = 0;
+    if (aiScene == NULL)
+    {
+        snprintf(error, nErrorBytes, "%s", AKImportErrorString(import));
+    }
+    else
+    {
+        AKSceneArchiveWriter *writer =
+            AKSceneCompile(aiScene, &settings->layout,
+                           settings->options.components, key);
+        size = AKSceneArchiveWriterWriteFile(writer, assetPath);
+        if (size == 0)
+        {
+            snprintf(error, nErrorBytes, "could not write the asset");
+        }
+        AKSceneArchiveWriterRelease(writer);
+    }
+    AKImportRelease(import);
+    return size;
+#else
+    snprintf(error, nErrorBytes, "built without the assimp library");
+    return 0;
+#endif
+}
+
+#pragma mark - Report
+
+/**
+ Prints the report of every file of the run and the totals.
+
+ @param compiler The compiler, after its run.
+ @param seconds The time of the run in seconds.
+ */
+static void printReport(const AKAssetCompiler *compiler, double seconds)
+{
+    static const char *statuses[] = {"compiled", "up to date", "FAILED"};
+    printf("%-10s %10s %10s %10s  %s\n", "status", "file KB", "asset KB",
+           "ms", "file");
+    size_t counts[3] = {0, 0, 0};
+    double fileBytes = 0.0;
+    double assetBytes = 0.0;
+    double milliseconds = 0.0;
+    for (size_t i = 0; i < AKAssetCompilerReportCount(compiler); i++)
+    {
+        AKAssetReport report = AKAssetCompilerReportAt(compiler, i);
+        printf("%-10s %10.1f %10.1f %10.2f  %s\n", statuses[report.status],
+               report.fileBytes / 1024.0, report.assetBytes / 1024.0,
+               report.milliseconds, report.path);
+        if (report.status == AKAssetFailed)
+        {
+            printf("%-10s %s\n", "", report.error);
+        }
+        counts[report.status]++;
+        fileBytes += report.fileBytes;
+        assetBytes += report.assetBytes;
+        milliseconds += report.milliseconds;
+    }
+    printf("%-10s %10.1f %10.1f %10.2f  %zu files\n", "total",
+           fileBytes / 1024.0, assetBytes / 1024.0, milliseconds,
+           AKAssetCompilerReportCount(compiler));
+    printf("compiled %zu, up to date %zu, failed %zu, removed %zu in %.2f "
+           "s\n",
+           counts[AKAssetCompiled], counts[AKAssetUpToDate],
+           counts[AKAssetFailed], AKAssetCompilerRemovedCount(compiler),
+           seconds);
+}
+
+/**
+ Prints the usage of the tool.
+ */
+static void printUsage()
+{
+    fprintf(stderr,
+            "usage: AKCompileAssets [-j workers] [-m max MB in flight] "
+            "[-e extensions]\n"
+            "                       [-p fast|quality|max] [-c components] "
+            "[-q]\n"
+            "                       input-directory output-directory\n");
+}
+
+int main(int argc, char **argv)
+{
+    AKCompileSettings settings;
+    settings.postProcessFlags = aiProcessPreset_TargetRealtime_Quality;
+    settings.options = AKImportOptionsMakeDefault();
+    settings.layout = AKVertexLayoutMakeDefault();
+    unsigned int nWorkers = 0;
+    size_t maxBytesInFlight = 0;
+    const char *extensions = NULL;
+    int option;
+    while ((option = getopt(argc, argv, "j:m:e:p:c:q")) != -1)
+    {
+        switch (option)
+        {
+        case 'j':
+            nWorkers = (unsigned int)atoi(optarg);
+            break;
+        case 'm':
+            maxBytesInFlight = (size_t)atol(optarg) * 1024 * 1024;
+            break;
+        case 'e':
+            extensions = optarg;
+            break;
+        case 'p':
+            if (!parsePreset(optarg, &settings.postProcessFlags))
+            {
+                fprintf(stderr, "unknown preset %s\n", optarg);
+                return 2;
+            }
+            break;
+        case 'c':
+            if (!parseComponents(optarg, &settings.options.components))
+            {
+                fprintf(stderr, "unknown components %s\n", optarg);
+                return 2;
+            }
+            break;
+        case 'q':
+            settings.layout.formats[AKVertexAttributePosition] =
+                AKVertexFormatSNorm16;
+            settings.layout.formats[AKVertexAttributeNormal] =
+                AKVertexFormatOctSNorm16;
+            settings.layout.formats[AKVertexAttributeTangent] =
+                AKVertexFormatOctSNorm16;
+            settings.layout.formats[AKVertexAttributeTexCoord] =
+                AKVertexFormatHalf;
+            settings.layout.formats[AKVertexAttributeColor] =
+                AKVertexFormatUNorm8;
+            break;
+        default:
+            printUsage();
+            return 2;
+        }
+    }
+    if (argc - optind != 2)
+    {
+        printUsage();
+        return 2;
+    }
+#ifndef AK_HAVE_ASSIMP_LIBRARY
+    fprintf(stderr, "AKCompileAssets was built without the assimp library "
+                    "and cannot read scene files\n");
+    return 1;
+#endif
+    const char *inputDirectory = argv[optind];
+    const char *outputDirectory = argv[optind + 1];
+    AKAssetCompiler *compiler =
+        AKAssetCompilerCreate(inputDirectory, outputDirectory,
+                              makeSettingsKey(&settings), compileFile,
+                              &settings);
+    std::string extensionsPath =
+        extensions != NULL
+            ? extensions
+            : std::string(inputDirectory) + "/valid-extensions.txt";
+    if (AKAssetCompilerAddExtensionsFromFile(compiler,
+                                             extensionsPath.c_str()) <= 0)
+    {
+        fprintf(stderr, "no extensions in %s\n", extensionsPath.c_str());
+        AKAssetCompilerRelease(compiler);
+        return 2;
+    }
+    AKWorkPool *pool = AKWorkPoolCreate(nWorkers, maxBytesInFlight);
+    printf("Compiling %s into %s on %u workers\n", inputDirectory,
+           outputDirectory, AKWorkPoolWorkerCount(pool));
+    double start = AKImportStatsClock();
+    int compiled = AKAssetCompilerRun(compiler, pool);
+    printReport(compiler, AKImportStatsClock() - start);
+    AKWorkPoolRelease(pool);
+    AKAssetCompilerRelease(compiler);
+    return compiled ? 0 : 1;
+}
@@ -12,6 +12,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface AssimpImageCache : NSObject
 
+@property (nonatomic, readonly) NSUInteger cachedImageCount;
+@property (nonatomic, readonly) NSUInteger storedImageCount;
+@property (nonatomic, readonly) NSUInteger storedImageBytes;
+
 - (CGImageRef)cachedFileAtPath:(NSString *)path;
 - (void)storeImage:(CGImageRef)image toPath:(NSString *)path;
 
@@ -9,6 +9,9 @@
 
 @interface AssimpImageCache()
 @property (nonatomic, strong) NSMutableDictionary<NSString *, id> *cacheDictionary;
+@property (nonatomic, readwrite) NSUInteger cachedImageCount;
+@property (nonatomic, readwrite) NSUInteger storedImageCount;
+@property (nonatomic, readwrite) NSUInteger storedImageBytes;
 @end
 
 @implementation AssimpImageCache
@@ -29,7 +32,11 @@
 
 - (CGImageRef)cachedFileAtPath:(NSString *)path
 {
-    return (__bridge CGImageRef _Nonnull)(self.cacheDictionary[path]);
+    id image = self.cacheDictionary[path];
+    if (image != nil) {
+        self.cachedImageCount++;
+    }
+    return (__bridge CGImageRef _Nonnull)(image);
 }
 
 - (void)storeImage:(CGImageRef)image toPath:(NSString *)path
@@ -38,6 +45,9 @@
         [self.cacheDictionary removeObjectForKey:path];
     } else {
         [self.cacheDictionary setObject:(__bridge id _Nonnull)(image) forKey:path];
+        self.storedImageCount++;
+        self.storedImageBytes +=
+            CGImageGetBytesPerRow(image) * CGImageGetHeight(image);
     }
 }
 
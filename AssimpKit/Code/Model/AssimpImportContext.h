@@ -0,0 +1,314 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import <Foundation/Foundation.h>
+#import <SceneKit/SceneKit.h>
+#import "AssimpImageCache.h"
+#import "SCNAssimpImportSettings.h"
+#import "SCNAssimpQuantizationReport.h"
+#include "AKBonePalette.h"
+#include "AKImportStats.h"
+#include "AKMeshStats.h"
+#include "AKProgress.h"
+#include "AKSceneArchive.h"
+#include "AKSceneGeometry.h"
+#include "AKSceneTrim.h"
+
+/**
+ The state of one import, which the importer makes for each import and passes
+ to every step of the conversion of the assimp scene.
+
+ As the importer keeps no state of its own, an importer can run any number of
+ imports at the same time, each with its own context. A context is used by one
+ import on one thread at a time.
+ */
+@interface AssimpImportContext : NSObject
+
+#pragma mark - Creating an import context
+
+/**
+ @name Creating an import context
+ */
+
+/**
+ Makes the context of an import with the specified settings and progress.
+
+ @param settings The import settings, or nil for the default settings.
+ @param progress The portable progress of the import, or NULL.
+ @return A new import context.
+ */
+- (id)initWithSettings:(SCNAssimpImportSettings *)settings
+              progress:(AKProgress *)progress;
+
+#pragma mark - Import settings
+
+/**
+ @name Import settings
+ */
+
+/**
+ The settings of the import.
+ */
+@property (readonly, nonatomic) SCNAssimpImportSettings *settings;
+
+/**
+ Determines if the import converts the specified components of the scene.
+
+ The materials, the textures and the skinning are only converted with the
+ geometry, and the textures only with the materials.
+
+ @param components The components.
+ @return YES if every one of the components is converted.
+ */
+- (BOOL)importsComponents:(SCNAssimpImportComponents)components;
+
+/**
+ The portable progress of the import, which is advanced and checked for
+ cancellation by the conversion, or NULL.
+ */
+@property (readonly, nonatomic) AKProgress *progress;
+
+/**
+ The cache of the images loaded for the textures of the import.
+ */
+@property (readonly, nonatomic) AssimpImageCache *imageCache;
+
+/**
+ The data of the files supplied by the resource resolver of the settings,
+ which are read in place and so are kept until the import ends.
+ */
+@property (readonly, nonatomic) NSMutableArray *resolvedFiles;
+
+/**
+ The block which supplies the external textures of the import, which reads
+ them through the file system of the assimp import, so that they are read
+ ahead, resolved and counted like the files which assimp reads. It is set
+ when the import is configured and is only used until the import is released.
+ */
+@property (readwrite, copy, nonatomic)
+    SCNAssimpResourceResolver textureResolver;
+
+/**
+ The quantization report of the scene being made, which accumulates the
+ quantization of each node geometry.
+ */
+@property (readwrite, nonatomic)
+    SCNAssimpQuantizationReport *quantizationReport;
+
+#pragma mark - Import stats
+
+/**
+ @name Import stats
+ */
+
+/**
+ The measurements of the import, which the conversion adds the time of its
+ phases and the bytes of its node geometries to, or NULL if the settings do
+ not measure the import.
+ */
+@property (readonly, nonatomic) AKImportStats *importStats;
+
+/**
+ The memory account of the import, which is current on the thread which
+ converts the scene, or NULL if the settings do not measure the import. The
+ account is owned by the assimp import.
+ */
+@property (readwrite, nonatomic) AKMemoryAccount *memoryAccount;
+
+/**
+ Starts timing a part of an import phase.
+
+ @return The start time, or 0 if the settings do not measure the import.
+ */
+- (double)startTiming;
+
+/**
+ Adds the time since the specified start to an import phase, if the settings
+ measure the import.
+
+ @param start The start time from startTiming.
+ @param phase The import phase.
+ @return The current time, to start timing the next part, or 0 if the
+ settings do not measure the import.
+ */
+- (double)addTimeSince:(double)start toPhase:(AKImportPhase)phase;
+
+#pragma mark - Node maps
+
+/**
+ @name Node maps
+ */
+
+/**
+ The dictionary of scene nodes, where key is the pointer to the assimp node
+ they were made from.
+ */
+@property (readwrite, nonatomic) NSMutableDictionary *scnNodes;
+
+/**
+ The dictionary of scene nodes, where key is the node name.
+ */
+@property (readwrite, nonatomic) NSMutableDictionary *nodeIndex;
+
+/**
+ The dictionary of node depths from the scene's root node, where key is the
+ scene node.
+ */
+@property (readwrite, nonatomic) NSMutableDictionary *nodeDepths;
+
+/**
+ The dictionary of the chunks of split node geometries, where key is the
+ pointer to the assimp node. Each chunk is a dictionary with the chunk's
+ geometry, its vertex map and, once the node is made, its scene node.
+ */
+@property (readwrite, nonatomic) NSMutableDictionary *geometryChunks;
+
+/**
+ The statistics of every mesh of the scene, computed once per import and used
+ to size the geometry and skin buffers of every node. The context releases
+ the statistics it still holds when it is deallocated.
+ */
+@property (readwrite, nonatomic) AKSceneStats *sceneStats;
+
+/**
+ The node geometries of every node of the scene, converted in parallel before
+ the scene nodes are made, which each scene node takes the geometry of its
+ assimp node from. The context releases the node geometries it still holds
+ when it is deallocated.
+ */
+@property (readwrite, nonatomic) AKSceneGeometry *sceneGeometry;
+
+/**
+ The trim of the assimp scene, which frees the data of the scene as soon as it
+ is converted when the settings minimize the peak memory, or NULL. The
+ geometry of each node is then converted when its scene node is made, instead
+ of taken from the scene geometry. The context releases the trim it still
+ holds when it is deallocated.
+ */
+@property (readwrite, nonatomic) AKSceneTrim *sceneTrim;
+
+#pragma mark - Scene cache
+
+/**
+ @name Scene cache
+ */
+
+/**
+ The writer of the archive of the scene being converted, which is stored in
+ the scene cache of the settings once the scene is made, or NULL if the
+ import does not store its scene. The context releases the writer it still
+ holds when it is deallocated.
+ */
+@property (readwrite, nonatomic) AKSceneArchiveWriter *archiveWriter;
+
+/**
+ The key of the scene in the scene cache of the settings.
+ */
+@property (readwrite, nonatomic) unsigned long long archiveKey;
+
+/**
+ The mapped file of the scene archive which the scene is made from, or nil if
+ the scene is converted from an assimp scene. The data of the geometry
+ sources and elements read in place from the archive keep it, so that the
+ archive stays mapped as long as a geometry uses it.
+ */
+@property (readwrite, nonatomic) NSData *archiveData;
+
+/**
+ Records the index in the scene archive of a scene node added to the archive.
+
+ @param index The index of the node in the archive.
+ @param node The scene node.
+ */
+- (void)setArchiveIndex:(unsigned int)index forNode:(SCNNode *)node;
+
+/**
+ Returns the index in the scene archive of a scene node.
+
+ @param node The scene node, or nil.
+ @return The index of the node, or AKArchiveNone if the node was not added to
+ the archive.
+ */
+- (unsigned int)archiveIndexOfNode:(SCNNode *)node;
+
+#pragma mark - Bone data
+
+/**
+ @name Bone data
+ */
+
+/**
+ The bone palette of unique bone names across all meshes in all nodes, which
+ maps each bone name to its index in the skinner's bones array. The context
+ releases the palette it still holds when it is deallocated.
+ */
+@property (readwrite, nonatomic) AKBonePalette *bonePalette;
+
+/**
+ The dictionary of the bone geometry sources made with the geometry of each
+ skinned node when the scene is trimmed, where key is the pointer to the
+ assimp node. Each value is an array with the boneWeights and boneIndices
+ geometry sources of each chunk of the node geometry, or of the whole node
+ geometry if it is not split.
+ */
+@property (readonly, nonatomic) NSMutableDictionary *boneSources;
+
+/**
+ The array of unique bone names across all meshes in all nodes, in the order
+ of the bone palette.
+ */
+@property (readwrite, nonatomic) NSArray *uniqueBoneNames;
+
+/**
+ The array of unique bone nodes across all meshes in all nodes.
+ */
+@property (readwrite, nonatomic) NSArray *uniqueBoneNodes;
+
+/**
+ The dictionary of bone inverse bind transforms, where key is the bone name.
+ */
+@property (readonly, nonatomic) NSMutableDictionary *boneTransforms;
+
+/**
+ The array of unique bone transforms for all unique bone nodes.
+ */
+@property (readwrite, nonatomic) NSArray *uniqueBoneTransforms;
+
+/**
+ The root node of the skeleton in the scene.
+ */
+@property (readwrite, nonatomic) SCNNode *skeleton;
+
+@end
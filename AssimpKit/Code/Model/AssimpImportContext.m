@@ -0,0 +1,247 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import "AssimpImportContext.h"
+
+@interface AssimpImportContext ()
+
+/**
+ The settings of the import.
+ */
+@property (readwrite, nonatomic) SCNAssimpImportSettings *settings;
+
+/**
+ The portable progress of the import, or NULL.
+ */
+@property (readwrite, nonatomic) AKProgress *progress;
+
+/**
+ The cache of the images loaded for the textures of the import.
+ */
+@property (readwrite, nonatomic) AssimpImageCache *imageCache;
+
+/**
+ The data of the files supplied by the resource resolver, kept until the
+ import ends.
+ */
+@property (readwrite, nonatomic) NSMutableArray *resolvedFiles;
+
+/**
+ The dictionary of bone inverse bind transforms, where key is the bone name.
+ */
+@property (readwrite, nonatomic) NSMutableDictionary *boneTransforms;
+
+/**
+ The dictionary of the bone geometry sources made with the geometry of each
+ skinned node when the scene is trimmed, where key is the pointer to the
+ assimp node.
+ */
+@property (readwrite, nonatomic) NSMutableDictionary *boneSources;
+
+/**
+ The dictionary of the indices of the scene nodes in the scene archive, where
+ key is the scene node.
+ */
+@property (readwrite, nonatomic) NSMutableDictionary *archiveNodes;
+
+@end
+
+@implementation AssimpImportContext
+{
+    /**
+     The measurements of the import, whether or not the settings measure it.
+     */
+    AKImportStats _importStats;
+}
+
+#pragma mark - Creating an import context
+
+/**
+ @name Creating an import context
+ */
+
+/**
+ Makes the context of an import with the specified settings and progress.
+
+ @param settings The import settings, or nil for the default settings.
+ @param progress The portable progress of the import, or NULL.
+ @return A new import context.
+ */
+- (id)initWithSettings:(SCNAssimpImportSettings *)settings
+              progress:(AKProgress *)progress
+{
+    self = [super init];
+    if (self)
+    {
+        self.settings = settings != nil
+                            ? settings
+                            : [[SCNAssimpImportSettings alloc] init];
+        self.progress = progress;
+        self.imageCache = [[AssimpImageCache alloc] init];
+        self.resolvedFiles = [[NSMutableArray alloc] init];
+        self.scnNodes = [[NSMutableDictionary alloc] init];
+        self.nodeIndex = [[NSMutableDictionary alloc] init];
+        self.nodeDepths = [[NSMutableDictionary alloc] init];
+        self.geometryChunks = [[NSMutableDictionary alloc] init];
+        self.boneTransforms = [[NSMutableDictionary alloc] init];
+        self.boneSources = [[NSMutableDictionary alloc] init];
+        self.archiveNodes = [[NSMutableDictionary alloc] init];
+        _importStats = AKImportStatsMakeEmpty();
+    }
+    return self;
+}
+
+/**
+ Releases the scene statistics, the node geometries, the scene trim, the
+ archive writer and the bone palette, if the import did not release them.
+ */
+- (void)dealloc
+{
+    AKSceneStatsRelease(self.sceneStats);
+    AKSceneGeometryRelease(self.sceneGeometry);
+    AKSceneTrimRelease(self.sceneTrim);
+    AKSceneArchiveWriterRelease(self.archiveWriter);
+    AKBonePaletteRelease(self.bonePalette);
+}
+
+#pragma mark - Import settings
+
+/**
+ Determines if the import converts the specified components of the scene.
+
+ The materials, the textures and the skinning are only converted with the
+ geometry, and the textures only with the materials.
+
+ @param components The components.
+ @return YES if every one of the components is converted.
+ */
+- (BOOL)importsComponents:(SCNAssimpImportComponents)components
+{
+    SCNAssimpImportComponents imported = self.settings.components;
+    if (!(imported & SCNAssimpImportComponentGeometry))
+    {
+        imported &= ~(SCNAssimpImportComponentMaterials |
+                      SCNAssimpImportComponentTextures |
+                      SCNAssimpImportComponentSkinning);
+    }
+    if (!(imported & SCNAssimpImportComponentMaterials))
+    {
+        imported &= ~SCNAssimpImportComponentTextures;
+    }
+    return (imported & components) == components;
+}
+
+#pragma mark - Import stats
+
+/**
+ @name Import stats
+ */
+
+/**
+ The measurements of the import, or NULL if the settings do not measure the
+ import.
+
+ @return The import stats, owned by the context.
+ */
+- (AKImportStats *)importStats
+{
+    return self.settings.measuresImport ? &_importStats : NULL;
+}
+
+/**
+ Starts timing a part of an import phase.
+
+ @return The start time, or 0 if the settings do not measure the import.
+ */
+- (double)startTiming
+{
+    return self.settings.measuresImport ? AKImportStatsClock() : 0;
+}
+
+/**
+ Adds the time since the specified start to an import phase, if the settings
+ measure the import.
+
+ @param start The start time from startTiming.
+ @param phase The import phase.
+ @return The current time, to start timing the next part, or 0 if the
+ settings do not measure the import.
+ */
+- (double)addTimeSince:(double)start toPhase:(AKImportPhase)phase
+{
+    if (!self.settings.measuresImport)
+    {
+        return 0;
+    }
+    return AKImportStatsAddPhaseTime(&_importStats, phase, start);
+}
+
+#pragma mark - Scene cache
+
+/**
+ @name Scene cache
+ */
+
+/**
+ Records the index in the scene archive of a scene node added to the archive.
+
+ @param index The index of the node in the archive.
+ @param node The scene node.
+ */
+- (void)setArchiveIndex:(unsigned int)index forNode:(SCNNode *)node
+{
+    [self.archiveNodes setObject:[NSNumber numberWithUnsignedInt:index]
+                          forKey:[NSValue valueWithNonretainedObject:node]];
+}
+
+/**
+ Returns the index in the scene archive of a scene node.
+
+ @param node The scene node, or nil.
+ @return The index of the node, or AKArchiveNone if the node was not added to
+ the archive.
+ */
+- (unsigned int)archiveIndexOfNode:(SCNNode *)node
+{
+    NSNumber *index = node != nil
+                          ? [self.archiveNodes
+                                objectForKey:[NSValue
+                                                 valueWithNonretainedObject:
+                                                     node]]
+                          : nil;
+    return index != nil ? index.unsignedIntValue : AKArchiveNone;
+}
+
+@end
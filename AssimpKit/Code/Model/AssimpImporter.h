@@ -38,6 +38,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #import <SceneKit/SceneKit.h>
 #import "SCNAssimpScene.h"
 #import "PostProcessingFlags.h"
+#import "SCNAssimpImportSettings.h"
+#import "SCNAssimpImportProgress.h"
 
 /**
  An importer that imports the files with formats supported by Assimp and
@@ -82,7 +84,212 @@ DEPRECATED_MSG_ATTRIBUTE("Please use importScene:postProcessFlags:error:");
                postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
                           error:(NSError **)error;
 
+/**
+ Loads a scene from the specified file path with the specified import
+ settings.
+
+ @param filePath The path to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
+- (SCNAssimpScene *)importScene:(NSString *)filePath
+               postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                       settings:(SCNAssimpImportSettings *)settings
+                          error:(NSError **)error;
+
+/**
+ Loads a scene from the specified file path with the specified import
+ settings, reporting the progress of the import.
+
+ If the import is cancelled, no scene is loaded and the error is
+ NSUserCancelledError in NSCocoaErrorDomain.
+
+ A file with the .akscene extension is a scene asset compiled ahead of time,
+ such as by the AKCompileAssets tool, which is loaded without assimp. Its
+ vertices, indices and bone weights are read in place from the mapped file,
+ so only the pages of the geometries which scenekit uses are read. The post
+ processing flags and the settings other than the components do not apply to
+ it, as it was converted when it was compiled.
+
+ @param filePath The path to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param progress The progress of the import, or nil.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
+- (SCNAssimpScene *)importScene:(NSString *)filePath
+               postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                       settings:(SCNAssimpImportSettings *)settings
+                       progress:(SCNAssimpImportProgress *)progress
+                          error:(NSError **)error;
+
+#pragma mark - Loading a scene from memory
+
+/**
+ @name Loading a scene from memory
+ */
+
+/**
+ Loads a scene from a scene file in memory with the specified import
+ settings.
+
+ @param data The contents of the scene file, which are read in place.
+ @param hint The file extension of the scene file, such as @"obj", which
+ picks the loader of the file.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
+- (SCNAssimpScene *)importSceneFromData:(NSData *)data
+                                   hint:(NSString *)hint
+                       postProcessFlags:
+                           (AssimpKitPostProcessSteps)postProcessFlags
+                               settings:(SCNAssimpImportSettings *)settings
+                                  error:(NSError **)error;
+
+/**
+ Loads a scene from a scene file in memory with the specified import
+ settings, reporting the progress of the import.
+
+ The scene file is neither copied nor written to the disk. The files it
+ refers to are supplied by the resource resolver of the settings, or read
+ from the disk relative to the current directory.
+
+ If the import is cancelled, no scene is loaded and the error is
+ NSUserCancelledError in NSCocoaErrorDomain.
+
+ @param data The contents of the scene file, which are read in place.
+ @param hint The file extension of the scene file, such as @"obj", which
+ picks the loader of the file.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param progress The progress of the import, or nil.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
+- (SCNAssimpScene *)importSceneFromData:(NSData *)data
+                                   hint:(NSString *)hint
+                       postProcessFlags:
+                           (AssimpKitPostProcessSteps)postProcessFlags
+                               settings:(SCNAssimpImportSettings *)settings
+                               progress:(SCNAssimpImportProgress *)progress
+                                  error:(NSError **)error;
+
+#pragma mark - Loading a scene asynchronously
+
+/**
+ @name Loading a scene asynchronously
+ */
+
+/**
+ Returns the concurrent queue on which the asynchronous imports parse the
+ files and convert the assimp scenes.
+
+ Imports on this queue run at the same time, as each import keeps its state
+ and its assimp error in its own context, so one importer can serve any
+ number of imports.
+
+ @return The conversion queue shared by all importers.
+ */
++ (dispatch_queue_t)conversionQueue;
+
+/**
+ Loads a scene from the specified file path with the specified import
+ settings, without blocking the calling thread.
+
+ The file is parsed and converted on the conversion queue. The importer is
+ retained until the completion handler has been called.
+
+ @param filePath The path to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param queue The queue on which to call the completion handler, or nil for
+ the main queue.
+ @param completionHandler The block which receives the new scene object, or
+ nil and the import error if no scene could be loaded.
+ */
+- (void)importScene:(NSString *)filePath
+     postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+             settings:(SCNAssimpImportSettings *)settings
+      completionQueue:(dispatch_queue_t)queue
+    completionHandler:(SCNAssimpSceneCompletionHandler)completionHandler;
+
+/**
+ Loads a scene from the specified file path with the specified import
+ settings, reporting the progress of the import, without blocking the calling
+ thread.
+
+ The import can be cancelled while it waits on the conversion queue and while
+ it runs. A cancelled import calls the completion handler with the error
+ NSUserCancelledError in NSCocoaErrorDomain.
+
+ @param filePath The path to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param progress The progress of the import, or nil.
+ @param queue The queue on which to call the completion handler, or nil for
+ the main queue.
+ @param completionHandler The block which receives the new scene object, or
+ nil and the import error if no scene could be loaded.
+ */
+- (void)importScene:(NSString *)filePath
+     postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+             settings:(SCNAssimpImportSettings *)settings
+             progress:(SCNAssimpImportProgress *)progress
+      completionQueue:(dispatch_queue_t)queue
+    completionHandler:(SCNAssimpSceneCompletionHandler)completionHandler;
+
+#pragma mark - Loading scenes in a batch
+
+/**
+ @name Loading scenes in a batch
+ */
+
+/**
+ Loads the scenes from the specified file URLs with the specified import
+ settings on a pool of workers, without blocking the calling thread.
+
+ Each worker starts with its own share of the files, the largest first, and
+ steals files from the other workers once it runs out, so that every worker
+ stays busy until the whole batch is loaded. The files imported at the same
+ time are never larger in total than maxBytesInFlight, which bounds the peak
+ memory of the batch, except for a file larger than maxBytesInFlight which is
+ imported on its own.
+
+ The scene handler receives each scene as its import completes, and the
+ completion handler receives all the scenes in the order of the URLs once the
+ batch is loaded. Both are called on the completion queue, and if the queue is
+ serial, every scene handler is called before the completion handler.
+
+ @param urls The file URLs of the scene files to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param nWorkers The number of scenes imported at the same time, or 0 for one
+ per processor.
+ @param maxBytesInFlight The largest total size of the files imported at the
+ same time, or 0 for no limit.
+ @param queue The queue on which to call the handlers, or nil for the main
+ queue.
+ @param sceneHandler The block which receives each scene as it is loaded, or
+ nil.
+ @param completionHandler The block which receives the scenes and the errors
+ in the order of the URLs.
+ */
+- (void)importScenesAtURLs:(NSArray *)urls
+          postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                  settings:(SCNAssimpImportSettings *)settings
+                   workers:(NSUInteger)nWorkers
+          maxBytesInFlight:(unsigned long long)maxBytesInFlight
+           completionQueue:(dispatch_queue_t)queue
+              sceneHandler:(SCNAssimpBatchSceneHandler)sceneHandler
+         completionHandler:(SCNAssimpBatchCompletionHandler)completionHandler;
+
 - (const char*) invokeAiGetErrorString;
 - (const void*)invokeAImportFile:(const char*)pFile pFlags:(unsigned int)pFlags;
+- (void)invokeAiReleaseImport:(const void*)pScene;
 
 @end
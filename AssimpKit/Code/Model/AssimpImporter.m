@@ -37,51 +37,42 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #import "SCNAssimpAnimation.h"
 #import "SCNTextureInfo.h"
 #import "AssimpImageCache.h"
+#import "AssimpImportContext.h"
 #include "assimp/cimport.h"     // Plain-C interface
 #include "assimp/light.h"       // Lights
 #include "assimp/material.h"    // Materials
 #include "assimp/postprocess.h" // Post processing flags
 #include "assimp/scene.h"       // Output data structure
-
-@interface AssimpImporter ()
-
-#pragma mark - Bone data
-
-/**
- @name Bone data
- */
-
-/**
- The array of bone names across all meshes in all nodes.
- */
-@property (readwrite, nonatomic) NSMutableArray *boneNames;
-
-/**
- The array of unique bone names across all meshes in all nodes.
- */
-@property (readwrite, nonatomic) NSArray *uniqueBoneNames;
-
-/**
- The array of unique bone nodes across all meshes in all nodes.
- */
-@property (readwrite, nonatomic) NSArray *uniqueBoneNodes;
-
-/**
- The dictionary of bone inverse bind transforms, where key is the bone name.
- */
-@property (readwrite, nonatomic) NSMutableDictionary *boneTransforms;
+#include "AKAnimation.h"
+#include "AKBonePalette.h"
+#include "AKGeometry.h"
+#include "AKImport.h"
+#include "AKMemory.h"
+#include "AKMeshStats.h"
+#include "AKProgress.h"
+#include "AKSceneArchive.h"
+#include "AKSceneCache.h"
+#include "AKSceneGeometry.h"
+#include "AKSkin.h"
+#include "AKWorkPool.h"
 
 /**
- The array of unique bone transforms for all unique bone nodes.
+ The number of texture types loaded for each material.
  */
-@property (readwrite, nonatomic) NSArray *uniqueBoneTransforms;
+enum
+{
+    kNumTextureTypes = 10
+};
 
 /**
- The root node of the skeleton in the scene.
+ The texture types loaded for each material.
  */
-@property (readwrite, nonatomic) SCNNode *skeleton;
-
-@end
+static const enum aiTextureType kTextureTypes[kNumTextureTypes] = {
+    aiTextureType_DIFFUSE,      aiTextureType_SPECULAR,
+    aiTextureType_AMBIENT,      aiTextureType_EMISSIVE,
+    aiTextureType_REFLECTION,   aiTextureType_OPACITY,
+    aiTextureType_NORMALS,      aiTextureType_HEIGHT,
+    aiTextureType_DISPLACEMENT, aiTextureType_SHININESS};
 
 @implementation AssimpImporter
 
@@ -99,14 +90,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 - (id)init
 {
     self = [super init];
-    if (self)
-    {
-        self.boneNames = [[NSMutableArray alloc] init];
-        self.boneTransforms = [[NSMutableDictionary alloc] init];
-
-        return self;
-    }
-    return nil;
+    return self;
 }
 
 #pragma mark - Loading a scene
@@ -141,592 +125,1862 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 - (SCNAssimpScene *)importScene:(NSString *)filePath
                postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
                           error:(NSError **)error
+{
+    return [self importScene:filePath
+            postProcessFlags:postProcessFlags
+                    settings:nil
+                       error:error];
+}
+
+/**
+ Loads a scene from the specified file path with the specified import
+ settings.
+
+ @param filePath The path to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
+- (SCNAssimpScene *)importScene:(NSString *)filePath
+               postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                       settings:(SCNAssimpImportSettings *)settings
+                          error:(NSError **)error
+{
+    return [self importScene:filePath
+            postProcessFlags:postProcessFlags
+                    settings:settings
+                    progress:nil
+                       error:error];
+}
+
+/**
+ Loads a scene from the specified file path with the specified import
+ settings, reporting the progress of the import.
+
+ If the import is cancelled, no scene is loaded and the error is
+ NSUserCancelledError in NSCocoaErrorDomain.
+
+ A file with the .akscene extension is a scene asset compiled ahead of time,
+ such as by the AKCompileAssets tool, which is loaded without assimp. Its
+ vertices, indices and bone weights are read in place from the mapped file,
+ so only the pages of the geometries which scenekit uses are read. The post
+ processing flags and the settings other than the components do not apply to
+ it, as it was converted when it was compiled.
+
+ @param filePath The path to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param progress The progress of the import, or nil.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
+- (SCNAssimpScene *)importScene:(NSString *)filePath
+               postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                       settings:(SCNAssimpImportSettings *)settings
+                       progress:(SCNAssimpImportProgress *)progress
+                          error:(NSError **)error
 {
     // Start the import on the given file with some example postprocessing
     // Usually - if speed is not the most important aspect for you - you'll t
     // probably to request more postprocessing than we do in this example.
     const char *pFile = [filePath UTF8String];
-    const struct aiScene *aiScene = aiImportFile(pFile, postProcessFlags);
-    // aiProcess_FlipUVs | aiProcess_Triangulate
-    // If the import failed, report it
-    if (!aiScene)
+    // The state of this import is kept in its own context so that imports
+    // can run at the same time
+    AssimpImportContext *context =
+        [[AssimpImportContext alloc] initWithSettings:settings
+                                             progress:progress.coreProgress];
+    // a scene asset compiled ahead of time is loaded without assimp
+    if (pFile != NULL &&
+        [filePath.pathExtension.lowercaseString
+            isEqualToString:@AK_SCENE_ARCHIVE_EXTENSION])
     {
-        NSString *errorString =
-            [NSString stringWithUTF8String:aiGetErrorString()];
-        ALog(@" Scene importing failed for filePath %@", filePath);
-        ALog(@" Scene importing failed with error %@", errorString);
-        
-        // Return error
-        if (error) {
-            *error = [NSError
-                      errorWithDomain:@"AssimpImporter"
-                      code:-1
-                      userInfo:@{NSLocalizedDescriptionKey:errorString}];
+        return [self makeSceneFromAssetFile:filePath
+                                    context:context
+                                      error:error];
+    }
+    // a file converted before is loaded from the scene cache, and a file
+    // which is not is stored in the cache once it is converted
+    SCNAssimpSceneCache *sceneCache = context.settings.sceneCache;
+    if (pFile != NULL && sceneCache != nil &&
+        [self makeArchiveKeyForFile:pFile
+                   postProcessFlags:postProcessFlags
+                            context:context])
+    {
+        AKSceneArchive *archive =
+            AKSceneCacheOpen(sceneCache.coreCache, context.archiveKey);
+        if (archive != NULL)
+        {
+            return [self makeSceneFromArchive:archive
+                                       atPath:filePath
+                                    fromCache:YES
+                                      context:context
+                                        error:error];
         }
-        
-        return nil;
+        context.archiveWriter = AKSceneArchiveWriterCreate(context.archiveKey);
     }
-    // Now we can access the file's contents
-    SCNAssimpScene *scene =
-        [self makeSCNSceneFromAssimpScene:aiScene atPath:filePath];
-    // We're done. Release all resources associated with this import
-    aiReleaseImport(aiScene);
-    return scene;
+    AKImport *import = AKImportCreate(progress.coreProgress);
+    const struct aiScene *aiScene =
+        pFile != NULL && [self configureImport:import context:context]
+            ? AKImportReadFile(import, pFile, postProcessFlags)
+            : NULL;
+    // aiProcess_FlipUVs | aiProcess_Triangulate
+    return [self makeSceneFromImport:import
+                             aiScene:aiScene
+                              atPath:filePath
+                             context:context
+                               error:error];
 }
 
-#pragma mark - Make scenekit scene
+#pragma mark - Loading a scene from memory
 
 /**
- @name Make scenekit scene
+ @name Loading a scene from memory
  */
 
 /**
- Creates a scenekit scene from the scene representing the file at a given path.
+ Loads a scene from a scene file in memory with the specified import
+ settings.
 
- @param aiScene The assimp scene.
- @param path The path to the scene file to load.
- @return A new scene object.
+ @param data The contents of the scene file, which are read in place.
+ @param hint The file extension of the scene file, such as @"obj", which
+ picks the loader of the file.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
  */
-- (SCNAssimpScene *)makeSCNSceneFromAssimpScene:(const struct aiScene *)aiScene
-                                         atPath:(NSString *)path
+- (SCNAssimpScene *)importSceneFromData:(NSData *)data
+                                   hint:(NSString *)hint
+                       postProcessFlags:
+                           (AssimpKitPostProcessSteps)postProcessFlags
+                               settings:(SCNAssimpImportSettings *)settings
+                                  error:(NSError **)error
 {
-    DLog(@" Make an SCNScene");
-    const struct aiNode *aiRootNode = aiScene->mRootNode;
-    SCNAssimpScene *scene = [[SCNAssimpScene alloc] init];
-    /*
-   -------------------------------------------------------------------
-   Assign geometry, materials, lights and cameras to the node
-   ---------------------------------------------------------------------
-   */
-	AssimpImageCache *imageCache = [[AssimpImageCache alloc] init];
-    SCNNode *scnRootNode =
-        [self makeSCNNodeFromAssimpNode:aiRootNode inScene:aiScene atPath:path imageCache:imageCache];
-    [scene.rootNode addChildNode:scnRootNode];
-    /*
-   ---------------------------------------------------------------------
-   Animations and skinning
-   ---------------------------------------------------------------------
-   */
-    [self buildSkeletonDatabaseForScene:scene];
-    [self makeSkinnerForAssimpNode:aiRootNode inScene:aiScene scnScene:scene];
-    [self createAnimationsFromScene:aiScene withScene:scene atPath:path];
-    /*
-     ---------------------------------------------------------------------
-     Make SCNScene for model and animations
-     ---------------------------------------------------------------------
-     */
-    [scene makeModelScene];
-    [scene makeAnimationScenes];
+    return [self importSceneFromData:data
+                                hint:hint
+                    postProcessFlags:postProcessFlags
+                            settings:settings
+                            progress:nil
+                               error:error];
+}
 
-    return scene;
+/**
+ Loads a scene from a scene file in memory with the specified import
+ settings, reporting the progress of the import.
+
+ The scene file is neither copied nor written to the disk. The files it
+ refers to are supplied by the resource resolver of the settings, or read
+ from the disk relative to the current directory.
+
+ If the import is cancelled, no scene is loaded and the error is
+ NSUserCancelledError in NSCocoaErrorDomain.
+
+ @param data The contents of the scene file, which are read in place.
+ @param hint The file extension of the scene file, such as @"obj", which
+ picks the loader of the file.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param progress The progress of the import, or nil.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
+- (SCNAssimpScene *)importSceneFromData:(NSData *)data
+                                   hint:(NSString *)hint
+                       postProcessFlags:
+                           (AssimpKitPostProcessSteps)postProcessFlags
+                               settings:(SCNAssimpImportSettings *)settings
+                               progress:(SCNAssimpImportProgress *)progress
+                                  error:(NSError **)error
+{
+    AssimpImportContext *context =
+        [[AssimpImportContext alloc] initWithSettings:settings
+                                             progress:progress.coreProgress];
+    AKImport *import = AKImportCreate(progress.coreProgress);
+    const struct aiScene *aiScene =
+        data != nil && [self configureImport:import context:context]
+            ? AKImportReadMemory(import, data.bytes, data.length,
+                                 hint.UTF8String, postProcessFlags)
+            : NULL;
+    // the scene is named as a file in the current directory, which the
+    // textures and animations are named relative to
+    NSString *path = hint.length > 0
+                         ? [@"scene" stringByAppendingPathExtension:hint]
+                         : @"scene";
+    return [self makeSceneFromImport:import
+                             aiScene:aiScene
+                              atPath:path
+                             context:context
+                               error:error];
 }
 
-#pragma mark - Make scenekit node
+#pragma mark - Reading the assimp scene
 
 /**
- @name Make a scenekit node
+ @name Reading the assimp scene
  */
 
 /**
- Creates a new scenekit node from the assimp scene node
+ Supplies a file which the scene refers to from the resource resolver of the
+ import settings.
+
+ @param context The import context.
+ @param name The path of the file relative to the directory of the scene.
+ @param data Receives the bytes of the file.
+ @param length Receives the number of bytes of the file.
+ @return 1 if the resolver supplied the file, 0 to read it from the disk.
+ */
+static int resolveImportFile(void *context,
+                             const char *name,
+                             const void **data,
+                             size_t *length)
+{
+    AssimpImportContext *importContext =
+        (__bridge AssimpImportContext *)context;
+    NSData *fileData = importContext.settings.resourceResolver(
+        [NSString stringWithUTF8String:name]);
+    if (fileData == nil)
+    {
+        return 0;
+    }
+    // the file is read in place, so the data is kept until the import ends
+    [importContext.resolvedFiles addObject:fileData];
+    *data = fileData.bytes;
+    *length = fileData.length;
+    return 1;
+}
 
- @param aiNode The assimp scene node.
- @param aiScene The assimp scene.
- @param path The path to the scene file to load.
- @return A new scene node.
+/**
+ Configures an import with the import options, the resource resolver and the
+ memory mapping of the import settings, and makes the texture resolver of the
+ import context, which reads the textures through the file system of the
+ import.
+
+ @param import The import.
+ @param context The import context, which outlives the import.
+ @return YES if the import was configured, NO if the import options are not
+ valid.
  */
-- (SCNNode *)makeSCNNodeFromAssimpNode:(const struct aiNode *)aiNode
-                               inScene:(const struct aiScene *)aiScene
-                                atPath:(NSString *)path
-							imageCache:(AssimpImageCache *)imageCache
+- (BOOL)configureImport:(AKImport *)import
+                context:(AssimpImportContext *)context
 {
-    const struct aiString *aiNodeName = &aiNode->mName;
-    if (aiNodeName == NULL) {
-        return nil;
+    AKImportOptions options =
+        [self makeImportOptionsForSettings:context.settings];
+    if (!AKImportSetOptions(import, &options))
+    {
+        return NO;
     }
-    
-    SCNNode *node = [[SCNNode alloc] init];
-    node.name = [NSString stringWithUTF8String:aiNodeName->data];
-    DLog(@" Creating node %@ with %d meshes", node.name, aiNode->mNumMeshes);
-    int nVertices = [self findNumVerticesInNode:aiNode inScene:aiScene];
-    DLog(@" N VERTICES: %@", @(nVertices));
-    if (nVertices > 0)
+    AKFileSystem *fs = AKImportFileSystem(import);
+    if (context.settings.resourceResolver != nil)
     {
-        node.geometry = [self makeSCNGeometryFromAssimpNode:aiNode
-                                                    inScene:aiScene
-                                               withVertices:nVertices
-                                                     atPath:path
-												 imageCache:imageCache];
+        AKFileSystemSetResolver(fs, resolveImportFile,
+                                (__bridge void *)context);
     }
-    // node.light = [self makeSCNLightFromAssimpNode:aiNode inScene:aiScene];
-    node.camera = [self makeSCNCameraFromAssimpNode:aiNode inScene:aiScene];
-    [self.boneNames
-        addObjectsFromArray:[self getBoneNamesForAssimpNode:aiNode
-                                                    inScene:aiScene]];
-    [self.boneTransforms
-        addEntriesFromDictionary:[self getBoneTransformsForAssimpNode:aiNode
-                                                              inScene:aiScene]];
+    AKFileSystemSetMapsFiles(fs, context.settings.mapsFiles ? 1 : 0);
+    context.textureResolver = ^NSData *(NSString *name) {
+        AKFile *file = AKFileSystemOpenReference(fs, name.UTF8String);
+        if (file == NULL)
+        {
+            return nil;
+        }
+        // the image source may decode the texture after the import is
+        // released, which unmaps its files, so the bytes are copied
+        NSMutableData *data = [NSMutableData dataWithLength:AKFileSize(file)];
+        data.length = AKFileRead(file, data.mutableBytes, data.length);
+        AKFileClose(file);
+        return data;
+    };
+    return YES;
+}
 
-    // ---------
-    // TRANSFORM
-    // ---------
-    const struct aiMatrix4x4 aiNodeMatrix = aiNode->mTransformation;
-    GLKMatrix4 glkNodeMatrix = GLKMatrix4Make(
-        aiNodeMatrix.a1, aiNodeMatrix.b1, aiNodeMatrix.c1, aiNodeMatrix.d1,
-        aiNodeMatrix.a2, aiNodeMatrix.b2, aiNodeMatrix.c2, aiNodeMatrix.d2,
-        aiNodeMatrix.a3, aiNodeMatrix.b3, aiNodeMatrix.c3, aiNodeMatrix.d3,
-        aiNodeMatrix.a4, aiNodeMatrix.b4, aiNodeMatrix.c4, aiNodeMatrix.d4);
+/**
+ Makes the scene of an import, or the error of an import which failed, and
+ releases the import.
 
-    SCNMatrix4 scnMatrix = SCNMatrix4FromGLKMatrix4(glkNodeMatrix);
-    node.transform = scnMatrix;
-    DLog(@" Node %@ position %f %f %f", node.name, aiNodeMatrix.a4,
-         aiNodeMatrix.b4, aiNodeMatrix.c4);
+ @param import The import.
+ @param aiScene The scene read by the import, or NULL if the read failed.
+ @param path The path to the scene file.
+ @param context The import context.
+ @param error Scene import error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
+- (SCNAssimpScene *)makeSceneFromImport:(AKImport *)import
+                                aiScene:(const struct aiScene *)aiScene
+                                 atPath:(NSString *)path
+                                context:(AssimpImportContext *)context
+                                  error:(NSError **)error
+{
+    // If the import failed, report it
+    if (!aiScene)
+    {
+        NSString *errorString =
+            [NSString stringWithUTF8String:AKImportErrorString(import)];
+        ALog(@" Scene importing failed for filePath %@", path);
+        ALog(@" Scene importing failed with error %@", errorString);
+        AKImportRelease(import);
 
-    for (int i = 0; i < aiNode->mNumChildren; i++)
+        // Return error
+        if (error) {
+            *error = AKProgressIsCancelled(context.progress)
+                         ? [self makeCancelledError]
+                         : [NSError
+                               errorWithDomain:@"AssimpImporter"
+                                          code:-1
+                                      userInfo:@{
+                                          NSLocalizedDescriptionKey :
+                                              errorString
+                                      }];
+        }
+        
+        return nil;
+    }
+    // the conversion adds its phases to the phases of the read, and charges
+    // the buffers of the core to the memory account of the import
+    AKMemoryAccount *previousAccount = NULL;
+    if (context.importStats != NULL)
     {
-        const struct aiNode *aiChildNode = aiNode->mChildren[i];
-        SCNNode *childNode = [self makeSCNNodeFromAssimpNode:aiChildNode
-                                                     inScene:aiScene
-                                                      atPath:path
-												  imageCache:imageCache];
-        [node addChildNode:childNode];
+        *context.importStats = AKImportGetStats(import);
+        context.memoryAccount = AKImportMemoryAccount(import);
+        previousAccount = AKMemoryAccountMakeCurrent(context.memoryAccount);
     }
-    return node;
+    // Now we can access the file's contents
+    SCNAssimpScene *scene = [self makeSCNSceneFromAssimpScene:aiScene
+                                                       atPath:path
+                                                      context:context];
+    if (context.memoryAccount != NULL)
+    {
+        AKMemoryAccountMakeCurrent(previousAccount);
+    }
+    if (scene != nil)
+    {
+        [self makeImportStats:scene.importStats
+                    forImport:import
+                      context:context];
+    }
+    // the archive lists every other file the loaders looked for on the
+    // disk, so that it is stale once a side file changes, while the scene
+    // file is covered by the key; a scene read from files of the resource
+    // resolver is not stored, as they cannot be checked
+    AKFileSystem *fs = AKImportFileSystem(import);
+    if (scene != nil && context.archiveWriter != NULL &&
+        AKFileSystemGetStats(fs).nResolved == 0)
+    {
+        const char *scenePath = path.UTF8String;
+        for (size_t i = 0; i < AKFileSystemDiskPathCount(fs); i++)
+        {
+            const char *diskPath = AKFileSystemDiskPath(fs, i);
+            if (strcmp(diskPath, scenePath) != 0)
+            {
+                AKSceneArchiveWriterAddDependency(context.archiveWriter,
+                                                  diskPath);
+            }
+        }
+        AKSceneCacheStore(context.settings.sceneCache.coreCache,
+                          context.archiveKey, context.archiveWriter);
+    }
+    AKSceneArchiveWriterRelease(context.archiveWriter);
+    context.archiveWriter = NULL;
+    // the memory account is released with the import
+    context.memoryAccount = NULL;
+    // We're done. Release all resources associated with this import
+    AKImportRelease(import);
+    if (scene == nil && error)
+    {
+        *error = [self makeCancelledError];
+    }
+    return scene;
 }
 
-#pragma mark - Find the number of vertices, faces and indices of a geometry
-
-/**
- @name Find the number of vertices, faces and indices of a geometry
- */
-
 /**
- Finds the total number of vertices in the meshes of the specified node.
-
- @param aiNode The assimp scene node.
- @param aiScene The assimp scene.
- @return The number of vertices.
+ Fills the import stats of a scene with the files read by the file system of
+ its import and, if the settings measure the import, with the measurements of
+ the import context.
+
+ @param stats The import stats of the scene.
+ @param import The import, or NULL if the scene was loaded from the scene
+ cache.
+ @param context The import context.
  */
-- (int)findNumVerticesInNode:(const struct aiNode *)aiNode
-                     inScene:(const struct aiScene *)aiScene
+- (void)makeImportStats:(SCNAssimpImportStats *)stats
+              forImport:(AKImport *)import
+                context:(AssimpImportContext *)context
 {
-    int nVertices = 0;
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    AKImportStats importStats = AKImportStatsMakeEmpty();
+    if (context.importStats != NULL)
     {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        nVertices += aiMesh->mNumVertices;
+        importStats = *context.importStats;
+        importStats.nTexturesDecoded = context.imageCache.storedImageCount;
+        importStats.nTexturesCached = context.imageCache.cachedImageCount;
+        // the size of the scene was estimated before the conversion
+        size_t sceneBytes = importStats.memory.sceneBytes;
+        AKMemoryAccountAddTextureBytes(context.memoryAccount,
+                                       context.imageCache.storedImageBytes);
+        importStats.memory = AKMemoryAccountGetStats(context.memoryAccount);
+        importStats.memory.sceneBytes = sceneBytes;
+    }
+    if (import != NULL)
+    {
+        importStats.files = AKFileSystemGetStats(AKImportFileSystem(import));
+    }
+    const AKFileSystemStats *fsStats = &importStats.files;
+    stats.fileOpens = fsStats->nOpens;
+    stats.diskFileOpens = fsStats->nDiskOpens;
+    stats.cachedFileOpens = fsStats->nCachedOpens;
+    stats.readAheads = fsStats->nReadAheads;
+    stats.reads = fsStats->nReads;
+    stats.bytesRead = fsStats->bytesRead;
+    stats.ioTime = fsStats->ioSeconds;
+
+    const double *seconds = importStats.phaseSeconds;
+    stats.parseTime = seconds[AKImportPhaseParse];
+    stats.postProcessTime = seconds[AKImportPhasePostProcess];
+    stats.geometryTime = seconds[AKImportPhaseGeometry];
+    stats.materialsTime = seconds[AKImportPhaseMaterials];
+    stats.texturesTime = seconds[AKImportPhaseTextures];
+    stats.skinTime = seconds[AKImportPhaseSkin];
+    stats.animationsTime = seconds[AKImportPhaseAnimations];
+
+    stats.nodes = importStats.nNodes;
+    stats.meshes = importStats.nMeshes;
+    stats.bones = importStats.nBones;
+    stats.keyframes = importStats.nKeyframes;
+    stats.vertices = importStats.nVertices;
+    stats.indices = importStats.nIndices;
+    stats.texturesDecoded = importStats.nTexturesDecoded;
+    stats.texturesCached = importStats.nTexturesCached;
+
+    const unsigned long *bytes = importStats.attributeBytes;
+    stats.positionBytes = bytes[AKVertexAttributePosition];
+    stats.normalBytes = bytes[AKVertexAttributeNormal];
+    stats.tangentBytes = bytes[AKVertexAttributeTangent];
+    stats.texCoordBytes = bytes[AKVertexAttributeTexCoord];
+    stats.colorBytes = bytes[AKVertexAttributeColor];
+    stats.indexBytes = importStats.indexBytes;
+
+    const AKMemoryStats *memory = &importStats.memory;
+    for (int i = 0; i < AKImportPhaseCount; i++)
+    {
+        SCNAssimpPhaseMemory *phaseMemory = [stats memoryOfPhase:i];
+        phaseMemory.bytesAllocated = memory->phases[i].bytesAllocated;
+        phaseMemory.bytesRetained = memory->phases[i].bytesRetained;
+        phaseMemory.peakBytes = memory->phases[i].peakBytes;
+        phaseMemory.footprintBytes = memory->phases[i].footprintBytes;
     }
-    return nVertices;
+    stats.peakMemoryBytes = memory->peakBytes;
+    stats.peakFootprintBytes = memory->peakFootprintBytes;
+    stats.textureMemoryBytes = memory->textureBytes;
+    stats.sceneMemoryBytes = memory->sceneBytes;
 }
 
 /**
- Finds the total number of faces in the meshes of the specified node.
+ Creates the options of the assimp importer from the import settings.
 
- @param aiNode The assimp scene node.
- @param aiScene The assimp scene.
- @return The number of faces.
+ @param settings The import settings, or nil for the default settings.
+ @return The import options.
  */
-- (int)findNumFacesInNode:(const struct aiNode *)aiNode
-                  inScene:(const struct aiScene *)aiScene
+- (AKImportOptions)makeImportOptionsForSettings:
+    (SCNAssimpImportSettings *)settings
 {
-    int nFaces = 0;
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    AKImportOptions options = AKImportOptionsMakeDefault();
+    if (settings == nil)
     {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        nFaces += aiMesh->mNumFaces;
+        return options;
     }
-    return nFaces;
+    options.splitVertexLimit = (unsigned int)settings.meshSplitVertexLimit;
+    options.splitTriangleLimit = (unsigned int)settings.meshSplitTriangleLimit;
+    options.maxBoneWeights = (unsigned int)settings.maxBoneWeightsPerVertex;
+    options.vertexCacheSize = (unsigned int)settings.vertexCacheSize;
+    options.maxSmoothingAngle = settings.maxSmoothingAngle;
+    options.favourSpeed = settings.favoursSpeed ? 1 : 0;
+    // the components have the values of the core components
+    options.components = (unsigned int)settings.components;
+    return options;
 }
 
 /**
- Finds the total number of indices in the specified mesh by index.
+ Makes the error of a cancelled import.
 
- @param aiMeshIndex The assimp mesh index.
- @param aiScene The assimp scene.
- @return The total number of indices.
+ @return The NSUserCancelledError error in NSCocoaErrorDomain.
  */
-- (int)findNumIndicesInMesh:(int)aiMeshIndex
-                    inScene:(const struct aiScene *)aiScene
+- (NSError *)makeCancelledError
 {
-    int nIndices = 0;
-    const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-    for (int j = 0; j < aiMesh->mNumFaces; j++)
-    {
-        const struct aiFace *aiFace = &aiMesh->mFaces[j];
-        nIndices += aiFace->mNumIndices;
-    }
-    return nIndices;
+    return [NSError
+        errorWithDomain:NSCocoaErrorDomain
+                   code:NSUserCancelledError
+               userInfo:@{
+                   NSLocalizedDescriptionKey : @"The import was cancelled"
+               }];
 }
 
-#pragma mark - Make scenekit geometry sources
+#pragma mark - Loading a scene from the scene cache
 
 /**
- @name Make scenekit geometry sources
+ @name Loading a scene from the scene cache
  */
 
 /**
- Creates a scenekit geometry source from the vertices of the specified node.
+ Makes the key of a scene file in the scene cache, from the bytes of the file,
+ the post processing flags and the settings which the converted scene depends
+ on, and sets it as the archive key of the import context.
 
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @param nVertices The total number of vertices in the meshes of the aiNode.
- @return A new geometry source whose semantic property is vertex.
+ @param path The path to the scene file.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param context The import context.
+ @return YES if the key was made, NO if the file could not be read.
  */
-- (SCNGeometrySource *)
-makeVertexGeometrySourceForNode:(const struct aiNode *)aiNode
-                        inScene:(const struct aiScene *)aiScene
-                  withNVertices:(int)nVertices
+- (BOOL)makeArchiveKeyForFile:(const char *)path
+             postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                      context:(AssimpImportContext *)context
 {
-        //float scnVertices[nVertices * 3];
-    float* scnVertices = (float*)malloc(nVertices * 3 * sizeof(float));
-    int verticesCounter = 0;
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    SCNAssimpImportSettings *settings = context.settings;
+    unsigned long long key = AKSceneCacheKeyMake();
+    if (!AKSceneCacheKeyAddFile(&key, path))
     {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        // create SCNGeometry source for aiMesh vertices, normals, texture
-        // coordinates
-        for (int j = 0; j < aiMesh->mNumVertices; j++)
-        {
-            const struct aiVector3D *aiVector3D = &aiMesh->mVertices[j];
-            scnVertices[verticesCounter++] = aiVector3D->x;
-            scnVertices[verticesCounter++] = aiVector3D->y;
-            scnVertices[verticesCounter++] = aiVector3D->z;
-        }
+        return NO;
     }
-    SCNGeometrySource *vertexSource = [SCNGeometrySource
-        geometrySourceWithData:[NSData
-                                   dataWithBytes:scnVertices
-                                          length:nVertices * 3 * sizeof(float)]
-                      semantic:SCNGeometrySourceSemanticVertex
-                   vectorCount:nVertices
-               floatComponents:YES
-           componentsPerVector:3
-             bytesPerComponent:sizeof(float)
-                    dataOffset:0
-                    dataStride:3 * sizeof(float)];
-    free(scnVertices);
-    return vertexSource;
+    unsigned int flags = (unsigned int)postProcessFlags;
+    key = AKSceneCacheKeyAdd(key, &flags, sizeof(flags));
+    AKImportOptions options = [self makeImportOptionsForSettings:settings];
+    key = AKSceneCacheKeyAddOptions(key, &options);
+    unsigned long long split[2] = {
+        settings.splitsLargeGeometries ? 1 : 0,
+        settings.splitsLargeGeometries ? settings.maxVerticesPerGeometry : 0};
+    key = AKSceneCacheKeyAdd(key, split, sizeof(split));
+    AKVertexLayout layout = [self makeVertexLayoutForSettings:settings];
+    context.archiveKey = AKSceneCacheKeyAdd(key, &layout, sizeof(layout));
+    return YES;
 }
 
 /**
- Creates a scenekit geometry source from the normals of the specified node.
-
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @param nVertices The number of vertices in the meshes of the aiNode.
- @return A new geometry source whose semantic property is normal.
+ Makes the scene of an import from the archive of the scene in the scene
+ cache or from a compiled scene asset, and releases the archive once no
+ geometry uses it.
+
+ The scene is the same as the scene converted from the file. The vertices,
+ the indices and the bone weights of the geometries are read in place from
+ the mapped archive, so their pages are only read once scenekit uses them.
+ The textures which are files are read from the resource resolver of the
+ settings or from the disk, as they are not kept in the archive.
+
+ @param archive The archive of the scene.
+ @param path The path to the scene file.
+ @param fromCache YES if the archive is from the scene cache.
+ @param context The import context.
+ @param error Scene import error.
+ @return A new scene object, or nil if the import was cancelled.
  */
-- (SCNGeometrySource *)
-makeNormalGeometrySourceForNode:(const struct aiNode *)aiNode
-                        inScene:(const struct aiScene *)aiScene
-                  withNVertices:(int)nVertices
+- (SCNAssimpScene *)makeSceneFromArchive:(AKSceneArchive *)archive
+                                  atPath:(NSString *)path
+                               fromCache:(BOOL)fromCache
+                                 context:(AssimpImportContext *)context
+                                   error:(NSError **)error
 {
-    float* scnNormals = (float*)malloc(nVertices * 3 * sizeof(float));
-    int verticesCounter = 0;
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    // the geometries read in place keep the mapped archive, which is unmapped
+    // once the last of them is released
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    context.archiveData = [[NSData alloc]
+        initWithBytesNoCopy:(void *)header
+                     length:(NSUInteger)header->fileBytes
+                deallocator:^(void *bytes, NSUInteger length) {
+                  AKSceneArchiveRelease(archive);
+                }];
+    // the buffers made from the archive are charged to a memory account of
+    // their own, as there is no assimp import
+    AKMemoryAccount *previousAccount = NULL;
+    if (context.importStats != NULL)
     {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        if (aiMesh->mNormals != NULL)
-        {
-            for (int j = 0; j < aiMesh->mNumVertices; j++)
-            {
-                const struct aiVector3D *aiVector3D = &aiMesh->mNormals[j];
-                scnNormals[verticesCounter++] = aiVector3D->x;
-                scnNormals[verticesCounter++] = aiVector3D->y;
-                scnNormals[verticesCounter++] = aiVector3D->z;
-            }
-        }
+        context.memoryAccount = AKMemoryAccountCreate();
+        previousAccount = AKMemoryAccountMakeCurrent(context.memoryAccount);
     }
-    SCNGeometrySource *normalSource = [SCNGeometrySource
-        geometrySourceWithData:[NSData
-                                   dataWithBytes:scnNormals
-                                          length:nVertices * 3 * sizeof(float)]
-                      semantic:SCNGeometrySourceSemanticNormal
-                   vectorCount:nVertices
-               floatComponents:YES
-           componentsPerVector:3
-             bytesPerComponent:sizeof(float)
-                    dataOffset:0
-                    dataStride:3 * sizeof(float)];
-    free(scnNormals);
-    return normalSource;
+    context.textureResolver = context.settings.resourceResolver;
+    SCNAssimpScene *scene = [self makeSCNSceneFromArchive:archive
+                                                   atPath:path
+                                                  context:context];
+    if (context.memoryAccount != NULL)
+    {
+        AKMemoryAccountMakeCurrent(previousAccount);
+    }
+    context.archiveData = nil;
+    if (scene != nil)
+    {
+        scene.importStats.loadedFromCache = fromCache;
+        [self makeImportStats:scene.importStats forImport:NULL context:context];
+    }
+    AKMemoryAccountRelease(context.memoryAccount);
+    context.memoryAccount = NULL;
+    if (scene == nil && error)
+    {
+        *error = [self makeCancelledError];
+    }
+    return scene;
 }
 
+#pragma mark - Loading a compiled scene asset
+
 /**
- Creates a scenekit geometry source from the tangents of the specified node.
+ @name Loading a compiled scene asset
+ */
 
-@param aiNode The assimp node.
-@param aiScene The assimp scene.
-@param nVertices The number of vertices in the meshes of the aiNode.
-@return A new geometry source whose semantic property is tangent.
-*/
-- (SCNGeometrySource *)
-makeTangentGeometrySourceForNode:(const struct aiNode *)aiNode
-inScene:(const struct aiScene *)aiScene
-withNVertices:(int)nVertices
+/**
+ Makes the scene of an import from a scene asset compiled ahead of time, a
+ scene archive file of any key.
+
+ The asset was converted with the post processing flags and the settings it
+ was compiled with, so only the components of the settings apply to it. Its
+ textures which are files are read relative to the directory of the asset.
+
+ @param path The path to the scene asset.
+ @param context The import context.
+ @param error Scene import error.
+ @return A new scene object, or nil if the file is not a scene asset or the
+ import was cancelled.
+ */
+- (SCNAssimpScene *)makeSceneFromAssetFile:(NSString *)path
+                                   context:(AssimpImportContext *)context
+                                     error:(NSError **)error
 {
-    float* scnTangents = (float*)malloc(nVertices * 3 * sizeof(float));
-    int verticesCounter = 0;
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    AKSceneArchive *archive = AKSceneArchiveOpenFile(path.UTF8String);
+    if (archive == NULL)
     {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        if (aiMesh->mTangents != NULL)
+        ALog(@" Scene asset loading failed for filePath %@", path);
+        if (error)
         {
-            for (int j = 0; j < aiMesh->mNumVertices; j++)
+            *error = [NSError
+                errorWithDomain:@"AssimpImporter"
+                           code:-1
+                       userInfo:@{
+                           NSLocalizedDescriptionKey :
+                               @"The file is not a scene asset of this version"
+                       }];
+        }
+        return nil;
+    }
+    return [self makeSceneFromArchive:archive
+                               atPath:path
+                            fromCache:NO
+                              context:context
+                                error:error];
+}
+
+#pragma mark - Loading a scene asynchronously
+
+/**
+ @name Loading a scene asynchronously
+ */
+
+/**
+ Returns the concurrent queue on which the asynchronous imports parse the
+ files and convert the assimp scenes.
+
+ Imports on this queue run at the same time, as each import keeps its state
+ and its assimp error in its own context, so one importer can serve any
+ number of imports.
+
+ @return The conversion queue shared by all importers.
+ */
++ (dispatch_queue_t)conversionQueue
+{
+    static dispatch_queue_t conversionQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(
+          DISPATCH_QUEUE_CONCURRENT, QOS_CLASS_USER_INITIATED, 0);
+      conversionQueue =
+          dispatch_queue_create("com.assimpkit.conversion", attributes);
+    });
+    return conversionQueue;
+}
+
+/**
+ Loads a scene from the specified file path with the specified import
+ settings, without blocking the calling thread.
+
+ The file is parsed and converted on the conversion queue. The importer is
+ retained until the completion handler has been called.
+
+ @param filePath The path to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param queue The queue on which to call the completion handler, or nil for
+ the main queue.
+ @param completionHandler The block which receives the new scene object, or
+ nil and the import error if no scene could be loaded.
+ */
+- (void)importScene:(NSString *)filePath
+     postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+             settings:(SCNAssimpImportSettings *)settings
+      completionQueue:(dispatch_queue_t)queue
+    completionHandler:(SCNAssimpSceneCompletionHandler)completionHandler
+{
+    [self importScene:filePath
+         postProcessFlags:postProcessFlags
+                 settings:settings
+                 progress:nil
+          completionQueue:queue
+        completionHandler:completionHandler];
+}
+
+/**
+ Loads a scene from the specified file path with the specified import
+ settings, reporting the progress of the import, without blocking the calling
+ thread.
+
+ The import can be cancelled while it waits on the conversion queue and while
+ it runs. A cancelled import calls the completion handler with the error
+ NSUserCancelledError in NSCocoaErrorDomain.
+
+ @param filePath The path to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param progress The progress of the import, or nil.
+ @param queue The queue on which to call the completion handler, or nil for
+ the main queue.
+ @param completionHandler The block which receives the new scene object, or
+ nil and the import error if no scene could be loaded.
+ */
+- (void)importScene:(NSString *)filePath
+     postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+             settings:(SCNAssimpImportSettings *)settings
+             progress:(SCNAssimpImportProgress *)progress
+      completionQueue:(dispatch_queue_t)queue
+    completionHandler:(SCNAssimpSceneCompletionHandler)completionHandler
+{
+    NSParameterAssert(completionHandler != nil);
+    dispatch_queue_t completionQueue =
+        queue != nil ? queue : dispatch_get_main_queue();
+    // the settings may be changed by the caller while the import waits
+    SCNAssimpImportSettings *importSettings = [settings copy];
+    dispatch_async([AssimpImporter conversionQueue], ^{
+      NSError *error = nil;
+      SCNAssimpScene *scene = [self importScene:filePath
+                               postProcessFlags:postProcessFlags
+                                       settings:importSettings
+                                       progress:progress
+                                          error:&error];
+      dispatch_async(completionQueue, ^{
+        completionHandler(scene, scene != nil ? nil : error);
+      });
+    });
+}
+
+#pragma mark - Loading scenes in a batch
+
+/**
+ @name Loading scenes in a batch
+ */
+
+/**
+ Imports a scene file of a batch on a worker of the work pool.
+
+ @param context The block which imports a scene file of the batch.
+ @param item The index of the scene file in the batch.
+ @param worker The index of the worker.
+ */
+static void importBatchItem(void *context, size_t item, unsigned int worker)
+{
+    @autoreleasepool
+    {
+        void (^importItem)(NSUInteger) =
+            (__bridge void (^)(NSUInteger))context;
+        importItem((NSUInteger)item);
+    }
+}
+
+/**
+ Loads the scenes from the specified file URLs with the specified import
+ settings on a pool of workers, without blocking the calling thread.
+
+ Each worker starts with its own share of the files, the largest first, and
+ steals files from the other workers once it runs out, so that every worker
+ stays busy until the whole batch is loaded. The files imported at the same
+ time are never larger in total than maxBytesInFlight, which bounds the peak
+ memory of the batch, except for a file larger than maxBytesInFlight which is
+ imported on its own.
+
+ The scene handler receives each scene as its import completes, and the
+ completion handler receives all the scenes in the order of the URLs once the
+ batch is loaded. Both are called on the completion queue, and if the queue is
+ serial, every scene handler is called before the completion handler.
+
+ @param urls The file URLs of the scene files to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param nWorkers The number of scenes imported at the same time, or 0 for one
+ per processor.
+ @param maxBytesInFlight The largest total size of the files imported at the
+ same time, or 0 for no limit.
+ @param queue The queue on which to call the handlers, or nil for the main
+ queue.
+ @param sceneHandler The block which receives each scene as it is loaded, or
+ nil.
+ @param completionHandler The block which receives the scenes and the errors
+ in the order of the URLs.
+ */
+- (void)importScenesAtURLs:(NSArray *)urls
+          postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                  settings:(SCNAssimpImportSettings *)settings
+                   workers:(NSUInteger)nWorkers
+          maxBytesInFlight:(unsigned long long)maxBytesInFlight
+           completionQueue:(dispatch_queue_t)queue
+              sceneHandler:(SCNAssimpBatchSceneHandler)sceneHandler
+         completionHandler:(SCNAssimpBatchCompletionHandler)completionHandler
+{
+    NSParameterAssert(completionHandler != nil);
+    dispatch_queue_t completionQueue =
+        queue != nil ? queue : dispatch_get_main_queue();
+    // the settings and urls may be changed by the caller while the batch waits
+    SCNAssimpImportSettings *importSettings =
+        settings != nil ? [settings copy]
+                        : [[SCNAssimpImportSettings alloc] init];
+    // the files are already imported in parallel
+    if (importSettings.conversionWorkers == 0)
+    {
+        importSettings.conversionWorkers = 1;
+    }
+    NSArray *batchURLs = [urls copy];
+    dispatch_async([AssimpImporter conversionQueue], ^{
+      NSUInteger nFiles = batchURLs.count;
+      NSMutableArray *scenes = [[NSMutableArray alloc] initWithCapacity:nFiles];
+      NSMutableArray *errors = [[NSMutableArray alloc] initWithCapacity:nFiles];
+      // the size of each file is its cost in the work pool
+      size_t *costs = (size_t *)calloc(nFiles > 0 ? nFiles : 1, sizeof(size_t));
+      for (NSUInteger i = 0; i < nFiles; i++)
+      {
+          [scenes addObject:[NSNull null]];
+          [errors addObject:[NSNull null]];
+          NSNumber *fileSize = nil;
+          [[batchURLs objectAtIndex:i] getResourceValue:&fileSize
+                                                 forKey:NSURLFileSizeKey
+                                                  error:nil];
+          costs[i] = (size_t)MAX(fileSize.unsignedLongLongValue, 1);
+      }
+      void (^importItem)(NSUInteger) = ^(NSUInteger i) {
+        NSError *error = nil;
+        SCNAssimpScene *scene =
+            [self importScene:[[batchURLs objectAtIndex:i] path]
+                postProcessFlags:postProcessFlags
+                        settings:importSettings
+                           error:&error];
+        @synchronized(scenes)
+        {
+            if (scene != nil)
             {
-                const struct aiVector3D *aiVector3D = &aiMesh->mTangents[j];
-                scnTangents[verticesCounter++] = aiVector3D->x;
-                scnTangents[verticesCounter++] = aiVector3D->y;
-                scnTangents[verticesCounter++] = aiVector3D->z;
+                [scenes replaceObjectAtIndex:i withObject:scene];
             }
+            else if (error != nil)
+            {
+                [errors replaceObjectAtIndex:i withObject:error];
+            }
+        }
+        if (sceneHandler != nil)
+        {
+            dispatch_async(completionQueue, ^{
+              sceneHandler(i, scene, scene != nil ? nil : error);
+            });
+        }
+      };
+      AKWorkPool *pool = AKWorkPoolCreate((unsigned int)nWorkers,
+                                          (size_t)maxBytesInFlight);
+      AKWorkPoolRun(pool, nFiles, costs, importBatchItem,
+                    (__bridge void *)importItem);
+      AKWorkPoolRelease(pool);
+      free(costs);
+      dispatch_async(completionQueue, ^{
+        completionHandler(scenes, errors);
+      });
+    });
+}
+
+#pragma mark - Make scenekit scene
+
+/**
+ @name Make scenekit scene
+ */
+
+/**
+ Creates a scenekit scene from the scene representing the file at a given path.
+
+ @param aiScene The assimp scene.
+ @param path The path to the scene file to load.
+ @param context The context of the import.
+ @return A new scene object, or nil if the import was cancelled.
+ */
+- (SCNAssimpScene *)makeSCNSceneFromAssimpScene:(const struct aiScene *)aiScene
+                                         atPath:(NSString *)path
+                                        context:(AssimpImportContext *)context
+{
+    DLog(@" Make an SCNScene");
+    const struct aiNode *aiRootNode = aiScene->mRootNode;
+    SCNAssimpScene *scene = [[SCNAssimpScene alloc] init];
+    context.quantizationReport = scene.quantizationReport;
+    context.sceneStats = AKSceneStatsCreate(aiScene);
+    [self setProgressTotalsForScene:aiScene context:context];
+    AKMemoryAccountSetPhase(context.memoryAccount, AKImportPhaseGeometry);
+    double start = [context startTiming];
+    // the animation scenes are made with the skeleton found from the bones
+    BOOL skins = [context importsComponents:SCNAssimpImportComponentSkinning];
+    BOOL animates =
+        [context importsComponents:SCNAssimpImportComponentAnimations];
+    /*
+   ---------------------------------------------------------------------
+   Convert the geometry of every node in parallel into its slot, or of
+   each node when it is made if the scene is trimmed as it is converted
+   ---------------------------------------------------------------------
+   */
+    if (context.settings.minimizesPeakMemory)
+    {
+        context.sceneTrim = AKSceneTrimCreate(aiScene);
+        if (skins)
+        {
+            // the bone weights are made with the geometry of each node
+            context.bonePalette = AKBonePaletteCreate(aiScene);
         }
     }
-    SCNGeometrySource *tangentSource = [SCNGeometrySource
-        geometrySourceWithData:[NSData
-                                   dataWithBytes:scnTangents
-                                          length:nVertices * 3 * sizeof(float)]
-                      semantic:SCNGeometrySourceSemanticTangent
-                   vectorCount:nVertices
-               floatComponents:YES
-           componentsPerVector:3
-             bytesPerComponent:sizeof(float)
-                    dataOffset:0
-                    dataStride:3 * sizeof(float)];
-    free(scnTangents);
-    return tangentSource;
+    else if ([context importsComponents:SCNAssimpImportComponentGeometry])
+    {
+        AKVertexLayout layout =
+            [self makeVertexLayoutForSettings:context.settings];
+        AKWorkPool *pool = AKWorkPoolCreate(
+            (unsigned int)context.settings.conversionWorkers, 0);
+        context.sceneGeometry = AKSceneGeometryCreate(
+            aiScene, &layout, context.sceneStats, context.progress, pool);
+        AKWorkPoolRelease(pool);
+    }
+    /*
+   -------------------------------------------------------------------
+   Assign geometry, materials, lights and cameras to the node
+   ---------------------------------------------------------------------
+   */
+    SCNNode *scnRootNode = [self makeSCNNodeFromAssimpNode:aiRootNode
+                                                   inScene:aiScene
+                                                    atPath:path
+                                                   context:context];
+    if (scnRootNode != nil)
+    {
+        [scene.rootNode addChildNode:scnRootNode];
+    }
+    scene.nodeIndex = context.nodeIndex;
+    AKSceneGeometryRelease(context.sceneGeometry);
+    context.sceneGeometry = NULL;
+    // every material is made, with its embedded textures decoded
+    AKSceneTrimTextures(context.sceneTrim);
+    start = [context addTimeSince:start toPhase:AKImportPhaseGeometry];
+    AKImportStats *stats = context.importStats;
+    if (stats != NULL)
+    {
+        // the nodes were timed with their materials, and the materials with
+        // their textures
+        double *seconds = stats->phaseSeconds;
+        seconds[AKImportPhaseGeometry] -= seconds[AKImportPhaseMaterials];
+        seconds[AKImportPhaseMaterials] -= seconds[AKImportPhaseTextures];
+    }
+    /*
+   ---------------------------------------------------------------------
+   Animations and skinning
+   ---------------------------------------------------------------------
+   */
+    if (AKProgressCompletePhase(context.progress, AKImportPhaseGeometry) &&
+        AKProgressCompletePhase(context.progress, AKImportPhaseMaterials) &&
+        AKProgressCompletePhase(context.progress, AKImportPhaseTextures) &&
+        (skins || animates))
+    {
+        AKMemoryAccountSetPhase(context.memoryAccount, AKImportPhaseSkin);
+        if (context.bonePalette == NULL)
+        {
+            context.bonePalette = AKBonePaletteCreate(aiScene);
+        }
+        [self buildSkeletonDatabaseForScene:scene context:context];
+        if (skins)
+        {
+            [self makeSkinnerForAssimpNode:aiRootNode
+                                   inScene:aiScene
+                                  scnScene:scene
+                                   context:context];
+        }
+        AKBonePaletteRelease(context.bonePalette);
+        context.bonePalette = NULL;
+    }
+    start = [context addTimeSince:start toPhase:AKImportPhaseSkin];
+    AKSceneStatsRelease(context.sceneStats);
+    context.sceneStats = NULL;
+    // the node maps refer to the assimp nodes which are released after this
+    context.scnNodes = nil;
+    context.nodeDepths = nil;
+    context.geometryChunks = nil;
+    [context.boneSources removeAllObjects];
+    if (AKProgressCompletePhase(context.progress, AKImportPhaseSkin) &&
+        animates)
+    {
+        AKMemoryAccountSetPhase(context.memoryAccount,
+                                AKImportPhaseAnimations);
+        [self createAnimationsFromScene:aiScene
+                              withScene:scene
+                                 atPath:path
+                                context:context];
+    }
+    AKSceneTrimRelease(context.sceneTrim);
+    context.sceneTrim = NULL;
+    start = [context addTimeSince:start toPhase:AKImportPhaseAnimations];
+    if (!AKProgressCompletePhase(context.progress, AKImportPhaseAnimations))
+    {
+        DLog(@" The import was cancelled, releasing the partial scene");
+        return nil;
+    }
+    /*
+     ---------------------------------------------------------------------
+     Make SCNScene for model and animations
+     ---------------------------------------------------------------------
+     */
+    [scene makeModelScene];
+    start = [context addTimeSince:start toPhase:AKImportPhaseGeometry];
+    [scene makeAnimationScenes];
+    [context addTimeSince:start toPhase:AKImportPhaseAnimations];
+
+    return scene;
 }
 
+/**
+ Creates a scenekit scene from the archive of a scene converted before.
+
+ The nodes are made in the order they were archived, each after its parent,
+ with the node geometries, the skins and the keyframe tracks read from the
+ archive, so that the scene is the same as the scene converted from the file.
+
+ @param archive The scene archive.
+ @param path The path to the scene file the archive was made from.
+ @param context The context of the import.
+ @return A new scene object, or nil if the import was cancelled.
+ */
+- (SCNAssimpScene *)makeSCNSceneFromArchive:(const AKSceneArchive *)archive
+                                     atPath:(NSString *)path
+                                    context:(AssimpImportContext *)context
+{
+    DLog(@" Make an SCNScene from the scene cache");
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    SCNAssimpScene *scene = [[SCNAssimpScene alloc] init];
+    context.quantizationReport = scene.quantizationReport;
+    // the file was read and post processed when the scene was converted
+    if (!AKProgressCompletePhase(context.progress, AKImportPhaseParse) ||
+        !AKProgressCompletePhase(context.progress, AKImportPhasePostProcess))
+    {
+        return nil;
+    }
+    AKMemoryAccountSetPhase(context.memoryAccount, AKImportPhaseGeometry);
+    double start = [context startTiming];
+    BOOL skins = [context importsComponents:SCNAssimpImportComponentSkinning];
+    BOOL animates =
+        [context importsComponents:SCNAssimpImportComponentAnimations];
+    /*
+   ---------------------------------------------------------------------
+   Make each node after its parent, with its geometry and camera
+   ---------------------------------------------------------------------
+   */
+    NSMutableArray *nodes =
+        [[NSMutableArray alloc] initWithCapacity:header->nNodes];
+    for (unsigned int i = 0; i < header->nNodes; i++)
+    {
+        const AKArchiveNode *archiveNode = AKSceneArchiveNodeAt(archive, i);
+        if (!AKProgressCheckpoint(context.progress))
+        {
+            return nil;
+        }
+        SCNNode *node = [self makeSCNNodeFromArchiveNode:archiveNode
+                                               inArchive:archive
+                                                  atPath:path
+                                                 context:context];
+        SCNNode *parentNode = archiveNode->parent != AKArchiveNone
+                                  ? [nodes objectAtIndex:archiveNode->parent]
+                                  : scene.rootNode;
+        [parentNode addChildNode:node];
+        [nodes addObject:node];
+        if ([context.nodeIndex objectForKey:node.name] == nil)
+        {
+            [context.nodeIndex setObject:node forKey:node.name];
+        }
+        int depth = [self findDepthOfNodeFromRoot:parentNode context:context];
+        [context.nodeDepths
+            setObject:[NSNumber numberWithInt:depth + 1]
+               forKey:[NSValue valueWithNonretainedObject:node]];
+    }
+    // the chunks of a node follow the children of the node
+    for (unsigned int i = 0; i < header->nNodes; i++)
+    {
+        const AKArchiveNode *archiveNode = AKSceneArchiveNodeAt(archive, i);
+        [self addChunkNodesToNode:[nodes objectAtIndex:i]
+                           forKey:[NSValue valueWithPointer:archiveNode]
+                          context:context];
+    }
+    scene.nodeIndex = context.nodeIndex;
+    start = [context addTimeSince:start toPhase:AKImportPhaseGeometry];
+    AKImportStats *stats = context.importStats;
+    if (stats != NULL)
+    {
+        // the nodes were timed with their materials, and the materials with
+        // their textures
+        double *seconds = stats->phaseSeconds;
+        seconds[AKImportPhaseGeometry] -= seconds[AKImportPhaseMaterials];
+        seconds[AKImportPhaseMaterials] -= seconds[AKImportPhaseTextures];
+    }
+    /*
+   ---------------------------------------------------------------------
+   Skinning, with the bones of the archive
+   ---------------------------------------------------------------------
+   */
+    if (AKProgressCompletePhase(context.progress, AKImportPhaseGeometry) &&
+        AKProgressCompletePhase(context.progress, AKImportPhaseMaterials) &&
+        AKProgressCompletePhase(context.progress, AKImportPhaseTextures) &&
+        (skins || animates))
+    {
+        AKMemoryAccountSetPhase(context.memoryAccount, AKImportPhaseSkin);
+        [self buildSkeletonDatabaseForScene:scene
+                                fromArchive:archive
+                                      nodes:nodes
+                                    context:context];
+        for (unsigned int i = 0; skins && i < header->nNodes; i++)
+        {
+            const AKArchiveNode *archiveNode = AKSceneArchiveNodeAt(archive, i);
+            if (archiveNode->geometry == AKArchiveNone)
+            {
+                continue;
+            }
+            const AKArchiveGeometry *geometry =
+                AKSceneArchiveGeometryAt(archive, archiveNode->geometry);
+            AKNodeSkin *skin =
+                geometry->skin != AKArchiveNone
+                    ? AKSceneArchiveCreateSkinInPlace(archive, geometry->skin)
+                    : NULL;
+            if (skin == NULL)
+            {
+                continue;
+            }
+            NSValue *key = [NSValue valueWithPointer:archiveNode];
+            NSArray *boneSources =
+                [self makeBoneSourcesForSkin:skin
+                                      forKey:key
+                                 archiveData:context.archiveData
+                                     context:context];
+            AKSceneArchiveReleaseSkinInPlace(skin);
+            [self makeSkinnersForNode:[nodes objectAtIndex:i]
+                      withBoneSources:boneSources
+                               forKey:key
+                              context:context];
+        }
+    }
+    start = [context addTimeSince:start toPhase:AKImportPhaseSkin];
+    context.nodeDepths = nil;
+    context.geometryChunks = nil;
+    /*
+   ---------------------------------------------------------------------
+   Animations, with the keyframe tracks of the archive
+   ---------------------------------------------------------------------
+   */
+    if (AKProgressCompletePhase(context.progress, AKImportPhaseSkin) &&
+        animates)
+    {
+        AKMemoryAccountSetPhase(context.memoryAccount,
+                                AKImportPhaseAnimations);
+        for (unsigned int i = 0; i < header->nAnimations; i++)
+        {
+            AKAnimationTracks *tracks =
+                AKSceneArchiveCreateAnimationTracks(archive, i);
+            if (tracks == NULL)
+            {
+                continue;
+            }
+            NSString *animName = [self makeNameOfAnimationAtIndex:i
+                                                           atPath:path];
+            SCNAssimpAnimation *animation =
+                [self makeAnimationNamed:animName
+                              fromTracks:tracks
+                                progress:context.progress];
+            AKAnimationTracksRelease(tracks);
+            if (AKProgressIsCancelled(context.progress))
+            {
+                break;
+            }
+            [scene.animations setValue:animation forKey:animName];
+        }
+    }
+    start = [context addTimeSince:start toPhase:AKImportPhaseAnimations];
+    if (!AKProgressCompletePhase(context.progress, AKImportPhaseAnimations))
+    {
+        DLog(@" The import was cancelled, releasing the partial scene");
+        return nil;
+    }
+    /*
+     ---------------------------------------------------------------------
+     Make SCNScene for model and animations
+     ---------------------------------------------------------------------
+     */
+    [scene makeModelScene];
+    start = [context addTimeSince:start toPhase:AKImportPhaseGeometry];
+    [scene makeAnimationScenes];
+    [context addTimeSince:start toPhase:AKImportPhaseAnimations];
+
+    return scene;
+}
+
+#pragma mark - Import progress
+
+/**
+ @name Import progress
+ */
 
 /**
- Creates a scenekit geometry source from the texture coordinates of the
- specified node.
+ Adds the vertices, materials and textures of the meshes of the specified node
+ and its children to the totals of their import phases.
 
  @param aiNode The assimp node.
  @param aiScene The assimp scene.
- @param nVertices The number of vertices in the meshes of the node.
- @return A new geometry source whose semantic property is texcoord.
+ @param totals The totals of the import phases.
+ */
+- (void)addProgressTotalsForNode:(const struct aiNode *)aiNode
+                         inScene:(const struct aiScene *)aiScene
+                          totals:(unsigned long *)totals
+{
+    totals[AKImportPhaseSkin] += 1;
+    for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        const struct aiMaterial *aiMaterial =
+            aiScene->mMaterials[aiMesh->mMaterialIndex];
+        totals[AKImportPhaseGeometry] += aiMesh->mNumVertices;
+        totals[AKImportPhaseMaterials] += 1;
+        for (int j = 0; j < kNumTextureTypes; j++)
+        {
+            if (aiGetMaterialTextureCount(aiMaterial, kTextureTypes[j]) > 0)
+            {
+                totals[AKImportPhaseTextures] += 1;
+            }
+        }
+    }
+    for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        [self addProgressTotalsForNode:aiNode->mChildren[i]
+                               inScene:aiScene
+                                totals:totals];
+    }
+}
+
+/**
+ Sets the totals of the conversion phases of the import: the vertices of the
+ node geometries, the materials and textures of the node meshes, the nodes
+ checked for skinning and the animation channels. The phases of the
+ components which the import leaves out have no work.
+
+ @param aiScene The assimp scene.
+ @param context The context of the import.
+ */
+- (void)setProgressTotalsForScene:(const struct aiScene *)aiScene
+                          context:(AssimpImportContext *)context
+{
+    AKProgress *progress = context.progress;
+    if (progress == NULL)
+    {
+        return;
+    }
+    unsigned long totals[AKImportPhaseCount] = {0};
+    [self addProgressTotalsForNode:aiScene->mRootNode
+                           inScene:aiScene
+                            totals:totals];
+    for (unsigned int i = 0; i < aiScene->mNumAnimations; i++)
+    {
+        totals[AKImportPhaseAnimations] +=
+            aiScene->mAnimations[i]->mNumChannels;
+    }
+    const SCNAssimpImportComponents phaseComponents[AKImportPhaseCount] = {
+        [AKImportPhaseGeometry] = SCNAssimpImportComponentGeometry,
+        [AKImportPhaseMaterials] = SCNAssimpImportComponentMaterials,
+        [AKImportPhaseTextures] = SCNAssimpImportComponentTextures,
+        [AKImportPhaseSkin] = SCNAssimpImportComponentSkinning,
+        [AKImportPhaseAnimations] = SCNAssimpImportComponentAnimations};
+    for (int phase = AKImportPhaseGeometry; phase < AKImportPhaseCount;
+         phase++)
+    {
+        if (![context importsComponents:phaseComponents[phase]])
+        {
+            totals[phase] = 0;
+        }
+    }
+    for (int phase = AKImportPhaseGeometry; phase < AKImportPhaseCount;
+         phase++)
+    {
+        AKProgressSetPhaseTotal(progress, (AKImportPhase)phase, totals[phase]);
+    }
+}
+
+#pragma mark - Make scenekit node
+
+/**
+ @name Make a scenekit node
+ */
+
+/**
+ Copies a scenekit matrix into the components m11, m12 ... m44 of a transform
+ of a scene archive.
+
+ @param matrix The scenekit matrix.
+ @param transform Receives the 16 components of the matrix.
+ */
+static void copyMatrixToArchiveTransform(SCNMatrix4 matrix, float *transform)
+{
+    const float components[16] = {
+        matrix.m11, matrix.m12, matrix.m13, matrix.m14,
+        matrix.m21, matrix.m22, matrix.m23, matrix.m24,
+        matrix.m31, matrix.m32, matrix.m33, matrix.m34,
+        matrix.m41, matrix.m42, matrix.m43, matrix.m44};
+    memcpy(transform, components, sizeof(components));
+}
+
+/**
+ Makes a scenekit matrix from the components m11, m12 ... m44 of a transform
+ of a scene archive.
+
+ @param transform The 16 components of the matrix.
+ @return The scenekit matrix.
+ */
+static SCNMatrix4 makeMatrixFromArchiveTransform(const float *transform)
+{
+    SCNMatrix4 matrix = {
+        transform[0],  transform[1],  transform[2],  transform[3],
+        transform[4],  transform[5],  transform[6],  transform[7],
+        transform[8],  transform[9],  transform[10], transform[11],
+        transform[12], transform[13], transform[14], transform[15]};
+    return matrix;
+}
+
+/**
+ Records the scene node made from the specified assimp node in the node maps.
+
+ The depth of the node is one more than the depth of the node made from the
+ parent assimp node, which is recorded before its children are made. The node
+ made from the assimp root node is a child of the scene's root node.
+
+ @param node The scene node.
+ @param aiNode The assimp node.
+ @param context The context of the import.
+ */
+- (void)recordNode:(SCNNode *)node
+     forAssimpNode:(const struct aiNode *)aiNode
+           context:(AssimpImportContext *)context
+{
+    [context.scnNodes setObject:node forKey:[NSValue valueWithPointer:aiNode]];
+    // a node whose name is not valid UTF-8 has no name, and is not indexed
+    if (node.name != nil && [context.nodeIndex objectForKey:node.name] == nil)
+    {
+        [context.nodeIndex setObject:node forKey:node.name];
+    }
+    int depth = 1;
+    if (aiNode->mParent != NULL)
+    {
+        SCNNode *parentNode = [context.scnNodes
+            objectForKey:[NSValue valueWithPointer:aiNode->mParent]];
+        depth = [self findDepthOfNodeFromRoot:parentNode context:context] + 1;
+    }
+    [context.nodeDepths setObject:[NSNumber numberWithInt:depth]
+                           forKey:[NSValue valueWithNonretainedObject:node]];
+}
+
+/**
+ Creates a new scenekit node from the assimp scene node
+
+ @param aiNode The assimp scene node.
+ @param aiScene The assimp scene.
+ @param path The path to the scene file to load.
+ @param context The context of the import.
+ @return A new scene node.
+ */
+- (SCNNode *)makeSCNNodeFromAssimpNode:(const struct aiNode *)aiNode
+                               inScene:(const struct aiScene *)aiScene
+                                atPath:(NSString *)path
+                               context:(AssimpImportContext *)context
+{
+    const struct aiString *aiNodeName = &aiNode->mName;
+    if (aiNodeName == NULL || !AKProgressCheckpoint(context.progress)) {
+        return nil;
+    }
+    
+    SCNNode *node = [[SCNNode alloc] init];
+    node.name = [NSString stringWithUTF8String:aiNodeName->data];
+    [self recordNode:node forAssimpNode:aiNode context:context];
+    DLog(@" Creating node %@ with %d meshes", node.name, aiNode->mNumMeshes);
+
+    // ---------
+    // TRANSFORM
+    // ---------
+    const struct aiMatrix4x4 aiNodeMatrix = aiNode->mTransformation;
+    GLKMatrix4 glkNodeMatrix = GLKMatrix4Make(
+        aiNodeMatrix.a1, aiNodeMatrix.b1, aiNodeMatrix.c1, aiNodeMatrix.d1,
+        aiNodeMatrix.a2, aiNodeMatrix.b2, aiNodeMatrix.c2, aiNodeMatrix.d2,
+        aiNodeMatrix.a3, aiNodeMatrix.b3, aiNodeMatrix.c3, aiNodeMatrix.d3,
+        aiNodeMatrix.a4, aiNodeMatrix.b4, aiNodeMatrix.c4, aiNodeMatrix.d4);
+
+    SCNMatrix4 scnMatrix = SCNMatrix4FromGLKMatrix4(glkNodeMatrix);
+    node.transform = scnMatrix;
+    DLog(@" Node %@ position %f %f %f", node.name, aiNodeMatrix.a4,
+         aiNodeMatrix.b4, aiNodeMatrix.c4);
+    if (context.archiveWriter != NULL)
+    {
+        [self addArchiveNode:node forAssimpNode:aiNode context:context];
+    }
+
+    node.geometry = [self makeSCNGeometryFromAssimpNode:aiNode
+                                                inScene:aiScene
+                                                 atPath:path
+                                                context:context];
+    // node.light = [self makeSCNLightFromAssimpNode:aiNode inScene:aiScene];
+    if ([context importsComponents:SCNAssimpImportComponentCameras])
+    {
+        node.camera = [self makeSCNCameraFromAssimpNode:aiNode
+                                                inScene:aiScene];
+    }
+    if (node.camera != nil && context.archiveWriter != NULL)
+    {
+        AKSceneArchiveWriterSetCamera(
+            context.archiveWriter, [context archiveIndexOfNode:node],
+            node.camera.xFov, node.camera.zNear, node.camera.zFar);
+    }
+    if ([context importsComponents:SCNAssimpImportComponentSkinning] ||
+        [context importsComponents:SCNAssimpImportComponentAnimations])
+    {
+        [context.boneTransforms
+            addEntriesFromDictionary:
+                [self getBoneTransformsForAssimpNode:aiNode inScene:aiScene]];
+    }
+    if (context.sceneTrim != NULL)
+    {
+        // the bone weights are made with the geometry, so that the meshes of
+        // the node can be freed before the next node is converted
+        if ([context importsComponents:SCNAssimpImportComponentSkinning])
+        {
+            NSArray *boneSources = [self makeBoneSourcesForAssimpNode:aiNode
+                                                              inScene:aiScene
+                                                              context:context];
+            if (boneSources != nil)
+            {
+                [context.boneSources
+                    setObject:boneSources
+                       forKey:[NSValue valueWithPointer:aiNode]];
+            }
+        }
+        AKSceneTrimNode(context.sceneTrim, aiNode);
+    }
+
+    for (int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        const struct aiNode *aiChildNode = aiNode->mChildren[i];
+        SCNNode *childNode = [self makeSCNNodeFromAssimpNode:aiChildNode
+                                                     inScene:aiScene
+                                                      atPath:path
+                                                     context:context];
+        if (childNode != nil)
+        {
+            [node addChildNode:childNode];
+        }
+    }
+    [self addChunkNodesToNode:node
+                       forKey:[NSValue valueWithPointer:aiNode]
+                      context:context];
+    return node;
+}
+
+/**
+ Creates a new scenekit node from a node of a scene archive, with its
+ transform, its geometry and its camera.
+
+ @param archiveNode The archive node.
+ @param archive The scene archive.
+ @param path The path to the scene file the archive was made from.
+ @param context The context of the import.
+ @return A new scene node.
+ */
+- (SCNNode *)makeSCNNodeFromArchiveNode:(const AKArchiveNode *)archiveNode
+                              inArchive:(const AKSceneArchive *)archive
+                                 atPath:(NSString *)path
+                                context:(AssimpImportContext *)context
+{
+    SCNNode *node = [[SCNNode alloc] init];
+    node.name = [NSString
+        stringWithUTF8String:AKSceneArchiveString(archive, archiveNode->name)];
+    DLog(@" Creating node %@ with %d meshes", node.name,
+         archiveNode->nMeshes);
+    node.transform = makeMatrixFromArchiveTransform(archiveNode->transform);
+    if (archiveNode->geometry != AKArchiveNone)
+    {
+        node.geometry = [self makeSCNGeometryFromArchiveNode:archiveNode
+                                                   inArchive:archive
+                                                      atPath:path
+                                                     context:context];
+    }
+    if (archiveNode->camera != AKArchiveNone)
+    {
+        const AKArchiveCamera *archiveCamera =
+            AKSceneArchiveCameraAt(archive, archiveNode->camera);
+        SCNCamera *camera = [SCNCamera camera];
+        camera.xFov = archiveCamera->xFov;
+        camera.zNear = archiveCamera->zNear;
+        camera.zFar = archiveCamera->zFar;
+        node.camera = camera;
+    }
+    return node;
+}
+
+/**
+ Adds the scene node made from the specified assimp node to the scene archive
+ of the import, after the node made from the parent assimp node.
+
+ @param node The scene node, with its transform.
+ @param aiNode The assimp node.
+ @param context The context of the import.
+ */
+- (void)addArchiveNode:(SCNNode *)node
+         forAssimpNode:(const struct aiNode *)aiNode
+               context:(AssimpImportContext *)context
+{
+    SCNNode *parentNode =
+        aiNode->mParent != NULL
+            ? [context.scnNodes
+                  objectForKey:[NSValue valueWithPointer:aiNode->mParent]]
+            : nil;
+    float transform[16];
+    copyMatrixToArchiveTransform(node.transform, transform);
+    unsigned int index = AKSceneArchiveWriterAddNode(
+        context.archiveWriter, node.name.UTF8String,
+        [context archiveIndexOfNode:parentNode], transform, aiNode->mMeshes,
+        aiNode->mNumMeshes);
+    [context setArchiveIndex:index forNode:node];
+}
+
+/**
+ Adds a child node for each chunk but the first of a split node geometry,
+ after the children made from the assimp node's children.
+
+ The first chunk is the geometry of the node itself. The other chunks are
+ attached to child nodes named after the node with the suffix -chunk-N, where
+ N is the chunk number starting from 1, which have the identity transform.
+
+ @param node The scene node.
+ @param key The key of the geometry chunks of the node, the pointer to the
+ assimp node or to the archive node the scene node was made from.
+ @param context The context of the import.
+ */
+- (void)addChunkNodesToNode:(SCNNode *)node
+                     forKey:(NSValue *)key
+                    context:(AssimpImportContext *)context
+{
+    NSArray *chunks = [context.geometryChunks objectForKey:key];
+    for (NSUInteger i = 0; i < chunks.count; i++)
+    {
+        NSMutableDictionary *chunk = [chunks objectAtIndex:i];
+        SCNNode *chunkNode = node;
+        if (i > 0)
+        {
+            chunkNode = [[SCNNode alloc] init];
+            chunkNode.name = [NSString
+                stringWithFormat:@"%@-chunk-%lu", node.name, (unsigned long)i];
+            chunkNode.geometry = [chunk objectForKey:@"geometry"];
+            [node addChildNode:chunkNode];
+            if ([context.nodeIndex objectForKey:chunkNode.name] == nil)
+            {
+                [context.nodeIndex setObject:chunkNode forKey:chunkNode.name];
+            }
+        }
+        [chunk setObject:chunkNode forKey:@"node"];
+    }
+}
+
+#pragma mark - Make scenekit geometry sources
+
+/**
+ @name Make scenekit geometry sources
+ */
+
+/**
+ Converts a vertex format of the import settings to the vertex format of the
+ core.
+
+ @param format The vertex format.
+ @return The vertex format of the core.
+ */
+- (AKVertexFormat)makeAKVertexFormat:(SCNAssimpVertexFormat)format
+{
+    switch (format)
+    {
+    case SCNAssimpVertexFormatFloat:
+        return AKVertexFormatFloat;
+    case SCNAssimpVertexFormatHalf:
+        return AKVertexFormatHalf;
+    case SCNAssimpVertexFormatSNorm16:
+        return AKVertexFormatSNorm16;
+    case SCNAssimpVertexFormatOctSNorm16:
+        return AKVertexFormatOctSNorm16;
+    case SCNAssimpVertexFormatUNorm8:
+        return AKVertexFormatUNorm8;
+    default:
+        return AKVertexFormatNone;
+    }
+}
+
+/**
+ Creates the vertex layout of the core from the vertex layout of the import
+ settings.
+
+ @param settings The import settings.
+ @return The vertex layout of the import.
  */
-- (SCNGeometrySource *)
-makeTextureGeometrySourceForNode:(const struct aiNode *)aiNode
-                         inScene:(const struct aiScene *)aiScene
-                   withNVertices:(int)nVertices
+- (AKVertexLayout)makeVertexLayoutForSettings:
+    (SCNAssimpImportSettings *)settings
 {
-    float* scnTextures = (float*)malloc(nVertices * 3 * sizeof(float));
-    int verticesCounter = 0;
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    SCNAssimpVertexLayout *vertexLayout = settings.vertexLayout;
+    if (vertexLayout == nil)
     {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        if (aiMesh->mTextureCoords[0] != NULL)
-        {
-            DLog(@"  Getting texture coordinates");
-            for (int j = 0; j < aiMesh->mNumVertices; j++)
-            {
-                float x = aiMesh->mTextureCoords[0][j].x;
-                float y = aiMesh->mTextureCoords[0][j].y;
-                scnTextures[verticesCounter++] = x;
-                scnTextures[verticesCounter++] = y;
-            }
-        }
+        return AKVertexLayoutMakeDefault();
     }
-    SCNGeometrySource *textureSource = [SCNGeometrySource
-        geometrySourceWithData:[NSData
-                                   dataWithBytes:scnTextures
-                                          length:nVertices * 2 * sizeof(float)]
-                      semantic:SCNGeometrySourceSemanticTexcoord
-                   vectorCount:nVertices
-               floatComponents:YES
-           componentsPerVector:2
-             bytesPerComponent:sizeof(float)
-                    dataOffset:0
-                    dataStride:2 * sizeof(float)];
-    free(scnTextures);
-    return textureSource;
+    AKVertexLayout layout;
+    layout.formats[AKVertexAttributePosition] =
+        [self makeAKVertexFormat:vertexLayout.positionFormat];
+    layout.formats[AKVertexAttributeNormal] =
+        [self makeAKVertexFormat:vertexLayout.normalFormat];
+    layout.formats[AKVertexAttributeTangent] =
+        [self makeAKVertexFormat:vertexLayout.tangentFormat];
+    layout.formats[AKVertexAttributeTexCoord] =
+        [self makeAKVertexFormat:vertexLayout.texCoordFormat];
+    layout.formats[AKVertexAttributeColor] =
+        [self makeAKVertexFormat:vertexLayout.colorFormat];
+    return layout;
 }
 
 /**
- Creates a scenekit vertex color source from the vertex color information of
- the specified node.
- 
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @param nVertices The number of vertices in the meshes of the node.
- @return A new color source whose semantic property is vertex color.
+ Makes a data object of a buffer of the core without a copy.
+
+ @param bytes The buffer, which is freed with the data object if it is not
+ read in place from a scene archive.
+ @param length The size of the buffer in bytes.
+ @param archiveData The mapped scene archive which the buffer is read in place
+ from, kept by the data object, or nil if the data object owns the buffer.
+ @return A data object of the buffer.
  */
-- (SCNGeometrySource *)
-makeColorGeometrySourceForNode:(const struct aiNode *)aiNode
-                       inScene:(const struct aiScene *)aiScene
-                 withNVertices:(int)nVertices
+- (NSData *)makeDataWithBytes:(void *)bytes
+                       length:(NSUInteger)length
+                  archiveData:(NSData *)archiveData
 {
-    float *scnColors = (float *)malloc(nVertices * 3 * sizeof(float));
-    int colorsCounter = 0;
-
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    if (archiveData == nil)
     {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        const struct aiColor4D *aiColor4D = aiMesh->mColors[0];
-
-        if (aiColor4D == NULL)
-        {
-            free(scnColors);
-            return NULL;
-        }
-
-        for (int j = 0; j < aiMesh->mNumVertices; j++)
-        {
-            scnColors[colorsCounter++] = aiColor4D[j].r;
-            scnColors[colorsCounter++] = aiColor4D[j].g;
-            scnColors[colorsCounter++] = aiColor4D[j].b;
-        }
+        return [NSData dataWithBytesNoCopy:bytes
+                                    length:length
+                              freeWhenDone:YES];
     }
-
-    SCNGeometrySource *colorSource = [SCNGeometrySource
-        geometrySourceWithData:[NSData
-                                   dataWithBytes:scnColors
-                                          length:nVertices * 3 * sizeof(float)]
-                      semantic:SCNGeometrySourceSemanticColor
-                   vectorCount:nVertices
-               floatComponents:YES
-           componentsPerVector:3
-             bytesPerComponent:sizeof(float)
-                    dataOffset:0
-                    dataStride:3 * sizeof(float)];
-    free(scnColors);
-    return colorSource;
+    return [[NSData alloc] initWithBytesNoCopy:bytes
+                                        length:length
+                                   deallocator:^(void *buffer,
+                                                 NSUInteger bufferLength) {
+                                     (void)archiveData;
+                                   }];
 }
 
 /**
- Creates an array of geometry sources for the specifed node describing
+ Creates an array of geometry sources for the specifed node geometry describing
  the vertices in the geometry and their attributes.
 
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @param nVertices The number of vertices in the meshes of the node.
+ The interleaved vertices are handed off to a data object without a copy, and
+ the data object is shared by the geometry sources, each being a view at the
+ offset of its attribute with the stride of a vertex. Attributes which the
+ geometry does not store have no geometry source. Half float components are
+ float components, and normalized integer components are integer components.
+
+ @param geometry The node geometry, whose vertices are owned by the geometry
+ sources from now on.
+ @param archiveData The mapped scene archive which the vertices are read in
+ place from, or nil.
  @return An array of geometry sources.
  */
-- (NSArray *)makeGeometrySourcesForNode:(const struct aiNode *)aiNode
-                                inScene:(const struct aiScene *)aiScene
-                           withVertices:(int)nVertices
+- (NSArray *)makeGeometrySourcesForGeometry:(AKNodeGeometry *)geometry
+                                archiveData:(NSData *)archiveData
 {
+    NSString *semantics[AKVertexAttributeCount];
+    semantics[AKVertexAttributePosition] = SCNGeometrySourceSemanticVertex;
+    semantics[AKVertexAttributeNormal] = SCNGeometrySourceSemanticNormal;
+    semantics[AKVertexAttributeTangent] = SCNGeometrySourceSemanticTangent;
+    semantics[AKVertexAttributeTexCoord] = SCNGeometrySourceSemanticTexcoord;
+    semantics[AKVertexAttributeColor] = SCNGeometrySourceSemanticColor;
+    NSData *vertexData =
+        [self makeDataWithBytes:geometry->vertexData
+                         length:geometry->nVertices * geometry->vertexStride
+                    archiveData:archiveData];
+    geometry->vertexData = NULL;
     NSMutableArray *scnGeometrySources = [[NSMutableArray alloc] init];
-    [scnGeometrySources
-        addObject:[self makeVertexGeometrySourceForNode:aiNode
-                                                inScene:aiScene
-                                          withNVertices:nVertices]];
-    [scnGeometrySources
-        addObject:[self makeNormalGeometrySourceForNode:aiNode
-                                                inScene:aiScene
-                                          withNVertices:nVertices]];
-    [scnGeometrySources
-        addObject:[self makeTangentGeometrySourceForNode:aiNode
-                                                 inScene:aiScene
-                                           withNVertices:nVertices]];
-    [scnGeometrySources
-        addObject:[self makeTextureGeometrySourceForNode:aiNode
-                                                 inScene:aiScene
-                                           withNVertices:nVertices]];
-
-    SCNGeometrySource *colorGeometrySource =
-        [self makeColorGeometrySourceForNode:aiNode
-                                     inScene:aiScene
-                               withNVertices:nVertices];
-    
-    if (colorGeometrySource != nil)
+    for (int i = 0; i < AKVertexAttributeCount; i++)
     {
-        [scnGeometrySources addObject:colorGeometrySource];
+        const AKVertexAttributeView *view = &geometry->attributes[i];
+        if (view->format == AKVertexFormatNone)
+        {
+            continue;
+        }
+        BOOL floatComponents = view->format == AKVertexFormatFloat ||
+                               view->format == AKVertexFormatHalf;
+        [scnGeometrySources
+            addObject:[SCNGeometrySource
+                          geometrySourceWithData:vertexData
+                                        semantic:semantics[i]
+                                     vectorCount:geometry->nVertices
+                                 floatComponents:floatComponents
+                             componentsPerVector:view->nComponents
+                               bytesPerComponent:view->bytesPerComponent
+                                      dataOffset:view->offset
+                                      dataStride:geometry->vertexStride]];
     }
 
     return scnGeometrySources;
 }
 
-#pragma mark - Make scenekit geometry elements
-
 /**
- @name Make scenekit geometry elements
- */
+ Makes the scenekit geometry decode the quantized attributes of the node
+ geometry.
 
-/**
- Creates a scenekit geometry element describing how vertices connect to define
- a three-dimensional object, or geometry for the specified mesh of a node.
+ A geometry shader modifier restores quantized positions with the position
+ scale and offset, and decodes octahedral normals and tangents. The bounding
+ box is set to the bounds of the restored positions, as scenekit computes it
+ from the stored positions.
 
- @param aiMeshIndex The assimp mesh index.
- @param aiNode The assimp node of the mesh.
- @param aiScene The assimp scene.
- @param indexOffset The total number of indices for the previous meshes.
- @param nFaces The number of faces in the geometry of the mesh.
- @return A new geometry element object.
+ @param scnGeometry The scenekit geometry made from the node geometry.
+ @param geometry The node geometry.
  */
-- (SCNGeometryElement *)
-makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
-                                inNode:(const struct aiNode *)aiNode
-                               inScene:(const struct aiScene *)aiScene
-                       withIndexOffset:(short)indexOffset
-                                nFaces:(int)nFaces
+- (void)applyVertexDecodingToGeometry:(SCNGeometry *)scnGeometry
+                         fromGeometry:(const AKNodeGeometry *)geometry
 {
-    int indicesCounter = 0;
-    int nIndices = [self findNumIndicesInMesh:aiMeshIndex inScene:aiScene];
-    short *scnIndices =(short *)malloc(nIndices * sizeof(short));
-    const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-    for (int i = 0; i < aiMesh->mNumFaces; i++)
+    BOOL quantizedPositions =
+        geometry->attributes[AKVertexAttributePosition].format !=
+        AKVertexFormatFloat;
+    BOOL octNormals = geometry->attributes[AKVertexAttributeNormal].format ==
+                      AKVertexFormatOctSNorm16;
+    BOOL octTangents = geometry->attributes[AKVertexAttributeTangent].format ==
+                       AKVertexFormatOctSNorm16;
+    if (!quantizedPositions && !octNormals && !octTangents)
     {
-        const struct aiFace *aiFace = &aiMesh->mFaces[i];
-        // we ignore faces which are not triangulated
-        
-        if ((aiFace  == NULL) || (aiFace->mNumIndices != 3) || (aiFace->mNumIndices > nIndices)) {
-            free(scnIndices);
-            scnIndices = NULL;
-            return nil;
-        }
-        for (int j = 0; j < aiFace->mNumIndices; j++)
-        {
-            scnIndices[indicesCounter++] =
-                (short)indexOffset + (short)aiFace->mIndices[j];
-        }
+        return;
+    }
+    NSMutableString *modifier = [[NSMutableString alloc] init];
+    if (quantizedPositions)
+    {
+        [modifier appendString:@"uniform vec3 akPositionScale;\n"
+                               @"uniform vec3 akPositionOffset;\n"];
+    }
+    if (octNormals || octTangents)
+    {
+        [modifier
+            appendString:
+                @"vec3 akOctDecode(vec2 o) {\n"
+                @"    vec3 v = vec3(o, 1.0 - abs(o.x) - abs(o.y));\n"
+                @"    if (v.z < 0.0) {\n"
+                @"        v.xy = (1.0 - abs(v.yx)) *\n"
+                @"               vec2(v.x >= 0.0 ? 1.0 : -1.0,\n"
+                @"                    v.y >= 0.0 ? 1.0 : -1.0);\n"
+                @"    }\n"
+                @"    return normalize(v);\n"
+                @"}\n"];
+    }
+    [modifier appendString:@"#pragma body\n"];
+    if (quantizedPositions)
+    {
+        [modifier appendString:@"_geometry.position.xyz =\n"
+                               @"    _geometry.position.xyz *\n"
+                               @"    akPositionScale + akPositionOffset;\n"];
+        SCNVector3 scale =
+            SCNVector3Make(geometry->positionScale[0],
+                           geometry->positionScale[1],
+                           geometry->positionScale[2]);
+        SCNVector3 offset =
+            SCNVector3Make(geometry->positionOffset[0],
+                           geometry->positionOffset[1],
+                           geometry->positionOffset[2]);
+        [scnGeometry setValue:[NSValue valueWithSCNVector3:scale]
+                       forKey:@"akPositionScale"];
+        [scnGeometry setValue:[NSValue valueWithSCNVector3:offset]
+                       forKey:@"akPositionOffset"];
+        SCNVector3 min = SCNVector3Make(offset.x - scale.x,
+                                        offset.y - scale.y,
+                                        offset.z - scale.z);
+        SCNVector3 max = SCNVector3Make(offset.x + scale.x,
+                                        offset.y + scale.y,
+                                        offset.z + scale.z);
+        [scnGeometry setBoundingBoxMin:&min max:&max];
     }
-    NSData *indicesData =
-        [NSData dataWithBytes:scnIndices length:nIndices * sizeof(short)];
-    SCNGeometryElement *indices = [SCNGeometryElement
-        geometryElementWithData:indicesData
-                  primitiveType:SCNGeometryPrimitiveTypeTriangles
-                 primitiveCount:nFaces
-                  bytesPerIndex:sizeof(short)];
-    free(scnIndices);
-    return indices;
+    if (octNormals)
+    {
+        [modifier appendString:@"_geometry.normal =\n"
+                               @"    akOctDecode(_geometry.normal.xy);\n"];
+    }
+    if (octTangents)
+    {
+        [modifier appendString:@"_geometry.tangent.xyz =\n"
+                               @"    akOctDecode(_geometry.tangent.xy);\n"];
+    }
+    scnGeometry.shaderModifiers =
+        @{ SCNShaderModifierEntryPointGeometry : modifier };
+}
+
+/**
+ Adds the quantization of a node geometry to the quantization report of the
+ scene.
+
+ @param quantization The quantization report of the node geometry.
+ @param report The quantization report of the scene.
+ */
+- (void)addQuantization:(const AKQuantizationReport *)quantization
+               toReport:(SCNAssimpQuantizationReport *)report
+{
+    report.maxPositionError =
+        MAX(report.maxPositionError, quantization->maxPositionError);
+    report.maxNormalAngleError =
+        MAX(report.maxNormalAngleError, quantization->maxNormalAngleError);
+    report.maxTangentAngleError =
+        MAX(report.maxTangentAngleError, quantization->maxTangentAngleError);
+    report.maxTexCoordError =
+        MAX(report.maxTexCoordError, quantization->maxTexCoordError);
+    report.bytesSaved += quantization->bytesSaved;
 }
 
+#pragma mark - Make scenekit geometry elements
+
+/**
+ @name Make scenekit geometry elements
+ */
+
 /**
  Creates an array of scenekit geometry element obejcts describing how to
- connect the geometry's vertices of the specified node.
+ connect the geometry's vertices of the specified node geometry.
 
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
+ Meshes with faces which are not triangulated have no indices and are ignored.
+ The indices of each element are handed off to a data object without a copy.
+
+ @param geometry The node geometry, whose indices are owned by the geometry
+ elements from now on.
+ @param archiveData The mapped scene archive which the indices are read in
+ place from, or nil.
  @return An array of geometry elements.
  */
-- (NSArray *)makeGeometryElementsforNode:(const struct aiNode *)aiNode
-                                 inScene:(const struct aiScene *)aiScene
+- (NSArray *)makeGeometryElementsForGeometry:(AKNodeGeometry *)geometry
+                                 archiveData:(NSData *)archiveData
 {
     NSMutableArray *scnGeometryElements = [[NSMutableArray alloc] init];
-    int indexOffset = 0;
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    for (int i = 0; i < geometry->nElements; i++)
     {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        SCNGeometryElement *indices =
-            [self makeIndicesGeometryElementForMeshIndex:aiMeshIndex
-                                                  inNode:aiNode
-                                                 inScene:aiScene
-                                         withIndexOffset:indexOffset
-                                                  nFaces:aiMesh->mNumFaces];
-        if(indices != nil) {
-            [scnGeometryElements addObject:indices];
+        AKGeometryElement *element = &geometry->elements[i];
+        if (element->indices == NULL)
+        {
+            continue;
         }
-        indexOffset += aiMesh->mNumVertices;
+        NSData *indicesData = [self
+            makeDataWithBytes:element->indices
+                       length:element->nIndices * element->bytesPerIndex
+                  archiveData:archiveData];
+        element->indices = NULL;
+        SCNGeometryElement *indices = [SCNGeometryElement
+            geometryElementWithData:indicesData
+                      primitiveType:SCNGeometryPrimitiveTypeTriangles
+                     primitiveCount:element->nPrimitives
+                      bytesPerIndex:element->bytesPerIndex];
+        [scnGeometryElements addObject:indices];
     }
 
     return scnGeometryElements;
@@ -742,7 +1996,8 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
  Updates a scenekit material property with the texture file path or the color
  if no texture is specifed.
 
- @param aiMaterial The assimp material.
+ @param aiMaterial The assimp material, or NULL for a material of a scene
+ archive.
  @param textureInfo The metadata of the texture.
  @param material The scenekit material.
  @param path The path to the scene file to load.
@@ -835,13 +2090,15 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
 }
 
 /**
- Updates a scenekit material's multiply property
+ Gets the multiply color of a material, which is its transparent color if the
+ color has no zero component.
 
- @param aiMaterial The assimp material
- @param material The scenekit material.
+ @param multiply Receives the rgba multiply color.
+ @param aiMaterial The assimp material.
+ @return YES if the material has a multiply color.
  */
-- (void)applyMultiplyPropertyForMaterial:(const struct aiMaterial *)aiMaterial
-                         withSCNMaterial:(SCNMaterial *)material
+- (BOOL)getMultiplyColor:(float *)multiply
+             forMaterial:(const struct aiMaterial *)aiMaterial
 {
     struct aiColor4D color;
     color.r = 0.0f;
@@ -854,14 +2111,121 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
     {
         if (color.r != 0 && color.g != 0 && color.b != 0)
         {
-            CGColorSpaceRef space = CGColorSpaceCreateDeviceRGB();
-            CGFloat components[4] = {color.r, color.g, color.b, color.a};
-            CGColorRef color = CGColorCreate(space, components);
-            material.multiply.contents = (__bridge id _Nullable)(color);
-            CGColorSpaceRelease(space);
-            CGColorRelease(color);
+            multiply[0] = color.r;
+            multiply[1] = color.g;
+            multiply[2] = color.b;
+            multiply[3] = color.a;
+            return YES;
         }
     }
+    return NO;
+}
+
+/**
+ Updates a scenekit material's multiply property
+
+ @param aiMaterial The assimp material
+ @param material The scenekit material.
+ */
+- (void)applyMultiplyPropertyForMaterial:(const struct aiMaterial *)aiMaterial
+                         withSCNMaterial:(SCNMaterial *)material
+{
+    float multiply[4];
+    if ([self getMultiplyColor:multiply forMaterial:aiMaterial])
+    {
+        [self applyMultiplyColor:multiply toMaterial:material];
+    }
+}
+
+/**
+ Sets the multiply property of a scenekit material to a color.
+
+ @param multiply The rgba multiply color.
+ @param material The scenekit material.
+ */
+- (void)applyMultiplyColor:(const float *)multiply
+                toMaterial:(SCNMaterial *)material
+{
+    CGColorSpaceRef space = CGColorSpaceCreateDeviceRGB();
+    CGFloat components[4] = {multiply[0], multiply[1], multiply[2],
+                             multiply[3]};
+    CGColorRef color = CGColorCreate(space, components);
+    material.multiply.contents = (__bridge id _Nullable)(color);
+    CGColorSpaceRelease(space);
+    CGColorRelease(color);
+}
+
+/**
+ Gets the assimp blend mode of a material.
+
+ @param aiMaterial The assimp material.
+ @return The blend mode, aiBlendMode_Default if the material has none.
+ */
+- (unsigned int)getBlendModeForMaterial:(const struct aiMaterial *)aiMaterial
+{
+    unsigned int blendMode = 0;
+    unsigned int *max = NULL;
+    aiGetMaterialIntegerArray(aiMaterial, AI_MATKEY_BLEND_FUNC,
+                              (int *)&blendMode, max);
+    return blendMode;
+}
+
+/**
+ Sets the blend mode, the cull mode and the lighting model of a scenekit
+ material.
+
+ @param blendMode The assimp blend mode of the material.
+ @param material The scenekit material.
+ */
+- (void)applyBlendMode:(unsigned int)blendMode
+            toMaterial:(SCNMaterial *)material
+{
+    if (blendMode == aiBlendMode_Default)
+    {
+        DLog(@" Using alpha blend mode");
+        material.blendMode = SCNBlendModeAlpha;
+    }
+    else if (blendMode == aiBlendMode_Additive)
+    {
+        DLog(@" Using add blend mode");
+        material.blendMode = SCNBlendModeAdd;
+    }
+    DLog(@"+++ Loading cull/double sided mode");
+    /**
+     FIXME: The cull mode works only on iOS. Not on OSX.
+     Hence has been defaulted to Cull Back.
+     USE AI_MATKEY_TWOSIDED to get the cull mode.
+     */
+    material.cullMode = SCNCullBack;
+    DLog(@"+++ Loading shading model");
+    /**
+     FIXME: The shading mode works only on iOS for iPhone.
+     Does not work on iOS for iPad and OS X.
+     Hence has been defaulted to Blinn.
+     USE AI_MATKEY_SHADING_MODEL to get the shading mode.
+     */
+    material.lightingModelName = SCNLightingModelBlinn;
+}
+
+/**
+ Adds a material to the scene archive of the import, without its properties.
+
+ @param aiMaterial The assimp material.
+ @param index The index of the assimp material.
+ @param name The name of the material.
+ @param context The context of the import.
+ */
+- (void)addArchiveMaterial:(const struct aiMaterial *)aiMaterial
+                   atIndex:(unsigned int)index
+                     named:(NSString *)name
+                   context:(AssimpImportContext *)context
+{
+    float multiply[4];
+    BOOL hasMultiply = [self getMultiplyColor:multiply forMaterial:aiMaterial];
+    AKSceneArchiveWriterSetMaterial(context.archiveWriter, index,
+                                    name.UTF8String,
+                                    [self getBlendModeForMaterial:aiMaterial],
+                                    hasMultiply ? multiply : NULL);
 }
 
 /**
@@ -870,14 +2234,17 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
  @param aiNode The assimp node.
  @param aiScene The assimp scene.
  @param path The path to the scene file to load.
+ @param context The context of the import.
  @return An array of scenekit materials.
  */
 - (NSMutableArray *)makeMaterialsForNode:(const struct aiNode *)aiNode
                                  inScene:(const struct aiScene *)aiScene
                                   atPath:(NSString *)path
-							  imageCache:(AssimpImageCache *)imageCache
+                                 context:(AssimpImportContext *)context
 {
     NSMutableArray *scnMaterials = [[NSMutableArray alloc] init];
+    BOOL loadsTextures =
+        [context importsComponents:SCNAssimpImportComponentTextures];
     for (int i = 0; i < aiNode->mNumMeshes; i++)
     {
         int aiMeshIndex = aiNode->mMeshes[i];
@@ -891,13 +2258,23 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
         DLog(@"Material name is \"%@\" Material index is \"%@\"", nameString,@(aiMesh->mMaterialIndex));
         SCNMaterial *material = [SCNMaterial material];
         material.name = nameString;
-        int kTextureTypes = 10;
-        int textureTypes[10] = {
-            aiTextureType_DIFFUSE,      aiTextureType_SPECULAR,
-            aiTextureType_AMBIENT,      aiTextureType_EMISSIVE,
-            aiTextureType_REFLECTION,   aiTextureType_OPACITY,
-            aiTextureType_NORMALS,      aiTextureType_HEIGHT,
-            aiTextureType_DISPLACEMENT, aiTextureType_SHININESS};
+        // each material is archived once, with the properties it is made of
+        AKSceneArchiveWriter *writer = context.archiveWriter;
+        BOOL archivesMaterial =
+            writer != NULL &&
+            !AKSceneArchiveWriterHasMaterial(writer, aiMesh->mMaterialIndex);
+        if (writer != NULL)
+        {
+            AKSceneArchiveWriterSetMeshMaterial(writer, aiMeshIndex,
+                                                aiMesh->mMaterialIndex);
+        }
+        if (archivesMaterial)
+        {
+            [self addArchiveMaterial:aiMaterial
+                             atIndex:aiMesh->mMaterialIndex
+                               named:nameString
+                             context:context];
+        }
 #ifdef MY_DEBUG
         NSDictionary *textureTypeNames = @{
             @"0" : @"Diffuse",
@@ -913,103 +2290,408 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
         };
 #endif
 
-        for(int i = 0; i < kTextureTypes; i++) {
+        for(int i = 0; i < kNumTextureTypes; i++) {
             DLog(@" Loading texture type : %@",
                  [textureTypeNames
                      valueForKey:[NSNumber numberWithInt:i].stringValue]);
-            SCNTextureInfo *textureInfo =
-                [[SCNTextureInfo alloc] initWithMeshIndex:aiMeshIndex
-                                              textureType:textureTypes[i]
-                                                  inScene:aiScene
-                                                   atPath:path
-											   imageCache:imageCache];
+            // only the textures are timed, so that the materials of a scene
+            // without textures read the clock once
+            BOOL hasTextures =
+                loadsTextures &&
+                aiGetMaterialTextureCount(aiMaterial, kTextureTypes[i]) > 0;
+            double start = hasTextures ? [context startTiming] : 0;
+            SCNTextureInfo *textureInfo = [[SCNTextureInfo alloc]
+                initWithMeshIndex:aiMeshIndex
+                      textureType:kTextureTypes[i]
+                          inScene:aiScene
+                           atPath:path
+                       imageCache:context.imageCache
+                    loadsTextures:loadsTextures
+                 resourceResolver:context.textureResolver];
+            if (hasTextures)
+            {
+                [context addTimeSince:start toPhase:AKImportPhaseTextures];
+            }
             [self makeMaterialPropertyForMaterial:aiMaterial
                                   withTextureInfo:textureInfo
                                   withSCNMaterial:material
                                            atPath:path];
+            if (archivesMaterial)
+            {
+                [textureInfo recordSlotInArchive:writer
+                                        material:aiMesh->mMaterialIndex
+                                         inScene:aiScene];
+            }
             [textureInfo releaseContents];
+            if (hasTextures &&
+                !AKProgressAdvance(context.progress, AKImportPhaseTextures, 1))
+            {
+                return scnMaterials;
+            }
         }
 
         DLog(@"+++ Loading multiply color");
         [self applyMultiplyPropertyForMaterial:aiMaterial
                                withSCNMaterial:material];
         DLog(@"+++ Loading blend mode");
-        unsigned int blendMode = 0;
-        unsigned int *max = NULL;
-        aiGetMaterialIntegerArray(aiMaterial, AI_MATKEY_BLEND_FUNC,
-                                  (int *)&blendMode, max);
-        if (blendMode == aiBlendMode_Default)
-        {
-            DLog(@" Using alpha blend mode");
-            material.blendMode = SCNBlendModeAlpha;
-        }
-        else if (blendMode == aiBlendMode_Additive)
-        {
-            DLog(@" Using add blend mode");
-            material.blendMode = SCNBlendModeAdd;
-        }
-        DLog(@"+++ Loading cull/double sided mode");
-        /**
-     FIXME: The cull mode works only on iOS. Not on OSX.
-     Hence has been defaulted to Cull Back.
-     USE AI_MATKEY_TWOSIDED to get the cull mode.
-     */
-        material.cullMode = SCNCullBack;
+        unsigned int blendMode = [self getBlendModeForMaterial:aiMaterial];
         DLog(@"+++ Loading shininess");
         int shininess;
+        unsigned int *max = NULL;
         aiGetMaterialIntegerArray(aiMaterial, AI_MATKEY_BLEND_FUNC,
                                   (int *)&shininess, max);
         DLog(@"   shininess: %d", shininess);
             //material.shininess = shininess;
-        DLog(@"+++ Loading shading model");
-        /**
-     FIXME: The shading mode works only on iOS for iPhone.
-     Does not work on iOS for iPad and OS X.
-     Hence has been defaulted to Blinn.
-     USE AI_MATKEY_SHADING_MODEL to get the shading mode.
-     */
-        material.lightingModelName = SCNLightingModelBlinn;
+        [self applyBlendMode:blendMode toMaterial:material];
+        [scnMaterials addObject:material];
+        if (!AKProgressAdvance(context.progress, AKImportPhaseMaterials, 1))
+        {
+            break;
+        }
+    }
+    return scnMaterials;
+}
+
+/**
+ Creates an array of scenekit materials one for each mesh of a node of a scene
+ archive, from the materials of the archive.
+
+ @param meshes The indices of the meshes of the node.
+ @param nMeshes The number of meshes of the node.
+ @param archive The scene archive.
+ @param path The path to the scene file the archive was made from.
+ @param context The context of the import.
+ @return An array of scenekit materials.
+ */
+- (NSMutableArray *)makeMaterialsForMeshes:(const unsigned int *)meshes
+                                     count:(unsigned int)nMeshes
+                                 inArchive:(const AKSceneArchive *)archive
+                                    atPath:(NSString *)path
+                                   context:(AssimpImportContext *)context
+{
+    NSMutableArray *scnMaterials = [[NSMutableArray alloc] init];
+    for (unsigned int i = 0; i < nMeshes; i++)
+    {
+        const AKArchiveMaterial *archiveMaterial =
+            AKSceneArchiveMeshMaterial(archive, meshes[i]);
+        if (archiveMaterial == NULL)
+        {
+            break;
+        }
+        SCNMaterial *material = [SCNMaterial material];
+        material.name = [NSString
+            stringWithUTF8String:AKSceneArchiveString(archive,
+                                                      archiveMaterial->name)];
+        for (unsigned int j = 0; j < archiveMaterial->nSlots; j++)
+        {
+            const AKArchiveMaterialSlot *slot = &archiveMaterial->slots[j];
+            BOOL hasTexture = slot->kind == AKMaterialSlotEmbeddedTexture ||
+                              slot->kind == AKMaterialSlotExternalTexture;
+            double start = hasTexture ? [context startTiming] : 0;
+            SCNTextureInfo *textureInfo = [[SCNTextureInfo alloc]
+                initWithArchiveSlot:slot
+                          inArchive:archive
+                             atPath:path
+                         imageCache:context.imageCache
+                   resourceResolver:context.textureResolver];
+            if (hasTexture)
+            {
+                [context addTimeSince:start toPhase:AKImportPhaseTextures];
+            }
+            [self makeMaterialPropertyForMaterial:NULL
+                                  withTextureInfo:textureInfo
+                                  withSCNMaterial:material
+                                           atPath:path];
+            [textureInfo releaseContents];
+        }
+        if (archiveMaterial->hasMultiply)
+        {
+            [self applyMultiplyColor:archiveMaterial->multiply
+                          toMaterial:material];
+        }
+        [self applyBlendMode:archiveMaterial->blendMode toMaterial:material];
         [scnMaterials addObject:material];
+        if (!AKProgressCheckpoint(context.progress))
+        {
+            break;
+        }
+    }
+    return scnMaterials;
+}
+
+/**
+ Creates a scenekit geometry to attach at the specified node.
+
+ The node geometry is taken from the node geometries of the import, which are
+ converted in parallel before the nodes are made, or converted now if the
+ scene is trimmed as it is converted.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param path The path to the scene file to load.
+ @param context The context of the import.
+ @return A new geometry, or nil if the meshes of the node have no vertices or
+ the import leaves out the geometry.
+ */
+- (SCNGeometry *)makeSCNGeometryFromAssimpNode:(const struct aiNode *)aiNode
+                                       inScene:(const struct aiScene *)aiScene
+                                        atPath:(NSString *)path
+                                       context:(AssimpImportContext *)context
+{
+    SCNAssimpImportSettings *settings = context.settings;
+    AKNodeGeometry *geometry = NULL;
+    if (context.sceneGeometry != NULL)
+    {
+        geometry = AKSceneGeometryTake(context.sceneGeometry, aiNode);
+    }
+    else if (context.sceneTrim != NULL &&
+             [context importsComponents:SCNAssimpImportComponentGeometry])
+    {
+        AKVertexLayout layout = [self makeVertexLayoutForSettings:settings];
+        geometry = AKNodeGeometryCreateWithProgress(
+            aiNode, aiScene, &layout, context.sceneStats, context.progress);
+    }
+    if (geometry == NULL)
+    {
+        return nil;
+    }
+    if (context.archiveWriter != NULL)
+    {
+        // the whole node geometry is archived, and split again when loaded
+        SCNNode *node = [context.scnNodes
+            objectForKey:[NSValue valueWithPointer:aiNode]];
+        AKSceneArchiveWriterSetGeometry(context.archiveWriter,
+                                        [context archiveIndexOfNode:node],
+                                        geometry);
+    }
+    NSArray *scnMaterials = nil;
+    if ([context importsComponents:SCNAssimpImportComponentMaterials])
+    {
+        double start = [context startTiming];
+        scnMaterials = [self makeMaterialsForNode:aiNode
+                                          inScene:aiScene
+                                           atPath:path
+                                          context:context];
+        [context addTimeSince:start toPhase:AKImportPhaseMaterials];
+    }
+    return [self makeSCNGeometryFromGeometry:geometry
+                                      forKey:[NSValue valueWithPointer:aiNode]
+                                      meshes:aiNode->mMeshes
+                                       count:aiNode->mNumMeshes
+                                   materials:scnMaterials
+                                 archiveData:nil
+                                     context:context];
+}
+
+/**
+ Creates a scenekit geometry to attach at the specified node of a scene
+ archive, from the node geometry of the archive read in place.
+
+ @param archiveNode The archive node, which has a geometry.
+ @param archive The scene archive.
+ @param path The path to the scene file the archive was made from.
+ @param context The context of the import.
+ @return A new geometry, or nil if the geometry is out of the archive.
+ */
+- (SCNGeometry *)makeSCNGeometryFromArchiveNode:
+                     (const AKArchiveNode *)archiveNode
+                                      inArchive:(const AKSceneArchive *)archive
+                                         atPath:(NSString *)path
+                                        context:(AssimpImportContext *)context
+{
+    AKNodeGeometry *geometry =
+        AKSceneArchiveCreateGeometryInPlace(archive, archiveNode->geometry);
+    if (geometry == NULL)
+    {
+        return nil;
+    }
+    const uint32_t *meshes = AKSceneArchiveNodeMeshes(archive, archiveNode);
+    NSArray *scnMaterials = nil;
+    if ([context importsComponents:SCNAssimpImportComponentMaterials])
+    {
+        double start = [context startTiming];
+        scnMaterials = [self makeMaterialsForMeshes:meshes
+                                              count:archiveNode->nMeshes
+                                          inArchive:archive
+                                             atPath:path
+                                            context:context];
+        [context addTimeSince:start toPhase:AKImportPhaseMaterials];
+    }
+    return [self
+        makeSCNGeometryFromGeometry:geometry
+                             forKey:[NSValue valueWithPointer:archiveNode]
+                             meshes:meshes
+                              count:archiveNode->nMeshes
+                          materials:scnMaterials
+                        archiveData:context.archiveData
+                            context:context];
+}
+
+/**
+ Creates a scenekit geometry from a node geometry, split into chunks if it has
+ more than maxVerticesPerGeometry vertices and the settings split large
+ geometries, and releases the node geometry.
+
+ @param geometry The node geometry, whose buffers are owned by the scenekit
+ geometry from now on.
+ @param key The key of the geometry chunks of the node, the pointer to the
+ assimp node or to the archive node the geometry was made from.
+ @param meshes The indices of the meshes of the node.
+ @param nMeshes The number of meshes of the node.
+ @param scnMaterials The materials of the node, one for each mesh of the node.
+ @param archiveData The mapped scene archive which the node geometry is read
+ in place from, or nil if the node geometry owns its buffers.
+ @param context The context of the import.
+ @return A new geometry, or the geometry of the first chunk if it is split.
+ */
+- (SCNGeometry *)makeSCNGeometryFromGeometry:(AKNodeGeometry *)geometry
+                                      forKey:(NSValue *)key
+                                      meshes:(const unsigned int *)meshes
+                                       count:(unsigned int)nMeshes
+                                   materials:(NSArray *)scnMaterials
+                                 archiveData:(NSData *)archiveData
+                                     context:(AssimpImportContext *)context
+{
+    SCNAssimpImportSettings *settings = context.settings;
+    [self addQuantization:&geometry->quantization
+                 toReport:context.quantizationReport];
+    if (context.importStats != NULL)
+    {
+        AKImportStatsAddGeometry(context.importStats, geometry);
+    }
+    if (settings.splitsLargeGeometries &&
+        geometry->nVertices > settings.maxVerticesPerGeometry)
+    {
+        SCNGeometry *scnGeometry =
+            [self makeSCNGeometryChunksFromGeometry:geometry
+                                             forKey:key
+                                             meshes:meshes
+                                              count:nMeshes
+                                          materials:scnMaterials
+                                            context:context];
+        [self releaseGeometry:geometry archiveData:archiveData];
+        return scnGeometry;
+    }
+    // make SCNGeometry with sources, elements and materials
+    NSArray *scnGeometrySources =
+        [self makeGeometrySourcesForGeometry:geometry archiveData:archiveData];
+    NSArray *scnGeometryElements =
+        [self makeGeometryElementsForGeometry:geometry archiveData:archiveData];
+    SCNGeometry *scnGeometry =
+        [SCNGeometry geometryWithSources:scnGeometrySources
+                                elements:scnGeometryElements];
+    [self applyVertexDecodingToGeometry:scnGeometry fromGeometry:geometry];
+    [self releaseGeometry:geometry archiveData:archiveData];
+    if (scnMaterials.count > 0)
+    {
+        scnGeometry.materials = scnMaterials;
+        scnGeometry.firstMaterial = [scnMaterials objectAtIndex:0];
+    }
+    return scnGeometry;
+}
+
+/**
+ Releases a node geometry, either read in place from a scene archive or with
+ buffers of its own.
+
+ @param geometry The node geometry.
+ @param archiveData The mapped scene archive which the node geometry is read
+ in place from, or nil if the node geometry owns its buffers.
+ */
+- (void)releaseGeometry:(AKNodeGeometry *)geometry
+            archiveData:(NSData *)archiveData
+{
+    if (archiveData != nil)
+    {
+        AKSceneArchiveReleaseGeometryInPlace(geometry);
+    }
+    else
+    {
+        AKNodeGeometryRelease(geometry);
     }
-    return scnMaterials;
 }
 
 /**
- Creates a scenekit geometry to attach at the specified node.
-
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @param nVertices The total number of vertices in the meshes of the node.
- @param path The path to the scene file to load.
- @return A new geometry.
+ Splits the node geometry into chunks of at most maxVerticesPerGeometry
+ vertices of the import settings, and creates a scenekit geometry for each
+ chunk.
+
+ The chunks are recorded in the geometry chunks of the node, so that
+ the chunks but the first can be attached to child nodes and each chunk gets
+ its own skinner.
+
+ @param geometry The node geometry.
+ @param key The key of the geometry chunks of the node, the pointer to the
+ assimp node or to the archive node the geometry was made from.
+ @param meshes The indices of the meshes of the node.
+ @param nMeshes The number of meshes of the node.
+ @param scnMaterials The materials of the node, one for each mesh of the node.
+ @param context The context of the import.
+ @return The geometry of the first chunk, which is the geometry of the node.
  */
-- (SCNGeometry *)makeSCNGeometryFromAssimpNode:(const struct aiNode *)aiNode
-                                       inScene:(const struct aiScene *)aiScene
-                                  withVertices:(int)nVertices
-                                        atPath:(NSString *)path
-									imageCache:(AssimpImageCache *)imageCache
+- (SCNGeometry *)
+makeSCNGeometryChunksFromGeometry:(const AKNodeGeometry *)geometry
+                           forKey:(NSValue *)key
+                           meshes:(const unsigned int *)meshes
+                            count:(unsigned int)nMeshes
+                        materials:(NSArray *)scnMaterials
+                          context:(AssimpImportContext *)context
 {
-    // make SCNGeometry with sources, elements and materials
-    NSArray *scnGeometrySources = [self makeGeometrySourcesForNode:aiNode
-                                                           inScene:aiScene
-                                                      withVertices:nVertices];
-    if (scnGeometrySources.count > 0)
+    unsigned int maxVertices =
+        (unsigned int)MIN(MAX(context.settings.maxVerticesPerGeometry, 3),
+                          UINT_MAX);
+    unsigned int nChunks = 0;
+    AKNodeGeometry **chunks =
+        AKNodeGeometryCreateChunks(geometry, maxVertices, &nChunks);
+    DLog(@" Splitting geometry of %d vertices into %d chunks",
+         geometry->nVertices, nChunks);
+    NSMutableArray *scnChunks = [[NSMutableArray alloc] init];
+    for (unsigned int i = 0; i < nChunks; i++)
     {
-        NSArray *scnGeometryElements =
-            [self makeGeometryElementsforNode:aiNode inScene:aiScene];
-        SCNGeometry *scnGeometry =
-            [SCNGeometry geometryWithSources:scnGeometrySources
-                                    elements:scnGeometryElements];
-        NSArray *scnMaterials =
-            [self makeMaterialsForNode:aiNode inScene:aiScene atPath:path imageCache:imageCache];
-        if (scnMaterials.count > 0)
+        AKNodeGeometry *chunk = chunks[i];
+        SCNGeometry *scnGeometry = [SCNGeometry
+            geometryWithSources:[self makeGeometrySourcesForGeometry:chunk
+                                                         archiveData:nil]
+                       elements:[self makeGeometryElementsForGeometry:chunk
+                                                          archiveData:nil]];
+        [self applyVertexDecodingToGeometry:scnGeometry fromGeometry:chunk];
+        // pick the material of the node mesh of each element of the chunk
+        NSMutableArray *chunkMaterials = [[NSMutableArray alloc] init];
+        for (unsigned int j = 0; j < chunk->nElements; j++)
+        {
+            for (unsigned int k = 0; k < nMeshes; k++)
+            {
+                if (meshes[k] == chunk->elements[j].meshIndex &&
+                    k < scnMaterials.count)
+                {
+                    [chunkMaterials
+                        addObject:[scnMaterials objectAtIndex:k]];
+                    break;
+                }
+            }
+        }
+        if (chunkMaterials.count > 0)
         {
-            scnGeometry.materials = scnMaterials;
-            scnGeometry.firstMaterial = [scnMaterials objectAtIndex:0];
+            scnGeometry.materials = chunkMaterials;
+            scnGeometry.firstMaterial = [chunkMaterials objectAtIndex:0];
         }
-        return scnGeometry;
+        NSData *vertexMap = [NSData
+            dataWithBytesNoCopy:chunk->vertexMap
+                         length:chunk->nVertices * sizeof(unsigned int)
+                   freeWhenDone:YES];
+        chunk->vertexMap = NULL;
+        [scnChunks addObject:[NSMutableDictionary dictionaryWithDictionary:@{
+                       @"geometry" : scnGeometry,
+                       @"vertexMap" : vertexMap
+                   }]];
     }
-    return nil;
+    AKNodeGeometryChunksRelease(chunks, nChunks);
+    if (scnChunks.count == 0)
+    {
+        return nil;
+    }
+    [context.geometryChunks setObject:scnChunks forKey:key];
+    return [[scnChunks objectAtIndex:0] objectForKey:@"geometry"];
 }
 
 #pragma mark - Make scenekit lights
@@ -1210,56 +2892,6 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
  @name Make scenekit skinner
  */
 
-/**
- Finds the number of bones in the meshes of the specified node.
-
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @return The number of bones.
- */
-- (int)findNumBonesInNode:(const struct aiNode *)aiNode
-                  inScene:(const struct aiScene *)aiScene
-{
-    int nBones = 0;
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
-    {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        nBones += aiMesh->mNumBones;
-    }
-    return nBones;
-}
-
-/**
- Creates an array of bone names in the meshes of the specified node.
-
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @return An array of bone names.
- */
-- (NSArray *)getBoneNamesForAssimpNode:(const struct aiNode *)aiNode
-                               inScene:(const struct aiScene *)aiScene
-{
-    NSMutableArray *boneNames = [[NSMutableArray alloc] init];
-
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
-    {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        for (int j = 0; j < aiMesh->mNumBones; j++)
-        {
-            const struct aiBone *aiBone = aiMesh->mBones[j];
-            const struct aiString name = aiBone->mName;
-            [boneNames
-                addObject:[NSString
-                              stringWithUTF8String:(const char *_Nonnull) &
-                                                   name.data]];
-        }
-    }
-
-    return boneNames;
-}
-
 /**
  Creates a dictionary of bone transforms where bone name is the key, for the
  meshes of the specified node.
@@ -1324,20 +2956,22 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
 }
 
 /**
- Creates an array of scenekit bone nodes for the specified bone names.
+ Creates an array of scenekit bone nodes for the specified bone names, which
+ are looked up in the node index.
 
  @param scene The scenekit scene.
  @param boneNames The array of bone names.
+ @param context The context of the import.
  @return An array of scenekit bone nodes.
  */
 - (NSArray *)findBoneNodesInScene:(SCNScene *)scene
                          forBones:(NSArray *)boneNames
+                          context:(AssimpImportContext *)context
 {
     NSMutableArray *boneNodes = [[NSMutableArray alloc] init];
     for (NSString *boneName in boneNames)
     {
-        SCNNode *boneNode =
-            [scene.rootNode childNodeWithName:boneName recursively:YES];
+        SCNNode *boneNode = [context.nodeIndex objectForKey:boneName];
         [boneNodes addObject:boneNode];
     }
     return boneNodes;
@@ -1347,15 +2981,17 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
  Find the root node of the skeleton from the specified bone nodes.
 
  @param boneNodes The array of bone nodes.
+ @param context The context of the import.
  @return The root node of the skeleton.
  */
 - (SCNNode *)findSkeletonNodeFromBoneNodes:(NSArray *)boneNodes
+                                   context:(AssimpImportContext *)context
 {
     NSMutableDictionary *nodeDepths = [[NSMutableDictionary alloc] init];
     int minDepth = -1;
     for (SCNNode *boneNode in boneNodes)
     {
-        int depth = [self findDepthOfNodeFromRoot:boneNode];
+        int depth = [self findDepthOfNodeFromRoot:boneNode context:context];
         DLog(@" bone with depth is (min depth): %@ -> %d ( %d )", boneNode.name,
              depth, minDepth);
         if (minDepth == -1 || (depth <= minDepth))
@@ -1388,11 +3024,22 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
 /**
  Finds the depth of the specified node from the scene's root node.
 
+ The depth of a node made from an assimp node is recorded when the node is
+ made, otherwise it is found by walking up the parent nodes.
+
  @param node The scene node.
+ @param context The context of the import.
  @return The depth from the scene's root node.
  */
 - (int)findDepthOfNodeFromRoot:(SCNNode *)node
+                       context:(AssimpImportContext *)context
 {
+    NSValue *nodeKey = [NSValue valueWithNonretainedObject:node];
+    NSNumber *recordedDepth = [context.nodeDepths objectForKey:nodeKey];
+    if (recordedDepth != nil)
+    {
+        return recordedDepth.intValue;
+    }
     int depth = 0;
     SCNNode *pNode = node;
     while (pNode.parentNode)
@@ -1404,143 +3051,30 @@ makeIndicesGeometryElementForMeshIndex:(int)aiMeshIndex
 }
 
 /**
- Finds the maximum number of weights that influence the vertices in the meshes
- of the specified node.
-
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @return The maximum influences or weights.
- */
-- (int)findMaxWeightsForNode:(const struct aiNode *)aiNode
-                     inScene:(const struct aiScene *)aiScene
-{
-    int maxWeights = 0;
-
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
-    {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        NSMutableDictionary *meshWeights = [[NSMutableDictionary alloc] init];
-        for (int j = 0; j < aiMesh->mNumBones; j++)
-        {
-            const struct aiBone *aiBone = aiMesh->mBones[j];
-            for (int k = 0; k < aiBone->mNumWeights; k++)
-            {
-                const struct aiVertexWeight *aiVertexWeight =
-                    &aiBone->mWeights[k];
-                NSNumber *vertex =
-                    [NSNumber numberWithInt:aiVertexWeight->mVertexId];
-                if ([meshWeights valueForKey:vertex.stringValue] == nil)
-                {
-                    [meshWeights setValue:[NSNumber numberWithInt:1]
-                                   forKey:vertex.stringValue];
-                }
-                else
-                {
-                    NSNumber *weightCounts =
-                        [meshWeights valueForKey:vertex.stringValue];
-                    [meshWeights
-                        setValue:[NSNumber
-                                     numberWithInt:(weightCounts.intValue + 1)]
-                          forKey:vertex.stringValue];
-                }
-            }
-        }
-
-        // Find the vertex with most weights which is our max weights
-        for (int j = 0; j < aiMesh->mNumVertices; j++)
-        {
-            NSNumber *vertex = [NSNumber numberWithInt:j];
-            NSNumber *weightsCount =
-                [meshWeights valueForKey:vertex.stringValue];
-            if (weightsCount.intValue > maxWeights)
-            {
-                maxWeights = weightsCount.intValue;
-            }
-        }
-    }
-
-    return maxWeights;
-}
+ Creates the bone weights and bone indices geometry sources from a node skin.
 
-/**
- Creates a scenekit geometry source defining the influence of each bone on the
- positions of vertices in the geometry
+ The bone weights and bone indices are handed off to the data objects of the
+ geometry sources without a copy.
 
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @param nVertices The number of vertices in the meshes of the node.
- @param maxWeights The maximum number of weights influencing each vertex.
- @return A new geometry source whose semantic property is boneWeights.
+ @param skin The node skin, whose buffers are owned by the geometry sources
+ from now on.
+ @param archiveData The mapped scene archive which the node skin is read in
+ place from, or nil.
+ @return An array with the boneWeights and boneIndices geometry sources.
  */
-- (SCNGeometrySource *)
-makeBoneWeightsGeometrySourceAtNode:(const struct aiNode *)aiNode
-                            inScene:(const struct aiScene *)aiScene
-                       withVertices:(int)nVertices
-                         maxWeights:(int)maxWeights
+- (NSArray *)makeBoneGeometrySourcesForSkin:(AKNodeSkin *)skin
+                                archiveData:(NSData *)archiveData
 {
-    assert((nVertices > 0) && (maxWeights > 0));
-
-    float *nodeGeometryWeights = malloc(sizeof(float) * nVertices * maxWeights);
-    int weightCounter = 0;
-
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
-    {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        NSMutableDictionary *meshWeights = [[NSMutableDictionary alloc] init];
-        for (int j = 0; j < aiMesh->mNumBones; j++)
-        {
-            const struct aiBone *aiBone = aiMesh->mBones[j];
-            for (int k = 0; k < aiBone->mNumWeights; k++)
-            {
-                const struct aiVertexWeight *aiVertexWeight =
-                    &aiBone->mWeights[k];
-                NSNumber *vertex =
-                    [NSNumber numberWithInt:aiVertexWeight->mVertexId];
-                NSNumber *weight =
-                    [NSNumber numberWithFloat:aiVertexWeight->mWeight];
-                if ([meshWeights valueForKey:vertex.stringValue] == nil)
-                {
-                    NSMutableArray *weights = [[NSMutableArray alloc] init];
-                    [weights addObject:weight];
-                    [meshWeights setValue:weights forKey:vertex.stringValue];
-                }
-                else
-                {
-                    NSMutableArray *weights =
-                        [meshWeights valueForKey:vertex.stringValue];
-                    [weights addObject:weight];
-                }
-            }
-        }
-
-        // Add weights to the weights array for the entire node geometry
-        for (int j = 0; j < aiMesh->mNumVertices; j++)
-        {
-            NSNumber *vertex = [NSNumber numberWithInt:j];
-            NSMutableArray *weights =
-                [meshWeights valueForKey:vertex.stringValue];
-            int zeroWeights = maxWeights - (int)weights.count;
-            for (NSNumber *weight in weights)
-            {
-                nodeGeometryWeights[weightCounter++] = [weight floatValue];
-                // DLog(@" adding weight: %f", weight.floatValue);
-            }
-            for (int k = 0; k < zeroWeights; k++)
-            {
-                nodeGeometryWeights[weightCounter++] = 0.0;
-            }
-        }
-    }
-
-    DLog(@" weight counter %d", weightCounter);
-    assert(weightCounter == nVertices * maxWeights);
+    int nVertices = skin->nVertices;
+    int maxWeights = skin->maxWeights;
+    DLog(@" |--| Making bone geometry sources vertices: %d max-weights: %d",
+         nVertices, maxWeights);
 
     SCNGeometrySource *boneWeightsSource = [SCNGeometrySource
-        geometrySourceWithData:[NSData dataWithBytes:nodeGeometryWeights
-                                              length:nVertices * maxWeights *
-                                                     sizeof(float)]
+        geometrySourceWithData:[self makeDataWithBytes:skin->boneWeights
+                                                length:nVertices * maxWeights *
+                                                       sizeof(float)
+                                           archiveData:archiveData]
                       semantic:SCNGeometrySourceSemanticBoneWeights
                    vectorCount:nVertices
                floatComponents:YES
@@ -1548,94 +3082,11 @@ makeBoneWeightsGeometrySourceAtNode:(const struct aiNode *)aiNode
              bytesPerComponent:sizeof(float)
                     dataOffset:0
                     dataStride:maxWeights * sizeof(float)];
-    free(nodeGeometryWeights);
-    return boneWeightsSource;
-}
-
-/**
- Creates a scenekit geometry source defining the mapping from bone indices in
- skeleton data to the skinner’s bones array
-
- @param aiNode The assimp node.
- @param aiScene The assimp scene.
- @param nVertices The number of vertices in the meshes of the node.
- @param maxWeights The maximum number of weights influencing each vertex.
- @param boneNames The array of unique bone names.
- @return A new geometry source whose semantic property is boneIndices.
- */
-- (SCNGeometrySource *)
-makeBoneIndicesGeometrySourceAtNode:(const struct aiNode *)aiNode
-                            inScene:(const struct aiScene *)aiScene
-                       withVertices:(int)nVertices
-                         maxWeights:(int)maxWeights
-                          boneNames:(NSArray *)boneNames
-{
-    DLog(@" |--| Making bone indices geometry source: %@", boneNames);
-    short nodeGeometryBoneIndices[nVertices * maxWeights];
-    int indexCounter = 0;
-
-    for (int i = 0; i < aiNode->mNumMeshes; i++)
-    {
-        int aiMeshIndex = aiNode->mMeshes[i];
-        const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
-        NSMutableDictionary *meshBoneIndices =
-            [[NSMutableDictionary alloc] init];
-        for (int j = 0; j < aiMesh->mNumBones; j++)
-        {
-            const struct aiBone *aiBone = aiMesh->mBones[j];
-            for (int k = 0; k < aiBone->mNumWeights; k++)
-            {
-                const struct aiVertexWeight *aiVertexWeight =
-                    &aiBone->mWeights[k];
-                NSNumber *vertex =
-                    [NSNumber numberWithInt:aiVertexWeight->mVertexId];
-                const struct aiString name = aiBone->mName;
-                NSString *boneName = [NSString
-                    stringWithUTF8String:(const char *_Nonnull) & name.data];
-                NSNumber *boneIndex = [NSNumber
-                    numberWithInteger:[boneNames indexOfObject:boneName]];
-                if ([meshBoneIndices valueForKey:vertex.stringValue] == nil)
-                {
-                    NSMutableArray *boneIndices = [[NSMutableArray alloc] init];
-                    [boneIndices addObject:boneIndex];
-                    [meshBoneIndices setValue:boneIndices
-                                       forKey:vertex.stringValue];
-                }
-                else
-                {
-                    NSMutableArray *boneIndices =
-                        [meshBoneIndices valueForKey:vertex.stringValue];
-                    [boneIndices addObject:boneIndex];
-                }
-            }
-        }
-
-        // Add bone indices to the indices array for the entire node geometry
-        for (int j = 0; j < aiMesh->mNumVertices; j++)
-        {
-            NSNumber *vertex = [NSNumber numberWithInt:j];
-            NSMutableArray *boneIndices =
-                [meshBoneIndices valueForKey:vertex.stringValue];
-            int zeroIndices = maxWeights - (int)boneIndices.count;
-            for (NSNumber *boneIndex in boneIndices)
-            {
-                nodeGeometryBoneIndices[indexCounter++] =
-                    [boneIndex shortValue];
-                // DLog(@"  adding bone index: %d", boneIndex.shortValue);
-            }
-            for (int k = 0; k < zeroIndices; k++)
-            {
-                nodeGeometryBoneIndices[indexCounter++] = 0;
-            }
-        }
-    }
-
-    assert(indexCounter == nVertices * maxWeights);
-
     SCNGeometrySource *boneIndicesSource = [SCNGeometrySource
-        geometrySourceWithData:[NSData dataWithBytes:nodeGeometryBoneIndices
-                                              length:nVertices * maxWeights *
-                                                     sizeof(short)]
+        geometrySourceWithData:[self makeDataWithBytes:skin->boneIndices
+                                                length:nVertices * maxWeights *
+                                                       sizeof(short)
+                                           archiveData:archiveData]
                       semantic:SCNGeometrySourceSemanticBoneIndices
                    vectorCount:nVertices
                floatComponents:NO
@@ -1643,85 +3094,238 @@ makeBoneIndicesGeometrySourceAtNode:(const struct aiNode *)aiNode
              bytesPerComponent:sizeof(short)
                     dataOffset:0
                     dataStride:maxWeights * sizeof(short)];
-    return boneIndicesSource;
+    skin->boneWeights = NULL;
+    skin->boneIndices = NULL;
+    return @[ boneWeightsSource, boneIndicesSource ];
 }
 
 /**
  Builds a skeleton database of unique bone names and inverse bind bone
  transforms.
 
- When the scenekit scene is created from the assimp scene, a list of all bone
- names and a dictionary of bone transforms where each key is the bone name,
- is generated when parsing each node of the assimp scene.
+ When the scenekit scene is created from the assimp scene, a dictionary of
+ bone transforms where each key is the bone name, is generated when parsing
+ each node of the assimp scene. The unique bone names are taken from the bone
+ palette, so that the bones have the same order for every import of a file.
 
  @param scene The scenekit scene.
+ @param context The context of the import.
  */
 - (void)buildSkeletonDatabaseForScene:(SCNAssimpScene *)scene
+                              context:(AssimpImportContext *)context
 {
-    self.uniqueBoneNames = [[NSSet setWithArray:self.boneNames] allObjects];
-    DLog(@" |--| bone names %lu: %@", self.boneNames.count, self.boneNames);
-    DLog(@" |--| unique bone names %lu: %@", self.uniqueBoneNames.count,
-         self.uniqueBoneNames);
-    self.uniqueBoneNodes =
-        [self findBoneNodesInScene:scene forBones:self.uniqueBoneNames];
-    DLog(@" |--| unique bone nodes %lu: %@", self.uniqueBoneNodes.count,
-         self.uniqueBoneNodes);
-    self.uniqueBoneTransforms =
-        [self getTransformsForBones:self.uniqueBoneNames
-                     fromTransforms:self.boneTransforms];
+    unsigned int nBones = AKBonePaletteCount(context.bonePalette);
+    NSMutableArray *uniqueBoneNames =
+        [[NSMutableArray alloc] initWithCapacity:nBones];
+    for (unsigned int i = 0; i < nBones; i++)
+    {
+        [uniqueBoneNames
+            addObject:[NSString
+                          stringWithUTF8String:AKBonePaletteName(
+                                                   context.bonePalette, i)]];
+    }
+    context.uniqueBoneNames = uniqueBoneNames;
+    DLog(@" |--| unique bone names %lu: %@", context.uniqueBoneNames.count,
+         context.uniqueBoneNames);
+    context.uniqueBoneNodes = [self findBoneNodesInScene:scene
+                                                forBones:context.uniqueBoneNames
+                                                 context:context];
+    DLog(@" |--| unique bone nodes %lu: %@", context.uniqueBoneNodes.count,
+         context.uniqueBoneNodes);
+    context.uniqueBoneTransforms =
+        [self getTransformsForBones:context.uniqueBoneNames
+                     fromTransforms:context.boneTransforms];
     DLog(@" |--| unique bone transforms %lu: %@",
-         self.uniqueBoneTransforms.count, self.uniqueBoneTransforms);
-    self.skeleton = [self findSkeletonNodeFromBoneNodes:self.uniqueBoneNodes];
-    [scene setSkeletonNode:self.skeleton];
-    DLog(@" |--| skeleton bone is : %@", self.skeleton);
+         context.uniqueBoneTransforms.count, context.uniqueBoneTransforms);
+    context.skeleton =
+        [self findSkeletonNodeFromBoneNodes:context.uniqueBoneNodes
+                                    context:context];
+    [scene setSkeletonNode:context.skeleton];
+    DLog(@" |--| skeleton bone is : %@", context.skeleton);
+    AKSceneArchiveWriter *writer = context.archiveWriter;
+    if (writer != NULL)
+    {
+        for (unsigned int i = 0; i < nBones; i++)
+        {
+            float transform[16];
+            copyMatrixToArchiveTransform(
+                [[context.uniqueBoneTransforms objectAtIndex:i]
+                    SCNMatrix4Value],
+                transform);
+            AKSceneArchiveWriterAddBone(
+                writer, AKBonePaletteName(context.bonePalette, i), transform);
+        }
+        AKSceneArchiveWriterSetSkeleton(
+            writer, [context archiveIndexOfNode:context.skeleton]);
+    }
+}
+
+/**
+ Builds the skeleton database of a scene loaded from a scene archive, from the
+ bones of the archive, which are in the order of the bone palette of the scene
+ converted from the file.
+
+ @param scene The scenekit scene.
+ @param archive The scene archive.
+ @param nodes The scene nodes made from the nodes of the archive, in the same
+ order.
+ @param context The context of the import.
+ */
+- (void)buildSkeletonDatabaseForScene:(SCNAssimpScene *)scene
+                          fromArchive:(const AKSceneArchive *)archive
+                                nodes:(NSArray *)nodes
+                              context:(AssimpImportContext *)context
+{
+    const AKArchiveHeader *header = AKSceneArchiveGetHeader(archive);
+    NSMutableArray *uniqueBoneNames =
+        [[NSMutableArray alloc] initWithCapacity:header->nBones];
+    NSMutableArray *uniqueBoneTransforms =
+        [[NSMutableArray alloc] initWithCapacity:header->nBones];
+    for (unsigned int i = 0; i < header->nBones; i++)
+    {
+        const AKArchiveBone *bone = AKSceneArchiveBoneAt(archive, i);
+        [uniqueBoneNames
+            addObject:[NSString
+                          stringWithUTF8String:AKSceneArchiveString(
+                                                   archive, bone->name)]];
+        [uniqueBoneTransforms
+            addObject:[NSValue
+                          valueWithSCNMatrix4:makeMatrixFromArchiveTransform(
+                                                  bone->inverseBindTransform)]];
+    }
+    context.uniqueBoneNames = uniqueBoneNames;
+    context.uniqueBoneNodes = [self findBoneNodesInScene:scene
+                                                forBones:uniqueBoneNames
+                                                 context:context];
+    context.uniqueBoneTransforms = uniqueBoneTransforms;
+    // the skeleton of a scene without bones is not found, and a skeleton
+    // which is not an archived node is the scene's root node
+    SCNNode *skeleton = nil;
+    if (header->nBones > 0)
+    {
+        skeleton = header->skeletonNode != AKArchiveNone
+                       ? [nodes objectAtIndex:header->skeletonNode]
+                       : scene.rootNode;
+    }
+    context.skeleton = skeleton;
+    [scene setSkeletonNode:context.skeleton];
+    DLog(@" |--| skeleton bone is : %@", context.skeleton);
+}
+
+/**
+ Creates the bone weights and bone indices geometry sources of the geometry of
+ the specified node, or of each chunk of the geometry if it is split.
+
+ @param aiNode The assimp node.
+ @param aiScene The assimp scene.
+ @param context The context of the import, with the bone palette, the mesh
+ statistics of the scene and the geometry chunks of the node.
+ @return An array with the boneWeights and boneIndices geometry sources of
+ each chunk, or of the node geometry if it is not split, or nil if the meshes
+ of the node have no bones.
+ */
+- (NSArray *)makeBoneSourcesForAssimpNode:(const struct aiNode *)aiNode
+                                  inScene:(const struct aiScene *)aiScene
+                                  context:(AssimpImportContext *)context
+{
+    AKNodeSkin *skin = AKNodeSkinCreateWithStats(
+        aiNode, aiScene, context.bonePalette, context.sceneStats);
+    if (skin == NULL)
+    {
+        return nil;
+    }
+    NSValue *key = [NSValue valueWithPointer:aiNode];
+    if (context.archiveWriter != NULL)
+    {
+        SCNNode *node = [context.scnNodes objectForKey:key];
+        AKSceneArchiveWriterSetSkin(context.archiveWriter,
+                                    [context archiveIndexOfNode:node], skin);
+    }
+    NSArray *boneSources = [self makeBoneSourcesForSkin:skin
+                                                 forKey:key
+                                            archiveData:nil
+                                                context:context];
+    AKNodeSkinRelease(skin);
+    return boneSources;
+}
+
+/**
+ Creates the bone weights and bone indices geometry sources of a node skin,
+ or of each chunk of the node geometry if it is split.
+
+ @param skin The node skin, whose buffers are owned by the geometry sources
+ from now on if the node geometry is not split.
+ @param key The key of the geometry chunks of the node, the pointer to the
+ assimp node or to the archive node the geometry was made from.
+ @param archiveData The mapped scene archive which the node skin is read in
+ place from, or nil if the node skin owns its buffers.
+ @param context The context of the import.
+ @return An array with the boneWeights and boneIndices geometry sources of
+ each chunk, or of the node geometry if it is not split.
+ */
+- (NSArray *)makeBoneSourcesForSkin:(AKNodeSkin *)skin
+                             forKey:(NSValue *)key
+                        archiveData:(NSData *)archiveData
+                            context:(AssimpImportContext *)context
+{
+    NSArray *chunks = [context.geometryChunks objectForKey:key];
+    if (chunks == nil)
+    {
+        return @[ [self makeBoneGeometrySourcesForSkin:skin
+                                           archiveData:archiveData] ];
+    }
+    NSMutableArray *chunkSources =
+        [[NSMutableArray alloc] initWithCapacity:chunks.count];
+    for (NSDictionary *chunk in chunks)
+    {
+        NSData *vertexMap = [chunk objectForKey:@"vertexMap"];
+        AKNodeSkin *chunkSkin = AKNodeSkinCreateForVertexMap(
+            skin, (const unsigned int *)vertexMap.bytes,
+            (unsigned int)(vertexMap.length / sizeof(unsigned int)));
+        [chunkSources addObject:[self makeBoneGeometrySourcesForSkin:chunkSkin
+                                                         archiveData:nil]];
+        AKNodeSkinRelease(chunkSkin);
+    }
+    return chunkSources;
 }
 
 /**
  Creates a scenekit skinner for the specified node with visible geometry and
  skeleton information.
 
+ If the scene is trimmed as it is converted, the bone geometry sources of the
+ node were made with its geometry, as the bone weights of its meshes are freed
+ since.
+
  @param aiNode The assimp node.
  @param aiScene The assimp scene.
  @param scene The scenekit scene.
+ @param context The context of the import.
  */
 - (void)makeSkinnerForAssimpNode:(const struct aiNode *)aiNode
                          inScene:(const struct aiScene *)aiScene
                         scnScene:(SCNScene *)scene
+                         context:(AssimpImportContext *)context
 {
-    int nBones = [self findNumBonesInNode:aiNode inScene:aiScene];
-    const struct aiString *aiNodeName = &aiNode->mName;
-    NSString *nodeName = [NSString stringWithUTF8String:aiNodeName->data];
-    if (nBones > 0)
-    {
-        int nVertices = [self findNumVerticesInNode:aiNode inScene:aiScene];
-        int maxWeights = [self findMaxWeightsForNode:aiNode inScene:aiScene];
-        DLog(@" |--| Making Skinner for node: %@ vertices: %d max-weights: %d "
-             @"nBones: %d",
-             nodeName, nVertices, maxWeights, nBones);
-
-        SCNGeometrySource *boneWeights =
-            [self makeBoneWeightsGeometrySourceAtNode:aiNode
-                                              inScene:aiScene
-                                         withVertices:nVertices
-                                           maxWeights:maxWeights];
-        SCNGeometrySource *boneIndices =
-            [self makeBoneIndicesGeometrySourceAtNode:aiNode
-                                              inScene:aiScene
-                                         withVertices:nVertices
-                                           maxWeights:maxWeights
-                                            boneNames:self.uniqueBoneNames];
-
-        SCNNode *node =
-            [scene.rootNode childNodeWithName:nodeName recursively:YES];
-        SCNSkinner *skinner =
-            [SCNSkinner skinnerWithBaseGeometry:node.geometry
-                                          bones:self.uniqueBoneNodes
-                      boneInverseBindTransforms:self.uniqueBoneTransforms
-                                    boneWeights:boneWeights
-                                    boneIndices:boneIndices];
-        skinner.skeleton = self.skeleton;
-        DLog(@" assigned skinner %@ skeleton: %@", skinner, skinner.skeleton);
-        node.skinner = skinner;
+    if (!AKProgressAdvance(context.progress, AKImportPhaseSkin, 1))
+    {
+        return;
+    }
+    NSValue *key = [NSValue valueWithPointer:aiNode];
+    NSArray *boneSources =
+        context.sceneTrim != NULL
+            ? [context.boneSources objectForKey:key]
+            : [self makeBoneSourcesForAssimpNode:aiNode
+                                         inScene:aiScene
+                                         context:context];
+    if (boneSources != nil)
+    {
+        DLog(@" |--| Making Skinner for node: %s nBones: %d",
+             aiNode->mName.data, AKNumBonesInNode(aiNode, aiScene));
+        [self makeSkinnersForNode:[context.scnNodes objectForKey:key]
+                  withBoneSources:boneSources
+                           forKey:key
+                          context:context];
     }
 
     for (int i = 0; i < aiNode->mNumChildren; i++)
@@ -1730,11 +3334,71 @@ makeBoneIndicesGeometrySourceAtNode:(const struct aiNode *)aiNode
         if (aiChildNode != NULL) {
             [self makeSkinnerForAssimpNode:aiChildNode
                                    inScene:aiScene
-                                  scnScene:scene];
+                                  scnScene:scene
+                                   context:context];
         }
     }
 }
 
+/**
+ Creates a scenekit skinner for the geometry of the specified node, or for
+ each chunk of the geometry if it is split.
+
+ @param node The scene node with the geometry to skin.
+ @param boneSources The boneWeights and boneIndices geometry sources of each
+ chunk, or of the node geometry if it is not split.
+ @param key The key of the geometry chunks of the node, the pointer to the
+ assimp node or to the archive node the geometry was made from.
+ @param context The context of the import.
+ */
+- (void)makeSkinnersForNode:(SCNNode *)node
+            withBoneSources:(NSArray *)boneSources
+                     forKey:(NSValue *)key
+                    context:(AssimpImportContext *)context
+{
+    NSArray *chunks = [context.geometryChunks objectForKey:key];
+    if (chunks == nil)
+    {
+        [self makeSkinnerForNode:node
+                 withBoneSources:[boneSources objectAtIndex:0]
+                         context:context];
+        return;
+    }
+    DLog(@" |--| Making Skinners for %lu chunks of node: %@",
+         (unsigned long)chunks.count, node.name);
+    for (NSUInteger i = 0; i < chunks.count; i++)
+    {
+        [self makeSkinnerForNode:[[chunks objectAtIndex:i]
+                                     objectForKey:@"node"]
+                 withBoneSources:[boneSources objectAtIndex:i]
+                         context:context];
+    }
+}
+
+/**
+ Creates a scenekit skinner for the geometry of the specified node with the
+ bones and skeleton of the scene.
+
+ @param node The scene node with the geometry to skin.
+ @param boneSources The boneWeights and boneIndices geometry sources for the
+ geometry of the node.
+ @param context The context of the import.
+ */
+- (void)makeSkinnerForNode:(SCNNode *)node
+           withBoneSources:(NSArray *)boneSources
+                   context:(AssimpImportContext *)context
+{
+    SCNSkinner *skinner =
+        [SCNSkinner skinnerWithBaseGeometry:node.geometry
+                                      bones:context.uniqueBoneNodes
+                  boneInverseBindTransforms:context.uniqueBoneTransforms
+                                boneWeights:[boneSources objectAtIndex:0]
+                                boneIndices:[boneSources objectAtIndex:1]];
+    skinner.skeleton = context.skeleton;
+    DLog(@" assigned skinner %@ skeleton: %@", skinner, skinner.skeleton);
+    node.skinner = skinner;
+}
+
 #pragma mark - Make scenekit animations
 
 /**
@@ -1742,25 +3406,136 @@ makeBoneIndicesGeometrySourceAtNode:(const struct aiNode *)aiNode
  */
 
 /**
- Creates a dictionary of animations where each animation is a
- SCNAssimpAnimation, from each animation in the assimp scene.
+ Creates a keyframe animation for the specified key path from a keyframe track.
+
+ @param track The keyframe track.
+ @param keyPath The key path of the animated property: position, orientation
+ or scale.
+ @param duration The duration of the animation.
+ @return A new keyframe animation.
+ */
+- (CAKeyframeAnimation *)makeKeyframeAnimationFromTrack:
+                             (const AKKeyframeTrack *)track
+                                                keyPath:(NSString *)keyPath
+                                               duration:(float)duration
+{
+    NSMutableArray *values = [[NSMutableArray alloc] init];
+    NSMutableArray *keyTimes = [[NSMutableArray alloc] init];
+    for (int k = 0; k < track->nKeys; k++)
+    {
+        const float *value = &track->values[k * track->nComponents];
+        [keyTimes addObject:[NSNumber numberWithFloat:track->keyTimes[k]]];
+        if (track->nComponents == 4)
+        {
+            SCNVector4 quat =
+                SCNVector4Make(value[0], value[1], value[2], value[3]);
+            [values addObject:[NSValue valueWithSCNVector4:quat]];
+        }
+        else
+        {
+            SCNVector3 vector = SCNVector3Make(value[0], value[1], value[2]);
+            [values addObject:[NSValue valueWithSCNVector3:vector]];
+        }
+    }
+    CAKeyframeAnimation *keyFrameAnim =
+        [CAKeyframeAnimation animationWithKeyPath:keyPath];
+    keyFrameAnim.values = values;
+    keyFrameAnim.keyTimes = keyTimes;
+    keyFrameAnim.duration = duration;
+    return keyFrameAnim;
+}
+
+/**
+ Makes the name of an animation by appending the file name with an animation
+ index, such as walk-1 for the first animation in a file named walk.
+
+ @param index The index of the animation in the scene.
+ @param path The path to the scene file.
+ @return The name of the animation.
+ */
+- (NSString *)makeNameOfAnimationAtIndex:(unsigned int)index
+                                  atPath:(NSString *)path
+{
+    NSString *animIndex = [@"-"
+        stringByAppendingString:[NSNumber numberWithInt:index + 1].stringValue];
+    return [[[path lastPathComponent] stringByDeletingPathExtension]
+        stringByAppendingString:animIndex];
+}
+
+/**
+ Creates an animation from the keyframe tracks of an animation.
 
  For each animation's channel which is a bone node, a CAKeyframeAnimation is
  created for each of position, orientation and scale. These animations are
  then stored in an SCNAssimpAnimation object, which holds the animation name and
  the keyframe animations.
 
- The animation name is generated by appending the file name with an animation
- index. The example of an animation name is walk-1 for the first animation in a
- file named walk.
+ @param animName The name of the animation.
+ @param tracks The keyframe tracks of the animation.
+ @param progress The portable progress of the import, or NULL.
+ @return A new animation, which lacks the channels after a cancellation.
+ */
+- (SCNAssimpAnimation *)makeAnimationNamed:(NSString *)animName
+                                fromTracks:(const AKAnimationTracks *)tracks
+                                  progress:(AKProgress *)progress
+{
+    NSMutableDictionary *currentAnimation = [[NSMutableDictionary alloc] init];
+    float duration = tracks->duration;
+    for (int j = 0; j < tracks->nChannels; j++)
+    {
+        const AKChannelTracks *channel = &tracks->channels[j];
+        NSString *name = [NSString stringWithUTF8String:channel->nodeName];
+        DLog(@" The channel %@ has data for %d position, %d rotation, "
+             @"%d scale "
+             @"keyframes",
+             name, channel->position.nKeys, channel->orientation.nKeys,
+             channel->scale.nKeys);
+
+        // create a lookup for all animation keys
+        NSMutableDictionary *channelKeys = [[NSMutableDictionary alloc] init];
+        [channelKeys
+            setValue:[self makeKeyframeAnimationFromTrack:&channel->position
+                                                  keyPath:@"position"
+                                                 duration:duration]
+              forKey:@"position"];
+        [channelKeys
+            setValue:[self makeKeyframeAnimationFromTrack:&channel->orientation
+                                                  keyPath:@"orientation"
+                                                 duration:duration]
+              forKey:@"orientation"];
+        [channelKeys
+            setValue:[self makeKeyframeAnimationFromTrack:&channel->scale
+                                                  keyPath:@"scale"
+                                                 duration:duration]
+              forKey:@"scale"];
+
+        [currentAnimation setValue:channelKeys forKey:name];
+        if (!AKProgressAdvance(progress, AKImportPhaseAnimations, 1))
+        {
+            break;
+        }
+    }
+    return [[SCNAssimpAnimation alloc] initWithKey:animName
+                                        frameAnims:currentAnimation];
+}
+
+/**
+ Creates a dictionary of animations where each animation is a
+ SCNAssimpAnimation, from each animation in the assimp scene.
+
+ The keys of each assimp animation are freed by the scene trim of the import
+ as soon as its tracks are made, and the tracks are added to the scene
+ archive of the import.
 
  @param aiScene The assimp scene.
  @param scene The scenekit scene.
  @param path The path to the scene file to load.
+ @param context The context of the import.
  */
 - (void)createAnimationsFromScene:(const struct aiScene *)aiScene
                         withScene:(SCNAssimpScene *)scene
                            atPath:(NSString *)path
+                          context:(AssimpImportContext *)context
 {
     DLog(@" ========= Number of animations in scene: %d",
          aiScene->mNumAnimations);
@@ -1768,112 +3543,27 @@ makeBoneIndicesGeometrySourceAtNode:(const struct aiNode *)aiNode
     {
         DLog(@"--- Animation data for animation at index: %d", i);
         const struct aiAnimation *aiAnimation = aiScene->mAnimations[i];
-        NSString *animIndex = [@"-"
-            stringByAppendingString:[NSNumber numberWithInt:i + 1].stringValue];
-        NSString *animName = [[[path lastPathComponent]
-            stringByDeletingPathExtension] stringByAppendingString:animIndex];
+        NSString *animName = [self makeNameOfAnimationAtIndex:i atPath:path];
         DLog(@" Generated animation name: %@", animName);
-        NSMutableDictionary *currentAnimation =
-            [[NSMutableDictionary alloc] init];
         DLog(@" This animation %@ has %d channels with duration %f ticks "
              @"per sec: %f",
              animName, aiAnimation->mNumChannels, aiAnimation->mDuration,
              aiAnimation->mTicksPerSecond);
-        float duration;
-        if (aiAnimation->mTicksPerSecond != 0)
-        {
-            duration = aiAnimation->mDuration / aiAnimation->mTicksPerSecond;
-        }
-        else
+        AKAnimationTracks *tracks = AKAnimationTracksCreate(aiAnimation);
+        AKSceneTrimAnimation(context.sceneTrim, i);
+        if (context.archiveWriter != NULL)
         {
-            duration = aiAnimation->mDuration;
+            AKSceneArchiveWriterAddAnimation(context.archiveWriter, tracks);
         }
-        for (int j = 0; j < aiAnimation->mNumChannels; j++)
+        SCNAssimpAnimation *animation =
+            [self makeAnimationNamed:animName
+                          fromTracks:tracks
+                            progress:context.progress];
+        AKAnimationTracksRelease(tracks);
+        if (AKProgressIsCancelled(context.progress))
         {
-            const struct aiNodeAnim *aiNodeAnim = aiAnimation->mChannels[j];
-            const struct aiString *aiNodeName = &aiNodeAnim->mNodeName;
-            NSString *name = [NSString stringWithUTF8String:aiNodeName->data];
-            DLog(@" The channel %@ has data for %d position, %d rotation, "
-                 @"%d scale "
-                 @"keyframes",
-                 name, aiNodeAnim->mNumPositionKeys,
-                 aiNodeAnim->mNumRotationKeys, aiNodeAnim->mNumScalingKeys);
-
-            // create a lookup for all animation keys
-            NSMutableDictionary *channelKeys =
-                [[NSMutableDictionary alloc] init];
-
-            // create translation animation
-            NSMutableArray *translationValues = [[NSMutableArray alloc] init];
-            NSMutableArray *translationTimes = [[NSMutableArray alloc] init];
-            for (int k = 0; k < aiNodeAnim->mNumPositionKeys; k++)
-            {
-                const struct aiVectorKey *aiTranslationKey =
-                    &aiNodeAnim->mPositionKeys[k];
-                double keyTime = aiTranslationKey->mTime;
-                const struct aiVector3D aiTranslation =
-                    aiTranslationKey->mValue;
-                [translationTimes addObject:[NSNumber numberWithFloat:keyTime]];
-                SCNVector3 pos = SCNVector3Make(
-                    aiTranslation.x, aiTranslation.y, aiTranslation.z);
-                [translationValues addObject:[NSValue valueWithSCNVector3:pos]];
-            }
-            CAKeyframeAnimation *translationKeyFrameAnim =
-                [CAKeyframeAnimation animationWithKeyPath:@"position"];
-            translationKeyFrameAnim.values = translationValues;
-            translationKeyFrameAnim.keyTimes = translationTimes;
-            translationKeyFrameAnim.duration = duration;
-            [channelKeys setValue:translationKeyFrameAnim forKey:@"position"];
-
-            // create rotation animation
-            NSMutableArray *rotationValues = [[NSMutableArray alloc] init];
-            NSMutableArray *rotationTimes = [[NSMutableArray alloc] init];
-            for (int k = 0; k < aiNodeAnim->mNumRotationKeys; k++)
-            {
-                const struct aiQuatKey *aiQuatKey =
-                    &aiNodeAnim->mRotationKeys[k];
-                double keyTime = aiQuatKey->mTime;
-                const struct aiQuaternion aiQuaternion = aiQuatKey->mValue;
-                [rotationTimes addObject:[NSNumber numberWithFloat:keyTime]];
-                SCNVector4 quat =
-                    SCNVector4Make(aiQuaternion.x, aiQuaternion.y,
-                                   aiQuaternion.z, aiQuaternion.w);
-                [rotationValues addObject:[NSValue valueWithSCNVector4:quat]];
-            }
-            CAKeyframeAnimation *rotationKeyFrameAnim =
-                [CAKeyframeAnimation animationWithKeyPath:@"orientation"];
-            rotationKeyFrameAnim.values = rotationValues;
-            rotationKeyFrameAnim.keyTimes = rotationTimes;
-            rotationKeyFrameAnim.duration = duration;
-            [channelKeys setValue:rotationKeyFrameAnim forKey:@"orientation"];
-
-            // create scale animation
-            NSMutableArray *scaleValues = [[NSMutableArray alloc] init];
-            NSMutableArray *scaleTimes = [[NSMutableArray alloc] init];
-            for (int k = 0; k < aiNodeAnim->mNumScalingKeys; k++)
-            {
-                const struct aiVectorKey *aiScaleKey =
-                    &aiNodeAnim->mScalingKeys[k];
-                double keyTime = aiScaleKey->mTime;
-                const struct aiVector3D aiScale = aiScaleKey->mValue;
-                [scaleTimes addObject:[NSNumber numberWithFloat:keyTime]];
-                SCNVector3 scale =
-                    SCNVector3Make(aiScale.x, aiScale.y, aiScale.z);
-                [scaleValues addObject:[NSValue valueWithSCNVector3:scale]];
-            }
-            CAKeyframeAnimation *scaleKeyFrameAnim =
-                [CAKeyframeAnimation animationWithKeyPath:@"scale"];
-            scaleKeyFrameAnim.values = scaleValues;
-            scaleKeyFrameAnim.keyTimes = scaleTimes;
-            scaleKeyFrameAnim.duration = duration;
-            [channelKeys setValue:scaleKeyFrameAnim forKey:@"scale"];
-
-            [currentAnimation setValue:channelKeys forKey:name];
+            return;
         }
-
-        SCNAssimpAnimation *animation =
-            [[SCNAssimpAnimation alloc] initWithKey:animName
-                                         frameAnims:currentAnimation];
         [scene.animations setValue:animation forKey:animName];
     }
 }
@@ -1886,4 +3576,8 @@ makeBoneIndicesGeometrySourceAtNode:(const struct aiNode *)aiNode
     return ((const void*)aiImportFile(pFile, pFlags));
 }
 
+- (void)invokeAiReleaseImport:(const void*)pScene {
+    aiReleaseImport((const struct aiScene*)pScene);
+}
+
 @end
@@ -0,0 +1,183 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import <Foundation/Foundation.h>
+
+/**
+ The phases of an import, in the order they start.
+ */
+typedef NS_ENUM(NSInteger, SCNAssimpImportPhase) {
+    /**
+     The scene file is parsed by assimp.
+     */
+    SCNAssimpImportPhaseParse,
+    /**
+     The assimp scene is post processed.
+     */
+    SCNAssimpImportPhasePostProcess,
+    /**
+     The geometry of the nodes is converted.
+     */
+    SCNAssimpImportPhaseGeometry,
+    /**
+     The materials of the nodes are made.
+     */
+    SCNAssimpImportPhaseMaterials,
+    /**
+     The textures of the materials are loaded.
+     */
+    SCNAssimpImportPhaseTextures,
+    /**
+     The skinners of the skinned nodes are made.
+     */
+    SCNAssimpImportPhaseSkin,
+    /**
+     The skeletal animations are made.
+     */
+    SCNAssimpImportPhaseAnimations
+};
+
+/**
+ The block which receives the progress of an import.
+
+ @param phase The current phase.
+ @param fractionCompleted The completed fraction of the whole import, from 0
+ to 1.
+ */
+typedef void (^SCNAssimpImportProgressHandler)(SCNAssimpImportPhase phase,
+                                               float fractionCompleted);
+
+struct AKProgress;
+
+/**
+ SCNAssimpImportProgress reports the progress of an import in phases, and
+ cancels the import.
+
+ A cancelled import stops at its next checkpoint, releases the scene it made
+ so far and fails with NSUserCancelledError in NSCocoaErrorDomain. The
+ conversion is checked at least once per chunk of 1024 vertices, material,
+ texture, skinned node and animation channel. Parsing is checked whenever the
+ assimp loader reports its progress, which depends on the file format.
+
+ A progress object tracks a single import.
+ */
+@interface SCNAssimpImportProgress : NSObject
+
+#pragma mark - Creating an import progress
+
+/**
+ @name Creating an import progress
+ */
+
+/**
+ Makes the progress of an import which has not started.
+
+ @return A new import progress.
+ */
+- (id)init;
+
+#pragma mark - Progress reports
+
+/**
+ @name Progress reports
+ */
+
+/**
+ The block which receives the progress of the import, or nil.
+
+ The block is called whenever the phase changes or the completed fraction
+ grows by at least a hundredth.
+ */
+@property (copy) SCNAssimpImportProgressHandler progressHandler;
+
+/**
+ The queue on which the progress handler is called.
+
+ The default value is nil, which calls the progress handler on the main
+ queue.
+ */
+@property (strong) dispatch_queue_t progressQueue;
+
+/**
+ The current phase of the import.
+ */
+@property (readonly) SCNAssimpImportPhase phase;
+
+/**
+ The completed fraction of the whole import, from 0 to 1.
+ */
+@property (readonly) float fractionCompleted;
+
+#pragma mark - Cancelling an import
+
+/**
+ @name Cancelling an import
+ */
+
+/**
+ Cancels the import, which stops at its next checkpoint.
+
+ This method may be called from any thread, before or during the import.
+ */
+- (void)cancel;
+
+/**
+ Determines if the import was cancelled.
+ */
+@property (readonly, getter=isCancelled) BOOL cancelled;
+
+/**
+ The time from cancelling the import to the first checkpoint which stopped
+ it, in seconds, or a negative value if the import was not stopped by a
+ cancel.
+
+ The latency is measured by the import, so it is read once the import has
+ completed.
+ */
+@property (readonly) NSTimeInterval cancellationLatency;
+
+#pragma mark - Core progress
+
+/**
+ @name Core progress
+ */
+
+/**
+ The portable progress which the importer reports to and checks for
+ cancellation.
+ */
+@property (readonly, nonatomic) struct AKProgress *coreProgress;
+
+@end
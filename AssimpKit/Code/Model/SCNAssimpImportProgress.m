@@ -0,0 +1,162 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import "SCNAssimpImportProgress.h"
+#include "AKProgress.h"
+
+@interface SCNAssimpImportProgress ()
+
+/**
+ The current phase of the import.
+ */
+@property (readwrite) SCNAssimpImportPhase phase;
+
+/**
+ The completed fraction of the whole import, from 0 to 1.
+ */
+@property (readwrite) float fractionCompleted;
+
+/**
+ The portable progress which the importer reports to and checks for
+ cancellation.
+ */
+@property (readwrite, nonatomic) struct AKProgress *coreProgress;
+
+@end
+
+#pragma mark - Core progress callback
+
+/**
+ Receives the progress of the import from the portable progress and passes it
+ on to the progress handler.
+
+ @param context The import progress.
+ @param phase The current phase.
+ @param fractionCompleted The completed fraction of the whole import.
+ */
+static void reportImportProgress(void *context,
+                                 AKImportPhase phase,
+                                 float fractionCompleted)
+{
+    SCNAssimpImportProgress *progress =
+        (__bridge SCNAssimpImportProgress *)context;
+    progress.phase = (SCNAssimpImportPhase)phase;
+    progress.fractionCompleted = fractionCompleted;
+    SCNAssimpImportProgressHandler progressHandler = progress.progressHandler;
+    if (progressHandler != nil)
+    {
+        dispatch_queue_t queue = progress.progressQueue != nil
+                                     ? progress.progressQueue
+                                     : dispatch_get_main_queue();
+        dispatch_async(queue, ^{
+          progressHandler((SCNAssimpImportPhase)phase, fractionCompleted);
+        });
+    }
+}
+
+@implementation SCNAssimpImportProgress
+
+#pragma mark - Creating an import progress
+
+/**
+ @name Creating an import progress
+ */
+
+/**
+ Makes the progress of an import which has not started.
+
+ @return A new import progress.
+ */
+- (id)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.phase = SCNAssimpImportPhaseParse;
+        self.fractionCompleted = 0.0f;
+        // the importer retains the progress while it reports to it
+        self.coreProgress =
+            AKProgressCreate(reportImportProgress, (__bridge void *)self);
+    }
+    return self;
+}
+
+/**
+ Releases the portable progress.
+ */
+- (void)dealloc
+{
+    AKProgressRelease(self.coreProgress);
+}
+
+#pragma mark - Cancelling an import
+
+/**
+ @name Cancelling an import
+ */
+
+/**
+ Cancels the import, which stops at its next checkpoint.
+
+ This method may be called from any thread, before or during the import.
+ */
+- (void)cancel
+{
+    AKProgressCancel(self.coreProgress);
+}
+
+/**
+ Determines if the import was cancelled.
+
+ @return YES if the import was cancelled.
+ */
+- (BOOL)isCancelled
+{
+    return AKProgressIsCancelled(self.coreProgress);
+}
+
+/**
+ The time from cancelling the import to the first checkpoint which stopped
+ it.
+
+ @return The latency in seconds, or a negative value if the import was not
+ stopped by a cancel.
+ */
+- (NSTimeInterval)cancellationLatency
+{
+    return AKProgressCancellationLatency(self.coreProgress);
+}
+
+@end
@@ -0,0 +1,334 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import <Foundation/Foundation.h>
+#import "SCNAssimpSceneCache.h"
+#import "SCNAssimpVertexLayout.h"
+
+/**
+ The block which supplies the bytes of a file which a scene refers to, such as
+ a texture or the material library of an OBJ file.
+
+ @param name The path of the file relative to the directory of the scene, as
+ the scene refers to it.
+ @return The bytes of the file, or nil to read the file from the disk.
+ */
+typedef NSData * (^SCNAssimpResourceResolver)(NSString *name);
+
+/**
+ The parts of a scene which an import converts.
+
+ The materials, the textures and the skinning are parts of the geometry and
+ are only imported with it. The assimp post processing steps which only serve
+ the parts left out are skipped.
+ */
+typedef NS_OPTIONS(NSUInteger, SCNAssimpImportComponents) {
+    /**
+     The geometries of the nodes.
+     */
+    SCNAssimpImportComponentGeometry = 1 << 0,
+    /**
+     The materials of the geometries.
+     */
+    SCNAssimpImportComponentMaterials = 1 << 1,
+    /**
+     The textures of the materials. The materials of an import without
+     textures get the colors of their properties instead.
+     */
+    SCNAssimpImportComponentTextures = 1 << 2,
+    /**
+     The skinners of the skinned geometries.
+     */
+    SCNAssimpImportComponentSkinning = 1 << 3,
+    /**
+     The skeletal animations.
+     */
+    SCNAssimpImportComponentAnimations = 1 << 4,
+    /**
+     The cameras of the nodes.
+     */
+    SCNAssimpImportComponentCameras = 1 << 5,
+    /**
+     The lights of the nodes.
+     */
+    SCNAssimpImportComponentLights = 1 << 6,
+    /**
+     Every part of the scene.
+     */
+    SCNAssimpImportComponentAll = (1 << 7) - 1
+};
+
+/**
+ SCNAssimpImportSettings configures how the assimp scene graph of an imported
+ file is converted into a scenekit scene graph.
+ */
+@interface SCNAssimpImportSettings : NSObject <NSCopying>
+
+#pragma mark - Scene components
+
+/**
+ @name Scene components
+ */
+
+/**
+ The parts of the scene to import, such as only the animations of a file
+ which animates a model imported before.
+
+ The nodes are always imported. An import of the animations without the
+ geometry still finds the skeleton from the bones of the meshes, so that its
+ animation scenes are the same as those of a full import.
+
+ The default value is SCNAssimpImportComponentAll.
+ */
+@property SCNAssimpImportComponents components;
+
+#pragma mark - Geometry
+
+/**
+ @name Geometry
+ */
+
+/**
+ Determines if the geometry of a node with more than maxVerticesPerGeometry
+ vertices is split into chunks, so that each chunk can use 16 bit indices.
+
+ The first chunk is the geometry of the node. Each further chunk is the
+ geometry of a child node named after the node with a -chunk-N suffix, where N
+ is the chunk number starting from 1. Skinned chunks share the skeleton of the
+ node.
+
+ When the geometry is not split, each geometry element uses 8, 16 or 32 bit
+ indices, whichever is the narrowest to address all of its vertices.
+
+ The default value is NO.
+ */
+@property BOOL splitsLargeGeometries;
+
+/**
+ The maximum number of vertices in a geometry chunk when
+ splitsLargeGeometries is YES.
+
+ The default value is 65535, the largest number of vertices addressed by 16
+ bit indices.
+ */
+@property NSUInteger maxVerticesPerGeometry;
+
+/**
+ The vertex layout, which picks the imported vertex attributes and their
+ formats.
+
+ The default value is a vertex layout which imports every attribute as floats.
+ */
+@property SCNAssimpVertexLayout *vertexLayout;
+
+#pragma mark - Assimp import
+
+/**
+ @name Assimp import
+ */
+
+/**
+ The maximum number of vertices in a mesh split by the
+ AssimpKit_Process_SplitLargeMeshes post processing step.
+
+ The default value is 1000000.
+ */
+@property NSUInteger meshSplitVertexLimit;
+
+/**
+ The maximum number of triangles in a mesh split by the
+ AssimpKit_Process_SplitLargeMeshes post processing step.
+
+ The default value is 1000000.
+ */
+@property NSUInteger meshSplitTriangleLimit;
+
+/**
+ The maximum number of bones which affect a vertex, kept by the
+ AssimpKit_Process_LimitBoneWeights post processing step.
+
+ The default value is 4.
+ */
+@property NSUInteger maxBoneWeightsPerVertex;
+
+/**
+ The number of vertices in the post transform vertex cache of the GPU, which
+ the AssimpKit_Process_ImproveCacheLocality post processing step optimizes
+ the triangle order for.
+
+ The default value is 12.
+ */
+@property NSUInteger vertexCacheSize;
+
+/**
+ The maximum angle in degrees, from 0 to 175, between two face normals at a
+ vertex which the AssimpKit_Process_GenSmoothNormals post processing step
+ smooths together.
+
+ The default value is 175.
+ */
+@property float maxSmoothingAngle;
+
+/**
+ Determines if assimp is hinted to favour the speed of the import over its
+ quality.
+
+ The default value is NO.
+ */
+@property BOOL favoursSpeed;
+
+#pragma mark - Reading files
+
+/**
+ @name Reading files
+ */
+
+/**
+ The block which supplies the files which the scene refers to, such as its
+ textures, so that a scene can be imported from pack files or decrypted
+ blobs without writing them to the disk.
+
+ The bytes returned are read in place and are not copied. The files which
+ the block does not supply are read from the disk.
+
+ The default value is nil, which reads every file from the disk.
+ */
+@property (copy) SCNAssimpResourceResolver resourceResolver;
+
+/**
+ Determines if the files read from the disk are memory mapped instead of read
+ with buffered reads.
+
+ The default value is NO.
+ */
+@property BOOL mapsFiles;
+
+/**
+ The cache of converted scenes which a file import loads its scene from, if
+ the file was converted before with the same post processing flags and
+ settings, instead of reading the file with assimp. A file import which does
+ not find its scene in the cache stores the scene it converts.
+
+ A scene loaded from the cache is the same as the scene converted from the
+ file, and its import stats have loadedFromCache set. Its texture files are
+ read again, but the other files which the scene refers to, such as the
+ material library of an OBJ file, are not part of the key of the scene, so
+ the scene must be removed from the cache when they change. The imports from
+ memory do not use the cache.
+
+ The default value is nil, which converts every scene.
+ */
+@property SCNAssimpSceneCache *sceneCache;
+
+#pragma mark - Conversion
+
+/**
+ @name Conversion
+ */
+
+/**
+ The number of workers which convert the geometries of the nodes of the scene
+ at the same time, or 0 for one worker per processor.
+
+ The scene made is the same for any number of workers. A batch import, which
+ already imports several files at the same time, converts each scene on one
+ worker unless this is set.
+
+ The default value is 0.
+ */
+@property NSUInteger conversionWorkers;
+
+/**
+ Determines if the import lowers its peak memory by converting the scene one
+ node at a time and freeing the data of the assimp scene as soon as it is
+ converted, instead of keeping the whole assimp scene until the end of the
+ import.
+
+ The geometry of each node is converted when its scene node is made, on the
+ calling thread, and the bone weights of a skinned node are made right after
+ its geometry. The vertices, faces and bone weights of a mesh are then freed,
+ once every node which uses the mesh is made. The keys of each animation are
+ freed as soon as its tracks are made, and the embedded textures once every
+ material is made. The peak memory of the import is then close to the larger
+ of the assimp scene and the scenekit scene instead of their sum.
+
+ The scene made is the same as without this setting, but the conversion of
+ the geometry is not spread over the conversionWorkers.
+
+ The default value is NO.
+ */
+@property BOOL minimizesPeakMemory;
+
+#pragma mark - Import stats
+
+/**
+ @name Import stats
+ */
+
+/**
+ Determines if the import measures the time of each import phase, the counts
+ of the scene, the bytes of its geometry and the memory of each phase into
+ the import stats of the scene.
+
+ The measurements add a few clock reads for each node, material and texture,
+ a walk of the assimp scene to count it, and a count of each buffer the
+ conversion core allocates. The files read are counted either way.
+
+ The default value is NO.
+ */
+@property BOOL measuresImport;
+
+#pragma mark - Creating import settings
+
+/**
+ @name Creating import settings
+ */
+
+/**
+ Makes an import settings object with the default values.
+
+ @return A settings object with the default values.
+ */
+- (id)init;
+
+/**
+ Makes a copy of the import settings, including a copy of the vertex layout.
+
+ @param zone Unused.
+ @return A settings object with the same values.
+ */
+- (id)copyWithZone:(NSZone *)zone;
+
+@end
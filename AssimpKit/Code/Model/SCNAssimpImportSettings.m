@@ -0,0 +1,108 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import "SCNAssimpImportSettings.h"
+
+/**
+ SCNAssimpImportSettings configures how the assimp scene graph of an imported
+ file is converted into a scenekit scene graph.
+ */
+@implementation SCNAssimpImportSettings
+
+#pragma mark - Creating import settings
+
+/**
+ @name Creating import settings
+ */
+
+/**
+ Makes an import settings object with the default values.
+
+ @return A settings object with the default values.
+ */
+- (id)init
+{
+    self = [super init];
+    if (self)
+    {
+        self.components = SCNAssimpImportComponentAll;
+        self.splitsLargeGeometries = NO;
+        self.maxVerticesPerGeometry = 65535;
+        self.vertexLayout = [[SCNAssimpVertexLayout alloc] init];
+        self.meshSplitVertexLimit = 1000000;
+        self.meshSplitTriangleLimit = 1000000;
+        self.maxBoneWeightsPerVertex = 4;
+        self.vertexCacheSize = 12;
+        self.maxSmoothingAngle = 175.0f;
+        self.favoursSpeed = NO;
+        self.resourceResolver = nil;
+        self.mapsFiles = NO;
+        self.sceneCache = nil;
+        self.conversionWorkers = 0;
+        self.minimizesPeakMemory = NO;
+        self.measuresImport = NO;
+    }
+    return self;
+}
+
+/**
+ Makes a copy of the import settings, including a copy of the vertex layout.
+
+ @param zone Unused.
+ @return A settings object with the same values.
+ */
+- (id)copyWithZone:(NSZone *)zone
+{
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.components = self.components;
+    settings.splitsLargeGeometries = self.splitsLargeGeometries;
+    settings.maxVerticesPerGeometry = self.maxVerticesPerGeometry;
+    settings.vertexLayout = [self.vertexLayout copy];
+    settings.meshSplitVertexLimit = self.meshSplitVertexLimit;
+    settings.meshSplitTriangleLimit = self.meshSplitTriangleLimit;
+    settings.maxBoneWeightsPerVertex = self.maxBoneWeightsPerVertex;
+    settings.vertexCacheSize = self.vertexCacheSize;
+    settings.maxSmoothingAngle = self.maxSmoothingAngle;
+    settings.favoursSpeed = self.favoursSpeed;
+    settings.resourceResolver = self.resourceResolver;
+    settings.mapsFiles = self.mapsFiles;
+    settings.sceneCache = self.sceneCache;
+    settings.conversionWorkers = self.conversionWorkers;
+    settings.minimizesPeakMemory = self.minimizesPeakMemory;
+    settings.measuresImport = self.measuresImport;
+    return settings;
+}
+
+@end
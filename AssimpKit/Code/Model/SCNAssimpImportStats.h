@@ -0,0 +1,311 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import <Foundation/Foundation.h>
+#import "SCNAssimpImportProgress.h"
+#import "SCNAssimpPhaseMemory.h"
+
+/**
+ SCNAssimpImportStats has the measurements of the import of a scene, such as
+ the files read while the scene was imported.
+
+ The files read are always counted. The time of the import phases, the counts
+ of the scene, the bytes of its geometry and the memory of the import are
+ measured when the measuresImport import setting is YES, and are zero
+ otherwise.
+ */
+@interface SCNAssimpImportStats : NSObject
+
+#pragma mark - Import phases
+
+/**
+ @name Import phases
+ */
+
+/**
+ The time spent parsing the scene file, measured with a monotonic clock as
+ every phase.
+ */
+@property (readwrite, nonatomic) NSTimeInterval parseTime;
+
+/**
+ The time spent in the assimp post processing steps.
+ */
+@property (readwrite, nonatomic) NSTimeInterval postProcessTime;
+
+/**
+ The time spent converting the geometries and making the nodes, apart from
+ their materials.
+ */
+@property (readwrite, nonatomic) NSTimeInterval geometryTime;
+
+/**
+ The time spent making the materials, apart from their textures.
+ */
+@property (readwrite, nonatomic) NSTimeInterval materialsTime;
+
+/**
+ The time spent loading the textures.
+ */
+@property (readwrite, nonatomic) NSTimeInterval texturesTime;
+
+/**
+ The time spent finding the skeleton and making the skinners.
+ */
+@property (readwrite, nonatomic) NSTimeInterval skinTime;
+
+/**
+ The time spent making the animations and the animation scenes.
+ */
+@property (readwrite, nonatomic) NSTimeInterval animationsTime;
+
+#pragma mark - Scene counts
+
+/**
+ @name Scene counts
+ */
+
+/**
+ The number of nodes of the assimp scene.
+ */
+@property (readwrite, nonatomic) NSUInteger nodes;
+
+/**
+ The number of meshes of the assimp scene.
+ */
+@property (readwrite, nonatomic) NSUInteger meshes;
+
+/**
+ The number of bones of the meshes, each bone counted once by name.
+ */
+@property (readwrite, nonatomic) NSUInteger bones;
+
+/**
+ The number of position, rotation and scaling keys of the animations.
+ */
+@property (readwrite, nonatomic) NSUInteger keyframes;
+
+/**
+ The number of vertices of the node geometries, before they are split.
+ */
+@property (readwrite, nonatomic) NSUInteger vertices;
+
+/**
+ The number of indices of the node geometries, before they are split.
+ */
+@property (readwrite, nonatomic) NSUInteger indices;
+
+/**
+ The number of textures decoded.
+ */
+@property (readwrite, nonatomic) NSUInteger texturesDecoded;
+
+/**
+ The number of textures shared with a material which decoded them before.
+ */
+@property (readwrite, nonatomic) NSUInteger texturesCached;
+
+#pragma mark - Geometry bytes
+
+/**
+ @name Geometry bytes
+ */
+
+/**
+ The number of bytes of the vertex positions.
+ */
+@property (readwrite, nonatomic) NSUInteger positionBytes;
+
+/**
+ The number of bytes of the vertex normals.
+ */
+@property (readwrite, nonatomic) NSUInteger normalBytes;
+
+/**
+ The number of bytes of the vertex tangents.
+ */
+@property (readwrite, nonatomic) NSUInteger tangentBytes;
+
+/**
+ The number of bytes of the vertex texture coordinates.
+ */
+@property (readwrite, nonatomic) NSUInteger texCoordBytes;
+
+/**
+ The number of bytes of the vertex colors.
+ */
+@property (readwrite, nonatomic) NSUInteger colorBytes;
+
+/**
+ The number of bytes of the indices.
+ */
+@property (readwrite, nonatomic) NSUInteger indexBytes;
+
+#pragma mark - Reading files
+
+/**
+ @name Reading files
+ */
+
+/**
+ Determines if the scene was loaded from the scene cache of the import
+ settings instead of read from its file with assimp. A scene loaded from the
+ cache reads its texture files without the file system of an assimp import,
+ so it counts no files, and its parse and post process phases take no time.
+ */
+@property (readwrite, nonatomic) BOOL loadedFromCache;
+
+/**
+ The number of files opened, including the files opened again from the handle
+ cache.
+ */
+@property (readwrite, nonatomic) NSUInteger fileOpens;
+
+/**
+ The number of files opened on the disk, which is at most one for each file.
+ */
+@property (readwrite, nonatomic) NSUInteger diskFileOpens;
+
+/**
+ The number of files opened again from the handle cache without opening them
+ on the disk.
+ */
+@property (readwrite, nonatomic) NSUInteger cachedFileOpens;
+
+/**
+ The number of files, such as textures, read ahead before they were opened.
+ */
+@property (readwrite, nonatomic) NSUInteger readAheads;
+
+/**
+ The number of reads from the files.
+ */
+@property (readwrite, nonatomic) NSUInteger reads;
+
+/**
+ The number of bytes read from the files.
+ */
+@property (readwrite, nonatomic) NSUInteger bytesRead;
+
+/**
+ The time spent opening, reading ahead and reading the files.
+ */
+@property (readwrite, nonatomic) NSTimeInterval ioTime;
+
+#pragma mark - Memory
+
+/**
+ @name Memory
+ */
+
+/**
+ The memory of each import phase, indexed by SCNAssimpImportPhase.
+
+ The materials and the textures are made with the nodes, so that their
+ buffers are charged to the geometry phase and the memory of their phases is
+ zero. The decoded textures are counted in textureMemoryBytes.
+ */
+@property (readwrite, nonatomic) NSArray *phaseMemory;
+
+/**
+ Returns the memory of an import phase.
+
+ @param phase The import phase.
+ @return The memory of the phase.
+ */
+- (SCNAssimpPhaseMemory *)memoryOfPhase:(SCNAssimpImportPhase)phase;
+
+/**
+ The largest number of bytes allocated by the conversion core at once.
+ */
+@property (readwrite, nonatomic) NSUInteger peakMemoryBytes;
+
+/**
+ The largest memory footprint of the process at the end of a phase.
+ */
+@property (readwrite, nonatomic) NSUInteger peakFootprintBytes;
+
+/**
+ The number of bytes of the decoded textures, which are drawn from the
+ textures as they are decoded, four bytes per pixel for most images.
+ */
+@property (readwrite, nonatomic) NSUInteger textureMemoryBytes;
+
+/**
+ An estimate of the number of bytes of the assimp scene, which the import
+ holds until the scenekit scene is made.
+ */
+@property (readwrite, nonatomic) NSUInteger sceneMemoryBytes;
+
+#pragma mark - Creating import stats
+
+/**
+ @name Creating import stats
+ */
+
+/**
+ Makes import stats whose measurements are all zero.
+
+ @return New import stats.
+ */
+- (id)init;
+
+#pragma mark - Serializing import stats
+
+/**
+ @name Serializing import stats
+ */
+
+/**
+ Makes a dictionary of the import stats, which NSJSONSerialization can
+ serialize, to aggregate the stats of imports across sessions.
+
+ The dictionary has the phase times in seconds under "phases", the counts,
+ the bytes of each vertex attribute under "attributeBytes", the files read
+ under "files" and the memory under "memory", with the keys of the JSON of
+ the portable import stats.
+
+ @return The dictionary of the import stats.
+ */
+- (NSDictionary *)dictionaryRepresentation;
+
+/**
+ Makes the JSON of the import stats.
+
+ @return The UTF-8 JSON of the dictionary representation.
+ */
+- (NSData *)JSONData;
+
+@end
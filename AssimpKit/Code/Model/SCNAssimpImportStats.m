@@ -0,0 +1,182 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import "SCNAssimpImportStats.h"
+
+/**
+ SCNAssimpImportStats has the measurements of the import of a scene, such as
+ the files read while the scene was imported.
+
+ The files read are always counted. The time of the import phases, the counts
+ of the scene, the bytes of its geometry and the memory of the import are
+ measured when the measuresImport import setting is YES, and are zero
+ otherwise.
+ */
+@implementation SCNAssimpImportStats
+
+#pragma mark - Creating import stats
+
+/**
+ @name Creating import stats
+ */
+
+/**
+ Makes import stats whose measurements are all zero.
+
+ @return New import stats.
+ */
+- (id)init
+{
+    self = [super init];
+    if (self)
+    {
+        NSMutableArray *phaseMemory = [[NSMutableArray alloc] init];
+        for (NSInteger phase = SCNAssimpImportPhaseParse;
+             phase <= SCNAssimpImportPhaseAnimations; phase++)
+        {
+            [phaseMemory addObject:[[SCNAssimpPhaseMemory alloc] init]];
+        }
+        self.phaseMemory = phaseMemory;
+    }
+    return self;
+}
+
+#pragma mark - Memory
+
+/**
+ @name Memory
+ */
+
+/**
+ Returns the memory of an import phase.
+
+ @param phase The import phase.
+ @return The memory of the phase.
+ */
+- (SCNAssimpPhaseMemory *)memoryOfPhase:(SCNAssimpImportPhase)phase
+{
+    return [self.phaseMemory objectAtIndex:phase];
+}
+
+#pragma mark - Serializing import stats
+
+/**
+ @name Serializing import stats
+ */
+
+/**
+ Makes a dictionary of the import stats, which NSJSONSerialization can
+ serialize, to aggregate the stats of imports across sessions.
+
+ The dictionary has the phase times in seconds under "phases", the counts,
+ the bytes of each vertex attribute under "attributeBytes", the files read
+ under "files" and the memory under "memory", with the keys of the JSON of
+ the portable import stats.
+
+ @return The dictionary of the import stats.
+ */
+- (NSDictionary *)dictionaryRepresentation
+{
+    NSArray *phaseNames = @[
+        @"parse", @"postProcess", @"geometry", @"materials", @"textures",
+        @"skin", @"animations"
+    ];
+    NSMutableDictionary *phaseMemory = [[NSMutableDictionary alloc] init];
+    for (NSUInteger i = 0; i < phaseNames.count; i++)
+    {
+        [phaseMemory
+            setObject:[[self.phaseMemory objectAtIndex:i]
+                          dictionaryRepresentation]
+               forKey:[phaseNames objectAtIndex:i]];
+    }
+    return @{
+        @"phases" : @{
+            @"parse" : @(self.parseTime),
+            @"postProcess" : @(self.postProcessTime),
+            @"geometry" : @(self.geometryTime),
+            @"materials" : @(self.materialsTime),
+            @"textures" : @(self.texturesTime),
+            @"skin" : @(self.skinTime),
+            @"animations" : @(self.animationsTime)
+        },
+        @"nodes" : @(self.nodes),
+        @"meshes" : @(self.meshes),
+        @"bones" : @(self.bones),
+        @"keyframes" : @(self.keyframes),
+        @"vertices" : @(self.vertices),
+        @"indices" : @(self.indices),
+        @"texturesDecoded" : @(self.texturesDecoded),
+        @"texturesCached" : @(self.texturesCached),
+        @"attributeBytes" : @{
+            @"position" : @(self.positionBytes),
+            @"normal" : @(self.normalBytes),
+            @"tangent" : @(self.tangentBytes),
+            @"texCoord" : @(self.texCoordBytes),
+            @"color" : @(self.colorBytes)
+        },
+        @"indexBytes" : @(self.indexBytes),
+        @"files" : @{
+            @"opens" : @(self.fileOpens),
+            @"diskOpens" : @(self.diskFileOpens),
+            @"cachedOpens" : @(self.cachedFileOpens),
+            @"readAheads" : @(self.readAheads),
+            @"reads" : @(self.reads),
+            @"bytesRead" : @(self.bytesRead),
+            @"ioSeconds" : @(self.ioTime)
+        },
+        @"memory" : @{
+            @"phases" : phaseMemory,
+            @"peak" : @(self.peakMemoryBytes),
+            @"peakFootprint" : @(self.peakFootprintBytes),
+            @"textures" : @(self.textureMemoryBytes),
+            @"scene" : @(self.sceneMemoryBytes)
+        }
+    };
+}
+
+/**
+ Makes the JSON of the import stats.
+
+ @return The UTF-8 JSON of the dictionary representation.
+ */
+- (NSData *)JSONData
+{
+    return [NSJSONSerialization
+        dataWithJSONObject:[self dictionaryRepresentation]
+                   options:0
+                     error:nil];
+}
+
+@end
@@ -0,0 +1,78 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import <Foundation/Foundation.h>
+
+/**
+ SCNAssimpPhaseMemory has the memory of an import phase: the buffers which the
+ conversion core allocated in the phase, and the memory footprint of the
+ process at the end of the phase.
+ */
+@interface SCNAssimpPhaseMemory : NSObject
+
+/**
+ The number of bytes the conversion core allocated in the phase.
+ */
+@property (readwrite, nonatomic) NSUInteger bytesAllocated;
+
+/**
+ The number of bytes allocated by the conversion core which were still
+ allocated at the end of the phase, such as the vertices handed over to the
+ geometry sources, whichever phase allocated them.
+ */
+@property (readwrite, nonatomic) NSUInteger bytesRetained;
+
+/**
+ The largest number of bytes allocated by the conversion core at once in the
+ phase.
+ */
+@property (readwrite, nonatomic) NSUInteger peakBytes;
+
+/**
+ The memory footprint of the process at the end of the phase, which includes
+ the assimp scene, the scenekit objects and the memory of the rest of the
+ process, or 0 if the import did not enter the phase.
+ */
+@property (readwrite, nonatomic) NSUInteger footprintBytes;
+
+/**
+ Makes a dictionary of the memory of the phase, which NSJSONSerialization can
+ serialize.
+
+ @return The dictionary of the memory of the phase.
+ */
+- (NSDictionary *)dictionaryRepresentation;
+
+@end
@@ -0,0 +1,90 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import <Foundation/Foundation.h>
+
+/**
+ SCNAssimpQuantizationReport has the error of the quantized vertex attributes
+ of an imported scene, and the memory saved by quantizing them.
+
+ The errors are the maximum over all the geometries of the scene, measured
+ against the attributes of the assimp meshes. An attribute imported as floats
+ has no error.
+ */
+@interface SCNAssimpQuantizationReport : NSObject
+
+#pragma mark - Quantization error
+
+/**
+ @name Quantization error
+ */
+
+/**
+ The maximum distance between a restored position and its original position,
+ in scene units.
+ */
+@property (readwrite, nonatomic) float maxPositionError;
+
+/**
+ The maximum angle between a restored normal and its original normal, in
+ degrees.
+ */
+@property (readwrite, nonatomic) float maxNormalAngleError;
+
+/**
+ The maximum angle between a restored tangent and its original tangent, in
+ degrees.
+ */
+@property (readwrite, nonatomic) float maxTangentAngleError;
+
+/**
+ The maximum difference between a restored texture coordinate component and
+ its original component.
+ */
+@property (readwrite, nonatomic) float maxTexCoordError;
+
+#pragma mark - Quantization savings
+
+/**
+ @name Quantization savings
+ */
+
+/**
+ The number of bytes of vertex data saved compared to importing the same
+ attributes as floats.
+ */
+@property (readwrite, nonatomic) NSUInteger bytesSaved;
+
+@end
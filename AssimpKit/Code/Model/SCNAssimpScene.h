@@ -35,6 +35,43 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #import <SceneKit/SceneKit.h>
 #import "SCNAssimpAnimation.h"
+#import "SCNAssimpImportStats.h"
+#import "SCNAssimpQuantizationReport.h"
+
+@class SCNAssimpScene;
+
+/**
+ The block which receives the result of an asynchronous import.
+
+ @param scene The imported scene, or nil if no scene could be loaded.
+ @param error The import error if no scene could be loaded, otherwise nil.
+ */
+typedef void (^SCNAssimpSceneCompletionHandler)(SCNAssimpScene *scene,
+                                                NSError *error);
+
+/**
+ The block which receives each scene of a batch import as its import
+ completes.
+
+ @param index The index of the scene file in the batch.
+ @param scene The imported scene, or nil if no scene could be loaded.
+ @param error The import error if no scene could be loaded, otherwise nil.
+ */
+typedef void (^SCNAssimpBatchSceneHandler)(NSUInteger index,
+                                           SCNAssimpScene *scene,
+                                           NSError *error);
+
+/**
+ The block which receives the results of a batch import, in the order of the
+ scene files of the batch.
+
+ @param scenes The imported scenes, with NSNull for each scene which could
+ not be loaded.
+ @param errors The import errors, with NSNull for each scene which was
+ loaded.
+ */
+typedef void (^SCNAssimpBatchCompletionHandler)(NSArray *scenes,
+                                                NSArray *errors);
 
 /**
  A scene graph—a hierarchy of nodes with attached geometries, lights, cameras
@@ -61,6 +98,52 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 @property (readonly, nonatomic) NSDictionary *animationScenes;
 
+#pragma mark - Node index
+
+/**
+ @name Node index
+ */
+
+/**
+ The dictionary of scene nodes, where key is the node name.
+
+ The index is built while the assimp scene graph is converted. If more than one
+ node has the same name, the first node in depth first order is indexed.
+ */
+@property (readwrite, nonatomic) NSDictionary *nodeIndex;
+
+/**
+ Return the scene node with the specified name.
+
+ @param name The node name.
+ @return The scene node, or nil if the scene has no node with this name.
+ */
+- (SCNNode *)nodeForName:(NSString *)name;
+
+#pragma mark - Vertex quantization
+
+/**
+ @name Vertex quantization
+ */
+
+/**
+ The error and the savings of the vertex attributes quantized by the vertex
+ layout of the import settings.
+ */
+@property (readwrite, nonatomic)
+    SCNAssimpQuantizationReport *quantizationReport;
+
+#pragma mark - Import stats
+
+/**
+ @name Import stats
+ */
+
+/**
+ The measurements of the import of the scene, such as the files read.
+ */
+@property (readwrite, nonatomic) SCNAssimpImportStats *importStats;
+
 #pragma mark - Animation data
 
 /**
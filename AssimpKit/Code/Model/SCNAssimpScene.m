@@ -101,10 +101,30 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     {
         self.animations = [[NSMutableDictionary alloc] init];
         self.animationScenes = [[NSMutableDictionary alloc] init];
+        self.nodeIndex = [[NSDictionary alloc] init];
+        self.quantizationReport = [[SCNAssimpQuantizationReport alloc] init];
+        self.importStats = [[SCNAssimpImportStats alloc] init];
     }
     return self;
 }
 
+#pragma mark - Node index
+
+/**
+ @name Node index
+ */
+
+/**
+ Return the scene node with the specified name.
+
+ @param name The node name.
+ @return The scene node, or nil if the scene has no node with this name.
+ */
+- (SCNNode *)nodeForName:(NSString *)name
+{
+    return [self.nodeIndex objectForKey:name];
+}
+
 #pragma mark - Add, fetch SCNAssimpAnimation animations
 
 /**
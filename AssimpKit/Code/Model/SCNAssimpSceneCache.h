@@ -0,0 +1,137 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import <Foundation/Foundation.h>
+
+/**
+ SCNAssimpSceneCache keeps the converted scenes of the files imported with it
+ in a directory, so that a file imported again with the same settings is
+ loaded from its converted scene without reading it with assimp.
+
+ A converted scene is stored in a single file which holds the nodes, the
+ vertex and index buffers, the materials, the embedded textures, the skins
+ and the keyframe tracks of the scene, laid out to be memory mapped. It is
+ found by a hash of the bytes of the scene file, the post processing flags,
+ the import settings which change the converted scene and the version of
+ AssimpKit, so that a change to any of them converts the scene again.
+
+ The files referred to by the scene, such as its texture files, are not part
+ of the hash, and are loaded again by each import. The cache keeps the total
+ size of its scenes under its cap by removing the scenes used least recently.
+
+ A scene cache can be used by several imports at the same time, such as by
+ the imports of a batch.
+ */
+@interface SCNAssimpSceneCache : NSObject
+
+#pragma mark - Creating a scene cache
+
+/**
+ @name Creating a scene cache
+ */
+
+/**
+ Makes a scene cache in a directory, which is created if it does not exist.
+
+ The converted scenes of another version of the cache format are removed from
+ the directory.
+
+ @param directory The path of the directory.
+ @param maxBytes The maximum total size of the converted scenes, or 0 for no
+ cap.
+ @return A new scene cache, or nil if the directory could not be created.
+ */
+- (id)initWithDirectory:(NSString *)directory maxBytes:(NSUInteger)maxBytes;
+
+#pragma mark - Cache directory
+
+/**
+ @name Cache directory
+ */
+
+/**
+ The path of the directory of the cache.
+ */
+@property (readonly, nonatomic) NSString *directory;
+
+/**
+ The maximum total size of the converted scenes, or 0 for no cap.
+ */
+@property (readonly, nonatomic) NSUInteger maxBytes;
+
+/**
+ The total size of the converted scenes in the cache.
+ */
+@property (readonly) NSUInteger cachedBytes;
+
+/**
+ Removes every converted scene of the cache.
+ */
+- (void)removeAllScenes;
+
+#pragma mark - Cache statistics
+
+/**
+ @name Cache statistics
+ */
+
+/**
+ The number of imports which loaded their scene from the cache.
+ */
+@property (readonly) NSUInteger hits;
+
+/**
+ The number of imports which did not find their scene in the cache.
+ */
+@property (readonly) NSUInteger misses;
+
+/**
+ The number of converted scenes removed to keep the cache under its cap.
+ */
+@property (readonly) NSUInteger evictions;
+
+#pragma mark - Core cache
+
+/**
+ @name Core cache
+ */
+
+/**
+ The portable scene cache which the importer loads and stores the converted
+ scenes with.
+ */
+@property (readonly, nonatomic) struct AKSceneCache *coreCache;
+
+@end
@@ -0,0 +1,163 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import "SCNAssimpSceneCache.h"
+#include "AKSceneCache.h"
+
+@interface SCNAssimpSceneCache ()
+
+/**
+ The path of the directory of the cache.
+ */
+@property (readwrite, nonatomic) NSString *directory;
+
+/**
+ The maximum total size of the converted scenes, or 0 for no cap.
+ */
+@property (readwrite, nonatomic) NSUInteger maxBytes;
+
+/**
+ The portable scene cache which the importer loads and stores the converted
+ scenes with.
+ */
+@property (readwrite, nonatomic) struct AKSceneCache *coreCache;
+
+@end
+
+@implementation SCNAssimpSceneCache
+
+#pragma mark - Creating a scene cache
+
+/**
+ @name Creating a scene cache
+ */
+
+/**
+ Makes a scene cache in a directory, which is created if it does not exist.
+
+ The converted scenes of another version of the cache format are removed from
+ the directory.
+
+ @param directory The path of the directory.
+ @param maxBytes The maximum total size of the converted scenes, or 0 for no
+ cap.
+ @return A new scene cache, or nil if the directory could not be created.
+ */
+- (id)initWithDirectory:(NSString *)directory maxBytes:(NSUInteger)maxBytes
+{
+    self = [super init];
+    if (self)
+    {
+        self.directory = directory;
+        self.maxBytes = maxBytes;
+        self.coreCache = AKSceneCacheCreate(directory.fileSystemRepresentation,
+                                            maxBytes);
+        if (self.coreCache == NULL)
+        {
+            return nil;
+        }
+    }
+    return self;
+}
+
+/**
+ Releases the portable scene cache, keeping its converted scenes.
+ */
+- (void)dealloc
+{
+    AKSceneCacheRelease(self.coreCache);
+}
+
+#pragma mark - Cache directory
+
+/**
+ @name Cache directory
+ */
+
+/**
+ The total size of the converted scenes in the cache.
+
+ @return The size in bytes.
+ */
+- (NSUInteger)cachedBytes
+{
+    return AKSceneCacheBytes(self.coreCache);
+}
+
+/**
+ Removes every converted scene of the cache.
+ */
+- (void)removeAllScenes
+{
+    AKSceneCacheRemoveAll(self.coreCache);
+}
+
+#pragma mark - Cache statistics
+
+/**
+ @name Cache statistics
+ */
+
+/**
+ The number of imports which loaded their scene from the cache.
+
+ @return The number of hits.
+ */
+- (NSUInteger)hits
+{
+    return AKSceneCacheGetStats(self.coreCache).hits;
+}
+
+/**
+ The number of imports which did not find their scene in the cache.
+
+ @return The number of misses.
+ */
+- (NSUInteger)misses
+{
+    return AKSceneCacheGetStats(self.coreCache).misses;
+}
+
+/**
+ The number of converted scenes removed to keep the cache under its cap.
+
+ @return The number of evictions.
+ */
+- (NSUInteger)evictions
+{
+    return AKSceneCacheGetStats(self.coreCache).evictions;
+}
+
+@end
@@ -0,0 +1,158 @@
+
+/*
+---------------------------------------------------------------------------
+Assimp to Scene Kit Library (AssimpKit)
+---------------------------------------------------------------------------
+ Copyright (c) 2016, Deepak Surti, Ison Apps, AssimpKit team
+All rights reserved.
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+* Neither the name of the AssimpKit team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the AssimpKit team.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+#import <Foundation/Foundation.h>
+
+/**
+ The storage format of the components of a vertex attribute.
+ */
+typedef NS_ENUM(NSInteger, SCNAssimpVertexFormat) {
+    /**
+     The attribute is not imported.
+     */
+    SCNAssimpVertexFormatNone = 0,
+
+    /**
+     Each component is a 32 bit float.
+     */
+    SCNAssimpVertexFormatFloat,
+
+    /**
+     Each component is a 16 bit half float. Applies to every attribute.
+     */
+    SCNAssimpVertexFormatHalf,
+
+    /**
+     Each component is a signed normalized 16 bit integer. Applies to
+     positions, normals and tangents.
+     */
+    SCNAssimpVertexFormatSNorm16,
+
+    /**
+     The unit vector is stored as two octahedral coordinates, each a signed
+     normalized 16 bit integer. Applies to normals and tangents.
+     */
+    SCNAssimpVertexFormatOctSNorm16,
+
+    /**
+     The rgba components are unsigned normalized 8 bit integers. Applies to
+     colors.
+     */
+    SCNAssimpVertexFormatUNorm8
+};
+
+/**
+ SCNAssimpVertexLayout describes which vertex attributes are imported and in
+ which format.
+
+ The imported attributes of a geometry are interleaved in a single buffer, and
+ each geometry source is a view with an offset and stride into that buffer.
+ An attribute which no mesh of a node has is not imported for that node, even
+ if the layout includes it. A format which does not apply to an attribute
+ imports that attribute as floats.
+
+ Quantized positions are stored relative to the bounds of their geometry,
+ and quantized normals and tangents may be octahedral. The geometry decodes
+ them with a geometry shader modifier and has the bounding box of the
+ restored positions. As the shader modifier runs on the geometry before it is
+ skinned, quantized positions are meant for static geometry.
+ */
+@interface SCNAssimpVertexLayout : NSObject <NSCopying>
+
+#pragma mark - Vertex attribute formats
+
+/**
+ @name Vertex attribute formats
+ */
+
+/**
+ The format of the vertex positions. The positions are always imported, as
+ floats if this is SCNAssimpVertexFormatNone.
+
+ The default value is SCNAssimpVertexFormatFloat.
+ */
+@property SCNAssimpVertexFormat positionFormat;
+
+/**
+ The format of the vertex normals.
+
+ The default value is SCNAssimpVertexFormatFloat.
+ */
+@property SCNAssimpVertexFormat normalFormat;
+
+/**
+ The format of the vertex tangents.
+
+ The default value is SCNAssimpVertexFormatFloat.
+ */
+@property SCNAssimpVertexFormat tangentFormat;
+
+/**
+ The format of the texture coordinates of the first uv channel.
+
+ The default value is SCNAssimpVertexFormatFloat.
+ */
+@property SCNAssimpVertexFormat texCoordFormat;
+
+/**
+ The format of the vertex colors of the first color set, which are only
+ imported for a node if every mesh of the node has vertex colors.
+
+ The default value is SCNAssimpVertexFormatFloat.
+ */
+@property SCNAssimpVertexFormat colorFormat;
+
+#pragma mark - Creating a vertex layout
+
+/**
+ @name Creating a vertex layout
+ */
+
+/**
+ Makes a vertex layout which imports every attribute as floats.
+
+ @return A vertex layout with the default formats.
+ */
+- (id)init;
+
+/**
+ Makes a copy of the vertex layout.
+
+ @param zone Unused.
+ @return A vertex layout with the same formats.
+ */
+- (id)copyWithZone:(NSZone *)zone;
+
+@end
@@ -37,6 +37,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #import <SceneKit/SceneKit.h>
 #import "SCNAssimpScene.h"
 #import "PostProcessingFlags.h"
+#import "SCNAssimpImportSettings.h"
+#import "SCNAssimpImportProgress.h"
 
 /**
  A scenekit SCNScene category to import scenes using the assimp library.
@@ -50,7 +52,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
 /**
-  Returns the array of file extensions for all the supported formats.
+  Returns the array of file extensions for all the supported formats,
+  including the .akscene extension of the compiled scene assets.
 
   @return The array of supported file extensions
 */
@@ -89,6 +92,41 @@ DEPRECATED_MSG_ATTRIBUTE("Please use assimpSceneNamed:postProcessFlags:error:");
                     postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
                                error:(NSError **)error;
 
+/**
+ Loads a scene from a file with the specified name in the app’s main bundle,
+ with the specified import settings.
+
+ @param name The name of a scene file in the app bundle’s resources directory.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param error Scene loading error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
++ (SCNAssimpScene *)assimpSceneNamed:(NSString *)name
+                    postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                            settings:(SCNAssimpImportSettings *)settings
+                               error:(NSError **)error;
+
+/**
+ Loads a scene from a file with the specified name in the app’s main bundle,
+ with the specified import settings, without blocking the calling thread.
+
+ The file is parsed and converted on the conversion queue of AssimpImporter.
+
+ @param name The name of a scene file in the app bundle’s resources directory.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param queue The queue on which to call the completion handler, or nil for
+ the main queue.
+ @param completionHandler The block which receives the new scene object, or
+ nil and the scene loading error if no scene could be loaded.
+ */
++ (void)assimpSceneNamed:(NSString *)name
+        postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                settings:(SCNAssimpImportSettings *)settings
+         completionQueue:(dispatch_queue_t)queue
+       completionHandler:(SCNAssimpSceneCompletionHandler)completionHandler;
+
 /**
  Loads a scene from the specified NSString URL.
 
@@ -115,4 +153,125 @@ DEPRECATED_MSG_ATTRIBUTE(
                           (AssimpKitPostProcessSteps)postProcessFlags
                                  error:(NSError **)error;
 
+/**
+ Loads a scene from the specified NSString URL with the specified import
+ settings.
+
+ @param url The NSString URL to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param error Scene loading error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
++ (SCNAssimpScene *)assimpSceneWithURL:(NSURL *)url
+                      postProcessFlags:
+                          (AssimpKitPostProcessSteps)postProcessFlags
+                              settings:(SCNAssimpImportSettings *)settings
+                                 error:(NSError **)error;
+
+/**
+ Loads a scene from a scene file in memory with the specified import
+ settings, without writing it to the disk.
+
+ @param data The contents of the scene file, which are read in place.
+ @param hint The file extension of the scene file, such as @"obj".
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings. Its
+ resource resolver supplies the files which the scene refers to.
+ @param error Scene loading error.
+ @return A new scene object, or nil if no scene could be loaded.
+ */
++ (SCNAssimpScene *)assimpSceneWithData:(NSData *)data
+                                   hint:(NSString *)hint
+                       postProcessFlags:
+                           (AssimpKitPostProcessSteps)postProcessFlags
+                               settings:(SCNAssimpImportSettings *)settings
+                                  error:(NSError **)error;
+
+/**
+ Loads a scene from the specified NSString URL with the specified import
+ settings, without blocking the calling thread.
+
+ The file is parsed and converted on the conversion queue of AssimpImporter.
+
+ @param url The NSString URL to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param queue The queue on which to call the completion handler, or nil for
+ the main queue.
+ @param completionHandler The block which receives the new scene object, or
+ nil and the scene loading error if no scene could be loaded.
+ */
++ (void)assimpSceneWithURL:(NSURL *)url
+          postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                  settings:(SCNAssimpImportSettings *)settings
+           completionQueue:(dispatch_queue_t)queue
+         completionHandler:(SCNAssimpSceneCompletionHandler)completionHandler;
+
+/**
+ Loads a scene from the specified NSString URL with the specified import
+ settings, reporting the progress of the import, without blocking the calling
+ thread.
+
+ The file is parsed and converted on the conversion queue of AssimpImporter.
+ A cancelled import calls the completion handler with the error
+ NSUserCancelledError in NSCocoaErrorDomain.
+
+ @param url The NSString URL to the scene file to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param progress The progress of the import, or nil.
+ @param queue The queue on which to call the completion handler, or nil for
+ the main queue.
+ @param completionHandler The block which receives the new scene object, or
+ nil and the scene loading error if no scene could be loaded.
+ */
++ (void)assimpSceneWithURL:(NSURL *)url
+          postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                  settings:(SCNAssimpImportSettings *)settings
+                  progress:(SCNAssimpImportProgress *)progress
+           completionQueue:(dispatch_queue_t)queue
+         completionHandler:(SCNAssimpSceneCompletionHandler)completionHandler;
+
+/**
+ Loads the scenes from the specified file URLs with the specified import
+ settings on a pool of workers, without blocking the calling thread.
+
+ The batch is loaded on the conversion queue of AssimpImporter.
+
+ Each worker starts with its own share of the files, the largest first, and
+ steals files from the other workers once it runs out, so that every worker
+ stays busy until the whole batch is loaded. The files imported at the same
+ time are never larger in total than maxBytesInFlight, which bounds the peak
+ memory of the batch, except for a file larger than maxBytesInFlight which is
+ imported on its own.
+
+ The scene handler receives each scene as its import completes, and the
+ completion handler receives all the scenes in the order of the URLs once the
+ batch is loaded. Both are called on the completion queue, and if the queue is
+ serial, every scene handler is called before the completion handler.
+
+ @param urls The file URLs of the scene files to load.
+ @param postProcessFlags The flags for all possible post processing steps.
+ @param settings The import settings, or nil for the default settings.
+ @param nWorkers The number of scenes imported at the same time, or 0 for one
+ per processor.
+ @param maxBytesInFlight The largest total size of the files imported at the
+ same time, or 0 for no limit.
+ @param queue The queue on which to call the handlers, or nil for the main
+ queue.
+ @param sceneHandler The block which receives each scene as it is loaded, or
+ nil.
+ @param completionHandler The block which receives the scenes and the errors
+ in the order of the URLs.
+ */
++ (void)assimpScenesWithURLs:(NSArray *)urls
+            postProcessFlags:(AssimpKitPostProcessSteps)postProcessFlags
+                    settings:(SCNAssimpImportSettings *)settings
+                     workers:(NSUInteger)nWorkers
+            maxBytesInFlight:(unsigned long long)maxBytesInFlight
+             completionQueue:(dispatch_queue_t)queue
+                sceneHandler:(SCNAssimpBatchSceneHandler)sceneHandler
+           completionHandler:(SCNAssimpBatchCompletionHandler)completionHandler;
+
 @end
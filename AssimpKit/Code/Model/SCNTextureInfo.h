@@ -36,6 +36,9 @@
 #import <Foundation/Foundation.h>
 #include "assimp/scene.h"       // Output data structure
 
+#import "SCNAssimpImportSettings.h"
+#include "AKSceneArchive.h"
+
 @class AssimpImageCache;
 
 @interface SCNTextureInfo : NSObject
@@ -56,13 +59,53 @@
  @param aiTextureType The texture type: diffuse, specular etc.
  @param aiScene The assimp scene.
  @param path The path to the scene file to load.
+ @param imageCache The cache of the images loaded for the import.
+ @param loadsTextures YES to load the textures, NO to apply the colors of the
+ material property instead.
+ @param resourceResolver The block which supplies the external textures, or
+ nil to read them from the disk.
  @return A new texture info.
  */
 - (id)initWithMeshIndex:(int)aiMeshIndex
             textureType:(enum aiTextureType)aiTextureType
                 inScene:(const struct aiScene *)aiScene
                  atPath:(NSString *)path
-			 imageCache:(AssimpImageCache *)imageCache;
+			 imageCache:(AssimpImageCache *)imageCache
+          loadsTextures:(BOOL)loadsTextures
+       resourceResolver:(SCNAssimpResourceResolver)resourceResolver;
+
+/**
+ Create a texture metadata object for a material property of a scene loaded
+ from a scene archive.
+
+ @param slot The material property of the archive.
+ @param archive The scene archive.
+ @param path The path to the scene file the archive was made from.
+ @param imageCache The cache of the images loaded for the import.
+ @param resourceResolver The block which supplies the external textures, or
+ nil to read them from the disk.
+ @return A new texture info.
+ */
+- (id)initWithArchiveSlot:(const AKArchiveMaterialSlot *)slot
+                inArchive:(const AKSceneArchive *)archive
+                   atPath:(NSString *)path
+               imageCache:(AssimpImageCache *)imageCache
+         resourceResolver:(SCNAssimpResourceResolver)resourceResolver;
+
+#pragma mark - Recording a texture info
+
+/**
+ Adds the material property to a material of a scene archive, with the
+ embedded texture it shows. It must be called before the contents are
+ released.
+
+ @param writer The scene archive writer.
+ @param material The index of the material.
+ @param aiScene The assimp scene.
+ */
+- (void)recordSlotInArchive:(AKSceneArchiveWriter *)writer
+                   material:(unsigned int)material
+                    inScene:(const struct aiScene *)aiScene;
 
 #pragma mark - Getting texture contents
 /**
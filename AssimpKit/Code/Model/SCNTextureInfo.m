@@ -105,6 +105,24 @@
  */
 @property NSString* externalTexturePath;
 
+/**
+ The path of the external texture relative to the scene file, as the
+ material refers to it.
+ */
+@property NSString* externalTextureName;
+
+/**
+ A Boolean value that determines if the texture is loaded, or if the color of
+ the material property is applied instead.
+ */
+@property BOOL loadsTextures;
+
+/**
+ The block which supplies the external texture, or nil to read it from the
+ disk.
+ */
+@property (copy) SCNAssimpResourceResolver resourceResolver;
+
 @end
 
 #pragma mark -
@@ -120,6 +138,11 @@
  @param aiTextureType The texture type: diffuse, specular etc.
  @param aiScene The assimp scene.
  @param path The path to the scene file to load.
+ @param imageCache The cache of the images loaded for the import.
+ @param loadsTextures YES to load the textures, NO to apply the colors of the
+ material property instead.
+ @param resourceResolver The block which supplies the external textures, or
+ nil to read them from the disk.
  @return A new texture info.
  */
 -(id)initWithMeshIndex:(int)aiMeshIndex
@@ -127,6 +150,8 @@
                inScene:(const struct aiScene *)aiScene
                 atPath:(NSString*)path
 			imageCache:(AssimpImageCache *)imageCache
+         loadsTextures:(BOOL)loadsTextures
+      resourceResolver:(SCNAssimpResourceResolver)resourceResolver
 {
     self = [super init];
     if(self) {
@@ -134,6 +159,8 @@
         _image = NULL;
         _colorSpace = NULL;
         _color = NULL;
+        self.loadsTextures = loadsTextures;
+        self.resourceResolver = resourceResolver;
         
         const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
         const struct aiMaterial *aiMaterial =
@@ -155,11 +182,157 @@
     return nil;
 }
 
+/**
+ Create a texture metadata object for a material property of a scene loaded
+ from a scene archive.
+
+ @param slot The material property of the archive.
+ @param archive The scene archive.
+ @param path The path to the scene file the archive was made from.
+ @param imageCache The cache of the images loaded for the import.
+ @param resourceResolver The block which supplies the external textures, or
+ nil to read them from the disk.
+ @return A new texture info.
+ */
+- (id)initWithArchiveSlot:(const AKArchiveMaterialSlot *)slot
+                inArchive:(const AKSceneArchive *)archive
+                   atPath:(NSString *)path
+               imageCache:(AssimpImageCache *)imageCache
+         resourceResolver:(SCNAssimpResourceResolver)resourceResolver
+{
+    self = [super init];
+    if (self)
+    {
+        _imageSource = NULL;
+        _image = NULL;
+        _colorSpace = NULL;
+        _color = NULL;
+        self.loadsTextures = YES;
+        self.resourceResolver = resourceResolver;
+        self.textureType = (enum aiTextureType)slot->textureType;
+        if (slot->hasColor)
+        {
+            _colorSpace = CGColorSpaceCreateDeviceRGB();
+            CGFloat components[4] = {slot->color[0], slot->color[1],
+                                     slot->color[2], slot->color[3]};
+            _color = CGColorCreate(_colorSpace, components);
+        }
+        if (slot->kind == AKMaterialSlotColor)
+        {
+            self.applyColor = true;
+        }
+        else if (slot->kind == AKMaterialSlotEmbeddedTexture)
+        {
+            self.applyEmbeddedTexture = true;
+            self.embeddedTextureIndex = (int)slot->texture;
+            // the embedded textures are cached by their assimp reference
+            NSString *texFilePath =
+                [NSString stringWithFormat:@"*%u", slot->texture];
+            CGImageRef image = [imageCache cachedFileAtPath:texFilePath];
+            if (image != NULL)
+            {
+                _image = CGImageRetain(image);
+            }
+            else
+            {
+                size_t nBytes = 0;
+                const char *formatHint = "";
+                const void *bytes = AKSceneArchiveTextureBytes(
+                    archive, slot->texture, &nBytes, &formatHint);
+                if (bytes != NULL)
+                {
+                    [self generateCGImageFromBytes:bytes
+                                            length:nBytes
+                                        formatHint:formatHint];
+                }
+                if (_image != NULL)
+                {
+                    [imageCache storeImage:_image toPath:texFilePath];
+                }
+            }
+        }
+        else if (slot->kind == AKMaterialSlotExternalTexture)
+        {
+            // the texture files are not part of the archive, so they are
+            // read again as the assimp import reads them
+            NSString *texFilePath = [NSString
+                stringWithUTF8String:AKSceneArchiveString(archive,
+                                                          slot->texture)];
+            self.applyExternalTexture = true;
+            self.externalTextureName = texFilePath;
+            self.externalTexturePath = [[path stringByDeletingLastPathComponent]
+                stringByAppendingPathComponent:texFilePath];
+            [self generateCGImageForExternalTextureAtPath:
+                      self.externalTexturePath
+                                                     name:texFilePath
+                                               imageCache:imageCache];
+        }
+        return self;
+    }
+    return nil;
+}
+
 - (void)dealloc
 {
     [self releaseContents];
 }
 
+#pragma mark - Recording a texture info
+
+/**
+ Adds the material property to a material of a scene archive, with the
+ embedded texture it shows. It must be called before the contents are
+ released.
+
+ @param writer The scene archive writer.
+ @param material The index of the material.
+ @param aiScene The assimp scene.
+ */
+- (void)recordSlotInArchive:(AKSceneArchiveWriter *)writer
+                   material:(unsigned int)material
+                    inScene:(const struct aiScene *)aiScene
+{
+    float color[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const float *slotColor = NULL;
+    if (_color != NULL && CGColorGetNumberOfComponents(_color) == 4)
+    {
+        const CGFloat *components = CGColorGetComponents(_color);
+        for (int i = 0; i < 4; i++)
+        {
+            color[i] = (float)components[i];
+        }
+        slotColor = color;
+    }
+    AKMaterialSlotKind kind = AKMaterialSlotNone;
+    unsigned int texture = AKArchiveNone;
+    const char *texturePath = NULL;
+    if (self.applyEmbeddedTexture)
+    {
+        kind = AKMaterialSlotEmbeddedTexture;
+        texture = (unsigned int)self.embeddedTextureIndex;
+        const struct aiTexture *aiTexture = aiScene->mTextures[texture];
+        // only the compressed textures are made into images
+        if (aiTexture->mHeight == 0)
+        {
+            AKSceneArchiveWriterSetTexture(writer, texture, aiTexture->pcData,
+                                           aiTexture->mWidth,
+                                           aiTexture->achFormatHint);
+        }
+    }
+    else if (self.applyExternalTexture)
+    {
+        kind = AKMaterialSlotExternalTexture;
+        texturePath = self.externalTextureName.UTF8String;
+    }
+    else if (self.applyColor)
+    {
+        kind = AKMaterialSlotColor;
+    }
+    AKSceneArchiveWriterAddMaterialSlot(writer, material, self.textureType,
+                                        kind, slotColor, texture,
+                                        texturePath);
+}
+
 #pragma mark - Inspect texture metadata
 
 /**
@@ -180,7 +353,7 @@
     int nTextures = aiGetMaterialTextureCount(aiMaterial, aiTextureType);
     DLog(@" has textures : %d", nTextures);
     DLog(@" has embedded textures: %d", aiScene->mNumTextures);
-    if(nTextures == 0 && aiScene->mNumTextures == 0) {
+    if(!self.loadsTextures || (nTextures == 0 && aiScene->mNumTextures == 0)) {
         self.applyColor = true;
         [self extractColorForMaterial:aiMaterial
                       withTextureType:aiTextureType];
@@ -235,10 +408,14 @@
             else {
                 self.applyExternalTexture = true;
                 DLog(@"  tex file name is %@", texFileName);
+                self.externalTextureName = texFilePath;
                 self.externalTexturePath = [[path stringByDeletingLastPathComponent] stringByAppendingPathComponent:texFilePath];
                 DLog(@"  tex path is %@", self.externalTexturePath);
-                [self generateCGImageForExternalTextureAtPath:
-                          self.externalTexturePath imageCache:imageCache];
+                [self
+                    generateCGImageForExternalTextureAtPath:
+                        self.externalTexturePath
+                                                       name:texFilePath
+                                                 imageCache:imageCache];
             }
         }
     }
@@ -259,10 +436,28 @@
     
     DLog(@" Generating embedded texture ");
     const struct aiTexture *aiTexture = aiScene->mTextures[index];
-    NSData *imageData = [NSData dataWithBytes:aiTexture->pcData
-                                       length:aiTexture->mWidth];
+    [self generateCGImageFromBytes:aiTexture->pcData
+                            length:aiTexture->mWidth
+                        formatHint:aiTexture->achFormatHint];
+}
+
+/**
+ Generates a bitmap image from the bytes of a texture in its compressed file
+ format.
+
+ @param bytes The bytes of the texture.
+ @param length The number of bytes.
+ @param formatHint The file format hint of the texture, png or jpg.
+ */
+- (void)generateCGImageFromBytes:(const void *)bytes
+                          length:(size_t)length
+                      formatHint:(const char *)formatHint
+{
+    NSAssert ((_image == NULL), @"We already generated a texture");
+
+    NSData *imageData = [NSData dataWithBytes:bytes length:length];
     CGDataProviderRef imageDataProviderRef = CGDataProviderCreateWithCFData((CFDataRef)imageData);
-    NSString* format = [NSString stringWithUTF8String:aiTexture->achFormatHint];
+    NSString* format = [NSString stringWithUTF8String:formatHint];
     if([format isEqualToString:@"png"]) {
         DLog(@" Created png embedded texture ");
         _image = CGImageCreateWithPNGDataProvider(
@@ -281,11 +476,16 @@
 
 
 /**
- Generates a bitmap image representing the external texture.
+ Generates a bitmap image representing the external texture, from the bytes
+ supplied by the resource resolver or else from the file at the path.
 
- @param path The path to the scene file to load.
+ @param path The path to the texture file.
+ @param name The path of the texture relative to the scene file, which is
+ passed to the resource resolver.
+ @param imageCache The cache of the images loaded for the import.
  */
 -(void)generateCGImageForExternalTextureAtPath:(NSString*)path
+                                          name:(NSString*)name
                                     imageCache:(AssimpImageCache *)imageCache
 {
     CGImageRef cachedImage = [imageCache cachedFileAtPath:path];
@@ -298,7 +498,16 @@
         NSAssert ((_imageSource == NULL), @"We already generated an image source");
         DLog(@" Generating external texture");
         NSURL *imageURL = [NSURL fileURLWithPath:path];
-        _imageSource = CGImageSourceCreateWithURL((CFURLRef)imageURL, NULL);
+        NSData *imageData = self.resourceResolver != nil
+                                ? self.resourceResolver(name)
+                                : nil;
+        if (imageData != nil) {
+            _imageSource =
+                CGImageSourceCreateWithData((CFDataRef)imageData, NULL);
+        } else {
+            _imageSource =
+                CGImageSourceCreateWithURL((CFURLRef)imageURL, NULL);
+        }
         if (_imageSource != nil) {
             _image = CGImageSourceCreateImageAtIndex(_imageSource, 0, NULL);
         } else {
@@ -112,8 +112,12 @@
  */
 
 /**
- Checks the scenekit node geometry has the correct vertex, normal and texture
- coordinate geometry sources for the specifed assimp node.
+ Checks the scenekit node geometry has the correct vertex, normal, tangent and
+ texture coordinate geometry sources for the specifed assimp node.
+
+ The geometry sources are views into one interleaved buffer, so they share
+ their data and stride. A source is only expected if a mesh of the node has
+ the attribute.
 
  @param aiNode The assimp node.
  @param nodeName The node name.
@@ -128,81 +132,70 @@
                   testLog:(ModelLog *)testLog
 {
     int nVertices = 0;
+    BOOL hasNormals = NO;
+    BOOL hasTangents = NO;
+    BOOL hasTexCoords = NO;
     for (int i = 0; i < aiNode->mNumMeshes; i++)
     {
         int aiMeshIndex = aiNode->mMeshes[i];
         const struct aiMesh *aiMesh = aiScene->mMeshes[aiMeshIndex];
         nVertices += aiMesh->mNumVertices;
+        hasNormals = hasNormals || aiMesh->mNormals != NULL;
+        hasTangents = hasTangents || aiMesh->mTangents != NULL;
+        hasTexCoords = hasTexCoords || aiMesh->mTextureCoords[0] != NULL;
     }
-    XCTAssertGreaterThanOrEqual(sceneNode.geometry.geometrySources.count, 4,
-                   @" Expected >= 4 geometry sources but got %lu",
-                   sceneNode.geometry.geometrySources.count);
-    XCTAssertLessThanOrEqual(sceneNode.geometry.geometrySources.count, 5,
-                             @" Expected <=5 geometry sources but got %lu",
-                             sceneNode.geometry.geometrySources.count);
-    SCNGeometrySource *vertexSource =
-        [sceneNode.geometry.geometrySources objectAtIndex:0];
-    if (nVertices != vertexSource.vectorCount)
-    {
-        NSString *errorLog = [NSString
-            stringWithFormat:
-                @"Scene node %@ geometry does not have expected %d vertices",
-                nodeName, nVertices];
-
-        [testLog addErrorLog:errorLog];
-    }
-    XCTAssertEqual(vertexSource.dataStride, 12,
-                   @" The vertex source data stride is %ld instead of 12",
-                   (long)vertexSource.dataStride);
-    SCNGeometrySource *normalSource =
-        [sceneNode.geometry.geometrySources objectAtIndex:1];
-    if (nVertices != normalSource.vectorCount)
-    {
-        NSString *errorLog = [NSString
-            stringWithFormat:
-                @"Scene node %@ geometry does not have expected %d normals",
-                nodeName, nVertices];
-        [testLog addErrorLog:errorLog];
-    }
-    XCTAssertEqual(normalSource.dataStride, 12,
-                   @" The texture source data stride is %ld instead of 12",
-                   (long)normalSource.dataStride);
-    SCNGeometrySource *texSource =
-    [sceneNode.geometry.geometrySources objectAtIndex:2];
-    if (nVertices != texSource.vectorCount)
+    NSDictionary *expectedSources = @{
+        SCNGeometrySourceSemanticVertex : @(YES),
+        SCNGeometrySourceSemanticNormal : @(hasNormals),
+        SCNGeometrySourceSemanticTangent : @(hasTangents),
+        SCNGeometrySourceSemanticTexcoord : @(hasTexCoords)
+    };
+    SCNGeometrySource *vertexSource = [[sceneNode.geometry
+        geometrySourcesForSemantic:SCNGeometrySourceSemanticVertex]
+        firstObject];
+    XCTAssertNotNil(vertexSource, @" The geometry of %@ has no vertex source",
+                    nodeName);
+    for (NSString *semantic in expectedSources)
     {
+        SCNGeometrySource *source = [[sceneNode.geometry
+            geometrySourcesForSemantic:semantic] firstObject];
+        BOOL expected = [[expectedSources objectForKey:semantic] boolValue];
+        if (expected != (source != nil))
         {
             NSString *errorLog = [NSString
-                                  stringWithFormat:@"Scene node %@ geometry does not have "
-                                  @"expected %d tex coords",
-                                  nodeName, nVertices];
+                stringWithFormat:@"Scene node %@ geometry %@ %@ source",
+                                 nodeName,
+                                 expected ? @"does not have expected"
+                                          : @"has unexpected",
+                                 semantic];
             [testLog addErrorLog:errorLog];
+            continue;
         }
+        if (source == nil)
+        {
+            continue;
+        }
+        if (nVertices != source.vectorCount)
+        {
+            NSString *errorLog = [NSString
+                stringWithFormat:@"Scene node %@ geometry %@ source does not "
+                                 @"have expected %d vectors",
+                                 nodeName, semantic, nVertices];
+            [testLog addErrorLog:errorLog];
+        }
+        XCTAssertEqual(source.data, vertexSource.data,
+                       @" The %@ source does not share the vertex data",
+                       semantic);
+        XCTAssertEqual(source.dataStride, vertexSource.dataStride,
+                       @" The %@ source data stride is %ld instead of %ld",
+                       semantic, (long)source.dataStride,
+                       (long)vertexSource.dataStride);
+        XCTAssertLessThanOrEqual(
+            source.dataOffset +
+                source.componentsPerVector * source.bytesPerComponent,
+            source.dataStride, @" The %@ source overflows its vertex",
+            semantic);
     }
-    XCTAssertGreaterThanOrEqual(texSource.dataStride, 8,
-                   @" The texture source data stride is %ld instead of >= 8",
-                   (long)texSource.dataStride);
-    XCTAssertLessThanOrEqual(
-        texSource.dataStride, 12,
-        @" The texture source data stride is %ld instead of <= 12",
-        (long)texSource.dataStride);
-    SCNGeometrySource *tangentSource =
-    [sceneNode.geometry.geometrySources objectAtIndex:3];
-    if (nVertices != tangentSource.vectorCount)
-    {
-        NSString *errorLog = [NSString
-            stringWithFormat:
-                @"Scene node %@ geometry does not have expected %d tangents",
-                nodeName, nVertices];
-        [testLog addErrorLog:errorLog];
-    }
-    XCTAssertGreaterThanOrEqual(tangentSource.dataStride, 8,
-                   @" The tangent source data stride is %ld instead of >= 8",
-                   (long)tangentSource.dataStride);
-    XCTAssertLessThanOrEqual(
-        tangentSource.dataStride, 12,
-        @" The tangent source data stride is %ld instead of <= 12",
-        (long)tangentSource.dataStride);
 }
 
 #pragma mark - Check node materials
@@ -361,6 +354,232 @@
     }
 }
 
+#pragma mark - Check geometry elements
+
+/**
+ @name Check geometry elements
+ */
+
+/**
+ Checks the geometry elements of the specified node and its descendants index
+ the same vertices as the triangle faces of the assimp meshes, which verifies
+ that no index is truncated by the index width of the element.
+
+ The scene must be imported with the triangulate post processing step. Meshes
+ with faces which are not triangles have no geometry element.
+
+ @param aiNode The assimp node.
+ @param sceneNode The scenekit node.
+ @param aiScene The triangulated assimp scene.
+ @param testLog The log for the file being tested.
+ */
+- (void)checkGeometryElements:(const struct aiNode *)aiNode
+                withSceneNode:(SCNNode *)sceneNode
+                      aiScene:(const struct aiScene *)aiScene
+                      testLog:(ModelLog *)testLog
+{
+    NSArray *scnElements = sceneNode.geometry.geometryElements;
+    NSUInteger elementIndex = 0;
+    unsigned int vertexOffset = 0;
+    for (int i = 0; i < aiNode->mNumMeshes; i++)
+    {
+        const struct aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
+        BOOL triangles = YES;
+        for (int j = 0; j < aiMesh->mNumFaces; j++)
+        {
+            triangles = triangles && aiMesh->mFaces[j].mNumIndices == 3;
+        }
+        if (!triangles || elementIndex >= scnElements.count)
+        {
+            vertexOffset += aiMesh->mNumVertices;
+            continue;
+        }
+        SCNGeometryElement *scnElement =
+            [scnElements objectAtIndex:elementIndex++];
+        NSInteger bytesPerIndex = scnElement.bytesPerIndex;
+        const unsigned char *bytes = scnElement.data.bytes;
+        BOOL matches = scnElement.primitiveCount == aiMesh->mNumFaces;
+        for (int j = 0; matches && j < aiMesh->mNumFaces; j++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                const unsigned char *index =
+                    bytes + (j * 3 + k) * bytesPerIndex;
+                unsigned int value = 0;
+                if (bytesPerIndex == 1)
+                {
+                    value = *index;
+                }
+                else if (bytesPerIndex == 2)
+                {
+                    value = *(const unsigned short *)index;
+                }
+                else
+                {
+                    value = *(const unsigned int *)index;
+                }
+                matches = matches &&
+                          value == aiMesh->mFaces[j].mIndices[k] + vertexOffset;
+            }
+        }
+        if (!matches)
+        {
+            NSString *errorLog = [NSString
+                stringWithFormat:@"Scene node %@ geometry element %lu does "
+                                 @"not match the faces of its mesh with %d "
+                                 @"byte indices",
+                                 sceneNode.name,
+                                 (unsigned long)(elementIndex - 1),
+                                 (int)bytesPerIndex];
+            [testLog addErrorLog:errorLog];
+        }
+        vertexOffset += aiMesh->mNumVertices;
+    }
+    for (int i = 0; i < aiNode->mNumChildren; i++)
+    {
+        [self checkGeometryElements:aiNode->mChildren[i]
+                      withSceneNode:[sceneNode.childNodes objectAtIndex:i]
+                            aiScene:aiScene
+                            testLog:testLog];
+    }
+}
+
+/**
+ Checks that no geometry of the specified node and its descendants has more
+ than the specified number of vertices, and that their indices are at most 16
+ bits wide, for a scene imported with split large geometries.
+
+ @param sceneNode The scenekit node.
+ @param maxVertices The maximum number of vertices of a geometry.
+ @param testLog The log for the file being tested.
+ */
+- (void)checkSplitGeometries:(SCNNode *)sceneNode
+                 maxVertices:(NSUInteger)maxVertices
+                     testLog:(ModelLog *)testLog
+{
+    SCNGeometrySource *vertexSource = [[sceneNode.geometry
+        geometrySourcesForSemantic:SCNGeometrySourceSemanticVertex]
+        firstObject];
+    if (vertexSource != nil && vertexSource.vectorCount > maxVertices)
+    {
+        NSString *errorLog = [NSString
+            stringWithFormat:@"Split scene node %@ geometry has %ld vertices",
+                             sceneNode.name, (long)vertexSource.vectorCount];
+        [testLog addErrorLog:errorLog];
+    }
+    for (SCNGeometryElement *scnElement in sceneNode.geometry.geometryElements)
+    {
+        if (scnElement.bytesPerIndex > 2)
+        {
+            NSString *errorLog = [NSString
+                stringWithFormat:@"Split scene node %@ geometry has %ld byte "
+                                 @"indices",
+                                 sceneNode.name,
+                                 (long)scnElement.bytesPerIndex];
+            [testLog addErrorLog:errorLog];
+        }
+    }
+    for (SCNNode *childNode in sceneNode.childNodes)
+    {
+        [self checkSplitGeometries:childNode
+                       maxVertices:maxVertices
+                           testLog:testLog];
+    }
+}
+
+#pragma mark - Check quantization
+
+/**
+ @name Check quantization
+ */
+
+/**
+ Checks a scene imported with the compact vertex formats reports the bytes it
+ saved and restores normals and tangents within their precision.
+
+ @param path The path to the model file being tested.
+ @param nVertices The number of vertices in the meshes of the assimp scene.
+ @param testLog The log for the file being tested.
+ */
+- (void)checkQuantization:(NSString *)path
+                nVertices:(NSUInteger)nVertices
+                  testLog:(ModelLog *)testLog
+{
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.vertexLayout.positionFormat = SCNAssimpVertexFormatSNorm16;
+    settings.vertexLayout.normalFormat = SCNAssimpVertexFormatOctSNorm16;
+    settings.vertexLayout.tangentFormat = SCNAssimpVertexFormatOctSNorm16;
+    settings.vertexLayout.texCoordFormat = SCNAssimpVertexFormatHalf;
+    settings.vertexLayout.colorFormat = SCNAssimpVertexFormatUNorm8;
+    SCNAssimpScene *scene = [[[AssimpImporter alloc] init]
+             importScene:path
+        postProcessFlags:AssimpKit_Process_FlipUVs |
+                         AssimpKit_Process_Triangulate
+                settings:settings
+                   error:nil];
+    SCNAssimpQuantizationReport *report = scene.quantizationReport;
+    // positions alone shrink from 12 to 8 bytes per vertex
+    if (nVertices > 0 && report.bytesSaved == 0)
+    {
+        NSString *errorLog = [NSString
+            stringWithFormat:@"Quantized scene saved %lu bytes for %lu "
+                             @"vertices",
+                             (unsigned long)report.bytesSaved,
+                             (unsigned long)nVertices];
+        [testLog addErrorLog:errorLog];
+    }
+    if (report.maxNormalAngleError > 0.05f ||
+        report.maxTangentAngleError > 0.05f)
+    {
+        NSString *errorLog = [NSString
+            stringWithFormat:@"Quantized normals are off by %f degrees and "
+                             @"tangents by %f degrees",
+                             report.maxNormalAngleError,
+                             report.maxTangentAngleError];
+        [testLog addErrorLog:errorLog];
+    }
+}
+
+#pragma mark - Check node index
+
+/**
+ @name Check node index
+ */
+
+/**
+ Checks the node index of the scene maps the name of the specified node and
+ its descendants to the first node with that name in depth first order.
+
+ @param sceneNode The scenekit node.
+ @param scene The scenekit scene.
+ @param indexedNames The names of the nodes already visited.
+ @param testLog The log for the file being tested.
+ */
+- (void)checkNodeIndex:(SCNNode *)sceneNode
+             withScene:(SCNAssimpScene *)scene
+          indexedNames:(NSMutableSet *)indexedNames
+               testLog:(ModelLog *)testLog
+{
+    if (![indexedNames containsObject:sceneNode.name])
+    {
+        [indexedNames addObject:sceneNode.name];
+        if ([scene nodeForName:sceneNode.name] != sceneNode)
+        {
+            NSString *errorLog = [NSString
+                stringWithFormat:@"Node index does not map %@ to its SCNNode",
+                                 sceneNode.name];
+            [testLog addErrorLog:errorLog];
+        }
+    }
+    for (SCNNode *childNode in sceneNode.childNodes)
+    {
+        [self checkNodeIndex:childNode
+                   withScene:scene
+                indexedNames:indexedNames
+                     testLog:testLog];
+    }
+}
+
 #pragma mark - Check cameras
 
 /**
@@ -823,9 +1042,15 @@
  1. The scenekit scene has the same node hierarchy as the assimp scene where
  each node has the correct geometry with geometry sources, elements and
  textures.
- 2. The scenekit has the correct lights.
- 3. The scenekit scene has the correct cameras.
- 4. If the scenekit scene has animations, it checks that the key frames created
+ 2. The geometry elements index the vertices of the mesh faces without
+ truncation, and a scene imported with split large geometries has no geometry
+ with more vertices than the limit or indices wider than 16 bits.
+ 3. A scene imported with the compact vertex formats saves memory and keeps
+ the normals and tangents within their precision.
+ 4. The node index of the scenekit scene maps each node name to its node.
+ 5. The scenekit has the correct lights.
+ 6. The scenekit scene has the correct cameras.
+ 7. If the scenekit scene has animations, it checks that the key frames created
  for the animation data are correct for values, timing, duration and the bone
  channel to which the key frame belongs.
 
@@ -871,6 +1096,46 @@
           modelPath:path
             testLog:testLog];
 
+    const struct aiScene *aiTriangulatedScene =
+        (const struct aiScene *)[importer
+            invokeAImportFile:pFile
+                       pFlags:aiProcess_FlipUVs | aiProcess_Triangulate];
+    if (aiTriangulatedScene)
+    {
+        [self checkGeometryElements:aiTriangulatedScene->mRootNode
+                      withSceneNode:[scene.modelScene.rootNode.childNodes
+                                        objectAtIndex:0]
+                            aiScene:aiTriangulatedScene
+                            testLog:testLog];
+        [importer invokeAiReleaseImport:aiTriangulatedScene];
+    }
+
+    SCNAssimpImportSettings *splitSettings =
+        [[SCNAssimpImportSettings alloc] init];
+    splitSettings.splitsLargeGeometries = YES;
+    splitSettings.maxVerticesPerGeometry = 255;
+    SCNAssimpScene *splitScene =
+        [[[AssimpImporter alloc] init] importScene:path
+                          postProcessFlags:AssimpKit_Process_FlipUVs |
+                                           AssimpKit_Process_Triangulate
+                                  settings:splitSettings
+                                     error:nil];
+    [self checkSplitGeometries:splitScene.modelScene.rootNode
+                   maxVertices:splitSettings.maxVerticesPerGeometry
+                       testLog:testLog];
+
+    NSUInteger nVertices = 0;
+    for (unsigned int i = 0; i < aiScene->mNumMeshes; i++)
+    {
+        nVertices += aiScene->mMeshes[i]->mNumVertices;
+    }
+    [self checkQuantization:path nVertices:nVertices testLog:testLog];
+
+    [self checkNodeIndex:[scene.modelScene.rootNode.childNodes objectAtIndex:0]
+               withScene:scene
+            indexedNames:[[NSMutableSet alloc] init]
+                 testLog:testLog];
+
     // [self checkLights:aiScene withScene:scene.modelScene testLog:testLog];
 
     [self checkCameras:aiScene withScene:scene.modelScene testLog:testLog];
@@ -881,6 +1146,669 @@
                   testLog:testLog];
 }
 
+#pragma mark - Test asynchronous import
+
+/**
+ @name Test asynchronous import
+ */
+
+/**
+ Tests an asynchronous import delivers the scene on the completion queue
+ without blocking the calling thread.
+ */
+- (void)testAsyncImport
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:
+            @"apple/models-proprietary/Collada/explorer_skinned.dae"];
+    dispatch_queue_t queue =
+        dispatch_queue_create("com.assimpkit.tests", DISPATCH_QUEUE_SERIAL);
+    static void *queueKey = &queueKey;
+    dispatch_queue_set_specific(queue, queueKey, queueKey, NULL);
+    XCTestExpectation *imported =
+        [self expectationWithDescription:@"Scene imported"];
+    __block BOOL completed = NO;
+    [[[AssimpImporter alloc] init]
+              importScene:path
+         postProcessFlags:AssimpKit_Process_FlipUVs |
+                          AssimpKit_Process_Triangulate
+                 settings:nil
+          completionQueue:queue
+        completionHandler:^(SCNAssimpScene *scene, NSError *error) {
+          XCTAssertTrue(dispatch_get_specific(queueKey) == queueKey,
+                        @"The completion handler ran on another queue");
+          XCTAssertNotNil(scene, @"The scene was not imported: %@", error);
+          XCTAssertNil(error, @"The import reported an error: %@", error);
+          XCTAssertGreaterThan(scene.rootNode.childNodes.count, 0);
+          completed = YES;
+          [imported fulfill];
+        }];
+    XCTAssertFalse(completed, @"The import blocked the calling thread");
+    [self waitForExpectationsWithTimeout:60 handler:nil];
+}
+
+/**
+ Tests an asynchronous import of a file which cannot be loaded reports the
+ import error on the main queue.
+ */
+- (void)testAsyncImportError
+{
+    NSString *path =
+        [self.testAssetsPath stringByAppendingString:@"no-such-file.dae"];
+    XCTestExpectation *failed =
+        [self expectationWithDescription:@"Import failed"];
+    [SCNScene assimpSceneWithURL:[NSURL fileURLWithPath:path]
+                postProcessFlags:AssimpKit_Process_Triangulate
+                        settings:nil
+                 completionQueue:nil
+               completionHandler:^(SCNAssimpScene *scene, NSError *error) {
+                 XCTAssertTrue([NSThread isMainThread],
+                               @"The completion handler ran off the main "
+                               @"queue");
+                 XCTAssertNil(scene);
+                 XCTAssertNotNil(error);
+                 XCTAssertEqualObjects(error.domain, @"AssimpImporter");
+                 [failed fulfill];
+               }];
+    [self waitForExpectationsWithTimeout:60 handler:nil];
+}
+
+#pragma mark - Test import progress
+
+/**
+ @name Test import progress
+ */
+
+/**
+ Tests an import reports its phases in order and completes its progress.
+ */
+- (void)testImportProgress
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:
+            @"apple/models-proprietary/Collada/explorer_skinned.dae"];
+    SCNAssimpImportProgress *progress = [[SCNAssimpImportProgress alloc] init];
+    NSMutableArray *phases = [[NSMutableArray alloc] init];
+    NSMutableArray *fractions = [[NSMutableArray alloc] init];
+    progress.progressHandler =
+        ^(SCNAssimpImportPhase phase, float fractionCompleted) {
+          [phases addObject:@(phase)];
+          [fractions addObject:@(fractionCompleted)];
+        };
+    XCTestExpectation *imported =
+        [self expectationWithDescription:@"Scene imported"];
+    [[[AssimpImporter alloc] init]
+              importScene:path
+         postProcessFlags:AssimpKit_Process_FlipUVs |
+                          AssimpKit_Process_Triangulate
+                 settings:nil
+                 progress:progress
+          completionQueue:nil
+        completionHandler:^(SCNAssimpScene *scene, NSError *error) {
+          XCTAssertNotNil(scene, @"The scene was not imported: %@", error);
+          [imported fulfill];
+        }];
+    [self waitForExpectationsWithTimeout:60 handler:nil];
+
+    // the progress handler and the completion handler share the main queue
+    XCTAssertGreaterThan(fractions.count, 0);
+    for (NSUInteger i = 1; i < fractions.count; i++)
+    {
+        XCTAssertGreaterThanOrEqual([phases[i] integerValue],
+                                    [phases[i - 1] integerValue]);
+        XCTAssertGreaterThanOrEqual([fractions[i] floatValue],
+                                    [fractions[i - 1] floatValue]);
+    }
+    XCTAssertEqual([phases.lastObject integerValue],
+                   SCNAssimpImportPhaseAnimations);
+    XCTAssertEqualWithAccuracy([fractions.lastObject floatValue], 1.0, 1e-6);
+    XCTAssertEqualWithAccuracy(progress.fractionCompleted, 1.0, 1e-6);
+    XCTAssertFalse(progress.cancelled);
+}
+
+/**
+ Tests a cancelled import fails with a cancelled error and stops within the
+ cancellation latency target.
+ */
+- (void)testImportCancel
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:
+            @"apple/models-proprietary/Collada/explorer_skinned.dae"];
+    // the longest time from cancelling to stopping the import
+    const NSTimeInterval latencyTarget = 0.05;
+    SCNAssimpImportProgress *progress = [[SCNAssimpImportProgress alloc] init];
+    // cancel as soon as the conversion starts
+    progress.progressQueue =
+        dispatch_queue_create("com.assimpkit.tests", DISPATCH_QUEUE_SERIAL);
+    __weak SCNAssimpImportProgress *weakProgress = progress;
+    progress.progressHandler =
+        ^(SCNAssimpImportPhase phase, float fractionCompleted) {
+          if (phase >= SCNAssimpImportPhaseGeometry)
+          {
+              [weakProgress cancel];
+          }
+        };
+    XCTestExpectation *cancelled =
+        [self expectationWithDescription:@"Import cancelled"];
+    [[[AssimpImporter alloc] init]
+              importScene:path
+         postProcessFlags:AssimpKit_Process_FlipUVs |
+                          AssimpKit_Process_Triangulate
+                 settings:nil
+                 progress:progress
+          completionQueue:nil
+        completionHandler:^(SCNAssimpScene *scene, NSError *error) {
+          XCTAssertNil(scene);
+          XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+          XCTAssertEqual(error.code, NSUserCancelledError);
+          [cancelled fulfill];
+        }];
+    [self waitForExpectationsWithTimeout:60 handler:nil];
+    XCTAssertTrue(progress.cancelled);
+    XCTAssertGreaterThanOrEqual(progress.cancellationLatency, 0.0);
+    XCTAssertLessThan(progress.cancellationLatency, latencyTarget);
+}
+
+/**
+ Tests an import cancelled before it starts stops before parsing the file.
+ */
+- (void)testImportCancelBeforeStart
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:
+            @"apple/models-proprietary/Collada/explorer_skinned.dae"];
+    SCNAssimpImportProgress *progress = [[SCNAssimpImportProgress alloc] init];
+    [progress cancel];
+    NSError *error = nil;
+    SCNAssimpScene *scene = [[[AssimpImporter alloc] init]
+         importScene:path
+    postProcessFlags:AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate
+            settings:nil
+            progress:progress
+               error:&error];
+    XCTAssertNil(scene);
+    XCTAssertEqual(error.code, NSUserCancelledError);
+    XCTAssertEqual(progress.phase, SCNAssimpImportPhaseParse);
+}
+
+#pragma mark - Test import options
+
+/**
+ @name Test import options
+ */
+
+/**
+ Finds the largest number of bones which affect a vertex of the skinned
+ geometries of a scene.
+
+ @param scene The scene.
+ @return The largest number of bone weights per vertex.
+ */
+- (NSInteger)maxBoneWeightsInScene:(SCNAssimpScene *)scene
+{
+    __block NSInteger maxBoneWeights = 0;
+    [scene.modelScene.rootNode
+        enumerateHierarchyUsingBlock:^(SCNNode *node, BOOL *stop) {
+          SCNGeometrySource *boneWeights = node.skinner.boneWeights;
+          if (boneWeights != nil)
+          {
+              maxBoneWeights =
+                  MAX(maxBoneWeights, boneWeights.componentsPerVector);
+          }
+        }];
+    return maxBoneWeights;
+}
+
+/**
+ Tests the import options of the settings reach the assimp post processing
+ steps.
+ */
+- (void)testImportOptions
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:
+            @"apple/models-proprietary/Collada/explorer_skinned.dae"];
+    AssimpKitPostProcessSteps flags = AssimpKit_Process_FlipUVs |
+                                      AssimpKit_Process_Triangulate |
+                                      AssimpKit_Process_LimitBoneWeights;
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    SCNAssimpScene *scene = [importer importScene:path
+                                 postProcessFlags:flags
+                                         settings:nil
+                                            error:nil];
+    XCTAssertGreaterThan([self maxBoneWeightsInScene:scene], 1);
+
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.maxBoneWeightsPerVertex = 1;
+    NSError *error = nil;
+    scene = [importer importScene:path
+                 postProcessFlags:flags
+                         settings:settings
+                            error:&error];
+    XCTAssertNotNil(scene, @"The scene was not imported: %@", error);
+    XCTAssertEqual([self maxBoneWeightsInScene:scene], 1);
+}
+
+/**
+ Tests an import with options which are not valid fails with an error.
+ */
+- (void)testInvalidImportOptions
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:
+            @"apple/models-proprietary/Collada/explorer_skinned.dae"];
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.vertexCacheSize = 2;
+    NSError *error = nil;
+    SCNAssimpScene *scene = [[[AssimpImporter alloc] init]
+         importScene:path
+    postProcessFlags:AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate
+            settings:settings
+               error:&error];
+    XCTAssertNil(scene);
+    XCTAssertNotNil(error);
+    XCTAssertEqualObjects(error.domain, @"AssimpImporter");
+}
+
+#pragma mark - Test import from memory
+
+/**
+ @name Test import from memory
+ */
+
+/**
+ Tests a scene file in memory is imported with the files it refers to
+ supplied by the resource resolver.
+ */
+- (void)testImportFromData
+{
+    NSString *directory = [self.testAssetsPath
+        stringByAppendingString:@"assimp/models/OBJ/"];
+    NSData *data = [NSData
+        dataWithContentsOfFile:[directory
+                                   stringByAppendingString:@"spider.obj"]];
+    NSMutableArray *names = [[NSMutableArray alloc] init];
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.resourceResolver = ^NSData *(NSString *name) {
+      @synchronized(names)
+      {
+          [names addObject:name];
+      }
+      NSString *fileName = [[name stringByReplacingOccurrencesOfString:@"\\"
+                                                            withString:@"/"]
+          lastPathComponent];
+      return [NSData
+          dataWithContentsOfFile:[directory
+                                     stringByAppendingString:fileName]];
+    };
+    NSError *error = nil;
+    SCNAssimpScene *scene = [[[AssimpImporter alloc] init]
+        importSceneFromData:data
+                       hint:@"obj"
+           postProcessFlags:AssimpKit_Process_FlipUVs |
+                            AssimpKit_Process_Triangulate
+                   settings:settings
+                      error:&error];
+    XCTAssertNotNil(scene, @"The scene was not imported: %@", error);
+    XCTAssertGreaterThan(scene.rootNode.childNodes.count, 0);
+    XCTAssertTrue([names containsObject:@"spider.mtl"],
+                  @"The material library was not resolved: %@", names);
+    NSUInteger nTextures = 0;
+    for (NSString *name in names)
+    {
+        nTextures += [name.pathExtension isEqualToString:@"jpg"] ? 1 : 0;
+    }
+    XCTAssertGreaterThan(nTextures, 0, @"No texture was resolved: %@", names);
+}
+
+/**
+ Tests a scene file which cannot be parsed from memory reports an error.
+ */
+- (void)testImportFromDataError
+{
+    NSData *data = [@"not a scene" dataUsingEncoding:NSUTF8StringEncoding];
+    NSError *error = nil;
+    SCNAssimpScene *scene = [[[AssimpImporter alloc] init]
+        importSceneFromData:data
+                       hint:@"dae"
+           postProcessFlags:AssimpKit_Process_FlipUVs
+                   settings:nil
+                      error:&error];
+    XCTAssertNil(scene);
+    XCTAssertEqualObjects(error.domain, @"AssimpImporter");
+}
+
+/**
+ Tests the scenes imported from memory mapped files are the same as the
+ scenes imported with buffered reads.
+ */
+- (void)testImportMappedFiles
+{
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    AssimpKitPostProcessSteps flags =
+        AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate;
+    SCNAssimpImportSettings *mapped = [[SCNAssimpImportSettings alloc] init];
+    mapped.mapsFiles = YES;
+    for (ModelFile *modelFile in [self getModelFiles])
+    @autoreleasepool {
+        SCNAssimpScene *readScene = [importer importScene:modelFile.path
+                                         postProcessFlags:flags
+                                                 settings:nil
+                                                    error:nil];
+        SCNAssimpScene *mappedScene = [importer importScene:modelFile.path
+                                           postProcessFlags:flags
+                                                   settings:mapped
+                                                      error:nil];
+        XCTAssertEqualObjects([self signatureOfScene:mappedScene],
+                              [self signatureOfScene:readScene],
+                              @"The mapped import of %@ differs",
+                              modelFile.path);
+    }
+}
+
+/**
+ Tests the import stats of a scene count the scene file and its textures,
+ which are read ahead and opened again from the handle cache.
+ */
+- (void)testImportStats
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:@"assimp/models/OBJ/spider.obj"];
+    SCNAssimpScene *scene = [[[AssimpImporter alloc] init]
+         importScene:path
+        postProcessFlags:AssimpKit_Process_FlipUVs |
+                         AssimpKit_Process_Triangulate
+                settings:nil
+                   error:nil];
+    XCTAssertNotNil(scene);
+    SCNAssimpImportStats *stats = scene.importStats;
+    XCTAssertGreaterThan(stats.bytesRead, 0);
+    XCTAssertGreaterThan(stats.reads, 0);
+    XCTAssertGreaterThan(stats.readAheads, 0,
+                         @"The textures were not read ahead");
+    XCTAssertGreaterThan(stats.cachedFileOpens, 0,
+                         @"The textures were not opened from the cache");
+    XCTAssertGreaterThanOrEqual(stats.fileOpens, stats.cachedFileOpens);
+    XCTAssertGreaterThan(stats.ioTime, 0.0);
+    XCTAssertEqual(stats.parseTime, 0.0, @"The import was measured");
+    XCTAssertEqual(stats.vertices, 0);
+}
+
+/**
+ Tests a measured import times its phases, counts its scene and geometry, and
+ serializes its stats to JSON.
+ */
+- (void)testMeasuredImportStats
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:@"assimp/models/OBJ/spider.obj"];
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.measuresImport = YES;
+    SCNAssimpScene *scene = [[[AssimpImporter alloc] init]
+         importScene:path
+        postProcessFlags:AssimpKit_Process_FlipUVs |
+                         AssimpKit_Process_Triangulate
+                settings:settings
+                   error:nil];
+    XCTAssertNotNil(scene);
+    SCNAssimpImportStats *stats = scene.importStats;
+    XCTAssertGreaterThan(stats.parseTime, 0.0);
+    XCTAssertGreaterThan(stats.geometryTime, 0.0);
+    XCTAssertGreaterThanOrEqual(stats.materialsTime, 0.0);
+    XCTAssertGreaterThan(stats.texturesTime, 0.0);
+    XCTAssertGreaterThan(stats.nodes, 0);
+    XCTAssertGreaterThan(stats.meshes, 0);
+    XCTAssertGreaterThan(stats.vertices, 0);
+    XCTAssertEqual(stats.indices % 3, 0);
+    // the default vertex layout stores the positions as three floats
+    XCTAssertEqual(stats.positionBytes, stats.vertices * 3 * sizeof(float));
+    XCTAssertGreaterThan(stats.texturesDecoded, 0);
+    XCTAssertGreaterThan(stats.bytesRead, 0);
+
+    NSData *json = [stats JSONData];
+    XCTAssertNotNil(json);
+    NSDictionary *dictionary =
+        [NSJSONSerialization JSONObjectWithData:json options:0 error:nil];
+    XCTAssertEqualObjects(dictionary[@"vertices"], @(stats.vertices));
+    XCTAssertEqualObjects(dictionary[@"attributeBytes"][@"position"],
+                          @(stats.positionBytes));
+    XCTAssertNotNil(dictionary[@"phases"][@"parse"]);
+    XCTAssertNotNil(dictionary[@"files"][@"bytesRead"]);
+    XCTAssertEqualObjects(dictionary[@"memory"][@"textures"],
+                          @(stats.textureMemoryBytes));
+}
+
+/**
+ Tests a measured import accounts the memory of its phases, with the decoded
+ textures apart.
+ */
+- (void)testImportMemory
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:@"assimp/models/OBJ/spider.obj"];
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.measuresImport = YES;
+    SCNAssimpScene *scene = [[[AssimpImporter alloc] init]
+         importScene:path
+        postProcessFlags:AssimpKit_Process_FlipUVs |
+                         AssimpKit_Process_Triangulate
+                settings:settings
+                   error:nil];
+    XCTAssertNotNil(scene);
+    SCNAssimpImportStats *stats = scene.importStats;
+    SCNAssimpPhaseMemory *geometry =
+        [stats memoryOfPhase:SCNAssimpImportPhaseGeometry];
+    // the vertices and indices are handed over to the geometry sources
+    XCTAssertGreaterThanOrEqual(geometry.bytesRetained,
+                                stats.positionBytes + stats.indexBytes);
+    XCTAssertGreaterThanOrEqual(geometry.bytesAllocated,
+                                geometry.bytesRetained);
+    XCTAssertGreaterThanOrEqual(geometry.peakBytes, geometry.bytesRetained);
+    XCTAssertGreaterThanOrEqual(stats.peakMemoryBytes, geometry.peakBytes);
+    XCTAssertGreaterThan(geometry.footprintBytes, 0);
+    XCTAssertGreaterThan(
+        [stats memoryOfPhase:SCNAssimpImportPhaseParse].footprintBytes, 0);
+    XCTAssertEqual(
+        [stats memoryOfPhase:SCNAssimpImportPhaseParse].bytesAllocated, 0);
+    XCTAssertGreaterThan(stats.textureMemoryBytes, 0);
+    XCTAssertGreaterThan(stats.sceneMemoryBytes, 0);
+    XCTAssertGreaterThanOrEqual(stats.peakFootprintBytes,
+                                geometry.footprintBytes);
+}
+
+#pragma mark - Test scene components
+
+/**
+ @name Test scene components
+ */
+
+/**
+ Determines if a node or one of its descendants has a geometry or a skinner.
+
+ @param node The scene node.
+ @return YES if a geometry or a skinner was found.
+ */
+- (BOOL)hasGeometryOrSkinner:(SCNNode *)node
+{
+    if (node.geometry != nil || node.skinner != nil)
+    {
+        return YES;
+    }
+    for (SCNNode *child in node.childNodes)
+    {
+        if ([self hasGeometryOrSkinner:child])
+        {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+/**
+ Tests an import of the animations only makes the same skeleton and
+ animations as a full import, without any geometry or skinner.
+ */
+- (void)testImportAnimationsOnly
+{
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    AssimpKitPostProcessSteps flags =
+        AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate;
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.components = SCNAssimpImportComponentAnimations;
+    NSArray *files = @[ @"walk.dae", @"run.dae", @"explorer_skinned.dae" ];
+    for (NSString *file in files)
+    {
+        NSString *path = [self.testAssetsPath
+            stringByAppendingFormat:@"apple/models-proprietary/Collada/%@",
+                                    file];
+        SCNAssimpScene *fullScene = [importer importScene:path
+                                         postProcessFlags:flags
+                                                 settings:nil
+                                                    error:nil];
+        SCNAssimpScene *animScene = [importer importScene:path
+                                         postProcessFlags:flags
+                                                 settings:settings
+                                                    error:nil];
+        XCTAssertNotNil(animScene, @"%@ was not imported", file);
+        XCTAssertFalse([self hasGeometryOrSkinner:animScene.rootNode],
+                       @"The animations of %@ have a geometry", file);
+        XCTAssertEqualObjects(animScene.skeletonNode.name,
+                              fullScene.skeletonNode.name);
+        SEL compare = @selector(compare:);
+        XCTAssertEqualObjects(
+            [animScene.animationKeys sortedArrayUsingSelector:compare],
+            [fullScene.animationKeys sortedArrayUsingSelector:compare]);
+        for (NSString *key in fullScene.animationKeys)
+        {
+            SCNAssimpAnimation *animation =
+                [animScene.animations valueForKey:key];
+            SCNAssimpAnimation *fullAnimation =
+                [fullScene.animations valueForKey:key];
+            XCTAssertEqual(animation.frameAnims.count,
+                           fullAnimation.frameAnims.count);
+            XCTAssertNotNil([animScene animationSceneForKey:key]);
+        }
+    }
+}
+
+/**
+ Tests an import without textures neither reads nor loads the textures, and
+ applies colors to the materials instead.
+ */
+- (void)testImportWithoutTextures
+{
+    NSString *path = [self.testAssetsPath
+        stringByAppendingString:@"assimp/models/OBJ/spider.obj"];
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    AssimpKitPostProcessSteps flags =
+        AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate;
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.components =
+        SCNAssimpImportComponentAll & ~SCNAssimpImportComponentTextures;
+    SCNAssimpScene *fullScene = [importer importScene:path
+                                     postProcessFlags:flags
+                                             settings:nil
+                                                error:nil];
+    SCNAssimpScene *scene = [importer importScene:path
+                                 postProcessFlags:flags
+                                         settings:settings
+                                            error:nil];
+    XCTAssertNotNil(scene);
+    XCTAssertEqual(scene.importStats.readAheads, 0);
+    XCTAssertLessThan(scene.importStats.bytesRead,
+                      fullScene.importStats.bytesRead,
+                      @"The textures were read");
+    XCTAssertTrue([self hasGeometryOrSkinner:scene.rootNode]);
+    [scene.rootNode enumerateChildNodesUsingBlock:^(SCNNode *child,
+                                                    BOOL *stop) {
+      for (SCNMaterial *material in child.geometry.materials)
+      {
+          id contents = material.diffuse.contents;
+          XCTAssertFalse(contents != nil &&
+                             CFGetTypeID((__bridge CFTypeRef)contents) ==
+                                 CGImageGetTypeID(),
+                         @"The texture of %@ was loaded", material.name);
+      }
+    }];
+}
+
+#pragma mark - Test batch import
+
+/**
+ @name Test batch import
+ */
+
+/**
+ Tests a batch import delivers every scene once as it is loaded, then all the
+ scenes and errors in the order of the URLs.
+ */
+- (void)testBatchImport
+{
+    NSArray *files = @[
+        @"attack.dae", @"bored.dae", @"explorer_skinned.dae",
+        @"no-such-file.dae", @"hit.dae", @"idle.dae", @"monkey_skinned.dae",
+        @"soldier.dae", @"walk.dae"
+    ];
+    NSMutableArray *urls = [[NSMutableArray alloc] init];
+    for (NSString *file in files)
+    {
+        NSString *path = [self.testAssetsPath
+            stringByAppendingFormat:@"apple/models-proprietary/Collada/%@",
+                                    file];
+        [urls addObject:[NSURL fileURLWithPath:path]];
+    }
+    const NSUInteger missingIndex = 3;
+    dispatch_queue_t queue =
+        dispatch_queue_create("com.assimpkit.tests", DISPATCH_QUEUE_SERIAL);
+    NSMutableIndexSet *handledIndexes = [[NSMutableIndexSet alloc] init];
+    XCTestExpectation *imported =
+        [self expectationWithDescription:@"Batch imported"];
+    [[[AssimpImporter alloc] init]
+        importScenesAtURLs:urls
+          postProcessFlags:AssimpKit_Process_FlipUVs |
+                           AssimpKit_Process_Triangulate
+                  settings:nil
+                   workers:4
+          maxBytesInFlight:1000000
+           completionQueue:queue
+              sceneHandler:^(NSUInteger index, SCNAssimpScene *scene,
+                             NSError *error) {
+                XCTAssertFalse([handledIndexes containsIndex:index],
+                               @"The scene %lu was handled twice",
+                               (unsigned long)index);
+                [handledIndexes addIndex:index];
+                XCTAssertEqual(scene == nil, index == missingIndex);
+                XCTAssertEqual(error != nil, index == missingIndex);
+              }
+         completionHandler:^(NSArray *scenes, NSArray *errors) {
+           XCTAssertEqual(handledIndexes.count, urls.count,
+                          @"The completion handler ran before every scene "
+                          @"handler");
+           XCTAssertEqual(scenes.count, urls.count);
+           XCTAssertEqual(errors.count, urls.count);
+           for (NSUInteger i = 0; i < urls.count; i++)
+           {
+               id scene = [scenes objectAtIndex:i];
+               id error = [errors objectAtIndex:i];
+               if (i == missingIndex)
+               {
+                   XCTAssertEqualObjects(scene, [NSNull null]);
+                   XCTAssertTrue([error isKindOfClass:[NSError class]]);
+               }
+               else
+               {
+                   XCTAssertTrue([scene isKindOfClass:[SCNAssimpScene class]],
+                                 @"The scene %@ was not imported: %@",
+                                 [files objectAtIndex:i], error);
+                   XCTAssertEqualObjects(error, [NSNull null]);
+               }
+           }
+           [imported fulfill];
+         }];
+    [self waitForExpectationsWithTimeout:120 handler:nil];
+}
+
 #pragma mark - Test all models
 
 /**
@@ -1115,4 +2043,362 @@
                          serlPercent);
 }
 
+
+#pragma mark - Test concurrent import
+
+/**
+ @name Test concurrent import
+ */
+
+/**
+ Hashes the bytes of a data object with 64 bit FNV-1a.
+
+ @param data The data object.
+ @return The hash of the bytes.
+ */
+static unsigned long long hashOfData(NSData *data)
+{
+    const unsigned char *bytes = (const unsigned char *)data.bytes;
+    unsigned long long hash = 14695981039346656037ULL;
+    for (NSUInteger i = 0; i < data.length; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ Appends a description of the specified node and its children to a signature,
+ with the node name and transform, the hashes of its geometry sources and
+ elements, its materials and the bones of its skinner.
+
+ @param node The scene node.
+ @param signature The signature to append to.
+ */
+- (void)appendNode:(SCNNode *)node toSignature:(NSMutableString *)signature
+{
+    SCNMatrix4 m = node.transform;
+    [signature appendFormat:@"node %@ [%g %g %g %g %g %g %g %g %g %g %g %g "
+                            @"%g %g %g %g]\n",
+                            node.name, m.m11, m.m12, m.m13, m.m14, m.m21,
+                            m.m22, m.m23, m.m24, m.m31, m.m32, m.m33, m.m34,
+                            m.m41, m.m42, m.m43, m.m44];
+    for (SCNGeometrySource *source in node.geometry.geometrySources)
+    {
+        [signature appendFormat:@" source %@ %ld %llx\n", source.semantic,
+                                (long)source.vectorCount,
+                                hashOfData(source.data)];
+    }
+    for (SCNGeometryElement *element in node.geometry.geometryElements)
+    {
+        [signature appendFormat:@" element %ld %llx\n",
+                                (long)element.primitiveCount,
+                                hashOfData(element.data)];
+    }
+    for (SCNMaterial *material in node.geometry.materials)
+    {
+        [signature
+            appendFormat:@" material %@ %@\n", material.name,
+                         NSStringFromClass([material.diffuse.contents class])];
+    }
+    for (SCNNode *bone in node.skinner.bones)
+    {
+        [signature appendFormat:@" bone %@\n", bone.name];
+    }
+    for (SCNNode *child in node.childNodes)
+    {
+        [self appendNode:child toSignature:signature];
+    }
+}
+
+/**
+ Makes a signature of a scene which is equal for two imports of a file if
+ they made the same scene graph, skeleton and animations.
+
+ @param scene The scene, or nil if the import failed.
+ @return The signature of the scene.
+ */
+- (NSString *)signatureOfScene:(SCNAssimpScene *)scene
+{
+    if (scene == nil)
+    {
+        return @"no scene";
+    }
+    NSMutableString *signature = [[NSMutableString alloc] init];
+    [self appendNode:scene.modelScene.rootNode toSignature:signature];
+    [signature appendFormat:@"skeleton %@\n", scene.skeletonNode.name];
+    NSArray *animationKeys = [scene.animations.allKeys
+        sortedArrayUsingSelector:@selector(compare:)];
+    for (NSString *animationKey in animationKeys)
+    {
+        SCNAssimpAnimation *animation =
+            [scene.animations valueForKey:animationKey];
+        [signature appendFormat:@"animation %@ %lu\n", animationKey,
+                                (unsigned long)animation.frameAnims.count];
+    }
+    return signature;
+}
+
+/**
+ Tests one importer imports the whole asset corpus from several threads at
+ the same time, and that every import makes the same scene as a single
+ threaded import of the file.
+
+ Each thread imports every file, starting at a different file so that
+ different files are imported at the same time as well as the same file.
+ */
+- (void)testConcurrentImport
+{
+    NSArray *modelFiles = [self getModelFiles];
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    AssimpKitPostProcessSteps flags =
+        AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate;
+
+    // the single threaded imports
+    NSMutableArray *expectedSignatures = [[NSMutableArray alloc] init];
+    for (ModelFile *modelFile in modelFiles)
+    @autoreleasepool {
+        SCNAssimpScene *scene = [importer importScene:modelFile.path
+                                     postProcessFlags:flags
+                                                error:nil];
+        [expectedSignatures addObject:[self signatureOfScene:scene]];
+    }
+
+    // the same imports from several threads at the same time
+    size_t nThreads =
+        MIN(MAX([NSProcessInfo processInfo].activeProcessorCount, 2), 8);
+    NSUInteger nFiles = modelFiles.count;
+    NSMutableArray *mismatches = [[NSMutableArray alloc] init];
+    dispatch_apply(
+        nThreads,
+        dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t t) {
+          for (NSUInteger i = 0; i < nFiles; i++)
+          @autoreleasepool {
+              NSUInteger fileIndex = (i + t * nFiles / nThreads) % nFiles;
+              ModelFile *modelFile = [modelFiles objectAtIndex:fileIndex];
+              SCNAssimpScene *scene = [importer importScene:modelFile.path
+                                           postProcessFlags:flags
+                                                      error:nil];
+              NSString *signature = [self signatureOfScene:scene];
+              if (![signature
+                      isEqualToString:[expectedSignatures
+                                          objectAtIndex:fileIndex]])
+              {
+                  @synchronized(mismatches)
+                  {
+                      [mismatches addObject:modelFile.path];
+                  }
+              }
+          }
+        });
+    NSLog(@" NUM OF FILES IMPORTED CONCURRENTLY    : %lu on %zu threads",
+          (unsigned long)nFiles, nThreads);
+    XCTAssertGreaterThan(nFiles, 0);
+    XCTAssertEqual(mismatches.count, 0,
+                   @"The concurrent imports of %@ differ from the single "
+                   @"threaded imports",
+                   mismatches);
+}
+
+
+/**
+ Tests the scenes made with the node geometries converted on several workers
+ are the same as the scenes converted on one worker.
+ */
+- (void)testParallelConversionMatchesSerial
+{
+    NSArray *modelFiles = [self getModelFiles];
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    AssimpKitPostProcessSteps flags =
+        AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate;
+    SCNAssimpImportSettings *serial = [[SCNAssimpImportSettings alloc] init];
+    serial.conversionWorkers = 1;
+    SCNAssimpImportSettings *parallel = [[SCNAssimpImportSettings alloc] init];
+    parallel.conversionWorkers = 8;
+    for (ModelFile *modelFile in modelFiles)
+    @autoreleasepool {
+        SCNAssimpScene *serialScene = [importer importScene:modelFile.path
+                                           postProcessFlags:flags
+                                                   settings:serial
+                                                      error:nil];
+        SCNAssimpScene *parallelScene = [importer importScene:modelFile.path
+                                             postProcessFlags:flags
+                                                     settings:parallel
+                                                        error:nil];
+        XCTAssertEqualObjects([self signatureOfScene:parallelScene],
+                              [self signatureOfScene:serialScene],
+                              @"The parallel conversion of %@ differs from "
+                              @"the serial conversion",
+                              modelFile.path);
+    }
+}
+
+/**
+ Tests the scenes made while the assimp scene is trimmed as it is converted
+ are the same as the scenes made from the whole assimp scene, with and without
+ split geometries.
+ */
+- (void)testMinimizedPeakMemoryMatchesImport
+{
+    NSArray *modelFiles = [self getModelFiles];
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    AssimpKitPostProcessSteps flags =
+        AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate;
+    for (int splits = 0; splits < 2; splits++)
+    {
+        SCNAssimpImportSettings *whole = [[SCNAssimpImportSettings alloc] init];
+        whole.splitsLargeGeometries = splits == 1;
+        whole.maxVerticesPerGeometry = 1000;
+        SCNAssimpImportSettings *trimmed = [whole copy];
+        trimmed.minimizesPeakMemory = YES;
+        for (ModelFile *modelFile in modelFiles)
+        @autoreleasepool {
+            SCNAssimpScene *wholeScene = [importer importScene:modelFile.path
+                                              postProcessFlags:flags
+                                                      settings:whole
+                                                         error:nil];
+            SCNAssimpScene *trimmedScene =
+                [importer importScene:modelFile.path
+                     postProcessFlags:flags
+                             settings:trimmed
+                                error:nil];
+            XCTAssertEqualObjects([self signatureOfScene:trimmedScene],
+                                  [self signatureOfScene:wholeScene],
+                                  @"The trimmed import of %@ differs",
+                                  modelFile.path);
+        }
+    }
+}
+
+/**
+ Tests the scenes loaded from the scene cache are the same as the scenes
+ converted from their files, with and without split geometries, and that the
+ second import of a file is loaded from the cache.
+ */
+- (void)testSceneCache
+{
+    NSArray *modelFiles = [self getModelFiles];
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    AssimpKitPostProcessSteps flags =
+        AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate;
+    NSString *directory = [NSTemporaryDirectory()
+        stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    SCNAssimpSceneCache *cache =
+        [[SCNAssimpSceneCache alloc] initWithDirectory:directory
+                                              maxBytes:0];
+    XCTAssertNotNil(cache);
+    for (int splits = 0; splits < 2; splits++)
+    {
+        SCNAssimpImportSettings *settings =
+            [[SCNAssimpImportSettings alloc] init];
+        settings.splitsLargeGeometries = splits == 1;
+        settings.maxVerticesPerGeometry = 1000;
+        settings.sceneCache = cache;
+        for (ModelFile *modelFile in modelFiles)
+        @autoreleasepool {
+            NSUInteger hits = cache.hits;
+            SCNAssimpScene *convertedScene =
+                [importer importScene:modelFile.path
+                     postProcessFlags:flags
+                             settings:settings
+                                error:nil];
+            SCNAssimpScene *cachedScene =
+                [importer importScene:modelFile.path
+                     postProcessFlags:flags
+                             settings:settings
+                                error:nil];
+            if (convertedScene == nil)
+            {
+                continue;
+            }
+            XCTAssertFalse(convertedScene.importStats.loadedFromCache);
+            XCTAssertTrue(cachedScene.importStats.loadedFromCache,
+                          @"The scene of %@ was not cached", modelFile.path);
+            XCTAssertEqual(cache.hits, hits + 1);
+            XCTAssertEqualObjects([self signatureOfScene:cachedScene],
+                                  [self signatureOfScene:convertedScene],
+                                  @"The cached scene of %@ differs",
+                                  modelFile.path);
+        }
+    }
+    [cache removeAllScenes];
+    XCTAssertEqual(cache.cachedBytes, 0);
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+}
+
+/**
+ Tests the scenes loaded from compiled scene assets are the same as the
+ scenes converted from their files, and that a file with the extension of a
+ scene asset which is not one is not loaded.
+ */
+- (void)testCompiledSceneAsset
+{
+    NSArray *modelFiles = [self getModelFiles];
+    AssimpImporter *importer = [[AssimpImporter alloc] init];
+    AssimpKitPostProcessSteps flags =
+        AssimpKit_Process_FlipUVs | AssimpKit_Process_Triangulate;
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *directory = [NSTemporaryDirectory()
+        stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    NSString *assetPath = [NSTemporaryDirectory()
+        stringByAppendingPathComponent:
+            [[[NSUUID UUID] UUIDString]
+                stringByAppendingPathExtension:@"akscene"]];
+    SCNAssimpSceneCache *cache =
+        [[SCNAssimpSceneCache alloc] initWithDirectory:directory
+                                              maxBytes:0];
+    SCNAssimpImportSettings *settings = [[SCNAssimpImportSettings alloc] init];
+    settings.sceneCache = cache;
+    for (ModelFile *modelFile in modelFiles)
+    @autoreleasepool {
+        // the archive the cache stores is the asset the file compiles to
+        SCNAssimpScene *convertedScene =
+            [importer importScene:modelFile.path
+                 postProcessFlags:flags
+                         settings:settings
+                            error:nil];
+        if (convertedScene == nil)
+        {
+            continue;
+        }
+        for (NSString *name in [fileManager enumeratorAtPath:directory])
+        {
+            if ([name.pathExtension isEqualToString:@"akscene"])
+            {
+                [fileManager
+                    copyItemAtPath:[directory stringByAppendingPathComponent:
+                                                  name]
+                            toPath:assetPath
+                             error:nil];
+            }
+        }
+        NSError *error = nil;
+        SCNAssimpScene *assetScene = [importer importScene:assetPath
+                                          postProcessFlags:flags
+                                                  settings:nil
+                                                     error:&error];
+        XCTAssertNotNil(assetScene, @"The asset of %@ was not loaded: %@",
+                        modelFile.path, error);
+        XCTAssertFalse(assetScene.importStats.loadedFromCache);
+        XCTAssertEqualObjects([self signatureOfScene:assetScene],
+                              [self signatureOfScene:convertedScene],
+                              @"The asset scene of %@ differs",
+                              modelFile.path);
+        [fileManager removeItemAtPath:assetPath error:nil];
+        [cache removeAllScenes];
+    }
+    [@"not a scene asset" writeToFile:assetPath
+                           atomically:YES
+                             encoding:NSUTF8StringEncoding
+                                error:nil];
+    NSError *error = nil;
+    XCTAssertNil([importer importScene:assetPath
+                      postProcessFlags:flags
+                              settings:nil
+                                 error:&error]);
+    XCTAssertNotNil(error);
+    [fileManager removeItemAtPath:assetPath error:nil];
+    [fileManager removeItemAtPath:directory error:nil];
+}
+
 @end
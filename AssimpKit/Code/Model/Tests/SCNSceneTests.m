@@ -90,9 +90,11 @@
 - (void)testSupportedFileTypes
 {
     NSArray *validExts = [SCNAssimpScene allowedFileExtensions];
-    XCTAssertTrue(validExts.count == 29,
-                  @"Expected %d formats supported, instead supports %lu", 31,
+    XCTAssertTrue(validExts.count == 30,
+                  @"Expected %d formats supported, instead supports %lu", 30,
                   (unsigned long)validExts.count);
+    XCTAssertTrue([SCNScene canImportFileExtension:@"akscene"],
+                  @"Can not import compiled scene assets");
 }
 
 @end
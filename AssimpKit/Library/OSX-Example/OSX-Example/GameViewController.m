@@ -120,16 +120,24 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 - (void)addAnimationFromSceneFileURL:(NSURL*)sceneFileURL {
     NSError *error = nil;
+    SCNScene *scene = self.gameView.scene;
+    // Only the animations are needed to animate the model which is shown
+    SCNAssimpImportSettings *importSettings =
+        [[SCNAssimpImportSettings alloc] init];
+    if (scene != nil)
+    {
+        importSettings.components = SCNAssimpImportComponentAnimations;
+    }
     SCNAssimpScene *animScene = [SCNScene
                                  assimpSceneWithURL:sceneFileURL
                                  postProcessFlags:AssimpKit_Process_FlipUVs |
                                  AssimpKit_Process_Triangulate
+                                 settings:importSettings
                                  error:&error];
     if (error) {
         NSLog(@"ERROR: \"%@\"", error);
     }
     
-    SCNScene *scene = self.gameView.scene;
     if (scene == nil)
     {
         scene = animScene.modelScene;